@@ -101,6 +101,9 @@ namespace Lucene
         bool _isBinary;
         bool lazy;
         bool omitTermFreqAndPositions;
+        DocValuesType docValuesType;
+        bool reducedPrecisionNorms;
+        bool bloomFiltered;
         double boost;
         
         // the data object for all different kind of field values
@@ -206,6 +209,28 @@ namespace Lucene
         /// to find results.
         virtual void setOmitTermFreqAndPositions(bool omitTermFreqAndPositions);
         
+        /// @see #setDocValuesType
+        virtual DocValuesType getDocValuesType();
+        
+        /// If set to anything other than {@link #DOC_VALUES_NONE}, the field's value is also written to a 
+        /// column of per-document values, which sorting and function queries can read without uninverting the 
+        /// field.
+        virtual void setDocValuesType(DocValuesType docValuesType);
+        
+        /// @see #setReducedPrecisionNorms
+        virtual bool getReducedPrecisionNorms();
+        
+        /// If set, the norms of this indexed field are rounded to the 16 most common values in each segment, 
+        /// so that they can be stored in half a byte per document.
+        virtual void setReducedPrecisionNorms(bool reducedPrecisionNorms);
+        
+        /// @see #setBloomFiltered
+        virtual bool isBloomFiltered();
+        
+        /// If set, each segment keeps a Bloom filter of the terms of this indexed field, so that looking up a 
+        /// term the segment doesn't have rarely has to search the terms dictionary.
+        virtual void setBloomFiltered(bool bloomFiltered);
+        
         /// Indicates whether a Field is Lazy or not.  The semantics of Lazy loading are such that if a Field 
         /// is lazily loaded, retrieving it's values via {@link #stringValue()} or {@link #getBinaryValue()} 
         /// is only valid as long as the {@link IndexReader} that retrieved the {@link Document} is still open.
@@ -0,0 +1,88 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef ARENARAMDIRECTORY_H
+#define ARENARAMDIRECTORY_H
+
+#include "Directory.h"
+
+namespace Lucene
+{
+    /// A memory-resident {@link Directory} that stores files in large slabs taken from a {@link RAMArena}, 
+    /// rather than in the many small buffers used by {@link RAMDirectory}.
+    ///
+    /// A file becomes immutable once its output is closed, so reading it needs no synchronization at all; 
+    /// only opening, listing and deleting files take the directory's lock.  A file can't be opened for 
+    /// reading while it's still being written.
+    ///
+    /// Because closed files never change, {@link #snapshot} can share them between directories: taking a 
+    /// snapshot copies no file data, and later changes to either directory (which always write new files) 
+    /// are not seen by the other.  This makes it cheap to hand a read-only replica of an index to other 
+    /// threads.
+    ///
+    /// Locking implementation is by default the {@link SingleInstanceLockFactory}.
+    class LPPAPI ArenaRAMDirectory : public Directory
+    {
+    public:
+        /// Constructs an empty directory with its own arena.
+        ArenaRAMDirectory();
+        
+        /// Constructs an empty directory allocating from the given arena, which may be shared.
+        ArenaRAMDirectory(RAMArenaPtr arena);
+        
+        virtual ~ArenaRAMDirectory();
+        
+        LUCENE_CLASS(ArenaRAMDirectory);
+    
+    protected:
+        RAMArenaPtr arena;
+        MapStringArenaFile fileMap;
+    
+    public:
+        /// Returns the arena that this directory allocates from.
+        RAMArenaPtr getArena();
+        
+        /// Returns a new directory holding the files that are currently closed for writing.  No file data 
+        /// is copied.  The snapshot shares this directory's arena and has its own lock factory.
+        ArenaRAMDirectoryPtr snapshot();
+        
+        /// Returns an array of strings, one for each file in the directory.
+        virtual HashSet<String> listAll();
+        
+        /// Returns true if a file with the given name exists.
+        virtual bool fileExists(const String& name);
+        
+        /// Returns the time the named file was last modified.
+        virtual uint64_t fileModified(const String& name);
+        
+        /// Set the modified time of an existing file to now.
+        virtual void touchFile(const String& name);
+        
+        /// Returns the length of a file in the directory.
+        virtual int64_t fileLength(const String& name);
+        
+        /// Return total size in bytes of all closed files in this directory.
+        int64_t sizeInBytes();
+        
+        /// Removes an existing file in the directory.
+        virtual void deleteFile(const String& name);
+        
+        /// Creates a new, empty file in the directory with the given name.
+        /// Returns a stream writing this file.
+        virtual IndexOutputPtr createOutput(const String& name);
+        
+        /// Returns a stream reading an existing file.
+        virtual IndexInputPtr openInput(const String& name);
+        
+        /// Closes the store to future operations, releasing associated memory.
+        virtual void close();
+    
+    protected:
+        ArenaFilePtr getFile(const String& name);
+    };
+}
+
+#endif
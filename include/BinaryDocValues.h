@@ -0,0 +1,45 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef BINARYDOCVALUES_H
+#define BINARYDOCVALUES_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Random access to the binary per-document values of a field in one segment.  Documents without a value
+    /// read as empty.
+    /// @see IndexReader#getBinaryDocValues
+    class LPPAPI BinaryDocValues : public LuceneObject
+    {
+    public:
+        BinaryDocValues(IndexInputPtr input);
+        virtual ~BinaryDocValues();
+        
+        LUCENE_CLASS(BinaryDocValues);
+    
+    protected:
+        IndexInputPtr input;
+        int32_t numDocs;
+        int32_t width;
+        int64_t addressPointer;
+        int64_t dataPointer;
+        UTF8ResultPtr scratch;
+    
+    public:
+        /// Returns the number of documents.
+        int32_t size();
+        
+        /// Reads the bytes of a document into result.
+        void get(int32_t doc, UTF8ResultPtr result);
+        
+        /// Returns the bytes of a document decoded from UTF-8.
+        String getString(int32_t doc);
+    };
+}
+
+#endif
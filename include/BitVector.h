@@ -74,21 +74,18 @@ namespace Lucene
         BitVectorPtr subset(int32_t start, int32_t end);
     
     protected:
-        /// Write as a bit set.
-        void writeBits(IndexOutputPtr output);
-        
-        /// Write as a d-gaps list.
-        void writeDgaps(IndexOutputPtr output);
-        
-        /// Indicates if the bit vector is sparse and should be saved as a d-gaps list, 
-        /// or dense, and should be saved as a bit set.
-        bool isSparse();
+        /// Write as a {@link RoaringDocIdSet}, which keeps sparse ranges as lists of bits, dense ranges
+        /// as bit sets and ranges of consecutive bits as runs.
+        void writeRoaring(IndexOutputPtr output);
         
         /// Read as a bit set.
         void readBits(IndexInputPtr input);
         
         /// Read as a d-gaps list.
         void readDgaps(IndexInputPtr input);
+        
+        /// Read as a {@link RoaringDocIdSet}.
+        void readRoaring(IndexInputPtr input);
     };
 }
 
@@ -0,0 +1,88 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLOCKCACHE_H
+#define BLOCKCACHE_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// A memory-bounded cache of fixed-size file pages, shared by any number of {@link BlockCacheDirectory} 
+    /// instances.  Pages are spread over a number of independently locked shards, each of which evicts using 
+    /// the CLOCK (second chance) approximation of LRU.
+    ///
+    /// Pages are identified by a file id, handed out by {@link #newFileId}, and the page number within that file.
+    class LPPAPI BlockCache : public LuceneObject
+    {
+    public:
+        /// Create a new BlockCache.
+        /// @param maxSizeInBytes the maximum number of bytes of page data held by the cache.
+        /// @param pageSize the size of each cached page (rounded up to a power of 2).
+        /// @param numShards the number of independently locked shards.
+        BlockCache(int64_t maxSizeInBytes, int32_t pageSize = DEFAULT_PAGE_SIZE, int32_t numShards = DEFAULT_NUM_SHARDS);
+        virtual ~BlockCache();
+        
+        LUCENE_CLASS(BlockCache);
+    
+    public:
+        /// Default page size.
+        static const int32_t DEFAULT_PAGE_SIZE;
+        
+        /// Default number of shards.
+        static const int32_t DEFAULT_NUM_SHARDS;
+    
+    protected:
+        int32_t pageSize;
+        int32_t pageSizePower;
+        Collection<BlockCacheShardPtr> shards;
+        int64_t nextFileId;
+    
+    public:
+        /// Returns the size of each cached page.
+        int32_t getPageSize();
+        
+        /// Returns the log2 of the page size.
+        int32_t getPageSizePower();
+        
+        /// Returns the maximum number of pages the cache will hold.
+        int64_t getMaxPages();
+        
+        /// Allocate a new file id.  File ids are never reused, so pages cached under a previous id become 
+        /// unreachable and are eventually evicted.
+        int64_t newFileId();
+        
+        /// Returns the cached page, or a null array if the page is not cached.
+        ByteArray get(int64_t fileId, int64_t page);
+        
+        /// Add a page to the cache, evicting another page if necessary.
+        void put(int64_t fileId, int64_t page, ByteArray bytes);
+        
+        /// Remove the first numPages pages of a file from the cache.
+        void remove(int64_t fileId, int64_t numPages);
+        
+        /// Remove all pages from the cache.  Statistics are not reset.
+        void clear();
+        
+        /// Returns the number of pages currently cached.
+        int64_t getPageCount();
+        
+        /// Returns the number of lookups that found the requested page.
+        int64_t getHitCount();
+        
+        /// Returns the number of lookups that did not find the requested page.
+        int64_t getMissCount();
+        
+        /// Returns the number of pages evicted to make room for new pages.
+        int64_t getEvictionCount();
+    
+    protected:
+        BlockCacheShardPtr getShard(int64_t key);
+        static int64_t makeKey(int64_t fileId, int64_t page);
+    };
+}
+
+#endif
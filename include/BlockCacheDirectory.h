@@ -0,0 +1,134 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLOCKCACHEDIRECTORY_H
+#define BLOCKCACHEDIRECTORY_H
+
+#include "Directory.h"
+
+namespace Lucene
+{
+    /// A Directory that wraps another Directory and serves reads through a {@link BlockCache}.  A single cache 
+    /// may be shared by many directories, giving one memory budget (and one eviction policy) across all the 
+    /// indexes on a host, independently of the operating system's page cache.
+    ///
+    /// Which files are cached is decided per file extension, see {@link #setCachePolicy}.  Merges read through 
+    /// {@link #getMergeReadDirectory}; they use pages that are already cached, but by default do not add new 
+    /// pages, so a large merge doesn't flush the pages that searches depend on.
+    ///
+    /// Cached pages are dropped when a file is deleted or re-created through this directory.  Files must not 
+    /// be modified through the wrapped directory directly while this directory is in use.
+    class LPPAPI BlockCacheDirectory : public Directory
+    {
+    public:
+        /// Create a new BlockCacheDirectory.
+        /// @param dir the directory to wrap.
+        /// @param cache the cache to use, which may be shared with other directories.
+        BlockCacheDirectory(DirectoryPtr dir, BlockCachePtr cache);
+        virtual ~BlockCacheDirectory();
+        
+        LUCENE_CLASS(BlockCacheDirectory);
+    
+    public:
+        /// Cache policies that may be applied to a file extension.
+        enum CachePolicy
+        {
+            /// Cache pages, except for those read by merges.
+            CACHE_DEFAULT,
+            
+            /// Always cache pages, including those read by merges.
+            CACHE_ALWAYS,
+            
+            /// Never cache pages; reads go straight to the wrapped directory.
+            CACHE_NEVER
+        };
+    
+    protected:
+        DirectoryPtr dir;
+        BlockCachePtr cache;
+        MapStringInt cachePolicies;
+        CachePolicy defaultCachePolicy;
+        MapStringLong fileIds;
+    
+    public:
+        /// Return the wrapped directory.
+        DirectoryPtr getDirectory();
+        
+        /// Return the cache used by this directory.
+        BlockCachePtr getCache();
+        
+        /// Set the cache policy for files with the given extension (eg. "tis").
+        void setCachePolicy(const String& extension, CachePolicy policy);
+        
+        /// Returns the cache policy for files with the given extension.
+        CachePolicy getCachePolicy(const String& extension);
+        
+        /// Set the cache policy for extensions that have no explicit policy.  The default is {@link #CACHE_DEFAULT}.
+        void setDefaultCachePolicy(CachePolicy policy);
+        
+        /// Returns the cache policy for extensions that have no explicit policy.
+        CachePolicy getDefaultCachePolicy();
+        
+        /// Returns an array of strings, one for each file in the directory.
+        virtual HashSet<String> listAll();
+        
+        /// Returns true if a file with the given name exists.
+        virtual bool fileExists(const String& name);
+        
+        /// Returns the time the named file was last modified.
+        virtual uint64_t fileModified(const String& name);
+        
+        /// Set the modified time of an existing file to now.
+        virtual void touchFile(const String& name);
+        
+        /// Removes an existing file in the directory.
+        virtual void deleteFile(const String& name);
+        
+        /// Returns the length of a file in the directory.
+        virtual int64_t fileLength(const String& name);
+        
+        /// Creates a new, empty file in the directory with the given name.
+        /// Returns a stream writing this file.
+        virtual IndexOutputPtr createOutput(const String& name);
+        
+        /// Ensure that any writes to this file are moved to stable storage.
+        virtual void sync(const String& name);
+        
+        /// Returns a stream reading an existing file.
+        virtual IndexInputPtr openInput(const String& name);
+        
+        /// Returns a stream reading an existing file, with the specified read buffer size.
+        virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
+        
+        /// Returns a view of this directory whose reads use cached pages but, unless the file's extension is 
+        /// always cached, don't add pages to the cache.
+        virtual DirectoryPtr getMergeReadDirectory();
+        
+        /// Return a string identifier that uniquely differentiates this Directory instance from other Directory instances.
+        virtual String getLockID();
+        
+        /// Closes the store.  The wrapped directory is also closed.
+        virtual void close();
+        
+        virtual String toString();
+    
+    protected:
+        /// Returns the cache id of the current version of the given file.
+        int64_t getFileId(const String& name);
+        
+        /// Forget the cache id of the given file and drop its pages, so pages of an old version of the file 
+        /// are never returned.
+        void invalidate(const String& name);
+        
+        /// Returns a stream reading an existing file through the cache.
+        /// @param isMerge true if the file is read by a merge.
+        IndexInputPtr openInput(const String& name, int32_t bufferSize, bool isMerge);
+        
+        friend class BlockCacheMergeDirectory;
+    };
+}
+
+#endif
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLOCKMAXDISJUNCTIONSCORER_H
+#define BLOCKMAXDISJUNCTIONSCORER_H
+
+#include "Scorer.h"
+
+namespace Lucene
+{
+    /// A Scorer for OR like queries that only has to find the docs that can enter the top hits, for collectors
+    /// that set a minimum competitive score with {@link #setMinCompetitiveScore}.
+    ///
+    /// Docs are matched a window at a time, up to the end of the first skip block of the subscorers.  Within
+    /// a window the subscorers are ordered by their greatest score, as given by {@link Scorer#getMaxScore}.
+    /// The longest run of the lowest whose scores add up to less than the minimum competitive score are
+    /// non-essential: a doc matching only these can't compete, so candidates come from the essential subscorers
+    /// alone, and the non-essential ones are only advanced to a candidate while it may still compete.  When
+    /// all subscorers of a window are non-essential, the whole window is skipped.
+    ///
+    /// Scores are the sum of the matching subscorers times the coordination factor of their number.
+    class LPPAPI BlockMaxDisjunctionScorer : public Scorer
+    {
+    public:
+        /// @param similarity The Similarity of the query.
+        /// @param subScorers The subscorers, at least two.
+        /// @param coordFactors The coordination factor of each number of matching subscorers.
+        BlockMaxDisjunctionScorer(SimilarityPtr similarity, Collection<ScorerPtr> subScorers, Collection<double> coordFactors);
+        virtual ~BlockMaxDisjunctionScorer();
+        
+        LUCENE_CLASS(BlockMaxDisjunctionScorer);
+    
+    protected:
+        /// The subscorers, ordered by their greatest score in the current window.
+        Collection<ScorerPtr> subScorers;
+        
+        /// The greatest score of each subscorer in the current window.
+        Collection<double> maxScores;
+        
+        /// The sum of the greatest scores of each subscorer and of those before it.
+        Collection<double> maxScoreSums;
+        
+        Collection<double> coordFactors;
+        
+        /// Scales a sum of greatest scores up to a bound of the score of a doc.
+        double boundFactor;
+        
+        double minCompetitiveScore;
+        
+        /// The subscorers before this one are non-essential.
+        int32_t numNonEssential;
+        
+        /// The last doc of the current window.
+        int32_t windowMax;
+        
+        int32_t doc;
+        double currentScore;
+    
+    public:
+        virtual int32_t docID();
+        virtual int32_t nextDoc();
+        virtual int32_t advance(int32_t target);
+        virtual double score();
+        virtual void setMinCompetitiveScore(double minScore);
+    
+    protected:
+        /// Moves to the first window from target on that holds a doc that may compete.  Returns false if there
+        /// is none.
+        bool nextWindow(int32_t target);
+        
+        /// Finds the non-essential subscorers of the current window.
+        void partition();
+        
+        /// Returns a bound of the score of a doc whose subscorers score up to sum.
+        double upperBound(double sum);
+    };
+}
+
+#endif
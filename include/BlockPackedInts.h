@@ -0,0 +1,65 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLOCKPACKEDINTS_H
+#define BLOCKPACKEDINTS_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Writes and reads blocks of {@link #BLOCK_SIZE} non-negative ints using frame of reference bit packing with
+    /// patched exceptions (PFOR): every value is stored in the same number of bits, chosen so that the few values
+    /// that don't fit are cheaper to store separately than to widen the whole block.
+    ///
+    /// A block is a byte holding the number of bits per value, a byte holding the number of exceptions, the packed
+    /// values and then each exception as a byte index followed by a VInt holding its high bits.  Values are packed
+    /// into four interleaved lanes of little-endian 32 bit words (value i goes to lane i % 4), so that a 128 bit
+    /// register holds one word of each lane and four consecutive values are decoded at once.  SSE2 is used for
+    /// this where available.
+    class LPPAPI BlockPackedInts : public LuceneObject
+    {
+    public:
+        BlockPackedInts();
+        virtual ~BlockPackedInts();
+
+        LUCENE_CLASS(BlockPackedInts);
+
+    public:
+        /// Number of values in a block.
+        static const int32_t BLOCK_SIZE;
+
+    protected:
+        /// Packed words of the current block.
+        IntArray packed;
+
+        /// Packed words as bytes, as read or written.
+        ByteArray bytes;
+
+        /// Bits needed by each value of the block being written.
+        IntArray bitsRequired;
+
+    public:
+        /// Writes a block of {@link #BLOCK_SIZE} values, which must not be negative.
+        void writeBlock(IndexOutputPtr out, const int32_t* values);
+
+        /// Reads a block of {@link #BLOCK_SIZE} values into the given array.
+        void readBlock(IndexInputPtr in, int32_t* values);
+
+        /// Replaces values by their running sum, starting from base.  Used to turn decoded deltas back into
+        /// absolute values.
+        static void prefixSum(int32_t* values, int32_t length, int32_t base);
+
+        /// Returns the number of bits needed to store a value.
+        static int32_t bitsRequiredFor(uint32_t value);
+
+    protected:
+        static void pack(const uint32_t* values, uint32_t* packed, int32_t bitsPerValue);
+        static void unpack(const uint32_t* packed, uint32_t* values, int32_t bitsPerValue);
+    };
+}
+
+#endif
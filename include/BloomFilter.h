@@ -0,0 +1,63 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// A set of 64 bit hashes that can answer "definitely not present" without false negatives, and "maybe 
+    /// present" with a small chance of a false positive.
+    ///
+    /// Each hash sets {@link #getNumHashes} bits of a power of two sized bitmap, derived from its two halves by
+    /// double hashing.  With the default of 10 bits per value, rounded up to a power of two, about one lookup 
+    /// in a hundred for a missing value is a false positive.
+    class LPPAPI BloomFilter : public LuceneObject
+    {
+    public:
+        /// @param numBits number of bits of the filter, rounded up to a power of two of at least 64.
+        /// @param numHashes number of bits set by each value.
+        BloomFilter(int64_t numBits, int32_t numHashes);
+        virtual ~BloomFilter();
+        
+        LUCENE_CLASS(BloomFilter);
+    
+    public:
+        /// Bits per value used by {@link #create} unless told otherwise.
+        static const int32_t DEFAULT_BITS_PER_VALUE;
+        
+        /// Upper bound of the number of bits set per value.
+        static const int32_t MAX_HASHES;
+    
+    protected:
+        LongArray bits;
+        int64_t mask;
+        int32_t numHashes;
+    
+    public:
+        /// Returns a filter holding the given hashes, sized for their number.
+        static BloomFilterPtr create(Collection<int64_t> hashes, int32_t bitsPerValue = DEFAULT_BITS_PER_VALUE);
+        
+        /// Returns the 64 bit MurmurHash2 of a run of bytes.
+        static int64_t hash(const uint8_t* bytes, int32_t length);
+        
+        void add(int64_t hash);
+        
+        /// Returns false if the hash was certainly never added.
+        bool mayContain(int64_t hash);
+        
+        int64_t getNumBits();
+        int32_t getNumHashes();
+        int64_t sizeInBytes();
+        
+        void write(IndexOutputPtr output);
+        static BloomFilterPtr read(IndexInputPtr input);
+    };
+}
+
+#endif
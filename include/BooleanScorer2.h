@@ -62,6 +62,7 @@ namespace Lucene
         virtual int32_t nextDoc();
         virtual double score();
         virtual int32_t advance(int32_t target);
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
     
     protected:
         ScorerPtr countingDisjunctionSumScorer(Collection<ScorerPtr> scorers, int32_t minNrShouldMatch);
@@ -123,6 +124,7 @@ namespace Lucene
         virtual int32_t docID();
         virtual int32_t nextDoc();
         virtual int32_t advance(int32_t target);
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
     };
     
     class CountingDisjunctionSumScorer : public DisjunctionSumScorer
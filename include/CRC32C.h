@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef CRC32C_H
+#define CRC32C_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Computes the CRC-32C (Castagnoli) checksum of a stream of bytes.  Where the processor supports 
+    /// it, the SSE4.2 crc32 instruction is used (detected at runtime); otherwise a slice-by-8 table 
+    /// implementation processes eight bytes per step.
+    class LPPAPI CRC32C : public LuceneObject
+    {
+    public:
+        CRC32C();
+        virtual ~CRC32C();
+        
+        LUCENE_CLASS(CRC32C);
+    
+    protected:
+        uint32_t crc;
+    
+    public:
+        /// Updates the checksum with a single byte.
+        void update(uint8_t b);
+        
+        /// Updates the checksum with an array of bytes.
+        void update(const uint8_t* b, int32_t offset, int32_t length);
+        
+        /// Returns the checksum of all bytes seen since construction or the last {@link #reset}.
+        int64_t getValue();
+        
+        /// Resets the checksum to its initial value.
+        void reset();
+        
+        /// Adjusts the checksum for bytes of the message that were overwritten after being added, 
+        /// without re-reading the message.
+        /// @param messageLength the number of bytes added so far.
+        /// @param position the position of the first overwritten byte.
+        /// @param oldBytes the original bytes.
+        /// @param newBytes the replacement bytes.
+        /// @param length the number of bytes overwritten.
+        void patch(int64_t messageLength, int64_t position, const uint8_t* oldBytes, const uint8_t* newBytes, int32_t length);
+        
+        /// Returns true if checksums are computed using the processor's crc32 instruction.
+        static bool isHardwareAccelerated();
+    
+    protected:
+        static uint32_t updateSoftware(uint32_t crc, const uint8_t* b, int32_t length);
+        static uint32_t updateHardware(uint32_t crc, const uint8_t* b, int32_t length);
+        
+        /// Appends the given number of zero bytes to a raw (un-inverted) checksum register.
+        static uint32_t shiftZeros(uint32_t crc, int64_t numBytes);
+    };
+}
+
+#endif
@@ -54,7 +54,8 @@ namespace Lucene
         /// Provide the DocIdSet to be cached, using the DocIdSet provided by the wrapped Filter.
         ///
         /// This implementation returns the given {@link DocIdSet}, if {@link DocIdSet#isCacheable} returns 
-        /// true, else it copies the {@link DocIdSetIterator} into an {@link OpenBitSetDISI}.
+        /// true and it is not a bit set of one bit per document, else it copies the {@link DocIdSetIterator}
+        /// into a {@link RoaringDocIdSet}, which takes less memory than a bit set unless most documents match.
         DocIdSetPtr docIdSetToCache(DocIdSetPtr docIdSet, IndexReaderPtr reader);
     
     public:
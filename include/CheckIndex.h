@@ -220,6 +220,12 @@ namespace Lucene
         /// @see AbstractField#setOmitTermFreqAndPositions
         bool hasProx;
         
+        /// Name of the codec that wrote this segment.
+        String codecName;
+        
+        /// Description of the sort the documents of this segment are in, or empty if unsorted.
+        String indexSort;
+        
         /// Map that includes certain debugging details that IndexWriter records into each segment it creates
         MapStringString diagnostics;
         
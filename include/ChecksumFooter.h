@@ -0,0 +1,69 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef CHECKSUMFOOTER_H
+#define CHECKSUMFOOTER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Utility methods for the checksum footer written at the end of index files by {@link 
+    /// ChecksumFooterIndexOutput}.
+    ///
+    /// The footer is {@link #FOOTER_LENGTH} bytes: FOOTER_MAGIC (Int32), the algorithm ID (Int32) and the 
+    /// CRC-32C checksum (Int64) of every preceding byte of the file, including the magic and algorithm ID.
+    ///
+    /// Whether a file has a footer is known from its format version (or, for files without a header, 
+    /// from the format of the segment's field infos); files written before footers were introduced 
+    /// have none.  Readers that rely on the length of a file with a footer use {@link #dataLength} 
+    /// rather than {@link IndexInput#length}.
+    class LPPAPI ChecksumFooter : public LuceneObject
+    {
+    public:
+        virtual ~ChecksumFooter();
+        
+        LUCENE_CLASS(ChecksumFooter);
+    
+    public:
+        /// Marks the start of a footer.
+        static const int32_t FOOTER_MAGIC;
+        
+        /// Algorithm ID for CRC-32C.
+        static const int32_t ALGORITHM_CRC32C;
+        
+        /// Number of bytes in a footer.
+        static const int32_t FOOTER_LENGTH;
+    
+    public:
+        /// Returns the length of a file that ends with a footer, excluding the footer.
+        static int64_t dataLength(IndexInputPtr input);
+        
+        /// Adds the next numBytes bytes of input to checksum.
+        static void updateChecksum(IndexInputPtr input, int64_t numBytes, CRC32CPtr checksum);
+        
+        /// Copies the next numBytes bytes of input to output, adding them to checksum on the way.  A merge 
+        /// that copies the whole of a file can then check it with {@link #checkFooter} without reading it twice.
+        static void copyBytes(IndexInputPtr input, IndexOutputPtr output, int64_t numBytes, CRC32CPtr checksum);
+        
+        /// Reads the footer of input and checks it against checksum, which must have seen every byte of the 
+        /// file before the footer.  The file pointer is left at the end of the file.
+        /// @return the checksum.
+        /// @throws CorruptIndexException if the file has no footer or the checksum doesn't match.
+        static int64_t checkFooter(IndexInputPtr input, CRC32CPtr checksum);
+        
+        /// Reads the whole file and checks it against its footer.  The file pointer is left at the end 
+        /// of the file.
+        /// @return the checksum.
+        /// @throws CorruptIndexException if the file has no footer or the checksum doesn't match.
+        static int64_t checksumEntireFile(IndexInputPtr input);
+        
+        /// Verifies the named file in the given directory, see {@link #checksumEntireFile}.
+        static int64_t checksumEntireFile(DirectoryPtr dir, const String& name);
+    };
+}
+
+#endif
@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef CHECKSUMFOOTERINDEXOUTPUT_H
+#define CHECKSUMFOOTERINDEXOUTPUT_H
+
+#include "IndexOutput.h"
+
+namespace Lucene
+{
+    /// Writes bytes through to a primary IndexOutput, computing a CRC-32C checksum as it goes, and 
+    /// appends a {@link ChecksumFooter} when closed.  Bytes are passed straight on to the primary output, 
+    /// which does its own buffering, and are only counted in the checksum once it took them; the checksum 
+    /// itself is updated a {@link #CHECKSUM_BUFFER_SIZE} chunk at a time rather than byte by byte.
+    ///
+    /// Writers may seek back to fill in a header, but only within the first {@link #HEADER_WINDOW} 
+    /// bytes of the file; the checksum is adjusted for the overwritten bytes without re-reading the file.
+    class LPPAPI ChecksumFooterIndexOutput : public IndexOutput
+    {
+    public:
+        ChecksumFooterIndexOutput(IndexOutputPtr main);
+        virtual ~ChecksumFooterIndexOutput();
+        
+        LUCENE_CLASS(ChecksumFooterIndexOutput);
+    
+    public:
+        /// Number of bytes at the start of a file that may be overwritten.
+        static const int32_t HEADER_WINDOW;
+        
+        /// Number of written bytes collected before they are added to the checksum.
+        static const int32_t CHECKSUM_BUFFER_SIZE;
+    
+    protected:
+        IndexOutputPtr main;
+        CRC32CPtr checksum;
+        int64_t checksumLength;
+        int64_t filePointer;
+        ByteArray header;
+        
+        /// Bytes appended to the file that are not yet part of the checksum.
+        ByteArray pending;
+        int32_t pendingLength;
+        
+        /// Set once the footer's magic and algorithm ID have been written by {@link #close}.
+        bool footerStarted;
+        
+        bool isOpen;
+    
+    public:
+        /// Writes a single byte, updating the checksum.
+        virtual void writeByte(uint8_t b);
+        
+        /// Writes an array of bytes, updating the checksum.
+        virtual void writeBytes(const uint8_t* b, int32_t offset, int32_t length);
+        
+        /// Forces any buffered output of the primary output to be written.
+        virtual void flush();
+        
+        /// Writes the footer and closes the primary output.  If this fails (eg. the disk is full) the 
+        /// output stays open, and closing it again retries writing the footer.
+        virtual void close();
+        
+        /// Returns the current position in this file, where the next write will occur.
+        virtual int64_t getFilePointer();
+        
+        /// Sets current position in this file, where the next write will occur.
+        virtual void seek(int64_t pos);
+        
+        /// The number of bytes in the file, not including the footer.
+        virtual int64_t length();
+        
+        /// Returns the checksum of the bytes written so far.
+        int64_t getChecksum();
+    
+    protected:
+        /// Adds the pending bytes to the checksum.
+        void updateChecksum();
+        
+        /// Counts bytes appended to the file, once the primary output took them.
+        void append(const uint8_t* b, int32_t offset, int32_t length);
+    };
+}
+
+#endif
@@ -0,0 +1,117 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef CODEC_H
+#define CODEC_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Encodes and decodes the files of a segment.
+    ///
+    /// A codec supplies the writers used when a segment is flushed or merged and the readers used when it is
+    /// opened: postings and the terms dictionary, stored fields, term vectors, norms and per-document values.  Each segment records
+    /// the name of the codec that wrote it, so that segments written by different codecs can live in the same
+    /// index.  Codecs are looked up by name when a segment is opened, so any codec other than the default must
+    /// be registered with {@link #registerCodec} before an index that uses it is opened.
+    ///
+    /// @see IndexWriter#setCodec
+    class LPPAPI Codec : public LuceneObject
+    {
+    public:
+        Codec(const String& name);
+        virtual ~Codec();
+        
+        LUCENE_CLASS(Codec);
+    
+    protected:
+        String name;
+    
+    public:
+        /// Returns the name of this codec, as recorded in the segments it writes.
+        String getName();
+        
+        /// Returns the codec that writes the standard index file format.
+        static CodecPtr getDefault();
+        
+        /// Makes a codec available to {@link #forName}, replacing any codec previously registered under the
+        /// same name.  Codecs should be registered at startup, before any index is opened.
+        static void registerCodec(CodecPtr codec);
+        
+        /// Returns the codec registered under the given name.
+        static CodecPtr forName(const String& name);
+        
+        /// Returns the names of all registered codecs.
+        static HashSet<String> availableCodecs();
+        
+        /// Returns the consumer that writes the postings and terms dictionary of a segment being flushed or merged.
+        virtual FormatPostingsFieldsConsumerPtr fieldsConsumer(SegmentWriteStatePtr state, FieldInfosPtr fieldInfos) = 0;
+        
+        /// Opens the terms dictionary of a segment.
+        virtual TermInfosReaderPtr termsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t indexDivisor) = 0;
+        
+        /// Returns a new enumerator over the postings of a segment.
+        virtual TermDocsPtr termDocs(SegmentReaderPtr reader) = 0;
+        
+        /// Returns a new enumerator over the postings and positions of a segment.
+        virtual TermPositionsPtr termPositions(SegmentReaderPtr reader) = 0;
+        
+        /// Opens the doc and freq postings of a segment, which its enumerators read from.
+        virtual IndexInputPtr freqInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize) = 0;
+        
+        /// Opens the positions and payloads of a segment, which its enumerators read from.
+        virtual IndexInputPtr proxInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize) = 0;
+        
+        /// Returns the writer for the stored fields of a segment or doc store.
+        virtual FieldsWriterPtr fieldsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos) = 0;
+        
+        /// Opens the stored fields of a segment or doc store.
+        virtual FieldsReaderPtr fieldsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size) = 0;
+        
+        /// Returns the consumer that writes term vectors while documents are indexed.
+        virtual TermsHashConsumerPtr termVectorsConsumer(DocumentsWriterPtr docWriter) = 0;
+        
+        /// Returns the writer for the term vectors of a merged segment.
+        virtual TermVectorsWriterPtr termVectorsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos) = 0;
+        
+        /// Opens the term vectors of a segment or doc store.
+        virtual TermVectorsReaderPtr termVectorsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size) = 0;
+        
+        /// Returns the consumer that writes norms while documents are indexed.
+        virtual InvertedDocEndConsumerPtr normsConsumer() = 0;
+        
+        /// Creates the norms file of a segment being flushed or merged, ready for the norms of its first field.
+        virtual IndexOutputPtr normsOutput(DirectoryPtr dir, const String& segment) = 0;
+        
+        /// Writes the norms of the next field to the norms file of a segment being flushed or merged.
+        /// @param norms the norms of the documents, which may be rounded in place if reducedPrecision is set.
+        virtual void writeNorms(IndexOutputPtr out, ByteArray norms, int32_t numDocs, bool reducedPrecision) = 0;
+        
+        /// Returns the position of the norms of each field in the norms file of a segment, read from its start, 
+        /// or null if the file has one byte per document per field.
+        virtual Collection<int64_t> readNormEntries(IndexInputPtr in, int32_t numFields) = 0;
+        
+        /// Reads the norms of a field from the norms file of a segment.
+        /// @see NormsFormat#read
+        virtual NormValuesPtr readNorms(IndexInputPtr in, int64_t pos, int32_t numDocs, bool encoded, bool& mapped) = 0;
+        
+        /// Returns the writer for the per-document values of a segment being flushed or merged.
+        virtual DocValuesWriterPtr docValuesWriter(DirectoryPtr dir, const String& segment, int32_t numDocs) = 0;
+        
+        /// Opens the per-document values of a segment.
+        virtual DocValuesReaderPtr docValuesReader(DirectoryPtr dir, const String& segment, int32_t readBufferSize) = 0;
+        
+        /// Adds the names of any files written by this codec that the standard segment files don't cover.
+        virtual void files(DirectoryPtr dir, SegmentInfoPtr info, HashSet<String> files);
+    
+    protected:
+        /// Returns the registry of codecs by name.
+        static MapStringCodec codecs();
+    };
+}
+
+#endif
@@ -132,6 +132,13 @@ namespace Lucene
         ///
         /// Many collectors don't mind getting docIDs out of order, so it's important to return true here.
            virtual bool acceptsDocsOutOfOrder() = 0;
+        
+        /// Return true if this collector keeps only the hits with the top scores, and tells the scorer it is given
+        /// the lowest score it can still collect through {@link Scorer#setMinCompetitiveScore}.  Searches may then
+        /// pass over the hits that score less without collecting them, see {@link Weight#topScoresScorer}.
+        ///
+        /// The default implementation returns false.
+        virtual bool needsTopScoresOnly();
     };
 }
 
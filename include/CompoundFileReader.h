@@ -15,6 +15,8 @@ namespace Lucene
     /// Class for accessing a compound stream.
     /// This class implements a directory, but is limited to only read operations.
     /// Directory methods that would normally modify data throw an exception.
+    /// Sub-files are opened as slices of the compound stream, see {@link IndexInput#slice}, and
+    /// are buffered with the requested buffer size when the slice is buffered.
     class CompoundFileReader : public Directory
     {
     public:
@@ -75,49 +77,15 @@ namespace Lucene
         /// Returns the length of a file in the directory.
         virtual int64_t fileLength(const String& name);
         
+        /// Returns the position of a file within the compound file.
+        int64_t fileOffset(const String& name);
+        
         /// Not implemented
         virtual IndexOutputPtr createOutput(const String& name);
         
         /// Not implemented
         virtual LockPtr makeLock(const String& name);
     };
-    
-    /// Implementation of an IndexInput that reads from a portion of the compound file. 
-    class CSIndexInput : public BufferedIndexInput
-    {
-    public:
-        CSIndexInput();
-        CSIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length);
-        CSIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length, int32_t readBufferSize);
-        virtual ~CSIndexInput();
-        
-        LUCENE_CLASS(CSIndexInput);
-        
-    public:
-        IndexInputPtr base;
-        int64_t fileOffset;
-        int64_t _length;
-        
-    public:
-        /// Closes the stream to further operations.
-        virtual void close();
-        
-        virtual int64_t length();
-        
-        /// Returns a clone of this stream.
-        virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
-    
-    protected:
-        /// Implements buffer refill.  Reads bytes from the current position in the input.
-        /// @param b the array to read bytes into
-        /// @param offset the offset in the array to start storing bytes
-        /// @param len the number of bytes to read
-        virtual void readInternal(uint8_t* b, int32_t offset, int32_t length);
-        
-        /// Implements seek.  Sets current position in this file, where the next {@link 
-        /// #readInternal(byte[],int,int)} will occur.
-        virtual void seekInternal(int64_t pos);
-    };
 }
 
 #endif
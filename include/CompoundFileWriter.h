@@ -13,6 +13,7 @@ namespace Lucene
 {
     /// Combines multiple files into a single compound file.
     /// The file format:
+    ///    VInt format ({@link #FORMAT_CURRENT}, negative; files written without a footer start with fileCount)
     ///    VInt fileCount
     ///    {Directory}
     ///    fileCount entries with the following structure:
@@ -21,9 +22,14 @@ namespace Lucene
     ///    {File Data}
     ///    fileCount entries with the raw data of the corresponding file
     ///
+    ///    {Footer}
+    ///    a {@link ChecksumFooter}
+    ///
     /// The fileCount integer indicates how many files are contained in this compound file. The {directory} 
     /// that follows has that many entries. Each directory entry contains a long pointer to the start of 
     /// this file's data section, and a string with that file's name.
+    ///
+    /// Source files added with a checksum footer are verified as they are copied.
     class CompoundFileWriter : public LuceneObject
     {
     public:
@@ -31,6 +37,12 @@ namespace Lucene
         virtual ~CompoundFileWriter();
         
         LUCENE_CLASS(CompoundFileWriter);
+    
+    public:
+        /// The compound file ends with a {@link ChecksumFooter}
+        static const int32_t FORMAT_CHECKSUM_FOOTER;
+        
+        static const int32_t FORMAT_CURRENT;
         
     protected:
         struct FileEntry
@@ -38,8 +50,8 @@ namespace Lucene
             /// source file
             String file;
             
-            /// temporary holder for the start of directory entry for this file
-            int64_t directoryOffset;
+            /// whether the source file ends with a checksum footer
+            bool hasFooter;
             
             /// temporary holder for the start of this file's data section
             int64_t dataOffset;
@@ -60,8 +72,9 @@ namespace Lucene
         String getName();
         
         /// Add a source stream. file is the string by which the sub-stream will be known in the 
-        /// compound stream.
-        void addFile(const String& file);
+        /// compound stream.  If hasFooter is true the file must end with a {@link ChecksumFooter}, 
+        /// which is verified as the file is copied.
+        void addFile(const String& file, bool hasFooter = false);
         
         /// Merge files with the extensions added up to now.  All files with these extensions are 
         /// combined sequentially into the compound stream. After successful merge, the source 
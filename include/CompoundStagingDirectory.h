@@ -0,0 +1,127 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef COMPOUNDSTAGINGDIRECTORY_H
+#define COMPOUNDSTAGINGDIRECTORY_H
+
+#include "Directory.h"
+
+namespace Lucene
+{
+    /// A view of a directory used while writing a segment that will be packed into a compound file.
+    ///
+    /// Files of the segment that belong in the compound file are held in RAM instead of being written to 
+    /// the delegate directory, so {@link CompoundFileWriter} can build the compound file from memory rather 
+    /// than writing every file out and reading it back.  Once more than maxStagedBytes are held, each 
+    /// file that is still being written spills to the delegate directory and continues there.  All other 
+    /// files, including the compound file itself, go straight to the delegate directory.
+    ///
+    /// If the segment ends up not using the compound format, {@link #unstage} writes the staged files out.
+    ///
+    /// Files are not streamed straight into the compound file, so maxStagedBytes bounds the saving: each 
+    /// flush or merge building a compound file holds up to maxStagedBytes in RAM (plus under 1KB 
+    /// per staged file), and the files of a segment larger than that are written to the delegate 
+    /// and read back when the compound file is built, as they would be without staging.
+    class LPPAPI CompoundStagingDirectory : public Directory
+    {
+    public:
+        CompoundStagingDirectory(DirectoryPtr delegate, const String& segment, int64_t maxStagedBytes = DEFAULT_MAX_STAGED_BYTES);
+        virtual ~CompoundStagingDirectory();
+        
+        LUCENE_CLASS(CompoundStagingDirectory);
+    
+    public:
+        /// Default limit on bytes held in RAM (16 MB), per segment being written.
+        static const int64_t DEFAULT_MAX_STAGED_BYTES;
+    
+    protected:
+        DirectoryPtr delegate;
+        String segment;
+        RAMDirectoryPtr staged;
+        int64_t maxStagedBytes;
+        
+        /// Set once a file has spilled, after which no more files are staged.
+        bool spilled;
+    
+    public:
+        /// Returns true if staging the files of a compound file in RAM saves writing them to the given 
+        /// directory and reading them back, which it doesn't for a directory that is itself held in RAM.
+        static bool isWorthStaging(DirectoryPtr directory);
+        
+        /// Return the wrapped directory.
+        DirectoryPtr getDelegate();
+        
+        /// Returns true if the named file is held in RAM.
+        bool isStaged(const String& name);
+        
+        /// Returns the number of bytes held in RAM.
+        int64_t sizeInBytes();
+        
+        /// Writes all staged files to the delegate directory and releases their memory.
+        void unstage();
+        
+        /// Returns an array of strings, one for each file in the directory.
+        virtual HashSet<String> listAll();
+        
+        /// Returns true if a file with the given name exists.
+        virtual bool fileExists(const String& name);
+        
+        /// Returns the time the named file was last modified.
+        virtual uint64_t fileModified(const String& name);
+        
+        /// Set the modified time of an existing file to now.
+        virtual void touchFile(const String& name);
+        
+        /// Removes an existing file in the directory.
+        virtual void deleteFile(const String& name);
+        
+        /// Returns the length of a file in the directory.
+        virtual int64_t fileLength(const String& name);
+        
+        /// Creates a new, empty file in the directory with the given name.
+        /// Returns a stream writing this file.
+        virtual IndexOutputPtr createOutput(const String& name);
+        
+        /// Ensure that any writes to this file are moved to stable storage.
+        virtual void sync(const String& name);
+        
+        /// Returns a stream reading an existing file.
+        virtual IndexInputPtr openInput(const String& name);
+        
+        /// Returns a stream reading an existing file, with the specified read buffer size.
+        virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
+        
+        /// Return a string identifier that uniquely differentiates this Directory instance from other 
+        /// Directory instances.
+        virtual String getLockID();
+        
+        /// Discards any staged files.  The delegate directory is left open.
+        virtual void close();
+        
+        virtual String toString();
+    
+    protected:
+        /// Returns true if the file should be written to RAM.
+        virtual bool doStageWrite(const String& name);
+        
+        /// Returns true if the staged files exceed maxStagedBytes or a file has spilled.
+        bool isFull();
+        
+        /// Moves a staged file that is being written to the delegate directory, returning an output 
+        /// positioned where the given staged output was.
+        IndexOutputPtr spill(const String& name, IndexOutputPtr output);
+        
+        /// Copy a staged file to the delegate directory.
+        void copyToDelegate(const String& name);
+        
+        /// Copy the contents of a staged file to the given output.
+        void copyStaged(const String& name, IndexOutputPtr output);
+        
+        friend class StagingIndexOutput;
+    };
+}
+
+#endif
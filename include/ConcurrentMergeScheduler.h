@@ -16,10 +16,14 @@ namespace Lucene
     /// the thread(s) that are updating the index will pause until one or more merges completes.  
     /// This is a simple way to use concurrency in the indexing process without having to create 
     /// and manage application level threads.
+    ///
+    /// A scheduler created with a {@link ThreadPool} runs each merge as a task of the pool instead 
+    /// of starting a thread for it, still up to the maximum number of merges at once.
     class LPPAPI ConcurrentMergeScheduler : public MergeScheduler
     {
     public:
         ConcurrentMergeScheduler();
+        ConcurrentMergeScheduler(ThreadPoolPtr executor);
         virtual ~ConcurrentMergeScheduler();
         
         LUCENE_CLASS(ConcurrentMergeScheduler);
@@ -34,6 +38,9 @@ namespace Lucene
         
         DirectoryPtr dir;
         
+        /// Runs the merges, if set, instead of a thread of their own
+        ThreadPoolPtr executor;
+        
         bool closed;
         IndexWriterWeakPtr _writer;
                 
@@ -53,6 +60,9 @@ namespace Lucene
         /// Get the max # simultaneous threads that may be running. @see #setMaxThreadCount.
         virtual int32_t getMaxThreadCount();
         
+        /// Returns the pool that runs the merges, or null if each merge runs in a thread of its own.
+        virtual ThreadPoolPtr getExecutor();
+        
         /// Return the priority that merge threads run at.  By default the priority is 1 plus the 
         /// priority of (ie, slightly higher priority than) the first thread that calls merge.
         virtual int32_t getMergeThreadPriority();
@@ -12,6 +12,9 @@
 namespace Lucene
 {
     /// Scorer for conjunctions, sets of queries, all of which are required.
+    ///
+    /// The approximations of the sub-scorers that {@link Scorer#twoPhaseIterator() iterate in two phases} are 
+    /// intersected with the other sub-scorers first, and confirmed only on the docs they all have in common.
     class ConjunctionScorer : public Scorer
     {
     public:
@@ -23,16 +26,23 @@ namespace Lucene
     protected:
         Collection<ScorerPtr> scorers;
         double coord;
-        int32_t lastDoc;
+        
+        /// Intersects the sub-scorers, or their approximations.
+        DocIdSetIteratorPtr approximation;
+        
+        /// Confirms the sub-scorers that iterate in two phases, null if none does.
+        TwoPhaseIteratorPtr twoPhase;
     
     public:
         virtual int32_t advance(int32_t target);
         virtual int32_t docID();
         virtual int32_t nextDoc();
         virtual double score();
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
     
     protected:
-        int32_t doNext();
+        /// Moves the approximation from doc on to the first doc that all sub-scorers match.
+        int32_t toMatch(int32_t doc);
     };
 }
 
@@ -0,0 +1,51 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DEFAULTCODEC_H
+#define DEFAULTCODEC_H
+
+#include "Codec.h"
+
+namespace Lucene
+{
+    /// The codec for the standard index file format: the .tis/.tii terms dictionary with .frq/.prx postings,
+    /// .fdx/.fdt stored fields, .tvx/.tvd/.tvf term vectors and .nrm norms.  Segments written before codecs
+    /// were recorded are read with this codec.
+    class LPPAPI DefaultCodec : public Codec
+    {
+    public:
+        DefaultCodec();
+        virtual ~DefaultCodec();
+    
+        LUCENE_CLASS(DefaultCodec);
+    
+    public:
+        /// The name of this codec.
+        static const String CODEC_NAME;
+    
+    public:
+        virtual FormatPostingsFieldsConsumerPtr fieldsConsumer(SegmentWriteStatePtr state, FieldInfosPtr fieldInfos);
+        virtual TermInfosReaderPtr termsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t indexDivisor);
+        virtual TermDocsPtr termDocs(SegmentReaderPtr reader);
+        virtual TermPositionsPtr termPositions(SegmentReaderPtr reader);
+        virtual IndexInputPtr freqInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize);
+        virtual IndexInputPtr proxInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize);
+        virtual FieldsWriterPtr fieldsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos);
+        virtual FieldsReaderPtr fieldsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size);
+        virtual TermsHashConsumerPtr termVectorsConsumer(DocumentsWriterPtr docWriter);
+        virtual TermVectorsWriterPtr termVectorsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos);
+        virtual TermVectorsReaderPtr termVectorsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size);
+        virtual InvertedDocEndConsumerPtr normsConsumer();
+        virtual IndexOutputPtr normsOutput(DirectoryPtr dir, const String& segment);
+        virtual void writeNorms(IndexOutputPtr out, ByteArray norms, int32_t numDocs, bool reducedPrecision);
+        virtual Collection<int64_t> readNormEntries(IndexInputPtr in, int32_t numFields);
+        virtual NormValuesPtr readNorms(IndexInputPtr in, int64_t pos, int32_t numDocs, bool encoded, bool& mapped);
+        virtual DocValuesWriterPtr docValuesWriter(DirectoryPtr dir, const String& segment, int32_t numDocs);
+        virtual DocValuesReaderPtr docValuesReader(DirectoryPtr dir, const String& segment, int32_t readBufferSize);
+    };
+}
+
+#endif
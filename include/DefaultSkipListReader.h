@@ -22,16 +22,21 @@ namespace Lucene
     
     protected:
         bool currentFieldStoresPayloads;
+        bool currentFieldStoresFreqImpacts;
+        bool currentFieldStoresNormImpacts;
         Collection<int64_t> freqPointer;
         Collection<int64_t> proxPointer;
         Collection<int32_t> payloadLength;
+        Collection<int32_t> maxFreq;
+        Collection<int32_t> maxNorm;
         
         int64_t lastFreqPointer;
         int64_t lastProxPointer;
         int32_t lastPayloadLength;
         
     public:
-        void init(int64_t skipPointer, int64_t freqBasePointer, int64_t proxBasePointer, int32_t df, bool storesPayloads);
+        void init(int64_t skipPointer, int64_t freqBasePointer, int64_t proxBasePointer, int32_t df, bool storesPayloads, 
+                  bool storesFreqImpacts = false, bool storesNormImpacts = false);
         
         /// Returns the freq pointer of the doc to which the last call of {@link MultiLevelSkipListReader#skipTo(int)} 
         /// has skipped.
@@ -44,6 +49,22 @@ namespace Lucene
         /// Returns the payload length of the payload stored just before the doc to which the last call of {@link 
         /// MultiLevelSkipListReader#skipTo(int)} has skipped.
         int32_t getPayloadLength();
+        
+        /// Returns true if the current skip entry of the given level is known after the last call of {@link 
+        /// MultiLevelSkipListReader#skipTo(int)}.  Its impacts then bound the docs after the doc of the last 
+        /// entry skipped on that level up to {@link #getImpactDocUpTo}, which include the target of skipTo.
+        bool hasImpacts(int32_t level);
+        
+        /// Returns the last doc covered by the impacts of the current skip entry of the given level.
+        int32_t getImpactDocUpTo(int32_t level);
+        
+        /// Returns the greatest term freq of the docs covered by the current skip entry of the given level, or 
+        /// INT_MAX if the field doesn't record freqs in its skip entries.
+        int32_t getMaxFreq(int32_t level);
+        
+        /// Returns the greatest encoded norm of the docs covered by the current skip entry of the given level, 
+        /// or 255 if the field doesn't record norms in its skip entries.
+        int32_t getMaxNorm(int32_t level);
     
     protected:
         /// Seeks the skip entry on the given level
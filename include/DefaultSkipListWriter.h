@@ -26,6 +26,10 @@ namespace Lucene
         Collection<int64_t> lastSkipFreqPointer;
         Collection<int64_t> lastSkipProxPointer;
         
+        /// Greatest freq and norm of the docs since the last skip entry of each level
+        Collection<int32_t> levelMaxFreq;
+        Collection<int32_t> levelMaxNorm;
+        
         IndexOutputPtr freqOutput;
         IndexOutputPtr proxOutput;
         
@@ -34,13 +38,20 @@ namespace Lucene
         int32_t curPayloadLength;
         int64_t curFreqPointer;
         int64_t curProxPointer;
+        bool curStoreFreqImpacts;
+        bool curStoreNormImpacts;
     
     public:
         void setFreqOutput(IndexOutputPtr freqOutput);
         void setProxOutput(IndexOutputPtr proxOutput);
         
-        /// Sets the values for the current skip data.
-        void setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength);
+        /// Sets whether skip entries of the current field record the greatest freq and norm of the docs they 
+        /// skip over.
+        void setStoreImpacts(bool storeFreqImpacts, bool storeNormImpacts);
+        
+        /// Sets the values for the current skip data.  maxFreq and maxNorm are the greatest freq and encoded 
+        /// norm of the docs since the previous skip entry.
+        void setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength, int32_t maxFreq, int32_t maxNorm);
     
     protected:
         virtual void resetSkip();
@@ -67,6 +67,11 @@ namespace Lucene
         /// this parameter are {@link FSDirectory} and {@link CompoundFileReader}.
         virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
         
+        /// Returns the directory that merges read this directory's files through.  Directories that treat merge 
+        /// reads differently, such as {@link BlockCacheDirectory}, return a view of themselves.  By default it is 
+        /// this directory.
+        virtual DirectoryPtr getMergeReadDirectory();
+        
         /// Construct a {@link Lock}.
         /// @param name the name of the lock file.
         virtual LockPtr makeLock(const String& name);
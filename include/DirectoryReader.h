@@ -126,6 +126,9 @@ namespace Lucene
         /// Returns the number of documents containing the term t.
         virtual int32_t docFreq(TermPtr t);
         
+        /// Returns the number of documents containing each of the terms.
+        virtual Collection<int32_t> docFreqs(Collection<TermPtr> terms);
+        
         /// Returns an unpositioned {@link TermDocs} enumerator.
         virtual TermDocsPtr termDocs();
         
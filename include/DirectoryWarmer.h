@@ -0,0 +1,109 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DIRECTORYWARMER_H
+#define DIRECTORYWARMER_H
+
+#include "FSDirectory.h"
+
+namespace Lucene
+{
+    /// Brings the files of an index into memory before it takes traffic, so that the first queries after a restart
+    /// don't all go to disk.
+    ///
+    /// Each file extension is given a {@link FSDirectory.WarmMode}.  By default the terms index and norms are preloaded
+    /// and the operating system is advised that the terms dictionary, frequencies and doc values will be needed; other
+    /// files are left alone.  Files inside compound files are warmed according to their own extension.
+    ///
+    /// Warming only applies to {@link FSDirectory}s and does nothing for other directories.  It can run on the calling
+    /// thread or in the background, see {@link #setBackground}.  Subclasses can override {@link #progress} to report
+    /// progress.
+    /// @see IndexReader#open(DirectoryPtr, bool, DirectoryWarmerPtr)
+    class LPPAPI DirectoryWarmer : public LuceneObject
+    {
+    public:
+        DirectoryWarmer();
+        virtual ~DirectoryWarmer();
+    
+        LUCENE_CLASS(DirectoryWarmer);
+    
+    protected:
+        /// A range of a file to warm.
+        struct WarmRange
+        {
+            WarmRange(const String& fileName = L"", int64_t offset = 0, int64_t length = 0, FSDirectory::WarmMode mode = FSDirectory::WARM_NONE)
+            {
+                this->fileName = fileName;
+                this->offset = offset;
+                this->length = length;
+                this->mode = mode;
+            }
+            String fileName;
+            int64_t offset;
+            int64_t length;
+            FSDirectory::WarmMode mode;
+        };
+    
+        MapStringInt modes;
+        bool background;
+    
+        LuceneThreadPtr thread;
+        int64_t bytesWarmed;
+        int64_t bytesToWarm;
+        LuceneException error;
+    
+    public:
+        /// Sets how files with the given extension are warmed.
+        void setMode(const String& extension, FSDirectory::WarmMode mode);
+    
+        /// Returns how files with the given extension are warmed.
+        FSDirectory::WarmMode getMode(const String& extension);
+    
+        /// If true, {@link #warm} starts warming on a background thread and returns immediately.  Default is false.
+        void setBackground(bool background);
+    
+        /// @see #setBackground
+        bool getBackground();
+    
+        /// Warms the files referenced by an index commit.
+        void warm(IndexCommitPtr commit);
+    
+        /// Warms the given files of a directory.
+        void warm(DirectoryPtr directory, HashSet<String> files);
+    
+        /// Returns true while warming is running in the background.
+        bool isRunning();
+    
+        /// Waits for background warming to finish, throwing any exception it hit.
+        void waitForCompletion();
+    
+        /// Returns the number of bytes warmed so far.
+        int64_t getBytesWarmed();
+    
+        /// Returns the total number of bytes being warmed.
+        int64_t getBytesToWarm();
+    
+    protected:
+        /// Called after each file, or part of a compound file, has been warmed.  Default implementation does nothing.
+        /// @param fileName the file just warmed.
+        /// @param bytesWarmed the number of bytes warmed so far.
+        /// @param bytesToWarm the total number of bytes being warmed.
+        virtual void progress(const String& fileName, int64_t bytesWarmed, int64_t bytesToWarm);
+    
+        /// Returns the mode to use for a file, by its extension.
+        FSDirectory::WarmMode getFileMode(const String& fileName);
+    
+        /// Adds the ranges to warm for a file, looking inside compound files.
+        void addRanges(FSDirectoryPtr directory, const String& fileName, Collection<WarmRange> ranges);
+    
+        /// Warms the given ranges on the current thread.
+        void warmRanges(FSDirectoryPtr directory, Collection<WarmRange> ranges);
+    
+        friend class WarmerThread;
+    };
+}
+
+#endif
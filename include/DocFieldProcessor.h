@@ -27,6 +27,7 @@ namespace Lucene
         FieldInfosPtr fieldInfos;
         DocFieldConsumerPtr consumer;
         StoredFieldsWriterPtr fieldsWriter;
+        DocValuesConsumerPtr docValuesConsumer;
     
     public:
         virtual void closeDocStore(SegmentWriteStatePtr state);
@@ -38,6 +38,7 @@ namespace Lucene
         int32_t totalFieldCount;
         
         StoredFieldsWriterPerThreadPtr fieldsWriter;
+        DocValuesConsumerPerThreadPtr docValuesWriter;
         DocStatePtr docState;
         
         Collection<DocFieldProcessorPerThreadPerDocPtr> docFreeList;
@@ -0,0 +1,42 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESCONSUMER_H
+#define DOCVALUESCONSUMER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Buffers the per-document values of fields with a {@link Fieldable#getDocValuesType} while documents are 
+    /// indexed.  Each thread buffers the values of the documents it processed, and the flush method merges them 
+    /// into a single _X.dv file.
+    class DocValuesConsumer : public LuceneObject
+    {
+    public:
+        DocValuesConsumer(DocumentsWriterPtr docWriter);
+        virtual ~DocValuesConsumer();
+        
+        LUCENE_CLASS(DocValuesConsumer);
+    
+    public:
+        DocumentsWriterWeakPtr _docWriter;
+        
+        /// Column type of each field buffered since the last flush.
+        MapStringInt fieldTypes;
+    
+    public:
+        DocValuesConsumerPerThreadPtr addThread(DocStatePtr docState);
+        
+        /// Records the column type of a field, failing if another document of the segment used another type.
+        void checkType(const String& field, int32_t type);
+        
+        void flush(Collection<DocValuesConsumerPerThreadPtr> threads, SegmentWriteStatePtr state);
+        void abort();
+    };
+}
+
+#endif
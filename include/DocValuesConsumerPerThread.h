@@ -0,0 +1,57 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESCONSUMERPERTHREAD_H
+#define DOCVALUESCONSUMERPERTHREAD_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    class DocValuesConsumerPerThread : public LuceneObject
+    {
+    public:
+        DocValuesConsumerPerThread(DocStatePtr docState, DocValuesConsumerPtr docValuesConsumer);
+        virtual ~DocValuesConsumerPerThread();
+        
+        LUCENE_CLASS(DocValuesConsumerPerThread);
+    
+    public:
+        DocValuesConsumerWeakPtr _docValuesConsumer;
+        DocStatePtr docState;
+        MapStringDocValuesConsumerPerField fields;
+        
+        /// RAM used by the values of the current document, and by all values buffered since the last flush.
+        int64_t docBytesUsed;
+        int64_t bytesUsed;
+    
+    public:
+        void addField(FieldablePtr field);
+        void finishDocument();
+        
+        /// Drops all buffered values, after a flush or abort.
+        void reset();
+    };
+    
+    /// The values of one field buffered by one thread, in the order the documents were processed.
+    class DocValuesConsumerPerField : public LuceneObject
+    {
+    public:
+        DocValuesConsumerPerField(int32_t type);
+        virtual ~DocValuesConsumerPerField();
+        
+        LUCENE_CLASS(DocValuesConsumerPerField);
+    
+    public:
+        int32_t type;
+        Collection<int32_t> docIDs;
+        Collection<int64_t> numbers;
+        Collection<ByteArray> bytes;
+        Collection<String> strings;
+    };
+}
+
+#endif
@@ -0,0 +1,58 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESFIELD_H
+#define DOCVALUESFIELD_H
+
+#include "AbstractField.h"
+
+namespace Lucene
+{
+    /// A field that is neither indexed nor stored, and only writes its value to a column of per-document values.
+    ///
+    /// Use this for values that are only needed for sorting or function queries.  Numeric values are better
+    /// added with a {@link NumericField} whose doc values type is set to {@link #DOC_VALUES_NUMERIC}.
+    ///
+    /// <pre>
+    /// document->add(newLucene<DocValuesField>(L"category", category));
+    /// </pre>
+    class LPPAPI DocValuesField : public AbstractField
+    {
+    public:
+        /// Creates a field with a string value.
+        /// @param name the field name
+        /// @param value the field value
+        /// @param docValuesType how the value is written, {@link #DOC_VALUES_SORTED} by default
+        DocValuesField(const String& name, const String& value, DocValuesType docValuesType = DOC_VALUES_SORTED);
+        
+        /// Creates a field with a binary value, written as {@link #DOC_VALUES_BINARY}.
+        /// @param name the field name
+        /// @param value the field value
+        DocValuesField(const String& name, ByteArray value);
+        
+        virtual ~DocValuesField();
+        
+        LUCENE_CLASS(DocValuesField);
+    
+    public:
+        /// The value of the field as a String, or empty if the value is binary.
+        virtual String stringValue();
+        
+        /// Returns always null for doc values fields.
+        virtual ReaderPtr readerValue();
+        
+        /// Returns always null for doc values fields.
+        virtual TokenStreamPtr tokenStreamValue();
+        
+        /// Change the value of this field.
+        virtual void setValue(const String& value);
+        
+        /// Change the value of this field.
+        virtual void setValue(ByteArray value);
+    };
+}
+
+#endif
@@ -0,0 +1,61 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESREADER_H
+#define DOCVALUESREADER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Opens the per-document values written by {@link DocValuesWriter}.
+    ///
+    /// Only the directory of columns is read when the file is opened.  Each call for a column returns a new
+    /// accessor that reads values straight from a slice of the file, so with {@link MMapDirectory} looking up a 
+    /// value is a memory access and no column is ever copied onto the heap.  Accessors are not thread safe; each
+    /// thread should get its own.
+    class LPPAPI DocValuesReader : public LuceneObject
+    {
+    public:
+        DocValuesReader(DirectoryPtr dir, const String& segment, int32_t readBufferSize);
+        virtual ~DocValuesReader();
+        
+        LUCENE_CLASS(DocValuesReader);
+    
+    protected:
+        IndexInputPtr input;
+        MapStringInt fieldTypes;
+        MapStringLong fieldPointers;
+        MapStringLong fieldLengths;
+    
+    public:
+        /// Returns the names of the fields that have per-document values.
+        virtual HashSet<String> getFields();
+        
+        /// Returns the column type of a field, one of the DocValuesWriter TYPE_ constants, or -1 if the field has
+        /// no per-document values.
+        virtual int32_t getType(const String& field);
+        
+        /// Returns the numeric values of a field, or null if the field has no numeric values.
+        virtual NumericDocValuesPtr getNumeric(const String& field);
+        
+        /// Returns the binary values of a field, or null if the field has no binary values.
+        virtual BinaryDocValuesPtr getBinary(const String& field);
+        
+        /// Returns the sorted values of a field, or null if the field has no sorted values.
+        virtual SortedDocValuesPtr getSorted(const String& field);
+        
+        virtual void close();
+        
+        /// Reads a value written by {@link DocValuesWriter#writeFixed}.
+        static uint64_t readFixed(IndexInputPtr input, int32_t width);
+    
+    protected:
+        IndexInputPtr column(const String& field);
+    };
+}
+
+#endif
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef DOCVALUESWRITER_H
+#define DOCVALUESWRITER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Writes the per-document values of a segment to its _X.dv file.
+    ///
+    /// Each field is written as one column holding a value for every document of the segment.  Every value of
+    /// a column has the same width, so a reader finds the value of a document with a single seek and never has 
+    /// to load the column into memory:
+    ///
+    /// <ul>
+    /// <li>Numeric columns hold the minimum value followed by each document's difference from it, in the fewest 
+    /// bytes that fit the largest difference.
+    /// <li>Binary columns hold the offset of each document's bytes, followed by the bytes.
+    /// <li>Sorted columns hold each document's ordinal in a sorted dictionary of the distinct values, followed by 
+    /// the offset of each dictionary entry and the UTF-8 bytes of the entries.
+    /// </ul>
+    ///
+    /// The columns are followed by a directory of field names, column types and column positions, and then by the 
+    /// position of the directory.
+    class LPPAPI DocValuesWriter : public LuceneObject
+    {
+    public:
+        DocValuesWriter(DirectoryPtr directory, const String& segment, int32_t numDocs);
+        virtual ~DocValuesWriter();
+        
+        LUCENE_CLASS(DocValuesWriter);
+    
+    public:
+        static const int32_t FORMAT_CURRENT;
+        
+        static const uint8_t TYPE_LONG;
+        static const uint8_t TYPE_DOUBLE;
+        static const uint8_t TYPE_BINARY;
+        static const uint8_t TYPE_SORTED;
+    
+    protected:
+        IndexOutputPtr output;
+        int32_t numDocs;
+        
+        Collection<String> fieldNames;
+        Collection<int32_t> fieldTypes;
+        Collection<int64_t> fieldPointers;
+    
+    public:
+        /// Writes a numeric column.
+        /// @param values a value for each document.  Double values are given as {@link MiscUtils#doubleToLongBits}.
+        virtual void addNumericField(const String& field, Collection<int64_t> values, bool isDouble);
+        
+        /// Writes a binary column.
+        /// @param values the bytes of each document; documents without a value are null.
+        virtual void addBinaryField(const String& field, Collection<ByteArray> values);
+        
+        /// Writes a sorted column.
+        /// @param dictionary the distinct values, in sorted order.
+        /// @param ords the index into dictionary of each document's value, or -1 for documents without a value.
+        virtual void addSortedField(const String& field, Collection<String> dictionary, Collection<int32_t> ords);
+        
+        /// Writes the directory of columns and closes the file.
+        virtual void close();
+        
+        /// Returns the number of bytes needed to hold values up to the given value.
+        static int32_t bytesRequired(uint64_t maxValue);
+        
+        /// Writes the low width bytes of a value, most significant first.
+        static void writeFixed(IndexOutputPtr output, uint64_t value, int32_t width);
+    
+    protected:
+        void startField(const String& field, uint8_t type);
+    };
+}
+
+#endif
@@ -104,6 +104,10 @@ namespace Lucene
         
         /// List of files that were written before last abort()
         HashSet<String> _abortedFiles;
+        
+        /// Doc store outputs whose close failed during abort().  Segments flushed before the abort may share 
+        /// the doc store, so these are closed again before the next flush.
+        Collection<IndexOutputPtr> unclosedDocStoreOutputs;
         SegmentWriteStatePtr flushState;
         
         Collection<IntArray> freeIntBlocks;
@@ -156,6 +160,7 @@ namespace Lucene
         IndexWriterWeakPtr _writer;
         DirectoryPtr directory;
         IndexingChainPtr indexingChain;
+        CodecPtr codec; // Writes the files of the segments we flush
         String segment; // Current segment we are working on
         
         int32_t numDocsInStore; // # docs written to doc stores
@@ -213,6 +218,11 @@ namespace Lucene
         void setMaxBufferedDocs(int32_t count);
         int32_t getMaxBufferedDocs();
         
+        /// Set the codec that writes flushed segments.  The indexing chain is rebuilt for the new codec, so
+        /// no documents may be buffered and the doc stores must be closed.
+        void setCodec(CodecPtr codec);
+        CodecPtr getCodec();
+        
         /// Get current segment name we are writing.
         String getSegment();
         
@@ -231,6 +241,13 @@ namespace Lucene
         
         HashSet<String> abortedFiles();
         
+        /// Called by a doc store consumer whose output could not be closed during abort().
+        void addUnclosedDocStoreOutput(IndexOutputPtr output);
+        
+        /// Closes the doc store outputs whose close failed during abort(), so that the footers of files shared 
+        /// by already flushed segments are written before they are committed.
+        void closeUnclosedDocStoreOutputs();
+        
         void message(const String& message);
         
         /// Returns Collection of files in use by this instance, including any flushed segments.
@@ -254,14 +271,18 @@ namespace Lucene
         
         void initFlushState(bool onlyDocStore);
         
-        /// Flush all pending docs to a new segment
-        int32_t flush(bool _closeDocStore);
+        /// Flush all pending docs to a new segment.  If stageCompoundFile is true, the segment's files are 
+        /// held in RAM (up to a limit) until {@link #createCompoundFile} or {@link #writeStagedFiles} is called.
+        int32_t flush(bool _closeDocStore, bool stageCompoundFile = false);
         
         HashSet<String> getFlushedFiles();
         
         /// Build compound file for the segment we just flushed
         void createCompoundFile(const String& segment);
         
+        /// Write any files of the segment we just flushed that are still held in RAM to the directory.
+        void writeStagedFiles();
+        
         /// Set flushPending if it is not already set and returns whether it was set. This is used by IndexWriter 
         /// to trigger a single flush even when multiple threads are trying to do so.
         bool setFlushPending();
@@ -0,0 +1,45 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef EARLYTERMINATINGSORTINGCOLLECTOR_H
+#define EARLYTERMINATINGSORTINGCOLLECTOR_H
+
+#include "Collector.h"
+
+namespace Lucene
+{
+    /// A {@link Collector} implementation which wraps another {@link Collector} and stops collecting a segment 
+    /// once it has seen a given number of documents, if the segment is physically ordered by the sort of the 
+    /// search (see {@link IndexWriter#setIndexSort}).  The remaining documents of such a segment can't compete 
+    /// with those already collected.  Segments in another order are collected in full.
+    ///
+    /// Wrapping a {@link TopFieldCollector} that keeps numDocsToCollect hits with the same sort gives the same top 
+    /// hits, but the total hit count only counts the documents that were collected, and scores are only tracked 
+    /// for those documents.
+    class LPPAPI EarlyTerminatingSortingCollector : public Collector
+    {
+    public:
+        EarlyTerminatingSortingCollector(CollectorPtr collector, SortPtr sort, int32_t numDocsToCollect);
+        virtual ~EarlyTerminatingSortingCollector();
+        
+        LUCENE_CLASS(EarlyTerminatingSortingCollector);
+    
+    protected:
+        CollectorPtr collector;
+        SortPtr sort;
+        int32_t numDocsToCollect;
+        int32_t numCollected;
+        bool segmentSorted;
+    
+    public:
+        virtual void collect(int32_t doc);
+        virtual void setNextReader(IndexReaderPtr reader, int32_t docBase);
+        virtual void setScorer(ScorerPtr scorer);
+        virtual bool acceptsDocsOutOfOrder();
+    };
+}
+
+#endif
@@ -14,6 +14,7 @@ namespace Lucene
     class ExactPhraseScorer : public PhraseScorer
     {
     public:
+        ExactPhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, NormValuesPtr norms);
         ExactPhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, ByteArray norms);
         virtual ~ExactPhraseScorer();
     
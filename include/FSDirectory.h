@@ -14,7 +14,13 @@ namespace Lucene
     /// Base class for Directory implementations that store index files in the file system.  There are currently three 
     /// core subclasses:
     ///
-    /// {@link SimpleFSDirectory} is a straightforward implementation using std::ofstream and std::ifstream.
+    /// {@link SimpleFSDirectory} is a straightforward implementation using std::ofstream and std::ifstream.  However, 
+    /// it has poor concurrent performance (multiple threads will bottleneck) as it synchronizes when multiple threads 
+    /// read from the same file.
+    ///
+    /// {@link NIOFSDirectory} uses positional reads (pread) on a shared file descriptor, which allows multiple threads 
+    /// to read from the same file without synchronizing.  {@link #open} only returns it when asked for positional 
+    /// reads, and never on Windows, where positional reads still move the shared file pointer.
     ///
     /// {@link MMapDirectory} uses memory-mapped IO when reading. This is a good choice if you have plenty of virtual 
     /// memory relative to your index size, eg if you are running on a 64 bit operating system, oryour index sizes are 
@@ -44,7 +50,26 @@ namespace Lucene
         /// @see #setReadChunkSize
         static const int32_t DEFAULT_READ_CHUNK_SIZE;
         
+        /// How {@link #warmFile} brings a file into memory.
+        enum WarmMode
+        {
+            /// Don't warm the file.
+            WARM_NONE,
+            
+            /// Ask the operating system to read the file ahead of use, without waiting for it.
+            WARM_ADVISE,
+            
+            /// Read the whole file, so that it is in the operating system's cache on return.
+            WARM_PRELOAD,
+            
+            /// Preload the file and lock it in memory, where the implementation supports it.
+            WARM_LOCK
+        };
+        
     protected:
+        /// Size of the reads used to preload files in {@link #warmFile}.
+        static const int32_t WARM_BUFFER_SIZE;
+        
         bool checked;
         
         /// The underlying filesystem directory.
@@ -60,6 +85,10 @@ namespace Lucene
         /// Just like {@link #open(File)}, but allows you to also specify a custom {@link LockFactory}.
         static FSDirectoryPtr open(const String& path, LockFactoryPtr lockFactory);
         
+        /// Just like {@link #open(File, LockFactory)}, but with positionalReads returns an {@link NIOFSDirectory} 
+        /// where it is supported (not on Windows), so that threads reading the same file don't synchronize.
+        static FSDirectoryPtr open(const String& path, LockFactoryPtr lockFactory, bool positionalReads);
+        
         /// Lists all files (not subdirectories) in the directory.
         /// @throws NoSuchDirectoryException if the directory does not exist, or does exist but is not a directory.
         static HashSet<String> listAll(const String& dir);
@@ -118,6 +147,16 @@ namespace Lucene
         /// Return a string identifier that uniquely differentiates this Directory instance from other Directory instances.
         virtual String getLockID();
         
+        /// Brings a range of a file into memory ahead of use.  This implementation advises the operating system where it 
+        /// can, and otherwise reads the range; {@link #WARM_LOCK} is treated as {@link #WARM_PRELOAD}, since nothing is 
+        /// mapped to lock.
+        /// @param name the file to warm.
+        /// @param mode how to warm the file.
+        /// @param offset the start of the range to warm.
+        /// @param length the length of the range to warm, or -1 for the rest of the file.
+        /// @see DirectoryWarmer
+        virtual void warmFile(const String& name, WarmMode mode, int64_t offset = 0, int64_t length = -1);
+        
         /// Closes the store to future operations.
         virtual void close();
         
@@ -127,6 +166,9 @@ namespace Lucene
     protected:
         /// Initializes the directory to create a new file with the given name. This method should be used in {@link #createOutput}.
         void initOutput(const String& name);
+        
+        /// Checks the range passed to {@link #warmFile} and returns its length.
+        int64_t checkWarmRange(const String& name, int64_t offset, int64_t length);
     };
 }
 
@@ -0,0 +1,90 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef FST_H
+#define FST_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// A finite state transducer mapping byte sequences to non-negative outputs, built in sorted key order
+    /// by {@link FSTBuilder}.
+    ///
+    /// Keys that share a prefix share the nodes of that prefix, and keys that share a suffix share the nodes
+    /// of the suffix, so a large sorted key set takes a small fraction of the memory of storing the keys.  The
+    /// output of a key is the sum of the outputs on its path, which requires outputs to increase with the keys.
+    ///
+    /// The whole transducer is one byte array.  A node is a flags byte, the node's final output as a VLong if
+    /// it has one, the number of arcs as a VInt and, if there are any arcs, the number of bytes per arc as a
+    /// VInt followed by the arcs.  Each arc is its label byte, its output as a VLong and the address of its
+    /// target node as a VInt, padded to the same size so that a node's arcs can be binary searched.
+    class LPPAPI FST : public LuceneObject
+    {
+    public:
+        FST(ByteArray bytes, int32_t length, int32_t startNode);
+        
+        /// Reads a transducer written by {@link #write}.
+        FST(IndexInputPtr in);
+        
+        virtual ~FST();
+        
+        LUCENE_CLASS(FST);
+    
+    public:
+        static const uint8_t FLAG_FINAL;
+        static const uint8_t FLAG_FINAL_OUTPUT;
+    
+    protected:
+        ByteArray bytes;
+        int32_t length;
+        int32_t startNode;
+    
+    public:
+        /// Returns the output of the given key, or -1 if the key is not accepted.
+        int64_t get(const uint8_t* key, int32_t keyLength);
+        
+        /// Finds the greatest accepted key that is less than or equal to the given key.
+        /// @param floorKey set to the key found.
+        /// @return the output of the key found, or -1 if every accepted key is greater.
+        int64_t floor(const uint8_t* key, int32_t keyLength, UTF8ResultPtr floorKey);
+        
+        /// Finds the least accepted key that is greater than or equal to the given key.
+        /// @param ceilKey set to the key found.
+        /// @return the output of the key found, or -1 if every accepted key is less.
+        int64_t ceil(const uint8_t* key, int32_t keyLength, UTF8ResultPtr ceilKey);
+        
+        /// Finds the key of the given output, which is only possible when the outputs increase with the keys 
+        /// (as the ordinals of the terms index do), as each arc then carries the least output below it.
+        /// @param key set to the key found.
+        /// @return false if no key has the output.
+        bool getKey(int64_t output, UTF8ResultPtr key);
+        
+        /// Returns the number of bytes used by the transducer.
+        int32_t sizeInBytes();
+        
+        /// Writes the transducer so that it can be read back with {@link #FST(IndexInputPtr)}.
+        void write(IndexOutputPtr out);
+    
+    protected:
+        /// Reads the header of the node at the given address.
+        /// @return the address of the node's first arc.
+        int32_t readNode(int32_t address, bool& isFinal, int64_t& finalOutput, int32_t& numArcs, int32_t& bytesPerArc);
+        
+        /// Reads an arc of a node.
+        /// @return the arc's label.
+        int32_t readArc(int32_t arcs, int32_t bytesPerArc, int32_t arc, int64_t& output, int32_t& target);
+        
+        /// Returns the index of the first arc of a node whose label is greater than or equal to the given label.
+        int32_t findArc(int32_t arcs, int32_t bytesPerArc, int32_t numArcs, int32_t label);
+        
+        /// Follows the greatest (or least) arcs from the given node to an accepted key, appending their labels
+        /// to result and returning output plus their outputs.
+        int64_t followEdge(int32_t node, int64_t output, bool greatest, UTF8ResultPtr result);
+    };
+}
+
+#endif
@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef FSTBUILDER_H
+#define FSTBUILDER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Builds a minimal {@link FST} from keys added in sorted order.
+    ///
+    /// Only the nodes along the path of the last key added are held uncompiled.  When a key is added, the
+    /// nodes of the previous key past the prefix the two keys share can no longer change, so they are
+    /// compiled into the byte array, reusing any identical node that was compiled before.  Outputs are pushed
+    /// as close to the root as possible so that keys with a common prefix share the common part of their
+    /// outputs.
+    class LPPAPI FSTBuilder : public LuceneObject
+    {
+    public:
+        FSTBuilder();
+        virtual ~FSTBuilder();
+        
+        LUCENE_CLASS(FSTBuilder);
+    
+    protected:
+        /// Compiled nodes.
+        ByteArray bytes;
+        int32_t length;
+        
+        /// Uncompiled nodes along the path of the last key added; frontier[i] follows the i'th byte.
+        Collection<FSTBuilderNodePtr> frontier;
+        
+        ByteArray lastKey;
+        int32_t lastKeyLength;
+        int64_t numKeys;
+        
+        /// Node being compiled.
+        ByteArray scratch;
+        
+        /// Open addressing hash of compiled node addresses, used to share identical nodes.
+        IntArray nodeTable;
+        IntArray nodeHashes;
+        int32_t numNodes;
+    
+    public:
+        /// Adds a key, which must be greater than every key added before.  Outputs must not be negative and must
+        /// not decrease from one key to the next.
+        void add(const uint8_t* key, int32_t keyLength, int64_t output);
+        
+        /// Returns the number of keys added.
+        int64_t size();
+        
+        /// Compiles the remaining nodes and returns the transducer.  The builder can't be used afterwards.
+        FSTPtr finish();
+    
+    protected:
+        /// Compiles the nodes of the last key past the given prefix length.
+        void freezeTail(int32_t prefixLength);
+        
+        /// Returns the address of a node identical to the given node, compiling it if there isn't one.
+        int32_t compileNode(FSTBuilderNodePtr node);
+        
+        void rehash();
+        void appendVInt(ByteArray& buffer, int32_t& upto, int32_t i);
+        void appendVLong(ByteArray& buffer, int32_t& upto, int64_t i);
+    };
+}
+
+#endif
@@ -174,6 +174,7 @@ namespace Lucene
     };
     
     /// Parses field's values as double (using {@link FieldCache#getDoubles} and sorts by ascending value
+    /// If the field has numeric per-document values (see {@link IndexReader#getNumericDocValues}) these are used instead.
     class LPPAPI DoubleComparator : public NumericComparator<double>
     {
     public:
@@ -184,14 +185,19 @@ namespace Lucene
     
     protected:
         DoubleParserPtr parser;
+        
+        /// The field's per-document values in the current reader, read in place of the field cache.
+        NumericDocValuesPtr docValues;
     
     public:
         virtual int32_t compare(int32_t slot1, int32_t slot2);
         virtual int32_t compareBottom(int32_t doc);
+        virtual void copy(int32_t slot, int32_t doc);
         virtual void setNextReader(IndexReaderPtr reader, int32_t docBase);
     };
     
     /// Parses field's values as int (using {@link FieldCache#getInts} and sorts by ascending value
+    /// If the field has numeric per-document values (see {@link IndexReader#getNumericDocValues}) these are used instead.
     class LPPAPI IntComparator : public NumericComparator<int32_t>
     {
     public:
@@ -202,14 +208,19 @@ namespace Lucene
     
     protected:
         IntParserPtr parser;
+        
+        /// The field's per-document values in the current reader, read in place of the field cache.
+        NumericDocValuesPtr docValues;
     
     public:
         virtual int32_t compare(int32_t slot1, int32_t slot2);
         virtual int32_t compareBottom(int32_t doc);
+        virtual void copy(int32_t slot, int32_t doc);
         virtual void setNextReader(IndexReaderPtr reader, int32_t docBase);
     };
     
     /// Parses field's values as long (using {@link FieldCache#getLongs} and sorts by ascending value
+    /// If the field has numeric per-document values (see {@link IndexReader#getNumericDocValues}) these are used instead.
     class LPPAPI LongComparator : public NumericComparator<int64_t>
     {
     public:
@@ -220,10 +231,14 @@ namespace Lucene
     
     protected:
         LongParserPtr parser;
+        
+        /// The field's per-document values in the current reader, read in place of the field cache.
+        NumericDocValuesPtr docValues;
     
     public:
         virtual int32_t compare(int32_t slot1, int32_t slot2);
         virtual int32_t compareBottom(int32_t doc);
+        virtual void copy(int32_t slot, int32_t doc);
         virtual void setNextReader(IndexReaderPtr reader, int32_t docBase);
     };
     
@@ -279,6 +294,9 @@ namespace Lucene
     /// index returned by {@link FieldCache#getStringIndex}), and does most comparisons using the ordinals.  
     /// For medium to large results, this comparator will be much faster than {@link StringValComparator}.  For 
     /// very small result sets it may be slower.
+    ///
+    /// If the field has sorted per-document values (see {@link IndexReader#getSortedDocValues}), their ordinals
+    /// are used instead of the field cache.
     class LPPAPI StringOrdValComparator : public FieldComparator
     {
     public:
@@ -296,6 +314,7 @@ namespace Lucene
         Collection<String> lookup;
         Collection<int32_t> order;
         String field;
+        SortedDocValuesPtr docValues;
         
         int32_t bottomSlot;
         int32_t bottomOrd;
@@ -315,6 +334,15 @@ namespace Lucene
         virtual String getField();
     
     protected:
+        /// Returns the ordinal of a document in the current reader, where 0 means no value.
+        int32_t getOrder(int32_t doc);
+        
+        /// Returns the value of an ordinal of the current reader.
+        String getLookup(int32_t ord);
+        
+        /// Returns the number of ordinals of the current reader, including 0.
+        int32_t getLookupSize();
+        
         void convert(int32_t slot);
         int32_t binarySearch(Collection<String> lookup, const String& key, int32_t low, int32_t high);
     };
@@ -34,6 +34,9 @@ namespace Lucene
         bool omitTermFreqAndPositions;
         
         bool storePayloads; // whether this field stores payloads together with term positions
+        
+        bool reducedPrecisionNorms; // norms are rounded to at most 16 distinct values
+        bool bloomFiltered; // each segment keeps a bloom filter of the field's terms
     
     public:
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
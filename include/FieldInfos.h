@@ -35,6 +35,9 @@ namespace Lucene
         
         // First used in 2.9; prior to 2.9 there was no format header
         static const int32_t FORMAT_START;
+        
+        // The bits of each field are written as a VInt, to make room for BLOOM_FILTERED
+        static const int32_t FORMAT_BLOOM_FILTERS;
 
         static const int32_t CURRENT_FORMAT;
 
@@ -45,6 +48,8 @@ namespace Lucene
         static const uint8_t OMIT_NORMS;
         static const uint8_t STORE_PAYLOADS;
         static const uint8_t OMIT_TERM_FREQ_AND_POSITIONS;
+        static const uint8_t REDUCED_PRECISION_NORMS;
+        static const int32_t BLOOM_FILTERED;
     
     protected:
         Collection<FieldInfoPtr> byNumber;
@@ -137,6 +142,13 @@ namespace Lucene
         
         bool hasVectors();
         
+        /// Returns true if any field keeps a bloom filter of its terms.
+        bool hasBloomFilters();
+        
+        /// Returns true if these field infos were read from a segment whose files end with a {@link 
+        /// ChecksumFooter}, which is every segment written in {@link #FORMAT_BLOOM_FILTERS} or later.
+        bool hasChecksumFooters();
+        
         void write(DirectoryPtr d, const String& name);
         void write(IndexOutputPtr output);
         
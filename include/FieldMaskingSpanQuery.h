@@ -67,6 +67,7 @@ namespace Lucene
         virtual String getField();
         SpanQueryPtr getMaskedQuery();
         virtual SpansPtr getSpans(IndexReaderPtr reader);
+        virtual DocIdSetIteratorPtr getApproximation(IndexReaderPtr reader);
         virtual void extractTerms(SetTerm terms);
         virtual WeightPtr createWeight(SearcherPtr searcher);
         virtual SimilarityPtr getSimilarity(SearcherPtr searcher);
@@ -22,6 +22,23 @@ namespace Lucene
     public:
         LUCENE_INTERFACE(Fieldable);
     
+    public:
+        /// Specifies whether and how per-document values of a field are written to the index.
+        enum DocValuesType
+        {
+            /// Do not write per-document values.
+            DOC_VALUES_NONE,
+            /// Write one numeric value per document.  The value of a {@link NumericField} is written as it was
+            /// set; the value of any other field is parsed from its string value as a long.
+            DOC_VALUES_NUMERIC,
+            /// Write the raw bytes of the field's binary value, or the UTF-8 bytes of its string value, for
+            /// each document.
+            DOC_VALUES_BINARY,
+            /// Write the field's string value for each document, deduplicated into a sorted dictionary so
+            /// that documents can be compared by ordinal.
+            DOC_VALUES_SORTED
+        };
+    
     public:
         /// Sets the boost factor hits on this field.  This value will be multiplied into the score of all 
         /// hits on this this field of this document.
@@ -145,6 +162,31 @@ namespace Lucene
         /// positional information, such as {@link PhraseQuery} or {@link SpanQuery} subclasses will silently fail 
         /// to find results.
         virtual void setOmitTermFreqAndPositions(bool omitTermFreqAndPositions) = 0;
+        
+        /// @see #setDocValuesType
+        virtual DocValuesType getDocValuesType() = 0;
+        
+        /// If set to anything other than {@link #DOC_VALUES_NONE}, the field's value is also written to a 
+        /// column of per-document values, which sorting and function queries can read without uninverting the 
+        /// field.  A document should have at most one value for such a field, and all documents must use the 
+        /// same type for a given field.
+        /// @see IndexReader#getNumericDocValues
+        virtual void setDocValuesType(DocValuesType docValuesType) = 0;
+        
+        /// @see #setReducedPrecisionNorms
+        virtual bool getReducedPrecisionNorms() = 0;
+        
+        /// If set, the norms of this indexed field are rounded to the 16 most common values in each segment, 
+        /// so that they can be stored in half a byte per document.  Once set for a field it stays set.
+        virtual void setReducedPrecisionNorms(bool reducedPrecisionNorms) = 0;
+        
+        /// @see #setBloomFiltered
+        virtual bool isBloomFiltered() = 0;
+        
+        /// If set, each segment keeps a Bloom filter of the terms of this indexed field, so that looking up a 
+        /// term the segment doesn't have (such as a unique key in all but one segment) rarely has to search the 
+        /// terms dictionary.  Once set for a field it stays set.
+        virtual void setBloomFiltered(bool bloomFiltered) = 0;
     };
 }
 
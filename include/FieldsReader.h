@@ -50,6 +50,20 @@ namespace Lucene
         CloseableThreadLocal<IndexInput> fieldsStreamTL;
         bool isOriginal;
         
+        /// First document and file pointer of each chunk, followed by the number of documents and the end of
+        /// the chunks.  Only used by compressed formats.
+        Collection<int32_t> chunkDocs;
+        Collection<int64_t> chunkPointers;
+        
+        /// The last chunk decompressed, kept for documents read in sequence.
+        int32_t currentChunk;
+        IntArray chunkOffsets;
+        ByteArray chunkBytes;
+        IndexInputPtr chunkStream;
+        
+        /// Stream the fields of the current document are read from: either fieldsStream or chunkStream.
+        IndexInputPtr docStream;
+        
     public:
         /// Returns a cloned FieldsReader that shares open IndexInputs with the original one.  It is the caller's job not to 
         /// close the original FieldsReader until all clones are called (eg, currently SegmentReader manages this logic).
@@ -57,17 +71,17 @@ namespace Lucene
         
         /// Closes the underlying {@link IndexInput} streams, including any ones associated with a lazy implementation of a 
         /// Field.  This means that the Fields values will not be accessible.
-        void close();
+        virtual void close();
         
-        int32_t size();
+        virtual int32_t size();
         
-        bool canReadRawDocs();
+        virtual bool canReadRawDocs();
         
-        DocumentPtr doc(int32_t n, FieldSelectorPtr fieldSelector);
+        virtual DocumentPtr doc(int32_t n, FieldSelectorPtr fieldSelector);
         
         /// Returns the length in bytes of each raw document in a contiguous range of length numDocs starting with startDocID.  
         /// Returns the IndexInput (the fieldStream), already seeked to the starting point for startDocID.
-        IndexInputPtr rawDocs(Collection<int32_t> lengths, int32_t startDocID, int32_t numDocs);
+        virtual IndexInputPtr rawDocs(Collection<int32_t> lengths, int32_t startDocID, int32_t numDocs);
     
     protected:
         void ConstructReader(DirectoryPtr d, const String& segment, FieldInfosPtr fn, int32_t readBufferSize, int32_t docStoreOffset, int32_t size);
@@ -76,6 +90,12 @@ namespace Lucene
         
         void seekIndex(int32_t docID);
         
+        void readChunkIndex(int64_t indexSize);
+        
+        /// Decompresses the chunk holding a document, if it isn't already the current chunk.
+        /// @return the offset of the document in the chunk.
+        int32_t loadChunk(int32_t docID);
+        
         /// Skip the field.  We still have to read some of the information about the field, but can skip past the actual content.  
         /// This will have the most payoff on large fields.
         void skipField(bool binary, bool compressed);
@@ -109,6 +129,9 @@ namespace Lucene
         int32_t toRead;
         int64_t pointer;
         
+        /// Decompressed chunk holding the field, for compressed formats.
+        IndexInputPtr chunkStream;
+        
         /// @deprecated Only kept for backward-compatibility with <3.0 indexes.
         bool isCompressed;
     
@@ -135,6 +158,8 @@ namespace Lucene
         
     protected:
         IndexInputPtr getFieldStream();
+        
+        friend class FieldsReader;
     };
 }
 
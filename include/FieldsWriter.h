@@ -11,6 +11,13 @@
 
 namespace Lucene
 {
+    /// Writes stored fields to <segment>.fdt and <segment>.fdx.
+    ///
+    /// Consecutive documents are buffered into chunks of about {@link #CHUNK_SIZE} bytes that are compressed
+    /// together with {@link LZ4}, so that the redundancy between documents is compressed away as well as the
+    /// redundancy within them.  Each chunk in the fdt file is the number of documents, the length of each
+    /// document and the compressed documents.  The fdx file holds the number of documents and the compressed
+    /// length of each chunk, from which the reader builds the map from document to chunk.
     class FieldsWriter : public LuceneObject
     {
     public:
@@ -25,6 +32,16 @@ namespace Lucene
         IndexOutputPtr fieldsStream;
         IndexOutputPtr indexStream;
         bool doClose;
+        
+        /// Documents of the chunk being buffered.
+        RAMFilePtr chunkFile;
+        RAMOutputStreamPtr chunkBuffer;
+        Collection<int32_t> chunkDocLengths;
+        int64_t docStart;
+        int32_t numDocs;
+        
+        ByteArray chunkBytes;
+        LZ4Ptr compressor;
     
     public:
         static const uint8_t FIELD_IS_TOKENIZED;
@@ -34,28 +51,54 @@ namespace Lucene
         static const int32_t FORMAT; // Original format
         static const int32_t FORMAT_VERSION_UTF8_LENGTH_IN_BYTES; // Changed strings to UTF8
         static const int32_t FORMAT_LUCENE_3_0_NO_COMPRESSED_FIELDS; // Lucene 3.0: Removal of compressed fields
+        static const int32_t FORMAT_COMPRESSED_CHUNKS; // Documents compressed together in chunks
         
         // NOTE: if you introduce a new format, make it 1 higher than the current one, and always change this
         // if you switch to a new format!
         static const int32_t FORMAT_CURRENT;
+        
+        /// Number of bytes of documents after which a chunk is compressed and written.
+        static const int32_t CHUNK_SIZE;
+        
+        /// Greatest number of documents in a chunk, so that tiny documents don't make a chunk's header large.
+        static const int32_t MAX_DOCUMENTS_PER_CHUNK;
     
     public:
         void setFieldsStream(IndexOutputPtr stream);
         
         /// Writes the contents of buffer into the fields stream and adds a new entry for this document into the index 
         /// stream.  This assumes the buffer was already written in the correct fields format.
-        void flushDocument(int32_t numStoredFields, RAMOutputStreamPtr buffer);
+        virtual void flushDocument(int32_t numStoredFields, RAMOutputStreamPtr buffer);
+        
+        /// Returns the number of documents added, including those still buffered in the current chunk.
+        int32_t getNumDocs();
+        
+        virtual void skipDocument();
+        virtual void flush();
+        virtual void close();
+        
+        /// Returns the streams that are still open, which after {@link #close} are those whose close failed.
+        Collection<IndexOutputPtr> getOpenStreams();
         
-        void skipDocument();
-        void flush();
-        void close();
         void writeField(FieldInfoPtr fi, FieldablePtr field);
         
         /// Bulk write a contiguous series of documents.  The lengths array is the length (in bytes) of each raw document.  
-        /// The stream IndexInput is the fieldsStream from which we should bulk-copy all bytes.
-        void addRawDocuments(IndexInputPtr stream, Collection<int32_t> lengths, int32_t numDocs);
+        /// The stream IndexInput holds the uncompressed documents from which we should bulk-copy all bytes.
+        virtual void addRawDocuments(IndexInputPtr stream, Collection<int32_t> lengths, int32_t numDocs);
+        
+        virtual void addDocument(DocumentPtr doc);
+    
+    protected:
+        void writeField(IndexOutputPtr out, FieldInfoPtr fi, FieldablePtr field);
+        
+        /// Returns the chunk buffer, positioned to append a document.
+        IndexOutputPtr startDocument();
+        
+        /// Records the length of the document just appended and writes the chunk if it is full.
+        void finishDocument();
         
-        void addDocument(DocumentPtr doc);
+        /// Compresses the buffered documents and writes them as a chunk.
+        void flushChunk();
     };
 }
 
@@ -49,9 +49,14 @@ namespace Lucene
         virtual bool hasNorms(const String& field);
         virtual ByteArray norms(const String& field);
         virtual void norms(const String& field, ByteArray norms, int32_t offset);
+        virtual NormValuesPtr normValues(const String& field);
+        virtual NumericDocValuesPtr getNumericDocValues(const String& field);
+        virtual BinaryDocValuesPtr getBinaryDocValues(const String& field);
+        virtual SortedDocValuesPtr getSortedDocValues(const String& field);
         virtual TermEnumPtr terms();
         virtual TermEnumPtr terms(TermPtr t);
         virtual int32_t docFreq(TermPtr t);
+        virtual Collection<int32_t> docFreqs(Collection<TermPtr> terms);
         virtual TermDocsPtr termDocs();
         virtual TermDocsPtr termDocs(TermPtr term);
         virtual TermPositionsPtr termPositions();
@@ -97,6 +102,7 @@ namespace Lucene
         virtual bool next();
         virtual int32_t read(Collection<int32_t> docs, Collection<int32_t> freqs);
         virtual bool skipTo(int32_t target);
+        virtual int32_t advanceShallow(int32_t target, int32_t& maxFreq, int32_t& maxNorm);
         virtual void close();
     };
 
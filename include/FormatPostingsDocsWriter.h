@@ -37,6 +37,20 @@ namespace Lucene
         int32_t lastDocID;
         int32_t df;
         
+        /// Norms of the current field, and the greatest freq and norm of the docs since the last skip entry.
+        NormValuesPtr norms;
+        int32_t blockMaxFreq;
+        int32_t blockMaxNorm;
+        
+        /// How doc and freq data is encoded, one of the TermInfosWriter::POSTINGS_FORMAT constants.
+        int32_t postingsFormat;
+        
+        /// Doc deltas and freqs buffered until a block is full, when writing block packed postings.
+        BlockPackedIntsPtr blockPacker;
+        IntArray docDeltaBuffer;
+        IntArray freqBuffer;
+        int32_t bufferCount;
+        
         TermInfoPtr termInfo; // minimize consing
         UTF8ResultPtr utf8;
     
@@ -52,6 +66,16 @@ namespace Lucene
         virtual void finish();
         
         void close();
+    
+    protected:
+        /// Adds the freq and norm of a doc to the impacts of the current skip block.
+        void addImpact(int32_t docID, int32_t termDocFreq);
+        
+        /// Writes the buffered docs as a block of packed deltas followed by a block of packed freqs.
+        void flushBlock();
+        
+        /// Writes the buffered docs as VInts, as the last docs of a term that don't fill a block.
+        void flushTail();
     };
 }
 
@@ -14,8 +14,9 @@ namespace Lucene
     /// Implements the fuzzy search query.  The similarity measurement is based on the Levenshtein (edit 
     /// distance) algorithm.
     ///
-    /// Warning: this query is not very scalable with its default prefix length of 0 - in this case, *every* 
-    /// term will be enumerated and cause an edit score calculation.
+    /// The terms are enumerated by intersecting the terms dictionary with a {@link LevenshteinAutomaton}, so
+    /// the cost depends on the number of similar terms rather than on the size of the dictionary.  A low
+    /// minimum similarity still lets the automaton accept most terms, making the enumeration close to a scan.
     class LPPAPI FuzzyQuery : public MultiTermQuery
     {
     public:
@@ -13,6 +13,10 @@ namespace Lucene
 {
     /// Subclass of FilteredTermEnum for enumerating all terms that are similar to the specified filter term.
     ///
+    /// Rather than comparing every term that shares the prefix, the terms dictionary is intersected with a
+    /// {@link LevenshteinAutomaton} of the term: after a term that does not match, the enumeration skips ahead
+    /// to the next term the automaton may accept, seeking the terms dictionary when it is far away.
+    ///
     /// Term enumerations are always ordered by Term.compareTo().  Each term in the enumeration is greater 
     /// than all that precede it.
     class LPPAPI FuzzyTermEnum : public FilteredTermEnum
@@ -50,14 +54,26 @@ namespace Lucene
         
         double minimumSimilarity;
         double scale_factor;
+        
+        IndexReaderPtr reader;
+        
+        /// Accepts the texts after the prefix that may be similar enough to the search term.
+        LevenshteinAutomatonPtr automaton;
+        
+        /// The number of terms to step over before seeking the terms dictionary instead.
+        static const int32_t MAX_SCANNED_TERMS;
     
     public:
         virtual double difference();
         virtual bool endEnum();
+        virtual bool next();
         virtual void close();
     
     protected:
         void ConstructTermEnum(IndexReaderPtr reader, TermPtr term, double minSimilarity, int32_t prefixLength);
+        
+        /// Moves the enumeration from the current term on to the first term that matches.
+        bool seekMatch();
     
         /// The termCompare method in FuzzyTermEnum uses Levenshtein distance to calculate the distance between 
         /// the given term and the comparing term. 
@@ -31,6 +31,12 @@ namespace Lucene
         /// Extension of norms file.
         static const String& NORMS_EXTENSION();
         
+        /// Extension of per-document values file.
+        static const String& DOC_VALUES_EXTENSION();
+        
+        /// Extension of the bloom filters of the terms of selected fields.
+        static const String& BLOOM_FILTER_EXTENSION();
+        
         /// Extension of freq postings file.
         static const String& FREQ_EXTENSION();
         
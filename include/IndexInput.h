@@ -116,8 +116,35 @@ namespace Lucene
         /// in the input from each other and from the stream they were cloned from.
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
         
+        /// Returns a view of length bytes of this stream, starting at offset.
+        ///
+        /// The slice reports offset as file position 0 and length as its length, and fails reads past its 
+        /// end.  Like a clone, it shares the underlying data with this stream and has its own file pointer, 
+        /// initially 0.
+        ///
+        /// The default implementation reads through a buffered {@link SlicedIndexInput} on a clone of this 
+        /// stream; subclasses should override it to bound a clone of themselves, avoiding the extra copy.
+        virtual IndexInputPtr slice(int64_t offset, int64_t length);
+        
+        /// Submit a batch of reads at absolute file positions.  The reads may proceed asynchronously and in parallel; 
+        /// call {@link ReadBatch#waitForCompletion} to collect them.  The current file pointer is not affected.
+        ///
+        /// The default implementation reads each request in turn through a clone of this stream before returning.
+        virtual void submitReads(ReadBatchPtr batch);
+        
+        /// Returns the length bytes of this stream starting at pos in place, if the stream can expose them without 
+        /// copying, as a memory mapped file can.  The bytes are valid until the stream this one was cloned or 
+        /// sliced from is closed.
+        ///
+        /// The default implementation returns null.
+        virtual const uint8_t* mappedBytes(int64_t pos, int64_t length);
+        
         /// Read string map as a series of key/value pairs.
         virtual MapStringString readStringStringMap();
+    
+    protected:
+        /// Throws IllegalArgumentException unless the given range lies within this stream.
+        void checkSlice(int64_t offset, int64_t length);
     };
 }
 
@@ -107,6 +107,14 @@ namespace Lucene
         /// @param readOnly true if no changes (deletions, norms) will be made with this IndexReader
         static IndexReaderPtr open(DirectoryPtr directory, bool readOnly);
         
+        /// Returns an IndexReader reading the index in the given Directory, and warms the files of the opened commit 
+        /// with the given warmer.  If the warmer runs in the background, this returns without waiting for it; call 
+        /// {@link DirectoryWarmer#waitForCompletion} before giving the reader traffic.
+        /// @param directory the index directory
+        /// @param readOnly true if no changes (deletions, norms) will be made with this IndexReader
+        /// @param warmer the warmer to run, or null to not warm
+        static IndexReaderPtr open(DirectoryPtr directory, bool readOnly, DirectoryWarmerPtr warmer);
+        
         /// Returns an IndexReader reading the index in the given {@link IndexCommit}.  You should pass readOnly = true, 
         /// since it gives much better concurrent performance, unless you intend to do write operations (delete documents 
         /// or change norms) with the reader.
@@ -382,6 +390,29 @@ namespace Lucene
         /// @see Field#setBoost(double)
         virtual void norms(const String& field, ByteArray norms, int32_t offset) = 0;
         
+        /// Returns the byte-encoded normalization factors for the named field, or null if the field has no norms.
+        ///
+        /// Unlike {@link #norms(const String&)}, a segment reader doesn't have to copy the norms into a heap array: 
+        /// they may be read in place from a memory mapped file, or kept in a sparse or packed form.  The values are 
+        /// only valid while this reader is open and may not reflect later calls to {@link #setNorm}.
+        virtual NormValuesPtr normValues(const String& field);
+        
+        /// Returns the numeric per-document values of a field, or null if the field has none.
+        ///
+        /// Per-document values are only available from single segment readers; composite readers return null, so
+        /// callers should ask each of {@link #getSequentialSubReaders}.  Each call returns a new accessor, which 
+        /// must not be shared between threads.
+        /// @see Fieldable#setDocValuesType
+        virtual NumericDocValuesPtr getNumericDocValues(const String& field);
+        
+        /// Returns the binary per-document values of a field, or null if the field has none.
+        /// @see #getNumericDocValues
+        virtual BinaryDocValuesPtr getBinaryDocValues(const String& field);
+        
+        /// Returns the sorted per-document values of a field, or null if the field has none.
+        /// @see #getNumericDocValues
+        virtual SortedDocValuesPtr getSortedDocValues(const String& field);
+        
         /// Resets the normalization factor for the named field of the named  document.  The norm represents 
         /// the product of the field's {@link Fieldable#setBoost(double) boost} and its {@link 
         /// Similarity#lengthNorm(String, int) length normalization}.  Thus, to preserve the length normalization
@@ -414,6 +445,10 @@ namespace Lucene
         /// Returns the number of documents containing the term t.
         virtual int32_t docFreq(TermPtr t) = 0;
         
+        /// Returns the number of documents containing each of the terms.  Readers that can look up several terms 
+        /// at once, overlapping their reads, override this; by default each term is looked up in turn.
+        virtual Collection<int32_t> docFreqs(Collection<TermPtr> terms);
+        
         /// Returns an enumeration of all the documents which contain term.  For each document, the 
         /// document number, the frequency of the term in that document is also provided, for use in
         /// search scoring.  If term is null, then all non-deleted docs are returned with freq=1.
@@ -33,6 +33,13 @@ namespace Lucene
         /// Creates a searcher searching the provided index.
         IndexSearcher(IndexReaderPtr reader);
         
+        /// Creates a searcher searching the provided index, whose subreaders are searched concurrently by the 
+        /// given thread pool.  Searches that return the top hits, sorted by score or by field, and counts of 
+        /// the matching documents split the subreaders into slices that are each searched by a thread of the 
+        /// pool with a collector of their own, then merge the results.  The calling thread searches one of the
+        /// slices itself.  Other searches collect the subreaders one after another on the calling thread.
+        IndexSearcher(IndexReaderPtr reader, ThreadPoolPtr executor);
+        
         /// Directly specify the reader, subReaders and their docID starts.
         IndexSearcher(IndexReaderPtr reader, Collection<IndexReaderPtr> subReaders, Collection<int32_t> docStarts);
         
@@ -51,6 +58,19 @@ namespace Lucene
         
         bool fieldSortDoTrackScores;
         bool fieldSortDoMaxScore;
+        int32_t totalHitsThreshold;
+        
+        /// Searches the slices of subreaders concurrently, if set.
+        ThreadPoolPtr executor;
+        
+        /// The subreaders of each slice, by index.
+        Collection< Collection<int32_t> > leafSlices;
+        
+        /// A slice is full once it holds more docs than this.
+        static const int32_t MAX_DOCS_PER_SLICE;
+        
+        /// Or once it holds this many subreaders.
+        static const int32_t MAX_SEGMENTS_PER_SLICE;
     
     public:
         /// Return the {@link IndexReader} this searches.
@@ -62,6 +82,7 @@ namespace Lucene
         virtual void close();
         
         virtual int32_t docFreq(TermPtr term);
+        virtual Collection<int32_t> docFreqs(Collection<TermPtr> terms);
         virtual DocumentPtr doc(int32_t n);
         virtual DocumentPtr doc(int32_t n, FieldSelectorPtr fieldSelector);
         virtual int32_t maxDoc();
@@ -81,6 +102,10 @@ namespace Lucene
         virtual TopFieldDocsPtr search(WeightPtr weight, FilterPtr filter, int32_t n, SortPtr sort, bool fillFields);
         
         virtual void search(WeightPtr weight, FilterPtr filter, CollectorPtr results);
+        
+        /// Returns the number of documents matching the query.
+        virtual int32_t count(QueryPtr query);
+        
         virtual QueryPtr rewrite(QueryPtr query);
         virtual ExplanationPtr explain(WeightPtr weight, int32_t doc);
         
@@ -91,11 +116,33 @@ namespace Lucene
         /// @param doTrackScores If true, then scores are returned for every matching document in {@link TopFieldDocs}.
         /// @param doMaxScore If true, then the max score for all matching docs is computed.
         virtual void setDefaultFieldSortScoring(bool doTrackScores, bool doMaxScore);
+        
+        /// By default, searches sorted by score count every matching document in {@link TopDocs#totalHits}.  
+        /// Once more than totalHitsThreshold documents have been counted, this lets queries that can bound their
+        /// scores, such as disjunctions of terms, skip the documents that can't enter the top hits.  totalHits 
+        /// is then a lower bound of the number of matching documents.
+        virtual void setTotalHitsThreshold(int32_t totalHitsThreshold);
+        
+        /// Returns the total hits threshold, INT_MAX unless set with {@link #setTotalHitsThreshold}.
+        virtual int32_t getTotalHitsThreshold();
     
     protected:
         void ConstructSearcher(IndexReaderPtr reader, bool closeReader);
         void gatherSubReaders(Collection<IndexReaderPtr> allSubReaders, IndexReaderPtr reader);
         void searchWithFilter(IndexReaderPtr reader, WeightPtr weight, FilterPtr filter, CollectorPtr collector);
+        
+        /// Collects the matching documents of one subreader.
+        void searchLeaf(int32_t leaf, WeightPtr weight, FilterPtr filter, CollectorPtr results);
+        
+        /// Searches each slice concurrently, with the collector of the same index.
+        void searchSlices(WeightPtr weight, FilterPtr filter, Collection<CollectorPtr> collectors);
+        
+        /// Groups the subreaders into the slices searched concurrently.  Large subreaders get a slice of their
+        /// own, smaller ones are grouped up to {@link #MAX_DOCS_PER_SLICE} docs or {@link 
+        /// #MAX_SEGMENTS_PER_SLICE} subreaders.
+        Collection< Collection<int32_t> > slices(Collection<IndexReaderPtr> subReaders);
+        
+        friend class IndexSearcherSliceCallable;
     };
 }
 
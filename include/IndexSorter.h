@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef INDEXSORTER_H
+#define INDEXSORTER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Orders the documents of segments by a {@link Sort}, so that flushed and merged segments can be written
+    /// in that order.  See {@link IndexWriter#setIndexSort}.
+    ///
+    /// The sort is evaluated with the {@link FieldComparator}s of its fields, one slot per document, so documents
+    /// compare exactly as they would in a {@link TopFieldCollector} using the same sort.  Documents that compare
+    /// equal keep their relative order.
+    class LPPAPI IndexSorter : public LuceneObject
+    {
+    public:
+        virtual ~IndexSorter();
+        
+        LUCENE_CLASS(IndexSorter);
+    
+    public:
+        /// Returns the description of a sort that is recorded with each sorted segment.  Only sorts by the values
+        /// of fields and by document number can be recorded, so an IllegalArgument exception is thrown for sorts
+        /// by score, custom comparators, custom parsers and locales.
+        static String describe(SortPtr sort);
+        
+        /// Returns true if the documents of a segment sorted by the recorded sort are also in the order of the
+        /// given sort, which is the case when its fields begin with those of the given sort.
+        static bool sortedBy(const String& segmentSort, SortPtr sort);
+        
+        /// Returns the document at each position of the sorted order, numbering the documents that are not
+        /// deleted one after the other through the readers.  Returns null if the documents are already in order.
+        static Collection<int32_t> sort(SortPtr sort, Collection<IndexReaderPtr> readers);
+    
+    protected:
+        /// Returns the description of one field of a sort, or an empty string if it can't be recorded.
+        static String describe(SortFieldPtr field);
+    };
+}
+
+#endif
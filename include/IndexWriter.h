@@ -101,15 +101,15 @@ namespace Lucene
         virtual ~IndexWriter();
         
         LUCENE_CLASS(IndexWriter);
-            
-    protected:
-        int64_t writeLockTimeout;
         
         /// The normal read buffer size defaults to 1024, but increasing this during merging seems to 
         /// yield performance gains.  However we don't want to increase it too much because there are 
         /// quite a few BufferedIndexInputs created during merging.
         static const int32_t MERGE_READ_BUFFER_SIZE;
         
+    protected:
+        int64_t writeLockTimeout;
+        
         SynchronizePtr messageIDLock;
         static int32_t MESSAGE_ID;
         int32_t messageID;
@@ -145,6 +145,10 @@ namespace Lucene
         LockPtr writeLock;
         
         int32_t termIndexInterval;
+        bool checkIntegrityAtMerge;
+        bool useBlockPackedPostings;
+        CodecPtr codec;
+        SortPtr indexSort;
         
         bool closed;
         bool closing;
@@ -359,6 +363,50 @@ namespace Lucene
         /// @see #setTermIndexInterval(int32_t)
         virtual int32_t getTermIndexInterval();
         
+        /// If set to true, every file of the segments being merged that were written with checksum footers 
+        /// is read in full and verified before the merge starts, so that corruption is never copied into a newly
+        /// merged segment.  Without it only the bytes a merge copies verbatim are verified, as they are copied: 
+        /// files copied into a compound file, and term vector files bulk copied whole from a segment without 
+        /// deletions.  Everything else a merge decodes and re-encodes is not checked.  Default is false.
+        virtual void setCheckIntegrityAtMerge(bool checkIntegrity);
+        
+        /// @see #setCheckIntegrityAtMerge(bool)
+        virtual bool getCheckIntegrityAtMerge();
+        
+        /// If set to true, newly flushed and merged segments store document numbers and frequencies in 
+        /// blocks of 128 bit packed values instead of one VInt each, which decode considerably faster when
+        /// iterating long postings lists.  Positions are not affected.  Segments written before this was 
+        /// changed keep their encoding until they are merged.  Default is false.
+        virtual void setUseBlockPackedPostings(bool useBlockPackedPostings);
+        
+        /// @see #setUseBlockPackedPostings(bool)
+        virtual bool getUseBlockPackedPostings();
+        
+        /// Set the codec that writes newly flushed and merged segments.  Existing segments are still read with 
+        /// the codec that wrote them.  Segments that share doc stores must share a codec, so any buffered documents 
+        /// are flushed and the open doc stores closed first.  This must not be called while other threads are adding 
+        /// documents.  Default is {@link Codec#getDefault()}.
+        virtual void setCodec(CodecPtr codec);
+        
+        /// @see #setCodec(CodecPtr)
+        virtual CodecPtr getCodec();
+        
+        /// Set the sort that newly flushed and merged segments are physically ordered by, so that searches sorted 
+        /// the same way can stop collecting each segment early (see {@link EarlyTerminatingSortingCollector}).  The 
+        /// sort is recorded with each segment written afterwards; existing segments keep their order until they 
+        /// are merged.  Only sorts by field values and document number are allowed.  While a sort is set every 
+        /// flush closes the doc stores and applies the buffered deletes, and each flushed segment that is not 
+        /// already in order is rewritten sorted.  Any buffered documents are flushed first.  Default is null, 
+        /// which keeps documents in the order they were added.
+        ///
+        /// NOTE: sorted flushes and merges reorder the postings of one term at a time in RAM, so they need 
+        /// memory in proportion to the postings of the most frequent term, roughly 20 bytes per document 
+        /// containing it plus a byte or two per position and the size of its payloads.
+        virtual void setIndexSort(SortPtr sort);
+        
+        /// @see #setIndexSort(SortPtr)
+        virtual SortPtr getIndexSort();
+        
         /// Set the merge policy used by this writer.
         virtual void setMergePolicy(MergePolicyPtr mp);
         
@@ -1046,14 +1094,18 @@ namespace Lucene
         virtual bool doFlush(bool flushDocStores, bool flushDeletes);
         virtual bool doFlushInternal(bool flushDocStores, bool flushDeletes);
         
+        /// Rewrites a newly flushed segment in the order of the index sort, or records that it is already in order.
+        virtual void sortFlushedSegment(SegmentInfoPtr info);
+        
         virtual int32_t ensureContiguousMerge(OneMergePtr merge);
         
         /// Carefully merges deletes for the segments we just merged.  This is tricky because, although merging 
         /// will clear all deletes (compacts the documents), new deletes may have been flushed to the segments 
         /// since the merge was started.  This method "carries over" such new deletes onto the newly merged 
         /// segment, and saves the resulting deletes file (incrementing the delete generation for merge.info).
-        /// If no deletes were flushed, no new deletes file is saved.
-        virtual void commitMergedDeletes(OneMergePtr merge, SegmentReaderPtr mergeReader);
+        /// If no deletes were flushed, no new deletes file is saved.  sortDocMap maps the documents to their place 
+        /// in a merged segment that was sorted.
+        virtual void commitMergedDeletes(OneMergePtr merge, SegmentReaderPtr mergeReader, Collection<int32_t> sortDocMap);
         virtual bool commitMerge(OneMergePtr merge, SegmentMergerPtr merger, int32_t mergedDocCount, SegmentReaderPtr mergedReader);
         
         virtual LuceneException handleMergeException(const LuceneException& exc, OneMergePtr merge);
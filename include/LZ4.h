@@ -0,0 +1,61 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// A fast LZ77 compressor writing the LZ4 block format.
+    ///
+    /// The input is a series of sequences, each a token byte whose high four bits hold the number of literal
+    /// bytes and low four bits the match length less {@link #MIN_MATCH}, any remaining literal length as bytes
+    /// of 255 and a final byte, the literal bytes, the distance back to the match as a little-endian short and
+    /// any remaining match length.  The last sequence only has literals.  Matches are found through a hash table
+    /// of the positions of four byte sequences, trading ratio for speed: decompression is a simple copy loop
+    /// and much faster than inflating zlib.
+    class LPPAPI LZ4 : public LuceneObject
+    {
+    public:
+        LZ4();
+        virtual ~LZ4();
+        
+        LUCENE_CLASS(LZ4);
+    
+    public:
+        /// Shortest match that is encoded.
+        static const int32_t MIN_MATCH;
+        
+        /// Greatest distance back to a match.
+        static const int32_t MAX_DISTANCE;
+        
+        /// Number of bytes at the end of the input that are always literals.
+        static const int32_t LAST_LITERALS;
+        
+        /// Number of bits of the hash of four bytes.
+        static const int32_t HASH_LOG;
+    
+    protected:
+        /// Last position plus one of each hash, or 0.
+        IntArray hashTable;
+    
+    public:
+        /// Compresses bytes and writes them to out.
+        void compress(const uint8_t* bytes, int32_t offset, int32_t length, IndexOutputPtr out);
+        
+        /// Decompresses decompressedLength bytes read from in into dest, starting at destOffset.
+        static void decompress(IndexInputPtr in, int32_t decompressedLength, uint8_t* dest, int32_t destOffset);
+    
+    protected:
+        static void encodeLength(int32_t length, IndexOutputPtr out);
+        static void encodeLiterals(const uint8_t* bytes, int32_t token, int32_t anchor, int32_t literalLength, IndexOutputPtr out);
+        static int32_t decodeLength(int32_t length, IndexInputPtr in);
+    };
+}
+
+#endif
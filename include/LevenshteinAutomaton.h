@@ -0,0 +1,77 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef LEVENSHTEINAUTOMATON_H
+#define LEVENSHTEINAUTOMATON_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Automaton that accepts the strings within a maximum Levenshtein distance of a text.
+    ///
+    /// The states are the rows of the edit distance matrix of the text, with distances above the maximum
+    /// clamped, and are computed as the input is read rather than built up front.  All the chars that do not
+    /// occur in the text lead to the same state, so stepping through the sorted strings only ever needs to try
+    /// the chars of the text and one other char.  This lets {@link #nextAccepted} find the smallest accepted
+    /// string after any string, which is used to intersect the automaton with a sorted terms dictionary.
+    class LPPAPI LevenshteinAutomaton : public LuceneObject
+    {
+    public:
+        /// @param text The text to match strings against.
+        /// @param maxDistance The maximum edit distance of the accepted strings.
+        LevenshteinAutomaton(const String& text, int32_t maxDistance);
+        virtual ~LevenshteinAutomaton();
+        
+        LUCENE_CLASS(LevenshteinAutomaton);
+    
+    protected:
+        String text;
+        int32_t maxDistance;
+        
+        /// The number of entries of a state.
+        int32_t width;
+        
+        /// The distinct chars of the text, sorted.
+        Collection<wchar_t> alphabet;
+        
+        /// The states along the current path, one row of width entries per char read.
+        Collection<int32_t> rows;
+    
+    public:
+        /// Returns whether s is within the maximum edit distance of the text.
+        bool accepts(const String& s);
+        
+        /// Finds the smallest accepted string that is greater than s.
+        /// @param s The string to start from.
+        /// @param next Set to the next accepted string if there is one.
+        /// @return false if no accepted string is greater than s.
+        bool nextAccepted(const String& s, String& next);
+    
+    protected:
+        /// Reads s from the start state as long as the state stays live.
+        /// @return The number of chars read, whose states are held in rows 1 to that number.
+        int32_t readLive(const String& s);
+        
+        /// Computes in row + 1 the state reached from row on c.
+        void step(int32_t row, wchar_t c);
+        
+        /// Finds the smallest char from which a live state can be reached from row, and leaves that state in row + 1.
+        bool nextLiveChar(int32_t row, wchar_t from, wchar_t& c);
+        
+        /// Appends to next the smallest string that leads from the live state in row to an accepting state.
+        void complete(int32_t row, String& next);
+        
+        /// Returns whether an accepting state can be reached from row.
+        bool isLive(int32_t row);
+        
+        bool isAccepting(int32_t row);
+        
+        void ensureRows(int32_t numRows);
+    };
+}
+
+#endif
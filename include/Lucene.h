@@ -170,7 +170,9 @@ namespace Lucene
     typedef HashMap< wchar_t, NormalizeCharMapPtr > MapCharNormalizeCharMap;
     typedef HashMap< String, AnalyzerPtr > MapStringAnalyzer;
     typedef HashMap< String, ByteArray > MapStringByteArray;
+    typedef HashMap< String, NormValuesPtr > MapStringNormValues;
     typedef HashMap< String, int32_t > MapStringInt;
+    typedef HashMap< String, int64_t > MapStringLong;
     typedef HashMap< String, FieldInfoPtr > MapStringFieldInfo;
     typedef HashMap< String, Collection<TermVectorEntryPtr> > MapStringCollectionTermVectorEntry;
     typedef HashMap< String, RefCountPtr > MapStringRefCount;
@@ -179,13 +181,17 @@ namespace Lucene
     typedef HashMap< String, NormPtr > MapStringNorm;
     typedef HashMap< String, TermVectorEntryPtr > MapStringTermVectorEntry;
     typedef HashMap< String, RAMFilePtr > MapStringRAMFile;
+    typedef HashMap< String, ArenaFilePtr > MapStringArenaFile;
     typedef HashMap< int32_t, ByteArray > MapIntByteArray;
     typedef HashMap< int32_t, FilterItemPtr > MapIntFilterItem;
     typedef HashMap< int32_t, double > MapIntDouble;
+    typedef HashMap< int32_t, int32_t > MapIntInt;
     typedef HashMap< int64_t, int32_t > MapLongInt;
     typedef HashMap< String, double > MapStringDouble;
     typedef HashMap< int32_t, CachePtr > MapStringCache;
     typedef HashMap< String, LockPtr > MapStringLock;
+    typedef HashMap< String, CodecPtr > MapStringCodec;
+    typedef HashMap< String, DocValuesConsumerPerFieldPtr > MapStringDocValuesConsumerPerField;
 
     typedef HashMap< SegmentInfoPtr, SegmentReaderPtr, luceneHash<SegmentInfoPtr>, luceneEquals<SegmentInfoPtr> > MapSegmentInfoSegmentReader;
     typedef HashMap< SegmentInfoPtr, int32_t, luceneHash<SegmentInfoPtr>, luceneEquals<SegmentInfoPtr> > MapSegmentInfoInt;
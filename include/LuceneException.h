@@ -19,6 +19,7 @@ namespace Lucene
         {
             Null,
             AlreadyClosed,
+            CollectionTerminated,
             Compression,
             CorruptIndex,
             FieldReader,
@@ -80,6 +81,7 @@ namespace Lucene
     typedef ExceptionTemplate<RuntimeException, LuceneException::FieldReader> FieldReaderException;
     typedef ExceptionTemplate<RuntimeException, LuceneException::Merge> MergeException;
     typedef ExceptionTemplate<RuntimeException, LuceneException::StopFillCache> StopFillCacheException;
+    typedef ExceptionTemplate<RuntimeException, LuceneException::CollectionTerminated> CollectionTerminatedException;
     typedef ExceptionTemplate<RuntimeException, LuceneException::TimeExceeded> TimeExceededException;
     typedef ExceptionTemplate<RuntimeException, LuceneException::TooManyClauses> TooManyClausesException;
     typedef ExceptionTemplate<RuntimeException, LuceneException::UnsupportedOperation> UnsupportedOperationException;
@@ -72,6 +72,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(DateField)
     DECLARE_SHARED_PTR(DateTools)
     DECLARE_SHARED_PTR(Document)
+    DECLARE_SHARED_PTR(DocValuesField)
     DECLARE_SHARED_PTR(Field)
     DECLARE_SHARED_PTR(Fieldable)
     DECLARE_SHARED_PTR(FieldSelector)
@@ -84,6 +85,7 @@ namespace Lucene
     // index
     DECLARE_SHARED_PTR(AbstractAllTermDocs)
     DECLARE_SHARED_PTR(AllTermDocs)
+    DECLARE_SHARED_PTR(BinaryDocValues)
     DECLARE_SHARED_PTR(BufferedDeletes)
     DECLARE_SHARED_PTR(ByteBlockAllocator)
     DECLARE_SHARED_PTR(ByteBlockPool)
@@ -93,15 +95,18 @@ namespace Lucene
     DECLARE_SHARED_PTR(CharBlockPool)
     DECLARE_SHARED_PTR(CheckAbort)
     DECLARE_SHARED_PTR(CheckIndex)
+    DECLARE_SHARED_PTR(Codec)
     DECLARE_SHARED_PTR(CommitPoint)
     DECLARE_SHARED_PTR(CompoundFileReader)
     DECLARE_SHARED_PTR(CompoundFileWriter)
+    DECLARE_SHARED_PTR(CompoundStagingDirectory)
     DECLARE_SHARED_PTR(ConcurrentMergeScheduler)
     DECLARE_SHARED_PTR(CoreReaders)
-    DECLARE_SHARED_PTR(CSIndexInput)
+    DECLARE_SHARED_PTR(DefaultCodec)
     DECLARE_SHARED_PTR(DefaultIndexingChain)
     DECLARE_SHARED_PTR(DefaultSkipListReader)
     DECLARE_SHARED_PTR(DefaultSkipListWriter)
+    DECLARE_SHARED_PTR(DenseNormValues)
     DECLARE_SHARED_PTR(DirectoryReader)
     DECLARE_SHARED_PTR(DocConsumer)
     DECLARE_SHARED_PTR(DocConsumerPerThread)
@@ -120,6 +125,11 @@ namespace Lucene
     DECLARE_SHARED_PTR(DocInverterPerField)
     DECLARE_SHARED_PTR(DocInverterPerThread)
     DECLARE_SHARED_PTR(DocState)
+    DECLARE_SHARED_PTR(DocValuesConsumer)
+    DECLARE_SHARED_PTR(DocValuesConsumerPerField)
+    DECLARE_SHARED_PTR(DocValuesConsumerPerThread)
+    DECLARE_SHARED_PTR(DocValuesReader)
+    DECLARE_SHARED_PTR(DocValuesWriter)
     DECLARE_SHARED_PTR(DocumentsWriter)
     DECLARE_SHARED_PTR(DocumentsWriterThreadState)
     DECLARE_SHARED_PTR(DocWriter)
@@ -156,6 +166,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(IndexingChain)
     DECLARE_SHARED_PTR(IndexReader)
     DECLARE_SHARED_PTR(IndexReaderWarmer)
+    DECLARE_SHARED_PTR(IndexSorter)
     DECLARE_SHARED_PTR(IndexStatus)
     DECLARE_SHARED_PTR(IndexWriter)
     DECLARE_SHARED_PTR(IntBlockPool)
@@ -167,6 +178,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(InvertedDocEndConsumerPerField)
     DECLARE_SHARED_PTR(InvertedDocEndConsumerPerThread)
     DECLARE_SHARED_PTR(KeepOnlyLastCommitDeletionPolicy)
+    DECLARE_SHARED_PTR(LazyField)
     DECLARE_SHARED_PTR(LogByteSizeMergePolicy)
     DECLARE_SHARED_PTR(LogDocMergePolicy)
     DECLARE_SHARED_PTR(LogMergePolicy)
@@ -185,11 +197,15 @@ namespace Lucene
     DECLARE_SHARED_PTR(MyCommitPoint)
     DECLARE_SHARED_PTR(MySegmentTermDocs)
     DECLARE_SHARED_PTR(Norm)
+    DECLARE_SHARED_PTR(NormValues)
+    DECLARE_SHARED_PTR(NormsFormat)
     DECLARE_SHARED_PTR(NormsWriter)
     DECLARE_SHARED_PTR(NormsWriterPerField)
     DECLARE_SHARED_PTR(NormsWriterPerThread)
+    DECLARE_SHARED_PTR(NumericDocValues)
     DECLARE_SHARED_PTR(Num)
     DECLARE_SHARED_PTR(OneMerge)
+    DECLARE_SHARED_PTR(PackedNormValues)
     DECLARE_SHARED_PTR(ParallelArrayTermVectorMapper)
     DECLARE_SHARED_PTR(ParallelReader)
     DECLARE_SHARED_PTR(ParallelTermEnum)
@@ -225,7 +241,10 @@ namespace Lucene
     DECLARE_SHARED_PTR(SkipBuffer)
     DECLARE_SHARED_PTR(SkipDocWriter)
     DECLARE_SHARED_PTR(SnapshotDeletionPolicy)
+    DECLARE_SHARED_PTR(SortedDocValues)
     DECLARE_SHARED_PTR(SortedTermVectorMapper)
+    DECLARE_SHARED_PTR(SparseNormValues)
+    DECLARE_SHARED_PTR(StagingIndexOutput)
     DECLARE_SHARED_PTR(StoredFieldStatus)
     DECLARE_SHARED_PTR(StoredFieldsWriter)
     DECLARE_SHARED_PTR(StoredFieldsWriterPerDoc)
@@ -275,6 +294,7 @@ namespace Lucene
             
     // search
     DECLARE_SHARED_PTR(AveragePayloadFunction)
+    DECLARE_SHARED_PTR(BlockMaxDisjunctionScorer)
     DECLARE_SHARED_PTR(BooleanClause)
     DECLARE_SHARED_PTR(BooleanQuery)
     DECLARE_SHARED_PTR(BooleanScorer)
@@ -294,7 +314,9 @@ namespace Lucene
     DECLARE_SHARED_PTR(CellQueue)
     DECLARE_SHARED_PTR(Collector)
     DECLARE_SHARED_PTR(ComplexExplanation)
+    DECLARE_SHARED_PTR(ConjunctionDocIdSetIterator)
     DECLARE_SHARED_PTR(ConjunctionScorer)
+    DECLARE_SHARED_PTR(ConjunctionTwoPhaseIterator)
     DECLARE_SHARED_PTR(ConstantScoreAutoRewrite)
     DECLARE_SHARED_PTR(ConstantScoreAutoRewriteDefault)
     DECLARE_SHARED_PTR(ConstantScoreBooleanQueryRewrite)
@@ -326,6 +348,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(DoubleCache)
     DECLARE_SHARED_PTR(DoubleFieldSource)
     DECLARE_SHARED_PTR(DoubleParser)
+    DECLARE_SHARED_PTR(EarlyTerminatingSortingCollector)
     DECLARE_SHARED_PTR(EmptyDocIdSet)
     DECLARE_SHARED_PTR(EmptyDocIdSetIterator)
     DECLARE_SHARED_PTR(Entry)
@@ -371,9 +394,11 @@ namespace Lucene
     DECLARE_SHARED_PTR(HitQueueBase)
     DECLARE_SHARED_PTR(IDFExplanation)
     DECLARE_SHARED_PTR(IndexSearcher)
+    DECLARE_SHARED_PTR(IndexSearcherSliceCallable)
     DECLARE_SHARED_PTR(IntCache)
     DECLARE_SHARED_PTR(IntFieldSource)
     DECLARE_SHARED_PTR(IntParser)
+    DECLARE_SHARED_PTR(LevenshteinAutomaton)
     DECLARE_SHARED_PTR(LongCache)
     DECLARE_SHARED_PTR(LongParser)
     DECLARE_SHARED_PTR(MatchAllDocsQuery)
@@ -390,6 +415,8 @@ namespace Lucene
     DECLARE_SHARED_PTR(MultiTermQueryWrapperFilter)
     DECLARE_SHARED_PTR(NearSpansOrdered)
     DECLARE_SHARED_PTR(NearSpansUnordered)
+    DECLARE_SHARED_PTR(NumericDocValuesSource)
+    DECLARE_SHARED_PTR(NumericDocValuesSourceValues)
     DECLARE_SHARED_PTR(NumericRangeFilter)
     DECLARE_SHARED_PTR(NumericRangeQuery)
     DECLARE_SHARED_PTR(NumericUtilsDoubleParser)
@@ -411,6 +438,8 @@ namespace Lucene
     DECLARE_SHARED_PTR(PhraseQuery)
     DECLARE_SHARED_PTR(PhraseQueue)
     DECLARE_SHARED_PTR(PhraseScorer)
+    DECLARE_SHARED_PTR(PhraseScorerApproximation)
+    DECLARE_SHARED_PTR(PhraseScorerTwoPhaseIterator)
     DECLARE_SHARED_PTR(PositionInfo)
     DECLARE_SHARED_PTR(PositiveScoresOnlyCollector)
     DECLARE_SHARED_PTR(PrefixFilter)
@@ -421,6 +450,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(QueryTermVector)
     DECLARE_SHARED_PTR(QueryWrapperFilter)
     DECLARE_SHARED_PTR(ReqExclScorer)
+    DECLARE_SHARED_PTR(ReqExclScorerTwoPhaseIterator)
     DECLARE_SHARED_PTR(ReqOptSumScorer)
     DECLARE_SHARED_PTR(RewriteMethod)
     DECLARE_SHARED_PTR(ReverseOrdFieldSource)
@@ -453,6 +483,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(Spans)
     DECLARE_SHARED_PTR(SpansCell)
     DECLARE_SHARED_PTR(SpanScorer)
+    DECLARE_SHARED_PTR(SpanScorerTwoPhaseIterator)
     DECLARE_SHARED_PTR(SpanTermQuery)
     DECLARE_SHARED_PTR(SpanWeight)
     DECLARE_SHARED_PTR(StartEnd)
@@ -464,6 +495,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(TermRangeFilter)
     DECLARE_SHARED_PTR(TermRangeQuery)
     DECLARE_SHARED_PTR(TermRangeTermEnum)
+    DECLARE_SHARED_PTR(TermDocsDocIdSetIterator)
     DECLARE_SHARED_PTR(TermScorer)
     DECLARE_SHARED_PTR(TermSpans)
     DECLARE_SHARED_PTR(TimeLimitingCollector)
@@ -473,6 +505,9 @@ namespace Lucene
     DECLARE_SHARED_PTR(TopFieldCollector)
     DECLARE_SHARED_PTR(TopFieldDocs)
     DECLARE_SHARED_PTR(TopScoreDocCollector)
+    DECLARE_SHARED_PTR(TotalHitCountCollector)
+    DECLARE_SHARED_PTR(TwoPhaseIterator)
+    DECLARE_SHARED_PTR(TwoPhaseIteratorDocIdSetIterator)
     DECLARE_SHARED_PTR(ValueSource)
     DECLARE_SHARED_PTR(ValueSourceQuery)
     DECLARE_SHARED_PTR(ValueSourceScorer)
@@ -482,30 +517,52 @@ namespace Lucene
     DECLARE_SHARED_PTR(WildcardTermEnum)
         
     // store
+    DECLARE_SHARED_PTR(ArenaFile)
+    DECLARE_SHARED_PTR(ArenaIndexInput)
+    DECLARE_SHARED_PTR(ArenaIndexOutput)
+    DECLARE_SHARED_PTR(ArenaRAMDirectory)
+    DECLARE_SHARED_PTR(BlockCache)
+    DECLARE_SHARED_PTR(BlockCacheDirectory)
+    DECLARE_SHARED_PTR(BlockCacheIndexInput)
+    DECLARE_SHARED_PTR(BlockCacheMergeDirectory)
+    DECLARE_SHARED_PTR(BlockCacheShard)
     DECLARE_SHARED_PTR(BufferedIndexInput)
     DECLARE_SHARED_PTR(BufferedIndexOutput)
+    DECLARE_SHARED_PTR(ByteArrayIndexInput)
+    DECLARE_SHARED_PTR(ChecksumFooter)
+    DECLARE_SHARED_PTR(ChecksumFooterIndexOutput)
     DECLARE_SHARED_PTR(ChecksumIndexInput)
     DECLARE_SHARED_PTR(ChecksumIndexOutput)
     DECLARE_SHARED_PTR(Directory)
+    DECLARE_SHARED_PTR(DirectoryWarmer)
     DECLARE_SHARED_PTR(FileSwitchDirectory)
     DECLARE_SHARED_PTR(FSDirectory)
     DECLARE_SHARED_PTR(FSLockFactory)
     DECLARE_SHARED_PTR(IndexInput)
     DECLARE_SHARED_PTR(IndexOutput)
     DECLARE_SHARED_PTR(InputFile)
+    DECLARE_SHARED_PTR(IOUringReadCompletion)
     DECLARE_SHARED_PTR(Lock)
     DECLARE_SHARED_PTR(LockFactory)
     DECLARE_SHARED_PTR(MMapDirectory)
     DECLARE_SHARED_PTR(MMapIndexInput)
     DECLARE_SHARED_PTR(NativeFSLock)
     DECLARE_SHARED_PTR(NativeFSLockFactory)
+    DECLARE_SHARED_PTR(NIOFSDirectory)
+    DECLARE_SHARED_PTR(NIOFSIndexInput)
     DECLARE_SHARED_PTR(NoLock)
     DECLARE_SHARED_PTR(NoLockFactory)
+    DECLARE_SHARED_PTR(NRTCachingDirectory)
+    DECLARE_SHARED_PTR(NRTCachingMergeScheduler)
     DECLARE_SHARED_PTR(OutputFile)
+    DECLARE_SHARED_PTR(PositionalInputFile)
+    DECLARE_SHARED_PTR(RAMArena)
     DECLARE_SHARED_PTR(RAMDirectory)
     DECLARE_SHARED_PTR(RAMFile)
     DECLARE_SHARED_PTR(RAMInputStream)
     DECLARE_SHARED_PTR(RAMOutputStream)
+    DECLARE_SHARED_PTR(ReadBatch)
+    DECLARE_SHARED_PTR(ReadCompletion)
     DECLARE_SHARED_PTR(SimpleFSDirectory)
     DECLARE_SHARED_PTR(SimpleFSIndexInput)
     DECLARE_SHARED_PTR(SimpleFSIndexOutput)
@@ -513,6 +570,9 @@ namespace Lucene
     DECLARE_SHARED_PTR(SimpleFSLockFactory)
     DECLARE_SHARED_PTR(SingleInstanceLock)
     DECLARE_SHARED_PTR(SingleInstanceLockFactory)
+    DECLARE_SHARED_PTR(SlicedIndexInput)
+    DECLARE_SHARED_PTR(ThreadPoolReadCompletion)
+    DECLARE_SHARED_PTR(WarmerThread)
     
     // util
     DECLARE_SHARED_PTR(Attribute)
@@ -521,12 +581,18 @@ namespace Lucene
     DECLARE_SHARED_PTR(AttributeSourceState)
     DECLARE_SHARED_PTR(BitSet)
     DECLARE_SHARED_PTR(BitVector)
+    DECLARE_SHARED_PTR(BlockPackedInts)
+    DECLARE_SHARED_PTR(BloomFilter)
     DECLARE_SHARED_PTR(BufferedReader)
     DECLARE_SHARED_PTR(Collator)
+    DECLARE_SHARED_PTR(CRC32C)
     DECLARE_SHARED_PTR(DefaultAttributeFactory)
     DECLARE_SHARED_PTR(DocIdBitSet)
     DECLARE_SHARED_PTR(FieldCacheSanityChecker)
     DECLARE_SHARED_PTR(FileReader)
+    DECLARE_SHARED_PTR(FST)
+    DECLARE_SHARED_PTR(FSTBuilder)
+    DECLARE_SHARED_PTR(FSTBuilderNode)
     DECLARE_SHARED_PTR(Future)
     DECLARE_SHARED_PTR(HeapedScorerDoc)
     DECLARE_SHARED_PTR(InfoStream)
@@ -539,6 +605,7 @@ namespace Lucene
     DECLARE_SHARED_PTR(LuceneObject)
     DECLARE_SHARED_PTR(LuceneSignal)
     DECLARE_SHARED_PTR(LuceneThread)
+    DECLARE_SHARED_PTR(LZ4)
     DECLARE_SHARED_PTR(NumericUtils)
     DECLARE_SHARED_PTR(OpenBitSet)
     DECLARE_SHARED_PTR(OpenBitSetDISI)
@@ -546,11 +613,16 @@ namespace Lucene
     DECLARE_SHARED_PTR(Random)
     DECLARE_SHARED_PTR(Reader)
     DECLARE_SHARED_PTR(ReaderField)
+    DECLARE_SHARED_PTR(RoaringContainer)
+    DECLARE_SHARED_PTR(RoaringDocIdSet)
+    DECLARE_SHARED_PTR(RoaringDocIdSetIterator)
     DECLARE_SHARED_PTR(ScorerDocQueue)
     DECLARE_SHARED_PTR(SortedVIntList)
     DECLARE_SHARED_PTR(StringReader)
     DECLARE_SHARED_PTR(Synchronize)
     DECLARE_SHARED_PTR(ThreadPool)
+    DECLARE_SHARED_PTR(ThreadPoolQueue)
+    DECLARE_SHARED_PTR(ThreadPoolWorkers)
     DECLARE_SHARED_PTR(UnicodeResult)
     DECLARE_SHARED_PTR(UTF8Decoder)
     DECLARE_SHARED_PTR(UTF8DecoderStream)
@@ -14,7 +14,8 @@ namespace Lucene
     /// File-based {@link Directory} implementation that uses mmap for reading, and {@link SimpleFSIndexOutput} for writing.
     ///
     /// NOTE: memory mapping uses up a portion of the virtual memory address space in your process equal to the size of the 
-    /// file being mapped.  Before using this class, be sure your have plenty of virtual address space.
+    /// file being mapped.  Before using this class, be sure your have plenty of virtual address space.  Files larger than 
+    /// {@link #getMaxChunkSize} are mapped as several consecutive chunks.
     ///
     /// NOTE: Accessing this class either directly or indirectly from a thread while it's interrupted can close the 
     /// underlying channel immediately if at the same time the thread is blocked on IO.  The channel will remain closed and 
@@ -30,15 +31,56 @@ namespace Lucene
         virtual ~MMapDirectory();
         
         LUCENE_CLASS(MMapDirectory);
-            
+    
+    public:
+        /// Default max chunk size.  This is a conditional default based on operating system.
+        /// @see #setMaxChunkSize
+        static const int32_t DEFAULT_MAX_CHUNK_SIZE;
+    
+    protected:
+        typedef HashMap<String, MMapIndexInputPtr> MapStringMMapIndexInput;
+        
+        int32_t chunkSizePower;
+        
+        /// Mappings held open to keep files locked in memory.
+        MapStringMMapIndexInput lockedFiles;
+    
     public:
         using FSDirectory::openInput;
         
+        /// Sets the maximum chunk size (default is {@link #DEFAULT_MAX_CHUNK_SIZE}) used for memory mapping.  Files larger 
+        /// than this are mapped as multiple chunks that are stitched together on read.  The value is rounded down to a power 
+        /// of 2 and must be at least the operating system's mapping granularity.  Changes to this value will not impact any 
+        /// already-opened {@link IndexInput}s.
+        void setMaxChunkSize(int32_t maxChunkSize);
+        
+        /// Returns the current mmap chunk size.
+        /// @see #setMaxChunkSize
+        int32_t getMaxChunkSize();
+        
         /// Creates an IndexInput for the file with the given name.
         virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
         
         /// Creates an IndexOutput for the file with the given name.
         virtual IndexOutputPtr createOutput(const String& name);
+        
+        /// Removes an existing file in the directory, releasing any lock held on it.
+        virtual void deleteFile(const String& name);
+        
+        /// Brings a range of a file into memory through a mapping.  {@link #WARM_ADVISE} uses madvise(MADV_WILLNEED), 
+        /// {@link #WARM_PRELOAD} touches every page, and {@link #WARM_LOCK} uses mlock and keeps the mapping open until the 
+        /// file is unlocked, deleted or overwritten, or the directory is closed.  Locking may fail with an IOException if 
+        /// it exceeds the process's locked memory limit.
+        virtual void warmFile(const String& name, WarmMode mode, int64_t offset = 0, int64_t length = -1);
+        
+        /// Returns the names of files currently locked in memory by {@link #warmFile}.
+        HashSet<String> getLockedFiles();
+        
+        /// Releases a file locked in memory by {@link #warmFile}.  Does nothing if the file isn't locked.
+        void unlockFile(const String& name);
+        
+        /// Releases all locked files and closes the store to future operations.
+        virtual void close();
     };
 }
 
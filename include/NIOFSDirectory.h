@@ -0,0 +1,41 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NIOFSDIRECTORY_H
+#define NIOFSDIRECTORY_H
+
+#include "FSDirectory.h"
+
+namespace Lucene
+{
+    /// An {@link FSDirectory} implementation that uses positional reads (pread) when reading from files.  This allows 
+    /// multiple threads to read from the same file without synchronizing, since each read specifies its own absolute 
+    /// offset and the shared file descriptor has no seek position that needs to be protected.
+    ///
+    /// Writing is done through {@link SimpleFSIndexOutput}.
+    class LPPAPI NIOFSDirectory : public FSDirectory
+    {
+    public:
+        /// Create a new NIOFSDirectory for the named location.
+        /// @param path the path of the directory.
+        /// @param lockFactory the lock factory to use, or null for the default ({@link NativeFSLockFactory})
+        NIOFSDirectory(const String& path, LockFactoryPtr lockFactory = LockFactoryPtr());
+        virtual ~NIOFSDirectory();
+        
+        LUCENE_CLASS(NIOFSDirectory);
+    
+    public:
+        using FSDirectory::openInput;
+        
+        /// Creates an IndexInput for the file with the given name.
+        virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
+        
+        /// Creates an IndexOutput for the file with the given name.
+        virtual IndexOutputPtr createOutput(const String& name);
+    };
+}
+
+#endif
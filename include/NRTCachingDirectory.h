@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NRTCACHINGDIRECTORY_H
+#define NRTCACHINGDIRECTORY_H
+
+#include "Directory.h"
+
+namespace Lucene
+{
+    /// Wraps a {@link RAMDirectory} around any provided delegate directory, to be used during near-real-time 
+    /// search.  The idea is that, as documents are added to the {@link IndexWriter} and {@link 
+    /// IndexWriter#getReader} is called frequently, the writer flushes many tiny segments.  Writing, syncing 
+    /// and re-opening those on disk is costly, and most of them are merged away again shortly afterwards.
+    ///
+    /// This directory writes newly created files to RAM, provided the RAM cache is below maxCachedMB and, 
+    /// when the file is written by a merge, the merge is smaller than maxMergeSizeMB.  A cached file is 
+    /// only written to the delegate directory when it is synced, ie. when it survives to an {@link 
+    /// IndexWriter#commit}, or when this directory is closed.
+    ///
+    /// Merges are only recognised if the writer uses the merge scheduler returned by {@link 
+    /// #getMergeScheduler}:
+    ///
+    /// <pre>
+    /// NRTCachingDirectoryPtr cachedDir(newLucene<NRTCachingDirectory>(fsDir, 5.0, 60.0));
+    /// IndexWriterPtr writer(newLucene<IndexWriter>(cachedDir, analyzer, IndexWriter::MaxFieldLengthUNLIMITED));
+    /// writer->setMergeScheduler(cachedDir->getMergeScheduler());
+    /// </pre>
+    ///
+    /// This will cache all newly flushed segments and all merges whose expected segment size is <= 5 MB, 
+    /// unless the total cached bytes would exceed 60 MB.
+    class LPPAPI NRTCachingDirectory : public Directory
+    {
+    public:
+        NRTCachingDirectory(DirectoryPtr delegate, double maxMergeSizeMB, double maxCachedMB);
+        virtual ~NRTCachingDirectory();
+        
+        LUCENE_CLASS(NRTCachingDirectory);
+    
+    protected:
+        RAMDirectoryPtr cache;
+        DirectoryPtr delegate;
+        int64_t maxMergeSizeBytes;
+        int64_t maxCachedBytes;
+        NRTCachingMergeSchedulerPtr mergeScheduler;
+        SynchronizePtr uncacheLock;
+    
+    public:
+        /// Return the wrapped directory.
+        DirectoryPtr getDelegate();
+        
+        /// Returns the names of the files currently held in RAM.
+        HashSet<String> listCachedFiles();
+        
+        /// Returns how many bytes are being used by the RAM cache.
+        int64_t sizeInBytes();
+        
+        /// Returns the merge scheduler that the {@link IndexWriter} should use, so merges are recognised.
+        MergeSchedulerPtr getMergeScheduler();
+        
+        /// Returns an array of strings, one for each file in the directory.
+        virtual HashSet<String> listAll();
+        
+        /// Returns true if a file with the given name exists.
+        virtual bool fileExists(const String& name);
+        
+        /// Returns the time the named file was last modified.
+        virtual uint64_t fileModified(const String& name);
+        
+        /// Set the modified time of an existing file to now.
+        virtual void touchFile(const String& name);
+        
+        /// Removes an existing file in the directory.
+        virtual void deleteFile(const String& name);
+        
+        /// Returns the length of a file in the directory.
+        virtual int64_t fileLength(const String& name);
+        
+        /// Creates a new, empty file in the directory with the given name.
+        /// Returns a stream writing this file.
+        virtual IndexOutputPtr createOutput(const String& name);
+        
+        /// Ensure that any writes to this file are moved to stable storage.  A cached file is first 
+        /// written to the delegate directory and removed from the cache.
+        virtual void sync(const String& name);
+        
+        /// Returns a stream reading an existing file.
+        virtual IndexInputPtr openInput(const String& name);
+        
+        /// Returns a stream reading an existing file, with the specified read buffer size.
+        virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
+        
+        /// Return a string identifier that uniquely differentiates this Directory instance from other 
+        /// Directory instances.
+        virtual String getLockID();
+        
+        /// Writes all cached files to the delegate directory, then closes both directories.
+        virtual void close();
+        
+        virtual String toString();
+    
+    protected:
+        /// Returns true if the file should be written to the RAM cache.
+        virtual bool doCacheWrite(const String& name);
+        
+        /// Move a file from the RAM cache to the delegate directory.
+        void unCache(const String& name);
+    };
+}
+
+#endif
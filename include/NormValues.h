@@ -0,0 +1,42 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NORMVALUES_H
+#define NORMVALUES_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Random access to the byte-encoded normalization factors of a field.
+    ///
+    /// Unlike {@link IndexReader#norms(const String&)} this doesn't require a byte per document on the heap: a
+    /// segment's norms may be read in place from a memory mapped file, or from a sparse or packed encoding.
+    /// @see IndexReader#normValues
+    /// @see Similarity#decodeNorm(uint8_t)
+    class LPPAPI NormValues : public LuceneObject
+    {
+    public:
+        virtual ~NormValues();
+        
+        LUCENE_CLASS(NormValues);
+    
+    public:
+        /// Returns the encoded norm of a document.
+        virtual uint8_t get(int32_t doc) = 0;
+        
+        /// Copies the norms of the first length documents into bytes, starting at offset.
+        virtual void copyTo(uint8_t* bytes, int32_t offset, int32_t length);
+        
+        /// Returns the number of bytes of heap used by the norms, not counting memory mapped files.
+        virtual int64_t sizeInBytes() = 0;
+        
+        /// Returns norms backed by one byte per document, or null if norms is null.
+        static NormValuesPtr fromBytes(ByteArray norms);
+    };
+}
+
+#endif
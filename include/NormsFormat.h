@@ -0,0 +1,71 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NORMSFORMAT_H
+#define NORMSFORMAT_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Encoding of the norms of a field in the .nrm file.
+    ///
+    /// Each field is an entry of the encoding byte, the length of the rest of the entry as a VLong and the
+    /// encoded norms.  The writer picks the smallest of three encodings:
+    /// <ul>
+    /// <li>{@link #DENSE}: one byte per document.
+    /// <li>{@link #SPARSE}: the most common norm, then the number of documents with another norm as a VInt,
+    /// their doc ID deltas as VInts and their norms.  Fields that few documents have are mostly the default
+    /// norm, so they take a few bytes per document that has them.
+    /// <li>{@link #PACKED}: the number of distinct norms, at most 16, the norms, then one four bit index into
+    /// them per document, two documents per byte.
+    /// </ul>
+    /// A field with reduced precision norms is rounded to its 16 most common norms, so that it can always be
+    /// packed.
+    ///
+    /// Files written before these encodings, whose header ends in -1, have one byte per document per field.
+    class LPPAPI NormsFormat : public LuceneObject
+    {
+    public:
+        virtual ~NormsFormat();
+        
+        LUCENE_CLASS(NormsFormat);
+    
+    public:
+        static const uint8_t DENSE;
+        static const uint8_t SPARSE;
+        static const uint8_t PACKED;
+        
+        /// Greatest number of distinct norms of a packed field.
+        static const int32_t MAX_PACKED_NORMS;
+    
+    public:
+        /// Writes the norms of a field.
+        /// @param norms the norms of the documents, which are rounded in place if reducedPrecision is set.
+        /// @param reducedPrecision round the norms to the 16 most common ones.
+        static void write(IndexOutputPtr out, ByteArray norms, int32_t numDocs, bool reducedPrecision);
+        
+        /// Returns the position of each field's entry in a .nrm file read from its start, or null if the file was
+        /// written with one byte per document per field.
+        static Collection<int64_t> readEntries(IndexInputPtr in, int32_t numFields);
+        
+        /// Reads the norms of a field.  Norms that are stored a byte or four bits per document are read in place
+        /// if the input is memory mapped.
+        /// @param pos position of the field's entry, or of its bytes if the file isn't encoded.
+        /// @param encoded false if the field has one byte per document without an entry header.
+        /// @param mapped set to true if the values refer to the mapped memory of the input, and so are only
+        /// valid until it is closed.
+        static NormValuesPtr read(IndexInputPtr in, int64_t pos, int32_t numDocs, bool encoded, bool& mapped);
+    
+    protected:
+        /// Replaces each norm with the nearest of the 16 most common norms.
+        static void reducePrecision(ByteArray norms, int32_t numDocs, Collection<int32_t> counts);
+        
+        static int32_t vIntLength(int32_t i);
+    };
+}
+
+#endif
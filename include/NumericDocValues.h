@@ -0,0 +1,47 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NUMERICDOCVALUES_H
+#define NUMERICDOCVALUES_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Random access to the numeric per-document values of a field in one segment.  Documents without a value
+    /// read as zero.
+    /// @see IndexReader#getNumericDocValues
+    class LPPAPI NumericDocValues : public LuceneObject
+    {
+    public:
+        NumericDocValues(IndexInputPtr input, bool isDouble);
+        virtual ~NumericDocValues();
+        
+        LUCENE_CLASS(NumericDocValues);
+    
+    protected:
+        IndexInputPtr input;
+        bool _isDouble;
+        int64_t minValue;
+        int32_t width;
+        int64_t dataPointer;
+    
+    public:
+        /// Returns true if the values were written as doubles.
+        bool isDouble();
+        
+        /// Returns the value of a document as a long, truncating double values.
+        int64_t getLong(int32_t doc);
+        
+        /// Returns the value of a document as a double.
+        double getDouble(int32_t doc);
+    
+    protected:
+        int64_t getRaw(int32_t doc);
+    };
+}
+
+#endif
@@ -0,0 +1,43 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef NUMERICDOCVALUESSOURCE_H
+#define NUMERICDOCVALUESSOURCE_H
+
+#include "ValueSource.h"
+
+namespace Lucene
+{
+    /// Obtains numeric field values from the per-document values of a field (see {@link 
+    /// IndexReader#getNumericDocValues}) rather than the {@link FieldCache}.
+    ///
+    /// Values are read from the index as they are needed, so nothing is loaded or cached up front and the 
+    /// source costs no RAM beyond the index files themselves.  Documents without a value, and readers without
+    /// values for the field, score 0.
+    ///
+    /// NOTE: per-document values are only held by single segment readers, so {@link #getValues} should be 
+    /// given the readers of each segment, as {@link ValueSourceQuery} does.
+    class LPPAPI NumericDocValuesSource : public ValueSource
+    {
+    public:
+        /// Create a source for the given field.
+        NumericDocValuesSource(const String& field);
+        virtual ~NumericDocValuesSource();
+        
+        LUCENE_CLASS(NumericDocValuesSource);
+    
+    protected:
+        String field;
+    
+    public:
+        virtual String description();
+        virtual DocValuesPtr getValues(IndexReaderPtr reader);
+        virtual bool equals(LuceneObjectPtr other);
+        virtual int32_t hashCode();
+    };
+}
+
+#endif
@@ -50,6 +50,10 @@ namespace Lucene
     /// If you only need to sort by numeric value, and never run range querying/filtering, you can index using a 
     /// precisionStep of {@link MAX_INT}.  This will minimize disk space consumed.
     ///
+    /// To sort or score by the value without uninverting the field, call {@link #setDocValuesType} with {@link 
+    /// #DOC_VALUES_NUMERIC}.  A field that is only needed for sorting can then be created with {@link 
+    /// #NumericField(String,Field.Store,boolean)} as neither stored nor indexed.
+    ///
     /// More advanced users can instead use {@link NumericTokenStream} directly, when indexing numbers.  This class is a 
     /// wrapper around this token stream type for easier, more intuitive usage.
     ///
@@ -116,6 +120,12 @@ namespace Lucene
         /// Returns the current numeric value.
         virtual int64_t getNumericValue();
         
+        /// Returns true if the current value was set with {@link #setDoubleValue}.
+        virtual bool isDoubleValue();
+        
+        /// Returns the current numeric value as a double.
+        virtual double getDoubleValue();
+        
         /// Initializes the field with the supplied long value.
         /// @param value the numeric value
         virtual NumericFieldPtr setLongValue(int64_t value);
@@ -18,12 +18,18 @@ namespace Lucene
     class LPPAPI ParallelMultiSearcher : public MultiSearcher
     {
     public:
-        /// Creates a {@link Searchable} which searches searchables.
+        /// Creates a {@link Searchable} which searches searchables on the shared {@link ThreadPool}.
         ParallelMultiSearcher(Collection<SearchablePtr> searchables);
+        
+        /// Creates a {@link Searchable} which searches searchables on the given executor.
+        ParallelMultiSearcher(Collection<SearchablePtr> searchables, ThreadPoolPtr executor);
         virtual ~ParallelMultiSearcher();
     
         LUCENE_CLASS(ParallelMultiSearcher);
     
+    protected:
+        ThreadPoolPtr executor;
+    
     public:
         /// Executes each {@link Searchable}'s docFreq() in its own thread and waits for each search to 
         /// complete and merge the results back together.
@@ -108,6 +108,9 @@ namespace Lucene
         /// Reads the byte-encoded normalization factor for the named field of every document.
         virtual void norms(const String& field, ByteArray norms, int32_t offset);
         
+        /// Returns the byte-encoded normalization factors for the named field from the reader that holds the field.
+        virtual NormValuesPtr normValues(const String& field);
+        
         /// Returns an enumeration of all the terms in the index. The enumeration is ordered by 
         /// Term::compareTo(). Each term is greater than all that precede it in the enumeration. 
         /// Note that after calling terms(), {@link TermEnum#next()} must be called on the resulting 
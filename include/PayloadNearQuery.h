@@ -65,7 +65,7 @@ namespace Lucene
     class LPPAPI PayloadNearSpanScorer : public SpanScorer
     {
     public:
-        PayloadNearSpanScorer(SpansPtr spans, WeightPtr weight, SimilarityPtr similarity, ByteArray norms);
+        PayloadNearSpanScorer(SpansPtr spans, WeightPtr weight, SimilarityPtr similarity, NormValuesPtr norms);
         virtual ~PayloadNearSpanScorer();
         
         LUCENE_CLASS(PayloadNearSpanScorer);
@@ -18,9 +18,13 @@ namespace Lucene
     /// #phraseFreq()} of extending classes is invoked for each document containing all the phrase query 
     /// terms, in order to compute the frequency of the phrase query in that document. A non zero frequency
     /// means a match. 
+    ///
+    /// The docs containing all the terms are an approximation of the matches that reads no positions, so that
+    /// {@link #twoPhaseIterator()} lets conjunctions and filters check the phrase only on the docs they accept.
     class PhraseScorer : public Scorer
     {
     public:
+        PhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, NormValuesPtr norms);
         PhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, ByteArray norms);
         virtual ~PhraseScorer();
     
@@ -28,7 +32,7 @@ namespace Lucene
     
     protected:
         WeightPtr weight;
-        ByteArray norms;
+        NormValuesPtr norms;
         double value;
         
         bool firstTime;
@@ -44,6 +48,7 @@ namespace Lucene
         virtual int32_t nextDoc();
         virtual double score();
         virtual int32_t advance(int32_t target);
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
         
         /// Phrase frequency in current doc as computed by phraseFreq().
         double currentFreq();
@@ -51,8 +56,22 @@ namespace Lucene
         virtual String toString();
     
     protected:
-        /// Next without initial increment
-        bool doNext();
+        void ConstructScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, NormValuesPtr norms);
+        
+        /// Moves the terms to the next doc containing all of them, without checking the phrase.
+        int32_t approximationNextDoc();
+        
+        /// Moves the terms to the first doc from target on containing all of them, without checking the phrase.
+        int32_t approximationAdvance(int32_t target);
+        
+        /// Moves the terms from their current docs on until they are all on the same doc.
+        int32_t alignDocs();
+        
+        /// Computes the phrase frequency of the doc that all terms are on.  Returns whether the phrase occurs in it.
+        bool matches();
+        
+        /// Moves the approximation from doc on to the first doc that contains the phrase.
+        int32_t toMatch(int32_t doc);
         
         /// For a document containing all the phrase query terms, compute the frequency of the phrase in 
         /// that document.  A non zero frequency means a match.
@@ -65,6 +84,9 @@ namespace Lucene
         void sort();
         void pqToList();
         void firstToLast();
+        
+        friend class PhraseScorerApproximation;
+        friend class PhraseScorerTwoPhaseIterator;
     };
 }
 
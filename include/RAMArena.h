@@ -0,0 +1,74 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef RAMARENA_H
+#define RAMARENA_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Hands out large, fixed-size slabs of memory for {@link ArenaRAMDirectory}.  Files are written into 
+    /// whole slabs; when a file is closed, a short tail is packed into a shared slab alongside the tails 
+    /// of other files, and the slab it was written into is recycled for the next file.
+    ///
+    /// Memory is released when the last file (or snapshot of a file) referencing a slab is deleted.
+    class LPPAPI RAMArena : public LuceneObject
+    {
+    public:
+        /// Create a new arena.
+        /// @param slabSize the size of each slab, rounded up to a power of two.
+        RAMArena(int32_t slabSize = DEFAULT_SLAB_SIZE);
+        virtual ~RAMArena();
+        
+        LUCENE_CLASS(RAMArena);
+    
+    public:
+        /// Default slab size (1 MB).
+        static const int32_t DEFAULT_SLAB_SIZE;
+        
+        /// Maximum number of free slabs kept for re-use.
+        static const int32_t MAX_FREE_SLABS;
+    
+    protected:
+        int32_t slabSize;
+        int32_t slabSizePower;
+        
+        /// Slabs released by closed outputs, ready to be handed out again.
+        Collection<ByteArray> freeSlabs;
+        
+        /// Slab that file tails are packed into.
+        ByteArray tailSlab;
+        int32_t tailSlabUpto;
+        
+        int64_t numSlabsAllocated;
+    
+    public:
+        /// Returns the size of each slab.
+        int32_t getSlabSize();
+        
+        /// Returns log2 of the slab size.
+        int32_t getSlabSizePower();
+        
+        /// Returns the number of slabs allocated from the heap (rather than re-used) so far.
+        int64_t getNumSlabsAllocated();
+        
+        /// Returns an empty slab for exclusive use by the caller.
+        ByteArray newSlab();
+        
+        /// Return a slab obtained from {@link #newSlab} that is no longer referenced by the caller.
+        void releaseSlab(ByteArray slab);
+        
+        /// Copy bytes into packed tail storage.
+        /// @param bytes the bytes to copy.
+        /// @param length number of bytes to copy, which must be no more than half a slab.
+        /// @param offset receives the offset of the copied bytes in the returned slab.
+        /// @return the slab now holding the bytes, which must not be modified.
+        ByteArray packTail(const uint8_t* bytes, int32_t length, int32_t& offset);
+    };
+}
+
+#endif
@@ -0,0 +1,73 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef READBATCH_H
+#define READBATCH_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// A batch of reads at absolute file positions, submitted together through {@link IndexInput#submitReads}.
+    /// Implementations are free to service the reads in any order and in parallel, so callers that know several 
+    /// locations they are about to visit (eg. the term dictionary blocks of every query term) can overlap the 
+    /// latency of the reads instead of paying for them one after another.
+    ///
+    /// Results are only valid once {@link #waitForCompletion} has returned.
+    class LPPAPI ReadBatch : public LuceneObject
+    {
+    public:
+        ReadBatch();
+        virtual ~ReadBatch();
+        
+        LUCENE_CLASS(ReadBatch);
+    
+    protected:
+        Collection<int64_t> positions;
+        Collection<ByteArray> buffers;
+        ReadCompletionPtr completion;
+    
+    public:
+        /// Add a read of length bytes starting at the given file position.
+        /// @return the index of the read within this batch.
+        int32_t add(int64_t position, int32_t length);
+        
+        /// Returns the number of reads in this batch.
+        int32_t size();
+        
+        /// Returns the file position of the given read.
+        int64_t getPosition(int32_t index);
+        
+        /// Returns the number of bytes requested by the given read.
+        int32_t getLength(int32_t index);
+        
+        /// Returns the buffer holding the bytes of the given read.
+        ByteArray getBytes(int32_t index);
+        
+        /// Register the handle used to wait for reads still in flight.  Called by {@link IndexInput#submitReads}.
+        void setCompletion(ReadCompletionPtr completion);
+        
+        /// Block until all submitted reads have completed.
+        /// @throws IOException if any of the reads failed.
+        void waitForCompletion();
+    };
+    
+    /// Handle to the reads of a {@link ReadBatch} that are still in flight.
+    class LPPAPI ReadCompletion : public LuceneObject
+    {
+    public:
+        virtual ~ReadCompletion();
+        
+        LUCENE_CLASS(ReadCompletion);
+    
+    public:
+        /// Block until all reads have completed.
+        /// @throws IOException if any of the reads failed.
+        virtual void waitForCompletion() = 0;
+    };
+}
+
+#endif
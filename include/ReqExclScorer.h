@@ -13,6 +13,10 @@ namespace Lucene
 {
     /// A Scorer for queries with a required subscorer and an excluding (prohibited) sub DocIdSetIterator.
     /// This Scorer implements {@link Scorer#skipTo(int32_t)}, and it uses the skipTo() on the given scorers.
+    ///
+    /// The required scorer and, when the exclusion is a Scorer, the exclusion are moved by their approximations 
+    /// and confirmed only when needed, and the exclusion check is deferred to {@link #twoPhaseIterator()}, so that
+    /// conjunctions and filters apply it only to the docs they accept.
     class ReqExclScorer : public Scorer
     {
     public:
@@ -26,8 +30,10 @@ namespace Lucene
     
     protected:
         ScorerPtr reqScorer;
-        DocIdSetIteratorPtr exclDisi;
-        int32_t doc;
+        DocIdSetIteratorPtr reqApproximation;
+        TwoPhaseIteratorPtr reqTwoPhase;
+        DocIdSetIteratorPtr exclApproximation;
+        TwoPhaseIteratorPtr exclTwoPhase;
     
     public:
         virtual int32_t nextDoc();
@@ -39,19 +45,19 @@ namespace Lucene
         virtual double score();
         
         virtual int32_t advance(int32_t target);
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
     
     protected:
+        /// Returns whether the doc the required approximation is on is matched by the required scorer and not
+        /// excluded.
+        bool matches();
+        
         /// Advance to non excluded doc.
-        ///
-        /// On entry:
-        /// <ul>
-        /// <li>reqScorer != null,
-        /// <li>exclScorer != null,
-        /// <li>reqScorer was advanced once via next() or skipTo() and reqScorer.doc() may still be excluded.
-        /// </ul>
-        /// Advances reqScorer a non excluded required doc, if any.
-        /// @return true iff there is a non excluded required doc.
-        int32_t toNonExcluded();
+        /// @param doc The doc of the required approximation, which may be excluded.
+        /// @return The first non excluded required doc from doc on, or NO_MORE_DOCS if there is none.
+        int32_t toNonExcluded(int32_t doc);
+        
+        friend class ReqExclScorerTwoPhaseIterator;
     };
 }
 
@@ -29,6 +29,7 @@ namespace Lucene
         virtual int32_t nextDoc();
         virtual int32_t advance(int32_t target);
         virtual int32_t docID();
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
         
         /// Returns the score of the current document matching the query.  Initially invalid, until {@link #next()} 
         /// is called the first time.
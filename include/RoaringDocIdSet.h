@@ -0,0 +1,103 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROARINGDOCIDSET_H
+#define ROARINGDOCIDSET_H
+
+#include "DocIdSet.h"
+
+namespace Lucene
+{
+    /// A compressed set of doc ids that adapts to the density of each range of the set.
+    ///
+    /// Doc ids are split into blocks of 65536 by their upper 16 bits.  Each block that has any doc ids is held
+    /// in a container chosen by its content: a sorted array of the lower 16 bits when the block is sparse, a
+    /// bitmap of 65536 bits when it is dense, or a list of runs of consecutive doc ids when that is smaller
+    /// still.  Empty blocks take no space at all, so a set costs roughly the smaller of two bytes per doc id
+    /// and one bit per document in each block, instead of one or the other for the whole set.
+    ///
+    /// The set may be changed with {@link #set} and {@link #clear}, which keep array and bitmap containers;
+    /// {@link #optimize} converts every container to its smallest form, including runs.
+    class LPPAPI RoaringDocIdSet : public DocIdSet
+    {
+    public:
+        /// Creates an empty set.
+        RoaringDocIdSet();
+        
+        /// Creates a set of the doc ids of an iterator, which is iterated completely.
+        RoaringDocIdSet(DocIdSetIteratorPtr docIdSetIterator);
+        
+        virtual ~RoaringDocIdSet();
+        
+        LUCENE_CLASS(RoaringDocIdSet);
+    
+    protected:
+        /// The upper 16 bits of the doc ids in each container, in increasing order.
+        Collection<int32_t> keys;
+        Collection<RoaringContainerPtr> containers;
+    
+    public:
+        virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
+        
+        /// Adds a doc id to the set.  Adding doc ids in increasing order is fastest.
+        void set(int32_t doc);
+        
+        /// Removes a doc id from the set.
+        void clear(int32_t doc);
+        
+        /// Returns true if the set contains the doc id.
+        bool get(int32_t doc);
+        
+        /// Returns the number of doc ids in the set.
+        int32_t cardinality();
+        
+        bool isEmpty();
+        
+        /// Converts each container to the smallest of its array, bitmap and run forms.
+        void optimize();
+        
+        /// Returns the number of bytes of memory used by the containers.
+        int64_t sizeInBytes();
+        
+        /// Returns a new set of the doc ids in both sets.
+        static RoaringDocIdSetPtr _and(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b);
+        
+        /// Returns a new set of the doc ids in either set.
+        static RoaringDocIdSetPtr _or(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b);
+        
+        /// Returns a new set of the doc ids in a that are not in b.
+        static RoaringDocIdSetPtr andNot(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b);
+        
+        /// Returns the number of doc ids in both sets, without creating their intersection.
+        static int32_t intersectionCount(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b);
+        
+        /// Writes the set so that it can be read back with {@link #read}.
+        void write(IndexOutputPtr output);
+        
+        /// Reads a set written by {@link #write}.
+        static RoaringDocIdSetPtr read(IndexInputPtr input);
+        
+        virtual DocIdSetIteratorPtr iterator();
+        
+        /// This DocIdSet implementation is cacheable.
+        virtual bool isCacheable();
+    
+    protected:
+        /// Returns the index of the container with the given key, or -(insertion point) - 1 if there is none.
+        int32_t findContainer(int32_t key, int32_t fromIndex = 0);
+        
+        /// Returns the container for the given key, adding an empty one if there is none.
+        RoaringContainerPtr getOrAddContainer(int32_t key);
+        
+        /// Appends a container, which must have a greater key than the last one.  Null or empty containers
+        /// are skipped.
+        void appendContainer(int32_t key, RoaringContainerPtr container);
+        
+        friend class RoaringDocIdSetIterator;
+    };
+}
+
+#endif
@@ -44,6 +44,26 @@ namespace Lucene
         /// #nextDoc()} or {@link #advance(int32_t)} is called the first time, or when called from within
         /// {@link Collector#collect}.
         virtual double score() = 0;
+        
+        /// Moves the score bounds, but not the iterator, to the docs from target on and returns the last doc up 
+        /// to which {@link #getMaxScore} can give a tight bound.  Target must not be greater than that of the next
+        /// call of {@link #advance}.  The default implementation knows no bounds and returns NO_MORE_DOCS.
+        virtual int32_t advanceShallow(int32_t target);
+        
+        /// Returns an upper bound of the scores of the docs from the target of the last call of {@link 
+        /// #advanceShallow} up to upTo.  The default implementation returns positive infinity.
+        virtual double getMaxScore(int32_t upTo);
+        
+        /// Tells the scorer that docs scoring less than minScore can't be collected, so it may pass over them.
+        /// Called from within {@link Collector#setScorer} and {@link Collector#collect} by collectors that 
+        /// {@link Collector#needsTopScoresOnly need the top scores only}.  The default implementation ignores it.
+        virtual void setMinCompetitiveScore(double minScore);
+        
+        /// Returns a view of this scorer that iterates over an approximation of the matching docs first and 
+        /// confirms each of them separately, or null if matching needs no confirmation.  Moving the approximation
+        /// moves this scorer.  The default implementation returns null.
+        /// @see TwoPhaseIterator
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
     
     protected:
         /// Collects matching documents in a range.  Hook for optimization.
@@ -86,6 +86,12 @@ namespace Lucene
         // True if this segment has any fields with omitTermFreqAndPositions == false
         bool hasProx;
         
+        // Name of the codec that wrote this segment
+        String codecName;
+        
+        // Description of the sort the documents of this segment are in, or empty if unsorted
+        String indexSort;
+        
         MapStringString diagnostics;
                             
     public:
@@ -149,6 +155,24 @@ namespace Lucene
         
         void setHasProx(bool hasProx);
         bool getHasProx();
+        
+        /// Set the codec that writes this segment.
+        void setCodec(CodecPtr codec);
+        
+        /// Returns the codec that reads this segment.
+        /// @throws IllegalArgumentException if no codec with the recorded name is registered
+        CodecPtr getCodec();
+        
+        /// Returns the name of the codec that wrote this segment.
+        String getCodecName();
+        
+        /// Record that the documents of this segment are in the order of a sort, as described by {@link 
+        /// IndexSorter#describe}.
+        void setIndexSort(const String& indexSort);
+        
+        /// Returns the description of the sort the documents of this segment are in, or an empty string if
+        /// they are in the order they were added.
+        String getIndexSort();
     
         /// Return all files referenced by this SegmentInfo.  The returns List is a locally cached List so 
         /// you should not modify it.
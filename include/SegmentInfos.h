@@ -51,6 +51,12 @@ namespace Lucene
         
         /// This format adds optional per-segment string diagnostics storage, and switches userData to Map
         static const int32_t FORMAT_DIAGNOSTICS;
+        
+        /// This format adds the name of the codec that wrote each segment.
+        static const int32_t FORMAT_CODEC;
+        
+        /// This format adds the sort the documents of each segment are in.
+        static const int32_t FORMAT_INDEX_SORT;
   
         /// This must always point to the most recent file format.
         static const int32_t CURRENT_FORMAT;
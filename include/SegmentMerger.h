@@ -31,6 +31,12 @@ namespace Lucene
         String segment;
         int32_t termIndexInterval;
         
+        /// How postings of the merged segment are encoded.
+        int32_t postingsFormat;
+        
+        /// Writes the files of the merged segment.
+        CodecPtr codec;
+        
         Collection<IndexReaderPtr> readers;
         FieldInfosPtr fieldInfos;
         
@@ -41,6 +47,12 @@ namespace Lucene
         /// are merging already share the same doc store files, we don't need to merge the doc stores.
         bool mergeDocStores;
         
+        /// Whether the checksums of all source segment files are verified before merging.
+        bool checkIntegrity;
+        
+        /// Whether any of the readers has per-document values.
+        bool hasDocValues;
+        
         /// Maximum number of contiguous documents to bulk-copy when merging stored fields
         static const int32_t MAX_RAW_MERGE_DOCS;
         
@@ -52,9 +64,24 @@ namespace Lucene
         bool omitTermFreqAndPositions;
         
         ByteArray payloadBuffer;
+        
+        /// Positions and payloads of the term being merged when the merged documents are reordered.
+        RAMFilePtr sortedPositionsFile;
+        RAMOutputStreamPtr sortedPositions;
+        
         Collection< Collection<int32_t> > docMaps;
         Collection<int32_t> delCounts;
         
+        /// Sort of the merged documents, if the writer has an index sort.
+        SortPtr indexSort;
+        
+        /// When the merged documents are reordered, the reader and the document within it of each merged 
+        /// document, and the merged document of each document of the readers numbered one after the other 
+        /// without deletions.
+        Collection<int32_t> sortedReaders;
+        Collection<int32_t> sortedDocs;
+        Collection<int32_t> sortDocMap;
+        
     public:
         /// norms header placeholder
         static const uint8_t NORMS_HEADER[];
@@ -90,21 +117,42 @@ namespace Lucene
         
         Collection< Collection<int32_t> > getDocMaps();
         Collection<int32_t> getDelCounts();
+        
+        /// Returns the description of the sort the merged documents are in, or an empty string if there is no 
+        /// index sort.
+        String getIndexSort();
+        
+        /// Returns the merged document of each document of the readers, numbered one after the other without 
+        /// deletions, or null if the merged documents are in the order of the readers.
+        Collection<int32_t> getSortDocMap();
     
     protected:
+        /// Works out the order of the merged documents from the index sort.
+        void sortDocs();
+        
+        /// Returns the merged document of a document of the readers, numbered one after the other without 
+        /// deletions.
+        int32_t sortedDoc(int32_t doc);
+        
         void addIndexed(IndexReaderPtr reader, FieldInfosPtr fInfos, HashSet<String> names, bool storeTermVectors,
                         bool storePositionWithTermVector, bool storeOffsetWithTermVector, bool storePayloads, 
                         bool omitTFAndPositions);
       
+        /// Verify the checksum footer of every file belonging to the segments being merged, skipping 
+        /// segments written before footers were introduced.
+        void checkIntegrityOfReaders();
+        
         void setMatchingSegmentReaders();
         int32_t copyFieldsWithDeletions(FieldsWriterPtr fieldsWriter, IndexReaderPtr reader, FieldsReaderPtr matchingFieldsReader);
         int32_t copyFieldsNoDeletions(FieldsWriterPtr fieldsWriter, IndexReaderPtr reader, FieldsReaderPtr matchingFieldsReader);
+        int32_t copyFieldsSorted(FieldsWriterPtr fieldsWriter);
         
         /// Merge the TermVectors from each of the segments into the new one.
         void mergeVectors();
         
         void copyVectorsWithDeletions(TermVectorsWriterPtr termVectorsWriter, TermVectorsReaderPtr matchingVectorsReader, IndexReaderPtr reader);
         void copyVectorsNoDeletions(TermVectorsWriterPtr termVectorsWriter, TermVectorsReaderPtr matchingVectorsReader, IndexReaderPtr reader);
+        void copyVectorsSorted(TermVectorsWriterPtr termVectorsWriter);
         
         void mergeTerms();
         
@@ -117,7 +165,20 @@ namespace Lucene
         /// @return number of documents across all segments where this term was found
         int32_t appendPostings(FormatPostingsTermsConsumerPtr termsConsumer, Collection<SegmentMergeInfoPtr> smis, int32_t n);
         
+        /// Process postings from multiple segments all positioned on the same term when the merged documents 
+        /// are reordered.  The postings are gathered and written in the order of the merged documents, so 
+        /// the postings of the term, with positions and payloads delta coded in RAM, are held at once.
+        int32_t appendSortedPostings(FormatPostingsTermsConsumerPtr termsConsumer, Collection<SegmentMergeInfoPtr> smis, int32_t n);
+        
         void mergeNorms();
+        
+        /// Reads the merged norms of each field back from the norms file, for the skip entries of the merged 
+        /// postings.  Returns the open norms file, which the norms may be read from in place until it is 
+        /// closed, or null if no field has norms.
+        IndexInputPtr readMergedNorms(MapStringNormValues fieldNorms);
+        
+        /// Merge the per-document values of every field, dropping deleted documents.
+        void mergeDocValues();
     };
     
     class CheckAbort : public LuceneObject
@@ -105,6 +105,9 @@ namespace Lucene
         /// Returns the number of documents containing the term t.
         virtual int32_t docFreq(TermPtr t);
         
+        /// Returns the number of documents containing each of the terms, reading their dictionary blocks together.
+        virtual Collection<int32_t> docFreqs(Collection<TermPtr> terms);
+        
         /// Returns the number of documents in this index.
         virtual int32_t numDocs();
         
@@ -123,6 +126,17 @@ namespace Lucene
         /// Read norms into a pre-allocated array.
         virtual void norms(const String& field, ByteArray norms, int32_t offset);
         
+        /// Returns the norms of a field without copying them to the heap where the .nrm file allows it.
+        virtual NormValuesPtr normValues(const String& field);
+        
+        /// Returns true if the norms of this field may differ from those the segment was written with, as after 
+        /// {@link #setNorm}, so that the norms recorded in its skip data no longer bound them.
+        bool normsChanged(const String& field);
+        
+        virtual NumericDocValuesPtr getNumericDocValues(const String& field);
+        virtual BinaryDocValuesPtr getBinaryDocValues(const String& field);
+        virtual SortedDocValuesPtr getSortedDocValues(const String& field);
+        
         bool termsIndexLoaded();
         
         /// NOTE: only called from IndexWriter when a near real-time reader is opened, or applyDeletes is run, sharing a 
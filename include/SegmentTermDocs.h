@@ -40,6 +40,17 @@ namespace Lucene
         
         bool currentFieldStoresPayloads;
         bool currentFieldOmitTermFreqAndPositions;
+        
+        /// Whether the skip entries of the current field record the greatest freq and norm of the docs they skip.
+        bool currentFieldFreqImpacts;
+        bool currentFieldNormImpacts;
+        
+        /// Decoded docs and freqs of the current block, when reading block packed postings.
+        BlockPackedIntsPtr blockPacker;
+        IntArray docBuffer;
+        IntArray freqBuffer;
+        int32_t bufferUpto;
+        int32_t bufferCount;
     
     public:
         /// Sets this to the data for a term.
@@ -67,6 +78,9 @@ namespace Lucene
         /// Optimized implementation.
         virtual bool skipTo(int32_t target);
         
+        /// Reads the bounds of the block holding target from the skip data.
+        virtual int32_t advanceShallow(int32_t target, int32_t& maxFreq, int32_t& maxNorm);
+        
         /// Used for testing
         virtual IndexInputPtr freqStream();
         virtual void freqStream(IndexInputPtr freqStream);
@@ -75,6 +89,15 @@ namespace Lucene
         virtual void skippingDoc();
         virtual int32_t readNoTf(Collection<int32_t> docs, Collection<int32_t> freqs, int32_t length);
         
+        /// Returns true if the term has skip data, creating and initializing the skip list reader on first use.
+        bool initSkipList();
+        
+        /// Decodes the next block of docs and freqs if the remaining docs of the term fill a block.
+        bool refillBuffer();
+        
+        /// Reads the next doc and freq from the buffer or, past the last full block, from VInts.
+        void readDoc();
+        
         /// Overridden by SegmentTermPositions to skip in prox stream.
         virtual void skipProx(int64_t proxPointer, int32_t payloadLength);
     };
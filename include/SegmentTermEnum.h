@@ -19,6 +19,8 @@ namespace Lucene
         virtual ~SegmentTermEnum();
         
         LUCENE_CLASS(SegmentTermEnum);
+        
+        friend class TermInfosReader;
             
     protected:
         IndexInputPtr input;
@@ -41,12 +43,17 @@ namespace Lucene
         int32_t indexInterval;
         int32_t skipInterval;
         int32_t maxSkipLevels;
+        int32_t postingsFormat;
+        bool skipImpacts;
     
     public:
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
     
         void seek(int64_t pointer, int64_t p, TermPtr t, TermInfoPtr ti);
         
+        /// Seeks to a term given by its field and UTF-8 encoded text, as found in the terms index transducer.
+        void seek(int64_t pointer, int64_t p, const String& field, const uint8_t* text, int32_t textLength, TermInfoPtr ti);
+        
         /// Increments the enumeration to the next element.  True if one exists.
         virtual bool next();
         
@@ -28,8 +28,14 @@ namespace Lucene
         String docStoreSegmentName;
         int32_t numDocs;
         int32_t termIndexInterval;
+        int32_t postingsFormat;
+        CodecPtr codec;
         int32_t numDocsInStore;
         HashSet<String> flushedFiles;
+        
+        /// Norms of each field as written to the norms file, which are written before the postings so that 
+        /// skip entries can record the greatest norm of the docs they skip over.
+        MapStringNormValues fieldNorms;
     
     public:
         String segmentFileName(const String& ext);
@@ -0,0 +1,59 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef SLICEDINDEXINPUT_H
+#define SLICEDINDEXINPUT_H
+
+#include "BufferedIndexInput.h"
+
+namespace Lucene
+{
+    /// Default implementation of {@link IndexInput#slice}, for inputs that can't bound a clone of themselves.
+    /// Reads a portion of a clone of the base input through its own buffer.
+    class LPPAPI SlicedIndexInput : public BufferedIndexInput
+    {
+    public:
+        SlicedIndexInput();
+        SlicedIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length);
+        SlicedIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length, int32_t readBufferSize);
+        virtual ~SlicedIndexInput();
+        
+        LUCENE_CLASS(SlicedIndexInput);
+        
+    public:
+        IndexInputPtr base;
+        int64_t fileOffset;
+        int64_t _length;
+        
+    public:
+        /// Closes the stream to further operations.
+        virtual void close();
+        
+        virtual int64_t length();
+        
+        /// Slices the base input directly, rather than stacking another slice on this one.
+        virtual IndexInputPtr slice(int64_t offset, int64_t length);
+        
+        /// Returns the bytes in place from the base input, if it can expose them.
+        virtual const uint8_t* mappedBytes(int64_t pos, int64_t length);
+        
+        /// Returns a clone of this stream.
+        virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
+    
+    protected:
+        /// Implements buffer refill.  Reads bytes from the current position in the input.
+        /// @param b the array to read bytes into
+        /// @param offset the offset in the array to start storing bytes
+        /// @param len the number of bytes to read
+        virtual void readInternal(uint8_t* b, int32_t offset, int32_t length);
+        
+        /// Implements seek.  Sets current position in this file, where the next {@link 
+        /// #readInternal(byte[],int,int)} will occur.
+        virtual void seekInternal(int64_t pos);
+    };
+}
+
+#endif
@@ -0,0 +1,62 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef SORTEDDOCVALUES_H
+#define SORTEDDOCVALUES_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Random access to the sorted per-document values of a field in one segment.
+    ///
+    /// Each document has the ordinal of its value in a sorted dictionary of the segment's distinct values, so
+    /// documents of the same segment can be compared by ordinal without looking at their values.
+    /// @see IndexReader#getSortedDocValues
+    class LPPAPI SortedDocValues : public LuceneObject
+    {
+    public:
+        SortedDocValues(IndexInputPtr input);
+        virtual ~SortedDocValues();
+        
+        LUCENE_CLASS(SortedDocValues);
+    
+    protected:
+        IndexInputPtr input;
+        int32_t numDocs;
+        int32_t numOrds;
+        int32_t ordWidth;
+        int64_t ordPointer;
+        int32_t addressWidth;
+        int64_t addressPointer;
+        int64_t dataPointer;
+        UTF8ResultPtr scratch;
+    
+    public:
+        /// Returns the number of documents.
+        int32_t size();
+        
+        /// Returns the number of distinct values.
+        int32_t getValueCount();
+        
+        /// Returns the ordinal of a document's value, or -1 if the document has no value.
+        int32_t getOrd(int32_t doc);
+        
+        /// Reads the UTF-8 bytes of the value with the given ordinal into result.
+        void lookupOrd(int32_t ord, UTF8ResultPtr result);
+        
+        /// Returns the value with the given ordinal.
+        String lookup(int32_t ord);
+        
+        /// Returns the value of a document, or empty if the document has no value.
+        String getString(int32_t doc);
+        
+        /// Returns the ordinal of the given value if it is in the dictionary, otherwise (-(insertion point) - 1).
+        int32_t lookupTerm(const String& value);
+    };
+}
+
+#endif
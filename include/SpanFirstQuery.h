@@ -40,6 +40,7 @@ namespace Lucene
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
         virtual void extractTerms(SetTerm terms);
         virtual SpansPtr getSpans(IndexReaderPtr reader);
+        virtual DocIdSetIteratorPtr getApproximation(IndexReaderPtr reader);
         virtual QueryPtr rewrite(IndexReaderPtr reader);
         
         virtual bool equals(LuceneObjectPtr other);
@@ -48,6 +48,7 @@ namespace Lucene
         virtual void extractTerms(SetTerm terms);
         virtual String toString(const String& field);
         virtual SpansPtr getSpans(IndexReaderPtr reader);
+        virtual DocIdSetIteratorPtr getApproximation(IndexReaderPtr reader);
         virtual QueryPtr rewrite(IndexReaderPtr reader);
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
         virtual bool equals(LuceneObjectPtr other);
@@ -39,6 +39,7 @@ namespace Lucene
         virtual String toString(const String& field);
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
         virtual SpansPtr getSpans(IndexReaderPtr reader);
+        virtual DocIdSetIteratorPtr getApproximation(IndexReaderPtr reader);
         virtual QueryPtr rewrite(IndexReaderPtr reader);
         
         virtual bool equals(LuceneObjectPtr other);
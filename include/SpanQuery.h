@@ -22,6 +22,11 @@ namespace Lucene
         /// Returns the matches for this query in an index.  Used internally to search for spans.
         virtual SpansPtr getSpans(IndexReaderPtr reader) = 0;
         
+        /// Returns an iterator over a superset of the docs that have spans of this query in an index, which reads
+        /// no positions, or null if there is none.  Lets {@link SpanScorer} position the spans only on the docs 
+        /// that conjunctions and filters accept.  The default implementation returns null.
+        virtual DocIdSetIteratorPtr getApproximation(IndexReaderPtr reader);
+        
         /// Returns the name of the field matched by this query.
         virtual String getField() = 0;
         
@@ -12,9 +12,14 @@
 namespace Lucene
 {
     /// Public for extension only.
+    ///
+    /// Given an approximation of the docs with spans, such as that of {@link SpanQuery#getApproximation}, the
+    /// scorer iterates over the approximation and positions the spans only to confirm its docs, which are then
+    /// checked only on docs that conjunctions and filters accept through {@link #twoPhaseIterator()}.
     class LPPAPI SpanScorer : public Scorer
     {
     public:
+        SpanScorer(SpansPtr spans, WeightPtr weight, SimilarityPtr similarity, NormValuesPtr norms, DocIdSetIteratorPtr approximation = DocIdSetIteratorPtr());
         SpanScorer(SpansPtr spans, WeightPtr weight, SimilarityPtr similarity, ByteArray norms);
         virtual ~SpanScorer();
         
@@ -23,27 +28,42 @@ namespace Lucene
     protected:
         SpansPtr spans;
         WeightPtr weight;
-        ByteArray norms;
+        NormValuesPtr norms;
         double value;
         bool more;
         int32_t doc;
         double freq;
+        
+        /// The docs to position the spans on, null if the spans are iterated directly.
+        DocIdSetIteratorPtr approximation;
+        bool firstTime;
     
     public:
         virtual int32_t nextDoc();
         virtual int32_t advance(int32_t target);
         virtual int32_t docID();
         virtual double score();
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
         
     protected:
+        void ConstructScorer(SpansPtr spans, WeightPtr weight, NormValuesPtr norms, DocIdSetIteratorPtr approximation);
+        
         virtual bool setFreqCurrentDoc();
         
+        /// Positions the spans on the doc of the approximation.  Returns whether they have a match there, in 
+        /// which case the frequency of the doc is set.
+        bool matches();
+        
+        /// Moves the approximation from doc on to the first doc that has spans.
+        int32_t toMatch(int32_t doc);
+        
         /// This method is no longer an official member of {@link Scorer}, but it is needed by SpanWeight 
         /// to build an explanation.
         virtual ExplanationPtr explain(int32_t doc);
         
         friend class SpanWeight;
         friend class PayloadNearSpanWeight;
+        friend class SpanScorerTwoPhaseIterator;
     };
 }
 
@@ -37,6 +37,7 @@ namespace Lucene
         virtual bool equals(LuceneObjectPtr other);
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
         virtual SpansPtr getSpans(IndexReaderPtr reader);
+        virtual DocIdSetIteratorPtr getApproximation(IndexReaderPtr reader);
     };
 }
 
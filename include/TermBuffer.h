@@ -36,6 +36,9 @@ namespace Lucene
         void read(IndexInputPtr input, FieldInfosPtr fieldInfos);
         
         void set(TermPtr term);
+        
+        /// Sets the term from its UTF-8 encoded text, without creating a Term.
+        void set(const String& field, const uint8_t* utf8, int32_t length);
         void set(TermBufferPtr other);
         void reset();
         
@@ -50,6 +50,14 @@ namespace Lucene
         /// Skips entries to the first beyond the current whose document number is greater than or equal to target.  
         /// Returns true if there is such an entry.
         virtual bool skipTo(int32_t target) = 0;
+        
+        /// Moves the skip data, but not the enumeration, to the block of docs holding target and returns the last 
+        /// doc of that block, along with the greatest term frequency and encoded norm of its docs.  Every doc from 
+        /// target up to the returned doc scores no more than these allow, so scorers may pass over the whole block 
+        /// when they cannot enter the current top hits.  Target must not be greater than that of the next call of 
+        /// {@link #skipTo}.  The default implementation knows no bounds: it returns INT_MAX, with INT_MAX for the 
+        /// frequency and 255 for the norm.
+        virtual int32_t advanceShallow(int32_t target, int32_t& maxFreq, int32_t& maxNorm);
 
         /// Frees associated resources.
         virtual void close() = 0;
@@ -34,21 +34,52 @@ namespace Lucene
         Collection<TermInfoPtr> indexInfos;
         Collection<int64_t> indexPointers;
         
+        /// Transducer from each index term to its ordinal, used instead of indexTerms and indexInfos when the 
+        /// terms index has one.  The TermInfos of every indexDivisor'th index term are then held in these arrays.
+        FSTPtr indexFST;
+        IntArray indexDocFreqs;
+        LongArray indexFreqPointers;
+        LongArray indexProxPointers;
+        IntArray indexSkipOffsets;
+        
+        int32_t indexDivisor;
         int32_t totalIndexInterval;
         
+        /// Bloom filter of the terms of each field that keeps one, by field number.  Null if no field does.
+        Collection<BloomFilterPtr> bloomFilters;
+        
         static const int32_t DEFAULT_CACHE_SIZE;
     
     public:
         int32_t getSkipInterval();
         int32_t getMaxSkipLevels();
+        
+        /// Returns how the postings of this segment are encoded.
+        /// @see TermInfosWriter#POSTINGS_FORMAT_BLOCK_PACKED
+        int32_t getPostingsFormat();
+        
+        /// Returns true if skip entries record the greatest freq and norm of the docs they skip over.
+        /// @see TermInfosWriter#FORMAT_VERSION_SKIP_IMPACTS
+        bool hasSkipImpacts();
+        
         void close();
         
         /// Returns the number of term/value pairs in the set.
         int64_t size();
         
-        /// Returns the TermInfo for a Term in the set, or null.
+        /// Returns the TermInfo for a Term in the set, or null.  Terms of fields that keep a bloom filter are 
+        /// checked against it first, so most terms that aren't in the set are rejected without a search.
         TermInfoPtr get(TermPtr term);
         
+        /// Returns the TermInfo of each of a number of Terms, or null for those not in the set.  The dictionary 
+        /// blocks of the terms that have to be looked up are read together through {@link IndexInput#submitReads}, 
+        /// so that their reads can overlap, and the terms are then found in the blocks read.
+        Collection<TermInfoPtr> get(Collection<TermPtr> terms);
+        
+        /// Returns false if the term is certainly not in the set, which is only known for the terms of fields 
+        /// that keep a bloom filter.
+        bool mayContain(TermPtr term);
+        
         /// Returns the position of a Term in the set or -1.
         int64_t getPosition(TermPtr term);
         
@@ -61,10 +92,24 @@ namespace Lucene
     protected:
         TermInfosReaderThreadResourcesPtr getThreadResources();
         
-        /// Returns the offset of the greatest index entry which is less than or equal to term.
-        int32_t getIndexOffset(TermPtr term);
+        /// Loads the terms index transducer, if the terms index has one.
+        bool loadIndexFST(IndexInputPtr input);
+        
+        /// Loads the bloom filters of the fields that keep one.
+        void loadBloomFilters(IndexInputPtr input);
+        
+        /// Returns the offset of the greatest index entry which is less than or equal to term.  When the 
+        /// transducer is used, the floor key is left in the thread's resources for {@link #seekEnum}.
+        int32_t getIndexOffset(TermPtr term, TermInfosReaderThreadResourcesPtr resources);
+        
+        /// Returns the term of an index entry.  When the transducer is used, the last one is kept in the 
+        /// thread's resources, so scanning within a block doesn't look it up again.
+        TermPtr getIndexTerm(int32_t indexOffset, TermInfosReaderThreadResourcesPtr resources);
         
-        void seekEnum(SegmentTermEnumPtr enumerator, int32_t indexOffset);
+        /// Positions an enumeration at an index entry.
+        /// @param base file position of the first byte of the enumeration's input, when it holds a block read 
+        /// from the dictionary rather than the whole of it.
+        void seekEnum(SegmentTermEnumPtr enumerator, int32_t indexOffset, TermInfosReaderThreadResourcesPtr resources, int64_t base = 0);
         
         /// Returns the TermInfo for a Term in the set, or null.
         TermInfoPtr get(TermPtr term, bool useCache);
@@ -84,6 +129,25 @@ namespace Lucene
     
         // Used for caching the least recently looked-up Terms
         TermInfoCachePtr termInfoCache;
+        
+        // Used for looking up terms in the terms index transducer
+        UTF8ResultPtr indexKey;
+        String indexKeyField;
+        int32_t indexKeyFieldLength;
+        UTF8ResultPtr indexKeyText;
+        UTF8ResultPtr floorKey;
+        int64_t floorOrdinal;
+        UTF8ResultPtr seekFieldKey;
+        String seekField;
+        TermInfoPtr indexTermInfo;
+        
+        // The index term that ends the block the enumeration is in
+        UTF8ResultPtr blockEndKey;
+        int32_t blockEndOffset;
+        TermPtr blockEndTerm;
+        
+        // Used for hashing terms to check them against the bloom filters
+        UTF8ResultPtr bloomKey;
     };
 }
 
@@ -16,8 +16,8 @@ namespace Lucene
     class TermInfosWriter : public LuceneObject
     {
     public:
-        TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval);
-        TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, bool isIndex);
+        TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, int32_t postingsFormat = POSTINGS_FORMAT_VINT);
+        TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, int32_t postingsFormat, bool isIndex);
         virtual ~TermInfosWriter();
         
         LUCENE_CLASS(TermInfosWriter);
@@ -29,9 +29,25 @@ namespace Lucene
         /// Changed strings to true utf8 with length-in-bytes not length-in-chars.
         static const int32_t FORMAT_VERSION_UTF8_LENGTH_IN_BYTES;
         
+        /// Records how the segment's postings are encoded.
+        static const int32_t FORMAT_VERSION_POSTINGS_FORMAT;
+        
+        /// Appends the index terms to the terms index as an {@link FST}.
+        static const int32_t FORMAT_VERSION_TERMS_INDEX_FST;
+        
+        /// Skip entries record the greatest freq and norm of the docs they skip over.
+        static const int32_t FORMAT_VERSION_SKIP_IMPACTS;
+        
+        /// The terms index only holds the index terms as prefix coded entries if their {@link FST} couldn't 
+        /// be built.
+        static const int32_t FORMAT_VERSION_TERMS_INDEX_FST_ONLY;
+        
         /// NOTE: always change this if you switch to a new format.
         static const int32_t FORMAT_CURRENT;
         
+        /// Format of the file holding the bloom filters of the terms of fields that keep one.
+        static const int32_t BLOOM_FILTERS_FORMAT;
+        
         /// The fraction of terms in the "dictionary" which should be stored in RAM.  Smaller values use more memory, but 
         /// make searching slightly faster, while larger values use less memory and make searching slightly slower.  
         /// Searching is typically not dominated by dictionary lookup, so tweaking this is rarely useful.
@@ -46,6 +62,16 @@ namespace Lucene
         /// The maximum number of skip levels. Smaller values result in slightly smaller indexes, but slower skipping 
         /// in big posting lists.
         int32_t maxSkipLevels;
+        
+        /// How the postings of the segment are encoded.
+        int32_t postingsFormat;
+        
+        /// Docs and freqs are written one VInt at a time.
+        static const int32_t POSTINGS_FORMAT_VINT;
+        
+        /// Docs and freqs are written in blocks of {@link BlockPackedInts#BLOCK_SIZE} using {@link BlockPackedInts}, 
+        /// with the remainder of each posting list written as VInts.  Skip entries are written at block boundaries.
+        static const int32_t POSTINGS_FORMAT_BLOCK_PACKED;
     
     protected:
         FieldInfosPtr fieldInfos;
@@ -63,6 +89,33 @@ namespace Lucene
         TermInfosWriterWeakPtr _other;
         UTF8ResultPtr utf8Result;
         
+        /// Transducer from each index term to its ordinal, built by the index writer.  Null if the index terms 
+        /// turn out not to be in byte order.
+        FSTBuilderPtr indexBuilder;
+        
+        /// The TermInfo and .tis pointer of each index term, written after the transducer.
+        RAMOutputStreamPtr indexEntries;
+        
+        /// The index writer's prefix coded entries are held here while the transducer is being built, and are 
+        /// only written to the terms index (indexFileOutput) if it can't be.
+        RAMOutputStreamPtr bufferedIndexTerms;
+        IndexOutputPtr indexFileOutput;
+        
+        /// Key of the last index term: the field name, a zero byte and the term.
+        UTF8ResultPtr indexKey;
+        int32_t indexKeyField;
+        int32_t indexKeyFieldLength;
+        
+        /// The bloom filter of each field that keeps one, written to the .blm file when closed.  Null if no field 
+        /// keeps one, and always null for the index writer.
+        IndexOutputPtr bloomOutput;
+        RAMOutputStreamPtr bloomFilters;
+        int32_t numBloomFilters;
+        
+        /// Hashes of the terms of the current bloom filtered field.
+        Collection<int64_t> bloomHashes;
+        int32_t bloomField;
+        
         // Currently used only by assert statements
         UnicodeResultPtr unicodeResult1;
         UnicodeResultPtr unicodeResult2;
@@ -80,7 +133,7 @@ namespace Lucene
         void close();
     
     protected:
-        void initialize(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, bool isi);
+        void initialize(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, int32_t postingsFormat, bool isi);
         
         /// Currently used only by assert statements
         bool initUnicodeResults();
@@ -89,6 +142,15 @@ namespace Lucene
         int32_t compareToLastTerm(int32_t fieldNumber, ByteArray termBytes, int32_t termBytesLength);
         
         void writeTerm(int32_t fieldNumber, ByteArray termBytes, int32_t termBytesLength);
+        
+        /// Adds an index term to the transducer and its TermInfo and .tis pointer to the index entries.
+        void addIndexEntry(int32_t fieldNumber, ByteArray termBytes, int32_t termBytesLength, TermInfoPtr ti, int64_t indexPointer);
+        
+        /// Writes the transducer and index entries at the end of the terms index, followed by their start.
+        void writeIndexFST();
+        
+        /// Adds the bloom filter of the terms of the current bloom filtered field, if it had any.
+        void finishBloomFilter();
     };
 }
 
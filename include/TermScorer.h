@@ -20,6 +20,13 @@ namespace Lucene
         /// @param td An iterator over the documents matching the Term.
         /// @param similarity The Similarity implementation to be used for score computations.
         /// @param norms The field norms of the document fields for the Term.
+        TermScorer(WeightPtr weight, TermDocsPtr td, SimilarityPtr similarity, NormValuesPtr norms);
+        
+        /// Construct a TermScorer.
+        /// @param weight The weight of the Term in the query.
+        /// @param td An iterator over the documents matching the Term.
+        /// @param similarity The Similarity implementation to be used for score computations.
+        /// @param norms The field norms of the document fields for the Term, one byte per document.
         TermScorer(WeightPtr weight, TermDocsPtr td, SimilarityPtr similarity, ByteArray norms);
         
         virtual ~TermScorer();
@@ -29,7 +36,7 @@ namespace Lucene
     protected:
         WeightPtr weight;
         TermDocsPtr termDocs;
-        ByteArray norms;
+        NormValuesPtr norms;
         double weightValue;
         int32_t doc;
         
@@ -40,6 +47,9 @@ namespace Lucene
         
         static const int32_t SCORE_CACHE_SIZE;
         Collection<double> scoreCache;
+        
+        int32_t shallowUpTo; // last doc of the skip block of the last shallow target
+        double shallowMaxScore; // greatest score of the docs of that block
     
     public:
         virtual void score(CollectorPtr collector);
@@ -59,10 +69,19 @@ namespace Lucene
         /// @return the matching document or -1 if none exist.
         virtual int32_t advance(int32_t target);
         
+        /// Moves to the skip block holding target, using {@link TermDocs#advanceShallow}, and returns its last doc.
+        virtual int32_t advanceShallow(int32_t target);
+        
+        /// Returns the score of the greatest frequency and norm of the current skip block, if it holds upTo.  This
+        /// assumes that {@link Similarity#tf} doesn't decrease as the frequency grows.
+        virtual double getMaxScore(int32_t upTo);
+        
         /// Returns a string representation of this TermScorer.
         virtual String toString();
         
     protected:
+        void ConstructScorer(WeightPtr weight, TermDocsPtr td, NormValuesPtr norms);
+        
         static const Collection<double> SIM_NORM_DECODER();
         
         virtual bool score(CollectorPtr collector, int32_t max, int32_t firstDocID);
@@ -32,6 +32,9 @@ namespace Lucene
         /// Changed strings to UTF8 with length-in-bytes not length-in-chars
         static const int32_t FORMAT_UTF8_LENGTH_IN_BYTES;
         
+        /// Files end with a {@link ChecksumFooter}
+        static const int32_t FORMAT_CHECKSUM_FOOTER;
+        
         /// NOTE: always change this if you switch to a new format.
         static const int32_t FORMAT_CURRENT;
         
@@ -62,34 +65,38 @@ namespace Lucene
         /// Used for bulk copy when merging
         IndexInputPtr getTvfStream();
         
-        bool canReadRawDocs();
+        virtual bool canReadRawDocs();
+        
+        /// Returns true if bulk copying all of our docs copies the whole of the tvd and tvf files, except 
+        /// their format header and {@link ChecksumFooter}, so they can be checked while they're copied.
+        virtual bool canVerifyRawDocs();
         
         /// Retrieve the length (in bytes) of the tvd and tvf entries for the next numDocs starting with
         /// startDocID.  This is used for bulk copying when merging segments, if the field numbers are
         /// congruent.  Once this returns, the tvf & tvd streams are seeked to the startDocID.
-        void rawDocs(Collection<int32_t> tvdLengths, Collection<int32_t> tvfLengths, int32_t startDocID, int32_t numDocs);
+        virtual void rawDocs(Collection<int32_t> tvdLengths, Collection<int32_t> tvfLengths, int32_t startDocID, int32_t numDocs);
         
-        void close();
+        virtual void close();
         
         /// @return The number of documents in the reader
-        int32_t size();
+        virtual int32_t size();
         
-        void get(int32_t docNum, const String& field, TermVectorMapperPtr mapper);
+        virtual void get(int32_t docNum, const String& field, TermVectorMapperPtr mapper);
         
         /// Retrieve the term vector for the given document and field
         /// @param docNum The document number to retrieve the vector for
         /// @param field The field within the document to retrieve
         /// @return The TermFreqVector for the document and field or null if there is no termVector for 
         /// this field.
-        TermFreqVectorPtr get(int32_t docNum, const String& field);
+        virtual TermFreqVectorPtr get(int32_t docNum, const String& field);
         
         /// Return all term vectors stored for this document or null if the could not be read in.
         ///
         /// @param docNum The document number to retrieve the vector for
         /// @return All term frequency vectors
-        Collection<TermFreqVectorPtr> get(int32_t docNum);
+        virtual Collection<TermFreqVectorPtr> get(int32_t docNum);
         
-        void get(int32_t docNumber, TermVectorMapperPtr mapper);
+        virtual void get(int32_t docNumber, TermVectorMapperPtr mapper);
         
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
     
@@ -29,14 +29,16 @@ namespace Lucene
     public:
         /// Add a complete document specified by all its term vectors. If document has no term vectors, 
         /// add value for tvx.
-        void addAllDocVectors(Collection<TermFreqVectorPtr> vectors);
+        virtual void addAllDocVectors(Collection<TermFreqVectorPtr> vectors);
         
         /// Do a bulk copy of numDocs documents from reader to our streams.  This is used to expedite merging, 
-        /// if the field numbers are congruent.
-        void addRawDocuments(TermVectorsReaderPtr reader, Collection<int32_t> tvdLengths, Collection<int32_t> tvfLengths, int32_t numDocs);
+        /// if the field numbers are congruent.  If checksums are given the copied tvd and tvf bytes are added 
+        /// to them.
+        virtual void addRawDocuments(TermVectorsReaderPtr reader, Collection<int32_t> tvdLengths, Collection<int32_t> tvfLengths, int32_t numDocs, 
+                                     CRC32CPtr tvdChecksum = CRC32CPtr(), CRC32CPtr tvfChecksum = CRC32CPtr());
         
         /// Close all streams.
-        void close();
+        virtual void close();
     };
 }
 
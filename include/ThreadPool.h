@@ -7,78 +7,126 @@
 #ifndef THREADPOOL_H
 #define THREADPOOL_H
 
-#include <boost/asio.hpp>
 #include <boost/any.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/thread/condition.hpp>
 #include "LuceneObject.h"
 
 namespace Lucene
 {
-    typedef boost::shared_ptr<boost::asio::io_service::work> workPtr;
+    /// A unit of work queued on a {@link ThreadPool}.
+    typedef boost::function<void()> ThreadPoolTask;
     
-    /// A Future represents the result of an asynchronous computation. Methods are provided to check if the computation 
-    /// is complete, to wait for its completion, and to retrieve the result of the computation. The result can only be 
+    /// A Future represents the result of an asynchronous computation. Methods are provided to check if the computation
+    /// is complete, to wait for its completion, and to retrieve the result of the computation. The result can only be
     /// retrieved using method get when the computation has completed, blocking if necessary until it is ready.
-    class Future : public LuceneObject
+    ///
+    /// A thread that waits for a result whose computation hasn't started yet runs the computation itself, so tasks 
+    /// may wait for the tasks they schedule without running the pool out of workers.  Other queued tasks are left to 
+    /// the workers, so waiting never runs unrelated work such as a merge.
+    class LPPAPI Future : public LuceneObject
     {
     public:
+        Future();
         virtual ~Future();
     
     protected:
+        /// The computation, until a thread takes it to run it.
+        ThreadPoolTask task;
         boost::any value;
+        LuceneException exception;
+        bool done;
+        boost::mutex futureMutex;
+        boost::condition futureCondition;
     
     public:
-        void set(const boost::any& value)
-        {
-            SyncLock syncLock(this);
-            this->value = value;
-        }
+        void set(const boost::any& value);
+        
+        /// Completes the computation with an error, which is thrown by {@link #get}.
+        void setException(const LuceneException& exception);
+        
+        /// Returns true if the computation has completed.
+        bool isDone();
+        
+        /// Runs the computation, unless another thread already has.
+        void run();
         
         template <typename TYPE>
         TYPE get()
         {
-            SyncLock syncLock(this);
-            while (value.empty())
-                wait(10);
+            waitForCompletion();
+            exception.throwException();
             return value.empty() ? TYPE() : boost::any_cast<TYPE>(value);
         }
+    
+    protected:
+        void waitForCompletion();
+        
+        friend class ThreadPool;
     };
     
     /// Utility class to handle a pool of threads.
-    class ThreadPool : public LuceneObject
+    ///
+    /// Each worker has its own queue of tasks.  Tasks scheduled by a worker go to its own queue, others are spread
+    /// over the queues in turn.  A worker runs the newest task of its own queue first and, when that is empty, steals
+    /// the oldest task of another queue.  Idle workers block until a task is scheduled.
+    class LPPAPI ThreadPool : public LuceneObject
     {
     public:
-        ThreadPool();
+        /// Creates a pool of numThreads workers.
+        ThreadPool(int32_t numThreads = defaultNumThreads());
+        
+        /// Runs the tasks still queued and stops the workers.
         virtual ~ThreadPool();
         
         LUCENE_CLASS(ThreadPool);
     
     protected:
-        boost::asio::io_service io_service;
-        workPtr work;
-        boost::thread_group threadGroup;
+        ThreadPoolWorkersPtr workers;
         
         static const int32_t THREADPOOL_SIZE;
     
     public:
         /// Get singleton thread pool instance.
         static ThreadPoolPtr getInstance();
-    
+        
+        /// Returns the number of workers of pools created without one: the number of hardware threads, and at least
+        /// THREADPOOL_SIZE.
+        static int32_t defaultNumThreads();
+        
+        /// Returns the number of workers of this pool.
+        int32_t getNumThreads();
+        
         template <typename FUNC>
         FuturePtr scheduleTask(FUNC func)
         {
             FuturePtr future(newInstance<Future>());
-            io_service.post(boost::bind(&ThreadPool::execute<FUNC>, this, func, future));
+            future->task = boost::bind(&ThreadPool::execute<FUNC>, func, future);
+            submit(boost::bind(&Future::run, future));
             return future;
         }
     
     protected:
+        void submit(const ThreadPoolTask& task);
+        
         // this will be executed when one of the threads is available
         template <typename FUNC>
-        void execute(FUNC func, FuturePtr future)
+        static void execute(FUNC func, FuturePtr future)
         {
-            future->set(func());
-            future->notifyAll();
+            try
+            {
+                future->set(func());
+            }
+            catch (LuceneException& e)
+            {
+                future->setException(e);
+            }
+            catch (...)
+            {
+                future->setException(RuntimeException(L"Unknown error in thread pool task"));
+            }
         }
     };
 }
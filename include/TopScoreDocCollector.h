@@ -16,12 +16,16 @@ namespace Lucene
     /// descending and then (when the scores are tied) docID ascending.  When you create an instance of this 
     /// collector you should know in advance whether documents are going to be collected in doc Id order or not.
     ///
+    /// Once more hits than a given threshold have been counted, the collector {@link #needsTopScoresOnly needs 
+    /// the top scores only}: it passes the lowest score that can still enter the top hits to its scorer, which 
+    /// may then skip hits scoring less.  The total hit count is then a lower bound.
+    ///
     /// NOTE: The values Nan, NEGATIVE_INFINITY and POSITIVE_INFINITY are not valid scores.  This collector will 
     /// not properly collect hits with such scores.
     class LPPAPI TopScoreDocCollector : public TopDocsCollector
     {
     public:
-        TopScoreDocCollector(int32_t numHits);
+        TopScoreDocCollector(int32_t numHits, int32_t totalHitsThreshold = INT_MAX);
         virtual ~TopScoreDocCollector();
     
         LUCENE_CLASS(TopScoreDocCollector);
@@ -30,6 +34,12 @@ namespace Lucene
         ScoreDocPtr pqTop;
         int32_t docBase;
         ScorerWeakPtr _scorer;
+        
+        /// Number of hits to count exactly before the scorer may skip hits that can't compete.
+        int32_t totalHitsThreshold;
+        
+        /// The lowest score passed to the scorer, the score of the top of the full queue.
+        double minCompetitiveScore;
     
     public:
         /// Creates a new {@link TopScoreDocCollector} given the number of hits to collect and whether documents 
@@ -38,11 +48,21 @@ namespace Lucene
         /// NOTE: The instances returned by this method pre-allocate a full array of length numHits.
         static TopScoreDocCollectorPtr create(int32_t numHits, bool docsScoredInOrder);
         
+        /// Creates a new {@link TopScoreDocCollector} that counts up to totalHitsThreshold hits exactly.  Beyond 
+        /// that, hits that score less than the current top hits may be skipped and go uncounted.
+        static TopScoreDocCollectorPtr create(int32_t numHits, bool docsScoredInOrder, int32_t totalHitsThreshold);
+        
+        /// Returns true if a total hits threshold was given.
+        virtual bool needsTopScoresOnly();
+        
         virtual void setNextReader(IndexReaderPtr reader, int32_t docBase);
         virtual void setScorer(ScorerPtr scorer);
     
     protected:
         virtual TopDocsPtr newTopDocs(Collection<ScoreDocPtr> results, int32_t start);
+        
+        /// Passes the score of the top of the queue on to the scorer once the queue is full, past the threshold.
+        void updateMinCompetitiveScore(ScorerPtr scorer);
     };
 }
 
@@ -0,0 +1,37 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef TOTALHITCOUNTCOLLECTOR_H
+#define TOTALHITCOUNTCOLLECTOR_H
+
+#include "Collector.h"
+
+namespace Lucene
+{
+    /// A {@link Collector} implementation which just counts the hits, without scoring them.
+    class LPPAPI TotalHitCountCollector : public Collector
+    {
+    public:
+        TotalHitCountCollector();
+        virtual ~TotalHitCountCollector();
+        
+        LUCENE_CLASS(TotalHitCountCollector);
+    
+    protected:
+        int32_t totalHits;
+    
+    public:
+        /// Returns how many hits matched the search.
+        int32_t getTotalHits();
+        
+        virtual void collect(int32_t doc);
+        virtual void setNextReader(IndexReaderPtr reader, int32_t docBase);
+        virtual void setScorer(ScorerPtr scorer);
+        virtual bool acceptsDocsOutOfOrder();
+    };
+}
+
+#endif
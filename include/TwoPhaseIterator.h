@@ -0,0 +1,50 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef TWOPHASEITERATOR_H
+#define TWOPHASEITERATOR_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Splits the iteration of a {@link Scorer} in two phases: an approximation that cheaply iterates over a
+    /// superset of the matching docs, and {@link #matches} that tells whether the current doc of the approximation
+    /// actually matches, which may be costly (eg. reading positions).  Scorers that intersect others move all
+    /// approximations to a common doc before confirming any of them, so the costly check only runs on docs that
+    /// pass every other clause.
+    ///
+    /// The approximation moves the scorer it was returned by: the docID of the scorer is that of the
+    /// approximation, and the scorer may be scored on that doc once {@link #matches} returned true.
+    /// @see Scorer#twoPhaseIterator()
+    class LPPAPI TwoPhaseIterator : public LuceneObject
+    {
+    public:
+        TwoPhaseIterator(DocIdSetIteratorPtr approximation);
+        virtual ~TwoPhaseIterator();
+        
+        LUCENE_CLASS(TwoPhaseIterator);
+    
+    protected:
+        DocIdSetIteratorPtr _approximation;
+    
+    public:
+        /// Returns the approximation of the matching docs.
+        DocIdSetIteratorPtr approximation();
+        
+        /// Returns whether the current doc of the approximation matches.  Called at most once per doc, and only
+        /// while the approximation is on a doc.
+        virtual bool matches() = 0;
+        
+        /// Returns an iterator over the docs of the approximation of twoPhase that match.
+        static DocIdSetIteratorPtr asDocIdSetIterator(TwoPhaseIteratorPtr twoPhase);
+        
+        /// Returns the approximation of scorer if it can iterate in two phases, and scorer itself otherwise.
+        static DocIdSetIteratorPtr approximationOf(ScorerPtr scorer);
+    };
+}
+
+#endif
@@ -68,6 +68,13 @@ namespace Lucene
         /// @return a {@link Scorer} which scores documents in/out-of order.
         virtual ScorerPtr scorer(IndexReaderPtr reader, bool scoreDocsInOrder, bool topScorer) = 0;
         
+        /// Returns a top {@link Scorer} for a collector that {@link Collector#needsTopScoresOnly needs the top 
+        /// scores only}.  The scorer doesn't have to match the docs that score less than the lowest score set with
+        /// {@link Scorer#setMinCompetitiveScore}.
+        ///
+        /// NOTE: the default implementation returns {@link #scorer(IndexReaderPtr, bool, bool)} as a top scorer.
+        virtual ScorerPtr topScoresScorer(IndexReaderPtr reader, bool scoreDocsInOrder);
+        
         /// The sum of squared weights of contained query clauses.
         virtual double sumOfSquaredWeights() = 0;
         
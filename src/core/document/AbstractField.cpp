@@ -26,6 +26,9 @@ namespace Lucene
         
         this->lazy = false;
         this->omitTermFreqAndPositions = false;
+        this->docValuesType = DOC_VALUES_NONE;
+        this->reducedPrecisionNorms = false;
+        this->bloomFiltered = false;
         this->boost = 1.0;
         this->fieldsData = VariantUtils::null();
         
@@ -44,6 +47,9 @@ namespace Lucene
         
         this->lazy = false;
         this->omitTermFreqAndPositions = false;
+        this->docValuesType = DOC_VALUES_NONE;
+        this->reducedPrecisionNorms = false;
+        this->bloomFiltered = false;
         this->boost = 1.0;
         this->fieldsData = VariantUtils::null();
         
@@ -157,6 +163,36 @@ namespace Lucene
         this->omitTermFreqAndPositions = omitTermFreqAndPositions;
     }
     
+    Fieldable::DocValuesType AbstractField::getDocValuesType()
+    {
+        return docValuesType;
+    }
+    
+    void AbstractField::setDocValuesType(DocValuesType docValuesType)
+    {
+        this->docValuesType = docValuesType;
+    }
+    
+    bool AbstractField::getReducedPrecisionNorms()
+    {
+        return reducedPrecisionNorms;
+    }
+    
+    void AbstractField::setReducedPrecisionNorms(bool reducedPrecisionNorms)
+    {
+        this->reducedPrecisionNorms = reducedPrecisionNorms;
+    }
+    
+    bool AbstractField::isBloomFiltered()
+    {
+        return bloomFiltered;
+    }
+    
+    void AbstractField::setBloomFiltered(bool bloomFiltered)
+    {
+        this->bloomFiltered = bloomFiltered;
+    }
+    
     bool AbstractField::isLazy()
     {
         return lazy;
@@ -207,6 +243,12 @@ namespace Lucene
             result << L",omitNorms";
         if (omitTermFreqAndPositions)
             result << L",omitTermFreqAndPositions";
+        if (docValuesType != DOC_VALUES_NONE)
+            result << L",docValues";
+        if (reducedPrecisionNorms)
+            result << L",reducedPrecisionNorms";
+        if (bloomFiltered)
+            result << L",bloomFiltered";
         if (lazy)
             result << L",lazy";
         result << L"<" << _name << L":";
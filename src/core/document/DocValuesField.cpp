@@ -0,0 +1,66 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesField.h"
+#include "Field.h"
+#include "StringUtils.h"
+#include "VariantUtils.h"
+
+namespace Lucene
+{
+    DocValuesField::DocValuesField(const String& name, const String& value, DocValuesType docValuesType) 
+        : AbstractField(name, Field::STORE_NO, Field::INDEX_NO, Field::TERM_VECTOR_NO)
+    {
+        if (docValuesType == DOC_VALUES_NONE)
+            boost::throw_exception(IllegalArgumentException(L"a doc values field must have a doc values type"));
+        this->docValuesType = docValuesType;
+        this->fieldsData = value;
+    }
+    
+    DocValuesField::DocValuesField(const String& name, ByteArray value)
+        : AbstractField(name, Field::STORE_NO, Field::INDEX_NO, Field::TERM_VECTOR_NO)
+    {
+        this->docValuesType = DOC_VALUES_BINARY;
+        setValue(value);
+    }
+    
+    DocValuesField::~DocValuesField()
+    {
+    }
+    
+    String DocValuesField::stringValue()
+    {
+        return _isBinary ? L"" : VariantUtils::get<String>(fieldsData);
+    }
+    
+    ReaderPtr DocValuesField::readerValue()
+    {
+        return ReaderPtr();
+    }
+    
+    TokenStreamPtr DocValuesField::tokenStreamValue()
+    {
+        return TokenStreamPtr();
+    }
+    
+    void DocValuesField::setValue(const String& value)
+    {
+        if (_isBinary)
+            boost::throw_exception(IllegalArgumentException(L"cannot set a String value on a binary field"));
+        fieldsData = value;
+    }
+    
+    void DocValuesField::setValue(ByteArray value)
+    {
+        if (!_isBinary && !VariantUtils::isNull(fieldsData))
+            boost::throw_exception(IllegalArgumentException(L"cannot set a byte[] value on a non-binary field"));
+        _isBinary = true;
+        fieldsData = value;
+        binaryLength = value.size();
+        binaryOffset = 0;
+    }
+}
@@ -10,6 +10,7 @@
 #include "NumericUtils.h"
 #include "NumericTokenStream.h"
 #include "StringUtils.h"
+#include "VariantUtils.h"
 
 namespace Lucene
 {
@@ -72,6 +73,22 @@ namespace Lucene
         return StringUtils::toLong(stringValue());
     }
     
+    bool NumericField::isDoubleValue()
+    {
+        return VariantUtils::typeOf<double>(fieldsData);
+    }
+    
+    double NumericField::getDoubleValue()
+    {
+        if (VariantUtils::typeOf<double>(fieldsData))
+            return VariantUtils::get<double>(fieldsData);
+        if (VariantUtils::typeOf<int64_t>(fieldsData))
+            return (double)VariantUtils::get<int64_t>(fieldsData);
+        if (VariantUtils::typeOf<int32_t>(fieldsData))
+            return (double)VariantUtils::get<int32_t>(fieldsData);
+        return 0.0;
+    }
+    
     NumericFieldPtr NumericField::setLongValue(int64_t value)
     {
         tokenStream->setLongValue(value);
@@ -0,0 +1,105 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ARENARAMDIRECTORY_H
+#define _ARENARAMDIRECTORY_H
+
+#include "IndexInput.h"
+#include "IndexOutput.h"
+
+namespace Lucene
+{
+    /// A file in an {@link ArenaRAMDirectory}.  Once sealed, none of its fields change.  Every block but the 
+    /// last holds exactly one slab of data; the last block may start part way through a shared slab.
+    class ArenaFile : public LuceneObject
+    {
+    public:
+        ArenaFile(int64_t lastModified);
+        virtual ~ArenaFile();
+        
+        LUCENE_CLASS(ArenaFile);
+    
+    public:
+        Collection<ByteArray> blocks;
+        Collection<int32_t> blockOffsets;
+        int64_t length;
+        int64_t lastModified;
+        bool sealed;
+    
+    public:
+        /// Returns a sealed copy of this file, sharing its data, with a new modified time.
+        ArenaFilePtr touch(int64_t lastModified);
+    };
+    
+    class ArenaIndexInput : public IndexInput
+    {
+    public:
+        ArenaIndexInput(ArenaFilePtr file = ArenaFilePtr(), int32_t blockSizePower = 0);
+        virtual ~ArenaIndexInput();
+        
+        LUCENE_CLASS(ArenaIndexInput);
+    
+    protected:
+        ArenaFilePtr file;
+        int64_t _length;
+        int32_t blockSizePower;
+        int32_t curBlockIndex;
+        ByteArray curBlock;
+        int32_t curBlockOffset;
+        int32_t curBlockLength;
+        int32_t curBlockPosition;
+    
+    public:
+        virtual uint8_t readByte();
+        virtual void readBytes(uint8_t* b, int32_t offset, int32_t length);
+        virtual int64_t getFilePointer();
+        virtual void seek(int64_t pos);
+        virtual int64_t length();
+        virtual void close();
+        virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
+    
+    protected:
+        void setBlock(int32_t blockIndex);
+        void nextBlock();
+    };
+    
+    class ArenaIndexOutput : public IndexOutput
+    {
+    public:
+        ArenaIndexOutput(ArenaRAMDirectoryPtr directory, RAMArenaPtr arena, ArenaFilePtr file);
+        virtual ~ArenaIndexOutput();
+        
+        LUCENE_CLASS(ArenaIndexOutput);
+    
+    protected:
+        ArenaRAMDirectoryWeakPtr _directory;
+        RAMArenaPtr arena;
+        ArenaFilePtr file;
+        Collection<ByteArray> slabs;
+        int32_t slabSize;
+        int32_t slabSizePower;
+        int32_t curSlabIndex;
+        ByteArray curSlab;
+        int32_t curSlabPosition;
+        int64_t _length;
+        bool isOpen;
+    
+    public:
+        virtual void writeByte(uint8_t b);
+        virtual void writeBytes(const uint8_t* b, int32_t offset, int32_t length);
+        virtual void flush();
+        virtual void close();
+        virtual int64_t getFilePointer();
+        virtual void seek(int64_t pos);
+        virtual int64_t length();
+    
+    protected:
+        void nextSlab();
+        void setFileLength();
+    };
+}
+
+#endif
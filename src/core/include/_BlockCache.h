@@ -0,0 +1,51 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _BLOCKCACHE_H
+#define _BLOCKCACHE_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// One independently locked slice of a {@link BlockCache}.
+    class BlockCacheShard : public LuceneObject
+    {
+    public:
+        BlockCacheShard(int32_t maxPages);
+        virtual ~BlockCacheShard();
+        
+        LUCENE_CLASS(BlockCacheShard);
+    
+    protected:
+        int32_t maxPages;
+        MapLongInt slotIndex; // page key -> slot
+        Collection<int64_t> slotKeys;
+        Collection<ByteArray> slotPages;
+        Collection<uint8_t> slotReferenced;
+        int32_t clockHand;
+        int64_t hitCount;
+        int64_t missCount;
+        int64_t evictionCount;
+    
+    public:
+        ByteArray get(int64_t key);
+        void put(int64_t key, ByteArray bytes);
+        void remove(int64_t key);
+        void clear();
+        int32_t size();
+        int32_t getMaxPages();
+        int64_t getHitCount();
+        int64_t getMissCount();
+        int64_t getEvictionCount();
+    
+    protected:
+        /// Advance the clock hand until a slot without its reference bit is found, clearing bits on the way.
+        int32_t findVictim();
+    };
+}
+
+#endif
@@ -0,0 +1,87 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _BLOCKCACHEDIRECTORY_H
+#define _BLOCKCACHEDIRECTORY_H
+
+#include "Directory.h"
+#include "IndexInput.h"
+
+namespace Lucene
+{
+    /// The view of a {@link BlockCacheDirectory} that merges read through, see {@link 
+    /// BlockCacheDirectory#getMergeReadDirectory}.  Everything but reads is passed to the directory.
+    class BlockCacheMergeDirectory : public Directory
+    {
+    public:
+        BlockCacheMergeDirectory(BlockCacheDirectoryPtr dir);
+        virtual ~BlockCacheMergeDirectory();
+        
+        LUCENE_CLASS(BlockCacheMergeDirectory);
+    
+    protected:
+        BlockCacheDirectoryPtr dir;
+    
+    public:
+        virtual HashSet<String> listAll();
+        virtual bool fileExists(const String& name);
+        virtual uint64_t fileModified(const String& name);
+        virtual void touchFile(const String& name);
+        virtual void deleteFile(const String& name);
+        virtual int64_t fileLength(const String& name);
+        virtual IndexOutputPtr createOutput(const String& name);
+        virtual void sync(const String& name);
+        virtual IndexInputPtr openInput(const String& name);
+        virtual IndexInputPtr openInput(const String& name, int32_t bufferSize);
+        virtual DirectoryPtr getMergeReadDirectory();
+        virtual String getLockID();
+        virtual void close();
+        virtual String toString();
+    };
+    
+    /// An IndexInput that reads whole pages through a {@link BlockCache}, falling back to the wrapped input 
+    /// on a miss.
+    class BlockCacheIndexInput : public IndexInput
+    {
+    public:
+        BlockCacheIndexInput(IndexInputPtr input, BlockCachePtr cache, int64_t fileId, bool admit);
+        virtual ~BlockCacheIndexInput();
+        
+        LUCENE_CLASS(BlockCacheIndexInput);
+    
+    protected:
+        IndexInputPtr input;
+        BlockCachePtr cache;
+        int64_t fileId;
+        bool admit; // add pages read on a miss to the cache
+        bool isClone;
+        int64_t _length;
+        int32_t pageSizePower;
+        
+        ByteArray currentPage;
+        int64_t currentPageIndex;
+        int32_t currentPageLength;
+        int32_t currentPagePosition; // next byte to read within current page
+    
+    public:
+        virtual uint8_t readByte();
+        virtual void readBytes(uint8_t* b, int32_t offset, int32_t length);
+        virtual int64_t getFilePointer();
+        virtual void seek(int64_t pos);
+        virtual int64_t length();
+        virtual void close();
+        virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
+    
+    protected:
+        /// Move on to the next page with unread bytes, loading the current page first if a seek unloaded it.
+        void nextPage();
+        
+        /// Make the given page current, reading it from the wrapped input if it isn't cached.
+        void loadPage(int64_t pageIndex);
+    };
+}
+
+#endif
@@ -34,6 +34,7 @@ namespace Lucene
         virtual void normalize(double norm);
         virtual ExplanationPtr explain(IndexReaderPtr reader, int32_t doc);
         virtual ScorerPtr scorer(IndexReaderPtr reader, bool scoreDocsInOrder, bool topScorer);
+        virtual ScorerPtr topScoresScorer(IndexReaderPtr reader, bool scoreDocsInOrder);
         virtual bool scoresDocsOutOfOrder();
     };
     
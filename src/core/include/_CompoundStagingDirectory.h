@@ -0,0 +1,48 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _COMPOUNDSTAGINGDIRECTORY_H
+#define _COMPOUNDSTAGINGDIRECTORY_H
+
+#include "IndexOutput.h"
+
+namespace Lucene
+{
+    /// Writes a staged file into RAM until the staging directory is full, then spills it to the delegate.  
+    /// Whether the directory is full is only checked once per RAM buffer written, so it may go over its 
+    /// limit by up to a buffer for each staged file.
+    class StagingIndexOutput : public IndexOutput
+    {
+    public:
+        StagingIndexOutput(CompoundStagingDirectoryPtr directory, const String& name, IndexOutputPtr output);
+        virtual ~StagingIndexOutput();
+        
+        LUCENE_CLASS(StagingIndexOutput);
+    
+    protected:
+        CompoundStagingDirectoryWeakPtr _directory;
+        String name;
+        IndexOutputPtr output;
+        bool spilled;
+        
+        /// Bytes written since the directory was last checked.
+        int32_t unchecked;
+    
+    public:
+        virtual void writeByte(uint8_t b);
+        virtual void writeBytes(const uint8_t* b, int32_t offset, int32_t length);
+        virtual void flush();
+        virtual void close();
+        virtual int64_t getFilePointer();
+        virtual void seek(int64_t pos);
+        virtual int64_t length();
+    
+    protected:
+        void checkSpill();
+    };
+}
+
+#endif
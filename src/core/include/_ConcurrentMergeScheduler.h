@@ -29,7 +29,15 @@ namespace Lucene
         void setRunningMerge(OneMergePtr merge);
         OneMergePtr getRunningMerge();
         void setThreadPriority(int32_t pri);
+        
+        /// Runs the merge as a task of executor instead of starting the thread.
+        void schedule(ThreadPoolPtr executor);
+        
+        virtual bool isAlive();
         virtual void run();
+    
+    protected:
+        bool runTask();
     };
 }
 
@@ -0,0 +1,33 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _DIRECTORYWARMER_H
+#define _DIRECTORYWARMER_H
+
+#include "DirectoryWarmer.h"
+#include "LuceneThread.h"
+
+namespace Lucene
+{
+    class WarmerThread : public LuceneThread
+    {
+    public:
+        WarmerThread(DirectoryWarmerPtr warmer, FSDirectoryPtr directory, Collection<DirectoryWarmer::WarmRange> ranges);
+        virtual ~WarmerThread();
+    
+        LUCENE_CLASS(WarmerThread);
+    
+    protected:
+        DirectoryWarmerWeakPtr _warmer;
+        FSDirectoryPtr directory;
+        Collection<DirectoryWarmer::WarmRange> ranges;
+    
+    public:
+        virtual void run();
+    };
+}
+
+#endif
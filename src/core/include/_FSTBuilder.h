@@ -0,0 +1,44 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _FSTBUILDER_H
+#define _FSTBUILDER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// A node that may still gain arcs.  Targets of all but the last arc are addresses of compiled nodes; the
+    /// target of the last arc is the next node of the builder's frontier until it is compiled.
+    class FSTBuilderNode : public LuceneObject
+    {
+    public:
+        FSTBuilderNode();
+        virtual ~FSTBuilderNode();
+        
+        LUCENE_CLASS(FSTBuilderNode);
+    
+    public:
+        Collection<int32_t> labels;
+        Collection<int64_t> outputs;
+        Collection<int32_t> targets;
+        bool isFinal;
+        int64_t finalOutput;
+    
+    public:
+        int32_t numArcs();
+        void clear();
+        void addArc(int32_t label);
+        int64_t getLastOutput();
+        void setLastOutput(int64_t output);
+        void setLastTarget(int32_t target);
+        
+        /// Adds to the output of every arc and to the final output, to move part of a shared output below this node.
+        void prependOutput(int64_t output);
+    };
+}
+
+#endif
@@ -37,6 +37,8 @@ namespace Lucene
         friend class FilteredQueryWeightScorer;
     };
     
+    /// Intersects the filter with the approximation of the scorer, so that a scorer that iterates in two
+    /// phases is only confirmed on docs the filter accepts.
     class FilteredQueryWeightScorer : public Scorer
     {
     public:
@@ -49,16 +51,23 @@ namespace Lucene
         FilteredQueryWeightPtr weight;
         ScorerPtr scorer;
         DocIdSetIteratorPtr docIdSetIterator;
-        int32_t doc;
+        
+        /// The docs of the filter and the approximation of the scorer have in common.
+        DocIdSetIteratorPtr approximation;
+        
+        /// Confirms the scorer on the docs of the approximation, null if it needs no confirmation.
+        TwoPhaseIteratorPtr twoPhase;
     
     public:
         virtual int32_t nextDoc();
         virtual int32_t docID();
         virtual int32_t advance(int32_t target);
         virtual double score();
+        virtual TwoPhaseIteratorPtr twoPhaseIterator();
     
     protected:
-        int32_t advanceToCommon(int32_t scorerDoc, int32_t disiDoc);
+        /// Moves the approximation from doc on to the first doc that the scorer matches.
+        int32_t toMatch(int32_t doc);
     };
 }
 
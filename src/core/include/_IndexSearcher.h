@@ -0,0 +1,38 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _INDEXSEARCHER_H
+#define _INDEXSEARCHER_H
+
+#include "LuceneObject.h"
+
+namespace Lucene
+{
+    /// Searches the subreaders of one slice with the collector of that slice.
+    class IndexSearcherSliceCallable : public LuceneObject
+    {
+    public:
+        IndexSearcherSliceCallable(IndexSearcherPtr searcher, Collection<int32_t> leaves, WeightPtr weight, FilterPtr filter, CollectorPtr collector);
+        virtual ~IndexSearcherSliceCallable();
+        
+        LUCENE_CLASS(IndexSearcherSliceCallable);
+    
+    protected:
+        IndexSearcherPtr searcher;
+        Collection<int32_t> leaves;
+        WeightPtr weight;
+        FilterPtr filter;
+        CollectorPtr collector;
+    
+    public:
+        /// The exception thrown by the search, if any.
+        LuceneException error;
+        
+        int32_t call();
+    };
+}
+
+#endif
@@ -56,8 +56,9 @@ namespace Lucene
         SegmentReaderPtr get(SegmentInfoPtr info, bool doOpenStores);
         
         /// Obtain a SegmentReader from the readerPool.  The reader must be returned by calling 
-        /// {@link #release(SegmentReader)}
-        SegmentReaderPtr get(SegmentInfoPtr info, bool doOpenStores, int32_t readBufferSize, int32_t termsIndexDivisor);
+        /// {@link #release(SegmentReader)}.  A reader opened for a merge reads through the directory's 
+        /// {@link Directory#getMergeReadDirectory}, unless readers are pooled.
+        SegmentReaderPtr get(SegmentInfoPtr info, bool doOpenStores, int32_t readBufferSize, int32_t termsIndexDivisor, bool forMerge = false);
         
         /// Returns a ref
         SegmentReaderPtr getIfExists(SegmentInfoPtr info);
@@ -9,22 +9,37 @@
 
 #include <boost/iostreams/device/mapped_file.hpp>
 #include "IndexInput.h"
+#include "FSDirectory.h"
 
 namespace Lucene
 {
     class MMapIndexInput : public IndexInput
     {
     public:
-        MMapIndexInput(const String& path = L"");
+        MMapIndexInput(const String& path = L"", int32_t chunkSizePower = 0);
         virtual ~MMapIndexInput();
         
         LUCENE_CLASS(MMapIndexInput);
-                
+    
     protected:
-        int32_t _length;
+        typedef boost::iostreams::mapped_file_source MappedChunk;
+        
+        int64_t _length;
         bool isClone;
-        boost::iostreams::mapped_file_source file;
-        int32_t bufferPosition; // next byte to read
+        
+        /// Position in the file of byte 0 of this input; non-zero for a slice.
+        int64_t sliceOffset;
+        
+        /// Mapped regions of the file, each (except the last) exactly 2^chunkSizePower bytes long.
+        /// Shared between clones.
+        Collection<MappedChunk> chunks;
+        int32_t chunkSizePower;
+        int64_t chunkSizeMask;
+        
+        int32_t curChunkIndex;
+        const uint8_t* curChunk;
+        int32_t curChunkLength;
+        int32_t curChunkPosition; // next byte to read within current chunk
     
     public:
         /// Reads and returns a single byte.
@@ -38,6 +53,14 @@ namespace Lucene
         /// @see IndexOutput#writeBytes(const uint8_t*,int)
         virtual void readBytes(uint8_t* b, int32_t offset, int32_t length);
         
+        /// Reads an int stored in variable-length format, decoding directly from the mapped chunk.
+        /// @see IndexOutput#writeVInt(int32_t)
+        virtual int32_t readVInt();
+        
+        /// Reads a int64 stored in variable-length format, decoding directly from the mapped chunk.
+        /// @see IndexOutput#writeVLong(int64_t)
+        virtual int64_t readVLong();
+        
         /// Returns the current position in this file, where the next read will occur.
         /// @see #seek(int64_t)
         virtual int64_t getFilePointer();
@@ -54,6 +77,21 @@ namespace Lucene
         
         /// Returns a clone of this stream.
         virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
+        
+        /// Returns a clone of this stream restricted to a range of the mapped file.
+        virtual IndexInputPtr slice(int64_t offset, int64_t length);
+        
+        /// Returns the bytes in place if they lie within one mapped chunk, otherwise null.
+        virtual const uint8_t* mappedBytes(int64_t pos, int64_t length);
+        
+        /// Brings a range of the mapped file into memory.  Locked pages stay resident until this input is closed.
+        /// @see FSDirectory#warmFile
+        void warm(int64_t offset, int64_t length, FSDirectory::WarmMode mode);
+    
+    protected:
+        void setChunk(int32_t index);
+        void nextChunk();
+        void warmRange(const uint8_t* start, int64_t length, FSDirectory::WarmMode mode);
     };
 }
 
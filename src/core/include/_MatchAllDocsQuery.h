@@ -39,7 +39,7 @@ namespace Lucene
     class MatchAllScorer : public Scorer
     {
     public:
-        MatchAllScorer(MatchAllDocsQueryPtr query, IndexReaderPtr reader, SimilarityPtr similarity, WeightPtr weight, ByteArray norms);
+        MatchAllScorer(MatchAllDocsQueryPtr query, IndexReaderPtr reader, SimilarityPtr similarity, WeightPtr weight, NormValuesPtr norms);
         virtual ~MatchAllScorer();
     
         LUCENE_CLASS(MatchAllScorer);
@@ -47,7 +47,7 @@ namespace Lucene
     public:
         TermDocsPtr termDocs;
         double _score;
-        ByteArray norms;
+        NormValuesPtr norms;
     
     protected:
         MatchAllDocsQueryPtr query;
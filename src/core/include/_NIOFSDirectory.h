@@ -0,0 +1,174 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _NIOFSDIRECTORY_H
+#define _NIOFSDIRECTORY_H
+
+#include "BufferedIndexInput.h"
+#include "ReadBatch.h"
+
+namespace Lucene
+{
+    /// A read-only file handle supporting reads at an absolute position.  Reads never change any shared state, 
+    /// so a single handle can be used concurrently by any number of threads.
+    class PositionalInputFile : public LuceneObject
+    {
+    public:
+        PositionalInputFile(const String& path);
+        virtual ~PositionalInputFile();
+        
+        LUCENE_CLASS(PositionalInputFile);
+    
+    public:
+        static const int32_t FILE_EOF;
+    
+    protected:
+        #if defined(_WIN32) || defined(_WIN64)
+        void* handle;
+        #else
+        int32_t fd;
+        #endif
+        int64_t length;
+    
+    public:
+        int64_t getLength();
+        
+        /// Read up to length bytes starting at the given file position.
+        /// @return the number of bytes read or {@link #FILE_EOF}.
+        int32_t read(uint8_t* b, int32_t offset, int32_t length, int64_t position);
+        
+        /// Read exactly length bytes starting at the given file position.
+        /// @throws IOException if the file ends before length bytes have been read.
+        void readFully(uint8_t* b, int32_t offset, int32_t length, int64_t position);
+        
+        #if !defined(_WIN32) && !defined(_WIN64)
+        /// Returns the underlying file descriptor.
+        int32_t getDescriptor();
+        #endif
+        
+        void close();
+        bool isValid();
+    };
+    
+    class NIOFSIndexInput : public BufferedIndexInput
+    {
+    public:
+        NIOFSIndexInput();
+        NIOFSIndexInput(const String& path, int32_t bufferSize, int32_t chunkSize);
+        virtual ~NIOFSIndexInput();
+        
+        LUCENE_CLASS(NIOFSIndexInput);
+    
+    protected:
+        PositionalInputFilePtr file;
+        bool isClone;
+        int32_t chunkSize;
+        
+        /// Start and end of this input within the file; a slice covers less than the whole file.
+        int64_t off;
+        int64_t end;
+    
+    protected:
+        virtual void readInternal(uint8_t* b, int32_t offset, int32_t length);
+        virtual void seekInternal(int64_t pos);
+    
+    public:
+        virtual int64_t length();
+        virtual void close();
+        
+        /// Returns a clone of this stream bounded to the given range of the file.
+        virtual IndexInputPtr slice(int64_t offset, int64_t length);
+        
+        /// Method used for testing.
+        bool isValid();
+        
+        /// Submit a batch of reads, using io_uring where available and the shared thread pool otherwise.
+        virtual void submitReads(ReadBatchPtr batch);
+        
+        /// Returns a clone of this stream.
+        virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
+    };
+    
+    /// Services a {@link ReadBatch} by issuing each read as a task on the shared {@link ThreadPool}.
+    class ThreadPoolReadCompletion : public ReadCompletion
+    {
+    public:
+        ThreadPoolReadCompletion(PositionalInputFilePtr file, ReadBatchPtr batch, int64_t offset);
+        virtual ~ThreadPoolReadCompletion();
+        
+        LUCENE_CLASS(ThreadPoolReadCompletion);
+    
+    protected:
+        Collection<FuturePtr> reads;
+    
+    public:
+        virtual void waitForCompletion();
+    
+    protected:
+        static bool read(PositionalInputFilePtr file, ByteArray bytes, int64_t position);
+    };
+    
+    #ifdef LPP_HAVE_IO_URING
+    /// Services a {@link ReadBatch} through a private io_uring submission/completion queue pair, keeping up to 
+    /// one queue's worth of reads in flight in the kernel at once.
+    class IOUringReadCompletion : public ReadCompletion
+    {
+    public:
+        IOUringReadCompletion(PositionalInputFilePtr file, ReadBatchPtr batch, int64_t offset);
+        virtual ~IOUringReadCompletion();
+        
+        LUCENE_CLASS(IOUringReadCompletion);
+    
+    protected:
+        PositionalInputFilePtr file;
+        Collection<int64_t> positions;
+        Collection<ByteArray> buffers;
+        int32_t submitted;
+        int32_t completed;
+        bool failed;
+        
+        int32_t ringFd;
+        uint32_t entries;
+        void* sqRing;
+        size_t sqRingSize;
+        void* cqRing;
+        size_t cqRingSize;
+        void* sqes;
+        size_t sqesSize;
+        
+        uint32_t* sqHead;
+        uint32_t* sqTail;
+        uint32_t* sqMask;
+        uint32_t* sqArray;
+        uint32_t* cqHead;
+        uint32_t* cqTail;
+        uint32_t* cqMask;
+        void* cqes;
+    
+    public:
+        /// Set up the ring and submit the first reads.
+        /// @return false if io_uring is not available, in which case nothing was submitted.
+        bool submit();
+        
+        virtual void waitForCompletion();
+    
+    protected:
+        bool setupRing();
+        void closeRing();
+        
+        /// Queue as many outstanding reads as there are free submission slots and hand them to the kernel, 
+        /// optionally waiting for at least one completion.
+        bool submitPending(bool wait);
+        
+        /// Process all available completions.
+        void reapCompletions();
+        
+        void complete(int32_t index, int32_t result);
+    };
+    #endif
+}
+
+#endif
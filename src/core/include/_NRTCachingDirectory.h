@@ -0,0 +1,35 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _NRTCACHINGDIRECTORY_H
+#define _NRTCACHINGDIRECTORY_H
+
+#include "ConcurrentMergeScheduler.h"
+
+namespace Lucene
+{
+    /// A {@link ConcurrentMergeScheduler} that records which merge each merge thread is running.
+    class NRTCachingMergeScheduler : public ConcurrentMergeScheduler
+    {
+    public:
+        NRTCachingMergeScheduler();
+        virtual ~NRTCachingMergeScheduler();
+        
+        LUCENE_CLASS(NRTCachingMergeScheduler);
+    
+    protected:
+        HashMap<int64_t, OneMergePtr> merges;
+    
+    public:
+        /// Returns the merge run by the calling thread, or null if it isn't a merge thread.
+        OneMergePtr getCurrentMerge();
+    
+    protected:
+        virtual void doMerge(OneMergePtr merge);
+    };
+}
+
+#endif
@@ -0,0 +1,82 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _NORMVALUES_H
+#define _NORMVALUES_H
+
+#include "NormValues.h"
+
+namespace Lucene
+{
+    /// One byte per document, either in a heap array or in place in a memory mapped input.
+    class DenseNormValues : public NormValues
+    {
+    public:
+        DenseNormValues(ByteArray bytes);
+        DenseNormValues(const uint8_t* mapped, int32_t length, IndexInputPtr input);
+        virtual ~DenseNormValues();
+        
+        LUCENE_CLASS(DenseNormValues);
+    
+    protected:
+        ByteArray bytes;
+        const uint8_t* data;
+        int32_t length;
+        
+        /// The input the mapped bytes belong to.
+        IndexInputPtr input;
+    
+    public:
+        virtual uint8_t get(int32_t doc);
+        virtual void copyTo(uint8_t* bytes, int32_t offset, int32_t length);
+        virtual int64_t sizeInBytes();
+    };
+    
+    /// The norms of the documents whose norm differs from the most common one, found by binary search.
+    class SparseNormValues : public NormValues
+    {
+    public:
+        SparseNormValues(uint8_t commonNorm, IntArray docs, ByteArray norms);
+        virtual ~SparseNormValues();
+        
+        LUCENE_CLASS(SparseNormValues);
+    
+    protected:
+        uint8_t commonNorm;
+        IntArray docs;
+        ByteArray norms;
+    
+    public:
+        virtual uint8_t get(int32_t doc);
+        virtual void copyTo(uint8_t* bytes, int32_t offset, int32_t length);
+        virtual int64_t sizeInBytes();
+    };
+    
+    /// Four bit indexes into a table of at most 16 norms, two documents per byte.
+    class PackedNormValues : public NormValues
+    {
+    public:
+        PackedNormValues(ByteArray table, ByteArray packed);
+        PackedNormValues(ByteArray table, const uint8_t* mapped, IndexInputPtr input);
+        virtual ~PackedNormValues();
+        
+        LUCENE_CLASS(PackedNormValues);
+    
+    protected:
+        ByteArray table;
+        ByteArray packed;
+        const uint8_t* data;
+        
+        /// The input the mapped bytes belong to.
+        IndexInputPtr input;
+    
+    public:
+        virtual uint8_t get(int32_t doc);
+        virtual int64_t sizeInBytes();
+    };
+}
+
+#endif
@@ -0,0 +1,38 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _NUMERICDOCVALUESSOURCE_H
+#define _NUMERICDOCVALUESSOURCE_H
+
+#include "DocValues.h"
+
+namespace Lucene
+{
+    class LPPAPI NumericDocValuesSourceValues : public DocValues
+    {
+    public:
+        NumericDocValuesSourceValues(NumericDocValuesSourcePtr source, NumericDocValuesPtr values, int32_t maxDoc);
+        virtual ~NumericDocValuesSourceValues();
+        
+        LUCENE_CLASS(NumericDocValuesSourceValues);
+    
+    protected:
+        NumericDocValuesSourceWeakPtr _source;
+        NumericDocValuesPtr values;
+        int32_t maxDoc;
+    
+    public:
+        virtual double doubleVal(int32_t doc);
+        virtual int32_t intVal(int32_t doc);
+        virtual int64_t longVal(int32_t doc);
+        virtual String toString(int32_t doc);
+    
+    protected:
+        void checkDoc(int32_t doc);
+    };
+}
+
+#endif
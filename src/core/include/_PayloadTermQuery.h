@@ -27,7 +27,7 @@ namespace Lucene
     class PayloadTermSpanScorer : public SpanScorer
     {
     public:
-        PayloadTermSpanScorer(TermSpansPtr spans, WeightPtr weight, SimilarityPtr similarity, ByteArray norms);
+        PayloadTermSpanScorer(TermSpansPtr spans, WeightPtr weight, SimilarityPtr similarity, NormValuesPtr norms);
         virtual ~PayloadTermSpanScorer();
         
         LUCENE_CLASS(PayloadTermSpanScorer);
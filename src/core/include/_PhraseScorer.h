@@ -0,0 +1,50 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _PHRASESCORER_H
+#define _PHRASESCORER_H
+
+#include "TwoPhaseIterator.h"
+#include "DocIdSetIterator.h"
+
+namespace Lucene
+{
+    /// Moves a {@link PhraseScorer} over the docs containing all of its terms.
+    class PhraseScorerApproximation : public DocIdSetIterator
+    {
+    public:
+        PhraseScorerApproximation(PhraseScorerPtr scorer);
+        virtual ~PhraseScorerApproximation();
+        
+        LUCENE_CLASS(PhraseScorerApproximation);
+    
+    protected:
+        PhraseScorerPtr scorer;
+    
+    public:
+        virtual int32_t docID();
+        virtual int32_t nextDoc();
+        virtual int32_t advance(int32_t target);
+    };
+    
+    /// Checks the phrase of a {@link PhraseScorer} on the docs of its approximation.
+    class PhraseScorerTwoPhaseIterator : public TwoPhaseIterator
+    {
+    public:
+        PhraseScorerTwoPhaseIterator(PhraseScorerPtr scorer);
+        virtual ~PhraseScorerTwoPhaseIterator();
+        
+        LUCENE_CLASS(PhraseScorerTwoPhaseIterator);
+    
+    protected:
+        PhraseScorerPtr scorer;
+    
+    public:
+        virtual bool matches();
+    };
+}
+
+#endif
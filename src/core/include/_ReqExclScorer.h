@@ -0,0 +1,32 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _REQEXCLSCORER_H
+#define _REQEXCLSCORER_H
+
+#include "TwoPhaseIterator.h"
+
+namespace Lucene
+{
+    /// Checks the exclusion and the required scorer of a {@link ReqExclScorer} on the docs of the required
+    /// approximation.
+    class ReqExclScorerTwoPhaseIterator : public TwoPhaseIterator
+    {
+    public:
+        ReqExclScorerTwoPhaseIterator(ReqExclScorerPtr scorer);
+        virtual ~ReqExclScorerTwoPhaseIterator();
+        
+        LUCENE_CLASS(ReqExclScorerTwoPhaseIterator);
+    
+    protected:
+        ReqExclScorerPtr scorer;
+    
+    public:
+        virtual bool matches();
+    };
+}
+
+#endif
@@ -0,0 +1,114 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _ROARINGDOCIDSET_H
+#define _ROARINGDOCIDSET_H
+
+#include "DocIdSetIterator.h"
+
+namespace Lucene
+{
+    /// The lower 16 bits of the doc ids of one block of a {@link RoaringDocIdSet}.
+    class RoaringContainer : public LuceneObject
+    {
+    public:
+        RoaringContainer();
+        virtual ~RoaringContainer();
+        
+        LUCENE_CLASS(RoaringContainer);
+    
+    public:
+        static const uint8_t ARRAY;
+        static const uint8_t BITMAP;
+        static const uint8_t RUN;
+        
+        /// An array container holds at most this many values, the point at which it takes as much memory as
+        /// a bitmap.
+        static const int32_t MAX_ARRAY_SIZE;
+        
+        static const int32_t BITMAP_WORDS;
+        
+        uint8_t type;
+        int32_t cardinality;
+        
+        /// Sorted values of an array container, or the start and length minus one of each run of a run container.
+        Array<uint16_t> values;
+        int32_t numRuns;
+        
+        /// Bits of a bitmap container.
+        LongArray words;
+    
+    public:
+        virtual LuceneObjectPtr clone(LuceneObjectPtr other = LuceneObjectPtr());
+        
+        bool contains(int32_t value);
+        
+        /// Adds a value, returning false if it was already there.
+        bool add(int32_t value);
+        
+        /// Removes a value, returning false if it wasn't there.
+        bool remove(int32_t value);
+        
+        /// Returns the least value greater than or equal to target, or -1 if there is none.
+        /// @param hint a position in the values kept by the caller between calls with increasing targets.
+        int32_t nextValue(int32_t target, int32_t& hint);
+        
+        int64_t sizeInBytes();
+        
+        /// Converts to the smallest of the array, bitmap and run forms.
+        void optimize();
+        
+        void write(IndexOutputPtr output);
+        static RoaringContainerPtr read(IndexInputPtr input);
+        
+        /// These return null if the result is empty.
+        static RoaringContainerPtr _and(RoaringContainerPtr a, RoaringContainerPtr b);
+        static RoaringContainerPtr _or(RoaringContainerPtr a, RoaringContainerPtr b);
+        static RoaringContainerPtr andNot(RoaringContainerPtr a, RoaringContainerPtr b);
+        static int32_t intersectionCount(RoaringContainerPtr a, RoaringContainerPtr b);
+    
+    protected:
+        /// Returns the position of value in an array container, or -(insertion point) - 1.
+        int32_t arrayIndex(int32_t value);
+        
+        /// Returns the index of the last run of a run container that starts at or before value, or -1.
+        int32_t runIndex(int32_t value);
+        
+        int32_t countRuns();
+        
+        /// Returns the bits of the container; for a bitmap these are its own words, which must not be changed.
+        LongArray toWords();
+        
+        void toArray();
+        void toBitmap();
+        void toRun();
+        
+        /// Makes an array or bitmap container, whichever is smaller, from a bitmap.
+        static RoaringContainerPtr fromWords(LongArray words);
+    };
+    
+    class RoaringDocIdSetIterator : public DocIdSetIterator
+    {
+    public:
+        RoaringDocIdSetIterator(RoaringDocIdSetPtr set);
+        virtual ~RoaringDocIdSetIterator();
+        
+        LUCENE_CLASS(RoaringDocIdSetIterator);
+    
+    protected:
+        RoaringDocIdSetPtr set;
+        int32_t doc;
+        int32_t index;
+        int32_t hint;
+    
+    public:
+        virtual int32_t docID();
+        virtual int32_t nextDoc();
+        virtual int32_t advance(int32_t target);
+    };
+}
+
+#endif
@@ -30,10 +30,12 @@ namespace Lucene
     
     public:
         String segment;
+        CodecPtr codec;
         FieldInfosPtr fieldInfos;
         IndexInputPtr freqStream;
         IndexInputPtr proxStream;
         TermInfosReaderPtr tisNoIndex;
+        DocValuesReaderPtr docValuesReader;
 
         DirectoryPtr dir;
         DirectoryPtr cfsDir;
@@ -107,7 +109,7 @@ namespace Lucene
     {
     public:
         Norm();
-        Norm(SegmentReaderPtr reader, IndexInputPtr in, int32_t number, int64_t normSeek);
+        Norm(SegmentReaderPtr reader, IndexInputPtr in, int32_t number, int64_t normSeek, bool encoded);
         virtual ~Norm();
         
         LUCENE_CLASS(Norm);
@@ -123,6 +125,13 @@ namespace Lucene
         IndexInputPtr in;
         int64_t normSeek;
         
+        /// True if normSeek points at an encoded entry of a .nrm file rather than at maxDoc raw bytes
+        bool encoded;
+        
+        /// Norms read without copying them to a byte array, possibly in place from a memory mapped input
+        NormValuesPtr _values;
+        bool valuesMapped;
+        
         SegmentReaderRefPtr _bytesRef;
         ByteArray _bytes;
         bool dirty;
@@ -139,6 +148,10 @@ namespace Lucene
         /// Load & cache full bytes array.  Returns bytes.
         ByteArray bytes();
         
+        /// Returns the cached bytes if they were loaded, otherwise reads and caches the norms in the encoding 
+        /// they were written with.
+        NormValuesPtr values();
+        
         /// Only for testing
         SegmentReaderRefPtr bytesRef();
         
@@ -155,6 +168,9 @@ namespace Lucene
     protected:
         void closeInput();
         
+        /// Reads the norms from disk.  Only the origNorm reads.
+        NormValuesPtr readValues(bool& mapped);
+        
         friend class SegmentReader;
     };
 }
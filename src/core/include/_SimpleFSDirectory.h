@@ -52,6 +52,10 @@ namespace Lucene
         InputFilePtr file;
         bool isClone;
         int32_t chunkSize;
+        
+        /// Start and end of this input within the file; a slice covers less than the whole file.
+        int64_t off;
+        int64_t end;
     
     protected:
         virtual void readInternal(uint8_t* b, int32_t offset, int32_t length);
@@ -61,6 +65,9 @@ namespace Lucene
         virtual int64_t length();
         virtual void close();
         
+        /// Returns a clone of this stream bounded to the given range of the file.
+        virtual IndexInputPtr slice(int64_t offset, int64_t length);
+        
         /// Method used for testing.
         bool isValid();
         
@@ -0,0 +1,31 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _SPANSCORER_H
+#define _SPANSCORER_H
+
+#include "TwoPhaseIterator.h"
+
+namespace Lucene
+{
+    /// Positions the spans of a {@link SpanScorer} on the docs of its approximation.
+    class SpanScorerTwoPhaseIterator : public TwoPhaseIterator
+    {
+    public:
+        SpanScorerTwoPhaseIterator(SpanScorerPtr scorer);
+        virtual ~SpanScorerTwoPhaseIterator();
+        
+        LUCENE_CLASS(SpanScorerTwoPhaseIterator);
+    
+    protected:
+        SpanScorerPtr scorer;
+    
+    public:
+        virtual bool matches();
+    };
+}
+
+#endif
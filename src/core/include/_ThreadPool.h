@@ -0,0 +1,78 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _THREADPOOL_H
+#define _THREADPOOL_H
+
+#include <deque>
+#include <boost/thread/tss.hpp>
+#include "ThreadPool.h"
+
+namespace Lucene
+{
+    /// The tasks queued on one worker of a {@link ThreadPool}.  The worker takes from the back, newest first, while
+    /// other workers steal from the front, oldest first.
+    class ThreadPoolQueue : public LuceneObject
+    {
+    public:
+        ThreadPoolQueue();
+        virtual ~ThreadPoolQueue();
+        
+        LUCENE_CLASS(ThreadPoolQueue);
+    
+    protected:
+        std::deque<ThreadPoolTask> tasks;
+    
+    public:
+        void push(const ThreadPoolTask& task);
+        bool popBack(ThreadPoolTask& task);
+        bool popFront(ThreadPoolTask& task);
+    };
+    
+    /// The worker threads of a {@link ThreadPool} and their queues.  Each worker keeps these alive until it stops,
+    /// as the last reference to a pool may be released by one of its own tasks.
+    class ThreadPoolWorkers : public LuceneObject
+    {
+    public:
+        ThreadPoolWorkers(int32_t numThreads);
+        virtual ~ThreadPoolWorkers();
+        
+        LUCENE_CLASS(ThreadPoolWorkers);
+    
+    protected:
+        Collection<ThreadPoolQueuePtr> queues;
+        Collection<threadPtr> threads;
+        
+        /// The index of the worker running on the current thread, if it is one of these.
+        boost::thread_specific_ptr<int32_t> currentWorker;
+        
+        boost::mutex idleMutex;
+        boost::condition idleCondition;
+        int32_t numQueued;
+        int32_t numIdle;
+        int32_t nextQueue;
+        bool shutdown;
+    
+    public:
+        /// Starts the worker threads.
+        virtual void initialize();
+        
+        int32_t size();
+        
+        void submit(const ThreadPoolTask& task);
+        
+        /// Stops the workers once the queued tasks have run, and waits for them unless called by one of them.
+        void stop();
+    
+    protected:
+        /// Runs one queued task on the given worker.  Returns false if all queues are empty.
+        bool runTask(int32_t worker);
+        
+        static void runWorker(ThreadPoolWorkersPtr workers, int32_t worker);
+    };
+}
+
+#endif
@@ -15,7 +15,7 @@ namespace Lucene
     class InOrderTopScoreDocCollector : public TopScoreDocCollector
     {
     public:
-        InOrderTopScoreDocCollector(int32_t numHits);
+        InOrderTopScoreDocCollector(int32_t numHits, int32_t totalHitsThreshold = INT_MAX);
         virtual ~InOrderTopScoreDocCollector();
     
         LUCENE_CLASS(InOrderTopScoreDocCollector);
@@ -29,7 +29,7 @@ namespace Lucene
     class OutOfOrderTopScoreDocCollector : public TopScoreDocCollector
     {
     public:
-        OutOfOrderTopScoreDocCollector(int32_t numHits);
+        OutOfOrderTopScoreDocCollector(int32_t numHits, int32_t totalHitsThreshold = INT_MAX);
         virtual ~OutOfOrderTopScoreDocCollector();
     
         LUCENE_CLASS(OutOfOrderTopScoreDocCollector);
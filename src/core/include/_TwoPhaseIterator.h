@@ -0,0 +1,98 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _TWOPHASEITERATOR_H
+#define _TWOPHASEITERATOR_H
+
+#include "TwoPhaseIterator.h"
+#include "DocIdSetIterator.h"
+
+namespace Lucene
+{
+    /// Iterates over the docs of the approximation of a {@link TwoPhaseIterator} that match.
+    class TwoPhaseIteratorDocIdSetIterator : public DocIdSetIterator
+    {
+    public:
+        TwoPhaseIteratorDocIdSetIterator(TwoPhaseIteratorPtr twoPhase);
+        virtual ~TwoPhaseIteratorDocIdSetIterator();
+        
+        LUCENE_CLASS(TwoPhaseIteratorDocIdSetIterator);
+    
+    protected:
+        TwoPhaseIteratorPtr twoPhase;
+        DocIdSetIteratorPtr approximation;
+    
+    public:
+        virtual int32_t docID();
+        virtual int32_t nextDoc();
+        virtual int32_t advance(int32_t target);
+    
+    protected:
+        /// Moves the approximation from doc on to the first doc that matches.
+        int32_t toMatch(int32_t doc);
+    };
+    
+    /// Iterates over the docs that all of the given iterators have in common.  Like {@link ConjunctionScorer},
+    /// it moves the iterators to their first common doc on construction.
+    class ConjunctionDocIdSetIterator : public DocIdSetIterator
+    {
+    public:
+        ConjunctionDocIdSetIterator(Collection<DocIdSetIteratorPtr> iterators);
+        virtual ~ConjunctionDocIdSetIterator();
+        
+        LUCENE_CLASS(ConjunctionDocIdSetIterator);
+    
+    protected:
+        Collection<DocIdSetIteratorPtr> iterators;
+        int32_t lastDoc;
+    
+    public:
+        virtual int32_t docID();
+        virtual int32_t nextDoc();
+        virtual int32_t advance(int32_t target);
+    
+    protected:
+        int32_t doNext();
+    };
+    
+    /// Matches the current doc of an approximation if all of the given two-phase iterators, which the
+    /// approximation moves, match it.
+    class ConjunctionTwoPhaseIterator : public TwoPhaseIterator
+    {
+    public:
+        ConjunctionTwoPhaseIterator(DocIdSetIteratorPtr approximation, Collection<TwoPhaseIteratorPtr> twoPhaseIterators);
+        virtual ~ConjunctionTwoPhaseIterator();
+        
+        LUCENE_CLASS(ConjunctionTwoPhaseIterator);
+    
+    protected:
+        Collection<TwoPhaseIteratorPtr> twoPhaseIterators;
+    
+    public:
+        virtual bool matches();
+    };
+    
+    /// Iterates over the docs of a {@link TermDocs}, without reading their positions.
+    class TermDocsDocIdSetIterator : public DocIdSetIterator
+    {
+    public:
+        TermDocsDocIdSetIterator(TermDocsPtr termDocs);
+        virtual ~TermDocsDocIdSetIterator();
+        
+        LUCENE_CLASS(TermDocsDocIdSetIterator);
+    
+    protected:
+        TermDocsPtr termDocs;
+        int32_t doc;
+    
+    public:
+        virtual int32_t docID();
+        virtual int32_t nextDoc();
+        virtual int32_t advance(int32_t target);
+    };
+}
+
+#endif
@@ -0,0 +1,56 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "BinaryDocValues.h"
+#include "DocValuesReader.h"
+#include "IndexInput.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    BinaryDocValues::BinaryDocValues(IndexInputPtr input)
+    {
+        this->input = input;
+        numDocs = input->readInt();
+        width = input->readByte();
+        addressPointer = input->getFilePointer();
+        dataPointer = addressPointer + (int64_t)(numDocs + 1) * width;
+        scratch = newLucene<UTF8Result>();
+    }
+    
+    BinaryDocValues::~BinaryDocValues()
+    {
+    }
+    
+    int32_t BinaryDocValues::size()
+    {
+        return numDocs;
+    }
+    
+    void BinaryDocValues::get(int32_t doc, UTF8ResultPtr result)
+    {
+        if (doc < 0 || doc >= numDocs)
+            boost::throw_exception(IndexOutOfBoundsException());
+        input->seek(addressPointer + (int64_t)doc * width);
+        int64_t start = (int64_t)DocValuesReader::readFixed(input, width);
+        int32_t length = (int32_t)((int64_t)DocValuesReader::readFixed(input, width) - start);
+        result->setLength(length);
+        if (length > 0)
+        {
+            input->seek(dataPointer + start);
+            input->readBytes(result->result.get(), 0, length);
+        }
+    }
+    
+    String BinaryDocValues::getString(int32_t doc)
+    {
+        get(doc, scratch);
+        return StringUtils::toUnicode(scratch->result.get(), scratch->length);
+    }
+}
@@ -121,6 +121,10 @@ namespace Lucene
                 sFormat = L"FORMAT_USER_DATA [Lucene 2.9]";
             else if (format == SegmentInfos::FORMAT_DIAGNOSTICS)
                 sFormat = L"FORMAT_DIAGNOSTICS [Lucene 2.9]";
+            else if (format == SegmentInfos::FORMAT_CODEC)
+                sFormat = L"FORMAT_CODEC [Lucene++ 3.0]";
+            else if (format == SegmentInfos::FORMAT_INDEX_SORT)
+                sFormat = L"FORMAT_INDEX_SORT [Lucene++ 3.0]";
             else if (format < SegmentInfos::CURRENT_FORMAT)
             {
                 sFormat = L"int=" + StringUtils::toString(format) + L" [newer version of Lucene than this tool]";
@@ -183,6 +187,11 @@ namespace Lucene
                 segInfoStat->compound = info->getUseCompoundFile();
                 msg(L"    hasProx=" + StringUtils::toString(info->getHasProx()));
                 segInfoStat->hasProx = info->getHasProx();
+                msg(L"    codec=" + info->getCodecName());
+                segInfoStat->codecName = info->getCodecName();
+                if (!info->getIndexSort().empty())
+                    msg(L"    sort=" + info->getIndexSort());
+                segInfoStat->indexSort = info->getIndexSort();
                 msg(L"    numFiles=" + StringUtils::toString(info->files().size()));
                 segInfoStat->numFiles = info->files().size();
                 msg(L"    size (MB)=" + StringUtils::toString((double)info->sizeInBytes() / (double)(1024 * 1024)));
@@ -0,0 +1,79 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "Codec.h"
+#include "DefaultCodec.h"
+
+namespace Lucene
+{
+    Codec::Codec(const String& name)
+    {
+        this->name = name;
+    }
+    
+    Codec::~Codec()
+    {
+    }
+    
+    String Codec::getName()
+    {
+        return name;
+    }
+    
+    CodecPtr Codec::getDefault()
+    {
+        static CodecPtr defaultCodec;
+        if (!defaultCodec)
+        {
+            defaultCodec = newLucene<DefaultCodec>();
+            CycleCheck::addStatic(defaultCodec);
+        }
+        return defaultCodec;
+    }
+    
+    MapStringCodec Codec::codecs()
+    {
+        static MapStringCodec _codecs;
+        if (!_codecs)
+        {
+            _codecs = MapStringCodec::newInstance();
+            CodecPtr defaultCodec(getDefault());
+            _codecs.put(defaultCodec->getName(), defaultCodec);
+        }
+        return _codecs;
+    }
+    
+    void Codec::registerCodec(CodecPtr codec)
+    {
+        if (!codec || codec->getName().empty())
+            boost::throw_exception(IllegalArgumentException(L"codec must have a name"));
+        codecs().put(codec->getName(), codec);
+    }
+    
+    CodecPtr Codec::forName(const String& name)
+    {
+        MapStringCodec _codecs(codecs());
+        MapStringCodec::iterator codec = _codecs.find(name);
+        if (codec == _codecs.end())
+            boost::throw_exception(IllegalArgumentException(L"no codec is registered with name \"" + name + L"\""));
+        return codec->second;
+    }
+    
+    HashSet<String> Codec::availableCodecs()
+    {
+        MapStringCodec _codecs(codecs());
+        HashSet<String> names(HashSet<String>::newInstance());
+        for (MapStringCodec::iterator codec = _codecs.begin(); codec != _codecs.end(); ++codec)
+            names.add(codec->first);
+        return names;
+    }
+    
+    void Codec::files(DirectoryPtr dir, SegmentInfoPtr info, HashSet<String> files)
+    {
+        // the standard segment files are listed by SegmentInfo
+    }
+}
@@ -6,6 +6,10 @@
 
 #include "LuceneInc.h"
 #include "CompoundFileReader.h"
+#include "BufferedIndexInput.h"
+#include "ChecksumFooter.h"
+#include "CompoundFileWriter.h"
+#include "StringUtils.h"
 
 namespace Lucene
 {
@@ -37,8 +41,16 @@ namespace Lucene
         {
             stream = dir->openInput(name, readBufferSize);
             
-            // read the directory and init files
-            int32_t count = stream->readVInt();
+            // read the directory and init files; files written before the format header have no footer
+            int32_t firstInt = stream->readVInt();
+            int32_t count = firstInt;
+            if (firstInt < 0)
+            {
+                if (firstInt < CompoundFileWriter::FORMAT_CURRENT)
+                    boost::throw_exception(CorruptIndexException(L"Incompatible format version: " + StringUtils::toString(firstInt) + L" expected " + StringUtils::toString(CompoundFileWriter::FORMAT_CURRENT)));
+                count = stream->readVInt();
+            }
+            int64_t dataLength = firstInt <= CompoundFileWriter::FORMAT_CHECKSUM_FOOTER ? ChecksumFooter::dataLength(stream) : stream->length();
             
             FileEntryPtr entry;
             for (int32_t i = 0; i < count; ++i)
@@ -59,7 +71,7 @@ namespace Lucene
             
             // set the length of the final entry
             if (entry)
-                entry->length = stream->length() - entry->offset;
+                entry->length = dataLength - entry->offset;
             
             success = true;
         }
@@ -120,7 +132,13 @@ namespace Lucene
         if (entry == entries.end())
             boost::throw_exception(IOException(L"No sub-file with id " + name + L" found"));
         
-        return newLucene<CSIndexInput>(stream, entry->second->offset, entry->second->length, readBufferSize);
+        IndexInputPtr slice(stream->slice(entry->second->offset, entry->second->length));
+        
+        // slices start out with the compound stream's buffer size
+        BufferedIndexInputPtr bufferedSlice(boost::dynamic_pointer_cast<BufferedIndexInput>(slice));
+        if (bufferedSlice && bufferedSlice->getBufferSize() != bufferSize)
+            bufferedSlice->setBufferSize(bufferSize);
+        return slice;
     }
     
     HashSet<String> CompoundFileReader::listAll()
@@ -164,6 +182,14 @@ namespace Lucene
         return entry->second->length;
     }
     
+    int64_t CompoundFileReader::fileOffset(const String& name)
+    {
+        MapStringFileEntryPtr::iterator entry = entries.find(name);
+        if (entry == entries.end())
+            boost::throw_exception(IOException(L"File " + name + L" does not exist"));
+        return entry->second->offset;
+    }
+    
     IndexOutputPtr CompoundFileReader::createOutput(const String& name)
     {
         boost::throw_exception(UnsupportedOperationException());
@@ -175,61 +201,4 @@ namespace Lucene
         boost::throw_exception(UnsupportedOperationException());
         return LockPtr();
     }
-    
-    CSIndexInput::CSIndexInput()
-    {
-        fileOffset = 0;
-        _length = 0;
-    }
-    
-    CSIndexInput::CSIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length) : BufferedIndexInput(BufferedIndexInput::BUFFER_SIZE)
-    {
-        this->base = boost::dynamic_pointer_cast<IndexInput>(base->clone());
-        this->fileOffset = fileOffset;
-        this->_length = length;
-    }
-    
-    CSIndexInput::CSIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length, int32_t readBufferSize) : BufferedIndexInput(readBufferSize)
-    {
-        this->base = boost::dynamic_pointer_cast<IndexInput>(base->clone());
-        this->fileOffset = fileOffset;
-        this->_length = length;
-    }
-    
-    CSIndexInput::~CSIndexInput()
-    {
-    }
-    
-    void CSIndexInput::readInternal(uint8_t* b, int32_t offset, int32_t length)
-    {
-        int64_t start = getFilePointer();
-        if (start + length > _length)
-            boost::throw_exception(IOException(L"read past EOF"));
-        base->seek(fileOffset + start);
-        base->readBytes(b, offset, length, false);
-    }
-    
-    void CSIndexInput::seekInternal(int64_t pos)
-    {
-    }
-    
-    void CSIndexInput::close()
-    {
-        base->close();
-    }
-    
-    int64_t CSIndexInput::length()
-    {
-        return _length;
-    }
-    
-    LuceneObjectPtr CSIndexInput::clone(LuceneObjectPtr other)
-    {
-        LuceneObjectPtr clone = other ? other : newLucene<CSIndexInput>();
-        CSIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<CSIndexInput>(BufferedIndexInput::clone(clone)));
-        cloneIndexInput->base = boost::dynamic_pointer_cast<IndexInput>(this->base->clone());
-        cloneIndexInput->fileOffset = fileOffset;
-        cloneIndexInput->_length = _length;
-        return cloneIndexInput;
-    }
 }
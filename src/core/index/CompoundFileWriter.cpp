@@ -11,9 +11,16 @@
 #include "IndexInput.h"
 #include "IndexOutput.h"
 #include "StringUtils.h"
+#include "RAMOutputStream.h"
+#include "ChecksumFooter.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "CRC32C.h"
 
 namespace Lucene
 {
+    const int32_t CompoundFileWriter::FORMAT_CHECKSUM_FOOTER = -1;
+    const int32_t CompoundFileWriter::FORMAT_CURRENT = CompoundFileWriter::FORMAT_CHECKSUM_FOOTER;
+    
     CompoundFileWriter::CompoundFileWriter(DirectoryPtr dir, const String& name, CheckAbortPtr checkAbort)
     {
         if (!dir)
@@ -42,7 +49,7 @@ namespace Lucene
         return fileName;
     }
 
-    void CompoundFileWriter::addFile(const String& file)
+    void CompoundFileWriter::addFile(const String& file, bool hasFooter)
     {
         if (merged)
             boost::throw_exception(IllegalStateException(L"Can't add extensions after merge has been called"));
@@ -55,6 +62,7 @@ namespace Lucene
 
         FileEntry entry;
         entry.file = file;
+        entry.hasFooter = hasFooter;
         entries.add(entry);
     }
 
@@ -75,21 +83,33 @@ namespace Lucene
         LuceneException finally;
         try
         {
-            os = directory->createOutput(fileName);
+            os = newLucene<ChecksumFooterIndexOutput>(directory->createOutput(fileName));
 
-            // Write the number of entries
-            os->writeVInt(entries.size());
-
-            // Write the directory with all offsets at 0. Remember the positions of directory entries so that we
-            // can adjust the offsets later
+            // Work out where each file's data will start, so the directory can be written with its final offsets 
+            // (the compound stream has a checksum footer, so can't be patched afterwards)
+            RAMOutputStreamPtr header(newLucene<RAMOutputStream>());
+            header->writeVInt(FORMAT_CURRENT);
+            header->writeVInt(entries.size());
+            for (Collection<FileEntry>::iterator fe = entries.begin(); fe != entries.end(); ++fe)
+            {
+                header->writeLong(0);
+                header->writeString(fe->file);
+            }
             int64_t totalSize = 0;
             for (Collection<FileEntry>::iterator fe = entries.begin(); fe != entries.end(); ++fe)
             {
-                fe->directoryOffset = os->getFilePointer();
-                os->writeLong(0); // for now
-                os->writeString(fe->file);
+                fe->dataOffset = header->getFilePointer() + totalSize;
                 totalSize += directory->fileLength(fe->file);
             }
+            
+            // Write the format, the number of entries, and the directory with all offsets
+            os->writeVInt(FORMAT_CURRENT);
+            os->writeVInt(entries.size());
+            for (Collection<FileEntry>::iterator fe = entries.begin(); fe != entries.end(); ++fe)
+            {
+                os->writeLong(fe->dataOffset);
+                os->writeString(fe->file);
+            }
 
             // Pre-allocate size of file as optimization - this can potentially help IO performance as we write the
             // file and also later during searching.  It also uncovers a disk-full situation earlier and hopefully
@@ -97,21 +117,15 @@ namespace Lucene
             int64_t finalLength = totalSize + os->getFilePointer();
             os->setLength(finalLength);
 
-            // Open the files and copy their data into the stream. Remember the locations of each file's data section.
+            // Open the files and copy their data into the stream.
             ByteArray buffer(ByteArray::newInstance(16384));
             for (Collection<FileEntry>::iterator fe = entries.begin(); fe != entries.end(); ++fe)
             {
-                fe->dataOffset = os->getFilePointer();
+                if (fe->dataOffset != os->getFilePointer())
+                    boost::throw_exception(IOException(L"File " + fe->file + L" changed length while building compound file"));
                 copyFile(*fe, os, buffer);
             }
 
-            // Write the data offsets into the directory of the compound stream
-            for (Collection<FileEntry>::iterator fe = entries.begin(); fe != entries.end(); ++fe)
-            {
-                os->seek(fe->directoryOffset);
-                os->writeLong(fe->dataOffset);
-            }
-
             BOOST_ASSERT(finalLength == os->length());
 
             // Close the output stream. Set the os to null before trying to close so that if an exception occurs during
@@ -151,11 +165,24 @@ namespace Lucene
             int64_t length = is->length();
             int64_t remainder = length;
             int64_t chunk = buffer.size();
+            
+            // verify files with a checksum footer as they are copied
+            bool verify = source.hasFooter;
+            if (verify && length < ChecksumFooter::FOOTER_LENGTH)
+                boost::throw_exception(CorruptIndexException(L"file is too short to have a checksum footer: " + source.file));
+            CRC32C checksum;
+            int64_t unchecked = verify ? length - 8 : 0;
 
             while (remainder > 0)
             {
                 int32_t len = (int32_t)std::min(chunk, remainder);
                 is->readBytes(buffer.get(), 0, len, false);
+                if (unchecked > 0)
+                {
+                    int32_t checkLength = (int32_t)std::min((int64_t)len, unchecked);
+                    checksum.update(buffer.get(), 0, checkLength);
+                    unchecked -= checkLength;
+                }
                 os->writeBytes(buffer.get(), len);
                 remainder -= len;
                 if (checkAbort)
@@ -164,6 +191,23 @@ namespace Lucene
                     checkAbort->work(80);
                 }
             }
+            
+            if (verify)
+            {
+                is->seek(length - ChecksumFooter::FOOTER_LENGTH);
+                int32_t magic = is->readInt();
+                int32_t algorithm = is->readInt();
+                if (magic != ChecksumFooter::FOOTER_MAGIC || algorithm != ChecksumFooter::ALGORITHM_CRC32C)
+                    boost::throw_exception(CorruptIndexException(L"missing checksum footer (file: " + source.file + L")"));
+                int64_t expected = is->readLong();
+                if (expected != checksum.getValue())
+                {
+                    boost::throw_exception(CorruptIndexException(L"checksum failed (hardware problem?) : expected=" + 
+                                                                 StringUtils::toString(expected, 16) + L" actual=" + 
+                                                                 StringUtils::toString(checksum.getValue(), 16) + 
+                                                                 L" (file: " + source.file + L")"));
+                }
+            }
 
             // Verify that remainder is 0
             if (remainder != 0)
@@ -0,0 +1,315 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include <boost/algorithm/string.hpp>
+#include "CompoundStagingDirectory.h"
+#include "_CompoundStagingDirectory.h"
+#include "RAMDirectory.h"
+#include "RAMOutputStream.h"
+#include "IndexInput.h"
+#include "IndexFileNames.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    const int64_t CompoundStagingDirectory::DEFAULT_MAX_STAGED_BYTES = 16 * 1024 * 1024;
+    
+    CompoundStagingDirectory::CompoundStagingDirectory(DirectoryPtr delegate, const String& segment, int64_t maxStagedBytes)
+    {
+        this->delegate = delegate;
+        this->segment = segment;
+        this->staged = newLucene<RAMDirectory>();
+        this->maxStagedBytes = maxStagedBytes;
+        this->spilled = false;
+        this->lockFactory = delegate->getLockFactory();
+    }
+    
+    CompoundStagingDirectory::~CompoundStagingDirectory()
+    {
+    }
+    
+    bool CompoundStagingDirectory::isWorthStaging(DirectoryPtr directory)
+    {
+        return !boost::dynamic_pointer_cast<RAMDirectory>(directory);
+    }
+    
+    DirectoryPtr CompoundStagingDirectory::getDelegate()
+    {
+        return delegate;
+    }
+    
+    bool CompoundStagingDirectory::isStaged(const String& name)
+    {
+        SyncLock syncLock(this);
+        return staged->fileExists(name);
+    }
+    
+    int64_t CompoundStagingDirectory::sizeInBytes()
+    {
+        return staged->sizeInBytes();
+    }
+    
+    void CompoundStagingDirectory::unstage()
+    {
+        SyncLock syncLock(this);
+        HashSet<String> stagedFiles(staged->listAll());
+        for (HashSet<String>::iterator file = stagedFiles.begin(); file != stagedFiles.end(); ++file)
+        {
+            copyToDelegate(*file);
+            staged->deleteFile(*file);
+        }
+    }
+    
+    HashSet<String> CompoundStagingDirectory::listAll()
+    {
+        SyncLock syncLock(this);
+        HashSet<String> stagedFiles(staged->listAll());
+        HashSet<String> delegateFiles(delegate->listAll());
+        HashSet<String> files(HashSet<String>::newInstance(stagedFiles.begin(), stagedFiles.end()));
+        files.addAll(delegateFiles.begin(), delegateFiles.end());
+        return files;
+    }
+    
+    bool CompoundStagingDirectory::fileExists(const String& name)
+    {
+        SyncLock syncLock(this);
+        return staged->fileExists(name) || delegate->fileExists(name);
+    }
+    
+    uint64_t CompoundStagingDirectory::fileModified(const String& name)
+    {
+        SyncLock syncLock(this);
+        return staged->fileExists(name) ? staged->fileModified(name) : delegate->fileModified(name);
+    }
+    
+    void CompoundStagingDirectory::touchFile(const String& name)
+    {
+        SyncLock syncLock(this);
+        if (staged->fileExists(name))
+            staged->touchFile(name);
+        else
+            delegate->touchFile(name);
+    }
+    
+    void CompoundStagingDirectory::deleteFile(const String& name)
+    {
+        SyncLock syncLock(this);
+        if (staged->fileExists(name))
+            staged->deleteFile(name);
+        else
+            delegate->deleteFile(name);
+    }
+    
+    int64_t CompoundStagingDirectory::fileLength(const String& name)
+    {
+        SyncLock syncLock(this);
+        return staged->fileExists(name) ? staged->fileLength(name) : delegate->fileLength(name);
+    }
+    
+    IndexOutputPtr CompoundStagingDirectory::createOutput(const String& name)
+    {
+        SyncLock syncLock(this);
+        if (doStageWrite(name))
+        {
+            if (delegate->fileExists(name))
+                delegate->deleteFile(name);
+            return newLucene<StagingIndexOutput>(shared_from_this(), name, staged->createOutput(name));
+        }
+        else
+        {
+            if (staged->fileExists(name))
+                staged->deleteFile(name);
+            return delegate->createOutput(name);
+        }
+    }
+    
+    void CompoundStagingDirectory::sync(const String& name)
+    {
+        SyncLock syncLock(this);
+        if (staged->fileExists(name))
+        {
+            copyToDelegate(name);
+            staged->deleteFile(name);
+        }
+        delegate->sync(name);
+    }
+    
+    IndexInputPtr CompoundStagingDirectory::openInput(const String& name)
+    {
+        SyncLock syncLock(this);
+        return staged->fileExists(name) ? staged->openInput(name) : delegate->openInput(name);
+    }
+    
+    IndexInputPtr CompoundStagingDirectory::openInput(const String& name, int32_t bufferSize)
+    {
+        SyncLock syncLock(this);
+        return staged->fileExists(name) ? staged->openInput(name) : delegate->openInput(name, bufferSize);
+    }
+    
+    String CompoundStagingDirectory::getLockID()
+    {
+        return delegate->getLockID();
+    }
+    
+    void CompoundStagingDirectory::close()
+    {
+        SyncLock syncLock(this);
+        staged->close();
+    }
+    
+    String CompoundStagingDirectory::toString()
+    {
+        return L"CompoundStagingDirectory(" + delegate->toString() + L"; segment=" + segment +
+               L" maxStagedMB=" + StringUtils::toString((double)maxStagedBytes / 1024.0 / 1024.0) + L")";
+    }
+    
+    bool CompoundStagingDirectory::doStageWrite(const String& name)
+    {
+        if (!boost::starts_with(name, segment + L"."))
+            return false;
+        // doc store files may be shared with other segments, so they are left out of the compound file
+        if (!IndexFileNames::NON_STORE_INDEX_EXTENSIONS().contains(name.substr(segment.length() + 1)))
+            return false;
+        return !isFull();
+    }
+    
+    bool CompoundStagingDirectory::isFull()
+    {
+        return (spilled || staged->sizeInBytes() > maxStagedBytes);
+    }
+    
+    IndexOutputPtr CompoundStagingDirectory::spill(const String& name, IndexOutputPtr output)
+    {
+        SyncLock syncLock(this);
+        spilled = true;
+        int64_t position = output->getFilePointer();
+        output->close();
+        IndexOutputPtr spilled(delegate->createOutput(name));
+        bool success = false;
+        LuceneException finally;
+        try
+        {
+            copyStaged(name, spilled);
+            success = true;
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        if (!success)
+        {
+            // the flush or merge fails with the original exception, and cleans up the partial file
+            try
+            {
+                spilled->close();
+            }
+            catch (...)
+            {
+            }
+        }
+        finally.throwException();
+        staged->deleteFile(name);
+        if (spilled->getFilePointer() != position)
+            spilled->seek(position);
+        return spilled;
+    }
+    
+    void CompoundStagingDirectory::copyToDelegate(const String& name)
+    {
+        IndexOutputPtr output(delegate->createOutput(name));
+        LuceneException finally;
+        try
+        {
+            copyStaged(name, output);
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        output->close();
+        finally.throwException();
+    }
+    
+    void CompoundStagingDirectory::copyStaged(const String& name, IndexOutputPtr output)
+    {
+        IndexInputPtr input(staged->openInput(name));
+        LuceneException finally;
+        try
+        {
+            output->copyBytes(input, input->length());
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        input->close();
+        finally.throwException();
+    }
+    
+    StagingIndexOutput::StagingIndexOutput(CompoundStagingDirectoryPtr directory, const String& name, IndexOutputPtr output)
+    {
+        this->_directory = directory;
+        this->name = name;
+        this->output = output;
+        this->spilled = false;
+        this->unchecked = 0;
+    }
+    
+    StagingIndexOutput::~StagingIndexOutput()
+    {
+    }
+    
+    void StagingIndexOutput::writeByte(uint8_t b)
+    {
+        output->writeByte(b);
+        if (!spilled && ++unchecked >= RAMOutputStream::BUFFER_SIZE)
+            checkSpill();
+    }
+    
+    void StagingIndexOutput::writeBytes(const uint8_t* b, int32_t offset, int32_t length)
+    {
+        output->writeBytes(b, offset, length);
+        if (!spilled && (unchecked += length) >= RAMOutputStream::BUFFER_SIZE)
+            checkSpill();
+    }
+    
+    void StagingIndexOutput::flush()
+    {
+        output->flush();
+    }
+    
+    void StagingIndexOutput::close()
+    {
+        output->close();
+    }
+    
+    int64_t StagingIndexOutput::getFilePointer()
+    {
+        return output->getFilePointer();
+    }
+    
+    void StagingIndexOutput::seek(int64_t pos)
+    {
+        output->seek(pos);
+    }
+    
+    int64_t StagingIndexOutput::length()
+    {
+        return output->length();
+    }
+    
+    void StagingIndexOutput::checkSpill()
+    {
+        unchecked = 0;
+        CompoundStagingDirectoryPtr directory(_directory);
+        if (directory->isFull())
+        {
+            output = directory->spill(name, output);
+            spilled = true;
+        }
+    }
+}
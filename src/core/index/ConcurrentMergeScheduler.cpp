@@ -5,11 +5,14 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "LuceneInc.h"
+#include <boost/bind.hpp>
+#include <boost/bind/protect.hpp>
 #include "ConcurrentMergeScheduler.h"
 #include "_ConcurrentMergeScheduler.h"
 #include "IndexWriter.h"
 #include "TestPoint.h"
 #include "StringUtils.h"
+#include "ThreadPool.h"
 
 namespace Lucene
 {
@@ -25,6 +28,18 @@ namespace Lucene
         closed = false;
     }
     
+    ConcurrentMergeScheduler::ConcurrentMergeScheduler(ThreadPoolPtr executor)
+    {
+        if (!executor)
+            boost::throw_exception(NullPointerException(L"executor must not be null"));
+        mergeThreadPriority = -1;
+        mergeThreads = SetMergeThread::newInstance();
+        maxThreadCount = 1;
+        suppressExceptions = false;
+        closed = false;
+        this->executor = executor;
+    }
+    
     ConcurrentMergeScheduler::~ConcurrentMergeScheduler()
     {
     }
@@ -48,6 +63,11 @@ namespace Lucene
         return maxThreadCount;
     }
     
+    ThreadPoolPtr ConcurrentMergeScheduler::getExecutor()
+    {
+        return executor;
+    }
+    
     int32_t ConcurrentMergeScheduler::getMergeThreadPriority()
     {
         SyncLock syncLock(this);
@@ -167,9 +187,16 @@ namespace Lucene
                 // OK to spawn a new merge thread to handle this merge
                 merger = getMergeThread(writer, merge);
                 mergeThreads.add(merger);
-                message(L"    launch new thread");
-                
-                merger->start();
+                if (executor)
+                {
+                    message(L"    schedule new task");
+                    merger->schedule(executor);
+                }
+                else
+                {
+                    message(L"    launch new thread");
+                    merger->start();
+                }
                 success = true;
             }
             catch (LuceneException& e)
@@ -293,6 +320,37 @@ namespace Lucene
         }
     }
     
+    void MergeThread::schedule(ThreadPoolPtr executor)
+    {
+        setRunning(true);
+        executor->scheduleTask(boost::protect(boost::bind<bool>(boost::mem_fn(&MergeThread::runTask), shared_from_this())));
+    }
+    
+    bool MergeThread::runTask()
+    {
+        try
+        {
+            run();
+        }
+        catch (...)
+        {
+        }
+        setRunning(false);
+        ConcurrentMergeSchedulerPtr merger(_merger.lock());
+        if (merger)
+        {
+            SyncLock syncLock(merger);
+            merger->notifyAll();
+        }
+        return true;
+    }
+    
+    bool MergeThread::isAlive()
+    {
+        // merges run by a pool have no thread of their own
+        return isRunning();
+    }
+    
     void MergeThread::run()
     {
         // First time through the while loop we do the merge that we were started with
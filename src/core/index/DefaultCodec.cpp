@@ -0,0 +1,144 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DefaultCodec.h"
+#include "FormatPostingsFieldsWriter.h"
+#include "TermInfosReader.h"
+#include "SegmentReader.h"
+#include "SegmentTermDocs.h"
+#include "SegmentTermPositions.h"
+#include "FieldsWriter.h"
+#include "FieldsReader.h"
+#include "TermVectorsTermsWriter.h"
+#include "TermVectorsWriter.h"
+#include "TermVectorsReader.h"
+#include "NormsWriter.h"
+#include "NormsFormat.h"
+#include "SegmentMerger.h"
+#include "Directory.h"
+#include "IndexFileNames.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "DocValuesWriter.h"
+#include "DocValuesReader.h"
+
+namespace Lucene
+{
+    const String DefaultCodec::CODEC_NAME = L"Lucene30";
+    
+    DefaultCodec::DefaultCodec() : Codec(CODEC_NAME)
+    {
+    }
+    
+    DefaultCodec::~DefaultCodec()
+    {
+    }
+    
+    FormatPostingsFieldsConsumerPtr DefaultCodec::fieldsConsumer(SegmentWriteStatePtr state, FieldInfosPtr fieldInfos)
+    {
+        return newLucene<FormatPostingsFieldsWriter>(state, fieldInfos);
+    }
+    
+    TermInfosReaderPtr DefaultCodec::termsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t indexDivisor)
+    {
+        return newLucene<TermInfosReader>(dir, segment, fieldInfos, readBufferSize, indexDivisor);
+    }
+    
+    TermDocsPtr DefaultCodec::termDocs(SegmentReaderPtr reader)
+    {
+        return newLucene<SegmentTermDocs>(reader);
+    }
+    
+    TermPositionsPtr DefaultCodec::termPositions(SegmentReaderPtr reader)
+    {
+        return newLucene<SegmentTermPositions>(reader);
+    }
+    
+    IndexInputPtr DefaultCodec::freqInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize)
+    {
+        return dir->openInput(segment + L"." + IndexFileNames::FREQ_EXTENSION(), readBufferSize);
+    }
+    
+    IndexInputPtr DefaultCodec::proxInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize)
+    {
+        return dir->openInput(segment + L"." + IndexFileNames::PROX_EXTENSION(), readBufferSize);
+    }
+    
+    FieldsWriterPtr DefaultCodec::fieldsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos)
+    {
+        return newLucene<FieldsWriter>(dir, segment, fieldInfos);
+    }
+    
+    FieldsReaderPtr DefaultCodec::fieldsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size)
+    {
+        return newLucene<FieldsReader>(dir, segment, fieldInfos, readBufferSize, docStoreOffset, size);
+    }
+    
+    TermsHashConsumerPtr DefaultCodec::termVectorsConsumer(DocumentsWriterPtr docWriter)
+    {
+        return newLucene<TermVectorsTermsWriter>(docWriter);
+    }
+    
+    TermVectorsWriterPtr DefaultCodec::termVectorsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos)
+    {
+        return newLucene<TermVectorsWriter>(dir, segment, fieldInfos);
+    }
+    
+    TermVectorsReaderPtr DefaultCodec::termVectorsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size)
+    {
+        return newLucene<TermVectorsReader>(dir, segment, fieldInfos, readBufferSize, docStoreOffset, size);
+    }
+    
+    InvertedDocEndConsumerPtr DefaultCodec::normsConsumer()
+    {
+        return newLucene<NormsWriter>();
+    }
+    
+    IndexOutputPtr DefaultCodec::normsOutput(DirectoryPtr dir, const String& segment)
+    {
+        IndexOutputPtr out(newLucene<ChecksumFooterIndexOutput>(dir->createOutput(segment + L"." + IndexFileNames::NORMS_EXTENSION())));
+        LuceneException finally;
+        try
+        {
+            out->writeBytes(SegmentMerger::NORMS_HEADER, 0, SegmentMerger::NORMS_HEADER_LENGTH);
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        if (!finally.isNull())
+        {
+            out->close();
+            finally.throwException();
+        }
+        return out;
+    }
+    
+    void DefaultCodec::writeNorms(IndexOutputPtr out, ByteArray norms, int32_t numDocs, bool reducedPrecision)
+    {
+        NormsFormat::write(out, norms, numDocs, reducedPrecision);
+    }
+    
+    Collection<int64_t> DefaultCodec::readNormEntries(IndexInputPtr in, int32_t numFields)
+    {
+        return NormsFormat::readEntries(in, numFields);
+    }
+    
+    NormValuesPtr DefaultCodec::readNorms(IndexInputPtr in, int64_t pos, int32_t numDocs, bool encoded, bool& mapped)
+    {
+        return NormsFormat::read(in, pos, numDocs, encoded, mapped);
+    }
+    
+    DocValuesWriterPtr DefaultCodec::docValuesWriter(DirectoryPtr dir, const String& segment, int32_t numDocs)
+    {
+        return newLucene<DocValuesWriter>(dir, segment, numDocs);
+    }
+    
+    DocValuesReaderPtr DefaultCodec::docValuesReader(DirectoryPtr dir, const String& segment, int32_t readBufferSize)
+    {
+        return newLucene<DocValuesReader>(dir, segment, readBufferSize);
+    }
+}
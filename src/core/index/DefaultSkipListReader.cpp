@@ -14,6 +14,8 @@ namespace Lucene
         : MultiLevelSkipListReader(skipStream, maxSkipLevels, skipInterval)
     {
         currentFieldStoresPayloads = false;
+        currentFieldStoresFreqImpacts = false;
+        currentFieldStoresNormImpacts = false;
         lastFreqPointer = 0;
         lastProxPointer = 0;
         lastPayloadLength = 0;
@@ -21,26 +23,35 @@ namespace Lucene
         freqPointer = Collection<int64_t>::newInstance(maxSkipLevels);
         proxPointer = Collection<int64_t>::newInstance(maxSkipLevels);
         payloadLength = Collection<int32_t>::newInstance(maxSkipLevels);
+        maxFreq = Collection<int32_t>::newInstance(maxSkipLevels);
+        maxNorm = Collection<int32_t>::newInstance(maxSkipLevels);
         
         MiscUtils::arrayFill(freqPointer.begin(), 0, freqPointer.size(), 0);
         MiscUtils::arrayFill(proxPointer.begin(), 0, proxPointer.size(), 0);
         MiscUtils::arrayFill(payloadLength.begin(), 0, payloadLength.size(), 0);
+        MiscUtils::arrayFill(maxFreq.begin(), 0, maxFreq.size(), INT_MAX);
+        MiscUtils::arrayFill(maxNorm.begin(), 0, maxNorm.size(), 0xff);
     }
     
     DefaultSkipListReader::~DefaultSkipListReader()
     {
     }
     
-    void DefaultSkipListReader::init(int64_t skipPointer, int64_t freqBasePointer, int64_t proxBasePointer, int32_t df, bool storesPayloads)
+    void DefaultSkipListReader::init(int64_t skipPointer, int64_t freqBasePointer, int64_t proxBasePointer, int32_t df, bool storesPayloads, 
+                                     bool storesFreqImpacts, bool storesNormImpacts)
     {
         MultiLevelSkipListReader::init(skipPointer, df);
         this->currentFieldStoresPayloads = storesPayloads;
+        this->currentFieldStoresFreqImpacts = storesFreqImpacts;
+        this->currentFieldStoresNormImpacts = storesNormImpacts;
         lastFreqPointer = freqBasePointer;
         lastProxPointer = proxBasePointer;
         
         MiscUtils::arrayFill(freqPointer.begin(), 0, freqPointer.size(), freqBasePointer);
         MiscUtils::arrayFill(proxPointer.begin(), 0, proxPointer.size(), proxBasePointer);
         MiscUtils::arrayFill(payloadLength.begin(), 0, payloadLength.size(), 0);
+        MiscUtils::arrayFill(maxFreq.begin(), 0, maxFreq.size(), INT_MAX);
+        MiscUtils::arrayFill(maxNorm.begin(), 0, maxNorm.size(), 0xff);
     }
     
     int64_t DefaultSkipListReader::getFreqPointer()
@@ -58,6 +69,27 @@ namespace Lucene
         return lastPayloadLength;
     }
     
+    bool DefaultSkipListReader::hasImpacts(int32_t level)
+    {
+        // an entry is known once read, until the level runs out of entries
+        return (haveSkipped && level < numberOfSkipLevels && numSkipped[level] > 0 && skipDoc[level] != INT_MAX);
+    }
+    
+    int32_t DefaultSkipListReader::getImpactDocUpTo(int32_t level)
+    {
+        return skipDoc[level];
+    }
+    
+    int32_t DefaultSkipListReader::getMaxFreq(int32_t level)
+    {
+        return maxFreq[level];
+    }
+    
+    int32_t DefaultSkipListReader::getMaxNorm(int32_t level)
+    {
+        return maxNorm[level];
+    }
+    
     void DefaultSkipListReader::seekChild(int32_t level)
     {
         MultiLevelSkipListReader::seekChild(level);
@@ -91,6 +123,10 @@ namespace Lucene
         
         freqPointer[level] += skipStream->readVInt();
         proxPointer[level] += skipStream->readVInt();
+        if (currentFieldStoresFreqImpacts)
+            maxFreq[level] = skipStream->readVInt();
+        if (currentFieldStoresNormImpacts)
+            maxNorm[level] = skipStream->readByte();
         
         return delta;
     }
@@ -18,6 +18,8 @@ namespace Lucene
         curPayloadLength = 0;
         curFreqPointer = 0;
         curProxPointer = 0;
+        curStoreFreqImpacts = false;
+        curStoreNormImpacts = false;
         
         this->freqOutput = freqOutput;
         this->proxOutput = proxOutput;
@@ -26,6 +28,8 @@ namespace Lucene
         lastSkipPayloadLength = Collection<int32_t>::newInstance(numberOfSkipLevels);
         lastSkipFreqPointer = Collection<int64_t>::newInstance(numberOfSkipLevels);
         lastSkipProxPointer = Collection<int64_t>::newInstance(numberOfSkipLevels);
+        levelMaxFreq = Collection<int32_t>::newInstance(numberOfSkipLevels);
+        levelMaxNorm = Collection<int32_t>::newInstance(numberOfSkipLevels);
     }
     
     DefaultSkipListWriter::~DefaultSkipListWriter()
@@ -42,8 +46,20 @@ namespace Lucene
         this->proxOutput = proxOutput;
     }
     
-    void DefaultSkipListWriter::setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength)
+    void DefaultSkipListWriter::setStoreImpacts(bool storeFreqImpacts, bool storeNormImpacts)
     {
+        this->curStoreFreqImpacts = storeFreqImpacts;
+        this->curStoreNormImpacts = storeNormImpacts;
+    }
+    
+    void DefaultSkipListWriter::setSkipData(int32_t doc, bool storePayloads, int32_t payloadLength, int32_t maxFreq, int32_t maxNorm)
+    {
+        // an entry on a higher level covers the docs of all the entries below it since its previous entry
+        for (int32_t level = 0; level < numberOfSkipLevels; ++level)
+        {
+            levelMaxFreq[level] = std::max(levelMaxFreq[level], maxFreq);
+            levelMaxNorm[level] = std::max(levelMaxNorm[level], maxNorm);
+        }
         this->curDoc = doc;
         this->curStorePayloads = storePayloads;
         this->curPayloadLength = payloadLength;
@@ -57,6 +73,8 @@ namespace Lucene
         MultiLevelSkipListWriter::resetSkip();
         MiscUtils::arrayFill(lastSkipDoc.begin(), 0, lastSkipDoc.size(), 0);
         MiscUtils::arrayFill(lastSkipPayloadLength.begin(), 0, lastSkipPayloadLength.size(), -1); // we don't have to write the first length in the skip list
+        MiscUtils::arrayFill(levelMaxFreq.begin(), 0, levelMaxFreq.size(), 0);
+        MiscUtils::arrayFill(levelMaxNorm.begin(), 0, levelMaxNorm.size(), 0);
         MiscUtils::arrayFill(lastSkipFreqPointer.begin(), 0, lastSkipFreqPointer.size(), freqOutput->getFilePointer());
         if (proxOutput)
             MiscUtils::arrayFill(lastSkipProxPointer.begin(), 0, lastSkipProxPointer.size(), proxOutput->getFilePointer());
@@ -84,6 +102,10 @@ namespace Lucene
         //         if DocSkip is even, then it is assumed that the
         //         current payload length equals the length at the previous
         //         skip point
+        // In both cases the entry ends with the impacts of the docs it skips over, for fields that keep them:
+        //           Impacts                   --> MaxFreq?, MaxNorm?
+        //           MaxFreq                   --> VInt, if the field stores term freqs
+        //           MaxNorm                   --> Byte, if the field stores norms
         if (curStorePayloads)
         {
             int32_t delta = curDoc - lastSkipDoc[level];
@@ -109,6 +131,12 @@ namespace Lucene
         }
         skipBuffer->writeVInt((int32_t)(curFreqPointer - lastSkipFreqPointer[level]));
         skipBuffer->writeVInt((int32_t)(curProxPointer - lastSkipProxPointer[level]));
+        if (curStoreFreqImpacts)
+            skipBuffer->writeVInt(levelMaxFreq[level]);
+        if (curStoreNormImpacts)
+            skipBuffer->writeByte((uint8_t)levelMaxNorm[level]);
+        levelMaxFreq[level] = 0;
+        levelMaxNorm[level] = 0;
         
         lastSkipDoc[level] = curDoc;
 
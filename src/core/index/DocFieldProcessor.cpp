@@ -10,6 +10,8 @@
 #include "DocFieldConsumerPerThread.h"
 #include "DocFieldConsumer.h"
 #include "StoredFieldsWriter.h"
+#include "DocValuesConsumer.h"
+#include "DocValuesConsumerPerThread.h"
 #include "SegmentWriteState.h"
 #include "IndexFileNames.h"
 #include "FieldInfos.h"
@@ -24,6 +26,7 @@ namespace Lucene
         this->consumer = consumer;
         consumer->setFieldInfos(fieldInfos);
         fieldsWriter = newLucene<StoredFieldsWriter>(docWriter, fieldInfos);
+        docValuesConsumer = newLucene<DocValuesConsumer>(docWriter);
     }
     
     DocFieldProcessor::~DocFieldProcessor()
@@ -40,14 +43,17 @@ namespace Lucene
     {
         TestScope testScope(L"DocFieldProcessor", L"flush");
         MapDocFieldConsumerPerThreadCollectionDocFieldConsumerPerField childThreadsAndFields(MapDocFieldConsumerPerThreadCollectionDocFieldConsumerPerField::newInstance());
+        Collection<DocValuesConsumerPerThreadPtr> docValuesThreads(Collection<DocValuesConsumerPerThreadPtr>::newInstance());
         
         for (Collection<DocConsumerPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
         {
             DocFieldProcessorPerThreadPtr perThread(boost::static_pointer_cast<DocFieldProcessorPerThread>(*thread));
             childThreadsAndFields.put(perThread->consumer, perThread->fields());
+            docValuesThreads.add(perThread->docValuesWriter);
             perThread->trimFields(state);
         }
         fieldsWriter->flush(state);
+        docValuesConsumer->flush(docValuesThreads, state);
         consumer->flush(childThreadsAndFields, state);
         
         // Important to save after asking consumer to flush so consumer can alter the FieldInfo* if necessary.
@@ -60,6 +66,7 @@ namespace Lucene
     void DocFieldProcessor::abort()
     {
         fieldsWriter->abort();
+        docValuesConsumer->abort();
         consumer->abort();
     }
     
@@ -15,6 +15,8 @@
 #include "DocumentsWriter.h"
 #include "StoredFieldsWriter.h"
 #include "StoredFieldsWriterPerThread.h"
+#include "DocValuesConsumer.h"
+#include "DocValuesConsumerPerThread.h"
 #include "SegmentWriteState.h"
 #include "FieldInfo.h"
 #include "FieldInfos.h"
@@ -54,6 +56,7 @@ namespace Lucene
         DocFieldProcessorPtr docFieldProcessor(_docFieldProcessor);
         consumer = docFieldProcessor->consumer->addThread(shared_from_this());
         fieldsWriter = docFieldProcessor->fieldsWriter->addThread(docState);
+        docValuesWriter = docFieldProcessor->docValuesConsumer->addThread(docState);
     }
     
     void DocFieldProcessorPerThread::abort()
@@ -69,6 +72,7 @@ namespace Lucene
             }
         }
         fieldsWriter->abort();
+        docValuesWriter->reset();
         consumer->abort();
     }
     
@@ -211,6 +215,11 @@ namespace Lucene
                                       (*field)->getOmitNorms(), false, (*field)->getOmitTermFreqAndPositions());
             }
             
+            if ((*field)->getReducedPrecisionNorms())
+                fp->fieldInfo->reducedPrecisionNorms = true; // once reduced, always reduced
+            if ((*field)->isBloomFiltered() && (*field)->isIndexed())
+                fp->fieldInfo->bloomFiltered = true;
+            
             if (thisFieldGen != fp->lastGen)
             {
                 // First time we're seeing this field for this doc
@@ -229,6 +238,8 @@ namespace Lucene
             fp->fields[fp->fieldCount++] = *field;
             if ((*field)->isStored())
                 fieldsWriter->addField(*field, fp->fieldInfo);
+            if ((*field)->getDocValuesType() != Fieldable::DOC_VALUES_NONE)
+                docValuesWriter->addField(*field);
         }
         
         // If we are writing vectors then we must visit fields in sorted order so they are written in sorted order.
@@ -246,6 +257,8 @@ namespace Lucene
             docState->maxTermPrefix.clear();
         }
         
+        docValuesWriter->finishDocument();
+        
         DocWriterPtr one(fieldsWriter->finishDocument());
         DocWriterPtr two(consumer->finishDocument());
         
@@ -54,8 +54,9 @@ namespace Lucene
             endChildThreadsAndFields.put(boost::static_pointer_cast<DocInverterPerThread>(entry->first)->endConsumer, endChildFields);
         }
         
-        consumer->flush(childThreadsAndFields, state);
+        // norms first, so the postings can record the norms of the docs each skip entry skips over
         endConsumer->flush(endChildThreadsAndFields, state);
+        consumer->flush(childThreadsAndFields, state);
     }
     
     void DocInverter::closeDocStore(SegmentWriteStatePtr state)
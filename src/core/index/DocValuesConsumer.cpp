@@ -0,0 +1,140 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesConsumer.h"
+#include "DocValuesConsumerPerThread.h"
+#include "DocValuesWriter.h"
+#include "DocumentsWriter.h"
+#include "SegmentWriteState.h"
+#include "IndexFileNames.h"
+#include "Codec.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    DocValuesConsumer::DocValuesConsumer(DocumentsWriterPtr docWriter)
+    {
+        this->_docWriter = docWriter;
+        fieldTypes = MapStringInt::newInstance();
+    }
+    
+    DocValuesConsumer::~DocValuesConsumer()
+    {
+    }
+    
+    DocValuesConsumerPerThreadPtr DocValuesConsumer::addThread(DocStatePtr docState)
+    {
+        return newLucene<DocValuesConsumerPerThread>(docState, shared_from_this());
+    }
+    
+    void DocValuesConsumer::checkType(const String& field, int32_t type)
+    {
+        SyncLock syncLock(this);
+        MapStringInt::iterator fieldType = fieldTypes.find(field);
+        if (fieldType == fieldTypes.end())
+            fieldTypes.put(field, type);
+        else if (fieldType->second != type)
+        {
+            boost::throw_exception(IllegalArgumentException(L"cannot change doc values type from " + StringUtils::toString(fieldType->second) + 
+                                                            L" to " + StringUtils::toString(type) + L" for field \"" + field + L"\""));
+        }
+    }
+    
+    void DocValuesConsumer::flush(Collection<DocValuesConsumerPerThreadPtr> threads, SegmentWriteStatePtr state)
+    {
+        SyncLock syncLock(this);
+        if (fieldTypes.empty())
+            return;
+        
+        // write the columns in field name order
+        Collection<String> fieldNames(Collection<String>::newInstance());
+        for (MapStringInt::iterator field = fieldTypes.begin(); field != fieldTypes.end(); ++field)
+            fieldNames.add(field->first);
+        std::sort(fieldNames.begin(), fieldNames.end());
+        
+        state->flushedFiles.add(state->segmentName + L"." + IndexFileNames::DOC_VALUES_EXTENSION());
+        DocValuesWriterPtr writer(state->codec->docValuesWriter(state->directory, state->segmentName, state->numDocs));
+        
+        LuceneException finally;
+        try
+        {
+            for (Collection<String>::iterator field = fieldNames.begin(); field != fieldNames.end(); ++field)
+            {
+                int32_t type = fieldTypes.get(*field);
+                
+                Collection<DocValuesConsumerPerFieldPtr> perFields(Collection<DocValuesConsumerPerFieldPtr>::newInstance());
+                for (Collection<DocValuesConsumerPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
+                {
+                    DocValuesConsumerPerFieldPtr perField((*thread)->fields.get(*field));
+                    if (perField)
+                        perFields.add(perField);
+                }
+                
+                // Documents are numbered across threads, so each thread's values are simply put in place.  If a
+                // document has more than one value for a field, the last one wins.
+                if (type == DocValuesWriter::TYPE_LONG || type == DocValuesWriter::TYPE_DOUBLE)
+                {
+                    Collection<int64_t> values(Collection<int64_t>::newInstance(state->numDocs));
+                    for (Collection<DocValuesConsumerPerFieldPtr>::iterator perField = perFields.begin(); perField != perFields.end(); ++perField)
+                    {
+                        for (int32_t i = 0; i < (*perField)->docIDs.size(); ++i)
+                            values[(*perField)->docIDs[i]] = (*perField)->numbers[i];
+                    }
+                    writer->addNumericField(*field, values, type == DocValuesWriter::TYPE_DOUBLE);
+                }
+                else if (type == DocValuesWriter::TYPE_BINARY)
+                {
+                    Collection<ByteArray> values(Collection<ByteArray>::newInstance(state->numDocs));
+                    for (Collection<DocValuesConsumerPerFieldPtr>::iterator perField = perFields.begin(); perField != perFields.end(); ++perField)
+                    {
+                        for (int32_t i = 0; i < (*perField)->docIDs.size(); ++i)
+                            values[(*perField)->docIDs[i]] = (*perField)->bytes[i];
+                    }
+                    writer->addBinaryField(*field, values);
+                }
+                else
+                {
+                    Collection<String> dictionary(Collection<String>::newInstance());
+                    for (Collection<DocValuesConsumerPerFieldPtr>::iterator perField = perFields.begin(); perField != perFields.end(); ++perField)
+                        dictionary.addAll((*perField)->strings.begin(), (*perField)->strings.end());
+                    std::sort(dictionary.begin(), dictionary.end());
+                    dictionary.remove(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+                    
+                    Collection<int32_t> ords(Collection<int32_t>::newInstance(state->numDocs));
+                    std::fill(ords.begin(), ords.end(), -1);
+                    for (Collection<DocValuesConsumerPerFieldPtr>::iterator perField = perFields.begin(); perField != perFields.end(); ++perField)
+                    {
+                        for (int32_t i = 0; i < (*perField)->docIDs.size(); ++i)
+                        {
+                            Collection<String>::iterator ord = std::lower_bound(dictionary.begin(), dictionary.end(), (*perField)->strings[i]);
+                            ords[(*perField)->docIDs[i]] = std::distance(dictionary.begin(), ord);
+                        }
+                    }
+                    writer->addSortedField(*field, dictionary, ords);
+                }
+            }
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        
+        writer->close();
+        
+        fieldTypes.clear();
+        for (Collection<DocValuesConsumerPerThreadPtr>::iterator thread = threads.begin(); thread != threads.end(); ++thread)
+            (*thread)->reset();
+        
+        finally.throwException();
+    }
+    
+    void DocValuesConsumer::abort()
+    {
+        SyncLock syncLock(this);
+        fieldTypes.clear();
+    }
+}
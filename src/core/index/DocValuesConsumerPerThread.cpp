@@ -0,0 +1,141 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesConsumerPerThread.h"
+#include "DocValuesConsumer.h"
+#include "DocValuesWriter.h"
+#include "DocumentsWriter.h"
+#include "Fieldable.h"
+#include "NumericField.h"
+#include "MiscUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    DocValuesConsumerPerThread::DocValuesConsumerPerThread(DocStatePtr docState, DocValuesConsumerPtr docValuesConsumer)
+    {
+        this->_docValuesConsumer = docValuesConsumer;
+        this->docState = docState;
+        fields = MapStringDocValuesConsumerPerField::newInstance();
+        docBytesUsed = 0;
+        bytesUsed = 0;
+    }
+    
+    DocValuesConsumerPerThread::~DocValuesConsumerPerThread()
+    {
+    }
+    
+    void DocValuesConsumerPerThread::addField(FieldablePtr field)
+    {
+        String fieldName(field->name());
+        int32_t type = DocValuesWriter::TYPE_LONG;
+        int64_t number = 0;
+        ByteArray bytes;
+        String string;
+        
+        switch (field->getDocValuesType())
+        {
+            case Fieldable::DOC_VALUES_NUMERIC:
+            {
+                NumericFieldPtr numericField(boost::dynamic_pointer_cast<NumericField>(field));
+                if (numericField && numericField->isDoubleValue())
+                {
+                    type = DocValuesWriter::TYPE_DOUBLE;
+                    number = MiscUtils::doubleToLongBits(numericField->getDoubleValue());
+                }
+                else
+                    number = StringUtils::toLong(field->stringValue());
+                break;
+            }
+            case Fieldable::DOC_VALUES_BINARY:
+            {
+                type = DocValuesWriter::TYPE_BINARY;
+                if (field->isBinary())
+                {
+                    bytes = ByteArray::newInstance(field->getBinaryLength());
+                    MiscUtils::arrayCopy(field->getBinaryValue().get(), field->getBinaryOffset(), bytes.get(), 0, bytes.size());
+                }
+                else
+                {
+                    SingleString utf8(StringUtils::toUTF8(field->stringValue()));
+                    bytes = ByteArray::newInstance(utf8.length());
+                    MiscUtils::arrayCopy((const uint8_t*)utf8.c_str(), 0, bytes.get(), 0, bytes.size());
+                }
+                break;
+            }
+            case Fieldable::DOC_VALUES_SORTED:
+                type = DocValuesWriter::TYPE_SORTED;
+                string = field->stringValue();
+                break;
+            default:
+                return;
+        }
+        
+        DocValuesConsumerPtr(_docValuesConsumer)->checkType(fieldName, type);
+        
+        DocValuesConsumerPerFieldPtr perField(fields.get(fieldName));
+        if (!perField)
+        {
+            perField = newLucene<DocValuesConsumerPerField>(type);
+            fields.put(fieldName, perField);
+        }
+        
+        perField->docIDs.add(docState->docID);
+        docBytesUsed += DocumentsWriter::INT_NUM_BYTE;
+        if (type == DocValuesWriter::TYPE_BINARY)
+        {
+            perField->bytes.add(bytes);
+            docBytesUsed += DocumentsWriter::OBJECT_HEADER_BYTES + bytes.size();
+        }
+        else if (type == DocValuesWriter::TYPE_SORTED)
+        {
+            perField->strings.add(string);
+            docBytesUsed += DocumentsWriter::OBJECT_HEADER_BYTES + string.length() * DocumentsWriter::CHAR_NUM_BYTE;
+        }
+        else
+        {
+            perField->numbers.add(number);
+            docBytesUsed += 2 * DocumentsWriter::INT_NUM_BYTE;
+        }
+    }
+    
+    void DocValuesConsumerPerThread::finishDocument()
+    {
+        if (docBytesUsed > 0)
+        {
+            DocumentsWriterPtr docWriter(DocValuesConsumerPtr(_docValuesConsumer)->_docWriter);
+            docWriter->bytesAllocated(docBytesUsed);
+            docWriter->bytesUsed(docBytesUsed);
+            bytesUsed += docBytesUsed;
+            docBytesUsed = 0;
+        }
+    }
+    
+    void DocValuesConsumerPerThread::reset()
+    {
+        fields.clear();
+        docBytesUsed = 0;
+        if (bytesUsed > 0)
+        {
+            DocumentsWriterPtr(DocValuesConsumerPtr(_docValuesConsumer)->_docWriter)->bytesAllocated(-bytesUsed);
+            bytesUsed = 0;
+        }
+    }
+    
+    DocValuesConsumerPerField::DocValuesConsumerPerField(int32_t type)
+    {
+        this->type = type;
+        docIDs = Collection<int32_t>::newInstance();
+        numbers = Collection<int64_t>::newInstance();
+        bytes = Collection<ByteArray>::newInstance();
+        strings = Collection<String>::newInstance();
+    }
+    
+    DocValuesConsumerPerField::~DocValuesConsumerPerField()
+    {
+    }
+}
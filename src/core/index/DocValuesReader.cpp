@@ -0,0 +1,116 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesReader.h"
+#include "DocValuesWriter.h"
+#include "NumericDocValues.h"
+#include "BinaryDocValues.h"
+#include "SortedDocValues.h"
+#include "ChecksumFooter.h"
+#include "IndexFileNames.h"
+#include "IndexInput.h"
+#include "Directory.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    DocValuesReader::DocValuesReader(DirectoryPtr dir, const String& segment, int32_t readBufferSize)
+    {
+        fieldTypes = MapStringInt::newInstance();
+        fieldPointers = MapStringLong::newInstance();
+        fieldLengths = MapStringLong::newInstance();
+        
+        String fileName(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION());
+        input = dir->openInput(fileName, readBufferSize);
+        
+        bool success = false;
+        LuceneException finally;
+        try
+        {
+            int32_t format = input->readInt();
+            if (format < DocValuesWriter::FORMAT_CURRENT)
+                boost::throw_exception(CorruptIndexException(L"Unknown format version:" + StringUtils::toString(format) + L" in " + fileName));
+            
+            input->seek(ChecksumFooter::dataLength(input) - 8);
+            input->seek(input->readLong());
+            int32_t numFields = input->readVInt();
+            for (int32_t i = 0; i < numFields; ++i)
+            {
+                String field(input->readString());
+                fieldTypes.put(field, input->readByte());
+                fieldPointers.put(field, input->readVLong());
+                fieldLengths.put(field, input->readVLong());
+            }
+            success = true;
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        if (!success)
+            input->close();
+        finally.throwException();
+    }
+    
+    DocValuesReader::~DocValuesReader()
+    {
+    }
+    
+    HashSet<String> DocValuesReader::getFields()
+    {
+        HashSet<String> fields(HashSet<String>::newInstance());
+        for (MapStringInt::iterator field = fieldTypes.begin(); field != fieldTypes.end(); ++field)
+            fields.add(field->first);
+        return fields;
+    }
+    
+    int32_t DocValuesReader::getType(const String& field)
+    {
+        MapStringInt::iterator type = fieldTypes.find(field);
+        return type == fieldTypes.end() ? -1 : type->second;
+    }
+    
+    IndexInputPtr DocValuesReader::column(const String& field)
+    {
+        return input->slice(fieldPointers.get(field), fieldLengths.get(field));
+    }
+    
+    NumericDocValuesPtr DocValuesReader::getNumeric(const String& field)
+    {
+        int32_t type = getType(field);
+        if (type != DocValuesWriter::TYPE_LONG && type != DocValuesWriter::TYPE_DOUBLE)
+            return NumericDocValuesPtr();
+        return newLucene<NumericDocValues>(column(field), type == DocValuesWriter::TYPE_DOUBLE);
+    }
+    
+    BinaryDocValuesPtr DocValuesReader::getBinary(const String& field)
+    {
+        if (getType(field) != DocValuesWriter::TYPE_BINARY)
+            return BinaryDocValuesPtr();
+        return newLucene<BinaryDocValues>(column(field));
+    }
+    
+    SortedDocValuesPtr DocValuesReader::getSorted(const String& field)
+    {
+        if (getType(field) != DocValuesWriter::TYPE_SORTED)
+            return SortedDocValuesPtr();
+        return newLucene<SortedDocValues>(column(field));
+    }
+    
+    void DocValuesReader::close()
+    {
+        input->close();
+    }
+    
+    uint64_t DocValuesReader::readFixed(IndexInputPtr input, int32_t width)
+    {
+        uint64_t value = 0;
+        for (int32_t i = 0; i < width; ++i)
+            value = (value << 8) | input->readByte();
+        return value;
+    }
+}
@@ -0,0 +1,172 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "DocValuesWriter.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "IndexFileNames.h"
+#include "Directory.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    const int32_t DocValuesWriter::FORMAT_CURRENT = -1;
+    
+    const uint8_t DocValuesWriter::TYPE_LONG = 0;
+    const uint8_t DocValuesWriter::TYPE_DOUBLE = 1;
+    const uint8_t DocValuesWriter::TYPE_BINARY = 2;
+    const uint8_t DocValuesWriter::TYPE_SORTED = 3;
+    
+    DocValuesWriter::DocValuesWriter(DirectoryPtr directory, const String& segment, int32_t numDocs)
+    {
+        this->numDocs = numDocs;
+        fieldNames = Collection<String>::newInstance();
+        fieldTypes = Collection<int32_t>::newInstance();
+        fieldPointers = Collection<int64_t>::newInstance();
+        output = newLucene<ChecksumFooterIndexOutput>(directory->createOutput(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION()));
+        output->writeInt(FORMAT_CURRENT);
+    }
+    
+    DocValuesWriter::~DocValuesWriter()
+    {
+    }
+    
+    void DocValuesWriter::startField(const String& field, uint8_t type)
+    {
+        fieldNames.add(field);
+        fieldTypes.add(type);
+        fieldPointers.add(output->getFilePointer());
+    }
+    
+    void DocValuesWriter::addNumericField(const String& field, Collection<int64_t> values, bool isDouble)
+    {
+        BOOST_ASSERT(values.size() == numDocs);
+        startField(field, isDouble ? TYPE_DOUBLE : TYPE_LONG);
+        
+        int64_t minValue = 0;
+        int64_t maxValue = 0;
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+        {
+            if (doc == 0 || values[doc] < minValue)
+                minValue = values[doc];
+            if (doc == 0 || values[doc] > maxValue)
+                maxValue = values[doc];
+        }
+        
+        int32_t width = bytesRequired((uint64_t)maxValue - (uint64_t)minValue);
+        output->writeLong(minValue);
+        output->writeByte((uint8_t)width);
+        if (width > 0)
+        {
+            for (int32_t doc = 0; doc < numDocs; ++doc)
+                writeFixed(output, (uint64_t)values[doc] - (uint64_t)minValue, width);
+        }
+    }
+    
+    void DocValuesWriter::addBinaryField(const String& field, Collection<ByteArray> values)
+    {
+        BOOST_ASSERT(values.size() == numDocs);
+        startField(field, TYPE_BINARY);
+        
+        int64_t totalLength = 0;
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+        {
+            if (values[doc])
+                totalLength += values[doc].size();
+        }
+        
+        int32_t width = bytesRequired((uint64_t)totalLength);
+        output->writeInt(numDocs);
+        output->writeByte((uint8_t)width);
+        int64_t address = 0;
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+        {
+            writeFixed(output, (uint64_t)address, width);
+            if (values[doc])
+                address += values[doc].size();
+        }
+        writeFixed(output, (uint64_t)address, width);
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+        {
+            if (values[doc])
+                output->writeBytes(values[doc].get(), values[doc].size());
+        }
+    }
+    
+    void DocValuesWriter::addSortedField(const String& field, Collection<String> dictionary, Collection<int32_t> ords)
+    {
+        BOOST_ASSERT(ords.size() == numDocs);
+        startField(field, TYPE_SORTED);
+        
+        int32_t numOrds = dictionary.size();
+        Collection<UTF8ResultPtr> terms(Collection<UTF8ResultPtr>::newInstance(numOrds));
+        int64_t totalLength = 0;
+        for (int32_t ord = 0; ord < numOrds; ++ord)
+        {
+            terms[ord] = newLucene<UTF8Result>();
+            StringUtils::toUTF8(dictionary[ord].c_str(), dictionary[ord].length(), terms[ord]);
+            totalLength += terms[ord]->length;
+        }
+        
+        // ords are written shifted by one so that documents without a value are zero
+        int32_t ordWidth = bytesRequired((uint64_t)numOrds);
+        output->writeInt(numDocs);
+        output->writeInt(numOrds);
+        output->writeByte((uint8_t)ordWidth);
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+        {
+            BOOST_ASSERT(ords[doc] >= -1 && ords[doc] < numOrds);
+            writeFixed(output, (uint64_t)(ords[doc] + 1), ordWidth);
+        }
+        
+        int32_t addressWidth = bytesRequired((uint64_t)totalLength);
+        output->writeByte((uint8_t)addressWidth);
+        int64_t address = 0;
+        for (int32_t ord = 0; ord < numOrds; ++ord)
+        {
+            writeFixed(output, (uint64_t)address, addressWidth);
+            address += terms[ord]->length;
+        }
+        writeFixed(output, (uint64_t)address, addressWidth);
+        for (int32_t ord = 0; ord < numOrds; ++ord)
+            output->writeBytes(terms[ord]->result.get(), terms[ord]->length);
+    }
+    
+    void DocValuesWriter::close()
+    {
+        int64_t directoryPointer = output->getFilePointer();
+        output->writeVInt(fieldNames.size());
+        for (int32_t i = 0; i < fieldNames.size(); ++i)
+        {
+            int64_t end = i + 1 < fieldNames.size() ? fieldPointers[i + 1] : directoryPointer;
+            output->writeString(fieldNames[i]);
+            output->writeByte((uint8_t)fieldTypes[i]);
+            output->writeVLong(fieldPointers[i]);
+            output->writeVLong(end - fieldPointers[i]);
+        }
+        output->writeLong(directoryPointer);
+        output->close();
+    }
+    
+    int32_t DocValuesWriter::bytesRequired(uint64_t maxValue)
+    {
+        int32_t width = 0;
+        while (maxValue != 0)
+        {
+            ++width;
+            maxValue >>= 8;
+        }
+        return width;
+    }
+    
+    void DocValuesWriter::writeFixed(IndexOutputPtr output, uint64_t value, int32_t width)
+    {
+        for (int32_t shift = (width - 1) * 8; shift >= 0; shift -= 8)
+            output->writeByte((uint8_t)(value >> shift));
+    }
+}
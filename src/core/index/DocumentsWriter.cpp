@@ -27,16 +27,20 @@
 #include "InfoStream.h"
 #include "DocConsumerPerThread.h"
 #include "SegmentWriteState.h"
+#include "TermInfosWriter.h"
 #include "IndexFileNames.h"
 #include "CompoundFileWriter.h"
+#include "CompoundStagingDirectory.h"
 #include "MergeDocIDRemapper.h"
 #include "SegmentReader.h"
 #include "SegmentInfos.h"
+#include "Codec.h"
 #include "SegmentInfo.h"
 #include "Query.h"
 #include "Weight.h"
 #include "Scorer.h"
 #include "TestPoint.h"
+#include "IndexOutput.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
 
@@ -107,6 +111,7 @@ namespace Lucene
         this->threadBindings = MapThreadDocumentsWriterThreadState::newInstance();
         this->_openFiles = HashSet<String>::newInstance();
         this->_closedFiles = HashSet<String>::newInstance();
+        this->unclosedDocStoreOutputs = Collection<IndexOutputPtr>::newInstance();
         this->freeIntBlocks = Collection<IntArray>::newInstance();
         this->freeCharBlocks = Collection<CharArray>::newInstance();
         
@@ -151,6 +156,7 @@ namespace Lucene
         IndexWriterPtr writer(_writer);
         this->similarity = writer->getSimilarity();
         flushedDocCount = writer->maxDoc();
+        codec = writer->getCodec();
         
         consumer = indexingChain->getChain(shared_from_this());
         docFieldProcessor = boost::dynamic_pointer_cast<DocFieldProcessor>(consumer);
@@ -257,6 +263,35 @@ namespace Lucene
         return maxBufferedDocs;
     }
     
+    void DocumentsWriter::setCodec(CodecPtr codec)
+    {
+        SyncLock syncLock(this);
+        pauseAllThreads();
+        LuceneException finally;
+        try
+        {
+            // a flush names the next doc store up front, but its files are only opened with the first document
+            if (numDocsInRAM != 0 || numDocsInStore != 0)
+                boost::throw_exception(IllegalStateException(L"cannot change codec while documents are buffered"));
+            this->codec = codec;
+            consumer = indexingChain->getChain(shared_from_this());
+            docFieldProcessor = boost::dynamic_pointer_cast<DocFieldProcessor>(consumer);
+            for (Collection<DocumentsWriterThreadStatePtr>::iterator threadState = threadStates.begin(); threadState != threadStates.end(); ++threadState)
+                (*threadState)->consumer = consumer->addThread(*threadState);
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        resumeAllThreads();
+        finally.throwException();
+    }
+    
+    CodecPtr DocumentsWriter::getCodec()
+    {
+        return codec;
+    }
+    
     String DocumentsWriter::getSegment()
     {
         return segment;
@@ -322,6 +357,22 @@ namespace Lucene
         return _abortedFiles;
     }
     
+    void DocumentsWriter::addUnclosedDocStoreOutput(IndexOutputPtr output)
+    {
+        SyncLock syncLock(this);
+        unclosedDocStoreOutputs.add(output);
+    }
+    
+    void DocumentsWriter::closeUnclosedDocStoreOutputs()
+    {
+        SyncLock syncLock(this);
+        while (!unclosedDocStoreOutputs.empty())
+        {
+            unclosedDocStoreOutputs[0]->close();
+            unclosedDocStoreOutputs.remove(unclosedDocStoreOutputs.begin());
+        }
+    }
+    
     void DocumentsWriter::message(const String& message)
     {
         if (infoStream)
@@ -495,10 +546,14 @@ namespace Lucene
     {
         SyncLock syncLock(this);
         initSegmentName(onlyDocStore);
-        flushState = newLucene<SegmentWriteState>(shared_from_this(), directory, segment, docStoreSegment, numDocsInRAM, numDocsInStore, IndexWriterPtr(_writer)->getTermIndexInterval());
+        IndexWriterPtr writer(_writer);
+        flushState = newLucene<SegmentWriteState>(shared_from_this(), directory, segment, docStoreSegment, numDocsInRAM, numDocsInStore, writer->getTermIndexInterval());
+        if (writer->getUseBlockPackedPostings())
+            flushState->postingsFormat = TermInfosWriter::POSTINGS_FORMAT_BLOCK_PACKED;
+        flushState->codec = codec;
     }
     
-    int32_t DocumentsWriter::flush(bool _closeDocStore)
+    int32_t DocumentsWriter::flush(bool _closeDocStore, bool stageCompoundFile)
     {
         SyncLock syncLock(this);
         BOOST_ASSERT(allThreadsIdle());
@@ -510,6 +565,8 @@ namespace Lucene
         BOOST_ASSERT(waitQueue->waitingBytes == 0);
         
         initFlushState(false);
+        if (stageCompoundFile)
+            flushState->directory = newLucene<CompoundStagingDirectory>(directory, flushState->segmentName);
         
         docStoreOffset = numDocsInStore;
         
@@ -537,7 +594,7 @@ namespace Lucene
             
             if (infoStream)
             {
-                SegmentInfoPtr si(newLucene<SegmentInfo>(flushState->segmentName, flushState->numDocs, directory));
+                SegmentInfoPtr si(newLucene<SegmentInfo>(flushState->segmentName, flushState->numDocs, flushState->directory));
                 int64_t newSegmentSize = si->sizeInBytes();
                 if (infoStream)
                 {
@@ -574,12 +631,26 @@ namespace Lucene
     
     void DocumentsWriter::createCompoundFile(const String& segment)
     {
-        CompoundFileWriterPtr cfsWriter(newLucene<CompoundFileWriter>(directory, segment + L"." + IndexFileNames::COMPOUND_FILE_EXTENSION()));
+        // staged files are read straight from RAM
+        CompoundFileWriterPtr cfsWriter(newLucene<CompoundFileWriter>(flushState->directory, segment + L"." + IndexFileNames::COMPOUND_FILE_EXTENSION()));
         for (HashSet<String>::iterator flushedFile = flushState->flushedFiles.begin(); flushedFile != flushState->flushedFiles.end(); ++flushedFile)
-            cfsWriter->addFile(*flushedFile);
+            cfsWriter->addFile(*flushedFile, true);
         
         // Perform the merge
         cfsWriter->close();
+        
+        if (flushState->directory != directory)
+            flushState->directory->close();
+    }
+    
+    void DocumentsWriter::writeStagedFiles()
+    {
+        CompoundStagingDirectoryPtr stagingDirectory(boost::dynamic_pointer_cast<CompoundStagingDirectory>(flushState->directory));
+        if (stagingDirectory)
+        {
+            stagingDirectory->unstage();
+            stagingDirectory->close();
+        }
     }
     
     bool DocumentsWriter::setFlushPending()
@@ -1424,14 +1495,15 @@ namespace Lucene
     
     DocConsumerPtr DefaultIndexingChain::getChain(DocumentsWriterPtr documentsWriter)
     {
-        TermsHashConsumerPtr termVectorsWriter(newLucene<TermVectorsTermsWriter>(documentsWriter));
+        CodecPtr codec(documentsWriter->getCodec());
+        TermsHashConsumerPtr termVectorsWriter(codec->termVectorsConsumer(documentsWriter));
         TermsHashConsumerPtr freqProxWriter(newLucene<FreqProxTermsWriter>());
         
         InvertedDocConsumerPtr termsHash(newLucene<TermsHash>(documentsWriter, true, freqProxWriter,
                                                                  newLucene<TermsHash>(documentsWriter, false, 
                                                                  termVectorsWriter, TermsHashPtr())));
                                                                      
-        DocInverterPtr docInverter(newLucene<DocInverter>(termsHash, newLucene<NormsWriter>()));
+        DocInverterPtr docInverter(newLucene<DocInverter>(termsHash, codec->normsConsumer()));
         return newLucene<DocFieldProcessor>(documentsWriter, docInverter);
     }
     
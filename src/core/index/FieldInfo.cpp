@@ -23,6 +23,8 @@ namespace Lucene
         this->storePayloads = isIndexed ? storePayloads : false;
         this->omitNorms = isIndexed ? omitNorms : true;
         this->omitTermFreqAndPositions = isIndexed ? omitTermFreqAndPositions : false;
+        this->reducedPrecisionNorms = false;
+        this->bloomFiltered = false;
     }
     
     FieldInfo::~FieldInfo()
@@ -31,8 +33,11 @@ namespace Lucene
     
     LuceneObjectPtr FieldInfo::clone(LuceneObjectPtr other)
     {
-        return newLucene<FieldInfo>(name, isIndexed, number, storeTermVector, storePositionWithTermVector, 
-                                    storeOffsetWithTermVector, omitNorms, storePayloads, omitTermFreqAndPositions);
+        FieldInfoPtr clone(newLucene<FieldInfo>(name, isIndexed, number, storeTermVector, storePositionWithTermVector, 
+                                                storeOffsetWithTermVector, omitNorms, storePayloads, omitTermFreqAndPositions));
+        clone->reducedPrecisionNorms = reducedPrecisionNorms;
+        clone->bloomFiltered = bloomFiltered;
+        return clone;
     }
     
     void FieldInfo::update(bool isIndexed, bool storeTermVector, bool storePositionWithTermVector, 
@@ -13,6 +13,8 @@
 #include "Document.h"
 #include "Fieldable.h"
 #include "StringUtils.h"
+#include "ChecksumFooter.h"
+#include "ChecksumFooterIndexOutput.h"
 
 namespace Lucene
 {
@@ -22,7 +24,10 @@ namespace Lucene
     // First used in 2.9; prior to 2.9 there was no format header
     const int32_t FieldInfos::FORMAT_START = -2;
 
-    const int32_t FieldInfos::CURRENT_FORMAT = FieldInfos::FORMAT_START;
+    // The bits of each field are written as a VInt, to make room for BLOOM_FILTERED
+    const int32_t FieldInfos::FORMAT_BLOOM_FILTERS = -3;
+
+    const int32_t FieldInfos::CURRENT_FORMAT = FieldInfos::FORMAT_BLOOM_FILTERS;
 
     const uint8_t FieldInfos::IS_INDEXED = 0x1;
     const uint8_t FieldInfos::STORE_TERMVECTOR = 0x2;
@@ -31,6 +36,8 @@ namespace Lucene
     const uint8_t FieldInfos::OMIT_NORMS = 0x10;
     const uint8_t FieldInfos::STORE_PAYLOADS = 0x20;
     const uint8_t FieldInfos::OMIT_TERM_FREQ_AND_POSITIONS = 0x40;
+    const uint8_t FieldInfos::REDUCED_PRECISION_NORMS = 0x80;
+    const int32_t FieldInfos::BLOOM_FILTERED = 0x100;
     
     FieldInfos::FieldInfos()
     {
@@ -105,9 +112,13 @@ namespace Lucene
         Collection<FieldablePtr> fields(doc->getFields());
         for (Collection<FieldablePtr>::iterator field = fields.begin(); field != fields.end(); ++field)
         {
-            add((*field)->name(), (*field)->isIndexed(), (*field)->isTermVectorStored(), 
-                (*field)->isStorePositionWithTermVector(), (*field)->isStoreOffsetWithTermVector(), 
-                (*field)->getOmitNorms(), false, (*field)->getOmitTermFreqAndPositions());
+            FieldInfoPtr fi(add((*field)->name(), (*field)->isIndexed(), (*field)->isTermVectorStored(), 
+                                (*field)->isStorePositionWithTermVector(), (*field)->isStoreOffsetWithTermVector(), 
+                                (*field)->getOmitNorms(), false, (*field)->getOmitTermFreqAndPositions()));
+            if ((*field)->getReducedPrecisionNorms())
+                fi->reducedPrecisionNorms = true; // once reduced, always reduced
+            if ((*field)->isBloomFiltered() && fi->isIndexed)
+                fi->bloomFiltered = true;
         }
     }
     
@@ -216,9 +227,24 @@ namespace Lucene
         return false;
     }
     
+    bool FieldInfos::hasChecksumFooters()
+    {
+        return (format <= FORMAT_BLOOM_FILTERS);
+    }
+    
+    bool FieldInfos::hasBloomFilters()
+    {
+        for (Collection<FieldInfoPtr>::iterator fi = byNumber.begin(); fi != byNumber.end(); ++fi)
+        {
+            if ((*fi)->bloomFiltered)
+                return true;
+        }
+        return false;
+    }
+    
     void FieldInfos::write(DirectoryPtr d, const String& name)
     {
-        IndexOutputPtr output(d->createOutput(name));
+        IndexOutputPtr output(newLucene<ChecksumFooterIndexOutput>(d->createOutput(name)));
         LuceneException finally;
         try
         {
@@ -238,7 +264,7 @@ namespace Lucene
         output->writeVInt(size());
         for (Collection<FieldInfoPtr>::iterator fi = byNumber.begin(); fi != byNumber.end(); ++fi)
         {
-            uint8_t bits = 0x0;
+            int32_t bits = 0x0;
             if ((*fi)->isIndexed)
                 bits |= IS_INDEXED;
             if ((*fi)->storeTermVector)
@@ -253,9 +279,13 @@ namespace Lucene
                 bits |= STORE_PAYLOADS;
             if ((*fi)->omitTermFreqAndPositions)
                 bits |= OMIT_TERM_FREQ_AND_POSITIONS;
+            if ((*fi)->reducedPrecisionNorms)
+                bits |= REDUCED_PRECISION_NORMS;
+            if ((*fi)->bloomFiltered)
+                bits |= BLOOM_FILTERED;
             
             output->writeString((*fi)->name);
-            output->writeByte(bits);
+            output->writeVInt(bits);
         }
     }
     
@@ -264,25 +294,28 @@ namespace Lucene
         int32_t firstInt = input->readVInt();
         format = firstInt < 0 ? firstInt : FORMAT_PRE; // This is a real format?
         
-        if (format != FORMAT_PRE && format != FORMAT_START)
+        if (format != FORMAT_PRE && format != FORMAT_START && format != FORMAT_BLOOM_FILTERS)
             boost::throw_exception(CorruptIndexException(L"unrecognized format " + StringUtils::toString(format) + L" in file \"" + fileName + L"\""));
         
         int32_t size = format == FORMAT_PRE ? firstInt : input->readVInt(); // read in the size if required
         for (int32_t i = 0; i < size; ++i)
         {
             String name(input->readString());
-            uint8_t bits = input->readByte();
+            int32_t bits = format <= FORMAT_BLOOM_FILTERS ? input->readVInt() : input->readByte();
             
-            addInternal(name, (bits & IS_INDEXED) != 0, (bits & STORE_TERMVECTOR) != 0, (bits & STORE_POSITIONS_WITH_TERMVECTOR) != 0,
-                        (bits & STORE_OFFSET_WITH_TERMVECTOR) != 0, (bits & OMIT_NORMS) != 0, (bits & STORE_PAYLOADS) != 0,
-                        (bits & OMIT_TERM_FREQ_AND_POSITIONS) != 0);
+            FieldInfoPtr fi(addInternal(name, (bits & IS_INDEXED) != 0, (bits & STORE_TERMVECTOR) != 0, (bits & STORE_POSITIONS_WITH_TERMVECTOR) != 0,
+                                        (bits & STORE_OFFSET_WITH_TERMVECTOR) != 0, (bits & OMIT_NORMS) != 0, (bits & STORE_PAYLOADS) != 0,
+                                        (bits & OMIT_TERM_FREQ_AND_POSITIONS) != 0));
+            fi->reducedPrecisionNorms = ((bits & REDUCED_PRECISION_NORMS) != 0);
+            fi->bloomFiltered = ((bits & BLOOM_FILTERED) != 0);
         }
         
-        if (input->getFilePointer() != input->length())
+        int64_t dataLength = hasChecksumFooters() ? ChecksumFooter::dataLength(input) : input->length();
+        if (input->getFilePointer() != dataLength)
         {
             boost::throw_exception(CorruptIndexException(L"did not read all bytes from file \"" + fileName + L"\": read " + 
                                                          StringUtils::toString(input->getFilePointer()) + L" vs size " + 
-                                                         StringUtils::toString(input->length())));
+                                                         StringUtils::toString(dataLength)));
         }
     }
 }
@@ -19,6 +19,12 @@
 #include "MiscUtils.h"
 #include "StringUtils.h"
 #include "VariantUtils.h"
+#include "ChecksumFooter.h"
+#include "RAMFile.h"
+#include "RAMInputStream.h"
+#include "RAMOutputStream.h"
+#include "ByteArrayIndexInput.h"
+#include "LZ4.h"
 
 namespace Lucene
 {
@@ -28,6 +34,7 @@ namespace Lucene
     {
         closed = false;
         isOriginal = false;
+        currentChunk = -1;
         this->fieldInfos = fieldInfos;
         this->numTotalDocs = numTotalDocs;
         this->_size = size;
@@ -63,7 +70,7 @@ namespace Lucene
         closed = false;
         format = 0;
         formatSize = 0;
-        docStoreOffset = docStoreOffset;
+        currentChunk = -1;
         LuceneException finally;
         try
         {
@@ -89,7 +96,17 @@ namespace Lucene
             
             fieldsStream = boost::dynamic_pointer_cast<IndexInput>(cloneableFieldsStream->clone());
             
-            int64_t indexSize = cloneableIndexStream->length() - formatSize;
+            // chunked files are the first written with a checksum footer
+            int64_t indexLength = format >= FieldsWriter::FORMAT_COMPRESSED_CHUNKS ? ChecksumFooter::dataLength(cloneableIndexStream) : cloneableIndexStream->length();
+            int64_t indexSize = indexLength - formatSize;
+            
+            if (format >= FieldsWriter::FORMAT_COMPRESSED_CHUNKS)
+            {
+                readChunkIndex(indexSize);
+                numTotalDocs = chunkDocs[chunkDocs.size() - 1];
+            }
+            else
+                numTotalDocs = (int32_t)(indexSize >> 3);
             
             if (docStoreOffset != -1)
             {
@@ -98,16 +115,15 @@ namespace Lucene
                 this->_size = size;
                 
                 // Verify the file is long enough to hold all of our docs
-                BOOST_ASSERT(((int32_t)((double)indexSize / 8.0)) >= _size + this->docStoreOffset);
+                BOOST_ASSERT(numTotalDocs >= _size + this->docStoreOffset);
             }
             else
             {
                 this->docStoreOffset = 0;
-                this->_size = (int32_t)(indexSize >> 3);
+                this->_size = numTotalDocs;
             }
             
             indexStream = boost::dynamic_pointer_cast<IndexInput>(cloneableIndexStream->clone());
-            numTotalDocs = (int32_t)(indexSize >> 3);
             success = true;
         }
         catch (LuceneException& e)
@@ -124,7 +140,11 @@ namespace Lucene
     LuceneObjectPtr FieldsReader::clone(LuceneObjectPtr other)
     {
         ensureOpen();
-        return newLucene<FieldsReader>(fieldInfos, numTotalDocs, _size, format, formatSize, docStoreOffset, cloneableFieldsStream, cloneableIndexStream);
+        FieldsReaderPtr cloneReader(newLucene<FieldsReader>(fieldInfos, numTotalDocs, _size, format, formatSize, docStoreOffset, 
+                                                            cloneableFieldsStream, cloneableIndexStream));
+        cloneReader->chunkDocs = chunkDocs;
+        cloneReader->chunkPointers = chunkPointers;
+        return cloneReader;
     }
     
     void FieldsReader::ensureOpen()
@@ -149,6 +169,8 @@ namespace Lucene
             if (indexStream)
                 indexStream->close();
             fieldsStreamTL.close();
+            chunkStream.reset();
+            docStream.reset();
             closed = true;
         }
     }
@@ -163,6 +185,57 @@ namespace Lucene
         indexStream->seek(formatSize + (docID + docStoreOffset) * 8);
     }
     
+    void FieldsReader::readChunkIndex(int64_t indexSize)
+    {
+        chunkDocs = Collection<int32_t>::newInstance();
+        chunkPointers = Collection<int64_t>::newInstance();
+        int32_t docs = 0;
+        int64_t pointer = formatSize;
+        int64_t end = formatSize + indexSize;
+        while (cloneableIndexStream->getFilePointer() < end)
+        {
+            chunkDocs.add(docs);
+            chunkPointers.add(pointer);
+            docs += cloneableIndexStream->readVInt();
+            pointer += cloneableIndexStream->readVLong();
+        }
+        chunkDocs.add(docs);
+        chunkPointers.add(pointer);
+    }
+    
+    int32_t FieldsReader::loadChunk(int32_t docID)
+    {
+        if (currentChunk == -1 || docID < chunkDocs[currentChunk] || docID >= chunkDocs[currentChunk + 1])
+        {
+            int32_t chunk = (int32_t)(std::upper_bound(chunkDocs.begin(), chunkDocs.end(), docID) - chunkDocs.begin()) - 1;
+            if (chunk < 0 || chunk >= chunkDocs.size() - 1)
+                boost::throw_exception(IndexOutOfBoundsException(L"docID " + StringUtils::toString(docID) + L" is out of range"));
+            
+            currentChunk = -1;
+            fieldsStream->seek(chunkPointers[chunk]);
+            int32_t numDocs = fieldsStream->readVInt();
+            if (numDocs != chunkDocs[chunk + 1] - chunkDocs[chunk])
+            {
+                boost::throw_exception(CorruptIndexException(L"chunk holds " + StringUtils::toString(numDocs) + 
+                                                             L" docs but the index expects " + 
+                                                             StringUtils::toString(chunkDocs[chunk + 1] - chunkDocs[chunk])));
+            }
+            if (!chunkOffsets || chunkOffsets.size() < numDocs + 1)
+                chunkOffsets = IntArray::newInstance(MiscUtils::getNextSize(numDocs + 1));
+            chunkOffsets[0] = 0;
+            for (int32_t i = 0; i < numDocs; ++i)
+                chunkOffsets[i + 1] = chunkOffsets[i] + fieldsStream->readVInt();
+            
+            // lazy fields may still refer to the previous chunk, so it is never overwritten
+            int32_t length = chunkOffsets[numDocs];
+            chunkBytes = ByteArray::newInstance(std::max(length, 1));
+            LZ4::decompress(fieldsStream, length, chunkBytes.get(), 0);
+            chunkStream = newLucene<ByteArrayIndexInput>(chunkBytes, length);
+            currentChunk = chunk;
+        }
+        return chunkOffsets[docID - chunkDocs[currentChunk]];
+    }
+    
     bool FieldsReader::canReadRawDocs()
     {
         // Disable reading raw docs in 2.x format, because of the removal of compressed fields in 3.0. 
@@ -173,19 +246,29 @@ namespace Lucene
     
     DocumentPtr FieldsReader::doc(int32_t n, FieldSelectorPtr fieldSelector)
     {
-        seekIndex(n);
-        int64_t position = indexStream->readLong();
-        fieldsStream->seek(position);
+        if (format >= FieldsWriter::FORMAT_COMPRESSED_CHUNKS)
+        {
+            int32_t offset = loadChunk(n + docStoreOffset);
+            docStream = chunkStream;
+            docStream->seek(offset);
+        }
+        else
+        {
+            seekIndex(n);
+            int64_t position = indexStream->readLong();
+            fieldsStream->seek(position);
+            docStream = fieldsStream;
+        }
         
         DocumentPtr doc(newLucene<Document>());
-        int32_t numFields = fieldsStream->readVInt();
+        int32_t numFields = docStream->readVInt();
         for (int32_t i = 0; i < numFields; ++i)
         {
-            int32_t fieldNumber = fieldsStream->readVInt();
+            int32_t fieldNumber = docStream->readVInt();
             FieldInfoPtr fi = fieldInfos->fieldInfo(fieldNumber);
             FieldSelector::FieldSelectorResult acceptField = fieldSelector ? fieldSelector->accept(fi->name) : FieldSelector::SELECTOR_LOAD;
             
-            uint8_t bits = fieldsStream->readByte();
+            uint8_t bits = docStream->readByte();
             BOOST_ASSERT(bits <= FieldsWriter::FIELD_IS_COMPRESSED + FieldsWriter::FIELD_IS_TOKENIZED + FieldsWriter::FIELD_IS_BINARY);
             
             bool compressed = ((bits & FieldsWriter::FIELD_IS_COMPRESSED) != 0);
@@ -221,6 +304,22 @@ namespace Lucene
     
     IndexInputPtr FieldsReader::rawDocs(Collection<int32_t> lengths, int32_t startDocID, int32_t numDocs)
     {
+        if (format >= FieldsWriter::FORMAT_COMPRESSED_CHUNKS)
+        {
+            // gather the documents, decompressed, into one stream; the writer compresses them into its own chunks
+            RAMFilePtr file(newLucene<RAMFile>());
+            RAMOutputStreamPtr out(newLucene<RAMOutputStream>(file));
+            for (int32_t i = 0; i < numDocs; ++i)
+            {
+                int32_t docID = docStoreOffset + startDocID + i;
+                int32_t offset = loadChunk(docID);
+                lengths[i] = chunkOffsets[docID - chunkDocs[currentChunk] + 1] - offset;
+                out->writeBytes(chunkBytes.get(), offset, lengths[i]);
+            }
+            out->flush();
+            return newLucene<RAMInputStream>(file);
+        }
+        
         seekIndex(startDocID);
         int64_t startOffset = indexStream->readLong();
         int64_t lastOffset = startOffset;
@@ -241,28 +340,35 @@ namespace Lucene
     
     void FieldsReader::skipField(bool binary, bool compressed)
     {
-        skipField(binary, compressed, fieldsStream->readVInt());
+        skipField(binary, compressed, docStream->readVInt());
     }
     
     void FieldsReader::skipField(bool binary, bool compressed, int32_t toRead)
     {
         if (format >= FieldsWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES || binary || compressed)
-            fieldsStream->seek(fieldsStream->getFilePointer() + toRead);
+            docStream->seek(docStream->getFilePointer() + toRead);
         else
         {
             // We need to skip chars.  This will slow us down, but still better
-            fieldsStream->skipChars(toRead);
+            docStream->skipChars(toRead);
         }
     }
     
     void FieldsReader::addFieldLazy(DocumentPtr doc, FieldInfoPtr fi, bool binary, bool compressed, bool tokenize)
     {
+        // a lazy field of a compressed document reads from its own view of the chunk
+        IndexInputPtr lazyStream;
+        if (docStream == chunkStream)
+            lazyStream = boost::dynamic_pointer_cast<IndexInput>(chunkStream->clone());
+        
         if (binary)
         {
-            int32_t toRead = fieldsStream->readVInt();
-            int64_t pointer = fieldsStream->getFilePointer();
-            doc->add(newLucene<LazyField>(shared_from_this(), fi->name, Field::STORE_YES, toRead, pointer, binary, compressed));
-            fieldsStream->seek(pointer + toRead);
+            int32_t toRead = docStream->readVInt();
+            int64_t pointer = docStream->getFilePointer();
+            LazyFieldPtr f(newLucene<LazyField>(shared_from_this(), fi->name, Field::STORE_YES, toRead, pointer, binary, compressed));
+            f->chunkStream = lazyStream;
+            doc->add(f);
+            docStream->seek(pointer + toRead);
         }
         else
         {
@@ -273,24 +379,26 @@ namespace Lucene
             AbstractFieldPtr f;
             if (compressed)
             {
-                int32_t toRead = fieldsStream->readVInt();
-                int64_t pointer = fieldsStream->getFilePointer();
+                int32_t toRead = docStream->readVInt();
+                int64_t pointer = docStream->getFilePointer();
                 f = newLucene<LazyField>(shared_from_this(), fi->name, store, toRead, pointer, binary, compressed);
                 // skip over the part that we aren't loading
-                fieldsStream->seek(pointer + toRead);
+                docStream->seek(pointer + toRead);
                 f->setOmitNorms(fi->omitNorms);
                 f->setOmitTermFreqAndPositions(fi->omitTermFreqAndPositions);
             }
             else
             {
-                int32_t length = fieldsStream->readVInt();
-                int64_t pointer = fieldsStream->getFilePointer();
+                int32_t length = docStream->readVInt();
+                int64_t pointer = docStream->getFilePointer();
                 // skip ahead of where we are by the length of what is stored
                 if (format >= FieldsWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES)
-                    fieldsStream->seek(pointer + length);
+                    docStream->seek(pointer + length);
                 else
-                    fieldsStream->skipChars(length);
-                f = newLucene<LazyField>(shared_from_this(), fi->name, store, index, termVector, length, pointer, binary, compressed);
+                    docStream->skipChars(length);
+                LazyFieldPtr lazyField(newLucene<LazyField>(shared_from_this(), fi->name, store, index, termVector, length, pointer, binary, compressed));
+                lazyField->chunkStream = lazyStream;
+                f = lazyField;
                 f->setOmitNorms(fi->omitNorms);
                 f->setOmitTermFreqAndPositions(fi->omitTermFreqAndPositions);
             }
@@ -304,9 +412,9 @@ namespace Lucene
         // we have a binary stored field, and it may be compressed
         if (binary)
         {
-            int32_t toRead = fieldsStream->readVInt();
+            int32_t toRead = docStream->readVInt();
             ByteArray b(ByteArray::newInstance(toRead));
-            fieldsStream->readBytes(b.get(), 0, b.size());
+            docStream->readBytes(b.get(), 0, b.size());
             if (compressed)
                 doc->add(newLucene<Field>(fi->name, uncompress(b), Field::STORE_YES));
             else
@@ -321,17 +429,17 @@ namespace Lucene
             AbstractFieldPtr f;
             if (compressed)
             {
-                int32_t toRead = fieldsStream->readVInt();
+                int32_t toRead = docStream->readVInt();
                 
                 ByteArray b(ByteArray::newInstance(toRead));
-                fieldsStream->readBytes(b.get(), 0, b.size());
+                docStream->readBytes(b.get(), 0, b.size());
                 f = newLucene<Field>(fi->name, uncompressString(b), store, index, termVector);
                 f->setOmitTermFreqAndPositions(fi->omitTermFreqAndPositions);
                 f->setOmitNorms(fi->omitNorms);
             }
             else
             {
-                f = newLucene<Field>(fi->name, fieldsStream->readString(), store, index, termVector);
+                f = newLucene<Field>(fi->name, docStream->readString(), store, index, termVector);
                 f->setOmitTermFreqAndPositions(fi->omitTermFreqAndPositions);
                 f->setOmitNorms(fi->omitNorms);
             }
@@ -342,7 +450,7 @@ namespace Lucene
     
     int32_t FieldsReader::addFieldSize(DocumentPtr doc, FieldInfoPtr fi, bool binary, bool compressed)
     {
-        int32_t size = fieldsStream->readVInt();
+        int32_t size = docStream->readVInt();
         int32_t bytesize = (binary || compressed) ? size : 2 * size;
         ByteArray sizebytes(ByteArray::newInstance(4));
         sizebytes[0] = (uint8_t)MiscUtils::unsignedShift(bytesize, 24);
@@ -411,6 +519,8 @@ namespace Lucene
     
     IndexInputPtr LazyField::getFieldStream()
     {
+        if (chunkStream)
+            return chunkStream;
         FieldsReaderPtr reader(_reader);
         IndexInputPtr localFieldsStream = reader->fieldsStreamTL.get();
         if (!localFieldsStream)
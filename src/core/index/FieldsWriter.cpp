@@ -10,11 +10,16 @@
 #include "Directory.h"
 #include "IndexOutput.h"
 #include "RAMOutputStream.h"
+#include "RAMInputStream.h"
+#include "RAMFile.h"
 #include "FieldInfo.h"
 #include "FieldInfos.h"
 #include "Fieldable.h"
 #include "Document.h"
 #include "TestPoint.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "LZ4.h"
+#include "MiscUtils.h"
 
 namespace Lucene
 {
@@ -25,21 +30,27 @@ namespace Lucene
     const int32_t FieldsWriter::FORMAT = 0; // Original format
     const int32_t FieldsWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES = 1; // Changed strings to UTF8
     const int32_t FieldsWriter::FORMAT_LUCENE_3_0_NO_COMPRESSED_FIELDS = 2; // Lucene 3.0: Removal of compressed fields
+    const int32_t FieldsWriter::FORMAT_COMPRESSED_CHUNKS = 3; // Documents compressed together in chunks
 
     // NOTE: if you introduce a new format, make it 1 higher than the current one, and always change this if you 
     // switch to a new format!
-    const int32_t FieldsWriter::FORMAT_CURRENT = FieldsWriter::FORMAT_LUCENE_3_0_NO_COMPRESSED_FIELDS;
+    const int32_t FieldsWriter::FORMAT_CURRENT = FieldsWriter::FORMAT_COMPRESSED_CHUNKS;
+    
+    const int32_t FieldsWriter::CHUNK_SIZE = 16384;
+    const int32_t FieldsWriter::MAX_DOCUMENTS_PER_CHUNK = 128;
 
     FieldsWriter::FieldsWriter(DirectoryPtr d, const String& segment, FieldInfosPtr fn)
     {
         fieldInfos = fn;
+        docStart = 0;
+        numDocs = 0;
         
         bool success = false;
         String fieldsName(segment + L"." + IndexFileNames::FIELDS_EXTENSION());
         LuceneException finally;
         try
         {
-            fieldsStream = d->createOutput(fieldsName);
+            fieldsStream = newLucene<ChecksumFooterIndexOutput>(d->createOutput(fieldsName));
             fieldsStream->writeInt(FORMAT_CURRENT);
             success = true;
         }
@@ -65,7 +76,7 @@ namespace Lucene
         String indexName(segment + L"." + IndexFileNames::FIELDS_INDEX_EXTENSION());
         try
         {
-            indexStream = d->createOutput(indexName);
+            indexStream = newLucene<ChecksumFooterIndexOutput>(d->createOutput(indexName));
             indexStream->writeInt(FORMAT_CURRENT);
             success = true;
         }
@@ -97,6 +108,8 @@ namespace Lucene
         fieldsStream = fdt;
         indexStream = fdx;
         doClose = false;
+        docStart = 0;
+        numDocs = 0;
     }
     
     FieldsWriter::~FieldsWriter()
@@ -111,19 +124,78 @@ namespace Lucene
     void FieldsWriter::flushDocument(int32_t numStoredFields, RAMOutputStreamPtr buffer)
     {
         TestScope testScope(L"FieldsWriter", L"flushDocument");
-        indexStream->writeLong(fieldsStream->getFilePointer());
-        fieldsStream->writeVInt(numStoredFields);
-        buffer->writeTo(fieldsStream);
+        IndexOutputPtr out(startDocument());
+        out->writeVInt(numStoredFields);
+        buffer->writeTo(out);
+        finishDocument();
+    }
+    
+    int32_t FieldsWriter::getNumDocs()
+    {
+        return numDocs;
     }
 
     void FieldsWriter::skipDocument()
     {
-        indexStream->writeLong(fieldsStream->getFilePointer());
-        fieldsStream->writeVInt(0);
+        startDocument()->writeVInt(0);
+        finishDocument();
+    }
+    
+    IndexOutputPtr FieldsWriter::startDocument()
+    {
+        if (!chunkBuffer)
+        {
+            chunkFile = newLucene<RAMFile>();
+            chunkBuffer = newLucene<RAMOutputStream>(chunkFile);
+            chunkDocLengths = Collection<int32_t>::newInstance();
+            compressor = newLucene<LZ4>();
+        }
+        docStart = chunkBuffer->getFilePointer();
+        return chunkBuffer;
+    }
+    
+    void FieldsWriter::finishDocument()
+    {
+        chunkDocLengths.add((int32_t)(chunkBuffer->getFilePointer() - docStart));
+        ++numDocs;
+        if (chunkBuffer->getFilePointer() >= CHUNK_SIZE || chunkDocLengths.size() >= MAX_DOCUMENTS_PER_CHUNK)
+            flushChunk();
+    }
+    
+    void FieldsWriter::flushChunk()
+    {
+        TestScope testScope(L"FieldsWriter", L"flushChunk");
+        int32_t numChunkDocs = chunkDocLengths.size();
+        if (numChunkDocs == 0)
+            return;
+        
+        int64_t start = fieldsStream->getFilePointer();
+        fieldsStream->writeVInt(numChunkDocs);
+        for (Collection<int32_t>::iterator length = chunkDocLengths.begin(); length != chunkDocLengths.end(); ++length)
+            fieldsStream->writeVInt(*length);
+        
+        chunkBuffer->flush();
+        int32_t length = (int32_t)chunkFile->getLength();
+        if (!chunkBytes || chunkBytes.size() < length)
+            chunkBytes = ByteArray::newInstance(MiscUtils::getNextSize(length));
+        RAMInputStreamPtr chunkInput(newLucene<RAMInputStream>(chunkFile));
+        chunkInput->readBytes(chunkBytes.get(), 0, length);
+        chunkInput->close();
+        compressor->compress(chunkBytes.get(), 0, length, fieldsStream);
+        
+        indexStream->writeVInt(numChunkDocs);
+        indexStream->writeVLong(fieldsStream->getFilePointer() - start);
+        
+        chunkBuffer->reset();
+        chunkDocLengths.clear();
     }
     
     void FieldsWriter::flush()
     {
+        // a flushed segment may share these files with later ones, so its documents must not be left 
+        // in the chunk buffer where an abort of the later ones would lose them
+        if (chunkBuffer)
+            flushChunk();
         indexStream->flush();
         fieldsStream->flush();
     }
@@ -133,45 +205,71 @@ namespace Lucene
         if (doClose)
         {
             LuceneException finally;
+            try
+            {
+                if (chunkBuffer && fieldsStream && indexStream)
+                    flushChunk();
+            }
+            catch (LuceneException& e)
+            {
+                finally = e;
+            }
+            // a stream whose close failed is kept, so closing again (eg. on abort) retries writing its footer
             if (fieldsStream)
             {
                 try
                 {
                     fieldsStream->close();
+                    fieldsStream.reset();
                 }
                 catch (LuceneException& e)
                 {
-                    finally = e;
+                    if (finally.isNull()) // throw first exception hit
+                        finally = e;
                 }
-                fieldsStream.reset();
             }
             if (indexStream)
             {
                 try
                 {
                     indexStream->close();
+                    indexStream.reset();
                 }
                 catch (LuceneException& e)
                 {
                     if (finally.isNull()) // throw first exception hit
                         finally = e;
                 }
-                indexStream.reset();
             }
             finally.throwException();
         }
     }
     
+    Collection<IndexOutputPtr> FieldsWriter::getOpenStreams()
+    {
+        Collection<IndexOutputPtr> streams(Collection<IndexOutputPtr>::newInstance());
+        if (fieldsStream)
+            streams.add(fieldsStream);
+        if (indexStream)
+            streams.add(indexStream);
+        return streams;
+    }
+    
     void FieldsWriter::writeField(FieldInfoPtr fi, FieldablePtr field)
     {
-        fieldsStream->writeVInt(fi->number);
+        writeField(fieldsStream, fi, field);
+    }
+    
+    void FieldsWriter::writeField(IndexOutputPtr out, FieldInfoPtr fi, FieldablePtr field)
+    {
+        out->writeVInt(fi->number);
         uint8_t bits = 0;
         if (field->isTokenized())
             bits |= FIELD_IS_TOKENIZED;
         if (field->isBinary())
             bits |= FIELD_IS_BINARY;
         
-        fieldsStream->writeByte(bits);
+        out->writeByte(bits);
         
         if (field->isBinary())
         {
@@ -179,29 +277,25 @@ namespace Lucene
             int32_t len = field->getBinaryLength();
             int32_t offset = field->getBinaryOffset();
             
-            fieldsStream->writeVInt(len);
-            fieldsStream->writeBytes(data.get(), offset, len);
+            out->writeVInt(len);
+            out->writeBytes(data.get(), offset, len);
         }
         else
-            fieldsStream->writeString(field->stringValue());
+            out->writeString(field->stringValue());
     }
     
     void FieldsWriter::addRawDocuments(IndexInputPtr stream, Collection<int32_t> lengths, int32_t numDocs)
     {
-        int64_t position = fieldsStream->getFilePointer();
-        int64_t start = position;
         for (int32_t i = 0; i < numDocs; ++i)
         {
-            indexStream->writeLong(position);
-            position += lengths[i];
+            startDocument()->copyBytes(stream, lengths[i]);
+            finishDocument();
         }
-        fieldsStream->copyBytes(stream, position - start);
-        BOOST_ASSERT(fieldsStream->getFilePointer() == position);
     }
     
     void FieldsWriter::addDocument(DocumentPtr doc)
     {
-        indexStream->writeLong(fieldsStream->getFilePointer());
+        IndexOutputPtr out(startDocument());
         
         int32_t storedCount = 0;
         Collection<FieldablePtr> fields(doc->getFields());
@@ -210,12 +304,14 @@ namespace Lucene
             if ((*field)->isStored())
                 ++storedCount;
         }
-        fieldsStream->writeVInt(storedCount);
+        out->writeVInt(storedCount);
         
         for (Collection<FieldablePtr>::iterator field = fields.begin(); field != fields.end(); ++field)
         {
             if ((*field)->isStored())
-                writeField(fieldInfos->fieldInfo((*field)->name()), *field);
+                writeField(out, fieldInfos->fieldInfo((*field)->name()), *field);
         }
+        
+        finishDocument();
     }
 }
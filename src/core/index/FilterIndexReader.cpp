@@ -89,6 +89,24 @@ namespace Lucene
         return in->hasNorms(field);
     }
     
+    NumericDocValuesPtr FilterIndexReader::getNumericDocValues(const String& field)
+    {
+        ensureOpen();
+        return in->getNumericDocValues(field);
+    }
+    
+    BinaryDocValuesPtr FilterIndexReader::getBinaryDocValues(const String& field)
+    {
+        ensureOpen();
+        return in->getBinaryDocValues(field);
+    }
+    
+    SortedDocValuesPtr FilterIndexReader::getSortedDocValues(const String& field)
+    {
+        ensureOpen();
+        return in->getSortedDocValues(field);
+    }
+    
     ByteArray FilterIndexReader::norms(const String& field)
     {
         ensureOpen();
@@ -101,6 +119,12 @@ namespace Lucene
         in->norms(field, norms, offset);
     }
     
+    NormValuesPtr FilterIndexReader::normValues(const String& field)
+    {
+        ensureOpen();
+        return in->normValues(field);
+    }
+    
     void FilterIndexReader::doSetNorm(int32_t doc, const String& field, uint8_t value)
     {
         in->setNorm(doc, field, value);
@@ -124,6 +148,12 @@ namespace Lucene
         return in->docFreq(t);
     }
     
+    Collection<int32_t> FilterIndexReader::docFreqs(Collection<TermPtr> terms)
+    {
+        ensureOpen();
+        return in->docFreqs(terms);
+    }
+    
     TermDocsPtr FilterIndexReader::termDocs()
     {
         ensureOpen();
@@ -244,6 +274,11 @@ namespace Lucene
         return in->skipTo(target);
     }
     
+    int32_t FilterTermDocs::advanceShallow(int32_t target, int32_t& maxFreq, int32_t& maxNorm)
+    {
+        return in->advanceShallow(target, maxFreq, maxNorm);
+    }
+    
     void FilterTermDocs::close()
     {
         in->close();
@@ -20,6 +20,9 @@
 #include "MiscUtils.h"
 #include "UnicodeUtils.h"
 #include "StringUtils.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "BlockPackedInts.h"
+#include "NormValues.h"
 
 namespace Lucene
 {
@@ -30,19 +33,30 @@ namespace Lucene
         this->omitTermFreqAndPositions = false;
         this->storePayloads = false;
         this->freqStart = 0;
+        this->blockMaxFreq = 0;
+        this->blockMaxNorm = 0;
         
         FormatPostingsFieldsWriterPtr parentPostings(parent->_parent);
         this->_parent = parent;
         this->state = state;
         String fileName(IndexFileNames::segmentFileName(parentPostings->segment, IndexFileNames::FREQ_EXTENSION()));
         state->flushedFiles.add(fileName);
-        out = parentPostings->dir->createOutput(fileName);
+        out = newLucene<ChecksumFooterIndexOutput>(parentPostings->dir->createOutput(fileName));
         totalNumDocs = parentPostings->totalNumDocs;
         
         skipInterval = parentPostings->termsOut->skipInterval;
         skipListWriter = parentPostings->skipListWriter;
         skipListWriter->setFreqOutput(out);
         
+        postingsFormat = parentPostings->termsOut->postingsFormat;
+        bufferCount = 0;
+        if (postingsFormat == TermInfosWriter::POSTINGS_FORMAT_BLOCK_PACKED)
+        {
+            blockPacker = newLucene<BlockPackedInts>();
+            docDeltaBuffer = IntArray::newInstance(BlockPackedInts::BLOCK_SIZE);
+            freqBuffer = IntArray::newInstance(BlockPackedInts::BLOCK_SIZE);
+        }
+        
         termInfo = newLucene<TermInfo>();
         utf8 = newLucene<UTF8Result>();
     }
@@ -62,6 +76,10 @@ namespace Lucene
         omitTermFreqAndPositions = fieldInfo->omitTermFreqAndPositions;
         storePayloads = fieldInfo->storePayloads;
         posWriter->setField(fieldInfo);
+        
+        // the norms were written before the postings, so skip entries can bound the norms of the docs they skip
+        norms = fieldInfo->omitNorms ? NormValuesPtr() : state->fieldNorms.get(fieldInfo->name);
+        skipListWriter->setStoreImpacts(!omitTermFreqAndPositions, !fieldInfo->omitNorms);
     }
     
     FormatPostingsPositionsConsumerPtr FormatPostingsDocsWriter::addDoc(int32_t docID, int32_t termDocFreq)
@@ -71,14 +89,41 @@ namespace Lucene
         if (docID < 0 || (df > 0 && delta <= 0))
             boost::throw_exception(CorruptIndexException(L"docs out of order (" + StringUtils::toString(docID) + L" <= " + StringUtils::toString(lastDocID) + L" )"));
         
+        if (blockPacker)
+        {
+            // skip points sit on block boundaries, after the last doc of each full block
+            if (df > 0 && (df % skipInterval) == 0)
+            {
+                skipListWriter->setSkipData(lastDocID, storePayloads, posWriter->lastPayloadLength, blockMaxFreq, blockMaxNorm);
+                skipListWriter->bufferSkip(df);
+                blockMaxFreq = 0;
+                blockMaxNorm = 0;
+            }
+            
+            BOOST_ASSERT(docID < totalNumDocs);
+            
+            addImpact(docID, termDocFreq);
+            ++df;
+            lastDocID = docID;
+            docDeltaBuffer[bufferCount] = delta;
+            freqBuffer[bufferCount] = termDocFreq - 1;
+            if (++bufferCount == BlockPackedInts::BLOCK_SIZE)
+                flushBlock();
+            
+            return posWriter;
+        }
+        
         if ((++df % skipInterval) == 0)
         {
-            skipListWriter->setSkipData(lastDocID, storePayloads, posWriter->lastPayloadLength);
+            skipListWriter->setSkipData(lastDocID, storePayloads, posWriter->lastPayloadLength, blockMaxFreq, blockMaxNorm);
             skipListWriter->bufferSkip(df);
+            blockMaxFreq = 0;
+            blockMaxNorm = 0;
         }
         
         BOOST_ASSERT(docID < totalNumDocs);
         
+        addImpact(docID, termDocFreq);
         lastDocID = docID;
         if (omitTermFreqAndPositions)
             out->writeVInt(delta);
@@ -93,8 +138,42 @@ namespace Lucene
         return posWriter;
     }
     
+    void FormatPostingsDocsWriter::addImpact(int32_t docID, int32_t termDocFreq)
+    {
+        blockMaxFreq = std::max(blockMaxFreq, termDocFreq);
+        // without the norms of the field, no norm can be ruled out
+        blockMaxNorm = std::max(blockMaxNorm, norms ? (int32_t)norms->get(docID) : 0xff);
+    }
+    
+    void FormatPostingsDocsWriter::flushBlock()
+    {
+        blockPacker->writeBlock(out, docDeltaBuffer.get());
+        if (!omitTermFreqAndPositions)
+            blockPacker->writeBlock(out, freqBuffer.get());
+        bufferCount = 0;
+    }
+    
+    void FormatPostingsDocsWriter::flushTail()
+    {
+        for (int32_t i = 0; i < bufferCount; ++i)
+        {
+            if (omitTermFreqAndPositions)
+                out->writeVInt(docDeltaBuffer[i]);
+            else if (freqBuffer[i] == 0)
+                out->writeVInt((docDeltaBuffer[i] << 1) | 1);
+            else
+            {
+                out->writeVInt(docDeltaBuffer[i] << 1);
+                out->writeVInt(freqBuffer[i] + 1);
+            }
+        }
+        bufferCount = 0;
+    }
+    
     void FormatPostingsDocsWriter::finish()
     {
+        if (blockPacker)
+            flushTail();
         int64_t skipPointer = skipListWriter->writeSkip(out);
         FormatPostingsTermsWriterPtr parent(_parent);
         termInfo->set(df, parent->freqStart, parent->proxStart, (int32_t)(skipPointer - parent->freqStart));
@@ -106,6 +185,8 @@ namespace Lucene
         
         lastDocID = 0;
         df = 0;
+        blockMaxFreq = 0;
+        blockMaxNorm = 0;
     }
     
     void FormatPostingsDocsWriter::close()
@@ -11,6 +11,7 @@
 #include "TermInfosWriter.h"
 #include "IndexFileNames.h"
 #include "DefaultSkipListWriter.h"
+#include "FieldInfos.h"
 
 namespace Lucene
 {
@@ -21,12 +22,14 @@ namespace Lucene
         totalNumDocs = state->numDocs;
         this->state = state;
         this->fieldInfos = fieldInfos;
-        termsOut = newLucene<TermInfosWriter>(dir, segment, fieldInfos, state->termIndexInterval);
+        termsOut = newLucene<TermInfosWriter>(dir, segment, fieldInfos, state->termIndexInterval, state->postingsFormat);
 
         skipListWriter = newLucene<DefaultSkipListWriter>(termsOut->skipInterval, termsOut->maxSkipLevels, totalNumDocs, IndexOutputPtr(), IndexOutputPtr());
 
         state->flushedFiles.add(state->segmentFileName(IndexFileNames::TERMS_EXTENSION()));
         state->flushedFiles.add(state->segmentFileName(IndexFileNames::TERMS_INDEX_EXTENSION()));
+        if (fieldInfos->hasBloomFilters())
+            state->flushedFiles.add(state->segmentFileName(IndexFileNames::BLOOM_FILTER_EXTENSION()));
     }
     
     FormatPostingsFieldsWriter::~FormatPostingsFieldsWriter()
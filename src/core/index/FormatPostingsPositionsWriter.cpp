@@ -16,6 +16,7 @@
 #include "Directory.h"
 #include "DefaultSkipListWriter.h"
 #include "IndexOutput.h"
+#include "ChecksumFooterIndexOutput.h"
 
 namespace Lucene
 {
@@ -35,7 +36,7 @@ namespace Lucene
             // At least one field does not omit TF, so create the prox file
             String fileName(IndexFileNames::segmentFileName(parentFieldsWriter->segment, IndexFileNames::PROX_EXTENSION()));
             state->flushedFiles.add(fileName);
-            out = parentFieldsWriter->dir->createOutput(fileName);
+            out = newLucene<ChecksumFooterIndexOutput>(parentFieldsWriter->dir->createOutput(fileName));
             parent->skipListWriter->setProxOutput(out);
         }
         else
@@ -15,7 +15,8 @@
 #include "TermsHashPerThread.h"
 #include "FormatPostingsDocsConsumer.h"
 #include "FormatPostingsFieldsConsumer.h"
-#include "FormatPostingsFieldsWriter.h"
+#include "SegmentWriteState.h"
+#include "Codec.h"
 #include "FormatPostingsTermsConsumer.h"
 #include "FormatPostingsPositionsConsumer.h"
 #include "FieldInfo.h"
@@ -91,7 +92,7 @@ namespace Lucene
         
         int32_t numAllFields = allFields.size();
         
-        FormatPostingsFieldsConsumerPtr consumer(newLucene<FormatPostingsFieldsWriter>(state, fieldInfos));
+        FormatPostingsFieldsConsumerPtr consumer(state->codec->fieldsConsumer(state, fieldInfos));
         
         // Current writer chain:
         // FormatPostingsFieldsConsumer
@@ -40,6 +40,18 @@ namespace Lucene
         return _NORMS_EXTENSION;
     }
     
+    const String& IndexFileNames::DOC_VALUES_EXTENSION()
+    {
+        static String _DOC_VALUES_EXTENSION(L"dv");
+        return _DOC_VALUES_EXTENSION;
+    }
+    
+    const String& IndexFileNames::BLOOM_FILTER_EXTENSION()
+    {
+        static String _BLOOM_FILTER_EXTENSION(L"blm");
+        return _BLOOM_FILTER_EXTENSION;
+    }
+    
     const String& IndexFileNames::FREQ_EXTENSION()
     {
         static String _FREQ_EXTENSION(L"frq");
@@ -156,6 +168,8 @@ namespace Lucene
             _INDEX_EXTENSIONS.add(VECTORS_FIELDS_EXTENSION());
             _INDEX_EXTENSIONS.add(GEN_EXTENSION());
             _INDEX_EXTENSIONS.add(NORMS_EXTENSION());
+            _INDEX_EXTENSIONS.add(DOC_VALUES_EXTENSION());
+            _INDEX_EXTENSIONS.add(BLOOM_FILTER_EXTENSION());
             _INDEX_EXTENSIONS.add(COMPOUND_FILE_STORE_EXTENSION());
         }
         return _INDEX_EXTENSIONS;
@@ -178,6 +192,8 @@ namespace Lucene
             _INDEX_EXTENSIONS_IN_COMPOUND_FILE.add(VECTORS_DOCUMENTS_EXTENSION());
             _INDEX_EXTENSIONS_IN_COMPOUND_FILE.add(VECTORS_FIELDS_EXTENSION());
             _INDEX_EXTENSIONS_IN_COMPOUND_FILE.add(NORMS_EXTENSION());
+            _INDEX_EXTENSIONS_IN_COMPOUND_FILE.add(DOC_VALUES_EXTENSION());
+            _INDEX_EXTENSIONS_IN_COMPOUND_FILE.add(BLOOM_FILTER_EXTENSION());
         }
         return _INDEX_EXTENSIONS_IN_COMPOUND_FILE;
     };
@@ -209,6 +225,8 @@ namespace Lucene
             _NON_STORE_INDEX_EXTENSIONS.add(TERMS_EXTENSION());
             _NON_STORE_INDEX_EXTENSIONS.add(TERMS_INDEX_EXTENSION());
             _NON_STORE_INDEX_EXTENSIONS.add(NORMS_EXTENSION());
+            _NON_STORE_INDEX_EXTENSIONS.add(DOC_VALUES_EXTENSION());
+            _NON_STORE_INDEX_EXTENSIONS.add(BLOOM_FILTER_EXTENSION());
         }
         return _NON_STORE_INDEX_EXTENSIONS;
     };
@@ -12,9 +12,11 @@
 #include "DirectoryReader.h"
 #include "IndexDeletionPolicy.h"
 #include "FSDirectory.h"
+#include "DirectoryWarmer.h"
 #include "FieldSelector.h"
 #include "Similarity.h"
 #include "CompoundFileReader.h"
+#include "_NormValues.h"
 #include "FileUtils.h"
 #include "StringUtils.h"
 
@@ -76,6 +78,27 @@ namespace Lucene
         return open(directory, IndexDeletionPolicyPtr(), IndexCommitPtr(), readOnly, DEFAULT_TERMS_INDEX_DIVISOR);
     }
     
+    IndexReaderPtr IndexReader::open(DirectoryPtr directory, bool readOnly, DirectoryWarmerPtr warmer)
+    {
+        IndexReaderPtr reader(open(directory, readOnly));
+        if (warmer)
+        {
+            LuceneException finally;
+            try
+            {
+                warmer->warm(reader->getIndexCommit());
+            }
+            catch (LuceneException& e)
+            {
+                finally = e;
+            }
+            if (!finally.isNull())
+                reader->close();
+            finally.throwException();
+        }
+        return reader;
+    }
+    
     IndexReaderPtr IndexReader::open(IndexCommitPtr commit, bool readOnly)
     {
         return open(commit->getDirectory(), IndexDeletionPolicyPtr(), commit, readOnly, DEFAULT_TERMS_INDEX_DIVISOR);
@@ -218,6 +241,30 @@ namespace Lucene
         return norms(field);
     }
     
+    NormValuesPtr IndexReader::normValues(const String& field)
+    {
+        ensureOpen();
+        return NormValues::fromBytes(norms(field));
+    }
+    
+    NumericDocValuesPtr IndexReader::getNumericDocValues(const String& field)
+    {
+        ensureOpen();
+        return NumericDocValuesPtr();
+    }
+    
+    BinaryDocValuesPtr IndexReader::getBinaryDocValues(const String& field)
+    {
+        ensureOpen();
+        return BinaryDocValuesPtr();
+    }
+    
+    SortedDocValuesPtr IndexReader::getSortedDocValues(const String& field)
+    {
+        ensureOpen();
+        return SortedDocValuesPtr();
+    }
+    
     void IndexReader::setNorm(int32_t doc, const String& field, uint8_t value)
     {
         SyncLock syncLock(this);
@@ -241,6 +288,14 @@ namespace Lucene
         return _termDocs;
     }
     
+    Collection<int32_t> IndexReader::docFreqs(Collection<TermPtr> terms)
+    {
+        Collection<int32_t> result(Collection<int32_t>::newInstance(terms.size()));
+        for (int32_t i = 0; i < terms.size(); ++i)
+            result[i] = docFreq(terms[i]);
+        return result;
+    }
+    
     TermPositionsPtr IndexReader::termPositions(TermPtr term)
     {
         ensureOpen();
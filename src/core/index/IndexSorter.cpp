@@ -0,0 +1,139 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include <boost/algorithm/string.hpp>
+#include "IndexSorter.h"
+#include "IndexReader.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "FieldComparator.h"
+
+namespace Lucene
+{
+    /// Orders slots by the comparators of a sort, each with its own direction.
+    struct lessSortSlot
+    {
+        lessSortSlot(Collection<FieldComparatorPtr> comparators, Collection<int32_t> reverseMul)
+        {
+            this->comparators = comparators;
+            this->reverseMul = reverseMul;
+        }
+        
+        inline bool operator()(int32_t first, int32_t second) const
+        {
+            for (int32_t i = 0; i < comparators.size(); ++i)
+            {
+                int32_t c = reverseMul[i] * comparators[i]->compare(first, second);
+                if (c != 0)
+                    return (c < 0);
+            }
+            return false;
+        }
+        
+        Collection<FieldComparatorPtr> comparators;
+        Collection<int32_t> reverseMul;
+    };
+    
+    IndexSorter::~IndexSorter()
+    {
+    }
+    
+    String IndexSorter::describe(SortPtr sort)
+    {
+        if (!sort || sort->getSort().empty())
+            boost::throw_exception(IllegalArgumentException(L"index sort must have at least one field"));
+        Collection<SortFieldPtr> fields(sort->getSort());
+        String description;
+        for (Collection<SortFieldPtr>::iterator field = fields.begin(); field != fields.end(); ++field)
+        {
+            String fieldDescription(describe(*field));
+            if (fieldDescription.empty())
+                boost::throw_exception(IllegalArgumentException(L"cannot sort the index by " + (*field)->toString()));
+            if (!description.empty())
+                description += L",";
+            description += fieldDescription;
+        }
+        return description;
+    }
+    
+    String IndexSorter::describe(SortFieldPtr field)
+    {
+        // a segment's order must be reproducible from its description alone
+        int32_t type = field->getType();
+        if (type == SortField::SCORE || type == SortField::CUSTOM || field->getParser() || field->getLocale())
+            return L"";
+        return field->toString();
+    }
+    
+    bool IndexSorter::sortedBy(const String& segmentSort, SortPtr sort)
+    {
+        if (segmentSort.empty() || !sort)
+            return false;
+        Collection<SortFieldPtr> fields(sort->getSort());
+        String description;
+        for (Collection<SortFieldPtr>::iterator field = fields.begin(); field != fields.end(); ++field)
+        {
+            String fieldDescription(describe(*field));
+            if (fieldDescription.empty())
+                return false;
+            if (!description.empty())
+                description += L",";
+            description += fieldDescription;
+        }
+        if (!boost::starts_with(segmentSort, description))
+            return false;
+        return (segmentSort.length() == description.length() || segmentSort[description.length()] == L',');
+    }
+    
+    Collection<int32_t> IndexSorter::sort(SortPtr sort, Collection<IndexReaderPtr> readers)
+    {
+        int32_t numDocs = 0;
+        for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
+            numDocs += (*reader)->numDocs();
+        
+        Collection<SortFieldPtr> fields(sort->getSort());
+        Collection<FieldComparatorPtr> comparators(Collection<FieldComparatorPtr>::newInstance(fields.size()));
+        Collection<int32_t> reverseMul(Collection<int32_t>::newInstance(fields.size()));
+        for (int32_t i = 0; i < fields.size(); ++i)
+        {
+            comparators[i] = fields[i]->getComparator(numDocs, i);
+            reverseMul[i] = fields[i]->getReverse() ? -1 : 1;
+        }
+        
+        // copy the sort values of each document that is not deleted into its own slot
+        int32_t slot = 0;
+        int32_t docBase = 0;
+        for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
+        {
+            for (Collection<FieldComparatorPtr>::iterator comparator = comparators.begin(); comparator != comparators.end(); ++comparator)
+                (*comparator)->setNextReader(*reader, docBase);
+            int32_t maxDoc = (*reader)->maxDoc();
+            bool hasDeletions = (*reader)->hasDeletions();
+            for (int32_t doc = 0; doc < maxDoc; ++doc)
+            {
+                if (hasDeletions && (*reader)->isDeleted(doc))
+                    continue;
+                for (Collection<FieldComparatorPtr>::iterator comparator = comparators.begin(); comparator != comparators.end(); ++comparator)
+                    (*comparator)->copy(slot, doc);
+                ++slot;
+            }
+            docBase += maxDoc;
+        }
+        
+        Collection<int32_t> docs(Collection<int32_t>::newInstance(numDocs));
+        for (int32_t i = 0; i < numDocs; ++i)
+            docs[i] = i;
+        std::stable_sort(docs.begin(), docs.end(), lessSortSlot(comparators, reverseMul));
+        
+        for (int32_t i = 0; i < numDocs; ++i)
+        {
+            if (docs[i] != i)
+                return docs;
+        }
+        return Collection<int32_t>(); // already in order
+    }
+}
@@ -23,12 +23,15 @@
 #include "Similarity.h"
 #include "ConcurrentMergeScheduler.h"
 #include "CompoundFileWriter.h"
+#include "CompoundStagingDirectory.h"
 #include "SegmentMerger.h"
 #include "DateTools.h"
 #include "Constants.h"
 #include "InfoStream.h"
 #include "TestPoint.h"
 #include "StringUtils.h"
+#include "Codec.h"
+#include "IndexSorter.h"
 
 namespace Lucene
 {
@@ -164,6 +167,9 @@ namespace Lucene
         mergeScheduler = newLucene<ConcurrentMergeScheduler>();
         similarity = Similarity::getDefault();
         termIndexInterval = DEFAULT_TERM_INDEX_INTERVAL;
+        checkIntegrityAtMerge = false;
+        useBlockPackedPostings = false;
+        codec = Codec::getDefault();
         commitLock  = newInstance<Synchronize>();
 
         if (!indexingChain)
@@ -472,6 +478,65 @@ namespace Lucene
         ensureOpen(false);
         return termIndexInterval;
     }
+    
+    void IndexWriter::setCheckIntegrityAtMerge(bool checkIntegrity)
+    {
+        ensureOpen();
+        this->checkIntegrityAtMerge = checkIntegrity;
+    }
+    
+    bool IndexWriter::getCheckIntegrityAtMerge()
+    {
+        ensureOpen(false);
+        return checkIntegrityAtMerge;
+    }
+    
+    void IndexWriter::setUseBlockPackedPostings(bool useBlockPackedPostings)
+    {
+        ensureOpen();
+        this->useBlockPackedPostings = useBlockPackedPostings;
+    }
+    
+    bool IndexWriter::getUseBlockPackedPostings()
+    {
+        ensureOpen(false);
+        return useBlockPackedPostings;
+    }
+    
+    void IndexWriter::setCodec(CodecPtr codec)
+    {
+        ensureOpen();
+        if (!codec)
+            boost::throw_exception(IllegalArgumentException(L"codec must not be null"));
+        if (codec == this->codec)
+            return;
+        flush(true, true, false);
+        docWriter->setCodec(codec);
+        this->codec = codec;
+    }
+    
+    CodecPtr IndexWriter::getCodec()
+    {
+        ensureOpen(false);
+        return codec;
+    }
+    
+    void IndexWriter::setIndexSort(SortPtr sort)
+    {
+        ensureOpen();
+        if (sort)
+            IndexSorter::describe(sort); // throws if the sort can't be recorded with a segment
+        if (sort == indexSort)
+            return;
+        flush(true, true, true);
+        indexSort = sort;
+    }
+    
+    SortPtr IndexWriter::getIndexSort()
+    {
+        ensureOpen(false);
+        return indexSort;
+    }
 
     void IndexWriter::setRollbackSegmentInfos(SegmentInfosPtr infos)
     {
@@ -882,7 +947,7 @@ namespace Lucene
             {
                 CompoundFileWriterPtr cfsWriter(newLucene<CompoundFileWriter>(directory, compoundFileName));
                 for (HashSet<String>::iterator file = closedFiles.begin(); file != closedFiles.end(); ++file)
-                    cfsWriter->addFile(*file);
+                    cfsWriter->addFile(*file, true);
                 
                 // Perform the merge
                 cfsWriter->close();
@@ -1575,6 +1640,15 @@ namespace Lucene
                 
                 docWriter->abort();
                 
+                // the segments that shared any doc store left open by the abort are gone, so just try to release it
+                try
+                {
+                    docWriter->closeUnclosedDocStoreOutputs();
+                }
+                catch (...)
+                {
+                }
+                
                 bool test = testPoint(L"rollback before checkpoint");
                 BOOST_ASSERT(test);
                 
@@ -2008,7 +2082,7 @@ namespace Lucene
                 {
                     SyncLock syncLock(this);
                     if (segmentInfos->size() == 1) // add existing index, if any
-                        sReader = readerPool->get(segmentInfos->info(0), true, BufferedIndexInput::BUFFER_SIZE, -1);
+                        sReader = readerPool->get(segmentInfos->info(0), true, BufferedIndexInput::BUFFER_SIZE, indexSort ? readerTermsIndexDivisor : -1);
                 }
                 
                 success = false;
@@ -2027,6 +2101,8 @@ namespace Lucene
                         SyncLock syncLock(this);
                         segmentInfos->clear(); // pop old infos & add new
                         info = newLucene<SegmentInfo>(mergedName, docCount, directory, false, true, -1, L"", false, merger->hasProx());
+                        info->setCodec(codec);
+                        info->setIndexSort(merger->getIndexSort());
                         setDiagnostics(info, L"addIndexes(Collection<IndexReaderPtr>)");
                         segmentInfos->add(info);
                     }
@@ -2287,6 +2363,14 @@ namespace Lucene
         if (docWriter->doApplyDeletes())
             flushDeletes = true;
         
+        // A flushed segment is rewritten in the order of the index sort, so it must own its doc stores and 
+        // have its deletes applied
+        if (indexSort)
+        {
+            flushDocStores = true;
+            flushDeletes = true;
+        }
+        
         // Make sure no threads are actively adding a document. Returns true if docWriter is currently aborting, in 
         // which case we skip flushing this segment
         if (infoStream)
@@ -2302,6 +2386,9 @@ namespace Lucene
         LuceneException finally;
         try
         {
+            // A doc store that failed to close during an abort may be shared by segments we are about to commit
+            docWriter->closeUnclosedDocStoreOutputs();
+            
             SegmentInfoPtr newSegment;
             
             int32_t numDocs = docWriter->getNumDocsInRAM();
@@ -2350,14 +2437,22 @@ namespace Lucene
             // If we are flushing docs, segment must not be null
             BOOST_ASSERT(!segment.empty() || !flushDocs);
             
+            bool useCompoundFile = false;
+            
             if (flushDocs)
             {
                 bool success = false;
                 int32_t flushedDocCount;
                 
+                // If the new segment will most likely be a compound file, keep its files in RAM until the 
+                // compound file is built instead of writing them out and reading them back
+                SegmentInfoPtr provisionalSegment(newLucene<SegmentInfo>(segment, docWriter->getNumDocsInRAM(), directory));
+                bool stageCompoundFile = (CompoundStagingDirectory::isWorthStaging(directory) && 
+                                          mergePolicy->useCompoundFile(segmentInfos, provisionalSegment));
+                
                 try
                 {
-                    flushedDocCount = docWriter->flush(flushDocStores);
+                    flushedDocCount = docWriter->flush(flushDocStores, stageCompoundFile);
                     if (infoStream)
                         message(L"flushedFiles=" + docWriter->getFlushedFiles());
                     success = true;
@@ -2389,6 +2484,7 @@ namespace Lucene
                 
                 // Create new SegmentInfo, but do not add to our segmentInfos until deletes are flushed successfully.
                 newSegment = newLucene<SegmentInfo>(segment, flushedDocCount, directory, false, true, docStoreOffset, docStoreSegment, docStoreIsCompoundFile, docWriter->hasProx());
+                newSegment->setCodec(docWriter->getCodec());
                 setDiagnostics(newSegment, L"flush");
             }
             
@@ -2397,10 +2493,16 @@ namespace Lucene
             if (flushDocs)
             {
                 segmentInfos->add(newSegment);
+                useCompoundFile = mergePolicy->useCompoundFile(segmentInfos, newSegment);
+                
+                // the segment stays as separate files, so any still held in RAM must be written out
+                if (!useCompoundFile)
+                    docWriter->writeStagedFiles();
+                
                 checkpoint();
             }
             
-            if (flushDocs && mergePolicy->useCompoundFile(segmentInfos, newSegment))
+            if (flushDocs && useCompoundFile)
             {
                 // Now build compound file
                 bool success = false;
@@ -2419,6 +2521,23 @@ namespace Lucene
                     if (infoStream)
                         message(L"hit exception creating compound file for newly flushed segment " + segment);
                     deleter->deleteFile(segment + L"." + IndexFileNames::COMPOUND_FILE_EXTENSION());
+                    
+                    // Keep the segment as separate files; if its staged files can't be written out either 
+                    // then the segment has to be dropped
+                    try
+                    {
+                        docWriter->writeStagedFiles();
+                        newSegment->setUseCompoundFile(false);
+                        checkpoint();
+                    }
+                    catch (LuceneException&)
+                    {
+                        if (infoStream)
+                            message(L"hit exception writing staged files; dropping newly flushed segment " + segment);
+                        segmentInfos->remove(segmentInfos->find(newSegment));
+                        checkpoint();
+                        deleter->refresh(segment);
+                    }
                 }
                 
                 finally.throwException();
@@ -2430,6 +2549,9 @@ namespace Lucene
             if (flushDeletes)
                 applyDeletes();
             
+            if (flushDocs && indexSort && segmentInfos->contains(newSegment))
+                sortFlushedSegment(newSegment);
+            
             if (flushDocs)
                 checkpoint();
             
@@ -2450,6 +2572,81 @@ namespace Lucene
         return flushDocs;
     }
     
+    void IndexWriter::sortFlushedSegment(SegmentInfoPtr info)
+    {
+        // the sort values are loaded through the field cache, which seeks the terms, so the terms index is needed
+        SegmentReaderPtr reader(readerPool->get(info, true, MERGE_READ_BUFFER_SIZE, readerTermsIndexDivisor, true));
+        Collection<int32_t> order;
+        LuceneException finally;
+        try
+        {
+            order = IndexSorter::sort(indexSort, newCollection<IndexReaderPtr>(reader));
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        if (!finally.isNull() || (!order && (!reader->hasDeletions() || reader->numDocs() == 0)))
+        {
+            readerPool->release(reader);
+            finally.throwException();
+            
+            // the documents were added in order, so the segment can be kept as it is
+            info->setIndexSort(IndexSorter::describe(indexSort));
+            return;
+        }
+        
+        // rewrite the segment with its documents in order, dropping those that are deleted
+        String sortedName(newSegmentName());
+        if (infoStream)
+            message(L"sort flushed segment " + info->name + L" into " + sortedName);
+        SegmentMergerPtr merger(newLucene<SegmentMerger>(shared_from_this(), sortedName, OneMergePtr()));
+        merger->add(reader);
+        
+        bool success = false;
+        try
+        {
+            int32_t docCount = merger->merge(true);
+            SegmentInfoPtr sortedInfo(newLucene<SegmentInfo>(sortedName, docCount, directory, false, true, -1, L"", false, merger->hasProx()));
+            sortedInfo->setCodec(codec);
+            sortedInfo->setIndexSort(merger->getIndexSort());
+            setDiagnostics(sortedInfo, L"flush");
+            
+            if (info->getUseCompoundFile())
+            {
+                merger->createCompoundFile(IndexFileNames::segmentFileName(sortedName, IndexFileNames::COMPOUND_FILE_EXTENSION()));
+                deleter->deleteNewFiles(merger->getMergedFiles());
+                sortedInfo->setUseCompoundFile(true);
+            }
+            
+            int32_t idx = segmentInfos->find(info);
+            segmentInfos->remove(idx);
+            segmentInfos->add(idx, sortedInfo);
+            
+            // the deleted documents were dropped from the flushed count
+            docWriter->updateFlushedDocCount(docCount - info->docCount);
+            success = true;
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        
+        if (!success)
+        {
+            // the unsorted segment is kept, along with the deletes applied to its reader
+            if (infoStream)
+                message(L"hit exception sorting flushed segment " + info->name);
+            readerPool->release(reader);
+            deleter->refresh(sortedName);
+            finally.throwException();
+        }
+        
+        // the deletes of the unsorted segment were dropped with it
+        readerPool->release(reader, true);
+        checkpoint();
+    }
+    
     int64_t IndexWriter::ramSizeInBytes()
     {
         ensureOpen();
@@ -2488,7 +2685,7 @@ namespace Lucene
         return first;
     }
     
-    void IndexWriter::commitMergedDeletes(OneMergePtr merge, SegmentReaderPtr mergeReader)
+    void IndexWriter::commitMergedDeletes(OneMergePtr merge, SegmentReaderPtr mergeReader, Collection<int32_t> sortDocMap)
     {
         SyncLock syncLock(this);
         BOOST_ASSERT(testPoint(L"startCommitMergeDeletes"));
@@ -2525,7 +2722,7 @@ namespace Lucene
                         {
                             if (currentReader->isDeleted(j))
                             {
-                                mergeReader->doDelete(docUpto);
+                                mergeReader->doDelete(sortDocMap ? sortDocMap[docUpto] : docUpto);
                                 ++delCount;
                             }
                             ++docUpto;
@@ -2542,7 +2739,7 @@ namespace Lucene
                 {
                     if (currentReader->isDeleted(j))
                     {
-                        mergeReader->doDelete(docUpto);
+                        mergeReader->doDelete(sortDocMap ? sortDocMap[docUpto] : docUpto);
                         ++delCount;
                     }
                     ++docUpto;
@@ -2585,7 +2782,7 @@ namespace Lucene
         
         int32_t start = ensureContiguousMerge(merge);
         
-        commitMergedDeletes(merge, mergedReader);
+        commitMergedDeletes(merge, mergedReader, merger->getSortDocMap());
         docWriter->remapDeletes(segmentInfos, merger->getDocMaps(), merger->getDelCounts(), merge, mergedDocCount);
         
         // If the doc store we are using has been closed and is in now compound format (but wasn't when we started), 
@@ -2634,6 +2831,7 @@ namespace Lucene
                     return exc;
                 break;
             case LuceneException::IO:
+            case LuceneException::CorruptIndex:
             case LuceneException::Runtime:
                 return exc;
             default:
@@ -2854,6 +3052,10 @@ namespace Lucene
         if (!mergeDocStores && mergedSegmentWarmer && !currentDocStoreSegment.empty() && !lastDocStoreSegment.empty() && lastDocStoreSegment == currentDocStoreSegment)
             mergeDocStores = true;
         
+        // the documents of a sorted merge are rewritten in their new order, stored fields and vectors included
+        if (indexSort)
+            mergeDocStores = true;
+        
         int32_t docStoreOffset;
         String docStoreSegment;
         bool docStoreIsCompoundFile;
@@ -2886,6 +3088,9 @@ namespace Lucene
         // Bind a new segment name here so even with ConcurrentMergePolicy we keep deterministic segment names.
         merge->info = newLucene<SegmentInfo>(newSegmentName(), 0, directory, false, true, docStoreOffset, docStoreSegment, docStoreIsCompoundFile, false);
         
+        // a merged segment that keeps sharing its doc store must be read with the codec that wrote the doc store
+        merge->info->setCodec(mergeDocStores ? codec : sourceSegments->info(0)->getCodec());
+        
         MapStringString details(MapStringString::newInstance());
         details.put(L"optimize", StringUtils::toString(merge->optimize));
         details.put(L"mergeFactor", StringUtils::toString(end));
@@ -3051,8 +3256,9 @@ namespace Lucene
             {
                 SegmentInfoPtr info(sourceSegments->info(i));
                 
-                // Hold onto the "live" reader; we will use this to commit merged deletes
-                merge->readers[i] = readerPool->get(info, merge->mergeDocStores, MERGE_READ_BUFFER_SIZE, -1);
+                // Hold onto the "live" reader; we will use this to commit merged deletes.  A sorted merge 
+                // needs the terms index to load the sort values
+                merge->readers[i] = readerPool->get(info, merge->mergeDocStores, MERGE_READ_BUFFER_SIZE, indexSort ? readerTermsIndexDivisor : -1, true);
                 SegmentReaderPtr reader(merge->readers[i]);
                 
                 // We clone the segment readers because other deletes may come in while we're merging so we need readers that will not change
@@ -3098,6 +3304,7 @@ namespace Lucene
             
             // This is where all the work happens
             merge->info->docCount = merger->merge(merge->mergeDocStores);
+            merge->info->setIndexSort(merger->getIndexSort());
             mergedDocCount = merge->info->docCount;
             
             BOOST_ASSERT(mergedDocCount == totDocCount);
@@ -3802,18 +4009,22 @@ namespace Lucene
         return get(info, doOpenStores, BufferedIndexInput::BUFFER_SIZE, IndexWriterPtr(_indexWriter)->readerTermsIndexDivisor);
     }
     
-    SegmentReaderPtr ReaderPool::get(SegmentInfoPtr info, bool doOpenStores, int32_t readBufferSize, int32_t termsIndexDivisor)
+    SegmentReaderPtr ReaderPool::get(SegmentInfoPtr info, bool doOpenStores, int32_t readBufferSize, int32_t termsIndexDivisor, bool forMerge)
     {
         SyncLock syncLock(this);
         IndexWriterPtr indexWriter(_indexWriter);
         if (indexWriter->poolReaders)
+        {
+            // pooled readers outlive the merge and go on to serve searches
             readBufferSize = BufferedIndexInput::BUFFER_SIZE;
+            forMerge = false;
+        }
         
         SegmentReaderPtr sr(readerMap.get(info));
         if (!sr)
         {
             // Returns a ref, which we xfer to readerMap
-            sr = SegmentReader::get(false, info->dir, info, readBufferSize, doOpenStores, termsIndexDivisor);
+            sr = SegmentReader::get(false, forMerge ? info->dir->getMergeReadDirectory() : info->dir, info, readBufferSize, doOpenStores, termsIndexDivisor);
             if (info->dir == indexWriter->directory)
             {
                 // Only pool if reader is not external
@@ -306,6 +306,19 @@ namespace Lucene
         return total;
     }
     
+    Collection<int32_t> MultiReader::docFreqs(Collection<TermPtr> terms)
+    {
+        ensureOpen();
+        Collection<int32_t> total(Collection<int32_t>::newInstance(terms.size())); // sum freqs in segments
+        for (Collection<IndexReaderPtr>::iterator reader = subReaders.begin(); reader != subReaders.end(); ++reader)
+        {
+            Collection<int32_t> freqs((*reader)->docFreqs(terms));
+            for (int32_t i = 0; i < terms.size(); ++i)
+                total[i] += freqs[i];
+        }
+        return total;
+    }
+    
     TermDocsPtr MultiReader::termDocs()
     {
         ensureOpen();
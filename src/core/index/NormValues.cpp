@@ -0,0 +1,122 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "NormValues.h"
+#include "_NormValues.h"
+#include "IndexInput.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    NormValues::~NormValues()
+    {
+    }
+    
+    void NormValues::copyTo(uint8_t* bytes, int32_t offset, int32_t length)
+    {
+        for (int32_t doc = 0; doc < length; ++doc)
+            bytes[offset + doc] = get(doc);
+    }
+    
+    NormValuesPtr NormValues::fromBytes(ByteArray norms)
+    {
+        return norms ? newLucene<DenseNormValues>(norms) : NormValuesPtr();
+    }
+    
+    DenseNormValues::DenseNormValues(ByteArray bytes)
+    {
+        this->bytes = bytes;
+        this->data = bytes.get();
+        this->length = bytes.size();
+    }
+    
+    DenseNormValues::DenseNormValues(const uint8_t* mapped, int32_t length, IndexInputPtr input)
+    {
+        this->data = mapped;
+        this->length = length;
+        this->input = input;
+    }
+    
+    DenseNormValues::~DenseNormValues()
+    {
+    }
+    
+    uint8_t DenseNormValues::get(int32_t doc)
+    {
+        return data[doc];
+    }
+    
+    void DenseNormValues::copyTo(uint8_t* bytes, int32_t offset, int32_t length)
+    {
+        MiscUtils::arrayCopy(data, 0, bytes, offset, length);
+    }
+    
+    int64_t DenseNormValues::sizeInBytes()
+    {
+        return bytes ? bytes.size() : 0;
+    }
+    
+    SparseNormValues::SparseNormValues(uint8_t commonNorm, IntArray docs, ByteArray norms)
+    {
+        this->commonNorm = commonNorm;
+        this->docs = docs;
+        this->norms = norms;
+    }
+    
+    SparseNormValues::~SparseNormValues()
+    {
+    }
+    
+    uint8_t SparseNormValues::get(int32_t doc)
+    {
+        const int32_t* begin = docs.get();
+        const int32_t* end = begin + docs.size();
+        const int32_t* found = std::lower_bound(begin, end, doc);
+        return (found != end && *found == doc) ? norms[(int32_t)(found - begin)] : commonNorm;
+    }
+    
+    void SparseNormValues::copyTo(uint8_t* bytes, int32_t offset, int32_t length)
+    {
+        MiscUtils::arrayFill(bytes, offset, offset + length, commonNorm);
+        for (int32_t i = 0; i < docs.size() && docs[i] < length; ++i)
+            bytes[offset + docs[i]] = norms[i];
+    }
+    
+    int64_t SparseNormValues::sizeInBytes()
+    {
+        return (int64_t)docs.size() * (sizeof(int32_t) + 1);
+    }
+    
+    PackedNormValues::PackedNormValues(ByteArray table, ByteArray packed)
+    {
+        this->table = table;
+        this->packed = packed;
+        this->data = packed.get();
+    }
+    
+    PackedNormValues::PackedNormValues(ByteArray table, const uint8_t* mapped, IndexInputPtr input)
+    {
+        this->table = table;
+        this->data = mapped;
+        this->input = input;
+    }
+    
+    PackedNormValues::~PackedNormValues()
+    {
+    }
+    
+    uint8_t PackedNormValues::get(int32_t doc)
+    {
+        uint8_t b = data[doc >> 1];
+        return table[(doc & 1) == 0 ? (b & 0x0f) : (b >> 4)];
+    }
+    
+    int64_t PackedNormValues::sizeInBytes()
+    {
+        return table.size() + (packed ? packed.size() : 0);
+    }
+}
@@ -0,0 +1,244 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "NormsFormat.h"
+#include "_NormValues.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "SegmentMerger.h"
+#include "MiscUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    const uint8_t NormsFormat::DENSE = 0;
+    const uint8_t NormsFormat::SPARSE = 1;
+    const uint8_t NormsFormat::PACKED = 2;
+    
+    const int32_t NormsFormat::MAX_PACKED_NORMS = 16;
+    
+    NormsFormat::~NormsFormat()
+    {
+    }
+    
+    int32_t NormsFormat::vIntLength(int32_t i)
+    {
+        int32_t length = 1;
+        while ((i & ~0x7f) != 0)
+        {
+            i = MiscUtils::unsignedShift(i, 7);
+            ++length;
+        }
+        return length;
+    }
+    
+    void NormsFormat::reducePrecision(ByteArray norms, int32_t numDocs, Collection<int32_t> counts)
+    {
+        Collection<int32_t> values(Collection<int32_t>::newInstance());
+        for (int32_t value = 0; value < 256; ++value)
+        {
+            if (counts[value] > 0)
+                values.add(value);
+        }
+        if (values.size() <= MAX_PACKED_NORMS)
+            return;
+        
+        // keep the most common norms; the encoding is monotonic, so the nearest byte is the nearest norm
+        Collection<uint8_t> kept(Collection<uint8_t>::newInstance(256));
+        for (int32_t i = 0; i < MAX_PACKED_NORMS; ++i)
+        {
+            int32_t best = -1;
+            for (Collection<int32_t>::iterator value = values.begin(); value != values.end(); ++value)
+            {
+                if (!kept[*value] && (best == -1 || counts[*value] > counts[best]))
+                    best = *value;
+            }
+            kept[best] = 1;
+        }
+        
+        Collection<int32_t> rounded(Collection<int32_t>::newInstance(256));
+        for (Collection<int32_t>::iterator value = values.begin(); value != values.end(); ++value)
+        {
+            int32_t nearest = -1;
+            for (int32_t candidate = 0; candidate < 256; ++candidate)
+            {
+                if (kept[candidate] && (nearest == -1 || std::abs(candidate - *value) < std::abs(nearest - *value)))
+                    nearest = candidate;
+            }
+            rounded[*value] = nearest;
+        }
+        
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+            norms[doc] = (uint8_t)rounded[norms[doc]];
+        for (Collection<int32_t>::iterator value = values.begin(); value != values.end(); ++value)
+        {
+            if (!kept[*value])
+            {
+                counts[rounded[*value]] += counts[*value];
+                counts[*value] = 0;
+            }
+        }
+    }
+    
+    void NormsFormat::write(IndexOutputPtr out, ByteArray norms, int32_t numDocs, bool reducedPrecision)
+    {
+        Collection<int32_t> counts(Collection<int32_t>::newInstance(256));
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+            ++counts[norms[doc]];
+        if (reducedPrecision)
+            reducePrecision(norms, numDocs, counts);
+        
+        int32_t commonNorm = 0;
+        int32_t numNorms = 0;
+        for (int32_t value = 0; value < 256; ++value)
+        {
+            if (counts[value] > 0)
+                ++numNorms;
+            if (counts[value] > counts[commonNorm])
+                commonNorm = value;
+        }
+        
+        int32_t numSparse = numDocs - counts[commonNorm];
+        int64_t sparseLength = 1 + vIntLength(numSparse) + numSparse;
+        int32_t lastDoc = 0;
+        for (int32_t doc = 0; doc < numDocs; ++doc)
+        {
+            if (norms[doc] != commonNorm)
+            {
+                sparseLength += vIntLength(doc - lastDoc);
+                lastDoc = doc;
+            }
+        }
+        int64_t packedLength = numNorms <= MAX_PACKED_NORMS ? 1 + numNorms + (numDocs + 1) / 2 : LLONG_MAX;
+        int64_t denseLength = numDocs;
+        
+        if (sparseLength < denseLength && sparseLength <= packedLength)
+        {
+            out->writeByte(SPARSE);
+            out->writeVLong(sparseLength);
+            out->writeByte((uint8_t)commonNorm);
+            out->writeVInt(numSparse);
+            lastDoc = 0;
+            for (int32_t doc = 0; doc < numDocs; ++doc)
+            {
+                if (norms[doc] != commonNorm)
+                {
+                    out->writeVInt(doc - lastDoc);
+                    lastDoc = doc;
+                }
+            }
+            for (int32_t doc = 0; doc < numDocs; ++doc)
+            {
+                if (norms[doc] != commonNorm)
+                    out->writeByte(norms[doc]);
+            }
+        }
+        else if (packedLength < denseLength)
+        {
+            out->writeByte(PACKED);
+            out->writeVLong(packedLength);
+            out->writeByte((uint8_t)numNorms);
+            Collection<int32_t> ords(Collection<int32_t>::newInstance(256));
+            int32_t ord = 0;
+            for (int32_t value = 0; value < 256; ++value)
+            {
+                if (counts[value] > 0)
+                {
+                    out->writeByte((uint8_t)value);
+                    ords[value] = ord++;
+                }
+            }
+            for (int32_t doc = 0; doc < numDocs; doc += 2)
+            {
+                int32_t high = doc + 1 < numDocs ? ords[norms[doc + 1]] : 0;
+                out->writeByte((uint8_t)(ords[norms[doc]] | (high << 4)));
+            }
+        }
+        else
+        {
+            out->writeByte(DENSE);
+            out->writeVLong(denseLength);
+            out->writeBytes(norms.get(), numDocs);
+        }
+    }
+    
+    Collection<int64_t> NormsFormat::readEntries(IndexInputPtr in, int32_t numFields)
+    {
+        uint8_t header[4];
+        in->readBytes(header, 0, SegmentMerger::NORMS_HEADER_LENGTH);
+        if (header[3] != SegmentMerger::NORMS_HEADER[3])
+            return Collection<int64_t>();
+        
+        Collection<int64_t> entries(Collection<int64_t>::newInstance());
+        for (int32_t i = 0; i < numFields; ++i)
+        {
+            entries.add(in->getFilePointer());
+            in->readByte();
+            int64_t length = in->readVLong();
+            in->seek(in->getFilePointer() + length);
+        }
+        return entries;
+    }
+    
+    NormValuesPtr NormsFormat::read(IndexInputPtr in, int64_t pos, int32_t numDocs, bool encoded, bool& mapped)
+    {
+        mapped = false;
+        in->seek(pos);
+        uint8_t encoding = DENSE;
+        if (encoded)
+        {
+            encoding = in->readByte();
+            in->readVLong();
+        }
+        
+        if (encoding == DENSE)
+        {
+            const uint8_t* bytes = in->mappedBytes(in->getFilePointer(), numDocs);
+            if (bytes)
+            {
+                mapped = true;
+                return newLucene<DenseNormValues>(bytes, numDocs, in);
+            }
+            ByteArray norms(ByteArray::newInstance(numDocs));
+            in->readBytes(norms.get(), 0, numDocs, false);
+            return newLucene<DenseNormValues>(norms);
+        }
+        else if (encoding == SPARSE)
+        {
+            uint8_t commonNorm = in->readByte();
+            int32_t numSparse = in->readVInt();
+            IntArray docs(IntArray::newInstance(numSparse));
+            int32_t doc = 0;
+            for (int32_t i = 0; i < numSparse; ++i)
+            {
+                doc += in->readVInt();
+                docs[i] = doc;
+            }
+            ByteArray norms(ByteArray::newInstance(numSparse));
+            in->readBytes(norms.get(), 0, numSparse);
+            return newLucene<SparseNormValues>(commonNorm, docs, norms);
+        }
+        else if (encoding == PACKED)
+        {
+            ByteArray table(ByteArray::newInstance(in->readByte()));
+            in->readBytes(table.get(), 0, table.size());
+            int32_t packedLength = (numDocs + 1) / 2;
+            const uint8_t* bytes = in->mappedBytes(in->getFilePointer(), packedLength);
+            if (bytes)
+            {
+                mapped = true;
+                return newLucene<PackedNormValues>(table, bytes, in);
+            }
+            ByteArray packed(ByteArray::newInstance(packedLength));
+            in->readBytes(packed.get(), 0, packedLength);
+            return newLucene<PackedNormValues>(table, packed);
+        }
+        
+        boost::throw_exception(CorruptIndexException(L"unknown norms encoding: " + StringUtils::toString(encoding)));
+        return NormValuesPtr();
+    }
+}
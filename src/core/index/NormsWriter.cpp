@@ -11,12 +11,14 @@
 #include "Similarity.h"
 #include "IndexFileNames.h"
 #include "IndexOutput.h"
-#include "SegmentMerger.h"
+#include "NormValues.h"
+#include "Codec.h"
 #include "SegmentWriteState.h"
 #include "InvertedDocEndConsumerPerField.h"
 #include "FieldInfos.h"
 #include "FieldInfo.h"
 #include "Directory.h"
+#include "MiscUtils.h"
 
 namespace Lucene
 {
@@ -87,90 +89,41 @@ namespace Lucene
         
         String normsFileName(state->segmentName + L"." + IndexFileNames::NORMS_EXTENSION());
         state->flushedFiles.add(normsFileName);
-        IndexOutputPtr normsOut(state->directory->createOutput(normsFileName));
+        IndexOutputPtr normsOut(state->codec->normsOutput(state->directory, state->segmentName));
         
         LuceneException finally;
         try
         {
-            normsOut->writeBytes(SegmentMerger::NORMS_HEADER, 0, SegmentMerger::NORMS_HEADER_LENGTH);
-            
             int32_t numField = fieldInfos->size();
             
-            int32_t normCount = 0;
-            
             for (int32_t fieldNumber = 0; fieldNumber < numField; ++fieldNumber)
             {
                 FieldInfoPtr fieldInfo(fieldInfos->fieldInfo(fieldNumber));
                 
                 Collection<NormsWriterPerFieldPtr> toMerge = byField.get(fieldInfo);
-                int32_t upto = 0;
                 
-                if (toMerge)
+                if (toMerge || (fieldInfo->isIndexed && !fieldInfo->omitNorms))
                 {
-                    int32_t numFields = toMerge.size();
-                    
-                    ++normCount;
-                    
-                    Collection<NormsWriterPerFieldPtr> fields(Collection<NormsWriterPerFieldPtr>::newInstance(numFields));
-                    Collection<int32_t> uptos(Collection<int32_t>::newInstance(numFields));
+                    // Documents without the field get the default norm
+                    ByteArray norms(ByteArray::newInstance(state->numDocs));
+                    MiscUtils::arrayFill(norms.get(), 0, state->numDocs, getDefaultNorm());
                     
-                    for (int32_t j = 0; j < numFields; ++j)
-                        fields[j] = toMerge[j];
-                    
-                    int32_t numLeft = numFields;
-                    
-                    while (numLeft > 0)
+                    if (toMerge)
                     {
-                        BOOST_ASSERT(uptos[0] < fields[0]->docIDs.size());
-                        
-                        int32_t minLoc = 0;
-                        int32_t minDocID = fields[0]->docIDs[uptos[0]];
-                        
-                        for (int32_t j = 1; j < numLeft; ++j)
+                        for (Collection<NormsWriterPerFieldPtr>::iterator field = toMerge.begin(); field != toMerge.end(); ++field)
                         {
-                            int32_t docID = fields[j]->docIDs[uptos[j]];
-                            if (docID < minDocID)
+                            for (int32_t upto = 0; upto < (*field)->upto; ++upto)
                             {
-                                minDocID = docID;
-                                minLoc = j;
+                                BOOST_ASSERT((*field)->docIDs[upto] < state->numDocs);
+                                norms[(*field)->docIDs[upto]] = (*field)->norms[upto];
                             }
-                        }
-                        
-                        BOOST_ASSERT(minDocID < state->numDocs);
-                        
-                        // Fill hole
-                        for (;upto < minDocID; ++upto)
-                            normsOut->writeByte(getDefaultNorm());
-                        
-                        normsOut->writeByte(fields[minLoc]->norms[uptos[minLoc]]);
-                        ++(uptos[minLoc]);
-                        ++upto;
-                        
-                        if (uptos[minLoc] == fields[minLoc]->upto)
-                        {
-                            fields[minLoc]->reset();
-                            if (minLoc != numLeft - 1)
-                            {
-                                fields[minLoc] = fields[numLeft - 1];
-                                uptos[minLoc] = uptos[numLeft - 1];
-                            }
-                            --numLeft;
+                            (*field)->reset();
                         }
                     }
                     
-                    // Fill final hole with defaultNorm
-                    for (;upto < state->numDocs; ++upto)
-                        normsOut->writeByte(getDefaultNorm());
+                    state->codec->writeNorms(normsOut, norms, state->numDocs, fieldInfo->reducedPrecisionNorms);
+                    state->fieldNorms.put(fieldInfo->name, NormValues::fromBytes(norms));
                 }
-                else if (fieldInfo->isIndexed && !fieldInfo->omitNorms)
-                {
-                    ++normCount;
-                    // Fill entire field with default norm
-                    for (;upto < state->numDocs; ++upto)
-                        normsOut->writeByte(getDefaultNorm());
-                }
-                
-                BOOST_ASSERT(4 + normCount * state->numDocs == normsOut->getFilePointer()); // .nrm file size mismatch?
             }
         }
         catch (LuceneException& e)
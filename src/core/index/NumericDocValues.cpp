@@ -0,0 +1,52 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "NumericDocValues.h"
+#include "DocValuesReader.h"
+#include "IndexInput.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    NumericDocValues::NumericDocValues(IndexInputPtr input, bool isDouble)
+    {
+        this->input = input;
+        this->_isDouble = isDouble;
+        minValue = input->readLong();
+        width = input->readByte();
+        dataPointer = input->getFilePointer();
+    }
+    
+    NumericDocValues::~NumericDocValues()
+    {
+    }
+    
+    bool NumericDocValues::isDouble()
+    {
+        return _isDouble;
+    }
+    
+    int64_t NumericDocValues::getRaw(int32_t doc)
+    {
+        if (width == 0)
+            return minValue;
+        input->seek(dataPointer + (int64_t)doc * width);
+        return (int64_t)((uint64_t)minValue + DocValuesReader::readFixed(input, width));
+    }
+    
+    int64_t NumericDocValues::getLong(int32_t doc)
+    {
+        int64_t value = getRaw(doc);
+        return _isDouble ? (int64_t)MiscUtils::longBitsToDouble(value) : value;
+    }
+    
+    double NumericDocValues::getDouble(int32_t doc)
+    {
+        int64_t value = getRaw(doc);
+        return _isDouble ? MiscUtils::longBitsToDouble(value) : (double)value;
+    }
+}
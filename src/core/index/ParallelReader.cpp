@@ -310,6 +310,13 @@ namespace Lucene
             reader->second->norms(field, norms, offset);
     }
     
+    NormValuesPtr ParallelReader::normValues(const String& field)
+    {
+        ensureOpen();
+        MapStringIndexReader::iterator reader = fieldToReader.find(field);
+        return reader == fieldToReader.end() ? NormValuesPtr() : reader->second->normValues(field);
+    }
+    
     void ParallelReader::doSetNorm(int32_t doc, const String& field, uint8_t value)
     {
         ensureOpen();
@@ -14,6 +14,7 @@
 #include "IndexFileNames.h"
 #include "IndexFileNameFilter.h"
 #include "BitVector.h"
+#include "DefaultCodec.h"
 #include "MiscUtils.h"
 #include "UnicodeUtils.h"
 #include "StringUtils.h"
@@ -40,6 +41,7 @@ namespace Lucene
         docStoreIsCompoundFile = false;
         delCount = 0;
         hasProx = true;
+        codecName = DefaultCodec::CODEC_NAME;
     }
     
     SegmentInfo::SegmentInfo(const String& name, int32_t docCount, DirectoryPtr dir, bool isCompoundFile, bool hasSingleNormFile)
@@ -56,6 +58,7 @@ namespace Lucene
         docStoreIsCompoundFile = false;
         delCount = 0;
         hasProx = true;
+        codecName = DefaultCodec::CODEC_NAME;
     }
             
     SegmentInfo::SegmentInfo(const String& name, int32_t docCount, DirectoryPtr dir, bool isCompoundFile, bool hasSingleNormFile,
@@ -74,6 +77,7 @@ namespace Lucene
         this->docStoreIsCompoundFile = docStoreIsCompoundFile;
         delCount = 0;
         this->hasProx = hasProx;
+        codecName = DefaultCodec::CODEC_NAME;
     }
     
     SegmentInfo::SegmentInfo(DirectoryPtr dir, int32_t format, IndexInputPtr input)
@@ -134,6 +138,14 @@ namespace Lucene
                 diagnostics = input->readStringStringMap();
             else
                 diagnostics = MapStringString::newInstance();
+            
+            if (format <= SegmentInfos::FORMAT_CODEC)
+                codecName = input->readString();
+            else
+                codecName = DefaultCodec::CODEC_NAME;
+            
+            if (format <= SegmentInfos::FORMAT_INDEX_SORT)
+                indexSort = input->readString();
         }
         else
         {
@@ -145,6 +157,7 @@ namespace Lucene
             docStoreIsCompoundFile = false;
             delCount = -1;
             hasProx = true;
+            codecName = DefaultCodec::CODEC_NAME;
             diagnostics = MapStringString::newInstance();
         }
     }
@@ -170,6 +183,8 @@ namespace Lucene
         isCompoundFile = src->isCompoundFile;
         hasSingleNormFile = src->hasSingleNormFile;
         delCount = src->delCount;
+        codecName = src->codecName;
+        indexSort = src->indexSort;
     }
     
     void SegmentInfo::setDiagnostics(MapStringString diagnostics)
@@ -260,6 +275,8 @@ namespace Lucene
         si->docStoreOffset = docStoreOffset;
         si->docStoreSegment = docStoreSegment;
         si->docStoreIsCompoundFile = docStoreIsCompoundFile;
+        si->codecName = codecName;
+        si->indexSort = indexSort;
         return si;
     }
     
@@ -456,6 +473,8 @@ namespace Lucene
         output->writeInt(delCount);
         output->writeByte((uint8_t)(hasProx ? 1 : 0));
         output->writeStringStringMap(diagnostics);
+        output->writeString(codecName);
+        output->writeString(indexSort);
     }
     
     void SegmentInfo::setHasProx(bool hasProx)
@@ -469,6 +488,32 @@ namespace Lucene
         return hasProx;
     }
     
+    void SegmentInfo::setCodec(CodecPtr codec)
+    {
+        codecName = codec->getName();
+        clearFiles();
+    }
+    
+    CodecPtr SegmentInfo::getCodec()
+    {
+        return Codec::forName(codecName);
+    }
+    
+    String SegmentInfo::getCodecName()
+    {
+        return codecName;
+    }
+    
+    void SegmentInfo::setIndexSort(const String& indexSort)
+    {
+        this->indexSort = indexSort;
+    }
+    
+    String SegmentInfo::getIndexSort()
+    {
+        return indexSort;
+    }
+    
     void SegmentInfo::addIfExists(HashSet<String> files, const String& fileName)
     {
         if (dir->fileExists(fileName))
@@ -567,6 +612,8 @@ namespace Lucene
                     _files.add(*fileName);
             }
         }
+        
+        getCodec()->files(dir, shared_from_this(), _files);
         return _files;
     }
     
@@ -52,8 +52,14 @@ namespace Lucene
     /// This format adds optional per-segment string diagnostics storage, and switches userData to Map
     const int32_t SegmentInfos::FORMAT_DIAGNOSTICS = -9;
     
+    /// This format adds the name of the codec that wrote each segment.
+    const int32_t SegmentInfos::FORMAT_CODEC = -10;
+    
+    /// This format adds the sort the documents of each segment are in.
+    const int32_t SegmentInfos::FORMAT_INDEX_SORT = -11;
+    
     /// This must always point to the most recent file format.
-    const int32_t SegmentInfos::CURRENT_FORMAT = SegmentInfos::FORMAT_DIAGNOSTICS;
+    const int32_t SegmentInfos::CURRENT_FORMAT = SegmentInfos::FORMAT_INDEX_SORT;
     
     /// Advanced configuration of retry logic in loading segments_N file.
     int32_t SegmentInfos::defaultGenFileRetryCount = 10;
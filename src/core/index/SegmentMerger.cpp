@@ -8,13 +8,18 @@
 #include "SegmentMerger.h"
 #include "MergePolicy.h"
 #include "IndexWriter.h"
+#include "IndexInput.h"
 #include "IndexOutput.h"
+#include "RAMFile.h"
+#include "RAMInputStream.h"
+#include "RAMOutputStream.h"
 #include "FieldInfos.h"
 #include "FieldInfo.h"
 #include "FieldsReader.h"
 #include "FieldsWriter.h"
 #include "IndexFileNames.h"
 #include "CompoundFileWriter.h"
+#include "CompoundStagingDirectory.h"
 #include "SegmentReader.h"
 #include "_SegmentReader.h"
 #include "Directory.h"
@@ -22,15 +27,26 @@
 #include "TermVectorsReader.h"
 #include "TermVectorsWriter.h"
 #include "FormatPostingsDocsConsumer.h"
-#include "FormatPostingsFieldsWriter.h"
+#include "FormatPostingsFieldsConsumer.h"
+#include "Codec.h"
 #include "FormatPostingsPositionsConsumer.h"
 #include "FormatPostingsTermsConsumer.h"
 #include "SegmentMergeInfo.h"
 #include "SegmentMergeQueue.h"
 #include "SegmentWriteState.h"
+#include "TermInfosWriter.h"
 #include "TestPoint.h"
 #include "MiscUtils.h"
+#include "UnicodeUtils.h"
 #include "StringUtils.h"
+#include "ChecksumFooter.h"
+#include "CRC32C.h"
+#include "SegmentInfo.h"
+#include "DocValuesWriter.h"
+#include "NumericDocValues.h"
+#include "BinaryDocValues.h"
+#include "SortedDocValues.h"
+#include "IndexSorter.h"
 
 namespace Lucene
 {
@@ -38,15 +54,19 @@ namespace Lucene
     const int32_t SegmentMerger::MAX_RAW_MERGE_DOCS = 4192;
     
     /// norms header placeholder
-    const uint8_t SegmentMerger::NORMS_HEADER[] = {'N', 'R', 'M', -1};
+    const uint8_t SegmentMerger::NORMS_HEADER[] = {'N', 'R', 'M', -2};
     const int32_t SegmentMerger::NORMS_HEADER_LENGTH = 4;
     
     SegmentMerger::SegmentMerger(DirectoryPtr dir, const String& name)
     {
         readers = Collection<IndexReaderPtr>::newInstance();
         termIndexInterval = IndexWriter::DEFAULT_TERM_INDEX_INTERVAL;
+        postingsFormat = TermInfosWriter::POSTINGS_FORMAT_VINT;
+        codec = Codec::getDefault();
         mergedDocs = 0;
         mergeDocStores = false;
+        checkIntegrity = false;
+        hasDocValues = false;
         omitTermFreqAndPositions = false;
         
         directory = dir;
@@ -59,6 +79,8 @@ namespace Lucene
         readers = Collection<IndexReaderPtr>::newInstance();
         mergedDocs = 0;
         mergeDocStores = false;
+        checkIntegrity = false;
+        hasDocValues = false;
         omitTermFreqAndPositions = false;
         
         directory = writer->getDirectory();
@@ -68,7 +90,16 @@ namespace Lucene
             checkAbort = newLucene<CheckAbort>(merge, directory);
         else
             checkAbort = newLucene<CheckAbortNull>();
+        
+        // the merged segment's files go straight into a compound file, so hold them in RAM until it's built
+        if (merge && merge->useCompoundFile && CompoundStagingDirectory::isWorthStaging(directory))
+            directory = newLucene<CompoundStagingDirectory>(directory, name);
+        
         termIndexInterval = writer->getTermIndexInterval();
+        postingsFormat = writer->getUseBlockPackedPostings() ? TermInfosWriter::POSTINGS_FORMAT_BLOCK_PACKED : TermInfosWriter::POSTINGS_FORMAT_VINT;
+        codec = merge ? merge->info->getCodec() : writer->getCodec();
+        checkIntegrity = writer->getCheckIntegrityAtMerge();
+        indexSort = writer->getIndexSort();
     }
     
     SegmentMerger::~SegmentMerger()
@@ -102,9 +133,16 @@ namespace Lucene
         // NOTE: it's important to add calls to checkAbort.work(...) if you make any changes to this method that will spend a lot of time.  
         // The frequency of this check impacts how long IndexWriter.close(false) takes to actually stop the threads.
         
+        if (checkIntegrity)
+            checkIntegrityOfReaders();
+        
+        if (indexSort)
+            sortDocs();
+        
         mergedDocs = mergeFields();
-        mergeTerms();
         mergeNorms();
+        mergeTerms();
+        mergeDocValues();
         
         if (mergeDocStores && fieldInfos->hasVectors())
             mergeVectors();
@@ -112,6 +150,65 @@ namespace Lucene
         return mergedDocs;
     }
     
+    void SegmentMerger::sortDocs()
+    {
+        Collection<int32_t> order(IndexSorter::sort(indexSort, readers));
+        if (!order)
+            return; // already in order
+        
+        if (!mergeDocStores)
+            boost::throw_exception(IllegalStateException(L"the doc stores must be merged to sort the merged documents"));
+        
+        // the reader and document of each document that is not deleted, numbered one after the other
+        int32_t numDocs = order.size();
+        Collection<int32_t> docReaders(Collection<int32_t>::newInstance(numDocs));
+        Collection<int32_t> docs(Collection<int32_t>::newInstance(numDocs));
+        int32_t docUpto = 0;
+        for (int32_t r = 0; r < readers.size(); ++r)
+        {
+            int32_t maxDoc = readers[r]->maxDoc();
+            for (int32_t j = 0; j < maxDoc; ++j)
+            {
+                if (readers[r]->isDeleted(j))
+                    continue;
+                docReaders[docUpto] = r;
+                docs[docUpto++] = j;
+            }
+        }
+        
+        sortedReaders = Collection<int32_t>::newInstance(numDocs);
+        sortedDocs = Collection<int32_t>::newInstance(numDocs);
+        sortDocMap = Collection<int32_t>::newInstance(numDocs);
+        for (int32_t k = 0; k < numDocs; ++k)
+        {
+            sortedReaders[k] = docReaders[order[k]];
+            sortedDocs[k] = docs[order[k]];
+            sortDocMap[order[k]] = k;
+        }
+    }
+    
+    int32_t SegmentMerger::sortedDoc(int32_t doc)
+    {
+        return sortDocMap ? sortDocMap[doc] : doc;
+    }
+    
+    void SegmentMerger::checkIntegrityOfReaders()
+    {
+        for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
+        {
+            SegmentReaderPtr segmentReader(boost::dynamic_pointer_cast<SegmentReader>(*reader));
+            if (!segmentReader || !segmentReader->fieldInfos()->hasChecksumFooters())
+                continue;
+            SegmentInfoPtr info(segmentReader->getSegmentInfo());
+            HashSet<String> files(info->files());
+            for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file)
+            {
+                ChecksumFooter::checksumEntireFile(info->dir, *file);
+                checkAbort->work(80.0 * (double)info->dir->fileLength(*file) / 16384.0);
+            }
+        }
+    }
+    
     void SegmentMerger::closeReaders()
     {
         for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
@@ -143,6 +240,12 @@ namespace Lucene
             }
         }
         
+        if (hasDocValues)
+            fileSet.add(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION());
+        
+        if (fieldInfos->hasBloomFilters())
+            fileSet.add(segment + L"." + IndexFileNames::BLOOM_FILTER_EXTENSION());
+        
         // Vector files
         if (fieldInfos->hasVectors() && mergeDocStores)
         {
@@ -160,11 +263,16 @@ namespace Lucene
         
         // Now merge all added files
         for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file)
-            cfsWriter->addFile(*file);
+            cfsWriter->addFile(*file, true);
         
         // Perform the merge
         cfsWriter->close();
         
+        // release any files held in RAM
+        CompoundStagingDirectoryPtr stagingDirectory(boost::dynamic_pointer_cast<CompoundStagingDirectory>(directory));
+        if (stagingDirectory)
+            stagingDirectory->close();
+        
         return files;
     }
     
@@ -199,7 +307,8 @@ namespace Lucene
                 int32_t numFieldInfos = segmentFieldInfos->size();
                 for (int32_t j = 0; same && j < numFieldInfos; ++j)
                     same = (fieldInfos->fieldName(j) == segmentFieldInfos->fieldName(j));
-                if (same)
+                // raw copying is only possible between doc stores written by the same codec
+                if (same && segmentReader->getSegmentInfo()->getCodecName() == codec->getName())
                     matchingSegmentReaders[i] = segmentReader;
             }
         }
@@ -230,9 +339,13 @@ namespace Lucene
                 for (int32_t j = 0; j < numReaderFieldInfos; ++j)
                 {
                     FieldInfoPtr fi(readerFieldInfos->fieldInfo(j));
-                    fieldInfos->add(fi->name, fi->isIndexed, fi->storeTermVector, fi->storePositionWithTermVector, 
-                                    fi->storeOffsetWithTermVector, !(*reader)->hasNorms(fi->name), fi->storePayloads, 
-                                    fi->omitTermFreqAndPositions);
+                    FieldInfoPtr mergedFi(fieldInfos->add(fi->name, fi->isIndexed, fi->storeTermVector, fi->storePositionWithTermVector, 
+                                                          fi->storeOffsetWithTermVector, !(*reader)->hasNorms(fi->name), fi->storePayloads, 
+                                                          fi->omitTermFreqAndPositions));
+                    if (fi->reducedPrecisionNorms)
+                        mergedFi->reducedPrecisionNorms = true;
+                    if (fi->bloomFiltered)
+                        mergedFi->bloomFiltered = true;
                 }
             }
             else
@@ -256,26 +369,31 @@ namespace Lucene
         if (mergeDocStores)
         {
             // merge field values
-            FieldsWriterPtr fieldsWriter(newLucene<FieldsWriter>(directory, segment, fieldInfos));
+            FieldsWriterPtr fieldsWriter(codec->fieldsWriter(directory, segment, fieldInfos));
             
             LuceneException finally;
             try
             {
-                int32_t idx = 0;
-                for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
+                if (sortDocMap)
+                    docCount = copyFieldsSorted(fieldsWriter);
+                else
                 {
-                    SegmentReaderPtr matchingSegmentReader(matchingSegmentReaders[idx++]);
-                    FieldsReaderPtr matchingFieldsReader;
-                    if (matchingSegmentReader)
+                    int32_t idx = 0;
+                    for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
                     {
-                        FieldsReaderPtr fieldsReader(matchingSegmentReader->getFieldsReader());
-                        if (fieldsReader && fieldsReader->canReadRawDocs())
-                            matchingFieldsReader = fieldsReader;
+                        SegmentReaderPtr matchingSegmentReader(matchingSegmentReaders[idx++]);
+                        FieldsReaderPtr matchingFieldsReader;
+                        if (matchingSegmentReader)
+                        {
+                            FieldsReaderPtr fieldsReader(matchingSegmentReader->getFieldsReader());
+                            if (fieldsReader && fieldsReader->canReadRawDocs())
+                                matchingFieldsReader = fieldsReader;
+                        }
+                        if ((*reader)->hasDeletions())
+                            docCount += copyFieldsWithDeletions(fieldsWriter, *reader, matchingFieldsReader);
+                        else
+                            docCount += copyFieldsNoDeletions(fieldsWriter, *reader, matchingFieldsReader);
                     }
-                    if ((*reader)->hasDeletions())
-                        docCount += copyFieldsWithDeletions(fieldsWriter, *reader, matchingFieldsReader);
-                    else
-                        docCount += copyFieldsNoDeletions(fieldsWriter, *reader, matchingFieldsReader);
                 }
             }
             catch (LuceneException& e)
@@ -286,13 +404,12 @@ namespace Lucene
             finally.throwException();
             
             String fileName(segment + L"." + IndexFileNames::FIELDS_INDEX_EXTENSION());
-            int64_t fdxFileLength = directory->fileLength(fileName);
             
-            if (4 + ((int64_t)docCount) * 8 != fdxFileLength)
+            if (docCount != fieldsWriter->getNumDocs())
             {
                 boost::throw_exception(RuntimeException(L"mergeFields produced an invalid result: docCount is " + 
-                                                        StringUtils::toString(docCount) + L" but fdx file size is " + 
-                                                        StringUtils::toString(fdxFileLength) + L" file=" + fileName + 
+                                                        StringUtils::toString(docCount) + L" but fdx holds " + 
+                                                        StringUtils::toString(fieldsWriter->getNumDocs()) + L" docs file=" + fileName + 
                                                         L" file exists?=" + StringUtils::toString(directory->fileExists(fileName)) + 
                                                         L"; now aborting this merge to prevent index corruption"));
             }
@@ -393,30 +510,46 @@ namespace Lucene
         return docCount;
     }
 
+    int32_t SegmentMerger::copyFieldsSorted(FieldsWriterPtr fieldsWriter)
+    {
+        // the documents are no longer in runs of the readers, so they can't be copied raw
+        for (int32_t k = 0; k < sortedDocs.size(); ++k)
+        {
+            fieldsWriter->addDocument(readers[sortedReaders[k]]->document(sortedDocs[k]));
+            checkAbort->work(300);
+        }
+        return sortedDocs.size();
+    }
+    
     void SegmentMerger::mergeVectors()
     {
-        TermVectorsWriterPtr termVectorsWriter(newLucene<TermVectorsWriter>(directory, segment, fieldInfos));
+        TermVectorsWriterPtr termVectorsWriter(codec->termVectorsWriter(directory, segment, fieldInfos));
         
         LuceneException finally;
         try
         {
-            int32_t idx = 0;
-            for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
+            if (sortDocMap)
+                copyVectorsSorted(termVectorsWriter);
+            else
             {
-                SegmentReaderPtr matchingSegmentReader(matchingSegmentReaders[idx++]);
-                TermVectorsReaderPtr matchingVectorsReader;
-                if (matchingSegmentReader)
+                int32_t idx = 0;
+                for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
                 {
-                    TermVectorsReaderPtr vectorsReader(matchingSegmentReader->getTermVectorsReaderOrig());
+                    SegmentReaderPtr matchingSegmentReader(matchingSegmentReaders[idx++]);
+                    TermVectorsReaderPtr matchingVectorsReader;
+                    if (matchingSegmentReader)
+                    {
+                        TermVectorsReaderPtr vectorsReader(matchingSegmentReader->getTermVectorsReaderOrig());
                     
-                    // If the TV* files are an older format then they cannot read raw docs
-                    if (vectorsReader && vectorsReader->canReadRawDocs())
-                        matchingVectorsReader = vectorsReader;
+                        // If the TV* files are an older format then they cannot read raw docs
+                        if (vectorsReader && vectorsReader->canReadRawDocs())
+                            matchingVectorsReader = vectorsReader;
+                    }
+                    if ((*reader)->hasDeletions())
+                        copyVectorsWithDeletions(termVectorsWriter, matchingVectorsReader, *reader);
+                    else
+                        copyVectorsNoDeletions(termVectorsWriter, matchingVectorsReader, *reader);
                 }
-                if ((*reader)->hasDeletions())
-                    copyVectorsWithDeletions(termVectorsWriter, matchingVectorsReader, *reader);
-                else
-                    copyVectorsNoDeletions(termVectorsWriter, matchingVectorsReader, *reader);
             }
         }
         catch (LuceneException& e)
@@ -429,7 +562,7 @@ namespace Lucene
         String fileName(segment + L"." + IndexFileNames::VECTORS_INDEX_EXTENSION());
         int64_t tvxSize = directory->fileLength(fileName);
         
-        if (4 + ((int64_t)mergedDocs) * 16 != tvxSize)
+        if (4 + ((int64_t)mergedDocs) * 16 + ChecksumFooter::FOOTER_LENGTH != tvxSize)
         {
             boost::throw_exception(RuntimeException(L"mergeVectors produced an invalid result: mergedDocs is " + 
                                                     StringUtils::toString(mergedDocs) + L" but tvx size is " + 
@@ -497,16 +630,36 @@ namespace Lucene
         int32_t maxDoc = reader->maxDoc();
         if (matchingVectorsReader)
         {
+            // When we copy the whole of the tvd and tvf files they are checked against their footers on 
+            // the way, rather than being read again up front
+            CRC32CPtr tvdChecksum;
+            CRC32CPtr tvfChecksum;
+            if (matchingVectorsReader->canVerifyRawDocs())
+            {
+                tvdChecksum = newLucene<CRC32C>();
+                tvfChecksum = newLucene<CRC32C>();
+                matchingVectorsReader->getTvdStream()->seek(0);
+                ChecksumFooter::updateChecksum(matchingVectorsReader->getTvdStream(), TermVectorsReader::FORMAT_SIZE, tvdChecksum);
+                matchingVectorsReader->getTvfStream()->seek(0);
+                ChecksumFooter::updateChecksum(matchingVectorsReader->getTvfStream(), TermVectorsReader::FORMAT_SIZE, tvfChecksum);
+            }
+            
             // We can bulk-copy because the fieldInfos are "congruent"
             int32_t docCount = 0;
             while (docCount < maxDoc)
             {
                 int32_t len = std::min(MAX_RAW_MERGE_DOCS, maxDoc - docCount);
                 matchingVectorsReader->rawDocs(rawDocLengths, rawDocLengths2, docCount, len);
-                termVectorsWriter->addRawDocuments(matchingVectorsReader, rawDocLengths, rawDocLengths2, len);
+                termVectorsWriter->addRawDocuments(matchingVectorsReader, rawDocLengths, rawDocLengths2, len, tvdChecksum, tvfChecksum);
                 docCount += len;
                 checkAbort->work(300 * len);
             }
+            
+            if (tvdChecksum)
+            {
+                ChecksumFooter::checkFooter(matchingVectorsReader->getTvdStream(), tvdChecksum);
+                ChecksumFooter::checkFooter(matchingVectorsReader->getTvfStream(), tvfChecksum);
+            }
         }
         else
         {
@@ -519,17 +672,32 @@ namespace Lucene
         }
     }
 
+    void SegmentMerger::copyVectorsSorted(TermVectorsWriterPtr termVectorsWriter)
+    {
+        for (int32_t k = 0; k < sortedDocs.size(); ++k)
+        {
+            termVectorsWriter->addAllDocVectors(readers[sortedReaders[k]]->getTermFreqVectors(sortedDocs[k]));
+            checkAbort->work(300);
+        }
+    }
+    
     void SegmentMerger::mergeTerms()
     {
         TestScope testScope(L"SegmentMerger", L"mergeTerms");
         
         SegmentWriteStatePtr state(newLucene<SegmentWriteState>(DocumentsWriterPtr(), directory, segment, L"", mergedDocs, 0, termIndexInterval));
+        state->postingsFormat = postingsFormat;
+        state->codec = codec;
+        
+        // the skip entries record the greatest norm of the docs they skip over, so the norms just written are 
+        // read back rather than all held on the heap while the norms were merged
+        IndexInputPtr normsInput(readMergedNorms(state->fieldNorms));
 
-        FormatPostingsFieldsConsumerPtr consumer(newLucene<FormatPostingsFieldsWriter>(state, fieldInfos));
-
+        FormatPostingsFieldsConsumerPtr consumer;
         LuceneException finally;
         try
         {
+            consumer = codec->fieldsConsumer(state, fieldInfos);
             queue = newLucene<SegmentMergeQueue>(readers.size());
             mergeTermInfos(consumer);
         }
@@ -537,12 +705,51 @@ namespace Lucene
         {
             finally = e;
         }
-        consumer->finish();
+        if (consumer)
+            consumer->finish();
         if (queue)
             queue->close();
+        state->fieldNorms.clear();
+        if (normsInput)
+            normsInput->close();
         finally.throwException();
     }
     
+    IndexInputPtr SegmentMerger::readMergedNorms(MapStringNormValues fieldNorms)
+    {
+        Collection<FieldInfoPtr> normFields(Collection<FieldInfoPtr>::newInstance());
+        for (int32_t i = 0; i < fieldInfos->size(); ++i)
+        {
+            FieldInfoPtr fi(fieldInfos->fieldInfo(i));
+            if (fi->isIndexed && !fi->omitNorms)
+                normFields.add(fi);
+        }
+        if (normFields.empty())
+            return IndexInputPtr();
+        
+        IndexInputPtr normsInput(directory->openInput(segment + L"." + IndexFileNames::NORMS_EXTENSION()));
+        LuceneException finally;
+        try
+        {
+            Collection<int64_t> entries(codec->readNormEntries(normsInput, normFields.size()));
+            for (int32_t i = 0; i < normFields.size(); ++i)
+            {
+                bool mapped = false;
+                fieldNorms.put(normFields[i]->name, codec->readNorms(normsInput, entries[i], mergedDocs, true, mapped));
+            }
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        if (!finally.isNull())
+        {
+            normsInput->close();
+            finally.throwException();
+        }
+        return normsInput;
+    }
+    
     void SegmentMerger::mergeTermInfos(FormatPostingsFieldsConsumerPtr consumer)
     {
         int32_t base = 0;
@@ -628,8 +835,21 @@ namespace Lucene
         return delCounts;
     }
     
+    String SegmentMerger::getIndexSort()
+    {
+        return indexSort ? IndexSorter::describe(indexSort) : L"";
+    }
+    
+    Collection<int32_t> SegmentMerger::getSortDocMap()
+    {
+        return sortDocMap;
+    }
+    
     int32_t SegmentMerger::appendPostings(FormatPostingsTermsConsumerPtr termsConsumer, Collection<SegmentMergeInfoPtr> smis, int32_t n)
     {
+        if (sortDocMap)
+            return appendSortedPostings(termsConsumer, smis, n);
+        
         FormatPostingsDocsConsumerPtr docConsumer(termsConsumer->addTerm(smis[0]->term->_text));
         int32_t df = 0;
         for (int32_t i = 0; i < n; ++i)
@@ -676,10 +896,108 @@ namespace Lucene
         
         return df;
     }
+    
+    int32_t SegmentMerger::appendSortedPostings(FormatPostingsTermsConsumerPtr termsConsumer, Collection<SegmentMergeInfoPtr> smis, int32_t n)
+    {
+        // each entry holds the merged doc in its upper half, so that sorting the entries orders the docs, and 
+        // the index of the gathered doc in its lower half
+        Collection<int64_t> entries(Collection<int64_t>::newInstance());
+        Collection<int32_t> freqs(Collection<int32_t>::newInstance());
+        Collection<int64_t> positionPointers(Collection<int64_t>::newInstance());
+        
+        // positions are delta coded, each followed by its payload length and payload; the buffers are kept 
+        // for the next term
+        if (!sortedPositions)
+        {
+            sortedPositionsFile = newLucene<RAMFile>();
+            sortedPositions = newLucene<RAMOutputStream>(sortedPositionsFile);
+        }
+        sortedPositions->reset();
+        if (!payloadBuffer)
+            payloadBuffer = ByteArray::newInstance(256);
+        
+        for (int32_t i = 0; i < n; ++i)
+        {
+            SegmentMergeInfoPtr smi(smis[i]);
+            TermPositionsPtr postings(smi->getPositions());
+            BOOST_ASSERT(postings);
+            int32_t base = smi->base;
+            Collection<int32_t> docMap(smi->getDocMap());
+            postings->seek(smi->termEnum);
+            
+            while (postings->next())
+            {
+                int32_t doc = postings->doc();
+                if (docMap)
+                    doc = docMap[doc]; // map around deletions
+                doc = sortDocMap[doc + base]; // convert to merged space
+                
+                int32_t freq = postings->freq();
+                entries.add(((int64_t)doc << 32) | (int64_t)freqs.size());
+                freqs.add(freq);
+                positionPointers.add(sortedPositions->getFilePointer());
+                
+                if (!omitTermFreqAndPositions)
+                {
+                    int32_t lastPosition = 0;
+                    for (int32_t j = 0; j < freq; ++j)
+                    {
+                        int32_t position = postings->nextPosition();
+                        sortedPositions->writeVInt(position - lastPosition);
+                        lastPosition = position;
+                        int32_t payloadLength = postings->getPayloadLength();
+                        sortedPositions->writeVInt(payloadLength);
+                        if (payloadLength > 0)
+                        {
+                            if (payloadBuffer.size() < payloadLength)
+                                payloadBuffer.resize(payloadLength);
+                            postings->getPayload(payloadBuffer, 0);
+                            sortedPositions->writeBytes(payloadBuffer.get(), 0, payloadLength);
+                        }
+                    }
+                }
+            }
+        }
+        std::sort(entries.begin(), entries.end());
+        
+        sortedPositions->flush();
+        RAMInputStreamPtr positionsInput(newLucene<RAMInputStream>(sortedPositionsFile));
+        FormatPostingsDocsConsumerPtr docConsumer(termsConsumer->addTerm(smis[0]->term->_text));
+        for (Collection<int64_t>::iterator entry = entries.begin(); entry != entries.end(); ++entry)
+        {
+            int32_t doc = (int32_t)(*entry >> 32);
+            int32_t idx = (int32_t)(*entry & 0xffffffff);
+            int32_t freq = freqs[idx];
+            FormatPostingsPositionsConsumerPtr posConsumer(docConsumer->addDoc(doc, freq));
+            
+            if (!omitTermFreqAndPositions)
+            {
+                positionsInput->seek(positionPointers[idx]);
+                int32_t position = 0;
+                for (int32_t j = 0; j < freq; ++j)
+                {
+                    position += positionsInput->readVInt();
+                    int32_t payloadLength = positionsInput->readVInt();
+                    if (payloadLength > 0)
+                    {
+                        if (payloadBuffer.size() < payloadLength)
+                            payloadBuffer.resize(payloadLength);
+                        positionsInput->readBytes(payloadBuffer.get(), 0, payloadLength);
+                    }
+                    posConsumer->addPosition(position, payloadBuffer, 0, payloadLength);
+                }
+                posConsumer->finish();
+            }
+        }
+        docConsumer->finish();
+        
+        return entries.size();
+    }
 
     void SegmentMerger::mergeNorms()
     {
         ByteArray normBuffer;
+        ByteArray mergedNorms;
         IndexOutputPtr output;
         LuceneException finally;
         try
@@ -692,9 +1010,13 @@ namespace Lucene
                 {
                     if (!output)
                     {
-                        output = directory->createOutput(segment + L"." + IndexFileNames::NORMS_EXTENSION());
-                        output->writeBytes(NORMS_HEADER, SIZEOF_ARRAY(NORMS_HEADER));
+                        output = codec->normsOutput(directory, segment);
                     }
+                    // the merged norms of a field are written as a whole so that they can be encoded, and in the 
+                    // order of the merged documents if they are reordered
+                    if (!mergedNorms)
+                        mergedNorms = ByteArray::newInstance(mergedDocs);
+                    int32_t numDocs = 0;
                     for (Collection<IndexReaderPtr>::iterator reader = readers.begin(); reader != readers.end(); ++reader)
                     {
                         int32_t maxDoc = (*reader)->maxDoc();
@@ -705,10 +1027,20 @@ namespace Lucene
                             normBuffer.resize(maxDoc);
                         MiscUtils::arrayFill(normBuffer.get(), 0, normBuffer.size(), 0);
                         (*reader)->norms(fi->name, normBuffer, 0);
-                        if (!(*reader)->hasDeletions())
+                        
+                        if (sortDocMap)
+                        {
+                            for (int32_t k = 0; k < maxDoc; ++k)
+                            {
+                                if (!(*reader)->isDeleted(k))
+                                    mergedNorms[sortDocMap[numDocs++]] = normBuffer[k];
+                            }
+                        }
+                        else if (!(*reader)->hasDeletions())
                         {
                             // optimized case for segments without deleted docs
-                            output->writeBytes(normBuffer.get(), maxDoc);
+                            MiscUtils::arrayCopy(normBuffer.get(), 0, mergedNorms.get(), numDocs, maxDoc);
+                            numDocs += maxDoc;
                         }
                         else
                         {
@@ -716,11 +1048,12 @@ namespace Lucene
                             for (int32_t k = 0; k < maxDoc; ++k)
                             {
                                 if (!(*reader)->isDeleted(k))
-                                    output->writeByte(normBuffer[k]);
+                                    mergedNorms[numDocs++] = normBuffer[k];
                             }
                         }
                         checkAbort->work(maxDoc);
                     }
+                    codec->writeNorms(output, mergedNorms, numDocs, fi->reducedPrecisionNorms);
                 }
             }
         }
@@ -733,6 +1066,145 @@ namespace Lucene
         finally.throwException();
     }
 
+    void SegmentMerger::mergeDocValues()
+    {
+        DocValuesWriterPtr writer;
+        LuceneException finally;
+        try
+        {
+            for (int32_t i = 0; i < fieldInfos->size(); ++i)
+            {
+                String field(fieldInfos->fieldInfo(i)->name);
+                
+                // the type of the first reader that has values for the field wins; longs are widened to doubles
+                // if any reader has doubles
+                int32_t type = -1;
+                Collection<NumericDocValuesPtr> numerics(Collection<NumericDocValuesPtr>::newInstance(readers.size()));
+                Collection<BinaryDocValuesPtr> binaries(Collection<BinaryDocValuesPtr>::newInstance(readers.size()));
+                Collection<SortedDocValuesPtr> sorteds(Collection<SortedDocValuesPtr>::newInstance(readers.size()));
+                for (int32_t r = 0; r < readers.size(); ++r)
+                {
+                    numerics[r] = readers[r]->getNumericDocValues(field);
+                    binaries[r] = readers[r]->getBinaryDocValues(field);
+                    sorteds[r] = readers[r]->getSortedDocValues(field);
+                    if (numerics[r] && (type == -1 || type == DocValuesWriter::TYPE_LONG))
+                        type = numerics[r]->isDouble() ? DocValuesWriter::TYPE_DOUBLE : DocValuesWriter::TYPE_LONG;
+                    else if (binaries[r] && type == -1)
+                        type = DocValuesWriter::TYPE_BINARY;
+                    else if (sorteds[r] && type == -1)
+                        type = DocValuesWriter::TYPE_SORTED;
+                }
+                if (type == -1)
+                    continue;
+                
+                if (!writer)
+                {
+                    writer = codec->docValuesWriter(directory, segment, mergedDocs);
+                    hasDocValues = true;
+                }
+                
+                if (type == DocValuesWriter::TYPE_LONG || type == DocValuesWriter::TYPE_DOUBLE)
+                {
+                    bool isDouble = (type == DocValuesWriter::TYPE_DOUBLE);
+                    Collection<int64_t> values(Collection<int64_t>::newInstance(mergedDocs));
+                    int32_t docUpto = 0;
+                    for (int32_t r = 0; r < readers.size(); ++r)
+                    {
+                        NumericDocValuesPtr numeric(numerics[r]);
+                        int32_t maxDoc = readers[r]->maxDoc();
+                        for (int32_t j = 0; j < maxDoc; ++j)
+                        {
+                            if (readers[r]->isDeleted(j))
+                                continue;
+                            if (numeric && isDouble)
+                                values[sortedDoc(docUpto)] = MiscUtils::doubleToLongBits(numeric->getDouble(j));
+                            else if (numeric)
+                                values[sortedDoc(docUpto)] = numeric->getLong(j);
+                            ++docUpto;
+                        }
+                        checkAbort->work(maxDoc);
+                    }
+                    writer->addNumericField(field, values, isDouble);
+                }
+                else if (type == DocValuesWriter::TYPE_BINARY)
+                {
+                    Collection<ByteArray> values(Collection<ByteArray>::newInstance(mergedDocs));
+                    UTF8ResultPtr scratch(newLucene<UTF8Result>());
+                    int32_t docUpto = 0;
+                    for (int32_t r = 0; r < readers.size(); ++r)
+                    {
+                        BinaryDocValuesPtr binary(binaries[r]);
+                        int32_t maxDoc = readers[r]->maxDoc();
+                        for (int32_t j = 0; j < maxDoc; ++j)
+                        {
+                            if (readers[r]->isDeleted(j))
+                                continue;
+                            if (binary)
+                            {
+                                binary->get(j, scratch);
+                                ByteArray value(ByteArray::newInstance(scratch->length));
+                                if (scratch->length > 0)
+                                    MiscUtils::arrayCopy(scratch->result.get(), 0, value.get(), 0, scratch->length);
+                                values[sortedDoc(docUpto)] = value;
+                            }
+                            ++docUpto;
+                        }
+                        checkAbort->work(maxDoc);
+                    }
+                    writer->addBinaryField(field, values);
+                }
+                else
+                {
+                    // the merged dictionary is the sorted union of the segments' dictionaries
+                    Collection<String> dictionary(Collection<String>::newInstance());
+                    for (int32_t r = 0; r < readers.size(); ++r)
+                    {
+                        if (!sorteds[r])
+                            continue;
+                        for (int32_t ord = 0; ord < sorteds[r]->getValueCount(); ++ord)
+                            dictionary.add(sorteds[r]->lookup(ord));
+                    }
+                    std::sort(dictionary.begin(), dictionary.end());
+                    dictionary.remove(std::unique(dictionary.begin(), dictionary.end()), dictionary.end());
+                    
+                    Collection<int32_t> ords(Collection<int32_t>::newInstance(mergedDocs));
+                    int32_t docUpto = 0;
+                    for (int32_t r = 0; r < readers.size(); ++r)
+                    {
+                        SortedDocValuesPtr sorted(sorteds[r]);
+                        int32_t maxDoc = readers[r]->maxDoc();
+                        
+                        // map the segment's ordinals to merged ordinals once, rather than per document
+                        Collection<int32_t> ordMap;
+                        if (sorted)
+                        {
+                            ordMap = Collection<int32_t>::newInstance(sorted->getValueCount());
+                            for (int32_t ord = 0; ord < ordMap.size(); ++ord)
+                                ordMap[ord] = std::distance(dictionary.begin(), std::lower_bound(dictionary.begin(), dictionary.end(), sorted->lookup(ord)));
+                        }
+                        
+                        for (int32_t j = 0; j < maxDoc; ++j)
+                        {
+                            if (readers[r]->isDeleted(j))
+                                continue;
+                            int32_t ord = sorted ? sorted->getOrd(j) : -1;
+                            ords[sortedDoc(docUpto++)] = ord == -1 ? -1 : ordMap[ord];
+                        }
+                        checkAbort->work(maxDoc);
+                    }
+                    writer->addSortedField(field, dictionary, ords);
+                }
+            }
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        if (writer)
+            writer->close();
+        finally.throwException();
+    }
+    
     CheckAbort::CheckAbort(OneMergePtr merge, DirectoryPtr dir)
     {
         workCount = 0;
@@ -24,11 +24,15 @@
 #include "SegmentTermPositions.h"
 #include "SegmentInfo.h"
 #include "SegmentMerger.h"
+#include "_NormValues.h"
 #include "AllTermDocs.h"
 #include "DefaultSimilarity.h"
 #include "FieldCache.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "Codec.h"
+#include "DocValuesReader.h"
 
 namespace Lucene
 {
@@ -475,13 +479,13 @@ namespace Lucene
     TermDocsPtr SegmentReader::termDocs()
     {
         ensureOpen();
-        return newLucene<SegmentTermDocs>(shared_from_this());
+        return core->codec->termDocs(shared_from_this());
     }
     
     TermPositionsPtr SegmentReader::termPositions()
     {
         ensureOpen();
-        return newLucene<SegmentTermPositions>(shared_from_this());
+        return core->codec->termPositions(shared_from_this());
     }
     
     int32_t SegmentReader::docFreq(TermPtr t)
@@ -491,6 +495,16 @@ namespace Lucene
         return ti ? ti->docFreq : 0;
     }
     
+    Collection<int32_t> SegmentReader::docFreqs(Collection<TermPtr> terms)
+    {
+        ensureOpen();
+        Collection<TermInfoPtr> infos(core->getTermsReader()->get(terms));
+        Collection<int32_t> result(Collection<int32_t>::newInstance(terms.size()));
+        for (int32_t i = 0; i < terms.size(); ++i)
+            result[i] = infos[i] ? infos[i]->docFreq : 0;
+        return result;
+    }
+    
     int32_t SegmentReader::numDocs()
     {
         // Don't call ensureOpen() here (it could affect performance)
@@ -560,6 +574,23 @@ namespace Lucene
         return getNorms(field);
     }
     
+    NormValuesPtr SegmentReader::normValues(const String& field)
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        NormPtr norm(_norms.get(field));
+        return norm ? norm->values() : NormValuesPtr();
+    }
+    
+    bool SegmentReader::normsChanged(const String& field)
+    {
+        SyncLock syncLock(this);
+        NormPtr norm(_norms.get(field));
+        if (!norm)
+            return false;
+        return (norm->dirty || si->hasSeparateNorms(norm->number));
+    }
+    
     void SegmentReader::doSetNorm(int32_t doc, const String& field, uint8_t value)
     {
         NormPtr norm(_norms.get(field));
@@ -587,55 +618,108 @@ namespace Lucene
         norm->bytes(norms.get(), offset, maxDoc());
     }
     
+    NumericDocValuesPtr SegmentReader::getNumericDocValues(const String& field)
+    {
+        ensureOpen();
+        return core->docValuesReader ? core->docValuesReader->getNumeric(field) : NumericDocValuesPtr();
+    }
+    
+    BinaryDocValuesPtr SegmentReader::getBinaryDocValues(const String& field)
+    {
+        ensureOpen();
+        return core->docValuesReader ? core->docValuesReader->getBinary(field) : BinaryDocValuesPtr();
+    }
+    
+    SortedDocValuesPtr SegmentReader::getSortedDocValues(const String& field)
+    {
+        ensureOpen();
+        return core->docValuesReader ? core->docValuesReader->getSorted(field) : SortedDocValuesPtr();
+    }
+    
     void SegmentReader::openNorms(DirectoryPtr cfsDir, int32_t readBufferSize)
     {
-        int64_t nextNormSeek = SegmentMerger::NORMS_HEADER_LENGTH; // skip header (header unused for now)
+        int64_t nextNormSeek = SegmentMerger::NORMS_HEADER_LENGTH; // skip header
         int32_t _maxDoc = maxDoc();
+        int32_t numNormFields = 0;
         for (int32_t i = 0; i < core->fieldInfos->size(); ++i)
         {
             FieldInfoPtr fi(core->fieldInfos->fieldInfo(i));
+            if (fi->isIndexed && !fi->omitNorms)
+                ++numNormFields;
+        }
+        
+        // positions of the encoded entries in the .nrm file, null for a file of raw bytes
+        Collection<int64_t> normEntries;
+        bool normEntriesRead = false;
+        
+        int32_t normField = 0;
+        for (int32_t i = 0; i < core->fieldInfos->size(); ++i)
+        {
+            FieldInfoPtr fi(core->fieldInfos->fieldInfo(i));
+            if (!fi->isIndexed || fi->omitNorms)
+                continue;
             if (_norms.contains(fi->name))
             {
                 // in case this SegmentReader is being re-opened, we might be able to reuse some norm 
                 // instances and skip loading them here
+                ++normField;
+                nextNormSeek += _maxDoc;
                 continue;
             }
-            if (fi->isIndexed && !fi->omitNorms)
+            
+            DirectoryPtr d(directory());
+            String fileName(si->getNormFileName(fi->number));
+            if (!si->hasSeparateNorms(fi->number))
+                d = cfsDir;
+            
+            // singleNormFile means multiple norms share this file
+            bool singleNormFile = boost::ends_with(fileName, String(L".") + IndexFileNames::NORMS_EXTENSION());
+            IndexInputPtr normInput;
+            int64_t normSeek;
+            bool encoded = false;
+            
+            if (singleNormFile)
             {
-                DirectoryPtr d(directory());
-                String fileName(si->getNormFileName(fi->number));
-                if (!si->hasSeparateNorms(fi->number))
-                    d = cfsDir;
-                
-                // singleNormFile means multiple norms share this file
-                bool singleNormFile = boost::ends_with(fileName, String(L".") + IndexFileNames::NORMS_EXTENSION());
-                IndexInputPtr normInput;
-                int64_t normSeek;
-                
-                if (singleNormFile)
+                if (!normEntriesRead)
                 {
-                    normSeek = nextNormSeek;
-                    if (!singleNormStream)
+                    IndexInputPtr entriesInput(d->openInput(fileName));
+                    LuceneException finally;
+                    try
                     {
-                        singleNormStream = d->openInput(fileName, readBufferSize);
-                        singleNormRef = newLucene<SegmentReaderRef>();
+                        normEntries = core->codec->readNormEntries(entriesInput, numNormFields);
                     }
-                    else
-                        singleNormRef->incRef();
-                    
-                    // All norms in the .nrm file can share a single IndexInput since they are only used in 
-                    // a synchronized context.  If this were to change in the future, a clone could be done here.
-                    normInput = singleNormStream;
+                    catch (LuceneException& e)
+                    {
+                        finally = e;
+                    }
+                    entriesInput->close();
+                    finally.throwException();
+                    normEntriesRead = true;
                 }
-                else
+                
+                encoded = normEntries;
+                normSeek = encoded ? normEntries[normField] : nextNormSeek;
+                if (!singleNormStream)
                 {
-                    normSeek = 0;
-                    normInput = d->openInput(fileName);
+                    singleNormStream = d->openInput(fileName, readBufferSize);
+                    singleNormRef = newLucene<SegmentReaderRef>();
                 }
+                else
+                    singleNormRef->incRef();
                 
-                _norms.put(fi->name, newLucene<Norm>(shared_from_this(), normInput, fi->number, normSeek));
-                nextNormSeek += _maxDoc; // increment also if some norms are separate
+                // All norms in the .nrm file can share a single IndexInput since they are only used in 
+                // a synchronized context.  If this were to change in the future, a clone could be done here.
+                normInput = singleNormStream;
+            }
+            else
+            {
+                normSeek = 0;
+                normInput = d->openInput(fileName);
             }
+            
+            _norms.put(fi->name, newLucene<Norm>(shared_from_this(), normInput, fi->number, normSeek, encoded));
+            ++normField;
+            nextNormSeek += _maxDoc; // increment also if some norms are separate
         }
     }
     
@@ -840,6 +924,7 @@ namespace Lucene
         ref = newLucene<SegmentReaderRef>();
         
         segment = si->name;
+        codec = si->getCodec();
         this->readBufferSize = readBufferSize;
         this->dir = dir;
         
@@ -858,7 +943,7 @@ namespace Lucene
             fieldInfos = newLucene<FieldInfos>(cfsDir, segment + L"." + IndexFileNames::FIELD_INFOS_EXTENSION());
             
             this->termsIndexDivisor = termsIndexDivisor;
-            TermInfosReaderPtr reader(newLucene<TermInfosReader>(cfsDir, segment, fieldInfos, readBufferSize, termsIndexDivisor));
+            TermInfosReaderPtr reader(codec->termsReader(cfsDir, segment, fieldInfos, readBufferSize, termsIndexDivisor));
             if (termsIndexDivisor == -1)
                 tisNoIndex = reader;
             else
@@ -866,10 +951,13 @@ namespace Lucene
             
             // make sure that all index files have been read or are kept open so that if an index 
             // update removes them we'll still have them
-            freqStream = cfsDir->openInput(segment + L"." + IndexFileNames::FREQ_EXTENSION(), readBufferSize);
+            freqStream = codec->freqInput(cfsDir, segment, readBufferSize);
             
             if (fieldInfos->hasProx())
-                proxStream = cfsDir->openInput(segment + L"." + IndexFileNames::PROX_EXTENSION(), readBufferSize);
+                proxStream = codec->proxInput(cfsDir, segment, readBufferSize);
+            
+            if (cfsDir->fileExists(segment + L"." + IndexFileNames::DOC_VALUES_EXTENSION()))
+                docValuesReader = codec->docValuesReader(cfsDir, segment, readBufferSize);
         
             success = true;
         }
@@ -944,7 +1032,7 @@ namespace Lucene
             else
                 dir0 = dir;
             
-            tis = newLucene<TermInfosReader>(dir0, segment, fieldInfos, readBufferSize, termsIndexDivisor);
+            tis = codec->termsReader(dir0, segment, fieldInfos, readBufferSize, termsIndexDivisor);
         }
     }
     
@@ -965,6 +1053,8 @@ namespace Lucene
                 freqStream->close();
             if (proxStream)
                 proxStream->close();
+            if (docValuesReader)
+                docValuesReader->close();
             if (termVectorsReaderOrig)
                 termVectorsReaderOrig->close();
             if (fieldsReaderOrig)
@@ -1021,7 +1111,7 @@ namespace Lucene
             
             String storesSegment(si->getDocStoreOffset() != -1 ? si->getDocStoreSegment() : segment);
             
-            fieldsReaderOrig = newLucene<FieldsReader>(storeDir, storesSegment, fieldInfos, readBufferSize, si->getDocStoreOffset(), si->docCount);
+            fieldsReaderOrig = codec->fieldsReader(storeDir, storesSegment, fieldInfos, readBufferSize, si->getDocStoreOffset(), si->docCount);
             
             // Verify two sources of "maxDoc" agree
             if (si->getDocStoreOffset() == -1 && fieldsReaderOrig->size() != si->docCount)
@@ -1032,7 +1122,7 @@ namespace Lucene
             }
             
             if (fieldInfos->hasVectors()) // open term vector files only as needed
-                termVectorsReaderOrig = newLucene<TermVectorsReader>(storeDir, storesSegment, fieldInfos, readBufferSize, si->getDocStoreOffset(), si->docCount);
+                termVectorsReaderOrig = codec->termVectorsReader(storeDir, storesSegment, fieldInfos, readBufferSize, si->getDocStoreOffset(), si->docCount);
         }
     }
     
@@ -1086,12 +1176,14 @@ namespace Lucene
     {
         this->refCount = 1;
         this->normSeek = 0;
+        this->encoded = false;
+        this->valuesMapped = false;
         this->dirty = false;
         this->rollbackDirty = false;
         this->number = 0;
     }
     
-    Norm::Norm(SegmentReaderPtr reader, IndexInputPtr in, int32_t number, int64_t normSeek)
+    Norm::Norm(SegmentReaderPtr reader, IndexInputPtr in, int32_t number, int64_t normSeek, bool encoded)
     {
         this->_reader = reader;
         this->refCount = 1;
@@ -1100,6 +1192,8 @@ namespace Lucene
         this->in = in;
         this->number = number;
         this->normSeek = normSeek;
+        this->encoded = encoded;
+        this->valuesMapped = false;
     }
     
     Norm::~Norm()
@@ -1155,6 +1249,8 @@ namespace Lucene
             if (origReader)
                 origReader.reset();
             
+            _values.reset();
+            
             if (_bytes)
             {
                 BOOST_ASSERT(_bytesRef);
@@ -1187,6 +1283,14 @@ namespace Lucene
                 // Ask origNorm to load
                 origNorm->bytes(bytesOut, offset, length);
             }
+            else if (_values)
+                _values->copyTo(bytesOut, offset, length);
+            else if (encoded)
+            {
+                // We are orig - decode ourselves from disk
+                bool mapped = false;
+                readValues(mapped)->copyTo(bytesOut, offset, length);
+            }
             else
             {
                 // We are orig - read ourselves from disk
@@ -1222,24 +1326,67 @@ namespace Lucene
                 int32_t count = SegmentReaderPtr(_reader)->maxDoc();
                 _bytes = ByteArray::newInstance(count);
                 
-                // Since we are orig, in must not be null
-                BOOST_ASSERT(in);
-                
-                // Read from disk.
+                if (_values)
+                    _values->copyTo(_bytes.get(), 0, count);
+                else
                 {
-                    SyncLock instancesLock(in);
-                    in->seek(normSeek);
-                    in->readBytes(_bytes.get(), 0, count, false);
+                    // Since we are orig, in must not be null
+                    BOOST_ASSERT(in);
+                    
+                    // Read from disk.
+                    if (encoded)
+                    {
+                        bool mapped = false;
+                        readValues(mapped)->copyTo(_bytes.get(), 0, count);
+                    }
+                    else
+                    {
+                        SyncLock instancesLock(in);
+                        in->seek(normSeek);
+                        in->readBytes(_bytes.get(), 0, count, false);
+                    }
                 }
                 
                 _bytesRef = newLucene<SegmentReaderRef>();
-                closeInput();
+                if (!valuesMapped)
+                    closeInput();
             }
         }
         
         return _bytes;
     }
     
+    NormValuesPtr Norm::values()
+    {
+        SyncLock syncLock(this);
+        BOOST_ASSERT(refCount > 0 && (!origNorm || origNorm->refCount > 0));
+        if (_bytes)
+            return newLucene<DenseNormValues>(_bytes);
+        if (origNorm)
+        {
+            // Share the values of the origNorm between reopened and cloned readers
+            return origNorm->values();
+        }
+        if (!_values)
+        {
+            // Since we are orig, in must not be null
+            BOOST_ASSERT(in);
+            _values = readValues(valuesMapped);
+            
+            // A memory mapped input must stay open for as long as the values are used
+            if (!valuesMapped)
+                closeInput();
+        }
+        return _values;
+    }
+    
+    NormValuesPtr Norm::readValues(bool& mapped)
+    {
+        SyncLock instancesLock(in);
+        SegmentReaderPtr reader(_reader);
+        return reader->core->codec->readNorms(in, normSeek, reader->maxDoc(), encoded, mapped);
+    }
+    
     SegmentReaderRefPtr Norm::bytesRef()
     {
         return _bytesRef;
@@ -1277,6 +1424,7 @@ namespace Lucene
         cloneNorm->origNorm = origNorm;
         cloneNorm->origReader = origReader;
         cloneNorm->normSeek = normSeek;
+        cloneNorm->encoded = encoded;
         cloneNorm->_bytesRef = _bytesRef;
         cloneNorm->_bytes = _bytes;
         cloneNorm->dirty = dirty;
@@ -1319,7 +1467,7 @@ namespace Lucene
         si->advanceNormGen(this->number);
         String normFileName(si->getNormFileName(this->number));
         SegmentReaderPtr reader(_reader);
-        IndexOutputPtr out(reader->directory()->createOutput(normFileName));
+        IndexOutputPtr out(newLucene<ChecksumFooterIndexOutput>(reader->directory()->createOutput(normFileName)));
         bool success = false;
         LuceneException finally;
         try
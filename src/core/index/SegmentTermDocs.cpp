@@ -11,12 +11,14 @@
 #include "SegmentTermEnum.h"
 #include "IndexInput.h"
 #include "TermInfosReader.h"
+#include "TermInfosWriter.h"
 #include "FieldInfos.h"
 #include "FieldInfo.h"
 #include "Term.h"
 #include "TermInfo.h"
 #include "DefaultSkipListReader.h"
 #include "BitVector.h"
+#include "BlockPackedInts.h"
 #include "MiscUtils.h"
 
 namespace Lucene
@@ -34,6 +36,10 @@ namespace Lucene
         this->haveSkipped = false;
         this->currentFieldStoresPayloads = false;
         this->currentFieldOmitTermFreqAndPositions = false;
+        this->currentFieldFreqImpacts = false;
+        this->currentFieldNormImpacts = false;
+        this->bufferUpto = 0;
+        this->bufferCount = 0;
         
         this->_freqStream = boost::dynamic_pointer_cast<IndexInput>(parent->core->freqStream->clone());
         {
@@ -42,6 +48,12 @@ namespace Lucene
         }
         this->skipInterval = parent->core->getTermsReader()->getSkipInterval();
         this->maxSkipLevels = parent->core->getTermsReader()->getMaxSkipLevels();
+        if (parent->core->getTermsReader()->getPostingsFormat() == TermInfosWriter::POSTINGS_FORMAT_BLOCK_PACKED)
+        {
+            this->blockPacker = newLucene<BlockPackedInts>();
+            this->docBuffer = IntArray::newInstance(BlockPackedInts::BLOCK_SIZE);
+            this->freqBuffer = IntArray::newInstance(BlockPackedInts::BLOCK_SIZE);
+        }
     }
     
     SegmentTermDocs::~SegmentTermDocs()
@@ -80,9 +92,16 @@ namespace Lucene
     void SegmentTermDocs::seek(TermInfoPtr ti, TermPtr term)
     {
         count = 0;
-        FieldInfoPtr fi(SegmentReaderPtr(_parent)->core->fieldInfos->fieldInfo(term->_field));
+        bufferUpto = 0;
+        bufferCount = 0;
+        SegmentReaderPtr parent(_parent);
+        FieldInfoPtr fi(parent->core->fieldInfos->fieldInfo(term->_field));
         currentFieldOmitTermFreqAndPositions = fi ? fi->omitTermFreqAndPositions : false;
         currentFieldStoresPayloads = fi ? fi->storePayloads : false;
+        bool skipImpacts = (fi && parent->core->getTermsReader()->hasSkipImpacts());
+        currentFieldFreqImpacts = (skipImpacts && !fi->omitTermFreqAndPositions);
+        // norms changed since the segment was written are not bounded by those in its skip data
+        currentFieldNormImpacts = (skipImpacts && !fi->omitNorms && !parent->normsChanged(fi->name));
         if (!ti)
             df = 0;
         else
@@ -124,23 +143,7 @@ namespace Lucene
         {
             if (count == df)
                 return false;
-            int32_t docCode = _freqStream->readVInt();
-            
-            if (currentFieldOmitTermFreqAndPositions)
-            {
-                _doc += docCode;
-                _freq = 1;
-            }
-            else
-            {
-                _doc += MiscUtils::unsignedShift(docCode, 1); // shift off low bit
-                if ((docCode & 1) != 0) // if low bit is set
-                    _freq = 1; // freq is one
-                else
-                    _freq = _freqStream->readVInt(); // else read freq
-            }
-            
-            ++count;
+            readDoc();
             
             if (!deletedDocs || !deletedDocs->get(_doc))
                 break;
@@ -149,10 +152,83 @@ namespace Lucene
         return true;
     }
     
+    void SegmentTermDocs::readDoc()
+    {
+        if (bufferUpto < bufferCount || refillBuffer())
+        {
+            _doc = docBuffer[bufferUpto];
+            _freq = freqBuffer[bufferUpto++];
+        }
+        else if (currentFieldOmitTermFreqAndPositions)
+        {
+            _doc += _freqStream->readVInt();
+            _freq = 1;
+        }
+        else
+        {
+            int32_t docCode = _freqStream->readVInt();
+            _doc += MiscUtils::unsignedShift(docCode, 1); // shift off low bit
+            if ((docCode & 1) != 0) // if low bit is set
+                _freq = 1; // freq is one
+            else
+                _freq = _freqStream->readVInt(); // else read freq
+        }
+        ++count;
+    }
+    
+    bool SegmentTermDocs::refillBuffer()
+    {
+        if (!blockPacker || df - count < BlockPackedInts::BLOCK_SIZE)
+            return false;
+        int32_t* docs = docBuffer.get();
+        int32_t* freqs = freqBuffer.get();
+        blockPacker->readBlock(_freqStream, docs);
+        BlockPackedInts::prefixSum(docs, BlockPackedInts::BLOCK_SIZE, _doc);
+        if (currentFieldOmitTermFreqAndPositions)
+            std::fill(freqs, freqs + BlockPackedInts::BLOCK_SIZE, 1);
+        else
+        {
+            blockPacker->readBlock(_freqStream, freqs);
+            for (int32_t i = 0; i < BlockPackedInts::BLOCK_SIZE; ++i)
+                ++freqs[i];
+        }
+        bufferUpto = 0;
+        bufferCount = BlockPackedInts::BLOCK_SIZE;
+        return true;
+    }
+    
     int32_t SegmentTermDocs::read(Collection<int32_t> docs, Collection<int32_t> freqs)
     {
         int32_t length = docs.size();
-        if (currentFieldOmitTermFreqAndPositions)
+        if (blockPacker)
+        {
+            int32_t i = 0;
+            while (i < length && count < df)
+            {
+                if (!deletedDocs && (bufferUpto < bufferCount || refillBuffer()))
+                {
+                    // copy as much of the decoded block as fits
+                    int32_t n = std::min(length - i, bufferCount - bufferUpto);
+                    MiscUtils::arrayCopy(docBuffer.get(), bufferUpto, docs.begin(), i, n);
+                    MiscUtils::arrayCopy(freqBuffer.get(), bufferUpto, freqs.begin(), i, n);
+                    bufferUpto += n;
+                    count += n;
+                    i += n;
+                    _doc = docs[i - 1];
+                    _freq = freqs[i - 1];
+                    continue;
+                }
+                readDoc();
+                if (!deletedDocs || !deletedDocs->get(_doc))
+                {
+                    docs[i] = _doc;
+                    freqs[i] = _freq;
+                    ++i;
+                }
+            }
+            return i;
+        }
+        else if (currentFieldOmitTermFreqAndPositions)
             return readNoTf(docs, freqs, length);
         else
         {
@@ -204,20 +280,31 @@ namespace Lucene
     {
     }
     
+    bool SegmentTermDocs::initSkipList()
+    {
+        if (blockPacker ? df <= skipInterval : df < skipInterval)
+            return false;
+        
+        if (!skipListReader)
+            skipListReader = newLucene<DefaultSkipListReader>(boost::dynamic_pointer_cast<IndexInput>(_freqStream->clone()), maxSkipLevels, skipInterval); // lazily clone
+        
+        if (!haveSkipped) // lazily initialize skip stream
+        {
+            // block packed skip points follow full blocks, so the last one is before the last doc
+            skipListReader->init(skipPointer, freqBasePointer, proxBasePointer, blockPacker ? df - 1 : df, currentFieldStoresPayloads, 
+                                 currentFieldFreqImpacts, currentFieldNormImpacts);
+            haveSkipped = true;
+        }
+        return true;
+    }
+    
     bool SegmentTermDocs::skipTo(int32_t target)
     {
-        if (df >= skipInterval) // optimized case
+        if (initSkipList()) // optimized case
         {
-            if (!skipListReader)
-                skipListReader = newLucene<DefaultSkipListReader>(boost::dynamic_pointer_cast<IndexInput>(_freqStream->clone()), maxSkipLevels, skipInterval); // lazily clone
-            
-            if (!haveSkipped) // lazily initialize skip stream
-            {
-                skipListReader->init(skipPointer, freqBasePointer, proxBasePointer, df, currentFieldStoresPayloads);
-                haveSkipped = true;
-            }
-            
             int32_t newCount = skipListReader->skipTo(target);
+            if (blockPacker)
+                ++newCount; // count docs up to the end of the skipped block
             if (newCount > count)
             {
                 _freqStream->seek(skipListReader->getFreqPointer());
@@ -225,6 +312,8 @@ namespace Lucene
 
                 _doc = skipListReader->getDoc();
                 count = newCount;
+                bufferUpto = 0;
+                bufferCount = 0;
             }
         }
         
@@ -238,6 +327,24 @@ namespace Lucene
         return true;
     }
     
+    int32_t SegmentTermDocs::advanceShallow(int32_t target, int32_t& maxFreq, int32_t& maxNorm)
+    {
+        maxFreq = currentFieldOmitTermFreqAndPositions ? 1 : INT_MAX;
+        maxNorm = 0xff;
+        if (!initSkipList())
+            return INT_MAX;
+        
+        skipListReader->skipTo(std::max(target, 1));
+        if (!skipListReader->hasImpacts(0))
+            return INT_MAX; // past the last skip entry
+        
+        if (currentFieldFreqImpacts)
+            maxFreq = skipListReader->getMaxFreq(0);
+        if (currentFieldNormImpacts)
+            maxNorm = skipListReader->getMaxNorm(0);
+        return skipListReader->getImpactDocUpTo(0);
+    }
+    
     IndexInputPtr SegmentTermDocs::freqStream()
     {
         return _freqStream;
@@ -28,6 +28,8 @@ namespace Lucene
         indexInterval = 0;
         skipInterval = 0;
         maxSkipLevels = 0;
+        postingsFormat = TermInfosWriter::POSTINGS_FORMAT_VINT;
+        skipImpacts = false;
         
         isIndex = false;
         maxSkipLevels = 0;
@@ -47,6 +49,8 @@ namespace Lucene
         indexInterval = 0;
         skipInterval = 0;
         maxSkipLevels = 0;
+        postingsFormat = TermInfosWriter::POSTINGS_FORMAT_VINT;
+        skipImpacts = false;
         
         input = i;
         fieldInfos = fis;
@@ -94,6 +98,13 @@ namespace Lucene
                     // this new format introduces multi-level skipping
                     maxSkipLevels = input->readInt();
                 }
+                if (format <= TermInfosWriter::FORMAT_VERSION_POSTINGS_FORMAT)
+                {
+                    postingsFormat = input->readInt();
+                    if (postingsFormat != TermInfosWriter::POSTINGS_FORMAT_VINT && postingsFormat != TermInfosWriter::POSTINGS_FORMAT_BLOCK_PACKED)
+                        boost::throw_exception(CorruptIndexException(L"Unknown postings format:" + StringUtils::toString(postingsFormat)));
+                }
+                skipImpacts = (format <= TermInfosWriter::FORMAT_VERSION_SKIP_IMPACTS);
             }
             
             BOOST_ASSERT(indexInterval > 0); // must not be negative
@@ -125,6 +136,8 @@ namespace Lucene
         cloneEnum->indexInterval = indexInterval;
         cloneEnum->skipInterval = skipInterval;
         cloneEnum->maxSkipLevels = maxSkipLevels;
+        cloneEnum->postingsFormat = postingsFormat;
+        cloneEnum->skipImpacts = skipImpacts;
         
         cloneEnum->input = boost::dynamic_pointer_cast<IndexInput>(input->clone());
         cloneEnum->_termInfo = newLucene<TermInfo>(_termInfo);
@@ -145,6 +158,15 @@ namespace Lucene
         _termInfo->set(ti);
     }
     
+    void SegmentTermEnum::seek(int64_t pointer, int64_t p, const String& field, const uint8_t* text, int32_t textLength, TermInfoPtr ti)
+    {
+        input->seek(pointer);
+        position = p;
+        termBuffer->set(field, text, textLength);
+        prevBuffer->reset();
+        _termInfo->set(ti);
+    }
+    
     bool SegmentTermEnum::next()
     {
         if (position++ >= size - 1)
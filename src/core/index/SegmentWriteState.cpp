@@ -6,6 +6,8 @@
 
 #include "LuceneInc.h"
 #include "SegmentWriteState.h"
+#include "TermInfosWriter.h"
+#include "Codec.h"
 
 namespace Lucene
 {
@@ -20,7 +22,10 @@ namespace Lucene
         this->numDocs = numDocs;
         this->numDocsInStore = numDocsInStore;
         this->termIndexInterval = termIndexInterval;
+        this->postingsFormat = TermInfosWriter::POSTINGS_FORMAT_VINT;
+        this->codec = Codec::getDefault();
         this->flushedFiles = HashSet<String>::newInstance();
+        this->fieldNorms = MapStringNormValues::newInstance();
     }
     
     SegmentWriteState::~SegmentWriteState()
@@ -0,0 +1,97 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "SortedDocValues.h"
+#include "DocValuesReader.h"
+#include "IndexInput.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    SortedDocValues::SortedDocValues(IndexInputPtr input)
+    {
+        this->input = input;
+        numDocs = input->readInt();
+        numOrds = input->readInt();
+        ordWidth = input->readByte();
+        ordPointer = input->getFilePointer();
+        input->seek(ordPointer + (int64_t)numDocs * ordWidth);
+        addressWidth = input->readByte();
+        addressPointer = input->getFilePointer();
+        dataPointer = addressPointer + (int64_t)(numOrds + 1) * addressWidth;
+        scratch = newLucene<UTF8Result>();
+    }
+    
+    SortedDocValues::~SortedDocValues()
+    {
+    }
+    
+    int32_t SortedDocValues::size()
+    {
+        return numDocs;
+    }
+    
+    int32_t SortedDocValues::getValueCount()
+    {
+        return numOrds;
+    }
+    
+    int32_t SortedDocValues::getOrd(int32_t doc)
+    {
+        if (doc < 0 || doc >= numDocs)
+            boost::throw_exception(IndexOutOfBoundsException());
+        input->seek(ordPointer + (int64_t)doc * ordWidth);
+        return (int32_t)DocValuesReader::readFixed(input, ordWidth) - 1;
+    }
+    
+    void SortedDocValues::lookupOrd(int32_t ord, UTF8ResultPtr result)
+    {
+        if (ord < 0 || ord >= numOrds)
+            boost::throw_exception(IndexOutOfBoundsException());
+        input->seek(addressPointer + (int64_t)ord * addressWidth);
+        int64_t start = (int64_t)DocValuesReader::readFixed(input, addressWidth);
+        int32_t length = (int32_t)((int64_t)DocValuesReader::readFixed(input, addressWidth) - start);
+        result->setLength(length);
+        if (length > 0)
+        {
+            input->seek(dataPointer + start);
+            input->readBytes(result->result.get(), 0, length);
+        }
+    }
+    
+    String SortedDocValues::lookup(int32_t ord)
+    {
+        lookupOrd(ord, scratch);
+        return StringUtils::toUnicode(scratch->result.get(), scratch->length);
+    }
+    
+    String SortedDocValues::getString(int32_t doc)
+    {
+        int32_t ord = getOrd(doc);
+        return ord == -1 ? L"" : lookup(ord);
+    }
+    
+    int32_t SortedDocValues::lookupTerm(const String& value)
+    {
+        int32_t low = 0;
+        int32_t high = numOrds - 1;
+        while (low <= high)
+        {
+            int32_t mid = MiscUtils::unsignedShift(low + high, 1);
+            int32_t cmp = lookup(mid).compare(value);
+            if (cmp < 0)
+                low = mid + 1;
+            else if (cmp > 0)
+                high = mid - 1;
+            else
+                return mid;
+        }
+        return -(low + 1);
+    }
+}
@@ -10,6 +10,8 @@
 #include "RAMOutputStream.h"
 #include "SegmentWriteState.h"
 #include "FieldsWriter.h"
+#include "DocumentsWriter.h"
+#include "Codec.h"
 #include "IndexFileNames.h"
 #include "IndexWriter.h"
 #include "Directory.h"
@@ -64,7 +66,7 @@ namespace Lucene
             String docStoreSegment(docWriter->getDocStoreSegment());
             if (!docStoreSegment.empty())
             {
-                fieldsWriter = newLucene<FieldsWriter>(docWriter->directory, docStoreSegment, fieldInfos);
+                fieldsWriter = docWriter->getCodec()->fieldsWriter(docWriter->directory, docStoreSegment, fieldInfos);
                 docWriter->addOpenFile(docStoreSegment + L"." + IndexFileNames::FIELDS_EXTENSION());
                 docWriter->addOpenFile(docStoreSegment + L"." + IndexFileNames::FIELDS_INDEX_EXTENSION());
                 lastDocID = 0;
@@ -84,6 +86,7 @@ namespace Lucene
         
         if (fieldsWriter)
         {
+            int32_t numDocs = fieldsWriter->getNumDocs();
             fieldsWriter->close();
             fieldsWriter.reset();
             lastDocID = 0;
@@ -97,12 +100,11 @@ namespace Lucene
             
             String fileName(state->docStoreSegmentName + L"." + IndexFileNames::FIELDS_INDEX_EXTENSION());
             
-            if (4 + ((int64_t)state->numDocsInStore) * 8 != state->directory->fileLength(fileName))
+            if (numDocs != state->numDocsInStore)
             {
-                boost::throw_exception(RuntimeException(L"after flush: fdx size mismatch: " + StringUtils::toString(state->numDocsInStore) + 
-                                                        L" docs vs " + StringUtils::toString(state->directory->fileLength(fileName)) + 
-                                                        L" length in bytes of " + fileName + L" file exists?=" + 
-                                                        StringUtils::toString(state->directory->fileExists(fileName))));
+                boost::throw_exception(RuntimeException(L"after flush: fdx doc count mismatch: " + StringUtils::toString(state->numDocsInStore) + 
+                                                        L" docs vs " + StringUtils::toString(numDocs) + L" docs written to " + 
+                                                        fileName + L" file exists?=" + StringUtils::toString(state->directory->fileExists(fileName))));
             }
         }
     }
@@ -137,6 +139,10 @@ namespace Lucene
             }
             catch (...)
             {
+                // segments flushed before the abort may share these files, so they must still be closed
+                Collection<IndexOutputPtr> streams(fieldsWriter->getOpenStreams());
+                for (Collection<IndexOutputPtr>::iterator stream = streams.begin(); stream != streams.end(); ++stream)
+                    DocumentsWriterPtr(_docWriter)->addUnclosedDocStoreOutput(*stream);
             }
             fieldsWriter.reset();
             lastDocID = 0;
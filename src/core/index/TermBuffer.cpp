@@ -86,6 +86,13 @@ namespace Lucene
         this->term = term;
     }
     
+    void TermBuffer::set(const String& field, const uint8_t* utf8, int32_t length)
+    {
+        StringUtils::toUnicode(utf8, length, text);
+        this->field = field;
+        this->term.reset(); // invalidate cache
+    }
+    
     void TermBuffer::set(TermBufferPtr other)
     {
         text->copyText(other->text);
@@ -55,6 +55,13 @@ namespace Lucene
         return false; // override
     }
     
+    int32_t TermDocs::advanceShallow(int32_t target, int32_t& maxFreq, int32_t& maxNorm)
+    {
+        maxFreq = INT_MAX;
+        maxNorm = 0xff;
+        return INT_MAX;
+    }
+    
     void TermDocs::close()
     {
         BOOST_ASSERT(false);
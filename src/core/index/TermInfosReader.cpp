@@ -10,6 +10,18 @@
 #include "Directory.h"
 #include "IndexFileNames.h"
 #include "Term.h"
+#include "TermInfo.h"
+#include "TermInfosWriter.h"
+#include "FST.h"
+#include "FieldInfos.h"
+#include "FieldInfo.h"
+#include "BloomFilter.h"
+#include "IndexInput.h"
+#include "ByteArrayIndexInput.h"
+#include "ReadBatch.h"
+#include "ChecksumFooter.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
 #include "StringUtils.h"
 
 namespace Lucene
@@ -29,11 +41,30 @@ namespace Lucene
             directory = dir;
             segment = seg;
             fieldInfos = fis;
+            this->indexDivisor = indexDivisor;
             
             origEnum = newLucene<SegmentTermEnum>(directory->openInput(segment + L"." + IndexFileNames::TERMS_EXTENSION(), readBufferSize), fieldInfos, false);
             _size = origEnum->size;
             
+            bool loadedIndexFST = false;
             if (indexDivisor != -1)
+            {
+                IndexInputPtr indexInput(directory->openInput(segment + L"." + IndexFileNames::TERMS_INDEX_EXTENSION(), readBufferSize));
+                try
+                {
+                    loadedIndexFST = loadIndexFST(indexInput);
+                }
+                catch (LuceneException& e)
+                {
+                    finally = e;
+                }
+                indexInput->close();
+                finally.throwException();
+            }
+            
+            if (loadedIndexFST)
+                totalIndexInterval = origEnum->indexInterval * indexDivisor;
+            else if (indexDivisor != -1)
             {
                 // Load terms index
                 totalIndexInterval = origEnum->indexInterval * indexDivisor;
@@ -71,6 +102,22 @@ namespace Lucene
                 // Do not load terms index
                 totalIndexInterval = -1;
             }
+            
+            // the filters only serve lookups, which need the terms index
+            if (indexDivisor != -1 && fieldInfos->hasBloomFilters())
+            {
+                IndexInputPtr bloomInput(directory->openInput(segment + L"." + IndexFileNames::BLOOM_FILTER_EXTENSION(), readBufferSize));
+                try
+                {
+                    loadBloomFilters(bloomInput);
+                }
+                catch (LuceneException& e)
+                {
+                    finally = e;
+                }
+                bloomInput->close();
+                finally.throwException();
+            }
             success = true;
         }
         catch (LuceneException& e)
@@ -98,6 +145,16 @@ namespace Lucene
         return origEnum->skipInterval;
     }
     
+    int32_t TermInfosReader::getPostingsFormat()
+    {
+        return origEnum->postingsFormat;
+    }
+    
+    bool TermInfosReader::hasSkipImpacts()
+    {
+        return origEnum->skipImpacts;
+    }
+    
     void TermInfosReader::close()
     {
         if (origEnum)
@@ -120,28 +177,240 @@ namespace Lucene
             
             // Cache does not have to be thread-safe, it is only used by one thread at the same time
             resources->termInfoCache = newInstance<TermInfoCache>(DEFAULT_CACHE_SIZE);
+            resources->indexKey = newLucene<UTF8Result>();
+            resources->indexKeyFieldLength = -1;
+            resources->indexKeyText = newLucene<UTF8Result>();
+            resources->floorKey = newLucene<UTF8Result>();
+            resources->floorOrdinal = -1;
+            resources->seekFieldKey = newLucene<UTF8Result>();
+            resources->blockEndKey = newLucene<UTF8Result>();
+            resources->blockEndOffset = -1;
+            resources->indexTermInfo = newLucene<TermInfo>();
+            resources->bloomKey = newLucene<UTF8Result>();
             threadResources.set(resources);
         }
         return resources;
     }
     
-    int32_t TermInfosReader::getIndexOffset(TermPtr term)
+    bool TermInfosReader::loadIndexFST(IndexInputPtr input)
+    {
+        if (input->readInt() > TermInfosWriter::FORMAT_VERSION_TERMS_INDEX_FST)
+            return false;
+        input->seek(ChecksumFooter::dataLength(input) - 8);
+        input->seek(input->readLong());
+        if (input->readByte() == 0)
+            return false;
+        
+        FSTPtr fst(newLucene<FST>(input));
+        int32_t numEntries = (int32_t)input->readVLong();
+        input->readVLong(); // length of the entries
+        
+        // only every indexDivisor'th entry is kept, the transducer still maps every index term to its entry
+        int32_t indexSize = 1 + (numEntries - 1) / indexDivisor;
+        indexPointers = Collection<int64_t>::newInstance(indexSize);
+        indexDocFreqs = IntArray::newInstance(indexSize);
+        indexFreqPointers = LongArray::newInstance(indexSize);
+        indexProxPointers = LongArray::newInstance(indexSize);
+        indexSkipOffsets = IntArray::newInstance(indexSize);
+        int64_t indexPointer = 0;
+        int64_t freqPointer = 0;
+        int64_t proxPointer = 0;
+        for (int32_t i = 0; i < numEntries; ++i)
+        {
+            int32_t docFreq = input->readVInt();
+            freqPointer += input->readVLong();
+            proxPointer += input->readVLong();
+            int32_t skipOffset = input->readVInt();
+            indexPointer += input->readVLong();
+            if (i % indexDivisor == 0)
+            {
+                int32_t indexOffset = i / indexDivisor;
+                indexDocFreqs[indexOffset] = docFreq;
+                indexFreqPointers[indexOffset] = freqPointer;
+                indexProxPointers[indexOffset] = proxPointer;
+                indexSkipOffsets[indexOffset] = skipOffset;
+                indexPointers[indexOffset] = indexPointer;
+            }
+        }
+        indexFST = fst;
+        return true;
+    }
+    
+    int32_t TermInfosReader::getIndexOffset(TermPtr term, TermInfosReaderThreadResourcesPtr resources)
+    {
+        if (!indexFST)
+        {
+            // binary search indexTerms
+            Collection<TermPtr>::iterator indexTerm = std::upper_bound(indexTerms.begin(), indexTerms.end(), term, luceneCompare<TermPtr>());
+            return (std::distance(indexTerms.begin(), indexTerm) - 1);
+        }
+        
+        // the key of a term is its field name, a zero byte and then its text
+        UTF8ResultPtr key(resources->indexKey);
+        if (resources->indexKeyFieldLength == -1 || term->_field != resources->indexKeyField)
+        {
+            resources->indexKeyFieldLength = StringUtils::toUTF8(term->_field.c_str(), term->_field.length(), key) + 1;
+            key->setLength(resources->indexKeyFieldLength);
+            key->result[resources->indexKeyFieldLength - 1] = 0;
+            resources->indexKeyField = term->_field;
+        }
+        int32_t fieldLength = resources->indexKeyFieldLength;
+        int32_t textLength = StringUtils::toUTF8(term->_text.c_str(), term->_text.length(), resources->indexKeyText);
+        key->setLength(fieldLength + textLength);
+        MiscUtils::arrayCopy(resources->indexKeyText->result.get(), 0, key->result.get(), fieldLength, textLength);
+        
+        // the first index term is the empty term, so there is always a floor
+        int64_t ordinal = indexFST->floor(key->result.get(), key->length, resources->floorKey);
+        BOOST_ASSERT(ordinal >= 0);
+        resources->floorOrdinal = std::max(ordinal, (int64_t)0);
+        return (int32_t)(resources->floorOrdinal / indexDivisor);
+    }
+    
+    TermPtr TermInfosReader::getIndexTerm(int32_t indexOffset, TermInfosReaderThreadResourcesPtr resources)
     {
-        // binary search indexTerms
-        Collection<TermPtr>::iterator indexTerm = std::upper_bound(indexTerms.begin(), indexTerms.end(), term, luceneCompare<TermPtr>());
-        return (std::distance(indexTerms.begin(), indexTerm) - 1);
+        if (!indexFST)
+            return indexTerms[indexOffset];
+        if (resources->blockEndOffset != indexOffset)
+        {
+            UTF8ResultPtr key(resources->blockEndKey);
+            indexFST->getKey((int64_t)indexOffset * indexDivisor, key);
+            int32_t fieldLength = (int32_t)(std::find(key->result.get(), key->result.get() + key->length, 0) - key->result.get());
+            resources->blockEndTerm = newLucene<Term>(StringUtils::toUnicode(key->result.get(), fieldLength), 
+                                                      StringUtils::toUnicode(key->result.get() + fieldLength + 1, std::max(key->length - fieldLength - 1, 0)));
+            resources->blockEndOffset = indexOffset;
+        }
+        return resources->blockEndTerm;
     }
     
-    void TermInfosReader::seekEnum(SegmentTermEnumPtr enumerator, int32_t indexOffset)
+    void TermInfosReader::seekEnum(SegmentTermEnumPtr enumerator, int32_t indexOffset, TermInfosReaderThreadResourcesPtr resources, int64_t base)
     {
-        enumerator->seek(indexPointers[indexOffset], ((int64_t)indexOffset * (int64_t)totalIndexInterval) - 1, indexTerms[indexOffset], indexInfos[indexOffset]);
+        int64_t position = ((int64_t)indexOffset * (int64_t)totalIndexInterval) - 1;
+        if (!indexFST)
+        {
+            enumerator->seek(indexPointers[indexOffset] - base, position, indexTerms[indexOffset], indexInfos[indexOffset]);
+            return;
+        }
+        
+        // the floor found by getIndexOffset is the entry's key unless the divisor skipped over it
+        UTF8ResultPtr floorKey(resources->floorKey);
+        int64_t ordinal = (int64_t)indexOffset * indexDivisor;
+        if (resources->floorOrdinal != ordinal)
+        {
+            indexFST->getKey(ordinal, floorKey);
+            resources->floorOrdinal = ordinal;
+        }
+        const uint8_t* key = floorKey->result.get();
+        int32_t fieldLength = (int32_t)(std::find(key, key + floorKey->length, 0) - key);
+        UTF8ResultPtr fieldKey(resources->seekFieldKey);
+        if (fieldKey->length != fieldLength || !std::equal(key, key + fieldLength, fieldKey->result.get()))
+        {
+            resources->seekField = StringUtils::toUnicode(key, fieldLength);
+            fieldKey->setLength(fieldLength);
+            MiscUtils::arrayCopy(key, 0, fieldKey->result.get(), 0, fieldLength);
+        }
+        resources->indexTermInfo->set(indexDocFreqs[indexOffset], indexFreqPointers[indexOffset], indexProxPointers[indexOffset], indexSkipOffsets[indexOffset]);
+        enumerator->seek(indexPointers[indexOffset] - base, position, resources->seekField, key + fieldLength + 1, 
+                         std::max(floorKey->length - fieldLength - 1, 0), resources->indexTermInfo);
+    }
+    
+    void TermInfosReader::loadBloomFilters(IndexInputPtr input)
+    {
+        int32_t format = input->readInt();
+        if (format < TermInfosWriter::BLOOM_FILTERS_FORMAT)
+            boost::throw_exception(CorruptIndexException(L"unknown bloom filters format version: " + StringUtils::toString(format)));
+        bloomFilters = Collection<BloomFilterPtr>::newInstance(fieldInfos->size());
+        int32_t numFilters = input->readVInt();
+        for (int32_t i = 0; i < numFilters; ++i)
+        {
+            int32_t fieldNumber = input->readVInt();
+            if (fieldNumber >= bloomFilters.size())
+                boost::throw_exception(CorruptIndexException(L"invalid field number in bloom filters: " + StringUtils::toString(fieldNumber)));
+            bloomFilters[fieldNumber] = BloomFilter::read(input);
+        }
     }
     
     TermInfoPtr TermInfosReader::get(TermPtr term)
     {
+        if (bloomFilters && !mayContain(term))
+            return TermInfoPtr();
         return get(term, true);
     }
     
+    Collection<TermInfoPtr> TermInfosReader::get(Collection<TermPtr> terms)
+    {
+        Collection<TermInfoPtr> infos(Collection<TermInfoPtr>::newInstance(terms.size()));
+        if (_size == 0)
+            return infos;
+        
+        ensureIndexIsRead();
+        TermInfosReaderThreadResourcesPtr resources(getThreadResources());
+        TermInfoCachePtr cache(resources->termInfoCache);
+        IndexInputPtr input(resources->termEnum->input);
+        
+        // the block each term has to be looked up in, or -1, and the read of each block
+        Collection<int32_t> termBlocks(Collection<int32_t>::newInstance(terms.size()));
+        MapIntInt blockReads(MapIntInt::newInstance());
+        ReadBatchPtr batch(newLucene<ReadBatch>());
+        for (int32_t i = 0; i < terms.size(); ++i)
+        {
+            termBlocks[i] = -1;
+            if (bloomFilters && !mayContain(terms[i]))
+                continue;
+            infos[i] = cache->get(terms[i]);
+            if (infos[i])
+                continue;
+            int32_t indexOffset = getIndexOffset(terms[i], resources);
+            termBlocks[i] = indexOffset;
+            if (!blockReads.contains(indexOffset))
+            {
+                // a block ends with the entry of the next index term, which ends where the next block starts
+                int64_t start = indexPointers[indexOffset];
+                int64_t end = indexOffset + 1 < indexPointers.size() ? indexPointers[indexOffset + 1] : input->length();
+                blockReads.put(indexOffset, batch->add(start, (int32_t)(end - start)));
+            }
+        }
+        if (batch->size() == 0)
+            return infos;
+        
+        input->submitReads(batch);
+        batch->waitForCompletion();
+        
+        SegmentTermEnumPtr blockEnum(boost::dynamic_pointer_cast<SegmentTermEnum>(resources->termEnum->clone()));
+        for (int32_t i = 0; i < terms.size(); ++i)
+        {
+            if (termBlocks[i] == -1)
+                continue;
+            int32_t read = blockReads.get(termBlocks[i]);
+            blockEnum->input = newLucene<ByteArrayIndexInput>(batch->getBytes(read), batch->getLength(read));
+            seekEnum(blockEnum, termBlocks[i], resources, batch->getPosition(read));
+            blockEnum->scanTo(terms[i]);
+            if (blockEnum->term() && terms[i]->compareTo(blockEnum->term()) == 0)
+            {
+                infos[i] = blockEnum->termInfo();
+                cache->put(terms[i], infos[i]);
+            }
+        }
+        return infos;
+    }
+    
+    bool TermInfosReader::mayContain(TermPtr term)
+    {
+        if (!bloomFilters)
+            return true;
+        int32_t fieldNumber = fieldInfos->fieldNumber(term->_field);
+        if (fieldNumber == -1)
+            return false;
+        BloomFilterPtr filter(bloomFilters[fieldNumber]);
+        if (!filter)
+        {
+            // a field that keeps a filter but has none here has no terms in this segment
+            return !fieldInfos->fieldInfo(fieldNumber)->bloomFiltered;
+        }
+        UTF8ResultPtr key(getThreadResources()->bloomKey);
+        StringUtils::toUTF8(term->_text.c_str(), term->_text.length(), key);
+        return filter->mayContain(BloomFilter::hash(key->result.get(), key->length));
+    }
+    
     TermInfoPtr TermInfosReader::get(TermPtr term, bool useCache)
     {
         if (_size == 0)
@@ -170,8 +439,8 @@ namespace Lucene
             term->compareTo(enumerator->term()) >= 0))
         {
             int32_t enumOffset = (int32_t)(enumerator->position / totalIndexInterval ) + 1;
-            if (indexTerms.size() == enumOffset || // but before end of block
-                term->compareTo(indexTerms[enumOffset]) < 0)
+            if (indexPointers.size() == enumOffset || // but before end of block
+                term->compareTo(getIndexTerm(enumOffset, resources)) < 0)
             {
                 // no need to seek
                 int32_t numScans = enumerator->scanTo(term);
@@ -193,7 +462,8 @@ namespace Lucene
         }
         
         // random-access: must seek
-        seekEnum(enumerator, getIndexOffset(term));
+        int32_t indexOffset = getIndexOffset(term, resources);
+        seekEnum(enumerator, indexOffset, resources);
         enumerator->scanTo(term);
         if (enumerator->term() && term->compareTo(enumerator->term()) == 0)
         {
@@ -208,7 +478,7 @@ namespace Lucene
     
     void TermInfosReader::ensureIndexIsRead()
     {
-        if (!indexTerms)
+        if (!indexTerms && !indexFST)
             boost::throw_exception(IllegalStateException(L"terms index was not loaded when this reader was created"));
     }
     
@@ -218,10 +488,11 @@ namespace Lucene
             return -1;
         
         ensureIndexIsRead();
-        int32_t indexOffset = getIndexOffset(term);
+        TermInfosReaderThreadResourcesPtr resources(getThreadResources());
+        int32_t indexOffset = getIndexOffset(term, resources);
         
-        SegmentTermEnumPtr enumerator(getThreadResources()->termEnum);
-        seekEnum(enumerator, indexOffset);
+        SegmentTermEnumPtr enumerator(resources->termEnum);
+        seekEnum(enumerator, indexOffset, resources);
         
         while (term->compareTo(enumerator->term()) > 0 && enumerator->next())
         {
@@ -14,6 +14,14 @@
 #include "MiscUtils.h"
 #include "UnicodeUtils.h"
 #include "StringUtils.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "BlockPackedInts.h"
+#include "FSTBuilder.h"
+#include "FST.h"
+#include "RAMOutputStream.h"
+#include "FieldInfo.h"
+#include "IndexFileNames.h"
+#include "BloomFilter.h"
 
 namespace Lucene
 {
@@ -23,18 +31,35 @@ namespace Lucene
     /// Changed strings to true utf8 with length-in-bytes not length-in-chars.
     const int32_t TermInfosWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES = -4;
     
+    /// Records how the segment's postings are encoded.
+    const int32_t TermInfosWriter::FORMAT_VERSION_POSTINGS_FORMAT = -5;
+    
+    /// Appends the index terms to the terms index as an FST.
+    const int32_t TermInfosWriter::FORMAT_VERSION_TERMS_INDEX_FST = -6;
+    
+    /// Skip entries record the greatest freq and norm of the docs they skip over.
+    const int32_t TermInfosWriter::FORMAT_VERSION_SKIP_IMPACTS = -7;
+    
+    /// The terms index only holds the index terms as prefix coded entries if their FST couldn't be built.
+    const int32_t TermInfosWriter::FORMAT_VERSION_TERMS_INDEX_FST_ONLY = -8;
+    
     /// NOTE: always change this if you switch to a new format.
-    const int32_t TermInfosWriter::FORMAT_CURRENT = TermInfosWriter::FORMAT_VERSION_UTF8_LENGTH_IN_BYTES;
+    const int32_t TermInfosWriter::FORMAT_CURRENT = TermInfosWriter::FORMAT_VERSION_TERMS_INDEX_FST_ONLY;
     
-    TermInfosWriter::TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval)
+    const int32_t TermInfosWriter::BLOOM_FILTERS_FORMAT = -1;
+    
+    const int32_t TermInfosWriter::POSTINGS_FORMAT_VINT = 0;
+    const int32_t TermInfosWriter::POSTINGS_FORMAT_BLOCK_PACKED = 1;
+    
+    TermInfosWriter::TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, int32_t postingsFormat)
     {
-        initialize(directory, segment, fis, interval, false);
-        otherWriter = newLucene<TermInfosWriter>(directory, segment, fis, interval, true);
+        initialize(directory, segment, fis, interval, postingsFormat, false);
+        otherWriter = newLucene<TermInfosWriter>(directory, segment, fis, interval, postingsFormat, true);
     }
     
-    TermInfosWriter::TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, bool isIndex)
+    TermInfosWriter::TermInfosWriter(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, int32_t postingsFormat, bool isIndex)
     {
-        initialize(directory, segment, fis, interval, isIndex);
+        initialize(directory, segment, fis, interval, postingsFormat, isIndex);
     }
     
     TermInfosWriter::~TermInfosWriter()
@@ -50,27 +75,49 @@ namespace Lucene
         }
     }
     
-    void TermInfosWriter::initialize(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, bool isi)
+    void TermInfosWriter::initialize(DirectoryPtr directory, const String& segment, FieldInfosPtr fis, int32_t interval, int32_t postingsFormat, bool isi)
     {
         lastTi = newLucene<TermInfo>();
         utf8Result = newLucene<UTF8Result>();
         lastTermBytes = ByteArray::newInstance(10);
         lastTermBytesLength = 0;
         lastFieldNumber = -1;
-        skipInterval = 16;
+        // block packed postings can only be skipped to at block boundaries
+        skipInterval = postingsFormat == POSTINGS_FORMAT_BLOCK_PACKED ? BlockPackedInts::BLOCK_SIZE : 16;
         maxSkipLevels = 10;
+        this->postingsFormat = postingsFormat;
         size = 0;
         lastIndexPointer = 0;
         
         indexInterval = interval;
         fieldInfos = fis;
         isIndex = isi;
-        output = directory->createOutput(segment + (isIndex ? L".tii" : L".tis"));
+        output = newLucene<ChecksumFooterIndexOutput>(directory->createOutput(segment + (isIndex ? L".tii" : L".tis")));
         output->writeInt(FORMAT_CURRENT); // write format
         output->writeLong(0); // leave space for size
         output->writeInt(indexInterval); // write indexInterval
         output->writeInt(skipInterval); // write skipInterval
         output->writeInt(maxSkipLevels); // write maxSkipLevels
+        output->writeInt(postingsFormat); // write postingsFormat
+        if (isIndex)
+        {
+            indexBuilder = newLucene<FSTBuilder>();
+            indexEntries = newLucene<RAMOutputStream>();
+            indexKey = newLucene<UTF8Result>();
+            indexKeyField = -2;
+            indexKeyFieldLength = 0;
+            indexFileOutput = output;
+            bufferedIndexTerms = newLucene<RAMOutputStream>();
+            output = bufferedIndexTerms;
+        }
+        numBloomFilters = 0;
+        bloomField = -1;
+        if (!isIndex && fieldInfos->hasBloomFilters())
+        {
+            bloomOutput = newLucene<ChecksumFooterIndexOutput>(directory->createOutput(segment + L"." + IndexFileNames::BLOOM_FILTER_EXTENSION()));
+            bloomFilters = newLucene<RAMOutputStream>();
+            bloomHashes = Collection<int64_t>::newInstance();
+        }
         BOOST_ASSERT(initUnicodeResults());
     }
     
@@ -126,6 +173,16 @@ namespace Lucene
             other->add(lastFieldNumber, lastTermBytes, lastTermBytesLength, lastTi); // add an index term
         
         writeTerm(fieldNumber, termBytes, termBytesLength); // write term
+        
+        if (bloomFilters && fieldInfos->fieldInfo(fieldNumber)->bloomFiltered)
+        {
+            if (fieldNumber != bloomField)
+            {
+                finishBloomFilter();
+                bloomField = fieldNumber;
+            }
+            bloomHashes.add(BloomFilter::hash(termBytes.get(), termBytesLength));
+        }
 
         output->writeVInt(ti->docFreq); // write doc freq
         output->writeVLong(ti->freqPointer - lastTi->freqPointer); // write pointers
@@ -136,8 +193,10 @@ namespace Lucene
         
         if (isIndex)
         {
-            output->writeVLong(other->output->getFilePointer() - lastIndexPointer);
-            lastIndexPointer = other->output->getFilePointer(); // write pointer
+            int64_t indexPointer = other->output->getFilePointer();
+            output->writeVLong(indexPointer - lastIndexPointer); // write pointer
+            addIndexEntry(fieldNumber, termBytes, termBytesLength, ti, indexPointer);
+            lastIndexPointer = indexPointer;
         }
         
         lastFieldNumber = fieldNumber;
@@ -168,8 +227,86 @@ namespace Lucene
         lastTermBytesLength = termBytesLength;
     }
         
+    void TermInfosWriter::addIndexEntry(int32_t fieldNumber, ByteArray termBytes, int32_t termBytesLength, TermInfoPtr ti, int64_t indexPointer)
+    {
+        if (indexBuilder)
+        {
+            if (fieldNumber != indexKeyField)
+            {
+                String fieldName(fieldInfos->fieldName(fieldNumber));
+                indexKeyFieldLength = StringUtils::toUTF8(fieldName.c_str(), fieldName.length(), indexKey) + 1;
+                indexKey->setLength(indexKeyFieldLength);
+                indexKey->result[indexKeyFieldLength - 1] = 0;
+                indexKeyField = fieldNumber;
+            }
+            indexKey->setLength(indexKeyFieldLength + termBytesLength);
+            MiscUtils::arrayCopy(termBytes.get(), 0, indexKey->result.get(), indexKeyFieldLength, termBytesLength);
+            try
+            {
+                indexBuilder->add(indexKey->result.get(), indexKey->length, size);
+            }
+            catch (IllegalArgumentException&)
+            {
+                // UTF-8 byte order can differ from term order where wchar_t is 16 bits, in which case 
+                // readers fall back to loading the index terms
+                indexBuilder.reset();
+                bufferedIndexTerms->writeTo(indexFileOutput);
+                bufferedIndexTerms.reset();
+                output = indexFileOutput;
+            }
+        }
+        
+        indexEntries->writeVInt(ti->docFreq);
+        indexEntries->writeVLong(ti->freqPointer - lastTi->freqPointer);
+        indexEntries->writeVLong(ti->proxPointer - lastTi->proxPointer);
+        indexEntries->writeVInt(ti->skipOffset);
+        indexEntries->writeVLong(indexPointer - lastIndexPointer);
+    }
+    
+    void TermInfosWriter::writeIndexFST()
+    {
+        // the transducer was built, so the buffered entries aren't needed
+        output = indexFileOutput;
+        bufferedIndexTerms.reset();
+        int64_t start = output->getFilePointer();
+        if (indexBuilder)
+        {
+            output->writeByte(1);
+            indexBuilder->finish()->write(output);
+            output->writeVLong(size);
+            output->writeVLong(indexEntries->length());
+            indexEntries->writeTo(output);
+        }
+        else
+            output->writeByte(0);
+        output->writeLong(start);
+        indexBuilder.reset();
+        indexEntries.reset();
+    }
+    
+    void TermInfosWriter::finishBloomFilter()
+    {
+        if (bloomHashes.empty())
+            return;
+        bloomFilters->writeVInt(bloomField);
+        BloomFilter::create(bloomHashes)->write(bloomFilters);
+        ++numBloomFilters;
+        bloomHashes.clear();
+    }
+    
     void TermInfosWriter::close()
     {
+        if (isIndex)
+            writeIndexFST();
+        if (bloomOutput)
+        {
+            finishBloomFilter();
+            bloomOutput->writeInt(BLOOM_FILTERS_FORMAT);
+            bloomOutput->writeVInt(numBloomFilters);
+            bloomFilters->writeTo(bloomOutput);
+            bloomOutput->close();
+            bloomFilters.reset();
+        }
         output->seek(4); // write size after format
         output->writeLong(size);
         output->close();
@@ -14,6 +14,7 @@
 #include "TermVectorOffsetInfo.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
+#include "ChecksumFooter.h"
 
 namespace Lucene
 {
@@ -26,8 +27,11 @@ namespace Lucene
     /// Changed strings to UTF8 with length-in-bytes not length-in-chars
     const int32_t TermVectorsReader::FORMAT_UTF8_LENGTH_IN_BYTES = 4;
     
+    /// Files end with a checksum footer
+    const int32_t TermVectorsReader::FORMAT_CHECKSUM_FOOTER = 5;
+    
     /// NOTE: always change this if you switch to a new format
-    const int32_t TermVectorsReader::FORMAT_CURRENT = TermVectorsReader::FORMAT_UTF8_LENGTH_IN_BYTES;
+    const int32_t TermVectorsReader::FORMAT_CURRENT = TermVectorsReader::FORMAT_CHECKSUM_FOOTER;
     
     /// The size in bytes that the FORMAT_VERSION will take up at the beginning of each file
     const int32_t TermVectorsReader::FORMAT_SIZE = 4;
@@ -80,15 +84,16 @@ namespace Lucene
                 BOOST_ASSERT(format == tvdFormat);
                 BOOST_ASSERT(format == tvfFormat);
                 
+                int64_t tvxLength = format >= FORMAT_CHECKSUM_FOOTER ? ChecksumFooter::dataLength(tvx) : tvx->length();
                 if (format >= FORMAT_VERSION2)
                 {
-                    BOOST_ASSERT((tvx->length() - FORMAT_SIZE) % 16 == 0);
-                    numTotalDocs = (int32_t)(tvx->length() >> 4);
+                    BOOST_ASSERT((tvxLength - FORMAT_SIZE) % 16 == 0);
+                    numTotalDocs = (int32_t)(tvxLength >> 4);
                 }
                 else
                 {
-                    BOOST_ASSERT((tvx->length() - FORMAT_SIZE) % 8 == 0);
-                    numTotalDocs = (int32_t)(tvx->length() >> 3);
+                    BOOST_ASSERT((tvxLength - FORMAT_SIZE) % 8 == 0);
+                    numTotalDocs = (int32_t)(tvxLength >> 3);
                 }
                 
                 if (docStoreOffset == -1)
@@ -150,6 +155,11 @@ namespace Lucene
         return (format >= FORMAT_UTF8_LENGTH_IN_BYTES);
     }
     
+    bool TermVectorsReader::canVerifyRawDocs()
+    {
+        return (tvx && format >= FORMAT_CHECKSUM_FOOTER && docStoreOffset == 0 && _size == numTotalDocs);
+    }
+    
     void TermVectorsReader::rawDocs(Collection<int32_t> tvdLengths, Collection<int32_t> tvfLengths, int32_t startDocID, int32_t numDocs)
     {
         if (!tvx)
@@ -186,8 +196,8 @@ namespace Lucene
             }
             else
             {
-                tvdPosition = tvd->length();
-                tvfPosition = tvf->length();
+                tvdPosition = format >= FORMAT_CHECKSUM_FOOTER ? ChecksumFooter::dataLength(tvd) : tvd->length();
+                tvfPosition = format >= FORMAT_CHECKSUM_FOOTER ? ChecksumFooter::dataLength(tvf) : tvf->length();
                 BOOST_ASSERT(count == numDocs - 1);
             }
             tvdLengths[count] = (int32_t)(tvdPosition - lastTvdPosition);
@@ -18,6 +18,8 @@
 #include "Directory.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "ChecksumFooter.h"
 
 namespace Lucene
 {
@@ -96,7 +98,7 @@ namespace Lucene
             tvx.reset();
             BOOST_ASSERT(!state->docStoreSegmentName.empty());
             String fileName(state->docStoreSegmentName + L"." + IndexFileNames::VECTORS_INDEX_EXTENSION());
-            if (4 + ((int64_t)state->numDocsInStore) * 16 != state->directory->fileLength(fileName))
+            if (4 + ((int64_t)state->numDocsInStore) * 16 + ChecksumFooter::FOOTER_LENGTH != state->directory->fileLength(fileName))
             {
                 boost::throw_exception(RuntimeException(L"after flush: tvx size mismatch: " + StringUtils::toString(state->numDocsInStore) + 
                                                         L" docs vs " + StringUtils::toString(state->directory->fileLength(fileName)) + 
@@ -164,9 +166,9 @@ namespace Lucene
             
             // If we hit an exception while init'ing the term vector output files, we must abort this segment
             // because those files will be in an unknown state
-            tvx = docWriter->directory->createOutput(docStoreSegment + L"." + IndexFileNames::VECTORS_INDEX_EXTENSION());
-            tvd = docWriter->directory->createOutput(docStoreSegment + L"." + IndexFileNames::VECTORS_DOCUMENTS_EXTENSION());
-            tvf = docWriter->directory->createOutput(docStoreSegment + L"." + IndexFileNames::VECTORS_FIELDS_EXTENSION());
+            tvx = newLucene<ChecksumFooterIndexOutput>(docWriter->directory->createOutput(docStoreSegment + L"." + IndexFileNames::VECTORS_INDEX_EXTENSION()));
+            tvd = newLucene<ChecksumFooterIndexOutput>(docWriter->directory->createOutput(docStoreSegment + L"." + IndexFileNames::VECTORS_DOCUMENTS_EXTENSION()));
+            tvf = newLucene<ChecksumFooterIndexOutput>(docWriter->directory->createOutput(docStoreSegment + L"." + IndexFileNames::VECTORS_FIELDS_EXTENSION()));
             
             tvx->writeInt(TermVectorsReader::FORMAT_CURRENT);
             tvd->writeInt(TermVectorsReader::FORMAT_CURRENT);
@@ -229,6 +231,8 @@ namespace Lucene
     
     void TermVectorsTermsWriter::abort()
     {
+        // segments flushed before the abort may share these files, so any that can't be closed now must 
+        // still be closed later
         if (tvx)
         {
             try
@@ -237,6 +241,7 @@ namespace Lucene
             }
             catch (...)
             {
+                DocumentsWriterPtr(_docWriter)->addUnclosedDocStoreOutput(tvx);
             }
             tvx.reset();
         }
@@ -248,6 +253,7 @@ namespace Lucene
             }
             catch (...)
             {
+                DocumentsWriterPtr(_docWriter)->addUnclosedDocStoreOutput(tvd);
             }
             tvd.reset();
         }
@@ -259,6 +265,7 @@ namespace Lucene
             }
             catch (...)
             {
+                DocumentsWriterPtr(_docWriter)->addUnclosedDocStoreOutput(tvf);
             }
             tvf.reset();
         }
@@ -16,6 +16,8 @@
 #include "MiscUtils.h"
 #include "UnicodeUtils.h"
 #include "StringUtils.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "ChecksumFooter.h"
 
 namespace Lucene
 {
@@ -24,11 +26,11 @@ namespace Lucene
         utf8Results = newCollection<UTF8ResultPtr>(newInstance<UTF8Result>(), newInstance<UTF8Result>());
         
         // Open files for TermVector storage
-        tvx = directory->createOutput(segment + L"." + IndexFileNames::VECTORS_INDEX_EXTENSION());
+        tvx = newLucene<ChecksumFooterIndexOutput>(directory->createOutput(segment + L"." + IndexFileNames::VECTORS_INDEX_EXTENSION()));
         tvx->writeInt(TermVectorsReader::FORMAT_CURRENT);
-        tvd = directory->createOutput(segment + L"." + IndexFileNames::VECTORS_DOCUMENTS_EXTENSION());
+        tvd = newLucene<ChecksumFooterIndexOutput>(directory->createOutput(segment + L"." + IndexFileNames::VECTORS_DOCUMENTS_EXTENSION()));
         tvd->writeInt(TermVectorsReader::FORMAT_CURRENT);
-        tvf = directory->createOutput(segment + L"." + IndexFileNames::VECTORS_FIELDS_EXTENSION());
+        tvf = newLucene<ChecksumFooterIndexOutput>(directory->createOutput(segment + L"." + IndexFileNames::VECTORS_FIELDS_EXTENSION()));
         tvf->writeInt(TermVectorsReader::FORMAT_CURRENT);
 
         this->fieldInfos = fieldInfos;
@@ -71,7 +73,7 @@ namespace Lucene
                 if (tpVector)
                 {
                     // May have positions & offsets
-                    storePositions = (tpVector->size() > 0 && !tpVector->getTermPositions(0));
+                    storePositions = (tpVector->size() > 0 && tpVector->getTermPositions(0));
                     storeOffsets = (tpVector->size() > 0 && tpVector->getOffsets(0));
                     bits = (uint8_t)((storePositions ? TermVectorsReader::STORE_POSITIONS_WITH_TERMVECTOR : 0) +
                                      (storeOffsets ? TermVectorsReader::STORE_OFFSET_WITH_TERMVECTOR : 0));
@@ -159,7 +161,8 @@ namespace Lucene
             tvd->writeVInt(0);
     }
     
-    void TermVectorsWriter::addRawDocuments(TermVectorsReaderPtr reader, Collection<int32_t> tvdLengths, Collection<int32_t> tvfLengths, int32_t numDocs)
+    void TermVectorsWriter::addRawDocuments(TermVectorsReaderPtr reader, Collection<int32_t> tvdLengths, Collection<int32_t> tvfLengths, int32_t numDocs, 
+                                            CRC32CPtr tvdChecksum, CRC32CPtr tvfChecksum)
     {
         int64_t tvdPosition = tvd->getFilePointer();
         int64_t tvfPosition = tvf->getFilePointer();
@@ -172,8 +175,16 @@ namespace Lucene
             tvx->writeLong(tvfPosition);
             tvfPosition += tvfLengths[i];
         }
-        tvd->copyBytes(reader->getTvdStream(), tvdPosition - tvdStart);
-        tvf->copyBytes(reader->getTvfStream(), tvfPosition - tvfStart);
+        if (tvdChecksum && tvfChecksum)
+        {
+            ChecksumFooter::copyBytes(reader->getTvdStream(), tvd, tvdPosition - tvdStart, tvdChecksum);
+            ChecksumFooter::copyBytes(reader->getTvfStream(), tvf, tvfPosition - tvfStart, tvfChecksum);
+        }
+        else
+        {
+            tvd->copyBytes(reader->getTvdStream(), tvdPosition - tvdStart);
+            tvf->copyBytes(reader->getTvfStream(), tvfPosition - tvfStart);
+        }
         BOOST_ASSERT(tvd->getFilePointer() == tvdPosition);
         BOOST_ASSERT(tvf->getFilePointer() == tvfPosition);
     }
@@ -0,0 +1,198 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "BlockMaxDisjunctionScorer.h"
+
+namespace Lucene
+{
+    BlockMaxDisjunctionScorer::BlockMaxDisjunctionScorer(SimilarityPtr similarity, Collection<ScorerPtr> subScorers, Collection<double> coordFactors) : Scorer(similarity)
+    {
+        if (subScorers.size() < 2)
+            boost::throw_exception(IllegalArgumentException(L"There must be at least 2 subScorers"));
+        this->subScorers = Collection<ScorerPtr>::newInstance(subScorers.begin(), subScorers.end());
+        this->maxScores = Collection<double>::newInstance(subScorers.size());
+        this->maxScoreSums = Collection<double>::newInstance(subScorers.size());
+        this->coordFactors = coordFactors;
+        
+        // sums of scores may round differently from sums of their bounds, by an ulp for each value added
+        double maxCoordFactor = 0.0;
+        for (int32_t i = 1; i < coordFactors.size(); ++i)
+            maxCoordFactor = std::max(maxCoordFactor, coordFactors[i]);
+        this->boundFactor = maxCoordFactor * (1.0 + 2.0 * (double)subScorers.size() * std::numeric_limits<double>::epsilon());
+        
+        this->minCompetitiveScore = -std::numeric_limits<double>::infinity();
+        this->numNonEssential = 0;
+        this->windowMax = -1;
+        this->doc = -1;
+        this->currentScore = 0.0;
+    }
+    
+    BlockMaxDisjunctionScorer::~BlockMaxDisjunctionScorer()
+    {
+    }
+    
+    int32_t BlockMaxDisjunctionScorer::docID()
+    {
+        return doc;
+    }
+    
+    int32_t BlockMaxDisjunctionScorer::nextDoc()
+    {
+        return doc == NO_MORE_DOCS ? doc : advance(doc + 1);
+    }
+    
+    int32_t BlockMaxDisjunctionScorer::advance(int32_t target)
+    {
+        while (true)
+        {
+            if (numNonEssential == subScorers.size())
+            {
+                // nothing left in the window can compete
+                if (windowMax == NO_MORE_DOCS)
+                    break;
+                target = std::max(target, windowMax + 1);
+            }
+            if (target > windowMax && !nextWindow(target))
+                break;
+            
+            // a doc can only compete if an essential subscorer matches it
+            int32_t candidate = NO_MORE_DOCS;
+            for (int32_t i = numNonEssential; i < subScorers.size(); ++i)
+            {
+                int32_t subDoc = subScorers[i]->docID();
+                if (subDoc < target)
+                    subDoc = subScorers[i]->advance(target);
+                candidate = std::min(candidate, subDoc);
+            }
+            if (candidate > windowMax || candidate == NO_MORE_DOCS)
+            {
+                // the last window ends on NO_MORE_DOCS, where the essential subscorers may all be exhausted
+                if (windowMax == NO_MORE_DOCS)
+                    break;
+                target = windowMax + 1;
+                continue;
+            }
+            
+            double sum = 0.0;
+            int32_t matches = 0;
+            for (int32_t i = numNonEssential; i < subScorers.size(); ++i)
+            {
+                if (subScorers[i]->docID() == candidate)
+                {
+                    sum += subScorers[i]->score();
+                    ++matches;
+                }
+            }
+            
+            // add the non-essential subscorers, greatest first, while the doc may still compete
+            bool competitive = true;
+            for (int32_t i = numNonEssential - 1; i >= 0; --i)
+            {
+                if (upperBound(sum + maxScoreSums[i]) < minCompetitiveScore)
+                {
+                    competitive = false;
+                    break;
+                }
+                int32_t subDoc = subScorers[i]->docID();
+                if (subDoc < candidate)
+                    subDoc = subScorers[i]->advance(candidate);
+                if (subDoc == candidate)
+                {
+                    sum += subScorers[i]->score();
+                    ++matches;
+                }
+            }
+            if (competitive)
+            {
+                doc = candidate;
+                currentScore = sum * coordFactors[matches];
+                return doc;
+            }
+            target = candidate + 1;
+        }
+        doc = NO_MORE_DOCS;
+        return doc;
+    }
+    
+    double BlockMaxDisjunctionScorer::score()
+    {
+        return currentScore;
+    }
+    
+    void BlockMaxDisjunctionScorer::setMinCompetitiveScore(double minScore)
+    {
+        minCompetitiveScore = minScore;
+        if (windowMax != -1)
+            partition();
+    }
+    
+    bool BlockMaxDisjunctionScorer::nextWindow(int32_t target)
+    {
+        while (target != NO_MORE_DOCS)
+        {
+            bool exhausted = true;
+            windowMax = NO_MORE_DOCS;
+            for (Collection<ScorerPtr>::iterator scorer = subScorers.begin(); scorer != subScorers.end(); ++scorer)
+            {
+                int32_t subDoc = (*scorer)->docID();
+                if (subDoc == NO_MORE_DOCS)
+                    continue;
+                exhausted = false;
+                windowMax = std::min(windowMax, (*scorer)->advanceShallow(std::max(target, subDoc)));
+            }
+            if (exhausted)
+                break;
+            windowMax = std::max(windowMax, target);
+            
+            for (int32_t i = 0; i < subScorers.size(); ++i)
+                maxScores[i] = subScorers[i]->docID() == NO_MORE_DOCS ? 0.0 : std::max(0.0, subScorers[i]->getMaxScore(windowMax));
+            
+            // insertion sort, as the order changes little from one window to the next
+            for (int32_t i = 1; i < subScorers.size(); ++i)
+            {
+                ScorerPtr scorer(subScorers[i]);
+                double maxScore = maxScores[i];
+                int32_t j = i;
+                for (; j > 0 && maxScores[j - 1] > maxScore; --j)
+                {
+                    subScorers[j] = subScorers[j - 1];
+                    maxScores[j] = maxScores[j - 1];
+                }
+                subScorers[j] = scorer;
+                maxScores[j] = maxScore;
+            }
+            double sum = 0.0;
+            for (int32_t i = 0; i < subScorers.size(); ++i)
+            {
+                sum += maxScores[i];
+                maxScoreSums[i] = sum;
+            }
+            
+            partition();
+            if (numNonEssential < subScorers.size())
+                return true;
+            if (windowMax == NO_MORE_DOCS)
+                break;
+            target = windowMax + 1;
+        }
+        windowMax = NO_MORE_DOCS;
+        numNonEssential = subScorers.size();
+        return false;
+    }
+    
+    void BlockMaxDisjunctionScorer::partition()
+    {
+        numNonEssential = 0;
+        while (numNonEssential < subScorers.size() && upperBound(maxScoreSums[numNonEssential]) < minCompetitiveScore)
+            ++numNonEssential;
+    }
+    
+    double BlockMaxDisjunctionScorer::upperBound(double sum)
+    {
+        return std::max(0.0, sum) * boundFactor;
+    }
+}
@@ -9,6 +9,7 @@
 #include "_BooleanQuery.h"
 #include "BooleanScorer.h"
 #include "BooleanScorer2.h"
+#include "BlockMaxDisjunctionScorer.h"
 #include "ComplexExplanation.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
@@ -382,6 +383,36 @@ namespace Lucene
         return newLucene<BooleanScorer2>(similarity, query->minNrShouldMatch, required, prohibited, optional);
     }
     
+    ScorerPtr BooleanWeight::topScoresScorer(IndexReaderPtr reader, bool scoreDocsInOrder)
+    {
+        if (query->minNrShouldMatch != 0 || query->clauses.size() < 2)
+            return scorer(reader, scoreDocsInOrder, true);
+        for (Collection<BooleanClausePtr>::iterator c = query->clauses.begin(); c != query->clauses.end(); ++c)
+        {
+            if ((*c)->getOccur() != BooleanClause::SHOULD)
+                return scorer(reader, scoreDocsInOrder, true);
+        }
+        
+        // a pure disjunction can pass over the docs that score less than the top hits
+        Collection<ScorerPtr> optional(Collection<ScorerPtr>::newInstance());
+        for (Collection<WeightPtr>::iterator w = weights.begin(); w != weights.end(); ++w)
+        {
+            ScorerPtr subScorer((*w)->scorer(reader, true, false));
+            if (subScorer)
+                optional.add(subScorer);
+        }
+        if (optional.empty())
+            return ScorerPtr();
+        if (optional.size() == 1)
+            return newLucene<BooleanScorer2>(similarity, 0, Collection<ScorerPtr>::newInstance(), Collection<ScorerPtr>::newInstance(), optional);
+        
+        // as BooleanScorer2, coord counts the clauses that have a scorer
+        Collection<double> coordFactors(Collection<double>::newInstance(optional.size() + 1));
+        for (int32_t i = 0; i < coordFactors.size(); ++i)
+            coordFactors[i] = similarity->coord(i, optional.size());
+        return newLucene<BlockMaxDisjunctionScorer>(similarity, optional, coordFactors);
+    }
+    
     bool BooleanWeight::scoresDocsOutOfOrder()
     {
         int32_t numProhibited = 0;
@@ -123,7 +123,7 @@ namespace Lucene
     
     int32_t BooleanScorer2::docID()
     {
-        return doc;
+        return countingSumScorer->docID(); // follows the approximation of a two-phase view
     }
 
     int32_t BooleanScorer2::nextDoc()
@@ -145,6 +145,11 @@ namespace Lucene
         return doc;
     }
     
+    TwoPhaseIteratorPtr BooleanScorer2::twoPhaseIterator()
+    {
+        return countingSumScorer->twoPhaseIterator();
+    }
+    
     Coordinator::Coordinator(BooleanScorer2Ptr scorer)
     {
         _scorer = scorer;
@@ -206,6 +211,11 @@ namespace Lucene
         return scorer->advance(target);
     }
     
+    TwoPhaseIteratorPtr SingleMatchScorer::twoPhaseIterator()
+    {
+        return scorer->twoPhaseIterator();
+    }
+    
     CountingDisjunctionSumScorer::CountingDisjunctionSumScorer(BooleanScorer2Ptr scorer, Collection<ScorerPtr> subScorers, int32_t minimumNrMatchers) : DisjunctionSumScorer(subScorers, minimumNrMatchers)
     {
         _scorer = scorer;
@@ -7,8 +7,11 @@
 #include "LuceneInc.h"
 #include "CachingWrapperFilter.h"
 #include "_CachingWrapperFilter.h"
-#include "OpenBitSetDISI.h"
+#include "RoaringDocIdSet.h"
+#include "OpenBitSet.h"
+#include "DocIdBitSet.h"
 #include "IndexReader.h"
+#include "MiscUtils.h"
 
 namespace Lucene
 {
@@ -31,14 +34,14 @@ namespace Lucene
             // this is better than returning null, as the nonnull result can be cached
             return DocIdSet::EMPTY_DOCIDSET();
         }
-        else if (docIdSet->isCacheable())
+        else if (docIdSet->isCacheable() && !MiscUtils::typeOf<OpenBitSet>(docIdSet) && !MiscUtils::typeOf<DocIdBitSet>(docIdSet))
             return docIdSet;
         else
         {
             DocIdSetIteratorPtr it(docIdSet->iterator());
             // null is allowed to be returned by iterator(), in this case we wrap with the empty set,
             // which is cacheable.
-            return !it ? DocIdSet::EMPTY_DOCIDSET() : newLucene<OpenBitSetDISI>(it, reader->maxDoc());
+            return !it ? DocIdSet::EMPTY_DOCIDSET() : newLucene<RoaringDocIdSet>(it);
         }
     }
     
@@ -12,4 +12,9 @@ namespace Lucene
     Collector::~Collector()
     {
     }
+    
+    bool Collector::needsTopScoresOnly()
+    {
+        return false;
+    }
 }
@@ -0,0 +1,55 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "EarlyTerminatingSortingCollector.h"
+#include "SegmentReader.h"
+#include "SegmentInfo.h"
+#include "IndexSorter.h"
+
+namespace Lucene
+{
+    EarlyTerminatingSortingCollector::EarlyTerminatingSortingCollector(CollectorPtr collector, SortPtr sort, int32_t numDocsToCollect)
+    {
+        if (numDocsToCollect <= 0)
+            boost::throw_exception(IllegalArgumentException(L"numDocsToCollect must always be > 0"));
+        this->collector = collector;
+        this->sort = sort;
+        this->numDocsToCollect = numDocsToCollect;
+        this->numCollected = 0;
+        this->segmentSorted = false;
+    }
+    
+    EarlyTerminatingSortingCollector::~EarlyTerminatingSortingCollector()
+    {
+    }
+    
+    void EarlyTerminatingSortingCollector::collect(int32_t doc)
+    {
+        collector->collect(doc);
+        if (segmentSorted && ++numCollected >= numDocsToCollect)
+            boost::throw_exception(CollectionTerminatedException());
+    }
+    
+    void EarlyTerminatingSortingCollector::setNextReader(IndexReaderPtr reader, int32_t docBase)
+    {
+        collector->setNextReader(reader, docBase);
+        SegmentReaderPtr segmentReader(boost::dynamic_pointer_cast<SegmentReader>(reader));
+        segmentSorted = (segmentReader && IndexSorter::sortedBy(segmentReader->getSegmentInfo()->getIndexSort(), sort));
+        numCollected = 0;
+    }
+    
+    void EarlyTerminatingSortingCollector::setScorer(ScorerPtr scorer)
+    {
+        collector->setScorer(scorer);
+    }
+    
+    bool EarlyTerminatingSortingCollector::acceptsDocsOutOfOrder()
+    {
+        // the first documents of a sorted segment are only the best ones if they come in order
+        return !segmentSorted && collector->acceptsDocsOutOfOrder();
+    }
+}
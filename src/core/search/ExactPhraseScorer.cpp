@@ -11,6 +11,10 @@
 
 namespace Lucene
 {
+    ExactPhraseScorer::ExactPhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, NormValuesPtr norms) : PhraseScorer(weight, tps, offsets, similarity, norms)
+    {
+    }
+    
     ExactPhraseScorer::ExactPhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, ByteArray norms) : PhraseScorer(weight, tps, offsets, similarity, norms)
     {
     }
@@ -9,6 +9,9 @@
 #include "FieldCache.h"
 #include "ScoreCachingWrappingScorer.h"
 #include "Collator.h"
+#include "IndexReader.h"
+#include "NumericDocValues.h"
+#include "SortedDocValues.h"
 
 namespace Lucene
 {
@@ -79,13 +82,20 @@ namespace Lucene
     
     int32_t DoubleComparator::compareBottom(int32_t doc)
     {
-        double v2 = currentReaderValues[doc];
+        double v2 = docValues ? docValues->getDouble(doc) : currentReaderValues[doc];
         return bottom > v2 ? 1 : (bottom < v2 ? -1 : 0);
     }
     
+    void DoubleComparator::copy(int32_t slot, int32_t doc)
+    {
+        values[slot] = docValues ? docValues->getDouble(doc) : currentReaderValues[doc];
+    }
+    
     void DoubleComparator::setNextReader(IndexReaderPtr reader, int32_t docBase)
     {
-        currentReaderValues = FieldCache::DEFAULT()->getDoubles(reader, field, parser);
+        docValues = reader->getNumericDocValues(field);
+        if (!docValues)
+            currentReaderValues = FieldCache::DEFAULT()->getDoubles(reader, field, parser);
     }
     
     IntComparator::IntComparator(int32_t numHits, const String& field, ParserPtr parser) : NumericComparator<int32_t>(numHits, field)
@@ -106,13 +116,20 @@ namespace Lucene
     
     int32_t IntComparator::compareBottom(int32_t doc)
     {
-        int32_t v2 = currentReaderValues[doc];
+        int32_t v2 = docValues ? (int32_t)docValues->getLong(doc) : currentReaderValues[doc];
         return bottom > v2 ? 1 : (bottom < v2 ? -1 : 0);
     }
     
+    void IntComparator::copy(int32_t slot, int32_t doc)
+    {
+        values[slot] = docValues ? (int32_t)docValues->getLong(doc) : currentReaderValues[doc];
+    }
+    
     void IntComparator::setNextReader(IndexReaderPtr reader, int32_t docBase)
     {
-        currentReaderValues = FieldCache::DEFAULT()->getInts(reader, field, parser);
+        docValues = reader->getNumericDocValues(field);
+        if (!docValues)
+            currentReaderValues = FieldCache::DEFAULT()->getInts(reader, field, parser);
     }
     
     LongComparator::LongComparator(int32_t numHits, const String& field, ParserPtr parser) : NumericComparator<int64_t>(numHits, field)
@@ -133,13 +150,20 @@ namespace Lucene
     
     int32_t LongComparator::compareBottom(int32_t doc)
     {
-        int64_t v2 = currentReaderValues[doc];
+        int64_t v2 = docValues ? docValues->getLong(doc) : currentReaderValues[doc];
         return bottom > v2 ? 1 : (bottom < v2 ? -1 : 0);
     }
     
+    void LongComparator::copy(int32_t slot, int32_t doc)
+    {
+        values[slot] = docValues ? docValues->getLong(doc) : currentReaderValues[doc];
+    }
+    
     void LongComparator::setNextReader(IndexReaderPtr reader, int32_t docBase)
     {
-        currentReaderValues = FieldCache::DEFAULT()->getLongs(reader, field, parser);
+        docValues = reader->getNumericDocValues(field);
+        if (!docValues)
+            currentReaderValues = FieldCache::DEFAULT()->getLongs(reader, field, parser);
     }
     
     RelevanceComparator::RelevanceComparator(int32_t numHits) : NumericComparator<double>(numHits)
@@ -248,11 +272,29 @@ namespace Lucene
     int32_t StringOrdValComparator::compareBottom(int32_t doc)
     {
         BOOST_ASSERT(bottomSlot != -1);
-        int32_t order = this->order[doc];
+        int32_t order = getOrder(doc);
         int32_t cmp = bottomOrd - order;
         if (cmp != 0)
             return cmp;
-        return bottomValue.compare(lookup[order]);
+        return bottomValue.compare(getLookup(order));
+    }
+    
+    int32_t StringOrdValComparator::getOrder(int32_t doc)
+    {
+        // sorted doc values number their ordinals from 0 and use -1 for no value
+        return docValues ? docValues->getOrd(doc) + 1 : order[doc];
+    }
+    
+    String StringOrdValComparator::getLookup(int32_t ord)
+    {
+        if (docValues)
+            return ord == 0 ? EmptyString : docValues->lookup(ord - 1);
+        return lookup[ord];
+    }
+    
+    int32_t StringOrdValComparator::getLookupSize()
+    {
+        return docValues ? docValues->getValueCount() + 1 : lookup.size();
     }
     
     void StringOrdValComparator::convert(int32_t slot)
@@ -266,6 +308,15 @@ namespace Lucene
             return;
         }
         
+        if (docValues)
+        {
+            index = docValues->lookupTerm(value);
+            
+            // shift to ordinals where 0 is no value; when not found this is the greatest value less than it
+            ords[slot] = index >= 0 ? index + 1 : -index - 1;
+            return;
+        }
+        
         if (sortPos == 0 && bottomSlot != -1 && bottomSlot != slot)
         {
             // Since we are the primary sort, the entries in the queue are bounded by bottomOrd
@@ -296,20 +347,24 @@ namespace Lucene
     
     void StringOrdValComparator::copy(int32_t slot, int32_t doc)
     {
-        int32_t ord = order[doc];
+        int32_t ord = getOrder(doc);
         ords[slot] = ord;
         BOOST_ASSERT(ord >= 0);
-        values[slot] = lookup[ord];
+        values[slot] = getLookup(ord);
         readerGen[slot] = currentReaderGen;
     }
     
     void StringOrdValComparator::setNextReader(IndexReaderPtr reader, int32_t docBase)
     {
-        StringIndexPtr currentReaderValues(FieldCache::DEFAULT()->getStringIndex(reader, field));
+        docValues = reader->getSortedDocValues(field);
+        if (!docValues)
+        {
+            StringIndexPtr currentReaderValues(FieldCache::DEFAULT()->getStringIndex(reader, field));
+            order = currentReaderValues->order;
+            lookup = currentReaderValues->lookup;
+            BOOST_ASSERT(!lookup.empty());
+        }
         ++currentReaderGen;
-        order = currentReaderValues->order;
-        lookup = currentReaderValues->lookup;
-        BOOST_ASSERT(!lookup.empty());
         if (bottomSlot != -1)
         {
             convert(bottomSlot);
@@ -324,7 +379,7 @@ namespace Lucene
             convert(bottomSlot);
         bottomOrd = ords[slot];
         BOOST_ASSERT(bottomOrd >= 0);
-        BOOST_ASSERT(bottomOrd < lookup.size());
+        BOOST_ASSERT(bottomOrd < getLookupSize());
         bottomValue = values[slot];
     }
     
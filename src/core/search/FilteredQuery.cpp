@@ -7,6 +7,7 @@
 #include "LuceneInc.h"
 #include "FilteredQuery.h"
 #include "_FilteredQuery.h"
+#include "_TwoPhaseIterator.h"
 #include "Explanation.h"
 #include "Filter.h"
 #include "DocIdSet.h"
@@ -165,48 +166,46 @@ namespace Lucene
         this->weight = weight;
         this->scorer = scorer;
         this->docIdSetIterator = docIdSetIterator;
-        doc = -1;
+        TwoPhaseIteratorPtr scorerTwoPhase(scorer->twoPhaseIterator());
+        DocIdSetIteratorPtr scorerApproximation(scorerTwoPhase ? scorerTwoPhase->approximation() : scorer);
+        this->approximation = newLucene<ConjunctionDocIdSetIterator>(newCollection<DocIdSetIteratorPtr>(docIdSetIterator, scorerApproximation));
+        if (scorerTwoPhase)
+            this->twoPhase = newLucene<ConjunctionTwoPhaseIterator>(approximation, newCollection<TwoPhaseIteratorPtr>(scorerTwoPhase));
     }
     
     FilteredQueryWeightScorer::~FilteredQueryWeightScorer()
     {
     }
     
-    int32_t FilteredQueryWeightScorer::advanceToCommon(int32_t scorerDoc, int32_t disiDoc)
+    int32_t FilteredQueryWeightScorer::toMatch(int32_t doc)
     {
-        while (scorerDoc != disiDoc)
-        {
-            if (scorerDoc < disiDoc)
-                scorerDoc = scorer->advance(disiDoc);
-            else
-                disiDoc = docIdSetIterator->advance(scorerDoc);
-        }
-        return scorerDoc;
+        while (doc != NO_MORE_DOCS && twoPhase && !twoPhase->matches())
+            doc = approximation->nextDoc();
+        return doc;
     }
     
     int32_t FilteredQueryWeightScorer::nextDoc()
     {
-        int32_t disiDoc = docIdSetIterator->nextDoc();
-        int32_t scorerDoc = scorer->nextDoc();
-        doc = (scorerDoc != NO_MORE_DOCS && advanceToCommon(scorerDoc, disiDoc) != NO_MORE_DOCS) ? scorer->docID() : NO_MORE_DOCS;
-        return doc;
+        return toMatch(approximation->nextDoc());
     }
     
     int32_t FilteredQueryWeightScorer::docID()
     {
-        return doc;
+        return approximation->docID();
     }
     
     int32_t FilteredQueryWeightScorer::advance(int32_t target)
     {
-        int32_t disiDoc = docIdSetIterator->advance(target);
-        int32_t scorerDoc = scorer->advance(target);
-        doc = (scorerDoc != NO_MORE_DOCS && advanceToCommon(scorerDoc, disiDoc) != NO_MORE_DOCS) ? scorer->docID() : NO_MORE_DOCS;
-        return doc;
+        return toMatch(approximation->advance(target));
     }
     
     double FilteredQueryWeightScorer::score()
     {
         return weight->query->getBoost() * scorer->score();
     }
+    
+    TwoPhaseIteratorPtr FilteredQueryWeightScorer::twoPhaseIterator()
+    {
+        return twoPhase;
+    }
 }
@@ -10,9 +10,12 @@
 #include "FuzzyQuery.h"
 #include "Term.h"
 #include "IndexReader.h"
+#include "LevenshteinAutomaton.h"
 
 namespace Lucene
 {
+    const int32_t FuzzyTermEnum::MAX_SCANNED_TERMS = 16;
+    
     FuzzyTermEnum::FuzzyTermEnum(IndexReaderPtr reader, TermPtr term, double minSimilarity, int32_t prefixLength)
     {
         ConstructTermEnum(reader, term, minSimilarity, prefixLength);
@@ -59,7 +62,17 @@ namespace Lucene
         this->p = Collection<int32_t>::newInstance(this->text.length() + 1);
         this->d = Collection<int32_t>::newInstance(this->text.length() + 1);
         
-        setEnum(reader->terms(newLucene<Term>(searchTerm->field(), prefix)));
+        // A term can only be similar enough if the edit distance of its text after the prefix is small enough when 
+        // measured against the longest length that similarity() may use, which is that of the search term.
+        int32_t length = text.length() + prefix.length();
+        int32_t maxDistance = 0;
+        while (1.0 - ((double)(maxDistance + 1) / (double)length) > minimumSimilarity)
+            ++maxDistance;
+        this->automaton = newLucene<LevenshteinAutomaton>(text, maxDistance);
+        this->reader = reader;
+        
+        this->actualEnum = reader->terms(newLucene<Term>(searchTerm->field(), prefix));
+        seekMatch();
     }
     
     bool FuzzyTermEnum::termCompare(TermPtr term)
@@ -74,6 +87,55 @@ namespace Lucene
         return false;
     }
     
+    bool FuzzyTermEnum::next()
+    {
+        if (!actualEnum)
+            return false; // the actual enumerator is not initialized
+        currentTerm.reset();
+        if (_endEnum || !actualEnum->next())
+            return false;
+        return seekMatch();
+    }
+    
+    bool FuzzyTermEnum::seekMatch()
+    {
+        TermPtr term(actualEnum->term());
+        while (term)
+        {
+            if (termCompare(term))
+            {
+                currentTerm = term;
+                return true;
+            }
+            if (_endEnum)
+                return false;
+            
+            // None of the terms before the next text the automaton accepts can match.  Step over them if there 
+            // are only a few, as seeking the terms dictionary costs as much as scanning a part of it.
+            String nextText;
+            if (!automaton->nextAccepted(term->text().substr(prefix.length()), nextText))
+            {
+                _endEnum = true;
+                return false;
+            }
+            TermPtr target(newLucene<Term>(field, prefix + nextText));
+            for (int32_t scanned = 0; ; ++scanned)
+            {
+                if (scanned == MAX_SCANNED_TERMS)
+                {
+                    actualEnum->close();
+                    actualEnum = reader->terms(target);
+                    term = actualEnum->term();
+                    break;
+                }
+                term = actualEnum->next() ? actualEnum->term() : TermPtr();
+                if (!term || term->compareTo(target) >= 0)
+                    break;
+            }
+        }
+        return false;
+    }
+    
     double FuzzyTermEnum::difference()
     {
         return (_similarity - minimumSimilarity) * scale_factor;
@@ -160,6 +222,8 @@ namespace Lucene
         p.reset();
         d.reset();
         searchTerm.reset();
+        automaton.reset();
+        reader.reset();
         FilteredTermEnum::close(); // call FilteredTermEnum::close() and let the garbage collector do its work.
     }
 }
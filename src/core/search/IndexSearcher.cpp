@@ -5,6 +5,8 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include "LuceneInc.h"
+#include <boost/bind.hpp>
+#include <boost/bind/protect.hpp>
 #include "IndexSearcher.h"
 #include "IndexReader.h"
 #include "TopScoreDocCollector.h"
@@ -13,12 +15,41 @@
 #include "Weight.h"
 #include "DocIdSet.h"
 #include "Scorer.h"
+#include "TwoPhaseIterator.h"
 #include "Filter.h"
 #include "Query.h"
 #include "ReaderUtil.h"
+#include "MiscUtils.h"
+#include "HitQueue.h"
+#include "FieldDocSortedHitQueue.h"
+#include "FieldDoc.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "TotalHitCountCollector.h"
+#include "ThreadPool.h"
+#include "_IndexSearcher.h"
 
 namespace Lucene
 {
+    /// Orders subreaders by descending number of docs.
+    struct lessMaxDoc
+    {
+        lessMaxDoc(Collection<IndexReaderPtr> subReaders)
+        {
+            this->subReaders = subReaders;
+        }
+        
+        inline bool operator()(int32_t first, int32_t second) const
+        {
+            return (subReaders[first]->maxDoc() > subReaders[second]->maxDoc());
+        }
+        
+        Collection<IndexReaderPtr> subReaders;
+    };
+    
+    const int32_t IndexSearcher::MAX_DOCS_PER_SLICE = 250000;
+    const int32_t IndexSearcher::MAX_SEGMENTS_PER_SLICE = 5;
+    
     IndexSearcher::IndexSearcher(DirectoryPtr path, bool readOnly)
     {
         ConstructSearcher(IndexReader::open(path, readOnly), true);
@@ -29,10 +60,18 @@ namespace Lucene
         ConstructSearcher(reader, false);
     }
     
+    IndexSearcher::IndexSearcher(IndexReaderPtr reader, ThreadPoolPtr executor)
+    {
+        ConstructSearcher(reader, false);
+        this->executor = executor;
+        this->leafSlices = slices(subReaders);
+    }
+    
     IndexSearcher::IndexSearcher(IndexReaderPtr reader, Collection<IndexReaderPtr> subReaders, Collection<int32_t> docStarts)
     {
         this->fieldSortDoTrackScores = false;
         this->fieldSortDoMaxScore = false;
+        this->totalHitsThreshold = INT_MAX;
         this->reader = reader;
         this->subReaders = subReaders;
         this->docStarts = docStarts;
@@ -47,6 +86,7 @@ namespace Lucene
     {
         this->fieldSortDoTrackScores = false;
         this->fieldSortDoMaxScore = false;
+        this->totalHitsThreshold = INT_MAX;
         this->reader = reader;
         this->closeReader = closeReader;
         
@@ -83,6 +123,11 @@ namespace Lucene
         return reader->docFreq(term);
     }
     
+    Collection<int32_t> IndexSearcher::docFreqs(Collection<TermPtr> terms)
+    {
+        return reader->docFreqs(terms);
+    }
+    
     DocumentPtr IndexSearcher::doc(int32_t n)
     {
         return reader->document(n);
@@ -102,9 +147,44 @@ namespace Lucene
     {
         if (n <= 0)
             boost::throw_exception(IllegalArgumentException(L"n must be > 0"));
-        TopScoreDocCollectorPtr collector(TopScoreDocCollector::create(std::min(n, reader->maxDoc()), !weight->scoresDocsOutOfOrder()));
-        search(weight, filter, collector);
-        return collector->topDocs();
+        int32_t numHits = std::min(n, reader->maxDoc());
+        if (!executor || leafSlices.size() < 2)
+        {
+            TopScoreDocCollectorPtr collector(TopScoreDocCollector::create(numHits, !weight->scoresDocsOutOfOrder(), totalHitsThreshold));
+            search(weight, filter, collector);
+            return collector->topDocs();
+        }
+        
+        Collection<CollectorPtr> collectors(Collection<CollectorPtr>::newInstance(leafSlices.size()));
+        for (int32_t i = 0; i < collectors.size(); ++i)
+            collectors[i] = TopScoreDocCollector::create(numHits, !weight->scoresDocsOutOfOrder(), totalHitsThreshold);
+        searchSlices(weight, filter, collectors);
+        
+        // hits of equal score are ordered by doc, as when the slices are searched one after another
+        HitQueuePtr hq(newLucene<HitQueue>(numHits, false));
+        int32_t totalHits = 0;
+        double maxScore = -std::numeric_limits<double>::infinity();
+        for (int32_t i = 0; i < collectors.size(); ++i)
+        {
+            TopDocsPtr topDocs(boost::static_pointer_cast<TopScoreDocCollector>(collectors[i])->topDocs());
+            totalHits += topDocs->totalHits;
+            if (topDocs->scoreDocs.empty())
+                continue;
+            maxScore = std::max(maxScore, topDocs->maxScore);
+            for (Collection<ScoreDocPtr>::iterator scoreDoc = topDocs->scoreDocs.begin(); scoreDoc != topDocs->scoreDocs.end(); ++scoreDoc)
+            {
+                if (*scoreDoc == hq->addOverflow(*scoreDoc))
+                    break;
+            }
+        }
+        if (hq->size() == 0)
+            maxScore = std::numeric_limits<double>::quiet_NaN();
+        
+        Collection<ScoreDocPtr> scoreDocs(Collection<ScoreDocPtr>::newInstance(hq->size()));
+        for (int32_t i = hq->size() - 1; i >= 0; --i) // put docs in array
+            scoreDocs[i] = hq->pop();
+        
+        return newLucene<TopDocs>(totalHits, scoreDocs, maxScore);
     }
     
     TopFieldDocsPtr IndexSearcher::search(WeightPtr weight, FilterPtr filter, int32_t n, SortPtr sort)
@@ -114,31 +194,190 @@ namespace Lucene
     
     TopFieldDocsPtr IndexSearcher::search(WeightPtr weight, FilterPtr filter, int32_t n, SortPtr sort, bool fillFields)
     {
-        TopFieldCollectorPtr collector(TopFieldCollector::create(sort, std::min(n, reader->maxDoc()), fillFields, fieldSortDoTrackScores, fieldSortDoMaxScore, !weight->scoresDocsOutOfOrder()));
-        search(weight, filter, collector);
-        return boost::dynamic_pointer_cast<TopFieldDocs>(collector->topDocs());
+        int32_t numHits = std::min(n, reader->maxDoc());
+        bool mergeable = true;
+        Collection<SortFieldPtr> sortFields(sort->getSort());
+        for (Collection<SortFieldPtr>::iterator field = sortFields.begin(); field != sortFields.end(); ++field)
+        {
+            // the values of custom comparators can't be compared outside of them
+            if ((*field)->getType() == SortField::CUSTOM)
+                mergeable = false;
+        }
+        if (!executor || leafSlices.size() < 2 || !mergeable)
+        {
+            TopFieldCollectorPtr collector(TopFieldCollector::create(sort, numHits, fillFields, fieldSortDoTrackScores, fieldSortDoMaxScore, !weight->scoresDocsOutOfOrder()));
+            search(weight, filter, collector);
+            return boost::dynamic_pointer_cast<TopFieldDocs>(collector->topDocs());
+        }
+        
+        // the hits of the slices are merged by the values of their sort fields, so these must be filled
+        Collection<CollectorPtr> collectors(Collection<CollectorPtr>::newInstance(leafSlices.size()));
+        for (int32_t i = 0; i < collectors.size(); ++i)
+            collectors[i] = TopFieldCollector::create(sort, numHits, true, fieldSortDoTrackScores, fieldSortDoMaxScore, !weight->scoresDocsOutOfOrder());
+        searchSlices(weight, filter, collectors);
+        
+        FieldDocSortedHitQueuePtr hq(newLucene<FieldDocSortedHitQueue>(numHits));
+        int32_t totalHits = 0;
+        double maxScore = -std::numeric_limits<double>::infinity();
+        for (int32_t i = 0; i < collectors.size(); ++i)
+        {
+            TopFieldDocsPtr topDocs(boost::dynamic_pointer_cast<TopFieldDocs>(boost::static_pointer_cast<TopFieldCollector>(collectors[i])->topDocs()));
+            totalHits += topDocs->totalHits;
+            if (i == 0)
+                hq->setFields(topDocs->fields);
+            if (!MiscUtils::isNaN(topDocs->maxScore))
+                maxScore = std::max(maxScore, topDocs->maxScore);
+            for (Collection<ScoreDocPtr>::iterator scoreDoc = topDocs->scoreDocs.begin(); scoreDoc != topDocs->scoreDocs.end(); ++scoreDoc)
+            {
+                FieldDocPtr fieldDoc(boost::static_pointer_cast<FieldDoc>(*scoreDoc));
+                if (fieldDoc == hq->addOverflow(fieldDoc))
+                    break;
+            }
+        }
+        if (maxScore == -std::numeric_limits<double>::infinity())
+            maxScore = std::numeric_limits<double>::quiet_NaN();
+        
+        Collection<ScoreDocPtr> scoreDocs(Collection<ScoreDocPtr>::newInstance(hq->size()));
+        for (int32_t i = hq->size() - 1; i >= 0; --i) // put docs in array
+        {
+            FieldDocPtr fieldDoc(hq->pop());
+            if (!fillFields)
+                fieldDoc->fields.reset();
+            scoreDocs[i] = fieldDoc;
+        }
+        
+        return newLucene<TopFieldDocs>(totalHits, scoreDocs, hq->getFields(), maxScore);
+    }
+    
+    int32_t IndexSearcher::count(QueryPtr query)
+    {
+        WeightPtr weight(createWeight(query));
+        if (!executor || leafSlices.size() < 2)
+        {
+            TotalHitCountCollectorPtr collector(newLucene<TotalHitCountCollector>());
+            search(weight, FilterPtr(), collector);
+            return collector->getTotalHits();
+        }
+        
+        Collection<CollectorPtr> collectors(Collection<CollectorPtr>::newInstance(leafSlices.size()));
+        for (int32_t i = 0; i < collectors.size(); ++i)
+            collectors[i] = newLucene<TotalHitCountCollector>();
+        searchSlices(weight, FilterPtr(), collectors);
+        int32_t totalHits = 0;
+        for (int32_t i = 0; i < collectors.size(); ++i)
+            totalHits += boost::static_pointer_cast<TotalHitCountCollector>(collectors[i])->getTotalHits();
+        return totalHits;
     }
     
     void IndexSearcher::search(WeightPtr weight, FilterPtr filter, CollectorPtr results)
     {
-        if (!filter)
+        for (int32_t i = 0; i < subReaders.size(); ++i) // search each subreader
+            searchLeaf(i, weight, filter, results);
+    }
+    
+    void IndexSearcher::searchLeaf(int32_t leaf, WeightPtr weight, FilterPtr filter, CollectorPtr results)
+    {
+        results->setNextReader(subReaders[leaf], docStarts[leaf]);
+        try
         {
-            for (int32_t i = 0; i < subReaders.size(); ++i) // search each subreader
+            if (!filter)
             {
-                results->setNextReader(subReaders[i], docStarts[i]);
-                ScorerPtr scorer(weight->scorer(subReaders[i], !results->acceptsDocsOutOfOrder(), true));
+                ScorerPtr scorer(results->needsTopScoresOnly() ? weight->topScoresScorer(subReaders[leaf], !results->acceptsDocsOutOfOrder()) : weight->scorer(subReaders[leaf], !results->acceptsDocsOutOfOrder(), true));
                 if (scorer)
                     scorer->score(results);
             }
+            else
+                searchWithFilter(subReaders[leaf], weight, filter, results);
+        }
+        catch (CollectionTerminatedException&)
+        {
+            // the collector has seen enough of this subreader
+        }
+    }
+    
+    void IndexSearcher::searchSlices(WeightPtr weight, FilterPtr filter, Collection<CollectorPtr> collectors)
+    {
+        // the calling thread searches the first slice itself while the executor searches the others
+        Collection<IndexSearcherSliceCallablePtr> callables(Collection<IndexSearcherSliceCallablePtr>::newInstance(leafSlices.size()));
+        Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance(leafSlices.size()));
+        for (int32_t i = 0; i < leafSlices.size(); ++i)
+        {
+            callables[i] = newLucene<IndexSearcherSliceCallable>(shared_from_this(), leafSlices[i], weight, filter, collectors[i]);
+            if (i > 0)
+                futures[i] = executor->scheduleTask(boost::protect(boost::bind<int32_t>(boost::mem_fn(&IndexSearcherSliceCallable::call), callables[i])));
         }
-        else
+        callables[0]->call();
+        LuceneException finally(callables[0]->error);
+        for (int32_t i = 1; i < leafSlices.size(); ++i)
         {
-            for (int32_t i = 0; i < subReaders.size(); ++i) // search each subreader
+            futures[i]->get<int32_t>();
+            if (finally.isNull())
+                finally = callables[i]->error;
+        }
+        finally.throwException();
+    }
+    
+    Collection< Collection<int32_t> > IndexSearcher::slices(Collection<IndexReaderPtr> subReaders)
+    {
+        // largest first, so that each large subreader gets a slice of its own
+        Collection<int32_t> leaves(Collection<int32_t>::newInstance(subReaders.size()));
+        for (int32_t i = 0; i < leaves.size(); ++i)
+            leaves[i] = i;
+        std::stable_sort(leaves.begin(), leaves.end(), lessMaxDoc(subReaders));
+        
+        Collection< Collection<int32_t> > sliceList(Collection< Collection<int32_t> >::newInstance());
+        Collection<int32_t> slice;
+        int32_t sliceDocs = 0;
+        for (Collection<int32_t>::iterator leaf = leaves.begin(); leaf != leaves.end(); ++leaf)
+        {
+            if (!slice)
+            {
+                slice = Collection<int32_t>::newInstance();
+                sliceDocs = 0;
+            }
+            slice.add(*leaf);
+            sliceDocs += subReaders[*leaf]->maxDoc();
+            if (sliceDocs > MAX_DOCS_PER_SLICE || slice.size() >= MAX_SEGMENTS_PER_SLICE)
             {
-                results->setNextReader(subReaders[i], docStarts[i]);
-                searchWithFilter(subReaders[i], weight, filter, results);
+                sliceList.add(slice);
+                slice.reset();
             }
         }
+        if (slice)
+            sliceList.add(slice);
+        
+        // in-order collectors rely on the subreaders of a slice being searched in doc order
+        for (Collection< Collection<int32_t> >::iterator leafSlice = sliceList.begin(); leafSlice != sliceList.end(); ++leafSlice)
+            std::sort(leafSlice->begin(), leafSlice->end());
+        return sliceList;
+    }
+    
+    IndexSearcherSliceCallable::IndexSearcherSliceCallable(IndexSearcherPtr searcher, Collection<int32_t> leaves, WeightPtr weight, FilterPtr filter, CollectorPtr collector)
+    {
+        this->searcher = searcher;
+        this->leaves = leaves;
+        this->weight = weight;
+        this->filter = filter;
+        this->collector = collector;
+    }
+    
+    IndexSearcherSliceCallable::~IndexSearcherSliceCallable()
+    {
+    }
+    
+    int32_t IndexSearcherSliceCallable::call()
+    {
+        // an exception must not escape the thread of the executor, so it is passed back to the searching thread
+        try
+        {
+            for (Collection<int32_t>::iterator leaf = leaves.begin(); leaf != leaves.end(); ++leaf)
+                searcher->searchLeaf(*leaf, weight, filter, collector);
+        }
+        catch (LuceneException& e)
+        {
+            error = e;
+        }
+        return 0;
     }
     
     void IndexSearcher::searchWithFilter(IndexReaderPtr reader, WeightPtr weight, FilterPtr filter, CollectorPtr collector)
@@ -166,8 +405,12 @@ namespace Lucene
             return;
         }
         
+        // leapfrog the filter with the approximation of the scorer, and confirm only the docs they agree on
+        TwoPhaseIteratorPtr twoPhase(scorer->twoPhaseIterator());
+        DocIdSetIteratorPtr scorerIter(twoPhase ? twoPhase->approximation() : scorer);
+        
         int32_t filterDoc = filterIter->nextDoc();
-        int32_t scorerDoc = scorer->advance(filterDoc);
+        int32_t scorerDoc = scorerIter->advance(filterDoc);
         
         collector->setScorer(scorer);
         while (true)
@@ -177,14 +420,15 @@ namespace Lucene
                 // Check if scorer has exhausted, only before collecting.
                 if (scorerDoc == DocIdSetIterator::NO_MORE_DOCS)
                     break;
-                collector->collect(scorerDoc);
+                if (!twoPhase || twoPhase->matches())
+                    collector->collect(scorerDoc);
                 filterDoc = filterIter->nextDoc();
-                scorerDoc = scorer->advance(filterDoc);
+                scorerDoc = scorerIter->advance(filterDoc);
             }
             else if (scorerDoc > filterDoc)
                 filterDoc = filterIter->advance(scorerDoc);
             else
-                scorerDoc = scorer->advance(filterDoc);
+                scorerDoc = scorerIter->advance(filterDoc);
         }
     }
     
@@ -208,4 +452,16 @@ namespace Lucene
         fieldSortDoTrackScores = doTrackScores;
         fieldSortDoMaxScore = doMaxScore;
     }
+    
+    void IndexSearcher::setTotalHitsThreshold(int32_t totalHitsThreshold)
+    {
+        if (totalHitsThreshold < 0)
+            boost::throw_exception(IllegalArgumentException(L"totalHitsThreshold must be >= 0"));
+        this->totalHitsThreshold = totalHitsThreshold;
+    }
+    
+    int32_t IndexSearcher::getTotalHitsThreshold()
+    {
+        return totalHitsThreshold;
+    }
 }
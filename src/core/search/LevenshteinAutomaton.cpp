@@ -0,0 +1,169 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "LevenshteinAutomaton.h"
+
+namespace Lucene
+{
+    LevenshteinAutomaton::LevenshteinAutomaton(const String& text, int32_t maxDistance)
+    {
+        this->text = text;
+        this->maxDistance = maxDistance;
+        this->width = text.length() + 1;
+        
+        this->alphabet = Collection<wchar_t>::newInstance(text.begin(), text.end());
+        std::sort(alphabet.begin(), alphabet.end());
+        alphabet.remove(std::unique(alphabet.begin(), alphabet.end()), alphabet.end());
+        
+        this->rows = Collection<int32_t>::newInstance();
+    }
+    
+    LevenshteinAutomaton::~LevenshteinAutomaton()
+    {
+    }
+    
+    bool LevenshteinAutomaton::accepts(const String& s)
+    {
+        return (readLive(s) == (int32_t)s.length() && isAccepting(s.length()));
+    }
+    
+    bool LevenshteinAutomaton::nextAccepted(const String& s, String& next)
+    {
+        int32_t length = readLive(s);
+        wchar_t c;
+        
+        // the strings that s is a prefix of are greater than s and, as the state of s is live, some of them are accepted
+        if (length == (int32_t)s.length() && nextLiveChar(length, 0, c))
+        {
+            next = s;
+            next += c;
+            complete(length + 1, next);
+            return true;
+        }
+        
+        // otherwise replace the last char of s that can be increased without leaving the live states
+        for (int32_t i = std::min(length, (int32_t)s.length() - 1); i >= 0; --i)
+        {
+            if (s[i] < std::numeric_limits<wchar_t>::max() && nextLiveChar(i, s[i] + 1, c))
+            {
+                next = s.substr(0, i);
+                next += c;
+                complete(i + 1, next);
+                return true;
+            }
+        }
+        
+        return false;
+    }
+    
+    int32_t LevenshteinAutomaton::readLive(const String& s)
+    {
+        ensureRows(s.length() + 2);
+        for (int32_t i = 0; i < width; ++i)
+            rows[i] = std::min(i, maxDistance + 1);
+        int32_t length = 0;
+        while (length < (int32_t)s.length())
+        {
+            step(length, s[length]);
+            if (!isLive(length + 1))
+                break;
+            ++length;
+        }
+        return length;
+    }
+    
+    void LevenshteinAutomaton::step(int32_t row, wchar_t c)
+    {
+        int32_t limit = maxDistance + 1;
+        int32_t from = row * width;
+        int32_t to = from + width;
+        rows[to] = std::min(rows[from] + 1, limit);
+        for (int32_t i = 1; i < width; ++i)
+        {
+            // minimum of cell to the left+1, to the top+1, diagonally left and up +(0|1)
+            int32_t distance = rows[from + i - 1] + (text[i - 1] == c ? 0 : 1);
+            distance = std::min(distance, std::min(rows[from + i], rows[to + i - 1]) + 1);
+            rows[to + i] = std::min(distance, limit);
+        }
+    }
+    
+    bool LevenshteinAutomaton::nextLiveChar(int32_t row, wchar_t from, wchar_t& c)
+    {
+        ensureRows(row + 2);
+        
+        // the smallest char from on that is not in the text
+        Collection<wchar_t>::iterator letter = std::lower_bound(alphabet.begin(), alphabet.end(), from);
+        wchar_t other = from;
+        bool hasOther = true;
+        for (Collection<wchar_t>::iterator scan = letter; hasOther && scan != alphabet.end() && *scan == other; ++scan)
+        {
+            if (other == std::numeric_limits<wchar_t>::max())
+                hasOther = false;
+            else
+                ++other;
+        }
+        
+        bool otherLive = false;
+        if (hasOther)
+        {
+            step(row, other);
+            otherLive = isLive(row + 1);
+        }
+        
+        for (; letter != alphabet.end() && (!otherLive || *letter < other); ++letter)
+        {
+            step(row, *letter);
+            if (isLive(row + 1))
+            {
+                c = *letter;
+                return true;
+            }
+        }
+        
+        if (otherLive)
+        {
+            step(row, other);
+            c = other;
+            return true;
+        }
+        
+        return false;
+    }
+    
+    void LevenshteinAutomaton::complete(int32_t row, String& next)
+    {
+        // the shortest completion is the smallest one, so stop at the first accepting state
+        wchar_t c;
+        while (!isAccepting(row) && nextLiveChar(row, 0, c))
+        {
+            next += c;
+            ++row;
+        }
+    }
+    
+    bool LevenshteinAutomaton::isLive(int32_t row)
+    {
+        int32_t start = row * width;
+        for (int32_t i = start; i < start + width; ++i)
+        {
+            if (rows[i] <= maxDistance)
+                return true;
+        }
+        return false;
+    }
+    
+    bool LevenshteinAutomaton::isAccepting(int32_t row)
+    {
+        return (rows[(row + 1) * width - 1] <= maxDistance);
+    }
+    
+    void LevenshteinAutomaton::ensureRows(int32_t numRows)
+    {
+        if (rows.size() < numRows * width)
+            rows.resize(numRows * width);
+    }
+}
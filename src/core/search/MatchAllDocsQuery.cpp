@@ -12,6 +12,7 @@
 #include "TermDocs.h"
 #include "ComplexExplanation.h"
 #include "Searcher.h"
+#include "NormValues.h"
 #include "MiscUtils.h"
 
 namespace Lucene
@@ -102,7 +103,7 @@ namespace Lucene
     
     ScorerPtr MatchAllDocsWeight::scorer(IndexReaderPtr reader, bool scoreDocsInOrder, bool topScorer)
     {
-        return newLucene<MatchAllScorer>(query, reader, similarity, shared_from_this(), !query->normsField.empty() ? reader->norms(query->normsField) : ByteArray());
+        return newLucene<MatchAllScorer>(query, reader, similarity, shared_from_this(), !query->normsField.empty() ? reader->normValues(query->normsField) : NormValuesPtr());
     }
     
     ExplanationPtr MatchAllDocsWeight::explain(IndexReaderPtr reader, int32_t doc)
@@ -115,7 +116,7 @@ namespace Lucene
         return queryExpl;
     }
     
-    MatchAllScorer::MatchAllScorer(MatchAllDocsQueryPtr query, IndexReaderPtr reader, SimilarityPtr similarity, WeightPtr weight, ByteArray norms) : Scorer(similarity)
+    MatchAllScorer::MatchAllScorer(MatchAllDocsQueryPtr query, IndexReaderPtr reader, SimilarityPtr similarity, WeightPtr weight, NormValuesPtr norms) : Scorer(similarity)
     {
         this->query = query;
         this->termDocs = reader->termDocs(TermPtr());
@@ -141,7 +142,7 @@ namespace Lucene
     
     double MatchAllScorer::score()
     {
-        return norms ? _score * Similarity::decodeNorm(norms[docID()]) : _score;
+        return norms ? _score * Similarity::decodeNorm(norms->get(docID())) : _score;
     }
     
     int32_t MatchAllScorer::advance(int32_t target)
@@ -19,6 +19,14 @@ namespace Lucene
 {
     ParallelMultiSearcher::ParallelMultiSearcher(Collection<SearchablePtr> searchables) : MultiSearcher(searchables)
     {
+        this->executor = ThreadPool::getInstance();
+    }
+    
+    ParallelMultiSearcher::ParallelMultiSearcher(Collection<SearchablePtr> searchables, ThreadPoolPtr executor) : MultiSearcher(searchables)
+    {
+        if (!executor)
+            boost::throw_exception(NullPointerException(L"executor must not be null"));
+        this->executor = executor;
     }
     
     ParallelMultiSearcher::~ParallelMultiSearcher()
@@ -27,10 +35,9 @@ namespace Lucene
     
     int32_t ParallelMultiSearcher::docFreq(TermPtr term)
     {
-        ThreadPoolPtr threadPool(ThreadPool::getInstance());
         Collection<FuturePtr> searchThreads(Collection<FuturePtr>::newInstance(searchables.size()));
         for (int32_t i = 0; i < searchables.size(); ++i)
-            searchThreads[i] = threadPool->scheduleTask(boost::protect(boost::bind<int32_t>(boost::mem_fn(&Searchable::docFreq), searchables[i], term)));
+            searchThreads[i] = executor->scheduleTask(boost::protect(boost::bind<int32_t>(boost::mem_fn(&Searchable::docFreq), searchables[i], term)));
         int32_t docFreq = 0;
         for (int32_t i = 0; i < searchThreads.size(); ++i)
             docFreq += searchThreads[i]->get<int32_t>();
@@ -41,13 +48,12 @@ namespace Lucene
     {
         HitQueuePtr hq(newLucene<HitQueue>(n, false));
         SynchronizePtr lock(newInstance<Synchronize>());
-        ThreadPoolPtr threadPool(ThreadPool::getInstance());
         Collection<FuturePtr> searchThreads(Collection<FuturePtr>::newInstance(searchables.size()));
         Collection<MultiSearcherCallableNoSortPtr> multiSearcher(Collection<MultiSearcherCallableNoSortPtr>::newInstance(searchables.size()));
         for (int32_t i = 0; i < searchables.size(); ++i) // search each searchable
         {
             multiSearcher[i] = newLucene<MultiSearcherCallableNoSort>(lock, searchables[i], weight, filter, n, hq, i, starts);
-            searchThreads[i] = threadPool->scheduleTask(boost::protect(boost::bind<TopDocsPtr>(boost::mem_fn(&MultiSearcherCallableNoSort::call), multiSearcher[i])));
+            searchThreads[i] = executor->scheduleTask(boost::protect(boost::bind<TopDocsPtr>(boost::mem_fn(&MultiSearcherCallableNoSort::call), multiSearcher[i])));
         }
         
         int32_t totalHits = 0;
@@ -73,13 +79,12 @@ namespace Lucene
              boost::throw_exception(NullPointerException(L"sort must not be null"));
         FieldDocSortedHitQueuePtr hq(newLucene<FieldDocSortedHitQueue>(n));
         SynchronizePtr lock(newInstance<Synchronize>());
-        ThreadPoolPtr threadPool(ThreadPool::getInstance());
         Collection<FuturePtr> searchThreads(Collection<FuturePtr>::newInstance(searchables.size()));
         Collection<MultiSearcherCallableWithSortPtr> multiSearcher(Collection<MultiSearcherCallableWithSortPtr>::newInstance(searchables.size()));
         for (int32_t i = 0; i < searchables.size(); ++i) // search each searchable
         {
             multiSearcher[i] = newLucene<MultiSearcherCallableWithSort>(lock, searchables[i], weight, filter, n, hq, sort, i, starts);
-            searchThreads[i] = threadPool->scheduleTask(boost::protect(boost::bind<TopFieldDocsPtr>(boost::mem_fn(&MultiSearcherCallableWithSort::call), multiSearcher[i])));
+            searchThreads[i] = executor->scheduleTask(boost::protect(boost::bind<TopFieldDocsPtr>(boost::mem_fn(&MultiSearcherCallableWithSort::call), multiSearcher[i])));
         }
         
         int32_t totalHits = 0;
@@ -15,6 +15,7 @@
 #include "ExactPhraseScorer.h"
 #include "SloppyPhraseScorer.h"
 #include "Explanation.h"
+#include "NormValues.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
 
@@ -214,9 +215,9 @@ namespace Lucene
         }
         
         if (query->slop == 0) // optimize exact case
-            return newLucene<ExactPhraseScorer>(shared_from_this(), tps, query->getPositions(), similarity, reader->norms(query->field));
+            return newLucene<ExactPhraseScorer>(shared_from_this(), tps, query->getPositions(), similarity, reader->normValues(query->field));
         else
-            return newLucene<SloppyPhraseScorer>(shared_from_this(), tps, query->getPositions(), similarity, query->slop, reader->norms(query->field));
+            return newLucene<SloppyPhraseScorer>(shared_from_this(), tps, query->getPositions(), similarity, query->slop, reader->normValues(query->field));
     }
     
     ExplanationPtr PhraseWeight::explain(IndexReaderPtr reader, int32_t doc)
@@ -271,8 +272,8 @@ namespace Lucene
         fieldExpl->addDetail(idfExpl);
         
         ExplanationPtr fieldNormExpl(newLucene<Explanation>());
-        ByteArray fieldNorms(reader->norms(query->field));
-        double fieldNorm = fieldNorms ? Similarity::decodeNorm(fieldNorms[doc]) : 1.0;
+        NormValuesPtr fieldNorms(reader->normValues(query->field));
+        double fieldNorm = fieldNorms ? Similarity::decodeNorm(fieldNorms->get(doc)) : 1.0;
         fieldNormExpl->setValue(fieldNorm);
         fieldNormExpl->setDescription(L"fieldNorm(field=" + query->field + L", doc=" + StringUtils::toString(doc) + L")");
         fieldExpl->addDetail(fieldNormExpl);
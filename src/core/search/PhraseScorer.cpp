@@ -6,14 +6,30 @@
 
 #include "LuceneInc.h"
 #include "PhraseScorer.h"
+#include "_PhraseScorer.h"
 #include "PhrasePositions.h"
 #include "PhraseQueue.h"
 #include "Weight.h"
 #include "Similarity.h"
+#include "NormValues.h"
 
 namespace Lucene
 {
+    PhraseScorer::PhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, NormValuesPtr norms) : Scorer(similarity)
+    {
+        ConstructScorer(weight, tps, offsets, norms);
+    }
+    
     PhraseScorer::PhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, ByteArray norms) : Scorer(similarity)
+    {
+        ConstructScorer(weight, tps, offsets, NormValues::fromBytes(norms));
+    }
+    
+    PhraseScorer::~PhraseScorer()
+    {
+    }
+    
+    void PhraseScorer::ConstructScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, NormValuesPtr norms)
     {
         this->firstTime = true;
         this->more = true;
@@ -40,16 +56,17 @@ namespace Lucene
         first->doc = -1;
     }
     
-    PhraseScorer::~PhraseScorer()
-    {
-    }
-    
     int32_t PhraseScorer::docID()
     {
         return first->doc;
     }
     
     int32_t PhraseScorer::nextDoc()
+    {
+        return toMatch(approximationNextDoc());
+    }
+    
+    int32_t PhraseScorer::approximationNextDoc()
     {
         if (firstTime)
         {
@@ -58,50 +75,58 @@ namespace Lucene
         }
         else if (more)
             more = last->next(); // trigger further scanning
-        if (!doNext())
-            first->doc = NO_MORE_DOCS;
-        return first->doc;
+        return alignDocs();
     }
     
-    bool PhraseScorer::doNext()
+    int32_t PhraseScorer::alignDocs()
     {
-        while (more)
+        while (more && first->doc < last->doc) // find doc with all the terms
         {
-            while (more && first->doc < last->doc) // find doc with all the terms
-            {
-                more = first->skipTo(last->doc); // skip first upto last and move it to the end
-                firstToLast();
-            }
-            
-            if (more)
-            {
-                // found a doc with all of the terms
-                freq = phraseFreq(); // check for phrase
-                if (freq == 0.0) // no match
-                    more = last->next(); // trigger further scanning
-                else
-                    return true;
-            }
+            more = first->skipTo(last->doc); // skip first upto last and move it to the end
+            firstToLast();
         }
-        return false; // no more matches
+        if (!more)
+            first->doc = NO_MORE_DOCS;
+        return first->doc;
+    }
+    
+    bool PhraseScorer::matches()
+    {
+        freq = phraseFreq(); // check for phrase
+        return (freq != 0.0);
+    }
+    
+    int32_t PhraseScorer::toMatch(int32_t doc)
+    {
+        while (doc != NO_MORE_DOCS && !matches())
+            doc = approximationNextDoc();
+        return doc;
     }
     
     double PhraseScorer::score()
     {
         double raw = getSimilarity()->tf(freq) * value; // raw score
-        return !norms ? raw : raw * Similarity::decodeNorm(norms[first->doc]); // normalize
+        return !norms ? raw : raw * Similarity::decodeNorm(norms->get(first->doc)); // normalize
     }
     
     int32_t PhraseScorer::advance(int32_t target)
+    {
+        return toMatch(approximationAdvance(target));
+    }
+    
+    int32_t PhraseScorer::approximationAdvance(int32_t target)
     {
         firstTime = false;
         for (PhrasePositionsPtr pp(first); more && pp; pp = pp->_next)
             more = pp->skipTo(target);
         if (more)
             sort(); // re-sort
-        if (!doNext())
-            first->doc = NO_MORE_DOCS;
-        return first->doc;
+        return alignDocs();
+    }
+    
+    TwoPhaseIteratorPtr PhraseScorer::twoPhaseIterator()
+    {
+        return newLucene<PhraseScorerTwoPhaseIterator>(shared_from_this());
     }
     
     double PhraseScorer::currentFreq()
@@ -153,4 +178,42 @@ namespace Lucene
     {
         return L"scorer(" + weight->toString() + L")";
     }
+    
+    PhraseScorerApproximation::PhraseScorerApproximation(PhraseScorerPtr scorer)
+    {
+        this->scorer = scorer;
+    }
+    
+    PhraseScorerApproximation::~PhraseScorerApproximation()
+    {
+    }
+    
+    int32_t PhraseScorerApproximation::docID()
+    {
+        return scorer->docID();
+    }
+    
+    int32_t PhraseScorerApproximation::nextDoc()
+    {
+        return scorer->approximationNextDoc();
+    }
+    
+    int32_t PhraseScorerApproximation::advance(int32_t target)
+    {
+        return scorer->approximationAdvance(target);
+    }
+    
+    PhraseScorerTwoPhaseIterator::PhraseScorerTwoPhaseIterator(PhraseScorerPtr scorer) : TwoPhaseIterator(newLucene<PhraseScorerApproximation>(scorer))
+    {
+        this->scorer = scorer;
+    }
+    
+    PhraseScorerTwoPhaseIterator::~PhraseScorerTwoPhaseIterator()
+    {
+    }
+    
+    bool PhraseScorerTwoPhaseIterator::matches()
+    {
+        return scorer->matches();
+    }
 }
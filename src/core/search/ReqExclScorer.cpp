@@ -6,14 +6,19 @@
 
 #include "LuceneInc.h"
 #include "ReqExclScorer.h"
+#include "_ReqExclScorer.h"
 
 namespace Lucene
 {
     ReqExclScorer::ReqExclScorer(ScorerPtr reqScorer, DocIdSetIteratorPtr exclDisi) : Scorer(SimilarityPtr()) // No similarity used.
     {
         this->reqScorer = reqScorer;
-        this->exclDisi = exclDisi;
-        this->doc = -1;
+        this->reqTwoPhase = reqScorer->twoPhaseIterator();
+        this->reqApproximation = reqTwoPhase ? reqTwoPhase->approximation() : reqScorer;
+        ScorerPtr exclScorer(boost::dynamic_pointer_cast<Scorer>(exclDisi));
+        if (exclScorer)
+            this->exclTwoPhase = exclScorer->twoPhaseIterator();
+        this->exclApproximation = exclTwoPhase ? exclTwoPhase->approximation() : exclDisi;
     }
     
     ReqExclScorer::~ReqExclScorer()
@@ -22,74 +27,58 @@ namespace Lucene
     
     int32_t ReqExclScorer::nextDoc()
     {
-        if (!reqScorer)
-            return doc;
-        doc = reqScorer->nextDoc();
-        if (doc == NO_MORE_DOCS)
-        {
-            reqScorer.reset(); // exhausted, nothing left
-            return doc;
-        }
-        if (!exclDisi)
-            return doc;
-        doc = toNonExcluded();
-        return doc;
+        return toNonExcluded(reqApproximation->nextDoc());
     }
     
-    int32_t ReqExclScorer::toNonExcluded()
+    bool ReqExclScorer::matches()
     {
-        int32_t exclDoc = exclDisi->docID();
-        int32_t reqDoc = reqScorer->docID(); // may be excluded
-        do
-        {
-            if (reqDoc < exclDoc)
-                return reqDoc; // reqScorer advanced to before exclScorer, ie. not excluded
-            else if (reqDoc > exclDoc)
-            {
-                exclDoc = exclDisi->advance(reqDoc);
-                if (exclDoc == NO_MORE_DOCS)
-                {
-                    exclDisi.reset(); // exhausted, no more exclusions
-                    return reqDoc;
-                }
-                if (exclDoc > reqDoc)
-                    return reqDoc; // not excluded
-            }
-        }
-        while ((reqDoc = reqScorer->nextDoc()) != NO_MORE_DOCS);
-        reqScorer.reset(); // exhausted, nothing left
-        return NO_MORE_DOCS;
+        int32_t doc = reqApproximation->docID();
+        int32_t exclDoc = exclApproximation->docID();
+        if (exclDoc < doc)
+            exclDoc = exclApproximation->advance(doc);
+        if (exclDoc == doc && (!exclTwoPhase || exclTwoPhase->matches()))
+            return false; // excluded
+        return (!reqTwoPhase || reqTwoPhase->matches());
     }
     
-    int32_t ReqExclScorer::docID()
+    int32_t ReqExclScorer::toNonExcluded(int32_t doc)
     {
+        while (doc != NO_MORE_DOCS && !matches())
+            doc = reqApproximation->nextDoc();
         return doc;
     }
     
+    int32_t ReqExclScorer::docID()
+    {
+        return reqApproximation->docID();
+    }
+    
     double ReqExclScorer::score()
     {
-        return reqScorer->score(); // reqScorer may be null when next() or skipTo() already return false
+        return reqScorer->score();
     }
     
     int32_t ReqExclScorer::advance(int32_t target)
     {
-        if (!reqScorer)
-        {
-            doc = NO_MORE_DOCS;
-            return doc;
-        }
-        if (!exclDisi)
-        {
-            doc = reqScorer->advance(target);
-            return doc;
-        }
-        if (reqScorer->advance(target) == NO_MORE_DOCS)
-        {
-            reqScorer.reset();
-            doc = NO_MORE_DOCS;
-            return doc;
-        }
-        doc = toNonExcluded();
-        return doc;
+        return toNonExcluded(reqApproximation->advance(target));
+    }
+    
+    TwoPhaseIteratorPtr ReqExclScorer::twoPhaseIterator()
+    {
+        return newLucene<ReqExclScorerTwoPhaseIterator>(shared_from_this());
+    }
+    
+    ReqExclScorerTwoPhaseIterator::ReqExclScorerTwoPhaseIterator(ReqExclScorerPtr scorer) : TwoPhaseIterator(scorer->reqApproximation)
+    {
+        this->scorer = scorer;
+    }
+    
+    ReqExclScorerTwoPhaseIterator::~ReqExclScorerTwoPhaseIterator()
+    {
+    }
+    
+    bool ReqExclScorerTwoPhaseIterator::matches()
+    {
+        return scorer->matches();
     }
 }
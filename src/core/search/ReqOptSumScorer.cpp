@@ -34,6 +34,11 @@ namespace Lucene
         return reqScorer->docID();
     }
     
+    TwoPhaseIteratorPtr ReqOptSumScorer::twoPhaseIterator()
+    {
+        return reqScorer->twoPhaseIterator();
+    }
+    
     double ReqOptSumScorer::score()
     {
         int32_t curDoc = reqScorer->docID();
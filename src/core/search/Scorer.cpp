@@ -32,6 +32,25 @@ namespace Lucene
             collector->collect(doc);
     }
     
+    int32_t Scorer::advanceShallow(int32_t target)
+    {
+        return NO_MORE_DOCS;
+    }
+    
+    double Scorer::getMaxScore(int32_t upTo)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    
+    void Scorer::setMinCompetitiveScore(double minScore)
+    {
+    }
+    
+    TwoPhaseIteratorPtr Scorer::twoPhaseIterator()
+    {
+        return TwoPhaseIteratorPtr();
+    }
+    
     bool Scorer::score(CollectorPtr collector, int32_t max, int32_t firstDocID)
     {
         collector->setScorer(shared_from_this());
@@ -87,11 +87,11 @@ namespace Lucene
         int32_t max = searcher->maxDoc();
         double _idf = 0.0;
         String exp;
-        for (Collection<TermPtr>::iterator term = terms.begin(); term != terms.end(); ++term)
+        Collection<int32_t> dfs(searcher->docFreqs(terms));
+        for (int32_t i = 0; i < terms.size(); ++i)
         {
-            int32_t df = searcher->docFreq(*term);
-            _idf += idf(df, max);
-            exp += L" " + (*term)->text() + L"=" + StringUtils::toString(df);
+            _idf += idf(dfs[i], max);
+            exp += L" " + terms[i]->text() + L"=" + StringUtils::toString(dfs[i]);
         }
         return newLucene<SimilarityIDFExplanation>(exp, _idf);
     }
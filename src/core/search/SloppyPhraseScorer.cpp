@@ -12,6 +12,12 @@
 
 namespace Lucene
 {
+    SloppyPhraseScorer::SloppyPhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, int32_t slop, NormValuesPtr norms) : PhraseScorer(weight, tps, offsets, similarity, norms)
+    {
+        this->slop = slop;
+        this->checkedRepeats = false;
+    }
+    
     SloppyPhraseScorer::SloppyPhraseScorer(WeightPtr weight, Collection<TermPositionsPtr> tps, Collection<int32_t> offsets, SimilarityPtr similarity, int32_t slop, ByteArray norms) : PhraseScorer(weight, tps, offsets, similarity, norms)
     {
         this->slop = slop;
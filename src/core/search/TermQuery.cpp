@@ -13,6 +13,7 @@
 #include "Term.h"
 #include "TermDocs.h"
 #include "Similarity.h"
+#include "NormValues.h"
 #include "MiscUtils.h"
 #include "StringUtils.h"
 
@@ -124,7 +125,7 @@ namespace Lucene
     ScorerPtr TermWeight::scorer(IndexReaderPtr reader, bool scoreDocsInOrder, bool topScorer)
     {
         TermDocsPtr termDocs(reader->termDocs(query->term));
-        return termDocs ? newLucene<TermScorer>(shared_from_this(), termDocs, similarity, reader->norms(query->term->field())) : ScorerPtr();
+        return termDocs ? newLucene<TermScorer>(shared_from_this(), termDocs, similarity, reader->normValues(query->term->field())) : ScorerPtr();
     }
     
     ExplanationPtr TermWeight::explain(IndexReaderPtr reader, int32_t doc)
@@ -184,8 +185,8 @@ namespace Lucene
         fieldExpl->addDetail(expl);
         
         ExplanationPtr fieldNormExpl(newLucene<Explanation>());
-        ByteArray fieldNorms(reader->norms(field));
-        double fieldNorm = fieldNorms ? Similarity::decodeNorm(fieldNorms[doc]) : 1.0;
+        NormValuesPtr fieldNorms(reader->normValues(field));
+        double fieldNorm = fieldNorms ? Similarity::decodeNorm(fieldNorms->get(doc)) : 1.0;
         fieldNormExpl->setValue(fieldNorm);
         fieldNormExpl->setDescription(L"fieldNorm(field=" + field + L", doc=" + StringUtils::toString(doc) + L")");
         fieldExpl->addDetail(fieldNormExpl);
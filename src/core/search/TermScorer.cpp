@@ -10,12 +10,27 @@
 #include "Similarity.h"
 #include "Weight.h"
 #include "Collector.h"
+#include "NormValues.h"
 
 namespace Lucene
 {
     const int32_t TermScorer::SCORE_CACHE_SIZE = 32;
     
+    TermScorer::TermScorer(WeightPtr weight, TermDocsPtr td, SimilarityPtr similarity, NormValuesPtr norms) : Scorer(similarity)
+    {
+        ConstructScorer(weight, td, norms);
+    }
+    
     TermScorer::TermScorer(WeightPtr weight, TermDocsPtr td, SimilarityPtr similarity, ByteArray norms) : Scorer(similarity)
+    {
+        ConstructScorer(weight, td, NormValues::fromBytes(norms));
+    }
+    
+    TermScorer::~TermScorer()
+    {
+    }
+    
+    void TermScorer::ConstructScorer(WeightPtr weight, TermDocsPtr td, NormValuesPtr norms)
     {
         this->weight = weight;
         this->termDocs = td;
@@ -27,15 +42,13 @@ namespace Lucene
         this->pointer = 0;
         this->pointerMax = 0;
         this->scoreCache = Collection<double>::newInstance(SCORE_CACHE_SIZE);
+        this->shallowUpTo = -1;
+        this->shallowMaxScore = std::numeric_limits<double>::infinity();
         
         for (int32_t i = 0; i < SCORE_CACHE_SIZE; ++i)
             scoreCache[i] = getSimilarity()->tf(i) * weightValue;
     }
     
-    TermScorer::~TermScorer()
-    {
-    }
-    
     const Collection<double> TermScorer::SIM_NORM_DECODER()
     {
         return Similarity::getNormDecoder();
@@ -100,7 +113,7 @@ namespace Lucene
         BOOST_ASSERT(doc != -1);
         int32_t f = freqs[pointer];
         double raw = f < SCORE_CACHE_SIZE ? scoreCache[f] : getSimilarity()->tf(f) * weightValue; // compute tf(f) * weight
-        return norms ? raw * SIM_NORM_DECODER()[norms[doc] & 0xff] : raw; // normalize for field
+        return norms ? raw * SIM_NORM_DECODER()[norms->get(doc) & 0xff] : raw; // normalize for field
     }
     
     int32_t TermScorer::advance(int32_t target)
@@ -130,6 +143,29 @@ namespace Lucene
         return doc;
     }
     
+    int32_t TermScorer::advanceShallow(int32_t target)
+    {
+        int32_t maxFreq = 0;
+        int32_t maxNorm = 0;
+        shallowUpTo = termDocs->advanceShallow(target, maxFreq, maxNorm);
+        if (maxFreq == INT_MAX)
+            shallowMaxScore = std::numeric_limits<double>::infinity();
+        else if (weightValue < 0.0)
+            shallowMaxScore = 0.0; // a greater frequency or norm only lowers the score
+        else
+        {
+            // computed as score() does, so that rounding can't take a score past its bound
+            double raw = maxFreq < SCORE_CACHE_SIZE ? scoreCache[maxFreq] : getSimilarity()->tf(maxFreq) * weightValue;
+            shallowMaxScore = norms ? raw * SIM_NORM_DECODER()[maxNorm & 0xff] : raw;
+        }
+        return shallowUpTo == INT_MAX ? NO_MORE_DOCS : shallowUpTo;
+    }
+    
+    double TermScorer::getMaxScore(int32_t upTo)
+    {
+        return upTo <= shallowUpTo ? shallowMaxScore : std::numeric_limits<double>::infinity();
+    }
+    
     String TermScorer::toString()
     {
         return L"scorer(" + weight->toString() + L")";
@@ -15,12 +15,14 @@
 
 namespace Lucene
 {
-    TopScoreDocCollector::TopScoreDocCollector(int32_t numHits) : TopDocsCollector(newLucene<HitQueue>(numHits, true))
+    TopScoreDocCollector::TopScoreDocCollector(int32_t numHits, int32_t totalHitsThreshold) : TopDocsCollector(newLucene<HitQueue>(numHits, true))
     {
         // HitQueue implements getSentinelObject to return a ScoreDoc, so we know that at this point top() 
         // is already initialized.
         pqTop = pq->top();
         docBase = 0;
+        this->totalHitsThreshold = totalHitsThreshold;
+        this->minCompetitiveScore = -std::numeric_limits<double>::infinity();
     }
     
     TopScoreDocCollector::~TopScoreDocCollector()
@@ -35,6 +37,31 @@ namespace Lucene
             return newLucene<OutOfOrderTopScoreDocCollector>(numHits);
     }
     
+    TopScoreDocCollectorPtr TopScoreDocCollector::create(int32_t numHits, bool docsScoredInOrder, int32_t totalHitsThreshold)
+    {
+        if (totalHitsThreshold < 0)
+            boost::throw_exception(IllegalArgumentException(L"totalHitsThreshold must be >= 0"));
+        if (docsScoredInOrder)
+            return newLucene<InOrderTopScoreDocCollector>(numHits, totalHitsThreshold);
+        else
+            return newLucene<OutOfOrderTopScoreDocCollector>(numHits, totalHitsThreshold);
+    }
+    
+    bool TopScoreDocCollector::needsTopScoresOnly()
+    {
+        return (totalHitsThreshold != INT_MAX);
+    }
+    
+    void TopScoreDocCollector::updateMinCompetitiveScore(ScorerPtr scorer)
+    {
+        // the sentinels hold the top of the queue at negative infinity until it is full
+        if (pqTop->score > minCompetitiveScore)
+        {
+            minCompetitiveScore = pqTop->score;
+            scorer->setMinCompetitiveScore(minCompetitiveScore);
+        }
+    }
+    
     TopDocsPtr TopScoreDocCollector::newTopDocs(Collection<ScoreDocPtr> results, int32_t start)
     {
         if (!results)
@@ -64,9 +91,12 @@ namespace Lucene
     void TopScoreDocCollector::setScorer(ScorerPtr scorer)
     {
         this->_scorer = scorer;
+        // hits of the next reader must beat those already collected
+        if (minCompetitiveScore != -std::numeric_limits<double>::infinity())
+            scorer->setMinCompetitiveScore(minCompetitiveScore);
     }
     
-    InOrderTopScoreDocCollector::InOrderTopScoreDocCollector(int32_t numHits) : TopScoreDocCollector(numHits)
+    InOrderTopScoreDocCollector::InOrderTopScoreDocCollector(int32_t numHits, int32_t totalHitsThreshold) : TopScoreDocCollector(numHits, totalHitsThreshold)
     {
     }
     
@@ -76,7 +106,8 @@ namespace Lucene
     
     void InOrderTopScoreDocCollector::collect(int32_t doc)
     {
-        double score = ScorerPtr(_scorer)->score();
+        ScorerPtr scorer(_scorer);
+        double score = scorer->score();
         
         // This collector cannot handle these scores
         BOOST_ASSERT(score != -std::numeric_limits<double>::infinity());
@@ -88,11 +119,15 @@ namespace Lucene
             // Since docs are returned in-order (ie., increasing doc Id), a document with equal score to 
             // pqTop.score cannot compete since HitQueue favours documents with lower doc Ids.  Therefore 
             // reject those docs too.
+            if (totalHits > totalHitsThreshold)
+                updateMinCompetitiveScore(scorer);
             return;
         }
         pqTop->doc = doc + docBase;
         pqTop->score = score;
         pqTop = pq->updateTop();
+        if (totalHits > totalHitsThreshold)
+            updateMinCompetitiveScore(scorer);
     }
     
     bool InOrderTopScoreDocCollector::acceptsDocsOutOfOrder()
@@ -100,7 +135,7 @@ namespace Lucene
         return false;
     }
     
-    OutOfOrderTopScoreDocCollector::OutOfOrderTopScoreDocCollector(int32_t numHits) : TopScoreDocCollector(numHits)
+    OutOfOrderTopScoreDocCollector::OutOfOrderTopScoreDocCollector(int32_t numHits, int32_t totalHitsThreshold) : TopScoreDocCollector(numHits, totalHitsThreshold)
     {
     }
     
@@ -110,7 +145,8 @@ namespace Lucene
     
     void OutOfOrderTopScoreDocCollector::collect(int32_t doc)
     {
-        double score = ScorerPtr(_scorer)->score();
+        ScorerPtr scorer(_scorer);
+        double score = scorer->score();
         
         // This collector cannot handle NaN
         BOOST_ASSERT(!MiscUtils::isNaN(score));
@@ -118,10 +154,16 @@ namespace Lucene
         ++totalHits;
         doc += docBase;
         if (score < pqTop->score || (score == pqTop->score && doc > pqTop->doc))
+        {
+            if (totalHits > totalHitsThreshold)
+                updateMinCompetitiveScore(scorer);
             return;
+        }
         pqTop->doc = doc;
         pqTop->score = score;
         pqTop = pq->updateTop();
+        if (totalHits > totalHitsThreshold)
+            updateMinCompetitiveScore(scorer);
     }
     
     bool OutOfOrderTopScoreDocCollector::acceptsDocsOutOfOrder()
@@ -0,0 +1,220 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "TwoPhaseIterator.h"
+#include "_TwoPhaseIterator.h"
+#include "Scorer.h"
+#include "TermDocs.h"
+
+namespace Lucene
+{
+    TwoPhaseIterator::TwoPhaseIterator(DocIdSetIteratorPtr approximation)
+    {
+        this->_approximation = approximation;
+    }
+    
+    TwoPhaseIterator::~TwoPhaseIterator()
+    {
+    }
+    
+    DocIdSetIteratorPtr TwoPhaseIterator::approximation()
+    {
+        return _approximation;
+    }
+    
+    DocIdSetIteratorPtr TwoPhaseIterator::asDocIdSetIterator(TwoPhaseIteratorPtr twoPhase)
+    {
+        return newLucene<TwoPhaseIteratorDocIdSetIterator>(twoPhase);
+    }
+    
+    DocIdSetIteratorPtr TwoPhaseIterator::approximationOf(ScorerPtr scorer)
+    {
+        TwoPhaseIteratorPtr twoPhase(scorer->twoPhaseIterator());
+        return twoPhase ? twoPhase->approximation() : scorer;
+    }
+    
+    TwoPhaseIteratorDocIdSetIterator::TwoPhaseIteratorDocIdSetIterator(TwoPhaseIteratorPtr twoPhase)
+    {
+        this->twoPhase = twoPhase;
+        this->approximation = twoPhase->approximation();
+    }
+    
+    TwoPhaseIteratorDocIdSetIterator::~TwoPhaseIteratorDocIdSetIterator()
+    {
+    }
+    
+    int32_t TwoPhaseIteratorDocIdSetIterator::docID()
+    {
+        return approximation->docID();
+    }
+    
+    int32_t TwoPhaseIteratorDocIdSetIterator::nextDoc()
+    {
+        return toMatch(approximation->nextDoc());
+    }
+    
+    int32_t TwoPhaseIteratorDocIdSetIterator::advance(int32_t target)
+    {
+        return toMatch(approximation->advance(target));
+    }
+    
+    int32_t TwoPhaseIteratorDocIdSetIterator::toMatch(int32_t doc)
+    {
+        while (doc != NO_MORE_DOCS && !twoPhase->matches())
+            doc = approximation->nextDoc();
+        return doc;
+    }
+    
+    struct lessIteratorDocId
+    {
+        inline bool operator()(const DocIdSetIteratorPtr& first, const DocIdSetIteratorPtr& second) const
+        {
+            return (first->docID() < second->docID());
+        }
+    };
+    
+    ConjunctionDocIdSetIterator::ConjunctionDocIdSetIterator(Collection<DocIdSetIteratorPtr> iterators)
+    {
+        this->lastDoc = -1;
+        this->iterators = iterators;
+        
+        for (Collection<DocIdSetIteratorPtr>::iterator iterator = iterators.begin(); iterator != iterators.end(); ++iterator)
+        {
+            if ((*iterator)->nextDoc() == NO_MORE_DOCS)
+            {
+                // If even one of the iterators does not have any documents, this iterator should not attempt 
+                // to do any more work.
+                lastDoc = NO_MORE_DOCS;
+                return;
+            }
+        }
+        
+        // Sort the array the first time...
+        // We don't need to sort the array in any future calls because we know it will already start off 
+        // sorted (all iterators on same doc).
+        std::sort(iterators.begin(), iterators.end(), lessIteratorDocId());
+        
+        // NOTE: doNext() must be called before the re-sorting of the array later on.  The reason is this: 
+        // assume there are 5 iterators, whose first docs are 1, 2, 3, 5, 5 respectively. Sorting (above) leaves 
+        // the array as is.  Calling doNext() here advances all the first iterators to 5 (or a larger doc ID
+        // they all agree on). 
+        // However, if we re-sort before doNext() is called, the order will be 5, 3, 2, 1, 5 and then doNext() 
+        // will stop immediately, since the first iterator's docs equals the last one. So the invariant that after 
+        // calling doNext() all iterators are on the same doc ID is broken.
+        if (doNext() == NO_MORE_DOCS)
+        {
+            // The iterators did not agree on any document.
+            lastDoc = NO_MORE_DOCS;
+            return;
+        }
+        
+        // If first-time skip distance is any predictor of iterator sparseness, then we should always try to skip 
+        // first on those iterators.  Keep last iterator in it's last place (it will be the first to be skipped on), 
+        // but reverse all of the others so that they will be skipped on in order of original high skip.
+        int32_t end = iterators.size() - 1;
+        int32_t max = end >> 1;
+        for (int32_t i = 0; i < max; ++i)
+        {
+            DocIdSetIteratorPtr tmp(iterators[i]);
+            int32_t idx = end - i - 1;
+            iterators[i] = iterators[idx];
+            iterators[idx] = tmp;
+        }
+    }
+    
+    ConjunctionDocIdSetIterator::~ConjunctionDocIdSetIterator()
+    {
+    }
+    
+    int32_t ConjunctionDocIdSetIterator::doNext()
+    {
+        int32_t first = 0;
+        int32_t doc = iterators[iterators.size() - 1]->docID();
+        DocIdSetIteratorPtr firstIterator;
+        while ((firstIterator = iterators[first])->docID() < doc)
+        {
+            doc = firstIterator->advance(doc);
+            first = first == iterators.size() - 1 ? 0 : first + 1;
+        }
+        return doc;
+    }
+    
+    int32_t ConjunctionDocIdSetIterator::docID()
+    {
+        return lastDoc;
+    }
+    
+    int32_t ConjunctionDocIdSetIterator::nextDoc()
+    {
+        if (lastDoc == NO_MORE_DOCS)
+            return lastDoc;
+        else if (lastDoc == -1)
+        {
+            lastDoc = iterators[iterators.size() - 1]->docID();
+            return lastDoc;
+        }
+        iterators[iterators.size() - 1]->nextDoc();
+        lastDoc = doNext();
+        return lastDoc;
+    }
+    
+    int32_t ConjunctionDocIdSetIterator::advance(int32_t target)
+    {
+        if (lastDoc == NO_MORE_DOCS)
+            return lastDoc;
+        else if (iterators[iterators.size() - 1]->docID() < target)
+            iterators[iterators.size() - 1]->advance(target);
+        lastDoc = doNext();
+        return lastDoc;
+    }
+    
+    ConjunctionTwoPhaseIterator::ConjunctionTwoPhaseIterator(DocIdSetIteratorPtr approximation, Collection<TwoPhaseIteratorPtr> twoPhaseIterators) : TwoPhaseIterator(approximation)
+    {
+        this->twoPhaseIterators = twoPhaseIterators;
+    }
+    
+    ConjunctionTwoPhaseIterator::~ConjunctionTwoPhaseIterator()
+    {
+    }
+    
+    bool ConjunctionTwoPhaseIterator::matches()
+    {
+        for (Collection<TwoPhaseIteratorPtr>::iterator twoPhase = twoPhaseIterators.begin(); twoPhase != twoPhaseIterators.end(); ++twoPhase)
+        {
+            if (!(*twoPhase)->matches())
+                return false;
+        }
+        return true;
+    }
+    
+    TermDocsDocIdSetIterator::TermDocsDocIdSetIterator(TermDocsPtr termDocs)
+    {
+        this->termDocs = termDocs;
+        this->doc = -1;
+    }
+    
+    TermDocsDocIdSetIterator::~TermDocsDocIdSetIterator()
+    {
+    }
+    
+    int32_t TermDocsDocIdSetIterator::docID()
+    {
+        return doc;
+    }
+    
+    int32_t TermDocsDocIdSetIterator::nextDoc()
+    {
+        doc = termDocs->next() ? termDocs->doc() : NO_MORE_DOCS;
+        return doc;
+    }
+    
+    int32_t TermDocsDocIdSetIterator::advance(int32_t target)
+    {
+        doc = termDocs->skipTo(target) ? termDocs->doc() : NO_MORE_DOCS;
+        return doc;
+    }
+}
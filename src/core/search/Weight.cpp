@@ -13,6 +13,11 @@ namespace Lucene
     {
     }
     
+    ScorerPtr Weight::topScoresScorer(IndexReaderPtr reader, bool scoreDocsInOrder)
+    {
+        return scorer(reader, scoreDocsInOrder, true);
+    }
+    
     bool Weight::scoresDocsOutOfOrder()
     {
         return false;
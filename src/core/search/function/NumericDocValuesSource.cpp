@@ -0,0 +1,91 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "NumericDocValuesSource.h"
+#include "_NumericDocValuesSource.h"
+#include "NumericDocValues.h"
+#include "IndexReader.h"
+#include "MiscUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    NumericDocValuesSource::NumericDocValuesSource(const String& field)
+    {
+        this->field = field;
+    }
+    
+    NumericDocValuesSource::~NumericDocValuesSource()
+    {
+    }
+    
+    String NumericDocValuesSource::description()
+    {
+        return L"docvalues(" + field + L")";
+    }
+    
+    DocValuesPtr NumericDocValuesSource::getValues(IndexReaderPtr reader)
+    {
+        return newLucene<NumericDocValuesSourceValues>(shared_from_this(), reader->getNumericDocValues(field), reader->maxDoc());
+    }
+    
+    bool NumericDocValuesSource::equals(LuceneObjectPtr other)
+    {
+        if (!MiscUtils::equalTypes(shared_from_this(), other))
+            return false;
+        NumericDocValuesSourcePtr otherSource(boost::dynamic_pointer_cast<NumericDocValuesSource>(other));
+        if (!otherSource)
+            return false;
+        return field == otherSource->field;
+    }
+    
+    int32_t NumericDocValuesSource::hashCode()
+    {
+        return StringUtils::hashCode(NumericDocValuesSource::_getClassName()) + StringUtils::hashCode(field);
+    }
+    
+    NumericDocValuesSourceValues::NumericDocValuesSourceValues(NumericDocValuesSourcePtr source, NumericDocValuesPtr values, int32_t maxDoc)
+    {
+        this->_source = source;
+        this->values = values;
+        this->maxDoc = maxDoc;
+    }
+    
+    NumericDocValuesSourceValues::~NumericDocValuesSourceValues()
+    {
+    }
+    
+    void NumericDocValuesSourceValues::checkDoc(int32_t doc)
+    {
+        if (doc < 0 || doc >= maxDoc)
+            boost::throw_exception(IndexOutOfBoundsException());
+    }
+    
+    double NumericDocValuesSourceValues::doubleVal(int32_t doc)
+    {
+        checkDoc(doc);
+        return values ? values->getDouble(doc) : 0.0;
+    }
+    
+    int32_t NumericDocValuesSourceValues::intVal(int32_t doc)
+    {
+        checkDoc(doc);
+        return values ? (int32_t)values->getLong(doc) : 0;
+    }
+    
+    int64_t NumericDocValuesSourceValues::longVal(int32_t doc)
+    {
+        checkDoc(doc);
+        return values ? values->getLong(doc) : 0;
+    }
+    
+    String NumericDocValuesSourceValues::toString(int32_t doc)
+    {
+        String value(values && values->isDouble() ? StringUtils::toString(doubleVal(doc)) : StringUtils::toString(longVal(doc)));
+        return NumericDocValuesSourcePtr(_source)->description() + L"=" + value;
+    }
+}
@@ -39,6 +39,11 @@ namespace Lucene
         return maskedQuery->getSpans(reader);
     }
     
+    DocIdSetIteratorPtr FieldMaskingSpanQuery::getApproximation(IndexReaderPtr reader)
+    {
+        return maskedQuery->getApproximation(reader);
+    }
+    
     void FieldMaskingSpanQuery::extractTerms(SetTerm terms)
     {
         maskedQuery->extractTerms(terms);
@@ -64,6 +64,11 @@ namespace Lucene
         return newLucene<FirstSpans>(shared_from_this(), match->getSpans(reader));
     }
     
+    DocIdSetIteratorPtr SpanFirstQuery::getApproximation(IndexReaderPtr reader)
+    {
+        return match->getApproximation(reader);
+    }
+    
     QueryPtr SpanFirstQuery::rewrite(IndexReaderPtr reader)
     {
         SpanFirstQueryPtr clone;
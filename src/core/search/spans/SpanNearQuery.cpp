@@ -10,6 +10,7 @@
 #include "SpanOrQuery.h"
 #include "NearSpansOrdered.h"
 #include "NearSpansUnordered.h"
+#include "_TwoPhaseIterator.h"
 #include "MiscUtils.h"
 
 namespace Lucene
@@ -88,6 +89,23 @@ namespace Lucene
                 : boost::static_pointer_cast<Spans>(newLucene<NearSpansUnordered>(shared_from_this(), reader));
     }
     
+    DocIdSetIteratorPtr SpanNearQuery::getApproximation(IndexReaderPtr reader)
+    {
+        // all clauses match the docs with spans, so those of any of their approximations will do
+        Collection<DocIdSetIteratorPtr> approximations(Collection<DocIdSetIteratorPtr>::newInstance());
+        for (Collection<SpanQueryPtr>::iterator clause = clauses.begin(); clause != clauses.end(); ++clause)
+        {
+            DocIdSetIteratorPtr approximation((*clause)->getApproximation(reader));
+            if (approximation)
+                approximations.add(approximation);
+        }
+        if (approximations.empty())
+            return DocIdSetIteratorPtr();
+        if (approximations.size() == 1)
+            return approximations[0];
+        return newLucene<ConjunctionDocIdSetIterator>(approximations);
+    }
+    
     QueryPtr SpanNearQuery::rewrite(IndexReaderPtr reader)
     {
         SpanNearQueryPtr clone;
@@ -65,6 +65,11 @@ namespace Lucene
         return newLucene<NotSpans>(shared_from_this(), include->getSpans(reader), exclude->getSpans(reader));
     }
     
+    DocIdSetIteratorPtr SpanNotQuery::getApproximation(IndexReaderPtr reader)
+    {
+        return include->getApproximation(reader);
+    }
+    
     QueryPtr SpanNotQuery::rewrite(IndexReaderPtr reader)
     {
         SpanNotQueryPtr clone;
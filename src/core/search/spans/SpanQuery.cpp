@@ -14,6 +14,11 @@ namespace Lucene
     {
     }
     
+    DocIdSetIteratorPtr SpanQuery::getApproximation(IndexReaderPtr reader)
+    {
+        return DocIdSetIteratorPtr();
+    }
+    
     WeightPtr SpanQuery::createWeight(SearcherPtr searcher)
     {
         return newLucene<SpanWeight>(shared_from_this(), searcher);
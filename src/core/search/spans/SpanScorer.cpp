@@ -6,22 +6,46 @@
 
 #include "LuceneInc.h"
 #include "SpanScorer.h"
+#include "_SpanScorer.h"
 #include "Explanation.h"
 #include "Weight.h"
 #include "Similarity.h"
 #include "Spans.h"
+#include "NormValues.h"
 #include "StringUtils.h"
 
 namespace Lucene
 {
+    SpanScorer::SpanScorer(SpansPtr spans, WeightPtr weight, SimilarityPtr similarity, NormValuesPtr norms, DocIdSetIteratorPtr approximation) : Scorer(similarity)
+    {
+        ConstructScorer(spans, weight, norms, approximation);
+    }
+    
     SpanScorer::SpanScorer(SpansPtr spans, WeightPtr weight, SimilarityPtr similarity, ByteArray norms) : Scorer(similarity)
+    {
+        ConstructScorer(spans, weight, NormValues::fromBytes(norms), DocIdSetIteratorPtr());
+    }
+    
+    SpanScorer::~SpanScorer()
+    {
+    }
+    
+    void SpanScorer::ConstructScorer(SpansPtr spans, WeightPtr weight, NormValuesPtr norms, DocIdSetIteratorPtr approximation)
     {
         this->spans = spans;
         this->norms = norms;
         this->weight = weight;
         this->value = weight->getValue();
         this->freq = 0.0;
-        if (this->spans->next())
+        this->approximation = approximation;
+        this->firstTime = true;
+        if (approximation)
+        {
+            // the spans are only positioned when a doc of the approximation is confirmed
+            doc = -1;
+            more = true;
+        }
+        else if (this->spans->next())
         {
             doc = -1;
             more = true;
@@ -33,12 +57,10 @@ namespace Lucene
         }
     }
     
-    SpanScorer::~SpanScorer()
-    {
-    }
-    
     int32_t SpanScorer::nextDoc()
     {
+        if (approximation)
+            return toMatch(approximation->nextDoc());
         if (!setFreqCurrentDoc())
             doc = NO_MORE_DOCS;
         return doc;
@@ -46,6 +68,8 @@ namespace Lucene
     
     int32_t SpanScorer::advance(int32_t target)
     {
+        if (approximation)
+            return toMatch(approximation->advance(target));
         if (!more)
         {
             doc = NO_MORE_DOCS;
@@ -74,15 +98,40 @@ namespace Lucene
         return true;
     }
     
-    int32_t SpanScorer::docID()
+    bool SpanScorer::matches()
+    {
+        int32_t target = approximation->docID();
+        if (more && (firstTime || spans->doc() < target)) // setFreqCurrentDoc() leaves spans->doc() ahead
+            more = spans->skipTo(target);
+        firstTime = false;
+        if (!more || spans->doc() != target)
+            return false;
+        return setFreqCurrentDoc();
+    }
+    
+    int32_t SpanScorer::toMatch(int32_t doc)
     {
+        while (doc != NO_MORE_DOCS && !matches())
+            doc = approximation->nextDoc();
         return doc;
     }
     
+    int32_t SpanScorer::docID()
+    {
+        return approximation ? approximation->docID() : doc;
+    }
+    
+    TwoPhaseIteratorPtr SpanScorer::twoPhaseIterator()
+    {
+        if (!approximation)
+            return TwoPhaseIteratorPtr();
+        return newLucene<SpanScorerTwoPhaseIterator>(shared_from_this());
+    }
+    
     double SpanScorer::score()
     {
         double raw = getSimilarity()->tf(freq) * value; // raw score
-        return norms ? raw * Similarity::decodeNorm(norms[doc]) : raw; // normalize
+        return norms ? raw * Similarity::decodeNorm(norms->get(doc)) : raw; // normalize
     }
     
     ExplanationPtr SpanScorer::explain(int32_t doc)
@@ -97,4 +146,18 @@ namespace Lucene
         
         return tfExplanation;
     }
+    
+    SpanScorerTwoPhaseIterator::SpanScorerTwoPhaseIterator(SpanScorerPtr scorer) : TwoPhaseIterator(scorer->approximation)
+    {
+        this->scorer = scorer;
+    }
+    
+    SpanScorerTwoPhaseIterator::~SpanScorerTwoPhaseIterator()
+    {
+    }
+    
+    bool SpanScorerTwoPhaseIterator::matches()
+    {
+        return scorer->matches();
+    }
 }
@@ -8,6 +8,7 @@
 #include "SpanTermQuery.h"
 #include "Term.h"
 #include "TermSpans.h"
+#include "_TwoPhaseIterator.h"
 #include "IndexReader.h"
 #include "MiscUtils.h"
 
@@ -89,4 +90,9 @@ namespace Lucene
     {
         return newLucene<TermSpans>(reader->termPositions(term), term);
     }
+    
+    DocIdSetIteratorPtr SpanTermQuery::getApproximation(IndexReaderPtr reader)
+    {
+        return newLucene<TermDocsDocIdSetIterator>(reader->termDocs(term));
+    }
 }
@@ -11,6 +11,7 @@
 #include "IndexReader.h"
 #include "ComplexExplanation.h"
 #include "Similarity.h"
+#include "NormValues.h"
 #include "StringUtils.h"
 
 namespace Lucene
@@ -59,7 +60,7 @@ namespace Lucene
     
     ScorerPtr SpanWeight::scorer(IndexReaderPtr reader, bool scoreDocsInOrder, bool topScorer)
     {
-        return newLucene<SpanScorer>(query->getSpans(reader), shared_from_this(), similarity, reader->norms(query->getField()));
+        return newLucene<SpanScorer>(query->getSpans(reader), shared_from_this(), similarity, reader->normValues(query->getField()), query->getApproximation(reader));
     }
     
     ExplanationPtr SpanWeight::explain(IndexReaderPtr reader, int32_t doc)
@@ -94,8 +95,8 @@ namespace Lucene
         fieldExpl->addDetail(idfExpl);
         
         ExplanationPtr fieldNormExpl(newLucene<Explanation>());
-        ByteArray fieldNorms(reader->norms(field));
-        double fieldNorm = fieldNorms ? Similarity::decodeNorm(fieldNorms[doc]) : 1.0;
+        NormValuesPtr fieldNorms(reader->normValues(field));
+        double fieldNorm = fieldNorms ? Similarity::decodeNorm(fieldNorms->get(doc)) : 1.0;
         fieldNormExpl->setValue(fieldNorm);
         fieldNormExpl->setDescription(L"fieldNorm(field=" + field + L", doc=" + StringUtils::toString(doc) + L")");
         fieldExpl->addDetail(fieldNormExpl);
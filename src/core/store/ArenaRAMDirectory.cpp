@@ -0,0 +1,410 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "ArenaRAMDirectory.h"
+#include "_ArenaRAMDirectory.h"
+#include "RAMArena.h"
+#include "SingleInstanceLockFactory.h"
+#include "LuceneThread.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    ArenaRAMDirectory::ArenaRAMDirectory()
+    {
+        this->arena = newLucene<RAMArena>();
+        this->fileMap = MapStringArenaFile::newInstance();
+        setLockFactory(newLucene<SingleInstanceLockFactory>());
+    }
+    
+    ArenaRAMDirectory::ArenaRAMDirectory(RAMArenaPtr arena)
+    {
+        this->arena = arena;
+        this->fileMap = MapStringArenaFile::newInstance();
+        setLockFactory(newLucene<SingleInstanceLockFactory>());
+    }
+    
+    ArenaRAMDirectory::~ArenaRAMDirectory()
+    {
+    }
+    
+    RAMArenaPtr ArenaRAMDirectory::getArena()
+    {
+        return arena;
+    }
+    
+    ArenaRAMDirectoryPtr ArenaRAMDirectory::snapshot()
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        ArenaRAMDirectoryPtr snapshot(newLucene<ArenaRAMDirectory>(arena));
+        for (MapStringArenaFile::iterator file = fileMap.begin(); file != fileMap.end(); ++file)
+        {
+            if (file->second->sealed)
+                snapshot->fileMap.put(file->first, file->second);
+        }
+        return snapshot;
+    }
+    
+    ArenaFilePtr ArenaRAMDirectory::getFile(const String& name)
+    {
+        MapStringArenaFile::iterator file = fileMap.find(name);
+        if (file == fileMap.end())
+            boost::throw_exception(FileNotFoundException(name));
+        return file->second;
+    }
+    
+    HashSet<String> ArenaRAMDirectory::listAll()
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        HashSet<String> result(HashSet<String>::newInstance());
+        for (MapStringArenaFile::iterator file = fileMap.begin(); file != fileMap.end(); ++file)
+            result.add(file->first);
+        return result;
+    }
+    
+    bool ArenaRAMDirectory::fileExists(const String& name)
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        return fileMap.contains(name);
+    }
+    
+    uint64_t ArenaRAMDirectory::fileModified(const String& name)
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        return getFile(name)->lastModified;
+    }
+    
+    void ArenaRAMDirectory::touchFile(const String& name)
+    {
+        int64_t lastModified;
+        {
+            SyncLock syncLock(this);
+            ensureOpen();
+            lastModified = getFile(name)->lastModified;
+        }
+        int64_t ts1 = MiscUtils::currentTimeMillis();
+        while (ts1 == MiscUtils::currentTimeMillis())
+            LuceneThread::threadSleep(1);
+        SyncLock syncLock(this);
+        ArenaFilePtr file(getFile(name));
+        // closed files may be shared with snapshots, so are replaced rather than modified
+        if (file->sealed)
+            fileMap.put(name, file->touch(MiscUtils::currentTimeMillis()));
+        else
+            file->lastModified = MiscUtils::currentTimeMillis();
+    }
+    
+    int64_t ArenaRAMDirectory::fileLength(const String& name)
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        return getFile(name)->length;
+    }
+    
+    int64_t ArenaRAMDirectory::sizeInBytes()
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        int64_t size = 0;
+        for (MapStringArenaFile::iterator file = fileMap.begin(); file != fileMap.end(); ++file)
+        {
+            if (file->second->sealed)
+                size += file->second->length;
+        }
+        return size;
+    }
+    
+    void ArenaRAMDirectory::deleteFile(const String& name)
+    {
+        SyncLock syncLock(this);
+        ensureOpen();
+        getFile(name);
+        fileMap.remove(name);
+    }
+    
+    IndexOutputPtr ArenaRAMDirectory::createOutput(const String& name)
+    {
+        ArenaFilePtr file(newLucene<ArenaFile>(MiscUtils::currentTimeMillis()));
+        {
+            SyncLock syncLock(this);
+            ensureOpen();
+            fileMap.put(name, file);
+        }
+        return newLucene<ArenaIndexOutput>(shared_from_this(), arena, file);
+    }
+    
+    IndexInputPtr ArenaRAMDirectory::openInput(const String& name)
+    {
+        ArenaFilePtr file;
+        {
+            SyncLock syncLock(this);
+            ensureOpen();
+            file = getFile(name);
+            if (!file->sealed)
+                boost::throw_exception(IOException(L"File is still open for writing: " + name));
+        }
+        return newLucene<ArenaIndexInput>(file, arena->getSlabSizePower());
+    }
+    
+    void ArenaRAMDirectory::close()
+    {
+        SyncLock syncLock(this);
+        isOpen = false;
+        fileMap.reset();
+    }
+    
+    ArenaFile::ArenaFile(int64_t lastModified)
+    {
+        this->length = 0;
+        this->lastModified = lastModified;
+        this->sealed = false;
+    }
+    
+    ArenaFile::~ArenaFile()
+    {
+    }
+    
+    ArenaFilePtr ArenaFile::touch(int64_t lastModified)
+    {
+        ArenaFilePtr file(newLucene<ArenaFile>(lastModified));
+        file->blocks = blocks;
+        file->blockOffsets = blockOffsets;
+        file->length = length;
+        file->sealed = sealed;
+        return file;
+    }
+    
+    ArenaIndexInput::ArenaIndexInput(ArenaFilePtr file, int32_t blockSizePower)
+    {
+        this->file = file;
+        this->_length = file ? file->length : 0;
+        this->blockSizePower = blockSizePower;
+        this->curBlockIndex = -1;
+        this->curBlockOffset = 0;
+        this->curBlockLength = 0;
+        this->curBlockPosition = 0;
+    }
+    
+    ArenaIndexInput::~ArenaIndexInput()
+    {
+    }
+    
+    void ArenaIndexInput::setBlock(int32_t blockIndex)
+    {
+        curBlockIndex = blockIndex;
+        if (blockIndex < file->blocks.size())
+        {
+            curBlock = file->blocks[blockIndex];
+            curBlockOffset = file->blockOffsets[blockIndex];
+            curBlockLength = (int32_t)std::min(_length - ((int64_t)blockIndex << blockSizePower), (int64_t)1 << blockSizePower);
+        }
+        else
+        {
+            curBlock.reset();
+            curBlockOffset = 0;
+            curBlockLength = 0;
+        }
+    }
+    
+    void ArenaIndexInput::nextBlock()
+    {
+        if (curBlockIndex + 1 >= file->blocks.size())
+            boost::throw_exception(IOException(L"Read past EOF"));
+        setBlock(curBlockIndex + 1);
+        curBlockPosition = 0;
+    }
+    
+    uint8_t ArenaIndexInput::readByte()
+    {
+        if (curBlockPosition >= curBlockLength)
+            nextBlock();
+        return curBlock[curBlockOffset + curBlockPosition++];
+    }
+    
+    void ArenaIndexInput::readBytes(uint8_t* b, int32_t offset, int32_t length)
+    {
+        while (length > 0)
+        {
+            if (curBlockPosition >= curBlockLength)
+                nextBlock();
+            int32_t count = std::min(length, curBlockLength - curBlockPosition);
+            MiscUtils::arrayCopy(curBlock.get(), curBlockOffset + curBlockPosition, b, offset, count);
+            curBlockPosition += count;
+            offset += count;
+            length -= count;
+        }
+    }
+    
+    int64_t ArenaIndexInput::getFilePointer()
+    {
+        return curBlockIndex < 0 ? 0 : ((int64_t)curBlockIndex << blockSizePower) + curBlockPosition;
+    }
+    
+    void ArenaIndexInput::seek(int64_t pos)
+    {
+        int32_t blockIndex = (int32_t)(pos >> blockSizePower);
+        if (blockIndex != curBlockIndex)
+            setBlock(blockIndex);
+        curBlockPosition = (int32_t)(pos & (((int64_t)1 << blockSizePower) - 1));
+    }
+    
+    int64_t ArenaIndexInput::length()
+    {
+        return _length;
+    }
+    
+    void ArenaIndexInput::close()
+    {
+        // nothing to do here
+    }
+    
+    LuceneObjectPtr ArenaIndexInput::clone(LuceneObjectPtr other)
+    {
+        LuceneObjectPtr clone = IndexInput::clone(other ? other : newLucene<ArenaIndexInput>(file, blockSizePower));
+        ArenaIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<ArenaIndexInput>(clone));
+        cloneIndexInput->file = file;
+        cloneIndexInput->_length = _length;
+        cloneIndexInput->blockSizePower = blockSizePower;
+        cloneIndexInput->curBlockIndex = curBlockIndex;
+        cloneIndexInput->curBlock = curBlock;
+        cloneIndexInput->curBlockOffset = curBlockOffset;
+        cloneIndexInput->curBlockLength = curBlockLength;
+        cloneIndexInput->curBlockPosition = curBlockPosition;
+        return cloneIndexInput;
+    }
+    
+    ArenaIndexOutput::ArenaIndexOutput(ArenaRAMDirectoryPtr directory, RAMArenaPtr arena, ArenaFilePtr file)
+    {
+        this->_directory = directory;
+        this->arena = arena;
+        this->file = file;
+        this->slabs = Collection<ByteArray>::newInstance();
+        this->slabSize = arena->getSlabSize();
+        this->slabSizePower = arena->getSlabSizePower();
+        this->curSlabIndex = -1;
+        this->curSlabPosition = 0;
+        this->_length = 0;
+        this->isOpen = true;
+    }
+    
+    ArenaIndexOutput::~ArenaIndexOutput()
+    {
+    }
+    
+    void ArenaIndexOutput::nextSlab()
+    {
+        ++curSlabIndex;
+        if (curSlabIndex == slabs.size())
+            slabs.add(arena->newSlab());
+        curSlab = slabs[curSlabIndex];
+        curSlabPosition = 0;
+    }
+    
+    void ArenaIndexOutput::writeByte(uint8_t b)
+    {
+        if (curSlabIndex < 0 || curSlabPosition == slabSize)
+            nextSlab();
+        curSlab[curSlabPosition++] = b;
+    }
+    
+    void ArenaIndexOutput::writeBytes(const uint8_t* b, int32_t offset, int32_t length)
+    {
+        while (length > 0)
+        {
+            if (curSlabIndex < 0 || curSlabPosition == slabSize)
+                nextSlab();
+            int32_t count = std::min(length, slabSize - curSlabPosition);
+            MiscUtils::arrayCopy(b, offset, curSlab.get(), curSlabPosition, count);
+            curSlabPosition += count;
+            offset += count;
+            length -= count;
+        }
+    }
+    
+    void ArenaIndexOutput::setFileLength()
+    {
+        int64_t pointer = getFilePointer();
+        if (pointer > _length)
+            _length = pointer;
+    }
+    
+    void ArenaIndexOutput::flush()
+    {
+        setFileLength();
+        ArenaRAMDirectoryPtr directory(_directory.lock());
+        SyncLock syncLock(directory ? LuceneObjectPtr(directory) : LuceneObjectPtr(file));
+        file->length = _length;
+    }
+    
+    void ArenaIndexOutput::close()
+    {
+        if (!isOpen)
+            return;
+        isOpen = false;
+        setFileLength();
+        
+        int32_t numSlabs = (int32_t)((_length + slabSize - 1) >> slabSizePower);
+        Collection<ByteArray> blocks(Collection<ByteArray>::newInstance(numSlabs));
+        Collection<int32_t> blockOffsets(Collection<int32_t>::newInstance(numSlabs));
+        for (int32_t i = 0; i < numSlabs; ++i)
+        {
+            blocks[i] = slabs[i];
+            blockOffsets[i] = 0;
+        }
+        int32_t tailLength = (int32_t)(_length & (slabSize - 1));
+        if (tailLength > 0 && tailLength <= slabSize / 2)
+        {
+            // pack a short tail alongside other files' tails, and re-use the slab it was written to
+            int32_t offset = 0;
+            blocks[numSlabs - 1] = arena->packTail(slabs[numSlabs - 1].get(), tailLength, offset);
+            blockOffsets[numSlabs - 1] = offset;
+            arena->releaseSlab(slabs[numSlabs - 1]);
+        }
+        slabs.clear();
+        curSlab.reset();
+        
+        // publish under the directory's lock, which readers take to open the file
+        ArenaRAMDirectoryPtr directory(_directory.lock());
+        SyncLock syncLock(directory ? LuceneObjectPtr(directory) : LuceneObjectPtr(file));
+        file->blocks = blocks;
+        file->blockOffsets = blockOffsets;
+        file->length = _length;
+        file->sealed = true;
+    }
+    
+    int64_t ArenaIndexOutput::getFilePointer()
+    {
+        return curSlabIndex < 0 ? 0 : ((int64_t)curSlabIndex << slabSizePower) + curSlabPosition;
+    }
+    
+    void ArenaIndexOutput::seek(int64_t pos)
+    {
+        // set the file length in case we seek back and flush() has not been called yet
+        setFileLength();
+        if (pos > _length)
+            boost::throw_exception(IllegalArgumentException(L"Cannot seek past the end of the file"));
+        curSlabIndex = (int32_t)(pos >> slabSizePower);
+        curSlabPosition = (int32_t)(pos & (slabSize - 1));
+        if (curSlabIndex == slabs.size())
+        {
+            // at the end of the last full slab (or of an empty file)
+            --curSlabIndex;
+            curSlabPosition = slabSize;
+        }
+        curSlab = curSlabIndex < 0 ? ByteArray() : slabs[curSlabIndex];
+    }
+    
+    int64_t ArenaIndexOutput::length()
+    {
+        setFileLength();
+        return _length;
+    }
+}
@@ -0,0 +1,276 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "BlockCache.h"
+#include "_BlockCache.h"
+#include "BitUtil.h"
+
+namespace Lucene
+{
+    const int32_t BlockCache::DEFAULT_PAGE_SIZE = 8192;
+    const int32_t BlockCache::DEFAULT_NUM_SHARDS = 16;
+    
+    BlockCache::BlockCache(int64_t maxSizeInBytes, int32_t pageSize, int32_t numShards)
+    {
+        if (maxSizeInBytes <= 0)
+            boost::throw_exception(IllegalArgumentException(L"maxSizeInBytes must be > 0"));
+        if (pageSize <= 0)
+            boost::throw_exception(IllegalArgumentException(L"pageSize must be > 0"));
+        if (numShards <= 0)
+            boost::throw_exception(IllegalArgumentException(L"numShards must be > 0"));
+        this->pageSize = BitUtil::nextHighestPowerOfTwo(pageSize);
+        this->pageSizePower = 0;
+        while ((1 << pageSizePower) < this->pageSize)
+            ++pageSizePower;
+        int64_t maxPages = std::max(maxSizeInBytes >> pageSizePower, (int64_t)1);
+        numShards = (int32_t)std::min((int64_t)numShards, maxPages);
+        int32_t shardPages = (int32_t)std::min(maxPages / numShards, (int64_t)INT_MAX);
+        shards = Collection<BlockCacheShardPtr>::newInstance(numShards);
+        for (int32_t i = 0; i < numShards; ++i)
+            shards[i] = newLucene<BlockCacheShard>(shardPages);
+        nextFileId = 0;
+    }
+    
+    BlockCache::~BlockCache()
+    {
+    }
+    
+    int32_t BlockCache::getPageSize()
+    {
+        return pageSize;
+    }
+    
+    int32_t BlockCache::getPageSizePower()
+    {
+        return pageSizePower;
+    }
+    
+    int64_t BlockCache::getMaxPages()
+    {
+        int64_t maxPages = 0;
+        for (Collection<BlockCacheShardPtr>::iterator shard = shards.begin(); shard != shards.end(); ++shard)
+            maxPages += (*shard)->getMaxPages();
+        return maxPages;
+    }
+    
+    int64_t BlockCache::newFileId()
+    {
+        SyncLock syncLock(this);
+        return nextFileId++;
+    }
+    
+    int64_t BlockCache::makeKey(int64_t fileId, int64_t page)
+    {
+        return (fileId << 32) | (page & 0xffffffffLL);
+    }
+    
+    BlockCacheShardPtr BlockCache::getShard(int64_t key)
+    {
+        uint64_t hash = (uint64_t)key * 0x9e3779b97f4a7c15ULL; // spread consecutive pages over shards
+        return shards[(int32_t)((hash >> 32) % (uint64_t)shards.size())];
+    }
+    
+    ByteArray BlockCache::get(int64_t fileId, int64_t page)
+    {
+        if ((page >> 32) != 0)
+            return ByteArray(); // beyond the addressable range of a page key
+        int64_t key = makeKey(fileId, page);
+        return getShard(key)->get(key);
+    }
+    
+    void BlockCache::put(int64_t fileId, int64_t page, ByteArray bytes)
+    {
+        if ((page >> 32) != 0)
+            return;
+        int64_t key = makeKey(fileId, page);
+        getShard(key)->put(key, bytes);
+    }
+    
+    void BlockCache::remove(int64_t fileId, int64_t numPages)
+    {
+        for (int64_t page = 0; page < std::min(numPages, (int64_t)1 << 32); ++page)
+        {
+            int64_t key = makeKey(fileId, page);
+            getShard(key)->remove(key);
+        }
+    }
+    
+    void BlockCache::clear()
+    {
+        for (Collection<BlockCacheShardPtr>::iterator shard = shards.begin(); shard != shards.end(); ++shard)
+            (*shard)->clear();
+    }
+    
+    int64_t BlockCache::getPageCount()
+    {
+        int64_t pageCount = 0;
+        for (Collection<BlockCacheShardPtr>::iterator shard = shards.begin(); shard != shards.end(); ++shard)
+            pageCount += (*shard)->size();
+        return pageCount;
+    }
+    
+    int64_t BlockCache::getHitCount()
+    {
+        int64_t hitCount = 0;
+        for (Collection<BlockCacheShardPtr>::iterator shard = shards.begin(); shard != shards.end(); ++shard)
+            hitCount += (*shard)->getHitCount();
+        return hitCount;
+    }
+    
+    int64_t BlockCache::getMissCount()
+    {
+        int64_t missCount = 0;
+        for (Collection<BlockCacheShardPtr>::iterator shard = shards.begin(); shard != shards.end(); ++shard)
+            missCount += (*shard)->getMissCount();
+        return missCount;
+    }
+    
+    int64_t BlockCache::getEvictionCount()
+    {
+        int64_t evictionCount = 0;
+        for (Collection<BlockCacheShardPtr>::iterator shard = shards.begin(); shard != shards.end(); ++shard)
+            evictionCount += (*shard)->getEvictionCount();
+        return evictionCount;
+    }
+    
+    BlockCacheShard::BlockCacheShard(int32_t maxPages)
+    {
+        this->maxPages = std::max(maxPages, 1);
+        slotIndex = MapLongInt::newInstance();
+        slotKeys = Collection<int64_t>::newInstance();
+        slotPages = Collection<ByteArray>::newInstance();
+        slotReferenced = Collection<uint8_t>::newInstance();
+        clockHand = 0;
+        hitCount = 0;
+        missCount = 0;
+        evictionCount = 0;
+    }
+    
+    BlockCacheShard::~BlockCacheShard()
+    {
+    }
+    
+    ByteArray BlockCacheShard::get(int64_t key)
+    {
+        SyncLock syncLock(this);
+        MapLongInt::iterator slot = slotIndex.find(key);
+        if (slot == slotIndex.end())
+        {
+            ++missCount;
+            return ByteArray();
+        }
+        ++hitCount;
+        slotReferenced[slot->second] = 1;
+        return slotPages[slot->second];
+    }
+    
+    void BlockCacheShard::put(int64_t key, ByteArray bytes)
+    {
+        SyncLock syncLock(this);
+        MapLongInt::iterator existing = slotIndex.find(key);
+        if (existing != slotIndex.end())
+        {
+            slotPages[existing->second] = bytes;
+            slotReferenced[existing->second] = 1;
+            return;
+        }
+        int32_t slot;
+        if (slotKeys.size() < maxPages)
+        {
+            slot = slotKeys.size();
+            slotKeys.add(key);
+            slotPages.add(bytes);
+            slotReferenced.add(1);
+        }
+        else
+        {
+            slot = findVictim();
+            slotIndex.remove(slotKeys[slot]);
+            ++evictionCount;
+            slotKeys[slot] = key;
+            slotPages[slot] = bytes;
+            slotReferenced[slot] = 1;
+        }
+        slotIndex.put(key, slot);
+    }
+    
+    void BlockCacheShard::remove(int64_t key)
+    {
+        SyncLock syncLock(this);
+        MapLongInt::iterator existing = slotIndex.find(key);
+        if (existing == slotIndex.end())
+            return;
+        
+        // keep the slots dense by moving the last one into the freed slot
+        int32_t slot = existing->second;
+        int32_t last = slotKeys.size() - 1;
+        slotIndex.remove(key);
+        if (slot != last)
+        {
+            slotKeys[slot] = slotKeys[last];
+            slotPages[slot] = slotPages[last];
+            slotReferenced[slot] = slotReferenced[last];
+            slotIndex.put(slotKeys[slot], slot);
+        }
+        slotKeys.removeLast();
+        slotPages.removeLast();
+        slotReferenced.removeLast();
+        if (clockHand >= last)
+            clockHand = 0;
+    }
+    
+    int32_t BlockCacheShard::findVictim()
+    {
+        while (slotReferenced[clockHand] != 0)
+        {
+            slotReferenced[clockHand] = 0; // second chance
+            clockHand = (clockHand + 1) % slotKeys.size();
+        }
+        int32_t victim = clockHand;
+        clockHand = (clockHand + 1) % slotKeys.size();
+        return victim;
+    }
+    
+    void BlockCacheShard::clear()
+    {
+        SyncLock syncLock(this);
+        slotIndex.clear();
+        slotKeys.clear();
+        slotPages.clear();
+        slotReferenced.clear();
+        clockHand = 0;
+    }
+    
+    int32_t BlockCacheShard::size()
+    {
+        SyncLock syncLock(this);
+        return slotKeys.size();
+    }
+    
+    int32_t BlockCacheShard::getMaxPages()
+    {
+        return maxPages;
+    }
+    
+    int64_t BlockCacheShard::getHitCount()
+    {
+        SyncLock syncLock(this);
+        return hitCount;
+    }
+    
+    int64_t BlockCacheShard::getMissCount()
+    {
+        SyncLock syncLock(this);
+        return missCount;
+    }
+    
+    int64_t BlockCacheShard::getEvictionCount()
+    {
+        SyncLock syncLock(this);
+        return evictionCount;
+    }
+}
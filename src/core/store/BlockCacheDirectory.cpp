@@ -0,0 +1,378 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "BlockCacheDirectory.h"
+#include "_BlockCacheDirectory.h"
+#include "BlockCache.h"
+#include "FileSwitchDirectory.h"
+#include "IndexOutput.h"
+#include "BufferedIndexInput.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    BlockCacheDirectory::BlockCacheDirectory(DirectoryPtr dir, BlockCachePtr cache)
+    {
+        this->dir = dir;
+        this->cache = cache;
+        this->cachePolicies = MapStringInt::newInstance();
+        this->defaultCachePolicy = CACHE_DEFAULT;
+        this->fileIds = MapStringLong::newInstance();
+        this->lockFactory = dir->getLockFactory();
+    }
+    
+    BlockCacheDirectory::~BlockCacheDirectory()
+    {
+    }
+    
+    DirectoryPtr BlockCacheDirectory::getDirectory()
+    {
+        return dir;
+    }
+    
+    BlockCachePtr BlockCacheDirectory::getCache()
+    {
+        return cache;
+    }
+    
+    void BlockCacheDirectory::setCachePolicy(const String& extension, CachePolicy policy)
+    {
+        SyncLock syncLock(this);
+        cachePolicies.put(extension, (int32_t)policy);
+    }
+    
+    BlockCacheDirectory::CachePolicy BlockCacheDirectory::getCachePolicy(const String& extension)
+    {
+        SyncLock syncLock(this);
+        MapStringInt::iterator policy = cachePolicies.find(extension);
+        return policy == cachePolicies.end() ? defaultCachePolicy : (CachePolicy)policy->second;
+    }
+    
+    void BlockCacheDirectory::setDefaultCachePolicy(CachePolicy policy)
+    {
+        SyncLock syncLock(this);
+        defaultCachePolicy = policy;
+    }
+    
+    BlockCacheDirectory::CachePolicy BlockCacheDirectory::getDefaultCachePolicy()
+    {
+        SyncLock syncLock(this);
+        return defaultCachePolicy;
+    }
+    
+    int64_t BlockCacheDirectory::getFileId(const String& name)
+    {
+        SyncLock syncLock(this);
+        MapStringLong::iterator fileId = fileIds.find(name);
+        if (fileId != fileIds.end())
+            return fileId->second;
+        int64_t newFileId = cache->newFileId();
+        fileIds.put(name, newFileId);
+        return newFileId;
+    }
+    
+    void BlockCacheDirectory::invalidate(const String& name)
+    {
+        int64_t fileId;
+        {
+            SyncLock syncLock(this);
+            MapStringLong::iterator existing = fileIds.find(name);
+            if (existing == fileIds.end())
+                return; // never read, so nothing is cached
+            fileId = existing->second;
+            fileIds.remove(name);
+        }
+        
+        // the old version's pages would never be read again, but would stay until evicted
+        int64_t length = 0;
+        try
+        {
+            length = dir->fileLength(name);
+        }
+        catch (IOException&)
+        {
+            return; // deleted behind our back, so its pages are left to be evicted
+        }
+        int64_t pageSize = cache->getPageSize();
+        cache->remove(fileId, (length + pageSize - 1) / pageSize);
+    }
+    
+    HashSet<String> BlockCacheDirectory::listAll()
+    {
+        return dir->listAll();
+    }
+    
+    bool BlockCacheDirectory::fileExists(const String& name)
+    {
+        return dir->fileExists(name);
+    }
+    
+    uint64_t BlockCacheDirectory::fileModified(const String& name)
+    {
+        return dir->fileModified(name);
+    }
+    
+    void BlockCacheDirectory::touchFile(const String& name)
+    {
+        dir->touchFile(name);
+    }
+    
+    void BlockCacheDirectory::deleteFile(const String& name)
+    {
+        invalidate(name);
+        dir->deleteFile(name);
+    }
+    
+    int64_t BlockCacheDirectory::fileLength(const String& name)
+    {
+        return dir->fileLength(name);
+    }
+    
+    IndexOutputPtr BlockCacheDirectory::createOutput(const String& name)
+    {
+        invalidate(name);
+        return dir->createOutput(name);
+    }
+    
+    void BlockCacheDirectory::sync(const String& name)
+    {
+        dir->sync(name);
+    }
+    
+    IndexInputPtr BlockCacheDirectory::openInput(const String& name)
+    {
+        return openInput(name, BufferedIndexInput::BUFFER_SIZE);
+    }
+    
+    IndexInputPtr BlockCacheDirectory::openInput(const String& name, int32_t bufferSize)
+    {
+        return openInput(name, bufferSize, false);
+    }
+    
+    DirectoryPtr BlockCacheDirectory::getMergeReadDirectory()
+    {
+        return newLucene<BlockCacheMergeDirectory>(shared_from_this());
+    }
+    
+    IndexInputPtr BlockCacheDirectory::openInput(const String& name, int32_t bufferSize, bool isMerge)
+    {
+        CachePolicy policy = getCachePolicy(FileSwitchDirectory::getExtension(name));
+        if (policy == CACHE_NEVER)
+            return dir->openInput(name, bufferSize);
+        bool admit = (policy == CACHE_ALWAYS || !isMerge);
+        // pages are read whole, so there's no point in the wrapped input buffering them again
+        IndexInputPtr input(dir->openInput(name, cache->getPageSize()));
+        return newLucene<BlockCacheIndexInput>(input, cache, getFileId(name), admit);
+    }
+    
+    String BlockCacheDirectory::getLockID()
+    {
+        return dir->getLockID();
+    }
+    
+    void BlockCacheDirectory::close()
+    {
+        dir->close();
+    }
+    
+    String BlockCacheDirectory::toString()
+    {
+        return L"BlockCacheDirectory(" + dir->toString() + L")";
+    }
+    
+    BlockCacheMergeDirectory::BlockCacheMergeDirectory(BlockCacheDirectoryPtr dir)
+    {
+        this->dir = dir;
+        this->lockFactory = dir->getLockFactory();
+    }
+    
+    BlockCacheMergeDirectory::~BlockCacheMergeDirectory()
+    {
+    }
+    
+    HashSet<String> BlockCacheMergeDirectory::listAll()
+    {
+        return dir->listAll();
+    }
+    
+    bool BlockCacheMergeDirectory::fileExists(const String& name)
+    {
+        return dir->fileExists(name);
+    }
+    
+    uint64_t BlockCacheMergeDirectory::fileModified(const String& name)
+    {
+        return dir->fileModified(name);
+    }
+    
+    void BlockCacheMergeDirectory::touchFile(const String& name)
+    {
+        dir->touchFile(name);
+    }
+    
+    void BlockCacheMergeDirectory::deleteFile(const String& name)
+    {
+        dir->deleteFile(name);
+    }
+    
+    int64_t BlockCacheMergeDirectory::fileLength(const String& name)
+    {
+        return dir->fileLength(name);
+    }
+    
+    IndexOutputPtr BlockCacheMergeDirectory::createOutput(const String& name)
+    {
+        return dir->createOutput(name);
+    }
+    
+    void BlockCacheMergeDirectory::sync(const String& name)
+    {
+        dir->sync(name);
+    }
+    
+    IndexInputPtr BlockCacheMergeDirectory::openInput(const String& name)
+    {
+        return openInput(name, BufferedIndexInput::BUFFER_SIZE);
+    }
+    
+    IndexInputPtr BlockCacheMergeDirectory::openInput(const String& name, int32_t bufferSize)
+    {
+        return dir->openInput(name, bufferSize, true);
+    }
+    
+    DirectoryPtr BlockCacheMergeDirectory::getMergeReadDirectory()
+    {
+        return shared_from_this();
+    }
+    
+    String BlockCacheMergeDirectory::getLockID()
+    {
+        return dir->getLockID();
+    }
+    
+    void BlockCacheMergeDirectory::close()
+    {
+        // the view doesn't own the directory
+    }
+    
+    String BlockCacheMergeDirectory::toString()
+    {
+        return L"BlockCacheMergeDirectory(" + dir->toString() + L")";
+    }
+    
+    BlockCacheIndexInput::BlockCacheIndexInput(IndexInputPtr input, BlockCachePtr cache, int64_t fileId, bool admit)
+    {
+        this->input = input;
+        this->cache = cache;
+        this->fileId = fileId;
+        this->admit = admit;
+        this->isClone = false;
+        this->_length = input->length();
+        this->pageSizePower = cache->getPageSizePower();
+        this->currentPageIndex = 0;
+        this->currentPageLength = 0;
+        this->currentPagePosition = 0;
+    }
+    
+    BlockCacheIndexInput::~BlockCacheIndexInput()
+    {
+    }
+    
+    void BlockCacheIndexInput::nextPage()
+    {
+        if (currentPage)
+        {
+            ++currentPageIndex;
+            currentPagePosition = 0;
+        }
+        loadPage(currentPageIndex);
+    }
+    
+    void BlockCacheIndexInput::loadPage(int64_t pageIndex)
+    {
+        int64_t start = pageIndex << pageSizePower;
+        if (start >= _length)
+            boost::throw_exception(IOException(L"Read past EOF"));
+        ByteArray page(cache->get(fileId, pageIndex));
+        if (!page)
+        {
+            int32_t pageLength = (int32_t)std::min((int64_t)1 << pageSizePower, _length - start);
+            page = ByteArray::newInstance(pageLength);
+            input->seek(start);
+            input->readBytes(page.get(), 0, pageLength);
+            if (admit)
+                cache->put(fileId, pageIndex, page);
+        }
+        currentPage = page;
+        currentPageIndex = pageIndex;
+        currentPageLength = page.size();
+        if (currentPagePosition >= currentPageLength)
+            boost::throw_exception(IOException(L"Read past EOF"));
+    }
+    
+    uint8_t BlockCacheIndexInput::readByte()
+    {
+        if (currentPagePosition >= currentPageLength)
+            nextPage();
+        return currentPage[currentPagePosition++];
+    }
+    
+    void BlockCacheIndexInput::readBytes(uint8_t* b, int32_t offset, int32_t length)
+    {
+        while (length > 0)
+        {
+            if (currentPagePosition >= currentPageLength)
+                nextPage();
+            int32_t count = std::min(length, currentPageLength - currentPagePosition);
+            MiscUtils::arrayCopy(currentPage.get(), currentPagePosition, b, offset, count);
+            currentPagePosition += count;
+            offset += count;
+            length -= count;
+        }
+    }
+    
+    int64_t BlockCacheIndexInput::getFilePointer()
+    {
+        return (currentPageIndex << pageSizePower) + currentPagePosition;
+    }
+    
+    void BlockCacheIndexInput::seek(int64_t pos)
+    {
+        int64_t pageIndex = pos >> pageSizePower;
+        if (pageIndex != currentPageIndex)
+        {
+            currentPageIndex = pageIndex;
+            currentPage.reset();
+            currentPageLength = 0;
+        }
+        currentPagePosition = (int32_t)(pos & (((int64_t)1 << pageSizePower) - 1));
+    }
+    
+    int64_t BlockCacheIndexInput::length()
+    {
+        return _length;
+    }
+    
+    void BlockCacheIndexInput::close()
+    {
+        if (!isClone)
+            input->close();
+    }
+    
+    LuceneObjectPtr BlockCacheIndexInput::clone(LuceneObjectPtr other)
+    {
+        IndexInputPtr inputClone(boost::dynamic_pointer_cast<IndexInput>(input->clone()));
+        LuceneObjectPtr clone = IndexInput::clone(other ? other : newLucene<BlockCacheIndexInput>(inputClone, cache, fileId, admit));
+        BlockCacheIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<BlockCacheIndexInput>(clone));
+        cloneIndexInput->currentPage = currentPage;
+        cloneIndexInput->currentPageIndex = currentPageIndex;
+        cloneIndexInput->currentPageLength = currentPageLength;
+        cloneIndexInput->currentPagePosition = currentPagePosition;
+        cloneIndexInput->isClone = true;
+        return cloneIndexInput;
+    }
+}
@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "ByteArrayIndexInput.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    ByteArrayIndexInput::ByteArrayIndexInput(ByteArray bytes, int32_t length)
+    {
+        this->bytes = bytes;
+        this->_length = length;
+        this->position = 0;
+    }
+    
+    ByteArrayIndexInput::~ByteArrayIndexInput()
+    {
+    }
+    
+    uint8_t ByteArrayIndexInput::readByte()
+    {
+        if (position >= _length)
+            boost::throw_exception(IOException(L"Read past EOF"));
+        return bytes[position++];
+    }
+    
+    void ByteArrayIndexInput::readBytes(uint8_t* b, int32_t offset, int32_t length)
+    {
+        if (length > _length - position)
+            boost::throw_exception(IOException(L"Read past EOF"));
+        MiscUtils::arrayCopy(bytes.get(), position, b, offset, length);
+        position += length;
+    }
+    
+    void ByteArrayIndexInput::close()
+    {
+        // nothing to do here
+    }
+    
+    int64_t ByteArrayIndexInput::getFilePointer()
+    {
+        return position;
+    }
+    
+    void ByteArrayIndexInput::seek(int64_t pos)
+    {
+        if (pos < 0 || pos > _length)
+            boost::throw_exception(IOException(L"Seek past EOF"));
+        position = (int32_t)pos;
+    }
+    
+    int64_t ByteArrayIndexInput::length()
+    {
+        return _length;
+    }
+    
+    LuceneObjectPtr ByteArrayIndexInput::clone(LuceneObjectPtr other)
+    {
+        LuceneObjectPtr clone = IndexInput::clone(other ? other : newLucene<ByteArrayIndexInput>(bytes, _length));
+        ByteArrayIndexInputPtr cloneInput(boost::dynamic_pointer_cast<ByteArrayIndexInput>(clone));
+        cloneInput->position = position;
+        return cloneInput;
+    }
+}
@@ -0,0 +1,109 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "ChecksumFooter.h"
+#include "CRC32C.h"
+#include "Directory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    const int32_t ChecksumFooter::FOOTER_MAGIC = ~0x3fd76c17;
+    const int32_t ChecksumFooter::ALGORITHM_CRC32C = 1;
+    const int32_t ChecksumFooter::FOOTER_LENGTH = 16;
+    
+    ChecksumFooter::~ChecksumFooter()
+    {
+    }
+    
+    int64_t ChecksumFooter::dataLength(IndexInputPtr input)
+    {
+        return input->length() - FOOTER_LENGTH;
+    }
+    
+    void ChecksumFooter::updateChecksum(IndexInputPtr input, int64_t numBytes, CRC32CPtr checksum)
+    {
+        ByteArray buffer(ByteArray::newInstance((int32_t)std::min((int64_t)16384, numBytes)));
+        while (numBytes > 0)
+        {
+            int32_t length = (int32_t)std::min((int64_t)buffer.size(), numBytes);
+            input->readBytes(buffer.get(), 0, length);
+            checksum->update(buffer.get(), 0, length);
+            numBytes -= length;
+        }
+    }
+    
+    void ChecksumFooter::copyBytes(IndexInputPtr input, IndexOutputPtr output, int64_t numBytes, CRC32CPtr checksum)
+    {
+        ByteArray buffer(ByteArray::newInstance((int32_t)std::min((int64_t)16384, numBytes)));
+        while (numBytes > 0)
+        {
+            int32_t length = (int32_t)std::min((int64_t)buffer.size(), numBytes);
+            input->readBytes(buffer.get(), 0, length);
+            checksum->update(buffer.get(), 0, length);
+            output->writeBytes(buffer.get(), 0, length);
+            numBytes -= length;
+        }
+    }
+    
+    int64_t ChecksumFooter::checkFooter(IndexInputPtr input, CRC32CPtr checksum)
+    {
+        if (input->length() < FOOTER_LENGTH)
+            boost::throw_exception(CorruptIndexException(L"file is too short to have a checksum footer: " + StringUtils::toString(input->length())));
+        input->seek(input->length() - FOOTER_LENGTH);
+        int32_t magic = input->readInt();
+        int32_t algorithm = input->readInt();
+        if (magic != FOOTER_MAGIC || algorithm != ALGORITHM_CRC32C)
+        {
+            boost::throw_exception(CorruptIndexException(L"missing checksum footer: magic=" + StringUtils::toString(magic) + 
+                                                         L" algorithm=" + StringUtils::toString(algorithm)));
+        }
+        
+        // the magic and algorithm ID are covered by the checksum too
+        input->seek(input->length() - FOOTER_LENGTH);
+        updateChecksum(input, 8, checksum);
+        
+        int64_t expected = input->readLong();
+        if (expected != checksum->getValue())
+        {
+            boost::throw_exception(CorruptIndexException(L"checksum failed (hardware problem?) : expected=" + 
+                                                         StringUtils::toString(expected, 16) + L" actual=" + 
+                                                         StringUtils::toString(checksum->getValue(), 16)));
+        }
+        return expected;
+    }
+    
+    int64_t ChecksumFooter::checksumEntireFile(IndexInputPtr input)
+    {
+        if (input->length() < FOOTER_LENGTH)
+            boost::throw_exception(CorruptIndexException(L"file is too short to have a checksum footer: " + StringUtils::toString(input->length())));
+        CRC32CPtr checksum(newLucene<CRC32C>());
+        input->seek(0);
+        updateChecksum(input, dataLength(input), checksum);
+        return checkFooter(input, checksum);
+    }
+    
+    int64_t ChecksumFooter::checksumEntireFile(DirectoryPtr dir, const String& name)
+    {
+        IndexInputPtr input(dir->openInput(name));
+        int64_t checksum = 0;
+        LuceneException finally;
+        try
+        {
+            checksum = checksumEntireFile(input);
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        input->close();
+        finally.throwException();
+        return checksum;
+    }
+}
@@ -0,0 +1,160 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "ChecksumFooter.h"
+#include "CRC32C.h"
+#include "MiscUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    const int32_t ChecksumFooterIndexOutput::HEADER_WINDOW = 64;
+    const int32_t ChecksumFooterIndexOutput::CHECKSUM_BUFFER_SIZE = 1024;
+    
+    ChecksumFooterIndexOutput::ChecksumFooterIndexOutput(IndexOutputPtr main)
+    {
+        this->main = main;
+        this->checksum = newLucene<CRC32C>();
+        this->checksumLength = 0;
+        this->filePointer = 0;
+        this->header = ByteArray::newInstance(HEADER_WINDOW);
+        this->pending = ByteArray::newInstance(CHECKSUM_BUFFER_SIZE);
+        this->pendingLength = 0;
+        this->footerStarted = false;
+        this->isOpen = true;
+    }
+    
+    ChecksumFooterIndexOutput::~ChecksumFooterIndexOutput()
+    {
+    }
+    
+    void ChecksumFooterIndexOutput::writeByte(uint8_t b)
+    {
+        if (filePointer != checksumLength || filePointer < HEADER_WINDOW)
+        {
+            writeBytes(&b, 0, 1);
+            return;
+        }
+        main->writeByte(b);
+        ++filePointer;
+        ++checksumLength;
+        pending[pendingLength++] = b;
+        if (pendingLength == CHECKSUM_BUFFER_SIZE)
+            updateChecksum();
+    }
+    
+    void ChecksumFooterIndexOutput::writeBytes(const uint8_t* b, int32_t offset, int32_t length)
+    {
+        if (length <= 0)
+            return;
+        int64_t pos = filePointer;
+        if (pos > checksumLength)
+            boost::throw_exception(IOException(L"Cannot leave a gap in a file with a checksum footer"));
+        int32_t overwrite = (int32_t)std::min((int64_t)length, checksumLength - pos);
+        if (overwrite > 0 && pos + overwrite > HEADER_WINDOW)
+            boost::throw_exception(IllegalStateException(L"Only the first " + StringUtils::toString(HEADER_WINDOW) + 
+                                                         L" bytes of a file with a checksum footer may be overwritten"));
+        
+        // count the bytes only once the primary output took them, so a failed write (eg. disk full) 
+        // doesn't leave the checksum ahead of the file
+        main->writeBytes(b, offset, length);
+        filePointer += length;
+        
+        if (overwrite > 0)
+        {
+            updateChecksum();
+            checksum->patch(checksumLength, pos, header.get() + pos, b + offset, overwrite);
+            MiscUtils::arrayCopy(b, offset, header.get(), (int32_t)pos, overwrite);
+        }
+        if (length > overwrite)
+            append(b, offset + overwrite, length - overwrite);
+    }
+    
+    void ChecksumFooterIndexOutput::append(const uint8_t* b, int32_t offset, int32_t length)
+    {
+        if (checksumLength < HEADER_WINDOW)
+        {
+            int32_t headerBytes = std::min(length, HEADER_WINDOW - (int32_t)checksumLength);
+            MiscUtils::arrayCopy(b, offset, header.get(), (int32_t)checksumLength, headerBytes);
+        }
+        checksumLength += length;
+        
+        // never leave the buffer full, writeByte relies on there being room for one more byte
+        if (pendingLength + length >= CHECKSUM_BUFFER_SIZE)
+        {
+            updateChecksum();
+            if (length >= CHECKSUM_BUFFER_SIZE)
+            {
+                checksum->update(b, offset, length);
+                return;
+            }
+        }
+        MiscUtils::arrayCopy(b, offset, pending.get(), pendingLength, length);
+        pendingLength += length;
+    }
+    
+    void ChecksumFooterIndexOutput::updateChecksum()
+    {
+        if (pendingLength > 0)
+        {
+            checksum->update(pending.get(), 0, pendingLength);
+            pendingLength = 0;
+        }
+    }
+    
+    void ChecksumFooterIndexOutput::flush()
+    {
+        main->flush();
+    }
+    
+    void ChecksumFooterIndexOutput::close()
+    {
+        if (!isOpen)
+            return;
+        if (main->getFilePointer() != checksumLength)
+            main->seek(checksumLength);
+        filePointer = checksumLength;
+        if (!footerStarted)
+        {
+            // a close that failed (eg. disk full) may be retried, writeBytes only counts the magic
+            // and algorithm ID once the primary output took all of them
+            int32_t words[2] = {ChecksumFooter::FOOTER_MAGIC, ChecksumFooter::ALGORITHM_CRC32C};
+            uint8_t footer[8];
+            for (int32_t i = 0; i < 8; ++i)
+                footer[i] = (uint8_t)(words[i / 4] >> (24 - 8 * (i % 4)));
+            writeBytes(footer, 0, 8);
+            footerStarted = true;
+        }
+        updateChecksum();
+        main->writeLong(checksum->getValue());
+        main->close();
+        isOpen = false;
+    }
+    
+    int64_t ChecksumFooterIndexOutput::getFilePointer()
+    {
+        return filePointer;
+    }
+    
+    void ChecksumFooterIndexOutput::seek(int64_t pos)
+    {
+        main->seek(pos);
+        filePointer = pos;
+    }
+    
+    int64_t ChecksumFooterIndexOutput::length()
+    {
+        return std::max(checksumLength, filePointer);
+    }
+    
+    int64_t ChecksumFooterIndexOutput::getChecksum()
+    {
+        updateChecksum();
+        return checksum->getValue();
+    }
+}
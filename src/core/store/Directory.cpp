@@ -37,6 +37,11 @@ namespace Lucene
         return openInput(name);
     }
     
+    DirectoryPtr Directory::getMergeReadDirectory()
+    {
+        return shared_from_this();
+    }
+    
     LockPtr Directory::makeLock(const String& name)
     {
         return lockFactory->makeLock(name);
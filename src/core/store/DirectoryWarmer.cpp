@@ -0,0 +1,228 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include <boost/algorithm/string.hpp>
+#include "DirectoryWarmer.h"
+#include "_DirectoryWarmer.h"
+#include "IndexCommit.h"
+#include "IndexFileNames.h"
+#include "CompoundFileReader.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
+
+namespace Lucene
+{
+    DirectoryWarmer::DirectoryWarmer()
+    {
+        modes = MapStringInt::newInstance();
+        modes.put(IndexFileNames::TERMS_INDEX_EXTENSION(), FSDirectory::WARM_PRELOAD);
+        modes.put(IndexFileNames::NORMS_EXTENSION(), FSDirectory::WARM_PRELOAD);
+        modes.put(IndexFileNames::TERMS_EXTENSION(), FSDirectory::WARM_ADVISE);
+        modes.put(IndexFileNames::FREQ_EXTENSION(), FSDirectory::WARM_ADVISE);
+        modes.put(IndexFileNames::DOC_VALUES_EXTENSION(), FSDirectory::WARM_ADVISE);
+        background = false;
+        bytesWarmed = 0;
+        bytesToWarm = 0;
+    }
+    
+    DirectoryWarmer::~DirectoryWarmer()
+    {
+    }
+    
+    void DirectoryWarmer::setMode(const String& extension, FSDirectory::WarmMode mode)
+    {
+        SyncLock syncLock(this);
+        modes.put(extension, mode);
+    }
+    
+    FSDirectory::WarmMode DirectoryWarmer::getMode(const String& extension)
+    {
+        SyncLock syncLock(this);
+        MapStringInt::iterator mode = modes.find(extension);
+        return mode == modes.end() ? FSDirectory::WARM_NONE : (FSDirectory::WarmMode)mode->second;
+    }
+    
+    void DirectoryWarmer::setBackground(bool background)
+    {
+        this->background = background;
+    }
+    
+    bool DirectoryWarmer::getBackground()
+    {
+        return background;
+    }
+    
+    void DirectoryWarmer::warm(IndexCommitPtr commit)
+    {
+        warm(commit->getDirectory(), commit->getFileNames());
+    }
+    
+    void DirectoryWarmer::warm(DirectoryPtr directory, HashSet<String> files)
+    {
+        FSDirectoryPtr fsDirectory(boost::dynamic_pointer_cast<FSDirectory>(directory));
+        if (!fsDirectory)
+            return;
+    
+        waitForCompletion();
+    
+        Collection<WarmRange> ranges(Collection<WarmRange>::newInstance());
+        for (HashSet<String>::iterator fileName = files.begin(); fileName != files.end(); ++fileName)
+            addRanges(fsDirectory, *fileName, ranges);
+    
+        {
+            SyncLock syncLock(this);
+            bytesWarmed = 0;
+            bytesToWarm = 0;
+            for (Collection<WarmRange>::iterator range = ranges.begin(); range != ranges.end(); ++range)
+                bytesToWarm += range->length;
+            error = LuceneException();
+        }
+    
+        if (background)
+        {
+            SyncLock syncLock(this);
+            thread = newLucene<WarmerThread>(shared_from_this(), fsDirectory, ranges);
+            thread->start();
+        }
+        else
+            warmRanges(fsDirectory, ranges);
+    }
+    
+    bool DirectoryWarmer::isRunning()
+    {
+        SyncLock syncLock(this);
+        return (thread && thread->isAlive());
+    }
+    
+    void DirectoryWarmer::waitForCompletion()
+    {
+        LuceneThreadPtr thread;
+        {
+            SyncLock syncLock(this);
+            thread = this->thread;
+        }
+        if (thread)
+            thread->join();
+        LuceneException finally;
+        {
+            SyncLock syncLock(this);
+            if (this->thread == thread)
+                this->thread.reset();
+            finally = error;
+            error = LuceneException();
+        }
+        finally.throwException();
+    }
+    
+    int64_t DirectoryWarmer::getBytesWarmed()
+    {
+        SyncLock syncLock(this);
+        return bytesWarmed;
+    }
+    
+    int64_t DirectoryWarmer::getBytesToWarm()
+    {
+        SyncLock syncLock(this);
+        return bytesToWarm;
+    }
+    
+    void DirectoryWarmer::progress(const String& fileName, int64_t bytesWarmed, int64_t bytesToWarm)
+    {
+    }
+    
+    FSDirectory::WarmMode DirectoryWarmer::getFileMode(const String& fileName)
+    {
+        String::size_type dot = fileName.find_last_of(L'.');
+        if (dot == String::npos)
+            return FSDirectory::WARM_NONE;
+        String extension(fileName.substr(dot + 1));
+    
+        // separate norms files are named .sN
+        if (boost::starts_with(extension, IndexFileNames::SEPARATE_NORMS_EXTENSION()) && extension.length() > 1 && UnicodeUtil::isDigit(extension[1]))
+            extension = IndexFileNames::NORMS_EXTENSION();
+    
+        return getMode(extension);
+    }
+    
+    void DirectoryWarmer::addRanges(FSDirectoryPtr directory, const String& fileName, Collection<WarmRange> ranges)
+    {
+        FSDirectory::WarmMode mode = getFileMode(fileName);
+        if (mode != FSDirectory::WARM_NONE)
+        {
+            ranges.add(WarmRange(fileName, 0, directory->fileLength(fileName), mode));
+            return;
+        }
+    
+        // warm the parts of compound files that we would warm if they were separate files
+        if (boost::ends_with(fileName, L"." + IndexFileNames::COMPOUND_FILE_EXTENSION()) ||
+            boost::ends_with(fileName, L"." + IndexFileNames::COMPOUND_FILE_STORE_EXTENSION()))
+        {
+            CompoundFileReaderPtr reader(newLucene<CompoundFileReader>(directory, fileName));
+            LuceneException finally;
+            try
+            {
+                HashSet<String> subFiles(reader->listAll());
+                for (HashSet<String>::iterator subFile = subFiles.begin(); subFile != subFiles.end(); ++subFile)
+                {
+                    FSDirectory::WarmMode subMode = getFileMode(*subFile);
+                    if (subMode != FSDirectory::WARM_NONE)
+                        ranges.add(WarmRange(fileName, reader->fileOffset(*subFile), reader->fileLength(*subFile), subMode));
+                }
+            }
+            catch (LuceneException& e)
+            {
+                finally = e;
+            }
+            reader->close();
+            finally.throwException();
+        }
+    }
+    
+    void DirectoryWarmer::warmRanges(FSDirectoryPtr directory, Collection<WarmRange> ranges)
+    {
+        for (Collection<WarmRange>::iterator range = ranges.begin(); range != ranges.end(); ++range)
+        {
+            directory->warmFile(range->fileName, range->mode, range->offset, range->length);
+            int64_t warmed;
+            int64_t toWarm;
+            {
+                SyncLock syncLock(this);
+                bytesWarmed += range->length;
+                warmed = bytesWarmed;
+                toWarm = bytesToWarm;
+            }
+            progress(range->fileName, warmed, toWarm);
+        }
+    }
+    
+    WarmerThread::WarmerThread(DirectoryWarmerPtr warmer, FSDirectoryPtr directory, Collection<DirectoryWarmer::WarmRange> ranges)
+    {
+        this->_warmer = warmer;
+        this->directory = directory;
+        this->ranges = ranges;
+    }
+    
+    WarmerThread::~WarmerThread()
+    {
+    }
+    
+    void WarmerThread::run()
+    {
+        DirectoryWarmerPtr warmer(_warmer.lock());
+        if (!warmer)
+            return;
+        try
+        {
+            warmer->warmRanges(directory, ranges);
+        }
+        catch (LuceneException& e)
+        {
+            SyncLock syncLock(warmer);
+            warmer->error = e;
+        }
+    }
+}
@@ -9,6 +9,7 @@
 #include "FSDirectory.h"
 #include "NativeFSLockFactory.h"
 #include "SimpleFSDirectory.h"
+#include "NIOFSDirectory.h"
 #include "BufferedIndexInput.h"
 #include "LuceneThread.h"
 #include "FileUtils.h"
@@ -19,6 +20,11 @@ extern "C"
 #include "../util/md5/md5.h"
 }
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace Lucene
 {
     /// Default read chunk size.  This is a conditional default based on operating system.
@@ -27,6 +33,8 @@ namespace Lucene
     #else
     const int32_t FSDirectory::DEFAULT_READ_CHUNK_SIZE = 100 * 1024 * 1024; // 100mb
     #endif
+    
+    const int32_t FSDirectory::WARM_BUFFER_SIZE = 65536;
 
     FSDirectory::FSDirectory(const String& path, LockFactoryPtr lockFactory)
     {
@@ -73,6 +81,15 @@ namespace Lucene
         return newLucene<SimpleFSDirectory>(path, lockFactory);
     }
     
+    FSDirectoryPtr FSDirectory::open(const String& path, LockFactoryPtr lockFactory, bool positionalReads)
+    {
+        #if !defined(_WIN32) && !defined(_WIN64)
+        if (positionalReads)
+            return newLucene<NIOFSDirectory>(path, lockFactory);
+        #endif
+        return newLucene<SimpleFSDirectory>(path, lockFactory);
+    }
+    
     void FSDirectory::createDir()
     {
         if (!checked)
@@ -214,6 +231,60 @@ namespace Lucene
         return lockID;
     }
     
+    void FSDirectory::warmFile(const String& name, WarmMode mode, int64_t offset, int64_t length)
+    {
+        ensureOpen();
+        length = checkWarmRange(name, offset, length);
+        if (mode == WARM_NONE || length == 0)
+            return;
+        
+        #ifdef POSIX_FADV_WILLNEED
+        if (mode == WARM_ADVISE)
+        {
+            int32_t fd = ::open(StringUtils::toUTF8(FileUtils::joinPath(directory, name)).c_str(), O_RDONLY);
+            if (fd < 0)
+                boost::throw_exception(FileNotFoundException(FileUtils::joinPath(directory, name)));
+            posix_fadvise(fd, (off_t)offset, (off_t)length, POSIX_FADV_WILLNEED); // advisory only, so ignore failure
+            ::close(fd);
+            return;
+        }
+        #endif
+        
+        IndexInputPtr input(openInput(name, WARM_BUFFER_SIZE));
+        LuceneException finally;
+        try
+        {
+            ByteArray buffer(ByteArray::newInstance(WARM_BUFFER_SIZE));
+            input->seek(offset);
+            while (length > 0)
+            {
+                int32_t toRead = (int32_t)std::min(length, (int64_t)buffer.size());
+                input->readBytes(buffer.get(), 0, toRead);
+                length -= toRead;
+            }
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        input->close();
+        finally.throwException();
+    }
+    
+    int64_t FSDirectory::checkWarmRange(const String& name, int64_t offset, int64_t length)
+    {
+        int64_t fileLength = this->fileLength(name);
+        if (length < 0)
+            length = fileLength - offset;
+        if (offset < 0 || length < 0 || offset + length > fileLength)
+        {
+            boost::throw_exception(IllegalArgumentException(L"warm range out of bounds: offset=" + StringUtils::toString(offset) + 
+                                                            L" length=" + StringUtils::toString(length) + 
+                                                            L" fileLength=" + StringUtils::toString(fileLength) + L" in " + name));
+        }
+        return length;
+    }
+    
     void FSDirectory::close()
     {
         SyncLock syncLock(this);
@@ -6,6 +6,8 @@
 
 #include "LuceneInc.h"
 #include "IndexInput.h"
+#include "ReadBatch.h"
+#include "SlicedIndexInput.h"
 #include "UTF8Stream.h"
 #include "Reader.h"
 #include "StringUtils.h"
@@ -133,6 +135,38 @@ namespace Lucene
         }
     }
     
+    void IndexInput::submitReads(ReadBatchPtr batch)
+    {
+        IndexInputPtr input(boost::dynamic_pointer_cast<IndexInput>(clone()));
+        for (int32_t i = 0; i < batch->size(); ++i)
+        {
+            ByteArray bytes(batch->getBytes(i));
+            input->seek(batch->getPosition(i));
+            input->readBytes(bytes.get(), 0, bytes.size());
+        }
+    }
+    
+    const uint8_t* IndexInput::mappedBytes(int64_t pos, int64_t length)
+    {
+        return NULL;
+    }
+    
+    IndexInputPtr IndexInput::slice(int64_t offset, int64_t length)
+    {
+        checkSlice(offset, length);
+        return newLucene<SlicedIndexInput>(boost::dynamic_pointer_cast<IndexInput>(shared_from_this()), offset, length);
+    }
+    
+    void IndexInput::checkSlice(int64_t offset, int64_t length)
+    {
+        if (offset < 0 || length < 0 || offset + length > this->length())
+        {
+            boost::throw_exception(IllegalArgumentException(L"slice out of bounds: offset=" + StringUtils::toString(offset) + 
+                                                            L" length=" + StringUtils::toString(length) + 
+                                                            L" fileLength=" + StringUtils::toString(this->length())));
+        }
+    }
+    
     MapStringString IndexInput::readStringStringMap()
     {
         MapStringString map(MapStringString::newInstance());
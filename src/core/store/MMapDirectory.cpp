@@ -13,42 +13,156 @@
 #include "FileUtils.h"
 #include "StringUtils.h"
 
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <sys/mman.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#endif
+
 namespace Lucene
 {
+    /// Default max chunk size.  This is a conditional default based on operating system.
+    #ifdef LPP_BUILD_64
+    const int32_t MMapDirectory::DEFAULT_MAX_CHUNK_SIZE = 1 << 30;
+    #else
+    const int32_t MMapDirectory::DEFAULT_MAX_CHUNK_SIZE = 1 << 28;
+    #endif
+    
     MMapDirectory::MMapDirectory(const String& path, LockFactoryPtr lockFactory) : FSDirectory(path, lockFactory)
     {
+        lockedFiles = MapStringMMapIndexInput::newInstance();
+        setMaxChunkSize(DEFAULT_MAX_CHUNK_SIZE);
     }
     
     MMapDirectory::~MMapDirectory()
     {
     }
     
+    void MMapDirectory::setMaxChunkSize(int32_t maxChunkSize)
+    {
+        if (maxChunkSize <= 0)
+            boost::throw_exception(IllegalArgumentException(L"Maximum chunk size for mmap must be > 0"));
+        int32_t power = 0;
+        while ((maxChunkSize >> (power + 1)) != 0)
+            ++power;
+        if ((1 << power) < boost::iostreams::mapped_file_source::alignment())
+            boost::throw_exception(IllegalArgumentException(L"Maximum chunk size for mmap must be at least the mapping granularity"));
+        chunkSizePower = power;
+    }
+    
+    int32_t MMapDirectory::getMaxChunkSize()
+    {
+        return 1 << chunkSizePower;
+    }
+    
     IndexInputPtr MMapDirectory::openInput(const String& name, int32_t bufferSize)
     {
         ensureOpen();
-        return newLucene<MMapIndexInput>(FileUtils::joinPath(directory, name));
+        return newLucene<MMapIndexInput>(FileUtils::joinPath(directory, name), chunkSizePower);
     }
     
     IndexOutputPtr MMapDirectory::createOutput(const String& name)
     {
+        unlockFile(name);
         initOutput(name);
         return newLucene<SimpleFSIndexOutput>(FileUtils::joinPath(directory, name));
     }
     
-    MMapIndexInput::MMapIndexInput(const String& path)
+    void MMapDirectory::deleteFile(const String& name)
+    {
+        unlockFile(name);
+        FSDirectory::deleteFile(name);
+    }
+    
+    void MMapDirectory::warmFile(const String& name, WarmMode mode, int64_t offset, int64_t length)
+    {
+        ensureOpen();
+        length = checkWarmRange(name, offset, length);
+        if (mode == WARM_NONE || length == 0)
+            return;
+        if (mode == WARM_LOCK)
+        {
+            SyncLock syncLock(this);
+            MMapIndexInputPtr input(lockedFiles.get(name));
+            if (!input)
+                input = newLucene<MMapIndexInput>(FileUtils::joinPath(directory, name), chunkSizePower);
+            input->warm(offset, length, mode);
+            lockedFiles.put(name, input);
+        }
+        else
+        {
+            MMapIndexInputPtr input(newLucene<MMapIndexInput>(FileUtils::joinPath(directory, name), chunkSizePower));
+            LuceneException finally;
+            try
+            {
+                input->warm(offset, length, mode);
+            }
+            catch (LuceneException& e)
+            {
+                finally = e;
+            }
+            input->close();
+            finally.throwException();
+        }
+    }
+    
+    HashSet<String> MMapDirectory::getLockedFiles()
+    {
+        SyncLock syncLock(this);
+        HashSet<String> files(HashSet<String>::newInstance());
+        for (MapStringMMapIndexInput::iterator locked = lockedFiles.begin(); locked != lockedFiles.end(); ++locked)
+            files.add(locked->first);
+        return files;
+    }
+    
+    void MMapDirectory::unlockFile(const String& name)
+    {
+        SyncLock syncLock(this);
+        MapStringMMapIndexInput::iterator locked = lockedFiles.find(name);
+        if (locked != lockedFiles.end())
+        {
+            locked->second->close();
+            lockedFiles.remove(name);
+        }
+    }
+    
+    void MMapDirectory::close()
+    {
+        SyncLock syncLock(this);
+        for (MapStringMMapIndexInput::iterator locked = lockedFiles.begin(); locked != lockedFiles.end(); ++locked)
+            locked->second->close();
+        lockedFiles.clear();
+        FSDirectory::close();
+    }
+    
+    MMapIndexInput::MMapIndexInput(const String& path, int32_t chunkSizePower)
     {
-        _length = path.empty() ? 0 : (int32_t)FileUtils::fileLength(path);
-        bufferPosition = 0;
+        _length = path.empty() ? 0 : FileUtils::fileLength(path);
+        this->chunkSizePower = chunkSizePower;
+        this->chunkSizeMask = ((int64_t)1 << chunkSizePower) - 1;
+        curChunkIndex = 0;
+        curChunk = NULL;
+        curChunkLength = 0;
+        curChunkPosition = 0;
+        sliceOffset = 0;
         if (!path.empty())
         {
+            chunks = Collection<MappedChunk>::newInstance();
             try
             {
-                file.open(StringUtils::toUTF8(path).c_str(), _length);
+                SingleString utf8Path(StringUtils::toUTF8(path));
+                for (int64_t offset = 0; offset < _length; offset += ((int64_t)1 << chunkSizePower))
+                {
+                    int64_t chunkLength = std::min(_length - offset, (int64_t)1 << chunkSizePower);
+                    chunks.add(MappedChunk(utf8Path.c_str(), (size_t)chunkLength, (boost::iostreams::stream_offset)offset));
+                }
             }
             catch (...)
             {
                 boost::throw_exception(FileNotFoundException(path));
             }
+            setChunk(0);
         }
         isClone = false;
     }
@@ -57,66 +171,220 @@ namespace Lucene
     {
     }
     
-    uint8_t MMapIndexInput::readByte()
+    void MMapIndexInput::setChunk(int32_t index)
     {
-        try
+        curChunkIndex = index;
+        if (chunks && index < chunks.size())
         {
-            return file.data()[bufferPosition++];
+            // the chunk is cut short at the end of a slice
+            int64_t available = sliceOffset + _length - ((int64_t)index << chunkSizePower);
+            curChunk = (const uint8_t*)chunks[index].data();
+            curChunkLength = (int32_t)std::max((int64_t)0, std::min((int64_t)chunks[index].size(), available));
         }
-        catch (...)
+        else
         {
-            boost::throw_exception(IOException(L"Read past EOF"));
-            return 0;
+            curChunk = NULL;
+            curChunkLength = 0;
         }
     }
     
+    void MMapIndexInput::nextChunk()
+    {
+        if (!chunks || curChunkIndex + 1 >= chunks.size() || ((int64_t)(curChunkIndex + 1) << chunkSizePower) >= sliceOffset + _length)
+            boost::throw_exception(IOException(L"Read past EOF"));
+        setChunk(curChunkIndex + 1);
+        curChunkPosition = 0;
+    }
+    
+    uint8_t MMapIndexInput::readByte()
+    {
+        if (curChunkPosition >= curChunkLength)
+            nextChunk();
+        return curChunk[curChunkPosition++];
+    }
+    
     void MMapIndexInput::readBytes(uint8_t* b, int32_t offset, int32_t length)
     {
-        try
+        int32_t available = curChunkLength - curChunkPosition;
+        while (length > available)
         {
-            MiscUtils::arrayCopy(file.data(), bufferPosition, b, offset, length);
-            bufferPosition += length;
+            if (available > 0)
+            {
+                MiscUtils::arrayCopy(curChunk, curChunkPosition, b, offset, available);
+                offset += available;
+                length -= available;
+            }
+            nextChunk();
+            available = curChunkLength;
         }
-        catch (...)
+        if (length > 0)
         {
-            boost::throw_exception(IOException(L"Read past EOF"));
+            MiscUtils::arrayCopy(curChunk, curChunkPosition, b, offset, length);
+            curChunkPosition += length;
+        }
+    }
+    
+    int32_t MMapIndexInput::readVInt()
+    {
+        // fall back to byte-at-a-time decoding if the value may straddle a chunk boundary
+        if (curChunkLength - curChunkPosition < 5)
+            return IndexInput::readVInt();
+        const uint8_t* bytes = curChunk + curChunkPosition;
+        uint8_t b = bytes[0];
+        int32_t i = (b & 0x7f);
+        int32_t pos = 1;
+        for (int32_t shift = 7; (b & 0x80) != 0 && pos < 5; shift += 7)
+        {
+            b = bytes[pos++];
+            i |= (b & 0x7f) << shift;
+        }
+        if ((b & 0x80) != 0)
+            boost::throw_exception(IOException(L"Invalid vInt detected (too many bits)"));
+        curChunkPosition += pos;
+        return i;
+    }
+    
+    int64_t MMapIndexInput::readVLong()
+    {
+        // fall back to byte-at-a-time decoding if the value may straddle a chunk boundary
+        if (curChunkLength - curChunkPosition < 9)
+            return IndexInput::readVLong();
+        const uint8_t* bytes = curChunk + curChunkPosition;
+        uint8_t b = bytes[0];
+        int64_t i = (b & 0x7f);
+        int32_t pos = 1;
+        for (int32_t shift = 7; (b & 0x80) != 0 && pos < 9; shift += 7)
+        {
+            b = bytes[pos++];
+            i |= (int64_t)(b & 0x7f) << shift;
         }
+        if ((b & 0x80) != 0)
+            boost::throw_exception(IOException(L"Invalid vLong detected (negative values disallowed)"));
+        curChunkPosition += pos;
+        return i;
     }
     
     int64_t MMapIndexInput::getFilePointer()
     {
-        return bufferPosition;
+        return ((int64_t)curChunkIndex << chunkSizePower) + curChunkPosition - sliceOffset;
     }
     
     void MMapIndexInput::seek(int64_t pos)
     {
-        bufferPosition = (int32_t)pos;
+        pos += sliceOffset;
+        int32_t index = (int32_t)(pos >> chunkSizePower);
+        if (index != curChunkIndex || !curChunk)
+            setChunk(index);
+        curChunkPosition = (int32_t)(pos & chunkSizeMask);
     }
     
     int64_t MMapIndexInput::length()
     {
-        return (int64_t)_length;
+        return _length;
     }
     
     void MMapIndexInput::close()
     {
-        if (isClone || !file.is_open())
+        if (isClone || !chunks)
             return;
+        for (Collection<MappedChunk>::iterator chunk = chunks.begin(); chunk != chunks.end(); ++chunk)
+            chunk->close();
+        chunks.clear(); // clones share the chunk list and will now see EOF
+        chunks.reset();
         _length = 0;
-        bufferPosition = 0;
-        file.close();
+        setChunk(0);
+        curChunkPosition = 0;
     }
     
     LuceneObjectPtr MMapIndexInput::clone(LuceneObjectPtr other)
     {
-        if (!file.is_open())
+        if (!chunks || (chunks.empty() && _length > 0))
             boost::throw_exception(AlreadyClosedException(L"MMapIndexInput already closed"));
         LuceneObjectPtr clone = IndexInput::clone(other ? other : newLucene<MMapIndexInput>());
         MMapIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<MMapIndexInput>(clone));
         cloneIndexInput->_length = _length;
-        cloneIndexInput->file = file;
-        cloneIndexInput->bufferPosition = bufferPosition;
+        cloneIndexInput->chunks = chunks;
+        cloneIndexInput->chunkSizePower = chunkSizePower;
+        cloneIndexInput->chunkSizeMask = chunkSizeMask;
+        cloneIndexInput->curChunkIndex = curChunkIndex;
+        cloneIndexInput->curChunk = curChunk;
+        cloneIndexInput->curChunkLength = curChunkLength;
+        cloneIndexInput->curChunkPosition = curChunkPosition;
         cloneIndexInput->isClone = true;
+        cloneIndexInput->sliceOffset = sliceOffset;
         return cloneIndexInput;
     }
+    
+    IndexInputPtr MMapIndexInput::slice(int64_t offset, int64_t length)
+    {
+        checkSlice(offset, length);
+        MMapIndexInputPtr slice(boost::dynamic_pointer_cast<MMapIndexInput>(clone()));
+        slice->sliceOffset = sliceOffset + offset;
+        slice->_length = length;
+        slice->setChunk((int32_t)(slice->sliceOffset >> chunkSizePower));
+        slice->seek(0);
+        return slice;
+    }
+    
+    const uint8_t* MMapIndexInput::mappedBytes(int64_t pos, int64_t length)
+    {
+        if (!chunks || pos < 0 || length < 0 || pos + length > _length)
+            return NULL;
+        pos += sliceOffset;
+        int32_t index = (int32_t)(pos >> chunkSizePower);
+        if (length > 0 && ((pos + length - 1) >> chunkSizePower) != index)
+            return NULL;
+        if (index >= chunks.size())
+            return NULL;
+        return (const uint8_t*)chunks[index].data() + (pos & chunkSizeMask);
+    }
+    
+    void MMapIndexInput::warm(int64_t offset, int64_t length, FSDirectory::WarmMode mode)
+    {
+        if (offset < 0 || length < 0 || offset + length > _length)
+            boost::throw_exception(IllegalArgumentException(L"warm range out of bounds"));
+        offset += sliceOffset;
+        int64_t end = offset + length;
+        while (offset < end)
+        {
+            int32_t index = (int32_t)(offset >> chunkSizePower);
+            int64_t chunkOffset = offset & chunkSizeMask;
+            int64_t rangeLength = std::min((int64_t)chunks[index].size() - chunkOffset, end - offset);
+            warmRange((const uint8_t*)chunks[index].data() + chunkOffset, rangeLength, mode);
+            offset += rangeLength;
+        }
+    }
+    
+    void MMapIndexInput::warmRange(const uint8_t* start, int64_t length, FSDirectory::WarmMode mode)
+    {
+        #if defined(_WIN32) || defined(_WIN64)
+        int64_t pageSize = 4096;
+        #else
+        int64_t pageSize = (int64_t)sysconf(_SC_PAGESIZE);
+        
+        // madvise and mlock want page aligned addresses
+        int64_t misalignment = (int64_t)((size_t)start % (size_t)pageSize);
+        void* pageStart = (void*)(start - misalignment);
+        size_t pageLength = (size_t)(length + misalignment);
+        
+        if (mode == FSDirectory::WARM_ADVISE)
+        {
+            madvise(pageStart, pageLength, MADV_WILLNEED); // advisory only, so ignore failure
+            return;
+        }
+        if (mode == FSDirectory::WARM_LOCK)
+        {
+            // mlock faults the pages in before returning
+            if (mlock(pageStart, pageLength) != 0)
+                boost::throw_exception(IOException(L"mlock failed: " + StringUtils::toUnicode(strerror(errno))));
+            return;
+        }
+        #endif
+        
+        // touch a byte in every page; volatile so the reads aren't optimized away
+        volatile uint8_t sum = 0;
+        for (int64_t i = 0; i < length; i += pageSize)
+            sum += start[i];
+        sum += start[length - 1];
+    }
 }
@@ -0,0 +1,521 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include <boost/bind.hpp>
+#include <boost/bind/protect.hpp>
+#include "NIOFSDirectory.h"
+#include "_NIOFSDirectory.h"
+#include "SimpleFSDirectory.h"
+#include "_SimpleFSDirectory.h"
+#include "ThreadPool.h"
+#include "FileReader.h"
+#include "FileUtils.h"
+#include "StringUtils.h"
+
+#if !defined(_WIN32) && !defined(_WIN64)
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifdef LPP_HAVE_IO_URING
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+namespace Lucene
+{
+    NIOFSDirectory::NIOFSDirectory(const String& path, LockFactoryPtr lockFactory) : FSDirectory(path, lockFactory)
+    {
+    }
+    
+    NIOFSDirectory::~NIOFSDirectory()
+    {
+    }
+    
+    IndexInputPtr NIOFSDirectory::openInput(const String& name, int32_t bufferSize)
+    {
+        ensureOpen();
+        return newLucene<NIOFSIndexInput>(FileUtils::joinPath(directory, name), bufferSize, getReadChunkSize());
+    }
+    
+    IndexOutputPtr NIOFSDirectory::createOutput(const String& name)
+    {
+        initOutput(name);
+        return newLucene<SimpleFSIndexOutput>(FileUtils::joinPath(directory, name));
+    }
+    
+    const int32_t PositionalInputFile::FILE_EOF = FileReader::FILE_EOF;
+    
+    PositionalInputFile::PositionalInputFile(const String& path)
+    {
+        #if defined(_WIN32) || defined(_WIN64)
+        handle = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 
+                               NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (handle == INVALID_HANDLE_VALUE)
+        {
+            handle = NULL;
+            boost::throw_exception(FileNotFoundException(path));
+        }
+        #else
+        fd = ::open(StringUtils::toUTF8(path).c_str(), O_RDONLY);
+        if (fd < 0)
+            boost::throw_exception(FileNotFoundException(path));
+        #endif
+        length = FileUtils::fileLength(path);
+    }
+    
+    PositionalInputFile::~PositionalInputFile()
+    {
+        close();
+    }
+    
+    int64_t PositionalInputFile::getLength()
+    {
+        return length;
+    }
+    
+    int32_t PositionalInputFile::read(uint8_t* b, int32_t offset, int32_t length, int64_t position)
+    {
+        if (position >= this->length)
+            return FILE_EOF;
+        #if defined(_WIN32) || defined(_WIN64)
+        if (handle == NULL)
+            boost::throw_exception(IOException(L"File already closed"));
+        OVERLAPPED overlapped;
+        ZeroMemory(&overlapped, sizeof(overlapped));
+        overlapped.Offset = (DWORD)(position & 0xffffffffLL);
+        overlapped.OffsetHigh = (DWORD)(position >> 32);
+        DWORD readCount = 0;
+        if (!::ReadFile((HANDLE)handle, b + offset, (DWORD)length, &readCount, &overlapped))
+        {
+            if (::GetLastError() == ERROR_HANDLE_EOF)
+                return FILE_EOF;
+            boost::throw_exception(IOException(L"Error reading file"));
+        }
+        #else
+        if (fd < 0)
+            boost::throw_exception(IOException(L"File already closed"));
+        ssize_t readCount;
+        do
+        {
+            readCount = ::pread(fd, b + offset, (size_t)length, (off_t)position);
+        }
+        while (readCount < 0 && errno == EINTR);
+        if (readCount < 0)
+            boost::throw_exception(IOException(L"Error reading file"));
+        #endif
+        return readCount == 0 ? FILE_EOF : (int32_t)readCount;
+    }
+    
+    void PositionalInputFile::readFully(uint8_t* b, int32_t offset, int32_t length, int64_t position)
+    {
+        int32_t total = 0;
+        while (total < length)
+        {
+            int32_t i = read(b, offset + total, length - total, position + total);
+            if (i == FILE_EOF)
+                boost::throw_exception(IOException(L"Read past EOF"));
+            total += i;
+        }
+    }
+    
+    #if !defined(_WIN32) && !defined(_WIN64)
+    int32_t PositionalInputFile::getDescriptor()
+    {
+        return fd;
+    }
+    #endif
+    
+    void PositionalInputFile::close()
+    {
+        #if defined(_WIN32) || defined(_WIN64)
+        if (handle != NULL)
+        {
+            ::CloseHandle((HANDLE)handle);
+            handle = NULL;
+        }
+        #else
+        if (fd >= 0)
+        {
+            ::close(fd);
+            fd = -1;
+        }
+        #endif
+    }
+    
+    bool PositionalInputFile::isValid()
+    {
+        #if defined(_WIN32) || defined(_WIN64)
+        return (handle != NULL);
+        #else
+        return (fd >= 0);
+        #endif
+    }
+    
+    NIOFSIndexInput::NIOFSIndexInput()
+    {
+        this->chunkSize = 0;
+        this->isClone = false;
+        this->off = 0;
+        this->end = 0;
+    }
+    
+    NIOFSIndexInput::NIOFSIndexInput(const String& path, int32_t bufferSize, int32_t chunkSize) : BufferedIndexInput(bufferSize)
+    {
+        this->file = newLucene<PositionalInputFile>(path);
+        this->chunkSize = chunkSize;
+        this->isClone = false;
+        this->off = 0;
+        this->end = file->getLength();
+    }
+    
+    NIOFSIndexInput::~NIOFSIndexInput()
+    {
+    }
+    
+    void NIOFSIndexInput::readInternal(uint8_t* b, int32_t offset, int32_t length)
+    {
+        // no locking required, each read is issued at an absolute position
+        int64_t position = off + getFilePointer();
+        if (position + length > end)
+            boost::throw_exception(IOException(L"Read past EOF"));
+        int32_t total = 0;
+        
+        while (total < length)
+        {
+            int32_t readLength = std::min(length - total, chunkSize);
+            
+            int32_t i = file->read(b, offset + total, readLength, position + total);
+            if (i == PositionalInputFile::FILE_EOF)
+                boost::throw_exception(IOException(L"Read past EOF"));
+            total += i;
+        }
+    }
+    
+    void NIOFSIndexInput::seekInternal(int64_t pos)
+    {
+    }
+    
+    int64_t NIOFSIndexInput::length()
+    {
+        return end - off;
+    }
+    
+    void NIOFSIndexInput::close()
+    {
+        if (!isClone)
+            file->close();
+    }
+    
+    bool NIOFSIndexInput::isValid()
+    {
+        return file->isValid();
+    }
+    
+    void NIOFSIndexInput::submitReads(ReadBatchPtr batch)
+    {
+        if (batch->size() == 0)
+            return;
+        for (int32_t i = 0; i < batch->size(); ++i)
+        {
+            if (batch->getPosition(i) < 0 || batch->getPosition(i) + batch->getBytes(i).size() > end - off)
+                boost::throw_exception(IOException(L"Read past EOF"));
+        }
+        #ifdef LPP_HAVE_IO_URING
+        IOUringReadCompletionPtr ring(newLucene<IOUringReadCompletion>(file, batch, off));
+        if (ring->submit())
+        {
+            batch->setCompletion(ring);
+            return;
+        }
+        #endif
+        batch->setCompletion(newLucene<ThreadPoolReadCompletion>(file, batch, off));
+    }
+    
+    LuceneObjectPtr NIOFSIndexInput::clone(LuceneObjectPtr other)
+    {
+        LuceneObjectPtr clone = BufferedIndexInput::clone(other ? other : newLucene<NIOFSIndexInput>());
+        NIOFSIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<NIOFSIndexInput>(clone));
+        cloneIndexInput->file = file;
+        cloneIndexInput->chunkSize = chunkSize;
+        cloneIndexInput->isClone = true;
+        cloneIndexInput->off = off;
+        cloneIndexInput->end = end;
+        return cloneIndexInput;
+    }
+    
+    IndexInputPtr NIOFSIndexInput::slice(int64_t offset, int64_t length)
+    {
+        checkSlice(offset, length);
+        NIOFSIndexInputPtr slice(boost::dynamic_pointer_cast<NIOFSIndexInput>(clone()));
+        slice->off = off + offset;
+        slice->end = slice->off + length;
+        slice->seek(0);
+        return slice;
+    }
+    
+    ThreadPoolReadCompletion::ThreadPoolReadCompletion(PositionalInputFilePtr file, ReadBatchPtr batch, int64_t offset)
+    {
+        ThreadPoolPtr threadPool(ThreadPool::getInstance());
+        reads = Collection<FuturePtr>::newInstance(batch->size());
+        for (int32_t i = 0; i < batch->size(); ++i)
+            reads[i] = threadPool->scheduleTask(boost::protect(boost::bind<bool>(&ThreadPoolReadCompletion::read, file, batch->getBytes(i), offset + batch->getPosition(i))));
+    }
+    
+    ThreadPoolReadCompletion::~ThreadPoolReadCompletion()
+    {
+    }
+    
+    bool ThreadPoolReadCompletion::read(PositionalInputFilePtr file, ByteArray bytes, int64_t position)
+    {
+        try
+        {
+            file->readFully(bytes.get(), 0, bytes.size(), position);
+            return true;
+        }
+        catch (...)
+        {
+            return false;
+        }
+    }
+    
+    void ThreadPoolReadCompletion::waitForCompletion()
+    {
+        bool success = true;
+        for (Collection<FuturePtr>::iterator read = reads.begin(); read != reads.end(); ++read)
+        {
+            if (!(*read)->get<bool>())
+                success = false;
+        }
+        reads.clear();
+        if (!success)
+            boost::throw_exception(IOException(L"Error reading file"));
+    }
+    
+    #ifdef LPP_HAVE_IO_URING
+    /// Maximum number of reads kept in flight by a single ring.
+    static const uint32_t IO_URING_MAX_ENTRIES = 64;
+    
+    IOUringReadCompletion::IOUringReadCompletion(PositionalInputFilePtr file, ReadBatchPtr batch, int64_t offset)
+    {
+        this->file = file;
+        positions = Collection<int64_t>::newInstance(batch->size());
+        buffers = Collection<ByteArray>::newInstance(batch->size());
+        for (int32_t i = 0; i < batch->size(); ++i)
+        {
+            positions[i] = offset + batch->getPosition(i);
+            buffers[i] = batch->getBytes(i);
+        }
+        submitted = 0;
+        completed = 0;
+        failed = false;
+        ringFd = -1;
+        entries = 0;
+        sqRing = MAP_FAILED;
+        sqRingSize = 0;
+        cqRing = MAP_FAILED;
+        cqRingSize = 0;
+        sqes = MAP_FAILED;
+        sqesSize = 0;
+        sqHead = NULL;
+        sqTail = NULL;
+        sqMask = NULL;
+        sqArray = NULL;
+        cqHead = NULL;
+        cqTail = NULL;
+        cqMask = NULL;
+        cqes = NULL;
+    }
+    
+    IOUringReadCompletion::~IOUringReadCompletion()
+    {
+        // the kernel may still be writing into our buffers, so drain the ring before releasing it
+        try
+        {
+            waitForCompletion();
+        }
+        catch (...)
+        {
+        }
+    }
+    
+    bool IOUringReadCompletion::submit()
+    {
+        if (!setupRing())
+            return false;
+        if (!submitPending(false))
+        {
+            // nothing reached the kernel, so it's safe to give up and let the caller fall back
+            closeRing();
+            return false;
+        }
+        return true;
+    }
+    
+    bool IOUringReadCompletion::setupRing()
+    {
+        struct io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        
+        ringFd = (int32_t)::syscall(__NR_io_uring_setup, std::min((uint32_t)positions.size(), IO_URING_MAX_ENTRIES), &params);
+        if (ringFd < 0)
+            return false; // not supported by this kernel, or not permitted
+        
+        entries = params.sq_entries;
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+        
+        bool singleMap = ((params.features & IORING_FEAT_SINGLE_MMAP) != 0);
+        if (singleMap)
+            sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+        
+        sqRing = ::mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        if (sqRing != MAP_FAILED)
+            cqRing = singleMap ? sqRing : ::mmap(NULL, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        if (cqRing != MAP_FAILED)
+            sqes = ::mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            closeRing();
+            return false;
+        }
+        
+        sqHead = (uint32_t*)((uint8_t*)sqRing + params.sq_off.head);
+        sqTail = (uint32_t*)((uint8_t*)sqRing + params.sq_off.tail);
+        sqMask = (uint32_t*)((uint8_t*)sqRing + params.sq_off.ring_mask);
+        sqArray = (uint32_t*)((uint8_t*)sqRing + params.sq_off.array);
+        cqHead = (uint32_t*)((uint8_t*)cqRing + params.cq_off.head);
+        cqTail = (uint32_t*)((uint8_t*)cqRing + params.cq_off.tail);
+        cqMask = (uint32_t*)((uint8_t*)cqRing + params.cq_off.ring_mask);
+        cqes = (uint8_t*)cqRing + params.cq_off.cqes;
+        return true;
+    }
+    
+    void IOUringReadCompletion::closeRing()
+    {
+        if (sqes != MAP_FAILED)
+            ::munmap(sqes, sqesSize);
+        if (cqRing != MAP_FAILED && cqRing != sqRing)
+            ::munmap(cqRing, cqRingSize);
+        if (sqRing != MAP_FAILED)
+            ::munmap(sqRing, sqRingSize);
+        if (ringFd >= 0)
+            ::close(ringFd);
+        sqes = MAP_FAILED;
+        cqRing = MAP_FAILED;
+        sqRing = MAP_FAILED;
+        ringFd = -1;
+    }
+    
+    bool IOUringReadCompletion::submitPending(bool wait)
+    {
+        // we are the only producer, so the tail can be read without synchronization
+        uint32_t tail = *sqTail;
+        while (submitted < positions.size() && (uint32_t)(submitted - completed) < entries)
+        {
+            uint32_t index = tail & *sqMask;
+            struct io_uring_sqe* sqe = (struct io_uring_sqe*)sqes + index;
+            std::memset(sqe, 0, sizeof(struct io_uring_sqe));
+            sqe->opcode = IORING_OP_READ;
+            sqe->fd = file->getDescriptor();
+            sqe->off = (uint64_t)positions[submitted];
+            sqe->addr = (uint64_t)(uintptr_t)buffers[submitted].get();
+            sqe->len = (uint32_t)buffers[submitted].size();
+            sqe->user_data = (uint64_t)submitted;
+            sqArray[index] = index;
+            ++tail;
+            ++submitted;
+        }
+        __atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+        
+        uint32_t toSubmit = tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        uint32_t minComplete = wait ? 1 : 0;
+        uint32_t flags = wait ? IORING_ENTER_GETEVENTS : 0;
+        if (toSubmit == 0 && !wait)
+            return true;
+        while (true)
+        {
+            int32_t result = (int32_t)::syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, NULL, 0);
+            if (result >= 0)
+                return true;
+            if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+                return false;
+        }
+    }
+    
+    void IOUringReadCompletion::reapCompletions()
+    {
+        uint32_t head = *cqHead;
+        uint32_t tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        while (head != tail)
+        {
+            struct io_uring_cqe* cqe = (struct io_uring_cqe*)cqes + (head & *cqMask);
+            complete((int32_t)cqe->user_data, cqe->res);
+            ++head;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+    
+    void IOUringReadCompletion::complete(int32_t index, int32_t result)
+    {
+        ++completed;
+        if (failed)
+            return;
+        ByteArray bytes(buffers[index]);
+        try
+        {
+            if (result == -EINVAL || result == -EOPNOTSUPP)
+                file->readFully(bytes.get(), 0, bytes.size(), positions[index]); // opcode not supported by this kernel
+            else if (result < 0)
+                failed = true;
+            else if (result < bytes.size())
+                file->readFully(bytes.get(), result, bytes.size() - result, positions[index] + result); // short read
+        }
+        catch (...)
+        {
+            failed = true;
+        }
+    }
+    
+    void IOUringReadCompletion::waitForCompletion()
+    {
+        if (ringFd < 0)
+            return;
+        bool ringFailed = false;
+        while (completed < positions.size() && !ringFailed)
+        {
+            reapCompletions();
+            if (completed < positions.size())
+                ringFailed = !submitPending(true);
+        }
+        closeRing();
+        if (ringFailed)
+        {
+            // reads that were in flight are lost, but anything never handed to the kernel can be read directly
+            if (completed < submitted)
+                failed = true;
+            for (; submitted < positions.size() && !failed; ++submitted)
+            {
+                try
+                {
+                    file->readFully(buffers[submitted].get(), 0, buffers[submitted].size(), positions[submitted]);
+                }
+                catch (...)
+                {
+                    failed = true;
+                }
+            }
+            completed = submitted = positions.size();
+        }
+        if (failed)
+            boost::throw_exception(IOException(L"Error reading file"));
+    }
+    #endif
+}
@@ -0,0 +1,251 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "NRTCachingDirectory.h"
+#include "_NRTCachingDirectory.h"
+#include "RAMDirectory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "IndexFileNames.h"
+#include "MergePolicy.h"
+#include "SegmentInfos.h"
+#include "SegmentInfo.h"
+#include "LuceneThread.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    NRTCachingDirectory::NRTCachingDirectory(DirectoryPtr delegate, double maxMergeSizeMB, double maxCachedMB)
+    {
+        this->cache = newLucene<RAMDirectory>();
+        this->delegate = delegate;
+        this->maxMergeSizeBytes = (int64_t)(maxMergeSizeMB * 1024.0 * 1024.0);
+        this->maxCachedBytes = (int64_t)(maxCachedMB * 1024.0 * 1024.0);
+        this->uncacheLock = newInstance<Synchronize>();
+        this->lockFactory = delegate->getLockFactory();
+    }
+    
+    NRTCachingDirectory::~NRTCachingDirectory()
+    {
+    }
+    
+    DirectoryPtr NRTCachingDirectory::getDelegate()
+    {
+        return delegate;
+    }
+    
+    HashSet<String> NRTCachingDirectory::listCachedFiles()
+    {
+        return cache->listAll();
+    }
+    
+    int64_t NRTCachingDirectory::sizeInBytes()
+    {
+        return cache->sizeInBytes();
+    }
+    
+    MergeSchedulerPtr NRTCachingDirectory::getMergeScheduler()
+    {
+        SyncLock syncLock(this);
+        if (!mergeScheduler)
+            mergeScheduler = newLucene<NRTCachingMergeScheduler>();
+        return mergeScheduler;
+    }
+    
+    HashSet<String> NRTCachingDirectory::listAll()
+    {
+        SyncLock syncLock(this);
+        HashSet<String> cachedFiles(cache->listAll());
+        HashSet<String> delegateFiles(delegate->listAll());
+        HashSet<String> files(HashSet<String>::newInstance(cachedFiles.begin(), cachedFiles.end()));
+        files.addAll(delegateFiles.begin(), delegateFiles.end());
+        return files;
+    }
+    
+    bool NRTCachingDirectory::fileExists(const String& name)
+    {
+        SyncLock syncLock(this);
+        return cache->fileExists(name) || delegate->fileExists(name);
+    }
+    
+    uint64_t NRTCachingDirectory::fileModified(const String& name)
+    {
+        SyncLock syncLock(this);
+        return cache->fileExists(name) ? cache->fileModified(name) : delegate->fileModified(name);
+    }
+    
+    void NRTCachingDirectory::touchFile(const String& name)
+    {
+        SyncLock syncLock(this);
+        if (cache->fileExists(name))
+            cache->touchFile(name);
+        else
+            delegate->touchFile(name);
+    }
+    
+    void NRTCachingDirectory::deleteFile(const String& name)
+    {
+        SyncLock syncLock(this);
+        if (cache->fileExists(name))
+            cache->deleteFile(name);
+        else
+            delegate->deleteFile(name);
+    }
+    
+    int64_t NRTCachingDirectory::fileLength(const String& name)
+    {
+        SyncLock syncLock(this);
+        return cache->fileExists(name) ? cache->fileLength(name) : delegate->fileLength(name);
+    }
+    
+    IndexOutputPtr NRTCachingDirectory::createOutput(const String& name)
+    {
+        SyncLock syncLock(this);
+        if (doCacheWrite(name))
+        {
+            if (delegate->fileExists(name))
+                delegate->deleteFile(name);
+            return cache->createOutput(name);
+        }
+        else
+        {
+            if (cache->fileExists(name))
+                cache->deleteFile(name);
+            return delegate->createOutput(name);
+        }
+    }
+    
+    void NRTCachingDirectory::sync(const String& name)
+    {
+        unCache(name);
+        delegate->sync(name);
+    }
+    
+    IndexInputPtr NRTCachingDirectory::openInput(const String& name)
+    {
+        SyncLock syncLock(this);
+        return cache->fileExists(name) ? cache->openInput(name) : delegate->openInput(name);
+    }
+    
+    IndexInputPtr NRTCachingDirectory::openInput(const String& name, int32_t bufferSize)
+    {
+        SyncLock syncLock(this);
+        return cache->fileExists(name) ? cache->openInput(name) : delegate->openInput(name, bufferSize);
+    }
+    
+    String NRTCachingDirectory::getLockID()
+    {
+        return delegate->getLockID();
+    }
+    
+    void NRTCachingDirectory::close()
+    {
+        HashSet<String> cachedFiles(cache->listAll());
+        for (HashSet<String>::iterator file = cachedFiles.begin(); file != cachedFiles.end(); ++file)
+            unCache(*file);
+        cache->close();
+        delegate->close();
+    }
+    
+    String NRTCachingDirectory::toString()
+    {
+        return L"NRTCachingDirectory(" + delegate->toString() + L"; maxCacheMB=" + 
+               StringUtils::toString((double)maxCachedBytes / 1024.0 / 1024.0) + L" maxMergeSizeMB=" + 
+               StringUtils::toString((double)maxMergeSizeBytes / 1024.0 / 1024.0) + L")";
+    }
+    
+    bool NRTCachingDirectory::doCacheWrite(const String& name)
+    {
+        // segments.gen is never synced, so must go straight to the delegate
+        if (name == IndexFileNames::SEGMENTS_GEN())
+            return false;
+        if (cache->sizeInBytes() > maxCachedBytes)
+            return false;
+        OneMergePtr merge;
+        {
+            SyncLock syncLock(this);
+            if (mergeScheduler)
+                merge = mergeScheduler->getCurrentMerge();
+        }
+        if (merge)
+        {
+            int64_t mergeSizeBytes = 0;
+            for (int32_t i = 0; i < merge->segments->size(); ++i)
+                mergeSizeBytes += merge->segments->info(i)->sizeInBytes();
+            if (mergeSizeBytes > maxMergeSizeBytes)
+                return false;
+        }
+        return true;
+    }
+    
+    void NRTCachingDirectory::unCache(const String& name)
+    {
+        // Only let one thread uncache at a time; this only happens during commit or close
+        SyncLock uncacheSyncLock(uncacheLock);
+        if (!cache->fileExists(name))
+            return;
+        if (delegate->fileExists(name))
+            boost::throw_exception(IOException(L"Cannot uncache file \"" + name + L"\": it was separately also created in the delegate directory"));
+        IndexOutputPtr output(delegate->createOutput(name));
+        IndexInputPtr input;
+        LuceneException finally;
+        try
+        {
+            input = cache->openInput(name);
+            output->copyBytes(input, input->length());
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        if (input)
+            input->close();
+        output->close();
+        finally.throwException();
+        
+        // lock order: uncacheLock -> this
+        SyncLock syncLock(this);
+        cache->deleteFile(name);
+    }
+    
+    NRTCachingMergeScheduler::NRTCachingMergeScheduler()
+    {
+        merges = HashMap<int64_t, OneMergePtr>::newInstance();
+    }
+    
+    NRTCachingMergeScheduler::~NRTCachingMergeScheduler()
+    {
+    }
+    
+    OneMergePtr NRTCachingMergeScheduler::getCurrentMerge()
+    {
+        SyncLock syncLock(this);
+        return merges.get(LuceneThread::currentId());
+    }
+    
+    void NRTCachingMergeScheduler::doMerge(OneMergePtr merge)
+    {
+        {
+            SyncLock syncLock(this);
+            merges.put(LuceneThread::currentId(), merge);
+        }
+        LuceneException finally;
+        try
+        {
+            ConcurrentMergeScheduler::doMerge(merge);
+        }
+        catch (LuceneException& e)
+        {
+            finally = e;
+        }
+        {
+            SyncLock syncLock(this);
+            merges.remove(LuceneThread::currentId());
+        }
+        finally.throwException();
+    }
+}
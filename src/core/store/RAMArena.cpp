@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "RAMArena.h"
+#include "BitUtil.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    const int32_t RAMArena::DEFAULT_SLAB_SIZE = 1 << 20;
+    const int32_t RAMArena::MAX_FREE_SLABS = 16;
+    
+    RAMArena::RAMArena(int32_t slabSize)
+    {
+        if (slabSize < 2 || slabSize > (1 << 30))
+            boost::throw_exception(IllegalArgumentException(L"slabSize must be between 2 and 2^30"));
+        this->slabSize = BitUtil::nextHighestPowerOfTwo(slabSize);
+        this->slabSizePower = 0;
+        while ((1 << slabSizePower) < this->slabSize)
+            ++slabSizePower;
+        this->freeSlabs = Collection<ByteArray>::newInstance();
+        this->tailSlabUpto = 0;
+        this->numSlabsAllocated = 0;
+    }
+    
+    RAMArena::~RAMArena()
+    {
+    }
+    
+    int32_t RAMArena::getSlabSize()
+    {
+        return slabSize;
+    }
+    
+    int32_t RAMArena::getSlabSizePower()
+    {
+        return slabSizePower;
+    }
+    
+    int64_t RAMArena::getNumSlabsAllocated()
+    {
+        SyncLock syncLock(this);
+        return numSlabsAllocated;
+    }
+    
+    ByteArray RAMArena::newSlab()
+    {
+        SyncLock syncLock(this);
+        if (!freeSlabs.empty())
+            return freeSlabs.removeLast();
+        ++numSlabsAllocated;
+        return ByteArray::newInstance(slabSize);
+    }
+    
+    void RAMArena::releaseSlab(ByteArray slab)
+    {
+        SyncLock syncLock(this);
+        if (freeSlabs.size() < MAX_FREE_SLABS)
+            freeSlabs.add(slab);
+    }
+    
+    ByteArray RAMArena::packTail(const uint8_t* bytes, int32_t length, int32_t& offset)
+    {
+        SyncLock syncLock(this);
+        if (!tailSlab || length > slabSize - tailSlabUpto)
+        {
+            // the rest of the current tail slab is left unused; it stays alive while files refer to it
+            ++numSlabsAllocated;
+            tailSlab = ByteArray::newInstance(slabSize);
+            tailSlabUpto = 0;
+        }
+        offset = tailSlabUpto;
+        MiscUtils::arrayCopy(bytes, 0, tailSlab.get(), offset, length);
+        tailSlabUpto += length;
+        return tailSlab;
+    }
+}
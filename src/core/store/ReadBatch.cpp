@@ -0,0 +1,68 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "ReadBatch.h"
+
+namespace Lucene
+{
+    ReadBatch::ReadBatch()
+    {
+        positions = Collection<int64_t>::newInstance();
+        buffers = Collection<ByteArray>::newInstance();
+    }
+    
+    ReadBatch::~ReadBatch()
+    {
+    }
+    
+    int32_t ReadBatch::add(int64_t position, int32_t length)
+    {
+        if (completion)
+            boost::throw_exception(IllegalStateException(L"Cannot add to a batch that has already been submitted"));
+        positions.add(position);
+        buffers.add(ByteArray::newInstance(length));
+        return positions.size() - 1;
+    }
+    
+    int32_t ReadBatch::size()
+    {
+        return positions.size();
+    }
+    
+    int64_t ReadBatch::getPosition(int32_t index)
+    {
+        return positions[index];
+    }
+    
+    int32_t ReadBatch::getLength(int32_t index)
+    {
+        return buffers[index].size();
+    }
+    
+    ByteArray ReadBatch::getBytes(int32_t index)
+    {
+        return buffers[index];
+    }
+    
+    void ReadBatch::setCompletion(ReadCompletionPtr completion)
+    {
+        this->completion = completion;
+    }
+    
+    void ReadBatch::waitForCompletion()
+    {
+        if (!completion)
+            return;
+        ReadCompletionPtr pending(completion);
+        completion.reset();
+        pending->waitForCompletion();
+    }
+    
+    ReadCompletion::~ReadCompletion()
+    {
+    }
+}
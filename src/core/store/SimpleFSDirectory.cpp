@@ -106,6 +106,8 @@ namespace Lucene
     {
         this->chunkSize = 0;
         this->isClone = false;
+        this->off = 0;
+        this->end = 0;
     }
     
     SimpleFSIndexInput::SimpleFSIndexInput(const String& path, int32_t bufferSize, int32_t chunkSize) : BufferedIndexInput(bufferSize)
@@ -114,6 +116,8 @@ namespace Lucene
         this->path = path;
         this->chunkSize = chunkSize;
         this->isClone = false;
+        this->off = 0;
+        this->end = file->getLength();
     }
     
     SimpleFSIndexInput::~SimpleFSIndexInput()
@@ -124,7 +128,9 @@ namespace Lucene
     {
         SyncLock fileLock(file);
         
-        int64_t position = getFilePointer();
+        int64_t position = off + getFilePointer();
+        if (position + length > end)
+            boost::throw_exception(IOException(L"Read past EOF"));
         if (position != file->getPosition())
             file->setPosition(position);
         
@@ -147,7 +153,7 @@ namespace Lucene
     
     int64_t SimpleFSIndexInput::length()
     {
-        return file->getLength();
+        return end - off;
     }
     
     void SimpleFSIndexInput::close()
@@ -169,9 +175,21 @@ namespace Lucene
         cloneIndexInput->file = file;
         cloneIndexInput->chunkSize = chunkSize;
         cloneIndexInput->isClone = true;
+        cloneIndexInput->off = off;
+        cloneIndexInput->end = end;
         return cloneIndexInput;
     }
     
+    IndexInputPtr SimpleFSIndexInput::slice(int64_t offset, int64_t length)
+    {
+        checkSlice(offset, length);
+        SimpleFSIndexInputPtr slice(boost::dynamic_pointer_cast<SimpleFSIndexInput>(clone()));
+        slice->off = off + offset;
+        slice->end = slice->off + length;
+        slice->seek(0);
+        return slice;
+    }
+    
     OutputFile::OutputFile(const String& path)
     {
         this->path = path;
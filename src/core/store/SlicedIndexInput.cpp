@@ -0,0 +1,81 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "SlicedIndexInput.h"
+
+namespace Lucene
+{
+    SlicedIndexInput::SlicedIndexInput()
+    {
+        fileOffset = 0;
+        _length = 0;
+    }
+    
+    SlicedIndexInput::SlicedIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length) : BufferedIndexInput(BufferedIndexInput::BUFFER_SIZE)
+    {
+        this->base = boost::dynamic_pointer_cast<IndexInput>(base->clone());
+        this->fileOffset = fileOffset;
+        this->_length = length;
+    }
+    
+    SlicedIndexInput::SlicedIndexInput(IndexInputPtr base, int64_t fileOffset, int64_t length, int32_t readBufferSize) : BufferedIndexInput(readBufferSize)
+    {
+        this->base = boost::dynamic_pointer_cast<IndexInput>(base->clone());
+        this->fileOffset = fileOffset;
+        this->_length = length;
+    }
+    
+    SlicedIndexInput::~SlicedIndexInput()
+    {
+    }
+    
+    void SlicedIndexInput::readInternal(uint8_t* b, int32_t offset, int32_t length)
+    {
+        int64_t start = getFilePointer();
+        if (start + length > _length)
+            boost::throw_exception(IOException(L"read past EOF"));
+        base->seek(fileOffset + start);
+        base->readBytes(b, offset, length, false);
+    }
+    
+    void SlicedIndexInput::seekInternal(int64_t pos)
+    {
+    }
+    
+    void SlicedIndexInput::close()
+    {
+        base->close();
+    }
+    
+    int64_t SlicedIndexInput::length()
+    {
+        return _length;
+    }
+    
+    IndexInputPtr SlicedIndexInput::slice(int64_t offset, int64_t length)
+    {
+        checkSlice(offset, length);
+        return newLucene<SlicedIndexInput>(base, fileOffset + offset, length, bufferSize);
+    }
+    
+    const uint8_t* SlicedIndexInput::mappedBytes(int64_t pos, int64_t length)
+    {
+        if (pos < 0 || length < 0 || pos + length > _length)
+            return NULL;
+        return base->mappedBytes(fileOffset + pos, length);
+    }
+    
+    LuceneObjectPtr SlicedIndexInput::clone(LuceneObjectPtr other)
+    {
+        LuceneObjectPtr clone = other ? other : newLucene<SlicedIndexInput>();
+        SlicedIndexInputPtr cloneIndexInput(boost::dynamic_pointer_cast<SlicedIndexInput>(BufferedIndexInput::clone(clone)));
+        cloneIndexInput->base = boost::dynamic_pointer_cast<IndexInput>(this->base->clone());
+        cloneIndexInput->fileOffset = fileOffset;
+        cloneIndexInput->_length = _length;
+        return cloneIndexInput;
+    }
+}
@@ -11,6 +11,8 @@
 #include "IndexOutput.h"
 #include "TestPoint.h"
 #include "MiscUtils.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "RoaringDocIdSet.h"
 
 namespace Lucene
 {
@@ -48,7 +50,9 @@ namespace Lucene
         try
         {
             _size = input->readInt(); // read size
-            if (_size == -1)
+            if (_size == -2)
+                readRoaring(input);
+            else if (_size == -1)
                 readDgaps(input);
             else
                 readBits(input);
@@ -145,14 +149,11 @@ namespace Lucene
     void BitVector::write(DirectoryPtr d, const String& name)
     {
         TestScope testScope(L"BitVector", L"write");
-        IndexOutputPtr output(d->createOutput(name));
+        IndexOutputPtr output(newLucene<ChecksumFooterIndexOutput>(d->createOutput(name)));
         LuceneException finally;
         try
         {
-            if (isSparse())
-                writeDgaps(output); // sparse bit-set more efficiently saved as d-gaps.
-            else
-                writeBits(output);
+            writeRoaring(output);
         }
         catch (LuceneException& e)
         {
@@ -162,52 +163,25 @@ namespace Lucene
         finally.throwException();
     }
     
-    void BitVector::writeBits(IndexOutputPtr output)
-    {
-        output->writeInt(size()); // write size
-        output->writeInt(count()); // write count
-        output->writeBytes(bits.get(), bits.size());
-    }
-    
-    void BitVector::writeDgaps(IndexOutputPtr output)
+    void BitVector::writeRoaring(IndexOutputPtr output)
     {
-        output->writeInt(-1); // mark using d-gaps
-        output->writeInt(size()); // write size
-        output->writeInt(count()); // write count
-        int32_t last = 0;
-        int32_t n = count();
-        int32_t m = bits.size();
-        for (int32_t i = 0; i < m && n > 0; ++i)
+        RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>());
+        for (int32_t i = 0; i < bits.size(); ++i)
         {
             if (bits[i] != 0)
             {
-                output->writeVInt(i-last);
-                output->writeByte(bits[i]);
-                last = i;
-                n -= BYTE_COUNTS[bits[i] & 0xff];
+                for (int32_t bit = 0; bit < 8; ++bit)
+                {
+                    if ((bits[i] & (1 << bit)) != 0)
+                        set->set((i << 3) + bit);
+                }
             }
         }
-    }
-    
-    bool BitVector::isSparse()
-    {
-        // note: order of comparisons below set to favor smaller values (no binary range search.)
-        // note: adding 4 because we start with ((int) -1) to indicate d-gaps format.
-        // note: we write the d-gap for the byte number, and the byte (bits[i]) itself, therefore
-        //       multiplying count by (8+8) or (8+16) or (8+24) etc.:
-        //       - first 8 for writing bits[i] (1 byte vs. 1 bit), and 
-        //       - second part for writing the byte-number d-gap as vint. 
-        // note: factor is for read/write of byte-arrays being faster than vints.
-        int32_t factor = 10;
-        if (bits.size() < (1 << 7))
-            return factor * (4 + (8 + 8) * count()) < size();
-        if (bits.size() < (1 << 14))
-            return factor * (4 + (8 + 16) * count()) < size();
-        if (bits.size() < (1 << 21))
-            return factor * (4 + (8 + 24) * count()) < size();
-        if (bits.size() < (1 << 28))
-            return factor * (4 + (8 + 32) * count()) < size();
-        return factor * (4 + (8 + 40) * count()) < size();
+        set->optimize();
+        output->writeInt(-2); // mark using roaring containers
+        output->writeInt(size()); // write size
+        output->writeInt(count()); // write count
+        set->write(output);
     }
     
     void BitVector::readBits(IndexInputPtr input)
@@ -234,6 +208,18 @@ namespace Lucene
         }
     }
     
+    void BitVector::readRoaring(IndexInputPtr input)
+    {
+        _size = input->readInt(); // (re)read size
+        _count = input->readInt(); // read count
+        bits = ByteArray::newInstance((_size >> 3) + 1); // allocate bits
+        MiscUtils::arrayFill(bits.get(), 0, bits.size(), 0);
+        DocIdSetIteratorPtr docs(RoaringDocIdSet::read(input)->iterator());
+        int32_t doc;
+        while ((doc = docs->nextDoc()) != DocIdSetIterator::NO_MORE_DOCS)
+            bits[doc >> 3] |= 1 << (doc & 7);
+    }
+    
     BitVectorPtr BitVector::subset(int32_t start, int32_t end)
     {
         if (start < 0 || end > size() || end < start)
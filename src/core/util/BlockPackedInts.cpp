@@ -0,0 +1,246 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "BlockPackedInts.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "StringUtils.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LPP_BLOCKPACKED_SSE2
+#endif
+
+namespace Lucene
+{
+    const int32_t BlockPackedInts::BLOCK_SIZE = 128;
+
+    /// Number of interleaved lanes; one 128 bit register holds a word of each.
+    static const int32_t LANES = 4;
+
+    /// Number of values in each lane of a block.
+    static const int32_t LANE_VALUES = 32;
+
+    BlockPackedInts::BlockPackedInts()
+    {
+        packed = IntArray::newInstance(BLOCK_SIZE);
+        bytes = ByteArray::newInstance(BLOCK_SIZE * 4);
+        bitsRequired = IntArray::newInstance(BLOCK_SIZE);
+    }
+
+    BlockPackedInts::~BlockPackedInts()
+    {
+    }
+
+    int32_t BlockPackedInts::bitsRequiredFor(uint32_t value)
+    {
+        int32_t bits = 0;
+        while (value != 0)
+        {
+            ++bits;
+            value >>= 1;
+        }
+        return bits;
+    }
+
+    void BlockPackedInts::writeBlock(IndexOutputPtr out, const int32_t* values)
+    {
+        int32_t maxBits = 0;
+        for (int32_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            if (values[i] < 0)
+                boost::throw_exception(IllegalArgumentException(L"cannot pack negative value: " + StringUtils::toString(values[i])));
+            bitsRequired[i] = bitsRequiredFor((uint32_t)values[i]);
+            maxBits = std::max(maxBits, bitsRequired[i]);
+        }
+
+        // pick the width that minimizes packed size plus the cost of the values that don't fit
+        int32_t bitsPerValue = maxBits;
+        int32_t bestCost = INT_MAX;
+        for (int32_t bits = maxBits; bits >= 0; --bits)
+        {
+            int32_t cost = bits * LANES * 4;
+            int32_t numExceptions = 0;
+            for (int32_t i = 0; i < BLOCK_SIZE && cost < bestCost; ++i)
+            {
+                if (bitsRequired[i] > bits)
+                {
+                    cost += 1 + (bitsRequired[i] - bits + 6) / 7;
+                    ++numExceptions;
+                }
+            }
+            if (cost < bestCost && numExceptions < BLOCK_SIZE)
+            {
+                bestCost = cost;
+                bitsPerValue = bits;
+            }
+        }
+
+        int32_t numExceptions = 0;
+        for (int32_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            if (bitsRequired[i] > bitsPerValue)
+                ++numExceptions;
+        }
+
+        out->writeByte((uint8_t)bitsPerValue);
+        out->writeByte((uint8_t)numExceptions);
+
+        if (bitsPerValue > 0)
+        {
+            uint32_t* words = (uint32_t*)packed.get();
+            pack((const uint32_t*)values, words, bitsPerValue);
+            int32_t numWords = bitsPerValue * LANES;
+            for (int32_t i = 0; i < numWords; ++i)
+            {
+                bytes[i * 4] = (uint8_t)words[i];
+                bytes[i * 4 + 1] = (uint8_t)(words[i] >> 8);
+                bytes[i * 4 + 2] = (uint8_t)(words[i] >> 16);
+                bytes[i * 4 + 3] = (uint8_t)(words[i] >> 24);
+            }
+            out->writeBytes(bytes.get(), numWords * 4);
+        }
+
+        for (int32_t i = 0; i < BLOCK_SIZE; ++i)
+        {
+            if (bitsRequired[i] > bitsPerValue)
+            {
+                out->writeByte((uint8_t)i);
+                out->writeVInt((int32_t)((uint32_t)values[i] >> bitsPerValue));
+            }
+        }
+    }
+
+    void BlockPackedInts::readBlock(IndexInputPtr in, int32_t* values)
+    {
+        int32_t bitsPerValue = in->readByte();
+        int32_t numExceptions = in->readByte();
+        if (bitsPerValue > 32 || numExceptions >= BLOCK_SIZE)
+        {
+            boost::throw_exception(CorruptIndexException(L"invalid packed block: bitsPerValue=" + StringUtils::toString(bitsPerValue) +
+                                                         L" numExceptions=" + StringUtils::toString(numExceptions)));
+        }
+
+        if (bitsPerValue == 0)
+            std::fill(values, values + BLOCK_SIZE, 0);
+        else
+        {
+            int32_t numWords = bitsPerValue * LANES;
+            in->readBytes(bytes.get(), 0, numWords * 4);
+            uint32_t* words = (uint32_t*)packed.get();
+            const uint8_t* b = bytes.get();
+            for (int32_t i = 0; i < numWords; ++i, b += 4)
+                words[i] = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+            unpack(words, (uint32_t*)values, bitsPerValue);
+        }
+
+        for (int32_t i = 0; i < numExceptions; ++i)
+        {
+            int32_t index = in->readByte();
+            if (index >= BLOCK_SIZE || bitsPerValue >= 32)
+                boost::throw_exception(CorruptIndexException(L"invalid packed block exception"));
+            values[index] |= (int32_t)((uint32_t)in->readVInt() << bitsPerValue);
+        }
+    }
+
+    void BlockPackedInts::pack(const uint32_t* values, uint32_t* packed, int32_t bitsPerValue)
+    {
+        uint32_t mask = bitsPerValue == 32 ? 0xffffffff : ((1u << bitsPerValue) - 1);
+        for (int32_t lane = 0; lane < LANES; ++lane)
+        {
+            uint32_t* out = packed + lane;
+            uint32_t word = 0;
+            int32_t shift = 0;
+            for (int32_t i = 0; i < LANE_VALUES; ++i)
+            {
+                uint32_t value = values[i * LANES + lane] & mask;
+                word |= value << shift;
+                shift += bitsPerValue;
+                if (shift >= 32)
+                {
+                    *out = word;
+                    out += LANES;
+                    shift -= 32;
+                    word = shift > 0 ? (value >> (bitsPerValue - shift)) : 0;
+                }
+            }
+        }
+    }
+
+    void BlockPackedInts::unpack(const uint32_t* packed, uint32_t* values, int32_t bitsPerValue)
+    {
+        // each lane holds 32 * bitsPerValue bits, so a lane always ends on a word boundary
+        #ifdef LPP_BLOCKPACKED_SSE2
+        const __m128i mask = _mm_set1_epi32(bitsPerValue == 32 ? -1 : (int32_t)((1u << bitsPerValue) - 1));
+        const __m128i* in = (const __m128i*)packed;
+        __m128i word = _mm_loadu_si128(in);
+        int32_t shift = 0;
+        for (int32_t i = 0; i < LANE_VALUES; ++i)
+        {
+            __m128i value = _mm_srl_epi32(word, _mm_cvtsi32_si128(shift));
+            shift += bitsPerValue;
+            if (shift >= 32)
+            {
+                shift -= 32;
+                ++in;
+                if (i < LANE_VALUES - 1)
+                    word = _mm_loadu_si128(in);
+                if (shift > 0)
+                    value = _mm_or_si128(value, _mm_sll_epi32(word, _mm_cvtsi32_si128(bitsPerValue - shift)));
+            }
+            _mm_storeu_si128((__m128i*)(values + i * LANES), _mm_and_si128(value, mask));
+        }
+        #else
+        uint32_t mask = bitsPerValue == 32 ? 0xffffffff : ((1u << bitsPerValue) - 1);
+        for (int32_t lane = 0; lane < LANES; ++lane)
+        {
+            const uint32_t* in = packed + lane;
+            uint32_t word = *in;
+            int32_t shift = 0;
+            for (int32_t i = 0; i < LANE_VALUES; ++i)
+            {
+                uint32_t value = word >> shift;
+                shift += bitsPerValue;
+                if (shift >= 32)
+                {
+                    shift -= 32;
+                    in += LANES;
+                    if (i < LANE_VALUES - 1)
+                        word = *in;
+                    if (shift > 0)
+                        value |= word << (bitsPerValue - shift);
+                }
+                values[i * LANES + lane] = value & mask;
+            }
+        }
+        #endif
+    }
+
+    void BlockPackedInts::prefixSum(int32_t* values, int32_t length, int32_t base)
+    {
+        int32_t i = 0;
+        #ifdef LPP_BLOCKPACKED_SSE2
+        __m128i carry = _mm_set1_epi32(base);
+        for (; i + 4 <= length; i += 4)
+        {
+            __m128i value = _mm_loadu_si128((const __m128i*)(values + i));
+            value = _mm_add_epi32(value, _mm_slli_si128(value, 4));
+            value = _mm_add_epi32(value, _mm_slli_si128(value, 8));
+            value = _mm_add_epi32(value, carry);
+            _mm_storeu_si128((__m128i*)(values + i), value);
+            carry = _mm_shuffle_epi32(value, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        if (i > 0)
+            base = values[i - 1];
+        #endif
+        for (; i < length; ++i)
+        {
+            base += values[i];
+            values[i] = base;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "BloomFilter.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "MiscUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    const int32_t BloomFilter::DEFAULT_BITS_PER_VALUE = 10;
+    const int32_t BloomFilter::MAX_HASHES = 16;
+    
+    BloomFilter::BloomFilter(int64_t numBits, int32_t numHashes)
+    {
+        if (numHashes < 1 || numHashes > MAX_HASHES)
+            boost::throw_exception(IllegalArgumentException(L"numHashes must be between 1 and " + StringUtils::toString(MAX_HASHES) + L": got " + StringUtils::toString(numHashes)));
+        int64_t size = 64;
+        while (size < numBits)
+            size <<= 1;
+        bits = LongArray::newInstance((int32_t)(size >> 6));
+        MiscUtils::arrayFill(bits.get(), 0, bits.size(), 0);
+        mask = size - 1;
+        this->numHashes = numHashes;
+    }
+    
+    BloomFilter::~BloomFilter()
+    {
+    }
+    
+    BloomFilterPtr BloomFilter::create(Collection<int64_t> hashes, int32_t bitsPerValue)
+    {
+        int64_t numValues = std::max((int64_t)hashes.size(), (int64_t)1);
+        BloomFilterPtr filter(newLucene<BloomFilter>(numValues * bitsPerValue, 1));
+        
+        // the false positive rate is lowest with ln(2) bits set per value for each bit of the filter per value
+        double bitsPerActualValue = (double)filter->getNumBits() / (double)numValues;
+        filter->numHashes = std::max(1, std::min(MAX_HASHES, (int32_t)(bitsPerActualValue * 0.6931471805599453 + 0.5)));
+        
+        for (Collection<int64_t>::iterator hash = hashes.begin(); hash != hashes.end(); ++hash)
+            filter->add(*hash);
+        return filter;
+    }
+    
+    int64_t BloomFilter::hash(const uint8_t* bytes, int32_t length)
+    {
+        const uint64_t m = 0xc6a4a7935bd1e995ULL;
+        const int32_t r = 47;
+        uint64_t h = 0x9747b28cULL ^ ((uint64_t)length * m);
+        
+        int32_t i = 0;
+        for (; i + 8 <= length; i += 8)
+        {
+            // read little-endian so that the hashes written on any platform agree
+            uint64_t k = (uint64_t)bytes[i] | ((uint64_t)bytes[i + 1] << 8) | ((uint64_t)bytes[i + 2] << 16) | 
+                         ((uint64_t)bytes[i + 3] << 24) | ((uint64_t)bytes[i + 4] << 32) | ((uint64_t)bytes[i + 5] << 40) | 
+                         ((uint64_t)bytes[i + 6] << 48) | ((uint64_t)bytes[i + 7] << 56);
+            k *= m;
+            k ^= k >> r;
+            k *= m;
+            h ^= k;
+            h *= m;
+        }
+        
+        int32_t remaining = length - i;
+        if (remaining > 0)
+        {
+            for (int32_t j = remaining - 1; j >= 0; --j)
+                h ^= (uint64_t)bytes[i + j] << (8 * j);
+            h *= m;
+        }
+        
+        h ^= h >> r;
+        h *= m;
+        h ^= h >> r;
+        return (int64_t)h;
+    }
+    
+    void BloomFilter::add(int64_t hash)
+    {
+        uint64_t h1 = (uint32_t)hash;
+        uint64_t h2 = ((uint64_t)hash >> 32) | 1;
+        for (int32_t i = 0; i < numHashes; ++i)
+        {
+            int64_t bit = (int64_t)((h1 + (uint64_t)i * h2) & (uint64_t)mask);
+            bits[(int32_t)(bit >> 6)] |= (int64_t)1 << (bit & 63);
+        }
+    }
+    
+    bool BloomFilter::mayContain(int64_t hash)
+    {
+        uint64_t h1 = (uint32_t)hash;
+        uint64_t h2 = ((uint64_t)hash >> 32) | 1;
+        for (int32_t i = 0; i < numHashes; ++i)
+        {
+            int64_t bit = (int64_t)((h1 + (uint64_t)i * h2) & (uint64_t)mask);
+            if ((bits[(int32_t)(bit >> 6)] & ((int64_t)1 << (bit & 63))) == 0)
+                return false;
+        }
+        return true;
+    }
+    
+    int64_t BloomFilter::getNumBits()
+    {
+        return mask + 1;
+    }
+    
+    int32_t BloomFilter::getNumHashes()
+    {
+        return numHashes;
+    }
+    
+    int64_t BloomFilter::sizeInBytes()
+    {
+        return (int64_t)bits.size() * 8;
+    }
+    
+    void BloomFilter::write(IndexOutputPtr output)
+    {
+        output->writeVInt(numHashes);
+        output->writeVInt(bits.size());
+        for (int32_t i = 0; i < bits.size(); ++i)
+            output->writeLong(bits[i]);
+    }
+    
+    BloomFilterPtr BloomFilter::read(IndexInputPtr input)
+    {
+        int32_t numHashes = input->readVInt();
+        int32_t numWords = input->readVInt();
+        if (numWords < 1 || (numWords & (numWords - 1)) != 0)
+            boost::throw_exception(CorruptIndexException(L"invalid bloom filter size: " + StringUtils::toString(numWords) + L" words"));
+        BloomFilterPtr filter(newLucene<BloomFilter>((int64_t)numWords << 6, numHashes));
+        for (int32_t i = 0; i < numWords; ++i)
+            filter->bits[i] = input->readLong();
+        return filter;
+    }
+}
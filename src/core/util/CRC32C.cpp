@@ -0,0 +1,245 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "CRC32C.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define LPP_CRC32C_GCC
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <nmmintrin.h>
+#define LPP_CRC32C_MSVC
+#endif
+
+namespace Lucene
+{
+    /// Reversed Castagnoli polynomial.
+    static const uint32_t CRC32C_POLY = 0x82f63b78;
+    
+    /// Tables for slice-by-8; table[0] is the usual byte-at-a-time table.
+    static uint32_t crcTable[8][256];
+    
+    static bool detectHardware()
+    {
+        #if defined(LPP_CRC32C_GCC)
+        unsigned int eax = 0;
+        unsigned int ebx = 0;
+        unsigned int ecx = 0;
+        unsigned int edx = 0;
+        if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0)
+            return false;
+        return ((ecx & (1 << 20)) != 0);
+        #elif defined(LPP_CRC32C_MSVC)
+        int info[4];
+        __cpuid(info, 1);
+        return ((info[2] & (1 << 20)) != 0);
+        #else
+        return false;
+        #endif
+    }
+    
+    static bool initTables()
+    {
+        for (int32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = (uint32_t)i;
+            for (int32_t j = 0; j < 8; ++j)
+                crc = (crc & 1) ? (crc >> 1) ^ CRC32C_POLY : (crc >> 1);
+            crcTable[0][i] = crc;
+        }
+        for (int32_t i = 0; i < 256; ++i)
+        {
+            for (int32_t slice = 1; slice < 8; ++slice)
+                crcTable[slice][i] = (crcTable[slice - 1][i] >> 8) ^ crcTable[0][crcTable[slice - 1][i] & 0xff];
+        }
+        return detectHardware();
+    }
+    
+    /// Tables are filled in (and the processor checked) during static initialization.
+    static const bool hardwareCRC = initTables();
+    
+    CRC32C::CRC32C()
+    {
+        crc = 0;
+    }
+    
+    CRC32C::~CRC32C()
+    {
+    }
+    
+    void CRC32C::update(uint8_t b)
+    {
+        uint32_t c = ~crc;
+        c = crcTable[0][(c ^ b) & 0xff] ^ (c >> 8);
+        crc = ~c;
+    }
+    
+    void CRC32C::update(const uint8_t* b, int32_t offset, int32_t length)
+    {
+        if (length <= 0)
+            return;
+        crc = hardwareCRC ? updateHardware(crc, b + offset, length) : updateSoftware(crc, b + offset, length);
+    }
+    
+    int64_t CRC32C::getValue()
+    {
+        return (int64_t)crc;
+    }
+    
+    void CRC32C::reset()
+    {
+        crc = 0;
+    }
+    
+    bool CRC32C::isHardwareAccelerated()
+    {
+        return hardwareCRC;
+    }
+    
+    uint32_t CRC32C::updateSoftware(uint32_t crc, const uint8_t* b, int32_t length)
+    {
+        uint32_t c = ~crc;
+        while (length > 0 && ((size_t)b & 7) != 0)
+        {
+            c = crcTable[0][(c ^ *b++) & 0xff] ^ (c >> 8);
+            --length;
+        }
+        while (length >= 8)
+        {
+            // bytes are combined explicitly (rather than loaded as words) so this is endian-neutral
+            uint32_t low = c ^ ((uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24));
+            c = crcTable[7][low & 0xff] ^ crcTable[6][(low >> 8) & 0xff] ^ 
+                crcTable[5][(low >> 16) & 0xff] ^ crcTable[4][low >> 24] ^ 
+                crcTable[3][b[4]] ^ crcTable[2][b[5]] ^ crcTable[1][b[6]] ^ crcTable[0][b[7]];
+            b += 8;
+            length -= 8;
+        }
+        while (length-- > 0)
+            c = crcTable[0][(c ^ *b++) & 0xff] ^ (c >> 8);
+        return ~c;
+    }
+    
+    #if defined(LPP_CRC32C_GCC)
+    __attribute__((target("sse4.2")))
+    #endif
+    uint32_t CRC32C::updateHardware(uint32_t crc, const uint8_t* b, int32_t length)
+    {
+        #if defined(LPP_CRC32C_GCC) || defined(LPP_CRC32C_MSVC)
+        uint32_t c = ~crc;
+        while (length > 0 && ((size_t)b & 7) != 0)
+        {
+            #if defined(LPP_CRC32C_GCC)
+            c = __builtin_ia32_crc32qi(c, *b++);
+            #else
+            c = _mm_crc32_u8(c, *b++);
+            #endif
+            --length;
+        }
+        #if defined(__x86_64__) || defined(_M_X64)
+        uint64_t c64 = c;
+        while (length >= 8)
+        {
+            #if defined(LPP_CRC32C_GCC)
+            c64 = __builtin_ia32_crc32di(c64, *(const uint64_t*)b);
+            #else
+            c64 = _mm_crc32_u64(c64, *(const uint64_t*)b);
+            #endif
+            b += 8;
+            length -= 8;
+        }
+        c = (uint32_t)c64;
+        #endif
+        while (length >= 4)
+        {
+            #if defined(LPP_CRC32C_GCC)
+            c = __builtin_ia32_crc32si(c, *(const uint32_t*)b);
+            #else
+            c = _mm_crc32_u32(c, *(const uint32_t*)b);
+            #endif
+            b += 4;
+            length -= 4;
+        }
+        while (length-- > 0)
+        {
+            #if defined(LPP_CRC32C_GCC)
+            c = __builtin_ia32_crc32qi(c, *b++);
+            #else
+            c = _mm_crc32_u8(c, *b++);
+            #endif
+        }
+        return ~c;
+        #else
+        return updateSoftware(crc, b, length);
+        #endif
+    }
+    
+    static uint32_t gf2MatrixTimes(const uint32_t* mat, uint32_t vec)
+    {
+        uint32_t sum = 0;
+        while (vec != 0)
+        {
+            if (vec & 1)
+                sum ^= *mat;
+            vec >>= 1;
+            ++mat;
+        }
+        return sum;
+    }
+    
+    static void gf2MatrixSquare(uint32_t* square, const uint32_t* mat)
+    {
+        for (int32_t n = 0; n < 32; ++n)
+            square[n] = gf2MatrixTimes(mat, mat[n]);
+    }
+    
+    uint32_t CRC32C::shiftZeros(uint32_t crc, int64_t numBytes)
+    {
+        if (numBytes <= 0 || crc == 0)
+            return crc;
+        uint32_t even[32]; // even-power-of-two zeros operator
+        uint32_t odd[32]; // odd-power-of-two zeros operator
+        
+        // operator for one zero bit in odd
+        odd[0] = CRC32C_POLY;
+        uint32_t row = 1;
+        for (int32_t n = 1; n < 32; ++n)
+        {
+            odd[n] = row;
+            row <<= 1;
+        }
+        gf2MatrixSquare(even, odd); // two zero bits
+        gf2MatrixSquare(odd, even); // four zero bits
+        
+        // apply numBytes zeros to crc (the first squaring puts the operator for one zero byte in even)
+        do
+        {
+            gf2MatrixSquare(even, odd);
+            if (numBytes & 1)
+                crc = gf2MatrixTimes(even, crc);
+            numBytes >>= 1;
+            if (numBytes == 0)
+                break;
+            gf2MatrixSquare(odd, even);
+            if (numBytes & 1)
+                crc = gf2MatrixTimes(odd, crc);
+            numBytes >>= 1;
+        }
+        while (numBytes != 0);
+        return crc;
+    }
+    
+    void CRC32C::patch(int64_t messageLength, int64_t position, const uint8_t* oldBytes, const uint8_t* newBytes, int32_t length)
+    {
+        // the checksum is linear: the change is the raw checksum of the xor of the old and new bytes, 
+        // followed by the rest of the message as zeros
+        uint32_t delta = 0;
+        for (int32_t i = 0; i < length; ++i)
+            delta = crcTable[0][(delta ^ oldBytes[i] ^ newBytes[i]) & 0xff] ^ (delta >> 8);
+        crc ^= shiftZeros(delta, messageLength - position - length);
+    }
+}
@@ -0,0 +1,314 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "FST.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
+
+namespace Lucene
+{
+    const uint8_t FST::FLAG_FINAL = 1;
+    const uint8_t FST::FLAG_FINAL_OUTPUT = 2;
+    
+    static inline int32_t readVInt(const uint8_t* bytes, int32_t& pos)
+    {
+        uint8_t b = bytes[pos++];
+        int32_t i = (b & 0x7f);
+        for (int32_t shift = 7; (b & 0x80) != 0; shift += 7)
+        {
+            b = bytes[pos++];
+            i |= (b & 0x7f) << shift;
+        }
+        return i;
+    }
+    
+    static inline int64_t readVLong(const uint8_t* bytes, int32_t& pos)
+    {
+        uint8_t b = bytes[pos++];
+        int64_t i = (b & 0x7f);
+        for (int32_t shift = 7; (b & 0x80) != 0; shift += 7)
+        {
+            b = bytes[pos++];
+            i |= (int64_t)(b & 0x7f) << shift;
+        }
+        return i;
+    }
+    
+    static inline void appendLabel(UTF8ResultPtr result, int32_t label)
+    {
+        int32_t length = result->length;
+        result->setLength(length + 1);
+        result->result[length] = (uint8_t)label;
+    }
+    
+    FST::FST(ByteArray bytes, int32_t length, int32_t startNode)
+    {
+        this->bytes = bytes;
+        this->length = length;
+        this->startNode = startNode;
+    }
+    
+    FST::FST(IndexInputPtr in)
+    {
+        length = in->readVInt();
+        startNode = in->readVInt();
+        bytes = ByteArray::newInstance(std::max(length, 1));
+        in->readBytes(bytes.get(), 0, length);
+    }
+    
+    FST::~FST()
+    {
+    }
+    
+    int32_t FST::sizeInBytes()
+    {
+        return length;
+    }
+    
+    void FST::write(IndexOutputPtr out)
+    {
+        out->writeVInt(length);
+        out->writeVInt(startNode);
+        out->writeBytes(bytes.get(), length);
+    }
+    
+    int32_t FST::readNode(int32_t address, bool& isFinal, int64_t& finalOutput, int32_t& numArcs, int32_t& bytesPerArc)
+    {
+        const uint8_t* b = bytes.get();
+        int32_t pos = address;
+        uint8_t flags = b[pos++];
+        isFinal = ((flags & FLAG_FINAL) != 0);
+        finalOutput = (flags & FLAG_FINAL_OUTPUT) != 0 ? readVLong(b, pos) : 0;
+        numArcs = readVInt(b, pos);
+        bytesPerArc = numArcs > 0 ? readVInt(b, pos) : 0;
+        return pos;
+    }
+    
+    int32_t FST::readArc(int32_t arcs, int32_t bytesPerArc, int32_t arc, int64_t& output, int32_t& target)
+    {
+        const uint8_t* b = bytes.get();
+        int32_t pos = arcs + arc * bytesPerArc;
+        int32_t label = b[pos++];
+        output = readVLong(b, pos);
+        target = readVInt(b, pos);
+        return label;
+    }
+    
+    int32_t FST::findArc(int32_t arcs, int32_t bytesPerArc, int32_t numArcs, int32_t label)
+    {
+        const uint8_t* b = bytes.get();
+        int32_t low = 0;
+        int32_t high = numArcs;
+        while (low < high)
+        {
+            int32_t mid = (int32_t)((uint32_t)(low + high) >> 1);
+            if (b[arcs + mid * bytesPerArc] < label)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        return low;
+    }
+    
+    int64_t FST::followEdge(int32_t node, int64_t output, bool greatest, UTF8ResultPtr result)
+    {
+        while (true)
+        {
+            bool isFinal;
+            int64_t finalOutput;
+            int32_t numArcs;
+            int32_t bytesPerArc;
+            int32_t arcs = readNode(node, isFinal, finalOutput, numArcs, bytesPerArc);
+            
+            // the least key ends at the first final node, the greatest at the first node without arcs
+            if (numArcs == 0 || (isFinal && !greatest))
+                return output + finalOutput;
+            
+            int64_t arcOutput;
+            appendLabel(result, readArc(arcs, bytesPerArc, greatest ? numArcs - 1 : 0, arcOutput, node));
+            output += arcOutput;
+        }
+    }
+    
+    int64_t FST::get(const uint8_t* key, int32_t keyLength)
+    {
+        int32_t node = startNode;
+        int64_t output = 0;
+        bool isFinal;
+        int64_t finalOutput;
+        int32_t numArcs;
+        int32_t bytesPerArc;
+        for (int32_t i = 0; i < keyLength; ++i)
+        {
+            int32_t arcs = readNode(node, isFinal, finalOutput, numArcs, bytesPerArc);
+            int32_t arc = findArc(arcs, bytesPerArc, numArcs, key[i]);
+            int64_t arcOutput;
+            if (arc == numArcs || readArc(arcs, bytesPerArc, arc, arcOutput, node) != key[i])
+                return -1;
+            output += arcOutput;
+        }
+        readNode(node, isFinal, finalOutput, numArcs, bytesPerArc);
+        return isFinal ? output + finalOutput : -1;
+    }
+    
+    bool FST::getKey(int64_t output, UTF8ResultPtr key)
+    {
+        // follow the last arc whose least output doesn't pass the one wanted
+        key->setLength(0);
+        int32_t node = startNode;
+        int64_t nodeOutput = 0;
+        bool isFinal;
+        int64_t finalOutput;
+        int32_t numArcs;
+        int32_t bytesPerArc;
+        while (true)
+        {
+            int32_t arcs = readNode(node, isFinal, finalOutput, numArcs, bytesPerArc);
+            if (isFinal && nodeOutput + finalOutput == output)
+                return true;
+            int32_t low = 0;
+            int32_t high = numArcs;
+            while (low < high)
+            {
+                int32_t mid = (int32_t)((uint32_t)(low + high) >> 1);
+                int64_t arcOutput;
+                int32_t target;
+                readArc(arcs, bytesPerArc, mid, arcOutput, target);
+                if (nodeOutput + arcOutput <= output)
+                    low = mid + 1;
+                else
+                    high = mid;
+            }
+            if (low == 0)
+                return false;
+            int64_t arcOutput;
+            appendLabel(key, readArc(arcs, bytesPerArc, low - 1, arcOutput, node));
+            nodeOutput += arcOutput;
+        }
+    }
+    
+    int64_t FST::floor(const uint8_t* key, int32_t keyLength, UTF8ResultPtr floorKey)
+    {
+        // walk down the key, remembering the deepest point where the path could turn off to a smaller key:
+        // either an arc with a smaller label, or a final node for a prefix of the key
+        int32_t node = startNode;
+        int64_t output = 0;
+        int32_t candidateDepth = -1;
+        int32_t candidateTarget = -1; // -1 when the candidate is the prefix itself
+        int32_t candidateLabel = 0;
+        int64_t candidateOutput = 0;
+        bool isFinal;
+        int64_t finalOutput;
+        int32_t numArcs;
+        int32_t bytesPerArc;
+        for (int32_t depth = 0; depth <= keyLength; ++depth)
+        {
+            int32_t arcs = readNode(node, isFinal, finalOutput, numArcs, bytesPerArc);
+            if (depth == keyLength)
+            {
+                if (isFinal)
+                {
+                    floorKey->setLength(keyLength);
+                    MiscUtils::arrayCopy(key, 0, floorKey->result.get(), 0, keyLength);
+                    return output + finalOutput;
+                }
+                break;
+            }
+            int32_t arc = findArc(arcs, bytesPerArc, numArcs, key[depth]);
+            if (arc > 0)
+            {
+                int64_t arcOutput;
+                candidateDepth = depth;
+                candidateLabel = readArc(arcs, bytesPerArc, arc - 1, arcOutput, candidateTarget);
+                candidateOutput = output + arcOutput;
+            }
+            else if (isFinal)
+            {
+                candidateDepth = depth;
+                candidateTarget = -1;
+                candidateOutput = output + finalOutput;
+            }
+            int64_t arcOutput;
+            if (arc == numArcs || readArc(arcs, bytesPerArc, arc, arcOutput, node) != key[depth])
+                break;
+            output += arcOutput;
+        }
+        
+        if (candidateDepth == -1)
+            return -1;
+        floorKey->setLength(candidateDepth);
+        MiscUtils::arrayCopy(key, 0, floorKey->result.get(), 0, candidateDepth);
+        if (candidateTarget == -1)
+            return candidateOutput;
+        appendLabel(floorKey, candidateLabel);
+        return followEdge(candidateTarget, candidateOutput, true, floorKey);
+    }
+    
+    int64_t FST::ceil(const uint8_t* key, int32_t keyLength, UTF8ResultPtr ceilKey)
+    {
+        // walk down the key, remembering the deepest arc with a greater label than the key's
+        int32_t node = startNode;
+        int64_t output = 0;
+        int32_t candidateDepth = -1;
+        int32_t candidateTarget = -1;
+        int32_t candidateLabel = 0;
+        int64_t candidateOutput = 0;
+        bool isFinal;
+        int64_t finalOutput;
+        int32_t numArcs;
+        int32_t bytesPerArc;
+        for (int32_t depth = 0; depth <= keyLength; ++depth)
+        {
+            int32_t arcs = readNode(node, isFinal, finalOutput, numArcs, bytesPerArc);
+            if (depth == keyLength)
+            {
+                // the key itself, or else the least key it is a prefix of
+                ceilKey->setLength(keyLength);
+                MiscUtils::arrayCopy(key, 0, ceilKey->result.get(), 0, keyLength);
+                if (isFinal)
+                    return output + finalOutput;
+                if (numArcs == 0)
+                    break;
+                return followEdge(node, output, false, ceilKey);
+            }
+            int32_t arc = findArc(arcs, bytesPerArc, numArcs, key[depth]);
+            int64_t arcOutput;
+            int32_t target;
+            int32_t label = arc < numArcs ? readArc(arcs, bytesPerArc, arc, arcOutput, target) : -1;
+            if (label != key[depth])
+            {
+                // the path turns off here, to an arc with a greater label if there is one
+                if (arc < numArcs)
+                {
+                    candidateDepth = depth;
+                    candidateLabel = label;
+                    candidateTarget = target;
+                    candidateOutput = output + arcOutput;
+                }
+                break;
+            }
+            if (arc + 1 < numArcs)
+            {
+                int64_t nextOutput;
+                candidateDepth = depth;
+                candidateLabel = readArc(arcs, bytesPerArc, arc + 1, nextOutput, candidateTarget);
+                candidateOutput = output + nextOutput;
+            }
+            output += arcOutput;
+            node = target;
+        }
+        
+        if (candidateDepth == -1)
+            return -1;
+        ceilKey->setLength(candidateDepth);
+        MiscUtils::arrayCopy(key, 0, ceilKey->result.get(), 0, candidateDepth);
+        appendLabel(ceilKey, candidateLabel);
+        return followEdge(candidateTarget, candidateOutput, false, ceilKey);
+    }
+}
@@ -0,0 +1,283 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "FSTBuilder.h"
+#include "_FSTBuilder.h"
+#include "FST.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    /// Returns the number of bytes needed to write a value as a VLong (or VInt).
+    static inline int32_t vLongLength(int64_t i)
+    {
+        int32_t length = 1;
+        while ((i & ~(int64_t)0x7f) != 0)
+        {
+            i = MiscUtils::unsignedShift(i, (int64_t)7);
+            ++length;
+        }
+        return length;
+    }
+    
+    FSTBuilder::FSTBuilder()
+    {
+        bytes = ByteArray::newInstance(1024);
+        length = 0;
+        frontier = Collection<FSTBuilderNodePtr>::newInstance();
+        frontier.add(newLucene<FSTBuilderNode>());
+        lastKey = ByteArray::newInstance(16);
+        lastKeyLength = 0;
+        numKeys = 0;
+        scratch = ByteArray::newInstance(64);
+        nodeTable = IntArray::newInstance(16);
+        nodeHashes = IntArray::newInstance(16);
+        std::fill(nodeTable.get(), nodeTable.get() + nodeTable.size(), -1);
+        numNodes = 0;
+    }
+    
+    FSTBuilder::~FSTBuilder()
+    {
+    }
+    
+    void FSTBuilder::add(const uint8_t* key, int32_t keyLength, int64_t output)
+    {
+        if (output < 0)
+            boost::throw_exception(IllegalArgumentException(L"outputs must not be negative"));
+        
+        int32_t prefixLength = 0;
+        if (numKeys > 0)
+        {
+            int32_t limit = std::min(lastKeyLength, keyLength);
+            while (prefixLength < limit && lastKey[prefixLength] == key[prefixLength])
+                ++prefixLength;
+            if (prefixLength == keyLength || (prefixLength < lastKeyLength && key[prefixLength] < lastKey[prefixLength]))
+                boost::throw_exception(IllegalArgumentException(L"keys must be added in sorted order without duplicates"));
+        }
+        
+        while (frontier.size() <= keyLength)
+            frontier.add(newLucene<FSTBuilderNode>());
+        
+        freezeTail(prefixLength);
+        
+        for (int32_t i = prefixLength; i < keyLength; ++i)
+            frontier[i]->addArc(key[i]);
+        frontier[keyLength]->isFinal = true;
+        frontier[keyLength]->finalOutput = 0;
+        
+        // keep only the part of each shared arc's output that this key has in common with the last one, and
+        // push the rest of it down to the next node
+        for (int32_t i = 0; i < prefixLength; ++i)
+        {
+            FSTBuilderNodePtr node(frontier[i]);
+            int64_t lastOutput = node->getLastOutput();
+            int64_t common = std::min(lastOutput, output);
+            if (common != lastOutput)
+            {
+                node->setLastOutput(common);
+                frontier[i + 1]->prependOutput(lastOutput - common);
+            }
+            output -= common;
+        }
+        if (prefixLength < keyLength)
+            frontier[prefixLength]->setLastOutput(output);
+        else
+            frontier[keyLength]->finalOutput = output; // the empty key
+        
+        if (lastKey.size() < keyLength)
+            lastKey.resize((int32_t)((double)keyLength * 1.5));
+        MiscUtils::arrayCopy(key, 0, lastKey.get(), 0, keyLength);
+        lastKeyLength = keyLength;
+        ++numKeys;
+    }
+    
+    int64_t FSTBuilder::size()
+    {
+        return numKeys;
+    }
+    
+    FSTPtr FSTBuilder::finish()
+    {
+        freezeTail(0);
+        int32_t startNode = compileNode(frontier[0]);
+        frontier.clear();
+        nodeTable.reset();
+        nodeHashes.reset();
+        return newLucene<FST>(bytes, length, startNode);
+    }
+    
+    void FSTBuilder::freezeTail(int32_t prefixLength)
+    {
+        for (int32_t i = lastKeyLength; i > prefixLength; --i)
+        {
+            frontier[i - 1]->setLastTarget(compileNode(frontier[i]));
+            frontier[i]->clear();
+        }
+    }
+    
+    void FSTBuilder::appendVInt(ByteArray& buffer, int32_t& upto, int32_t i)
+    {
+        while ((i & ~0x7f) != 0)
+        {
+            buffer[upto++] = (uint8_t)((i & 0x7f) | 0x80);
+            i = MiscUtils::unsignedShift(i, 7);
+        }
+        buffer[upto++] = (uint8_t)i;
+    }
+    
+    void FSTBuilder::appendVLong(ByteArray& buffer, int32_t& upto, int64_t i)
+    {
+        while ((i & ~0x7f) != 0)
+        {
+            buffer[upto++] = (uint8_t)((i & 0x7f) | 0x80);
+            i = MiscUtils::unsignedShift(i, (int64_t)7);
+        }
+        buffer[upto++] = (uint8_t)i;
+    }
+    
+    int32_t FSTBuilder::compileNode(FSTBuilderNodePtr node)
+    {
+        int32_t numArcs = node->numArcs();
+        
+        // every arc is padded to the size of the largest: a label byte, a VLong output and a VInt target
+        int32_t bytesPerArc = 0;
+        for (int32_t i = 0; i < numArcs; ++i)
+            bytesPerArc = std::max(bytesPerArc, 1 + vLongLength(node->outputs[i]) + vLongLength(node->targets[i]));
+        int32_t maxLength = 1 + 10 + 5 + 5 + numArcs * bytesPerArc;
+        if (scratch.size() < maxLength)
+            scratch.resize((int32_t)((double)maxLength * 1.5));
+        
+        int32_t upto = 0;
+        uint8_t flags = 0;
+        if (node->isFinal)
+            flags |= FST::FLAG_FINAL;
+        if (node->isFinal && node->finalOutput != 0)
+            flags |= FST::FLAG_FINAL_OUTPUT;
+        scratch[upto++] = flags;
+        if ((flags & FST::FLAG_FINAL_OUTPUT) != 0)
+            appendVLong(scratch, upto, node->finalOutput);
+        appendVInt(scratch, upto, numArcs);
+        if (numArcs > 0)
+        {
+            appendVInt(scratch, upto, bytesPerArc);
+            for (int32_t i = 0; i < numArcs; ++i)
+            {
+                int32_t start = upto;
+                scratch[upto++] = (uint8_t)node->labels[i];
+                appendVLong(scratch, upto, node->outputs[i]);
+                appendVInt(scratch, upto, node->targets[i]);
+                while (upto < start + bytesPerArc)
+                    scratch[upto++] = 0;
+            }
+        }
+        
+        int32_t hash = 0;
+        for (int32_t i = 0; i < upto; ++i)
+            hash = 31 * hash + scratch[i];
+        
+        // nodes are self-delimiting, so a compiled node that starts with the same bytes is the same node
+        int32_t mask = nodeTable.size() - 1;
+        int32_t pos = hash & mask;
+        while (nodeTable[pos] != -1)
+        {
+            int32_t address = nodeTable[pos];
+            if (nodeHashes[pos] == hash && address + upto <= length && std::memcmp(bytes.get() + address, scratch.get(), upto) == 0)
+                return address;
+            pos = (pos + 1) & mask;
+        }
+        
+        if (bytes.size() < length + upto)
+            bytes.resize(std::max(length + upto, (int32_t)((double)bytes.size() * 1.5)));
+        int32_t address = length;
+        MiscUtils::arrayCopy(scratch.get(), 0, bytes.get(), address, upto);
+        length += upto;
+        
+        nodeTable[pos] = address;
+        nodeHashes[pos] = hash;
+        if (++numNodes * 2 > nodeTable.size())
+            rehash();
+        return address;
+    }
+    
+    void FSTBuilder::rehash()
+    {
+        IntArray oldTable(nodeTable);
+        IntArray oldHashes(nodeHashes);
+        int32_t size = oldTable.size() * 2;
+        nodeTable = IntArray::newInstance(size);
+        nodeHashes = IntArray::newInstance(size);
+        std::fill(nodeTable.get(), nodeTable.get() + size, -1);
+        int32_t mask = size - 1;
+        for (int32_t i = 0; i < oldTable.size(); ++i)
+        {
+            if (oldTable[i] == -1)
+                continue;
+            int32_t pos = oldHashes[i] & mask;
+            while (nodeTable[pos] != -1)
+                pos = (pos + 1) & mask;
+            nodeTable[pos] = oldTable[i];
+            nodeHashes[pos] = oldHashes[i];
+        }
+    }
+    
+    FSTBuilderNode::FSTBuilderNode()
+    {
+        labels = Collection<int32_t>::newInstance();
+        outputs = Collection<int64_t>::newInstance();
+        targets = Collection<int32_t>::newInstance();
+        isFinal = false;
+        finalOutput = 0;
+    }
+    
+    FSTBuilderNode::~FSTBuilderNode()
+    {
+    }
+    
+    int32_t FSTBuilderNode::numArcs()
+    {
+        return labels.size();
+    }
+    
+    void FSTBuilderNode::clear()
+    {
+        labels.clear();
+        outputs.clear();
+        targets.clear();
+        isFinal = false;
+        finalOutput = 0;
+    }
+    
+    void FSTBuilderNode::addArc(int32_t label)
+    {
+        labels.add(label);
+        outputs.add(0);
+        targets.add(-1);
+    }
+    
+    int64_t FSTBuilderNode::getLastOutput()
+    {
+        return outputs[outputs.size() - 1];
+    }
+    
+    void FSTBuilderNode::setLastOutput(int64_t output)
+    {
+        outputs[outputs.size() - 1] = output;
+    }
+    
+    void FSTBuilderNode::setLastTarget(int32_t target)
+    {
+        targets[targets.size() - 1] = target;
+    }
+    
+    void FSTBuilderNode::prependOutput(int64_t output)
+    {
+        for (int32_t i = 0; i < outputs.size(); ++i)
+            outputs[i] += output;
+        if (isFinal)
+            finalOutput += output;
+    }
+}
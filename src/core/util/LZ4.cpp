@@ -0,0 +1,153 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "LZ4.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "MiscUtils.h"
+
+namespace Lucene
+{
+    const int32_t LZ4::MIN_MATCH = 4;
+    const int32_t LZ4::MAX_DISTANCE = 1 << 16;
+    const int32_t LZ4::LAST_LITERALS = 5;
+    const int32_t LZ4::HASH_LOG = 14;
+    
+    LZ4::LZ4()
+    {
+        hashTable = IntArray::newInstance(1 << HASH_LOG);
+    }
+    
+    LZ4::~LZ4()
+    {
+    }
+    
+    static inline int32_t readInt(const uint8_t* bytes, int32_t i)
+    {
+        return ((int32_t)bytes[i] << 24) | ((int32_t)bytes[i + 1] << 16) | ((int32_t)bytes[i + 2] << 8) | (int32_t)bytes[i + 3];
+    }
+    
+    static inline int32_t hash(int32_t i)
+    {
+        return (int32_t)(((uint32_t)i * 0x9e3779b1U) >> (32 - LZ4::HASH_LOG));
+    }
+    
+    void LZ4::encodeLength(int32_t length, IndexOutputPtr out)
+    {
+        while (length >= 0xff)
+        {
+            out->writeByte(0xff);
+            length -= 0xff;
+        }
+        out->writeByte((uint8_t)length);
+    }
+    
+    void LZ4::encodeLiterals(const uint8_t* bytes, int32_t token, int32_t anchor, int32_t literalLength, IndexOutputPtr out)
+    {
+        out->writeByte((uint8_t)token);
+        if (literalLength >= 0x0f)
+            encodeLength(literalLength - 0x0f, out);
+        out->writeBytes(bytes, anchor, literalLength);
+    }
+    
+    void LZ4::compress(const uint8_t* bytes, int32_t offset, int32_t length, IndexOutputPtr out)
+    {
+        int32_t end = offset + length;
+        int32_t anchor = offset;
+        
+        if (length > LAST_LITERALS + MIN_MATCH)
+        {
+            int32_t limit = end - LAST_LITERALS;
+            int32_t matchLimit = limit - MIN_MATCH;
+            MiscUtils::arrayFill(hashTable.get(), 0, hashTable.size(), 0);
+            
+            int32_t off = offset;
+            while (off < matchLimit)
+            {
+                // find the next four bytes seen before within reach
+                int32_t v = readInt(bytes, off);
+                int32_t h = hash(v);
+                int32_t ref = offset + hashTable[h] - 1;
+                hashTable[h] = off - offset + 1;
+                if (ref < offset || off - ref >= MAX_DISTANCE || readInt(bytes, ref) != v)
+                {
+                    ++off;
+                    continue;
+                }
+                
+                int32_t matchLength = MIN_MATCH;
+                while (off + matchLength < limit && bytes[ref + matchLength] == bytes[off + matchLength])
+                    ++matchLength;
+                
+                int32_t literalLength = off - anchor;
+                int32_t extraMatchLength = matchLength - MIN_MATCH;
+                int32_t token = (std::min(literalLength, 0x0f) << 4) | std::min(extraMatchLength, 0x0f);
+                encodeLiterals(bytes, token, anchor, literalLength, out);
+                int32_t distance = off - ref;
+                out->writeByte((uint8_t)distance);
+                out->writeByte((uint8_t)(distance >> 8));
+                if (extraMatchLength >= 0x0f)
+                    encodeLength(extraMatchLength - 0x0f, out);
+                
+                off += matchLength;
+                anchor = off;
+            }
+        }
+        
+        int32_t literalLength = end - anchor;
+        encodeLiterals(bytes, std::min(literalLength, 0x0f) << 4, anchor, literalLength, out);
+    }
+    
+    int32_t LZ4::decodeLength(int32_t length, IndexInputPtr in)
+    {
+        uint8_t b;
+        do
+        {
+            b = in->readByte();
+            length += b;
+        }
+        while (b == 0xff);
+        return length;
+    }
+    
+    void LZ4::decompress(IndexInputPtr in, int32_t decompressedLength, uint8_t* dest, int32_t destOffset)
+    {
+        int32_t destEnd = destOffset + decompressedLength;
+        int32_t destStart = destOffset;
+        while (true)
+        {
+            int32_t token = in->readByte();
+            
+            int32_t literalLength = token >> 4;
+            if (literalLength == 0x0f)
+                literalLength = decodeLength(literalLength, in);
+            if (literalLength > destEnd - destOffset)
+                boost::throw_exception(CorruptIndexException(L"compressed literals overrun the decompressed length"));
+            in->readBytes(dest, destOffset, literalLength);
+            destOffset += literalLength;
+            
+            if (destOffset == destEnd)
+                break;
+            
+            int32_t distance = in->readByte();
+            distance |= (int32_t)in->readByte() << 8;
+            int32_t matchLength = token & 0x0f;
+            if (matchLength == 0x0f)
+                matchLength = decodeLength(matchLength, in);
+            matchLength += MIN_MATCH;
+            if (distance == 0 || distance > destOffset - destStart || matchLength > destEnd - destOffset)
+                boost::throw_exception(CorruptIndexException(L"invalid compressed match"));
+            
+            // the match may overlap the bytes it produces, so copy a byte at a time
+            uint8_t* from = dest + destOffset - distance;
+            uint8_t* to = dest + destOffset;
+            for (int32_t i = 0; i < matchLength; ++i)
+                to[i] = from[i];
+            destOffset += matchLength;
+        }
+    }
+}
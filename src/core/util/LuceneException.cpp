@@ -40,6 +40,8 @@ namespace Lucene
         {
             case LuceneException::AlreadyClosed:
                 boost::throw_exception(AlreadyClosedException(error, type));
+            case LuceneException::CollectionTerminated:
+                boost::throw_exception(CollectionTerminatedException(error, type));
             case LuceneException::Compression:
                 boost::throw_exception(CompressionException(error, type));
             case LuceneException::CorruptIndex:
@@ -0,0 +1,813 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "LuceneInc.h"
+#include "RoaringDocIdSet.h"
+#include "_RoaringDocIdSet.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "BitUtil.h"
+#include "MiscUtils.h"
+#include "StringUtils.h"
+
+namespace Lucene
+{
+    RoaringDocIdSet::RoaringDocIdSet()
+    {
+        keys = Collection<int32_t>::newInstance();
+        containers = Collection<RoaringContainerPtr>::newInstance();
+    }
+    
+    RoaringDocIdSet::RoaringDocIdSet(DocIdSetIteratorPtr docIdSetIterator)
+    {
+        keys = Collection<int32_t>::newInstance();
+        containers = Collection<RoaringContainerPtr>::newInstance();
+        int32_t key = -1;
+        RoaringContainerPtr container;
+        int32_t doc;
+        while ((doc = docIdSetIterator->nextDoc()) != DocIdSetIterator::NO_MORE_DOCS)
+        {
+            if ((doc >> 16) != key)
+            {
+                appendContainer(key, container);
+                key = doc >> 16;
+                container = newLucene<RoaringContainer>();
+            }
+            container->add(doc & 0xffff);
+        }
+        appendContainer(key, container);
+        optimize();
+    }
+    
+    RoaringDocIdSet::~RoaringDocIdSet()
+    {
+    }
+    
+    LuceneObjectPtr RoaringDocIdSet::clone(LuceneObjectPtr other)
+    {
+        LuceneObjectPtr clone = other ? other : newLucene<RoaringDocIdSet>();
+        RoaringDocIdSetPtr cloneSet(boost::dynamic_pointer_cast<RoaringDocIdSet>(clone));
+        cloneSet->keys = Collection<int32_t>::newInstance(keys.begin(), keys.end());
+        cloneSet->containers = Collection<RoaringContainerPtr>::newInstance();
+        for (Collection<RoaringContainerPtr>::iterator container = containers.begin(); container != containers.end(); ++container)
+            cloneSet->containers.add(boost::dynamic_pointer_cast<RoaringContainer>((*container)->clone()));
+        return cloneSet;
+    }
+    
+    void RoaringDocIdSet::set(int32_t doc)
+    {
+        getOrAddContainer(doc >> 16)->add(doc & 0xffff);
+    }
+    
+    void RoaringDocIdSet::clear(int32_t doc)
+    {
+        int32_t index = findContainer(doc >> 16);
+        if (index < 0)
+            return;
+        RoaringContainerPtr container(containers[index]);
+        container->remove(doc & 0xffff);
+        if (container->cardinality == 0)
+        {
+            keys.remove(keys.begin() + index);
+            containers.remove(containers.begin() + index);
+        }
+    }
+    
+    bool RoaringDocIdSet::get(int32_t doc)
+    {
+        int32_t index = findContainer(doc >> 16);
+        return (index >= 0 && containers[index]->contains(doc & 0xffff));
+    }
+    
+    int32_t RoaringDocIdSet::cardinality()
+    {
+        int32_t cardinality = 0;
+        for (Collection<RoaringContainerPtr>::iterator container = containers.begin(); container != containers.end(); ++container)
+            cardinality += (*container)->cardinality;
+        return cardinality;
+    }
+    
+    bool RoaringDocIdSet::isEmpty()
+    {
+        return containers.empty();
+    }
+    
+    void RoaringDocIdSet::optimize()
+    {
+        for (Collection<RoaringContainerPtr>::iterator container = containers.begin(); container != containers.end(); ++container)
+            (*container)->optimize();
+    }
+    
+    int64_t RoaringDocIdSet::sizeInBytes()
+    {
+        int64_t size = keys.size() * sizeof(int32_t);
+        for (Collection<RoaringContainerPtr>::iterator container = containers.begin(); container != containers.end(); ++container)
+            size += (*container)->sizeInBytes();
+        return size;
+    }
+    
+    RoaringDocIdSetPtr RoaringDocIdSet::_and(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b)
+    {
+        RoaringDocIdSetPtr result(newLucene<RoaringDocIdSet>());
+        int32_t i = 0;
+        int32_t j = 0;
+        while (i < a->keys.size() && j < b->keys.size())
+        {
+            if (a->keys[i] < b->keys[j])
+                ++i;
+            else if (a->keys[i] > b->keys[j])
+                ++j;
+            else
+            {
+                result->appendContainer(a->keys[i], RoaringContainer::_and(a->containers[i], b->containers[j]));
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+    
+    RoaringDocIdSetPtr RoaringDocIdSet::_or(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b)
+    {
+        RoaringDocIdSetPtr result(newLucene<RoaringDocIdSet>());
+        int32_t i = 0;
+        int32_t j = 0;
+        while (i < a->keys.size() || j < b->keys.size())
+        {
+            if (j == b->keys.size() || (i < a->keys.size() && a->keys[i] < b->keys[j]))
+            {
+                result->appendContainer(a->keys[i], boost::dynamic_pointer_cast<RoaringContainer>(a->containers[i]->clone()));
+                ++i;
+            }
+            else if (i == a->keys.size() || a->keys[i] > b->keys[j])
+            {
+                result->appendContainer(b->keys[j], boost::dynamic_pointer_cast<RoaringContainer>(b->containers[j]->clone()));
+                ++j;
+            }
+            else
+            {
+                result->appendContainer(a->keys[i], RoaringContainer::_or(a->containers[i], b->containers[j]));
+                ++i;
+                ++j;
+            }
+        }
+        return result;
+    }
+    
+    RoaringDocIdSetPtr RoaringDocIdSet::andNot(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b)
+    {
+        RoaringDocIdSetPtr result(newLucene<RoaringDocIdSet>());
+        int32_t j = 0;
+        for (int32_t i = 0; i < a->keys.size(); ++i)
+        {
+            while (j < b->keys.size() && b->keys[j] < a->keys[i])
+                ++j;
+            if (j < b->keys.size() && b->keys[j] == a->keys[i])
+                result->appendContainer(a->keys[i], RoaringContainer::andNot(a->containers[i], b->containers[j]));
+            else
+                result->appendContainer(a->keys[i], boost::dynamic_pointer_cast<RoaringContainer>(a->containers[i]->clone()));
+        }
+        return result;
+    }
+    
+    int32_t RoaringDocIdSet::intersectionCount(RoaringDocIdSetPtr a, RoaringDocIdSetPtr b)
+    {
+        int32_t count = 0;
+        int32_t i = 0;
+        int32_t j = 0;
+        while (i < a->keys.size() && j < b->keys.size())
+        {
+            if (a->keys[i] < b->keys[j])
+                ++i;
+            else if (a->keys[i] > b->keys[j])
+                ++j;
+            else
+                count += RoaringContainer::intersectionCount(a->containers[i++], b->containers[j++]);
+        }
+        return count;
+    }
+    
+    void RoaringDocIdSet::write(IndexOutputPtr output)
+    {
+        output->writeVInt(keys.size());
+        for (int32_t i = 0; i < keys.size(); ++i)
+        {
+            output->writeVInt(keys[i]);
+            containers[i]->write(output);
+        }
+    }
+    
+    RoaringDocIdSetPtr RoaringDocIdSet::read(IndexInputPtr input)
+    {
+        RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>());
+        int32_t numContainers = input->readVInt();
+        for (int32_t i = 0; i < numContainers; ++i)
+        {
+            int32_t key = input->readVInt();
+            set->appendContainer(key, RoaringContainer::read(input));
+        }
+        return set;
+    }
+    
+    DocIdSetIteratorPtr RoaringDocIdSet::iterator()
+    {
+        return newLucene<RoaringDocIdSetIterator>(shared_from_this());
+    }
+    
+    bool RoaringDocIdSet::isCacheable()
+    {
+        return true;
+    }
+    
+    int32_t RoaringDocIdSet::findContainer(int32_t key, int32_t fromIndex)
+    {
+        Collection<int32_t>::iterator position = std::lower_bound(keys.begin() + fromIndex, keys.end(), key);
+        int32_t index = std::distance(keys.begin(), position);
+        if (position != keys.end() && *position == key)
+            return index;
+        return -index - 1;
+    }
+    
+    RoaringContainerPtr RoaringDocIdSet::getOrAddContainer(int32_t key)
+    {
+        // doc ids are usually added in increasing order
+        if (!keys.empty() && keys[keys.size() - 1] == key)
+            return containers[containers.size() - 1];
+        int32_t index = findContainer(key);
+        if (index >= 0)
+            return containers[index];
+        index = -index - 1;
+        RoaringContainerPtr container(newLucene<RoaringContainer>());
+        keys.add(index, key);
+        containers.add(index, container);
+        return container;
+    }
+    
+    void RoaringDocIdSet::appendContainer(int32_t key, RoaringContainerPtr container)
+    {
+        if (container && container->cardinality > 0)
+        {
+            keys.add(key);
+            containers.add(container);
+        }
+    }
+    
+    const uint8_t RoaringContainer::ARRAY = 0;
+    const uint8_t RoaringContainer::BITMAP = 1;
+    const uint8_t RoaringContainer::RUN = 2;
+    
+    const int32_t RoaringContainer::MAX_ARRAY_SIZE = 4096;
+    const int32_t RoaringContainer::BITMAP_WORDS = 1024;
+    
+    RoaringContainer::RoaringContainer()
+    {
+        type = ARRAY;
+        cardinality = 0;
+        numRuns = 0;
+    }
+    
+    RoaringContainer::~RoaringContainer()
+    {
+    }
+    
+    LuceneObjectPtr RoaringContainer::clone(LuceneObjectPtr other)
+    {
+        LuceneObjectPtr clone = other ? other : newLucene<RoaringContainer>();
+        RoaringContainerPtr cloneContainer(boost::dynamic_pointer_cast<RoaringContainer>(clone));
+        cloneContainer->type = type;
+        cloneContainer->cardinality = cardinality;
+        cloneContainer->numRuns = numRuns;
+        if (values)
+        {
+            cloneContainer->values = Array<uint16_t>::newInstance(values.size());
+            MiscUtils::arrayCopy(values.get(), 0, cloneContainer->values.get(), 0, values.size());
+        }
+        if (words)
+        {
+            cloneContainer->words = LongArray::newInstance(words.size());
+            MiscUtils::arrayCopy(words.get(), 0, cloneContainer->words.get(), 0, words.size());
+        }
+        return cloneContainer;
+    }
+    
+    bool RoaringContainer::contains(int32_t value)
+    {
+        if (type == ARRAY)
+            return (arrayIndex(value) >= 0);
+        else if (type == BITMAP)
+            return ((words[value >> 6] & ((int64_t)1 << (value & 63))) != 0);
+        int32_t run = runIndex(value);
+        return (run >= 0 && value <= values[run << 1] + values[(run << 1) + 1]);
+    }
+    
+    bool RoaringContainer::add(int32_t value)
+    {
+        if (type == RUN)
+        {
+            if (contains(value))
+                return false;
+            if (cardinality < MAX_ARRAY_SIZE)
+                toArray();
+            else
+                toBitmap();
+        }
+        if (type == ARRAY)
+        {
+            int32_t position = cardinality;
+            if (cardinality > 0 && values[cardinality - 1] >= value)
+            {
+                position = arrayIndex(value);
+                if (position >= 0)
+                    return false;
+                position = -position - 1;
+            }
+            if (cardinality == MAX_ARRAY_SIZE)
+            {
+                toBitmap();
+                return add(value);
+            }
+            if (!values || cardinality == values.size())
+                values.resize(std::min(MAX_ARRAY_SIZE, std::max(4, cardinality << 1)));
+            std::copy_backward(values.get() + position, values.get() + cardinality, values.get() + cardinality + 1);
+            values[position] = (uint16_t)value;
+            ++cardinality;
+            return true;
+        }
+        int64_t& word = words[value >> 6];
+        int64_t bit = (int64_t)1 << (value & 63);
+        if ((word & bit) != 0)
+            return false;
+        word |= bit;
+        ++cardinality;
+        return true;
+    }
+    
+    bool RoaringContainer::remove(int32_t value)
+    {
+        if (!contains(value))
+            return false;
+        if (type == RUN)
+        {
+            if (cardinality <= MAX_ARRAY_SIZE)
+                toArray();
+            else
+                toBitmap();
+        }
+        if (type == ARRAY)
+        {
+            int32_t position = arrayIndex(value);
+            std::copy(values.get() + position + 1, values.get() + cardinality, values.get() + position);
+            --cardinality;
+        }
+        else
+        {
+            words[value >> 6] &= ~((int64_t)1 << (value & 63));
+            --cardinality;
+        }
+        return true;
+    }
+    
+    int32_t RoaringContainer::nextValue(int32_t target, int32_t& hint)
+    {
+        if (target > 0xffff || cardinality == 0)
+            return -1;
+        if (type == ARRAY)
+        {
+            // start from the position of the last value found, and check the next value before searching
+            int32_t from = (hint > 0 && hint < cardinality && values[hint] <= target) ? hint : 0;
+            if (values[from] >= target)
+            {
+                hint = from;
+                return values[from];
+            }
+            if (++from < cardinality && values[from] >= target)
+            {
+                hint = from;
+                return values[from];
+            }
+            uint16_t* data = values.get();
+            hint = (int32_t)(std::lower_bound(data + from, data + cardinality, (uint16_t)target) - data);
+            return hint < cardinality ? values[hint] : -1;
+        }
+        else if (type == BITMAP)
+        {
+            int32_t i = target >> 6;
+            int64_t word = words[i] & (int64_t)((uint64_t)-1 << (target & 63));
+            while (word == 0)
+            {
+                if (++i == BITMAP_WORDS)
+                    return -1;
+                word = words[i];
+            }
+            return (i << 6) + BitUtil::ntz(word);
+        }
+        int32_t run = std::max(runIndex(target), 0);
+        if (target > values[run << 1] + values[(run << 1) + 1])
+            ++run;
+        if (run == numRuns)
+            return -1;
+        return std::max(target, (int32_t)values[run << 1]);
+    }
+    
+    int64_t RoaringContainer::sizeInBytes()
+    {
+        if (type == BITMAP)
+            return (int64_t)BITMAP_WORDS * sizeof(int64_t);
+        return values ? (int64_t)values.size() * sizeof(uint16_t) : 0;
+    }
+    
+    void RoaringContainer::optimize()
+    {
+        // a run takes two shorts, an array value one
+        int32_t runShorts = countRuns() << 1;
+        if (runShorts < (BITMAP_WORDS << 2) && (cardinality > MAX_ARRAY_SIZE || runShorts < cardinality))
+            toRun();
+        else if (cardinality <= MAX_ARRAY_SIZE)
+            toArray();
+        else
+            toBitmap();
+    }
+    
+    void RoaringContainer::write(IndexOutputPtr output)
+    {
+        output->writeByte(type);
+        if (type == ARRAY)
+        {
+            // values as gaps from the previous value
+            output->writeVInt(cardinality);
+            int32_t last = 0;
+            for (int32_t i = 0; i < cardinality; ++i)
+            {
+                output->writeVInt(values[i] - last);
+                last = values[i];
+            }
+        }
+        else if (type == BITMAP)
+        {
+            for (int32_t i = 0; i < BITMAP_WORDS; ++i)
+                output->writeLong(words[i]);
+        }
+        else
+        {
+            // each run as the gap from the end of the previous run and its length minus one
+            output->writeVInt(numRuns);
+            int32_t last = 0;
+            for (int32_t run = 0; run < numRuns; ++run)
+            {
+                output->writeVInt(values[run << 1] - last);
+                output->writeVInt(values[(run << 1) + 1]);
+                last = values[run << 1] + values[(run << 1) + 1];
+            }
+        }
+    }
+    
+    RoaringContainerPtr RoaringContainer::read(IndexInputPtr input)
+    {
+        RoaringContainerPtr container(newLucene<RoaringContainer>());
+        container->type = input->readByte();
+        if (container->type == ARRAY)
+        {
+            container->cardinality = input->readVInt();
+            container->values = Array<uint16_t>::newInstance(container->cardinality);
+            int32_t last = 0;
+            for (int32_t i = 0; i < container->cardinality; ++i)
+            {
+                last += input->readVInt();
+                container->values[i] = (uint16_t)last;
+            }
+        }
+        else if (container->type == BITMAP)
+        {
+            container->words = LongArray::newInstance(BITMAP_WORDS);
+            for (int32_t i = 0; i < BITMAP_WORDS; ++i)
+                container->words[i] = input->readLong();
+            container->cardinality = (int32_t)BitUtil::pop_array(container->words.get(), 0, BITMAP_WORDS);
+        }
+        else if (container->type == RUN)
+        {
+            container->numRuns = input->readVInt();
+            container->values = Array<uint16_t>::newInstance(container->numRuns << 1);
+            int32_t last = 0;
+            for (int32_t run = 0; run < container->numRuns; ++run)
+            {
+                int32_t start = last + input->readVInt();
+                int32_t length = input->readVInt();
+                container->values[run << 1] = (uint16_t)start;
+                container->values[(run << 1) + 1] = (uint16_t)length;
+                container->cardinality += length + 1;
+                last = start + length;
+            }
+        }
+        else
+            boost::throw_exception(CorruptIndexException(L"unknown doc id set container type " + StringUtils::toString(container->type)));
+        return container;
+    }
+    
+    RoaringContainerPtr RoaringContainer::_and(RoaringContainerPtr a, RoaringContainerPtr b)
+    {
+        RoaringContainerPtr result;
+        if (a->type == ARRAY || b->type == ARRAY)
+        {
+            RoaringContainerPtr array(a->type == ARRAY ? a : b);
+            RoaringContainerPtr other(a->type == ARRAY ? b : a);
+            result = newLucene<RoaringContainer>();
+            result->values = Array<uint16_t>::newInstance(array->cardinality);
+            for (int32_t i = 0; i < array->cardinality; ++i)
+            {
+                if (other->contains(array->values[i]))
+                    result->values[result->cardinality++] = array->values[i];
+            }
+        }
+        else
+        {
+            LongArray aWords(a->toWords());
+            LongArray bWords(b->toWords());
+            LongArray words(LongArray::newInstance(BITMAP_WORDS));
+            for (int32_t i = 0; i < BITMAP_WORDS; ++i)
+                words[i] = aWords[i] & bWords[i];
+            result = fromWords(words);
+        }
+        if (!result || result->cardinality == 0)
+            return RoaringContainerPtr();
+        result->optimize();
+        return result;
+    }
+    
+    RoaringContainerPtr RoaringContainer::_or(RoaringContainerPtr a, RoaringContainerPtr b)
+    {
+        RoaringContainerPtr result;
+        if (a->type == ARRAY && b->type == ARRAY && a->cardinality + b->cardinality <= MAX_ARRAY_SIZE)
+        {
+            result = newLucene<RoaringContainer>();
+            result->values = Array<uint16_t>::newInstance(a->cardinality + b->cardinality);
+            uint16_t* end = std::set_union(a->values.get(), a->values.get() + a->cardinality, b->values.get(),
+                                           b->values.get() + b->cardinality, result->values.get());
+            result->cardinality = (int32_t)(end - result->values.get());
+        }
+        else
+        {
+            LongArray aWords(a->toWords());
+            LongArray bWords(b->toWords());
+            LongArray words(LongArray::newInstance(BITMAP_WORDS));
+            for (int32_t i = 0; i < BITMAP_WORDS; ++i)
+                words[i] = aWords[i] | bWords[i];
+            result = fromWords(words);
+        }
+        if (!result || result->cardinality == 0)
+            return RoaringContainerPtr();
+        result->optimize();
+        return result;
+    }
+    
+    RoaringContainerPtr RoaringContainer::andNot(RoaringContainerPtr a, RoaringContainerPtr b)
+    {
+        RoaringContainerPtr result;
+        if (a->type == ARRAY)
+        {
+            result = newLucene<RoaringContainer>();
+            result->values = Array<uint16_t>::newInstance(a->cardinality);
+            for (int32_t i = 0; i < a->cardinality; ++i)
+            {
+                if (!b->contains(a->values[i]))
+                    result->values[result->cardinality++] = a->values[i];
+            }
+        }
+        else
+        {
+            LongArray aWords(a->toWords());
+            LongArray bWords(b->toWords());
+            LongArray words(LongArray::newInstance(BITMAP_WORDS));
+            for (int32_t i = 0; i < BITMAP_WORDS; ++i)
+                words[i] = aWords[i] & ~bWords[i];
+            result = fromWords(words);
+        }
+        if (!result || result->cardinality == 0)
+            return RoaringContainerPtr();
+        result->optimize();
+        return result;
+    }
+    
+    int32_t RoaringContainer::intersectionCount(RoaringContainerPtr a, RoaringContainerPtr b)
+    {
+        if (a->type == ARRAY || b->type == ARRAY)
+        {
+            RoaringContainerPtr array(a->type == ARRAY ? a : b);
+            RoaringContainerPtr other(a->type == ARRAY ? b : a);
+            int32_t count = 0;
+            for (int32_t i = 0; i < array->cardinality; ++i)
+            {
+                if (other->contains(array->values[i]))
+                    ++count;
+            }
+            return count;
+        }
+        return (int32_t)BitUtil::pop_intersect(a->toWords().get(), b->toWords().get(), 0, BITMAP_WORDS);
+    }
+    
+    int32_t RoaringContainer::arrayIndex(int32_t value)
+    {
+        int32_t low = 0;
+        int32_t high = cardinality - 1;
+        while (low <= high)
+        {
+            int32_t mid = MiscUtils::unsignedShift(low + high, 1);
+            int32_t midValue = values[mid];
+            if (midValue < value)
+                low = mid + 1;
+            else if (midValue > value)
+                high = mid - 1;
+            else
+                return mid;
+        }
+        return -(low + 1);
+    }
+    
+    int32_t RoaringContainer::runIndex(int32_t value)
+    {
+        int32_t low = 0;
+        int32_t high = numRuns - 1;
+        int32_t run = -1;
+        while (low <= high)
+        {
+            int32_t mid = MiscUtils::unsignedShift(low + high, 1);
+            if (values[mid << 1] <= value)
+            {
+                run = mid;
+                low = mid + 1;
+            }
+            else
+                high = mid - 1;
+        }
+        return run;
+    }
+    
+    int32_t RoaringContainer::countRuns()
+    {
+        if (type == RUN)
+            return numRuns;
+        int32_t runs = 0;
+        if (type == ARRAY)
+        {
+            for (int32_t i = 0; i < cardinality; ++i)
+            {
+                if (i == 0 || values[i] != values[i - 1] + 1)
+                    ++runs;
+            }
+            return runs;
+        }
+        // a run starts at each set bit whose preceding bit is clear
+        uint64_t carry = 0;
+        for (int32_t i = 0; i < BITMAP_WORDS; ++i)
+        {
+            uint64_t word = (uint64_t)words[i];
+            runs += BitUtil::pop((int64_t)(word & ~((word << 1) | carry)));
+            carry = word >> 63;
+        }
+        return runs;
+    }
+    
+    LongArray RoaringContainer::toWords()
+    {
+        if (type == BITMAP)
+            return words;
+        LongArray bits(LongArray::newInstance(BITMAP_WORDS));
+        MiscUtils::arrayFill(bits.get(), 0, BITMAP_WORDS, 0);
+        if (type == ARRAY)
+        {
+            for (int32_t i = 0; i < cardinality; ++i)
+                bits[values[i] >> 6] |= (int64_t)1 << (values[i] & 63);
+        }
+        else
+        {
+            for (int32_t run = 0; run < numRuns; ++run)
+            {
+                int32_t end = values[run << 1] + values[(run << 1) + 1];
+                for (int32_t value = values[run << 1]; value <= end; ++value)
+                    bits[value >> 6] |= (int64_t)1 << (value & 63);
+            }
+        }
+        return bits;
+    }
+    
+    void RoaringContainer::toArray()
+    {
+        if (type == ARRAY)
+        {
+            if (values && values.size() != cardinality)
+                values.resize(cardinality);
+            return;
+        }
+        Array<uint16_t> arrayValues(Array<uint16_t>::newInstance(cardinality));
+        int32_t hint = 0;
+        int32_t count = 0;
+        for (int32_t value = nextValue(0, hint); value != -1; value = nextValue(value + 1, hint))
+            arrayValues[count++] = (uint16_t)value;
+        type = ARRAY;
+        values = arrayValues;
+        numRuns = 0;
+        words.reset();
+    }
+    
+    void RoaringContainer::toBitmap()
+    {
+        if (type == BITMAP)
+            return;
+        words = toWords();
+        type = BITMAP;
+        values.reset();
+        numRuns = 0;
+    }
+    
+    void RoaringContainer::toRun()
+    {
+        if (type == RUN)
+            return;
+        int32_t runs = countRuns();
+        Array<uint16_t> runValues(Array<uint16_t>::newInstance(runs << 1));
+        int32_t hint = 0;
+        int32_t run = -1;
+        int32_t last = -2;
+        for (int32_t value = nextValue(0, hint); value != -1; value = nextValue(value + 1, hint))
+        {
+            if (value == last + 1)
+                ++runValues[(run << 1) + 1];
+            else
+            {
+                ++run;
+                runValues[run << 1] = (uint16_t)value;
+                runValues[(run << 1) + 1] = 0;
+            }
+            last = value;
+        }
+        type = RUN;
+        values = runValues;
+        numRuns = runs;
+        words.reset();
+    }
+    
+    RoaringContainerPtr RoaringContainer::fromWords(LongArray words)
+    {
+        int32_t cardinality = (int32_t)BitUtil::pop_array(words.get(), 0, BITMAP_WORDS);
+        if (cardinality == 0)
+            return RoaringContainerPtr();
+        RoaringContainerPtr container(newLucene<RoaringContainer>());
+        container->type = BITMAP;
+        container->cardinality = cardinality;
+        container->words = words;
+        if (cardinality <= MAX_ARRAY_SIZE)
+            container->toArray();
+        return container;
+    }
+    
+    RoaringDocIdSetIterator::RoaringDocIdSetIterator(RoaringDocIdSetPtr set)
+    {
+        this->set = set;
+        this->doc = -1;
+        this->index = 0;
+        this->hint = 0;
+    }
+    
+    RoaringDocIdSetIterator::~RoaringDocIdSetIterator()
+    {
+    }
+    
+    int32_t RoaringDocIdSetIterator::docID()
+    {
+        return doc;
+    }
+    
+    int32_t RoaringDocIdSetIterator::nextDoc()
+    {
+        if (doc == NO_MORE_DOCS)
+            return doc;
+        return advance(doc + 1);
+    }
+    
+    int32_t RoaringDocIdSetIterator::advance(int32_t target)
+    {
+        int32_t key = target >> 16;
+        if (index < set->keys.size() && set->keys[index] < key)
+        {
+            // skip the containers below the target without looking at them
+            int32_t next = set->findContainer(key, index + 1);
+            index = next >= 0 ? next : -next - 1;
+            hint = 0;
+        }
+        while (index < set->keys.size())
+        {
+            int32_t value = set->containers[index]->nextValue(set->keys[index] == key ? (target & 0xffff) : 0, hint);
+            if (value != -1)
+            {
+                doc = (set->keys[index] << 16) | value;
+                return doc;
+            }
+            ++index;
+            hint = 0;
+        }
+        doc = NO_MORE_DOCS;
+        return doc;
+    }
+}
@@ -6,26 +6,76 @@
 
 #include "LuceneInc.h"
 #include "ThreadPool.h"
+#include "_ThreadPool.h"
 
 namespace Lucene
 {
+    Future::Future()
+    {
+        this->done = false;
+    }
+    
     Future::~Future()
     {
     }
     
+    void Future::set(const boost::any& value)
+    {
+        boost::mutex::scoped_lock futureLock(futureMutex);
+        this->value = value;
+        done = true;
+        futureCondition.notify_all();
+    }
+    
+    void Future::setException(const LuceneException& exception)
+    {
+        boost::mutex::scoped_lock futureLock(futureMutex);
+        this->exception = exception;
+        done = true;
+        futureCondition.notify_all();
+    }
+    
+    bool Future::isDone()
+    {
+        boost::mutex::scoped_lock futureLock(futureMutex);
+        return done;
+    }
+    
+    void Future::run()
+    {
+        ThreadPoolTask task;
+        {
+            boost::mutex::scoped_lock futureLock(futureMutex);
+            if (this->task.empty())
+                return;
+            // dropping the task also releases the reference it holds to this future
+            task.swap(this->task);
+        }
+        task();
+    }
+    
+    void Future::waitForCompletion()
+    {
+        run();
+        
+        // the computation is running on another thread
+        boost::mutex::scoped_lock futureLock(futureMutex);
+        while (!done)
+            futureCondition.wait(futureLock);
+    }
+    
     const int32_t ThreadPool::THREADPOOL_SIZE = 5;
     
-    ThreadPool::ThreadPool()
+    ThreadPool::ThreadPool(int32_t numThreads)
     {
-        work.reset(new boost::asio::io_service::work(io_service));
-        for (int32_t i = 0; i < THREADPOOL_SIZE; ++i)
-            threadGroup.create_thread(boost::bind(&boost::asio::io_service::run, &io_service));
+        if (numThreads < 1)
+            boost::throw_exception(IllegalArgumentException(L"numThreads must be at least 1"));
+        workers = newLucene<ThreadPoolWorkers>(numThreads);
     }
     
     ThreadPool::~ThreadPool()
     {
-        work.reset(); // stop all threads
-        threadGroup.join_all(); // wait for all competition
+        workers->stop();
     }
     
     ThreadPoolPtr ThreadPool::getInstance()
@@ -38,4 +88,155 @@ namespace Lucene
         }
         return threadPool;
     }
+    
+    int32_t ThreadPool::defaultNumThreads()
+    {
+        return std::max((int32_t)boost::thread::hardware_concurrency(), THREADPOOL_SIZE);
+    }
+    
+    int32_t ThreadPool::getNumThreads()
+    {
+        return workers->size();
+    }
+    
+    void ThreadPool::submit(const ThreadPoolTask& task)
+    {
+        workers->submit(task);
+    }
+    
+    ThreadPoolQueue::ThreadPoolQueue()
+    {
+    }
+    
+    ThreadPoolQueue::~ThreadPoolQueue()
+    {
+    }
+    
+    void ThreadPoolQueue::push(const ThreadPoolTask& task)
+    {
+        SyncLock syncLock(this);
+        tasks.push_back(task);
+    }
+    
+    bool ThreadPoolQueue::popBack(ThreadPoolTask& task)
+    {
+        SyncLock syncLock(this);
+        if (tasks.empty())
+            return false;
+        task = tasks.back();
+        tasks.pop_back();
+        return true;
+    }
+    
+    bool ThreadPoolQueue::popFront(ThreadPoolTask& task)
+    {
+        SyncLock syncLock(this);
+        if (tasks.empty())
+            return false;
+        task = tasks.front();
+        tasks.pop_front();
+        return true;
+    }
+    
+    ThreadPoolWorkers::ThreadPoolWorkers(int32_t numThreads)
+    {
+        queues = Collection<ThreadPoolQueuePtr>::newInstance(numThreads);
+        for (int32_t i = 0; i < numThreads; ++i)
+            queues[i] = newLucene<ThreadPoolQueue>();
+        threads = Collection<threadPtr>::newInstance(numThreads);
+        numQueued = 0;
+        numIdle = 0;
+        nextQueue = 0;
+        shutdown = false;
+    }
+    
+    ThreadPoolWorkers::~ThreadPoolWorkers()
+    {
+    }
+    
+    void ThreadPoolWorkers::initialize()
+    {
+        for (int32_t i = 0; i < threads.size(); ++i)
+            threads[i] = newInstance<boost::thread>(boost::bind(&ThreadPoolWorkers::runWorker, shared_from_this(), i));
+    }
+    
+    int32_t ThreadPoolWorkers::size()
+    {
+        return queues.size();
+    }
+    
+    void ThreadPoolWorkers::submit(const ThreadPoolTask& task)
+    {
+        int32_t* worker = currentWorker.get();
+        boost::mutex::scoped_lock idleLock(idleMutex);
+        if (worker != NULL)
+            queues[*worker]->push(task);
+        else
+        {
+            queues[nextQueue]->push(task);
+            nextQueue = (nextQueue + 1) % queues.size();
+        }
+        ++numQueued;
+        if (numIdle > 0)
+            idleCondition.notify_one();
+    }
+    
+    void ThreadPoolWorkers::stop()
+    {
+        {
+            boost::mutex::scoped_lock idleLock(idleMutex);
+            shutdown = true;
+            idleCondition.notify_all();
+        }
+        for (int32_t i = 0; i < threads.size(); ++i)
+        {
+            // a worker releasing the pool carries on with the queued tasks and stops with the others
+            if (threads[i]->get_id() == boost::this_thread::get_id())
+                threads[i]->detach();
+            else
+                threads[i]->join();
+        }
+        threads.clear();
+    }
+    
+    bool ThreadPoolWorkers::runTask(int32_t worker)
+    {
+        ThreadPoolTask task;
+        bool found = queues[worker]->popBack(task);
+        for (int32_t i = 1; !found && i < queues.size(); ++i)
+            found = queues[(worker + i) % queues.size()]->popFront(task);
+        if (!found)
+            return false;
+        {
+            boost::mutex::scoped_lock idleLock(idleMutex);
+            --numQueued;
+        }
+        task();
+        return true;
+    }
+    
+    void ThreadPoolWorkers::runWorker(ThreadPoolWorkersPtr workers, int32_t worker)
+    {
+        workers->currentWorker.reset(new int32_t(worker));
+        while (true)
+        {
+            if (workers->runTask(worker))
+                continue;
+            boost::mutex::scoped_lock idleLock(workers->idleMutex);
+            if (workers->numQueued > 0)
+            {
+                // another worker is taking the last task
+                idleLock.unlock();
+                boost::this_thread::yield();
+                continue;
+            }
+            if (workers->shutdown)
+                break;
+            ++workers->numIdle;
+            workers->idleCondition.wait(idleLock);
+            --workers->numIdle;
+        }
+        workers->currentWorker.reset();
+        ReleaseThreadCache();
+    }
 }
@@ -38,6 +38,21 @@ namespace Lucene
     /// This runs the CheckIndex tool on the index in.  
     /// If any issues are hit, a RuntimeException is thrown; else, true is returned.
     bool checkIndex(DirectoryPtr dir);
+    
+    /// Return the byte at the given position of a file written by writeTestFile.
+    uint8_t testFileByte(int64_t position, int32_t seed = 0);
+    
+    /// Write length bytes of test data to output and close it.
+    void writeTestFile(IndexOutputPtr output, int32_t length, int32_t seed = 0);
+    
+    /// Create a file of length bytes of test data.
+    void writeTestFile(DirectoryPtr dir, const String& name, int32_t length, int32_t seed = 0);
+    
+    /// Check that input holds length bytes of test data, reading it from the current file pointer.
+    void checkTestFile(IndexInputPtr input, int32_t length, int32_t seed = 0);
+    
+    /// Check that a file holds length bytes of test data and nothing more.
+    void checkTestFile(DirectoryPtr dir, const String& name, int32_t length, int32_t seed = 0);
 }
 
 #endif
@@ -0,0 +1,257 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include <boost/algorithm/string.hpp>
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermEnum.h"
+#include "TermDocs.h"
+#include "TermPositions.h"
+#include "IndexFileNames.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(BlockPackedPostingsTest, LuceneTestFixture)
+
+static const int32_t NUM_DOCS = 1000;
+
+static DocumentPtr createDocument(int32_t i)
+{
+    StringStream content;
+    for (int32_t freq = 0; freq <= i % 5; ++freq)
+        content << L"all ";
+    if (i % 2 == 0)
+        content << L"even ";
+    if (i % 7 == 0)
+        content << L"seven seven ";
+    if (i % 97 == 0)
+        content << L"rare ";
+    if (i < 256)
+        content << L"block ";
+    if (i == NUM_DOCS - 1)
+        content << L"last ";
+    content << L"id" << i;
+    DocumentPtr doc(newLucene<Document>());
+    doc->add(newLucene<Field>(L"content", content.str(), Field::STORE_NO, Field::INDEX_ANALYZED));
+    FieldPtr noTf(newLucene<Field>(L"notf", content.str(), Field::STORE_NO, Field::INDEX_ANALYZED));
+    noTf->setOmitTermFreqAndPositions(true);
+    doc->add(noTf);
+    return doc;
+}
+
+static DirectoryPtr createIndex(bool blockPacked, bool optimize)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(false);
+    writer->setUseBlockPackedPostings(blockPacked);
+    writer->setMaxBufferedDocs(300);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    if (optimize)
+        writer->optimize();
+    writer->close();
+    return dir;
+}
+
+static int64_t freqFileLength(DirectoryPtr dir)
+{
+    int64_t length = 0;
+    HashSet<String> files(dir->listAll());
+    for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file)
+    {
+        if (boost::ends_with(*file, L"." + IndexFileNames::FREQ_EXTENSION()))
+            length += dir->fileLength(*file);
+    }
+    return length;
+}
+
+static void checkSameDocs(IndexReaderPtr expected, IndexReaderPtr actual, TermPtr term)
+{
+    TermDocsPtr expectedDocs(expected->termDocs(term));
+    TermDocsPtr actualDocs(actual->termDocs(term));
+    while (expectedDocs->next())
+    {
+        BOOST_CHECK(actualDocs->next());
+        BOOST_CHECK_EQUAL(actualDocs->doc(), expectedDocs->doc());
+        BOOST_CHECK_EQUAL(actualDocs->freq(), expectedDocs->freq());
+    }
+    BOOST_CHECK(!actualDocs->next());
+
+    // bulk read, with a buffer size that doesn't line up with blocks
+    expectedDocs->seek(term);
+    actualDocs->seek(term);
+    Collection<int32_t> docs(Collection<int32_t>::newInstance(50));
+    Collection<int32_t> freqs(Collection<int32_t>::newInstance(50));
+    Collection<int32_t> actualDocsRead(Collection<int32_t>::newInstance(50));
+    Collection<int32_t> actualFreqs(Collection<int32_t>::newInstance(50));
+    while (true)
+    {
+        int32_t n = expectedDocs->read(docs, freqs);
+        BOOST_CHECK_EQUAL(actualDocs->read(actualDocsRead, actualFreqs), n);
+        if (n == 0)
+            break;
+        for (int32_t i = 0; i < n; ++i)
+        {
+            BOOST_CHECK_EQUAL(actualDocsRead[i], docs[i]);
+            BOOST_CHECK_EQUAL(actualFreqs[i], freqs[i]);
+        }
+    }
+
+    // skipping, both from the start and between blocks
+    for (int32_t target = 0; target < NUM_DOCS + 10; target += 61)
+    {
+        expectedDocs->seek(term);
+        actualDocs->seek(term);
+        bool found = expectedDocs->skipTo(target);
+        BOOST_CHECK_EQUAL(actualDocs->skipTo(target), found);
+        if (found)
+        {
+            BOOST_CHECK_EQUAL(actualDocs->doc(), expectedDocs->doc());
+            BOOST_CHECK_EQUAL(actualDocs->freq(), expectedDocs->freq());
+        }
+    }
+    expectedDocs->seek(term);
+    actualDocs->seek(term);
+    for (int32_t target = 3; target < NUM_DOCS; target += 131)
+    {
+        bool found = expectedDocs->skipTo(target);
+        BOOST_CHECK_EQUAL(actualDocs->skipTo(target), found);
+        if (!found)
+            break;
+        BOOST_CHECK_EQUAL(actualDocs->doc(), expectedDocs->doc());
+        found = expectedDocs->next();
+        BOOST_CHECK_EQUAL(actualDocs->next(), found);
+        if (!found)
+            break;
+        BOOST_CHECK_EQUAL(actualDocs->doc(), expectedDocs->doc());
+    }
+
+    expectedDocs->close();
+    actualDocs->close();
+}
+
+static void checkSamePositions(IndexReaderPtr expected, IndexReaderPtr actual, TermPtr term)
+{
+    TermPositionsPtr expectedPositions(expected->termPositions(term));
+    TermPositionsPtr actualPositions(actual->termPositions(term));
+    for (int32_t target = 0; ; target += 3)
+    {
+        // alternate between scanning and skipping so that positions of skipped docs must be skipped too
+        bool found = (target % 2 == 0) ? expectedPositions->next() : expectedPositions->skipTo(expectedPositions->doc() + 200);
+        BOOST_CHECK_EQUAL((target % 2 == 0) ? actualPositions->next() : actualPositions->skipTo(actualPositions->doc() + 200), found);
+        if (!found)
+            break;
+        BOOST_CHECK_EQUAL(actualPositions->doc(), expectedPositions->doc());
+        BOOST_CHECK_EQUAL(actualPositions->freq(), expectedPositions->freq());
+        for (int32_t i = 0; i < expectedPositions->freq(); ++i)
+            BOOST_CHECK_EQUAL(actualPositions->nextPosition(), expectedPositions->nextPosition());
+    }
+    expectedPositions->close();
+    actualPositions->close();
+}
+
+static void checkSameIndex(IndexReaderPtr expected, IndexReaderPtr actual)
+{
+    BOOST_CHECK_EQUAL(actual->numDocs(), expected->numDocs());
+    TermEnumPtr terms(expected->terms());
+    int32_t numTerms = 0;
+    while (terms->next())
+    {
+        TermPtr term(terms->term());
+        BOOST_CHECK_EQUAL(actual->docFreq(term), terms->docFreq());
+        checkSameDocs(expected, actual, term);
+        if (term->field() == L"content" && terms->docFreq() > 1)
+            checkSamePositions(expected, actual, term);
+        ++numTerms;
+    }
+    BOOST_CHECK(numTerms > 2 * NUM_DOCS);
+    terms->close();
+}
+
+BOOST_AUTO_TEST_CASE(testFlushedSegments)
+{
+    DirectoryPtr vintDir(createIndex(false, false));
+    DirectoryPtr packedDir(createIndex(true, false));
+    IndexReaderPtr expected(IndexReader::open(vintDir, true));
+    IndexReaderPtr actual(IndexReader::open(packedDir, true));
+    BOOST_CHECK(actual->getSequentialSubReaders().size() > 1);
+    checkSameIndex(expected, actual);
+    expected->close();
+    actual->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMergedSegment)
+{
+    DirectoryPtr vintDir(createIndex(false, true));
+    DirectoryPtr packedDir(createIndex(true, true));
+    IndexReaderPtr expected(IndexReader::open(vintDir, true));
+    IndexReaderPtr actual(IndexReader::open(packedDir, true));
+    checkSameIndex(expected, actual);
+    expected->close();
+    actual->close();
+
+    // the frequent terms take much less space when packed
+    BOOST_CHECK(freqFileLength(packedDir) < freqFileLength(vintDir));
+}
+
+BOOST_AUTO_TEST_CASE(testDeletions)
+{
+    DirectoryPtr vintDir(createIndex(false, true));
+    DirectoryPtr packedDir(createIndex(true, true));
+    IndexReaderPtr expected(IndexReader::open(vintDir, false));
+    IndexReaderPtr actual(IndexReader::open(packedDir, false));
+    for (int32_t i = 0; i < NUM_DOCS; i += 3)
+    {
+        expected->deleteDocument(i);
+        actual->deleteDocument(i);
+    }
+    checkSameIndex(expected, actual);
+    expected->close();
+    actual->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMixedFormats)
+{
+    // segments in both formats merged into a packed segment, and back
+    DirectoryPtr vintDir(createIndex(false, false));
+    DirectoryPtr mixedDir(createIndex(true, false));
+    IndexWriterPtr writer(newLucene<IndexWriter>(mixedDir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseBlockPackedPostings(false);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    writer->commit();
+
+    IndexReaderPtr actual(IndexReader::open(mixedDir, true));
+    BOOST_CHECK_EQUAL(actual->numDocs(), 2 * NUM_DOCS);
+    BOOST_CHECK_EQUAL(actual->docFreq(newLucene<Term>(L"content", L"all")), 2 * NUM_DOCS);
+    actual->close();
+
+    writer->setUseBlockPackedPostings(true);
+    writer->optimize();
+    writer->close();
+
+    writer = newLucene<IndexWriter>(vintDir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    writer->optimize();
+    writer->close();
+
+    IndexReaderPtr expected(IndexReader::open(vintDir, true));
+    actual = IndexReader::open(mixedDir, true);
+    checkSameIndex(expected, actual);
+    expected->close();
+    actual->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
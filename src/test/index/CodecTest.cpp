@@ -0,0 +1,309 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermDocs.h"
+#include "SegmentInfos.h"
+#include "SegmentInfo.h"
+#include "DefaultCodec.h"
+#include "FormatPostingsFieldsConsumer.h"
+#include "TermInfosReader.h"
+#include "FieldsWriter.h"
+#include "FieldsReader.h"
+#include "TermVectorsWriter.h"
+#include "TermVectorsReader.h"
+#include "TermsHashConsumer.h"
+#include "InvertedDocEndConsumer.h"
+#include "TermPositions.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(CodecTest, LuceneTestFixture)
+
+DECLARE_SHARED_PTR(CountingCodec)
+
+/// Writes the standard file format, counting the segments it writes and opens
+class CountingCodec : public Codec
+{
+public:
+    CountingCodec() : Codec(L"Counting")
+    {
+        delegate = Codec::getDefault();
+        segmentsWritten = 0;
+        segmentsOpened = 0;
+        storesWritten = 0;
+        normsWritten = 0;
+        normsOpened = 0;
+    }
+
+    virtual ~CountingCodec()
+    {
+    }
+
+    LUCENE_CLASS(CountingCodec);
+
+public:
+    CodecPtr delegate;
+    int32_t segmentsWritten;
+    int32_t segmentsOpened;
+    int32_t storesWritten;
+    int32_t normsWritten;
+    int32_t normsOpened;
+
+public:
+    virtual FormatPostingsFieldsConsumerPtr fieldsConsumer(SegmentWriteStatePtr state, FieldInfosPtr fieldInfos)
+    {
+        ++segmentsWritten;
+        return delegate->fieldsConsumer(state, fieldInfos);
+    }
+
+    virtual TermInfosReaderPtr termsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t indexDivisor)
+    {
+        ++segmentsOpened;
+        return delegate->termsReader(dir, segment, fieldInfos, readBufferSize, indexDivisor);
+    }
+
+    virtual TermDocsPtr termDocs(SegmentReaderPtr reader)
+    {
+        return delegate->termDocs(reader);
+    }
+
+    virtual TermPositionsPtr termPositions(SegmentReaderPtr reader)
+    {
+        return delegate->termPositions(reader);
+    }
+
+    virtual IndexInputPtr freqInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize)
+    {
+        return delegate->freqInput(dir, segment, readBufferSize);
+    }
+
+    virtual IndexInputPtr proxInput(DirectoryPtr dir, const String& segment, int32_t readBufferSize)
+    {
+        return delegate->proxInput(dir, segment, readBufferSize);
+    }
+
+    virtual FieldsWriterPtr fieldsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos)
+    {
+        ++storesWritten;
+        return delegate->fieldsWriter(dir, segment, fieldInfos);
+    }
+
+    virtual FieldsReaderPtr fieldsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size)
+    {
+        return delegate->fieldsReader(dir, segment, fieldInfos, readBufferSize, docStoreOffset, size);
+    }
+
+    virtual TermsHashConsumerPtr termVectorsConsumer(DocumentsWriterPtr docWriter)
+    {
+        return delegate->termVectorsConsumer(docWriter);
+    }
+
+    virtual TermVectorsWriterPtr termVectorsWriter(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos)
+    {
+        return delegate->termVectorsWriter(dir, segment, fieldInfos);
+    }
+
+    virtual TermVectorsReaderPtr termVectorsReader(DirectoryPtr dir, const String& segment, FieldInfosPtr fieldInfos, int32_t readBufferSize, int32_t docStoreOffset, int32_t size)
+    {
+        return delegate->termVectorsReader(dir, segment, fieldInfos, readBufferSize, docStoreOffset, size);
+    }
+
+    virtual InvertedDocEndConsumerPtr normsConsumer()
+    {
+        return delegate->normsConsumer();
+    }
+
+    virtual IndexOutputPtr normsOutput(DirectoryPtr dir, const String& segment)
+    {
+        ++normsWritten;
+        return delegate->normsOutput(dir, segment);
+    }
+
+    virtual void writeNorms(IndexOutputPtr out, ByteArray norms, int32_t numDocs, bool reducedPrecision)
+    {
+        delegate->writeNorms(out, norms, numDocs, reducedPrecision);
+    }
+
+    virtual Collection<int64_t> readNormEntries(IndexInputPtr in, int32_t numFields)
+    {
+        ++normsOpened;
+        return delegate->readNormEntries(in, numFields);
+    }
+
+    virtual NormValuesPtr readNorms(IndexInputPtr in, int64_t pos, int32_t numDocs, bool encoded, bool& mapped)
+    {
+        return delegate->readNorms(in, pos, numDocs, encoded, mapped);
+    }
+
+    virtual DocValuesWriterPtr docValuesWriter(DirectoryPtr dir, const String& segment, int32_t numDocs)
+    {
+        return delegate->docValuesWriter(dir, segment, numDocs);
+    }
+
+    virtual DocValuesReaderPtr docValuesReader(DirectoryPtr dir, const String& segment, int32_t readBufferSize)
+    {
+        return delegate->docValuesReader(dir, segment, readBufferSize);
+    }
+};
+
+static void addDocs(IndexWriterPtr writer, int32_t start, int32_t count)
+{
+    for (int32_t i = start; i < start + count; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"content", L"aaa bbb", Field::STORE_NO, Field::INDEX_ANALYZED, Field::TERM_VECTOR_WITH_POSITIONS_OFFSETS));
+        writer->addDocument(doc);
+    }
+}
+
+static void checkIndex(DirectoryPtr dir, int32_t numDocs)
+{
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), numDocs);
+    BOOST_CHECK_EQUAL(reader->docFreq(newLucene<Term>(L"content", L"aaa")), numDocs);
+    for (int32_t i = 0; i < numDocs; ++i)
+    {
+        BOOST_CHECK_EQUAL(reader->document(i)->get(L"id"), StringUtils::toString(i));
+        BOOST_CHECK(reader->getTermFreqVector(i, L"content"));
+    }
+    TermDocsPtr termDocs(reader->termDocs(newLucene<Term>(L"id", L"7")));
+    BOOST_CHECK(termDocs->next());
+    BOOST_CHECK_EQUAL(termDocs->doc(), 7);
+    termDocs->close();
+    reader->close();
+}
+
+static Collection<String> segmentCodecs(DirectoryPtr dir)
+{
+    SegmentInfosPtr infos(newLucene<SegmentInfos>());
+    infos->read(dir);
+    Collection<String> codecs(Collection<String>::newInstance());
+    for (int32_t i = 0; i < infos->size(); ++i)
+        codecs.add(infos->info(i)->getCodecName());
+    return codecs;
+}
+
+static CountingCodecPtr countingCodec()
+{
+    static CountingCodecPtr codec;
+    if (!codec)
+    {
+        codec = newLucene<CountingCodec>();
+        Codec::registerCodec(codec);
+    }
+    return codec;
+}
+
+BOOST_AUTO_TEST_CASE(testDefaultCodec)
+{
+    BOOST_CHECK_EQUAL(Codec::getDefault()->getName(), DefaultCodec::CODEC_NAME);
+    BOOST_CHECK_EQUAL(Codec::forName(DefaultCodec::CODEC_NAME), Codec::getDefault());
+    BOOST_CHECK(Codec::availableCodecs().contains(DefaultCodec::CODEC_NAME));
+
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    BOOST_CHECK_EQUAL(writer->getCodec(), Codec::getDefault());
+    writer->setMaxBufferedDocs(10);
+    addDocs(writer, 0, 25);
+    writer->close();
+
+    Collection<String> codecs(segmentCodecs(dir));
+    BOOST_CHECK_EQUAL(codecs.size(), 3);
+    for (Collection<String>::iterator codec = codecs.begin(); codec != codecs.end(); ++codec)
+        BOOST_CHECK_EQUAL(*codec, DefaultCodec::CODEC_NAME);
+    checkIndex(dir, 25);
+}
+
+BOOST_AUTO_TEST_CASE(testUnknownCodec)
+{
+    BOOST_CHECK_EXCEPTION(Codec::forName(L"NoSuchCodec"), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    BOOST_CHECK_EXCEPTION(writer->setCodec(CodecPtr()), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    writer->close();
+}
+
+BOOST_AUTO_TEST_CASE(testCustomCodec)
+{
+    CountingCodecPtr codec(countingCodec());
+    BOOST_CHECK_EQUAL(Codec::forName(L"Counting"), codec);
+    int32_t segmentsWritten = codec->segmentsWritten;
+    int32_t segmentsOpened = codec->segmentsOpened;
+    int32_t normsWritten = codec->normsWritten;
+    int32_t normsOpened = codec->normsOpened;
+
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setCodec(codec);
+    writer->setMaxBufferedDocs(10);
+    addDocs(writer, 0, 25);
+    writer->commit();
+
+    BOOST_CHECK_EQUAL(codec->segmentsWritten - segmentsWritten, 3);
+    BOOST_CHECK_EQUAL(codec->normsWritten - normsWritten, 3);
+    Collection<String> codecs(segmentCodecs(dir));
+    BOOST_CHECK_EQUAL(codecs.size(), 3);
+    for (Collection<String>::iterator name = codecs.begin(); name != codecs.end(); ++name)
+        BOOST_CHECK_EQUAL(*name, L"Counting");
+    checkIndex(dir, 25);
+    BOOST_CHECK(codec->segmentsOpened - segmentsOpened >= 3);
+    BOOST_CHECK(codec->normsOpened - normsOpened >= 3);
+
+    writer->optimize();
+    writer->close();
+    BOOST_CHECK_EQUAL(codec->segmentsWritten - segmentsWritten, 4);
+    BOOST_CHECK_EQUAL(codec->normsWritten - normsWritten, 4);
+    codecs = segmentCodecs(dir);
+    BOOST_CHECK_EQUAL(codecs.size(), 1);
+    BOOST_CHECK_EQUAL(codecs[0], L"Counting");
+    checkIndex(dir, 25);
+}
+
+BOOST_AUTO_TEST_CASE(testMixedCodecs)
+{
+    CountingCodecPtr codec(countingCodec());
+
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMaxBufferedDocs(10);
+    addDocs(writer, 0, 15);
+
+    // switching codecs flushes the buffered documents and closes the shared doc store
+    int32_t storesWritten = codec->storesWritten;
+    writer->setCodec(codec);
+    addDocs(writer, 15, 15);
+    writer->commit();
+    BOOST_CHECK(codec->storesWritten > storesWritten);
+
+    Collection<String> codecs(segmentCodecs(dir));
+    BOOST_CHECK_EQUAL(codecs.size(), 4);
+    BOOST_CHECK_EQUAL(codecs[0], DefaultCodec::CODEC_NAME);
+    BOOST_CHECK_EQUAL(codecs[1], DefaultCodec::CODEC_NAME);
+    BOOST_CHECK_EQUAL(codecs[2], L"Counting");
+    BOOST_CHECK_EQUAL(codecs[3], L"Counting");
+    checkIndex(dir, 30);
+
+    writer->setCodec(Codec::getDefault());
+    writer->optimize();
+    writer->close();
+    codecs = segmentCodecs(dir);
+    BOOST_CHECK_EQUAL(codecs.size(), 1);
+    BOOST_CHECK_EQUAL(codecs[0], DefaultCodec::CODEC_NAME);
+    checkIndex(dir, 30);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,326 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include <boost/algorithm/string.hpp>
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "NumericField.h"
+#include "DocValuesField.h"
+#include "NumericDocValues.h"
+#include "BinaryDocValues.h"
+#include "SortedDocValues.h"
+#include "IndexFileNames.h"
+#include "Term.h"
+#include "IndexSearcher.h"
+#include "MatchAllDocsQuery.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "TopFieldDocs.h"
+#include "ScoreDoc.h"
+#include "ValueSourceQuery.h"
+#include "NumericDocValuesSource.h"
+#include "DocValues.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(ColumnStrideFieldsTest, LuceneTestFixture)
+
+static const int32_t NUM_DOCS = 57;
+
+static int64_t longValue(int32_t id)
+{
+    return (int64_t)(id % 10) * 100000000000LL - (int64_t)id;
+}
+
+static double doubleValue(int32_t id)
+{
+    return 0.25 + (double)((id * 7) % NUM_DOCS) * 0.5;
+}
+
+static String binaryValue(int32_t id)
+{
+    return id % 5 == 0 ? L"" : L"value" + StringUtils::toString(id) + L"\x00e9";
+}
+
+static bool hasSortedValue(int32_t id)
+{
+    return id % 4 != 3;
+}
+
+static String sortedValue(int32_t id)
+{
+    // few distinct values, so that the dictionary is shared
+    return String(1, (wchar_t)(L'a' + (id * 3) % 7)) + L"\x4e2d";
+}
+
+static DirectoryPtr createIndex(bool useCompoundFile)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMaxBufferedDocs(10);
+    writer->setMergeFactor(100);
+    writer->setUseCompoundFile(useCompoundFile);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+
+        // neither stored nor indexed, so only the doc values are written
+        NumericFieldPtr num(newLucene<NumericField>(L"num", Field::STORE_NO, false));
+        num->setLongValue(longValue(i));
+        num->setDocValuesType(Fieldable::DOC_VALUES_NUMERIC);
+        doc->add(num);
+
+        NumericFieldPtr small(newLucene<NumericField>(L"small", Field::STORE_NO, false));
+        small->setIntValue(NUM_DOCS - i);
+        small->setDocValuesType(Fieldable::DOC_VALUES_NUMERIC);
+        doc->add(small);
+
+        NumericFieldPtr dbl(newLucene<NumericField>(L"dbl", Field::STORE_NO, false));
+        dbl->setDoubleValue(doubleValue(i));
+        dbl->setDocValuesType(Fieldable::DOC_VALUES_NUMERIC);
+        doc->add(dbl);
+
+        doc->add(newLucene<DocValuesField>(L"bin", binaryValue(i), Fieldable::DOC_VALUES_BINARY));
+        if (hasSortedValue(i))
+            doc->add(newLucene<DocValuesField>(L"sorted", sortedValue(i)));
+        writer->addDocument(doc);
+    }
+    writer->close();
+    return dir;
+}
+
+static int32_t countDocValuesFiles(DirectoryPtr dir)
+{
+    HashSet<String> files(dir->listAll());
+    int32_t count = 0;
+    for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file)
+    {
+        if (boost::ends_with(*file, L"." + IndexFileNames::DOC_VALUES_EXTENSION()))
+            ++count;
+    }
+    return count;
+}
+
+static void checkValues(IndexReaderPtr reader)
+{
+    // composite readers don't have per-document values
+    if (reader->getSequentialSubReaders())
+        BOOST_CHECK(!reader->getNumericDocValues(L"num"));
+
+    Collection<IndexReaderPtr> subReaders(reader->getSequentialSubReaders());
+    if (!subReaders)
+        subReaders = newCollection<IndexReaderPtr>(reader);
+
+    for (Collection<IndexReaderPtr>::iterator subReader = subReaders.begin(); subReader != subReaders.end(); ++subReader)
+    {
+        NumericDocValuesPtr num((*subReader)->getNumericDocValues(L"num"));
+        NumericDocValuesPtr dbl((*subReader)->getNumericDocValues(L"dbl"));
+        BinaryDocValuesPtr bin((*subReader)->getBinaryDocValues(L"bin"));
+        SortedDocValuesPtr sorted((*subReader)->getSortedDocValues(L"sorted"));
+        BOOST_REQUIRE(num && dbl && bin && sorted);
+        BOOST_CHECK(!num->isDouble());
+        BOOST_CHECK(dbl->isDouble());
+
+        // wrong type or no values
+        BOOST_CHECK(!(*subReader)->getBinaryDocValues(L"num"));
+        BOOST_CHECK(!(*subReader)->getNumericDocValues(L"sorted"));
+        BOOST_CHECK(!(*subReader)->getNumericDocValues(L"id"));
+
+        for (int32_t doc = 0; doc < (*subReader)->maxDoc(); ++doc)
+        {
+            if ((*subReader)->isDeleted(doc))
+                continue;
+            String idValue((*subReader)->document(doc)->get(L"id"));
+            if (idValue == L"none")
+                continue; // added without values, see testSegmentsWithoutValues
+            int32_t id = StringUtils::toInt(idValue);
+            BOOST_CHECK_EQUAL(num->getLong(doc), longValue(id));
+            BOOST_CHECK_EQUAL(dbl->getDouble(doc), doubleValue(id));
+            BOOST_CHECK_EQUAL(bin->getString(doc), binaryValue(id));
+            if (hasSortedValue(id))
+            {
+                int32_t ord = sorted->getOrd(doc);
+                BOOST_CHECK(ord >= 0 && ord < sorted->getValueCount());
+                BOOST_CHECK_EQUAL(sorted->lookup(ord), sortedValue(id));
+                BOOST_CHECK_EQUAL(sorted->lookupTerm(sortedValue(id)), ord);
+            }
+            else
+            {
+                BOOST_CHECK_EQUAL(sorted->getOrd(doc), -1);
+                BOOST_CHECK(sorted->getString(doc).empty());
+            }
+        }
+
+        for (int32_t ord = 1; ord < sorted->getValueCount(); ++ord)
+            BOOST_CHECK(sorted->lookup(ord - 1) < sorted->lookup(ord));
+        BOOST_CHECK_EQUAL(sorted->lookupTerm(L"0"), -1);
+        BOOST_CHECK_EQUAL(sorted->lookupTerm(L"zz"), -sorted->getValueCount() - 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testValues)
+{
+    for (int32_t i = 0; i < 2; ++i)
+    {
+        DirectoryPtr dir(createIndex(i == 0));
+        if (i == 1)
+            BOOST_CHECK_EQUAL(countDocValuesFiles(dir), 6);
+        IndexReaderPtr reader(IndexReader::open(dir, true));
+        BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 6);
+        checkValues(reader);
+        reader->close();
+        dir->close();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testMergeWithDeletions)
+{
+    for (int32_t i = 0; i < 2; ++i)
+    {
+        DirectoryPtr dir(createIndex(i == 0));
+        IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+        writer->setUseCompoundFile(i == 0);
+        for (int32_t id = 0; id < NUM_DOCS; id += 3)
+            writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(id)));
+        writer->optimize();
+        writer->close();
+
+        if (i == 1)
+            BOOST_CHECK_EQUAL(countDocValuesFiles(dir), 1);
+        IndexReaderPtr reader(IndexReader::open(dir, true));
+        BOOST_CHECK_EQUAL(reader->numDocs(), NUM_DOCS - (NUM_DOCS + 2) / 3);
+        checkValues(reader);
+        reader->close();
+        dir->close();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSegmentsWithoutValues)
+{
+    DirectoryPtr dir(createIndex(false));
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+    DocumentPtr doc(newLucene<Document>());
+    doc->add(newLucene<Field>(L"id", L"none", Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+    writer->addDocument(doc);
+    writer->commit();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    Collection<IndexReaderPtr> subReaders(reader->getSequentialSubReaders());
+    BOOST_CHECK(!subReaders[subReaders.size() - 1]->getNumericDocValues(L"num"));
+    reader->close();
+
+    // documents without values get 0, empty and no ordinal
+    writer->optimize();
+    writer->close();
+    reader = IndexReader::open(dir, true);
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 1);
+    IndexReaderPtr segmentReader(reader->getSequentialSubReaders()[0]);
+    int32_t last = segmentReader->maxDoc() - 1;
+    BOOST_CHECK_EQUAL(segmentReader->document(last)->get(L"id"), L"none");
+    BOOST_CHECK_EQUAL(segmentReader->getNumericDocValues(L"num")->getLong(last), 0);
+    BOOST_CHECK_EQUAL(segmentReader->getNumericDocValues(L"dbl")->getDouble(last), 0.0);
+    BOOST_CHECK(segmentReader->getBinaryDocValues(L"bin")->getString(last).empty());
+    BOOST_CHECK_EQUAL(segmentReader->getSortedDocValues(L"sorted")->getOrd(last), -1);
+    checkValues(reader);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testSort)
+{
+    DirectoryPtr dir(createIndex(true));
+    IndexSearcherPtr searcher(newLucene<IndexSearcher>(dir, true));
+    QueryPtr query(newLucene<MatchAllDocsQuery>());
+
+    // the fields aren't indexed, so these sorts only work from the doc values
+    Collection<ScoreDocPtr> hits(searcher->search(query, FilterPtr(), NUM_DOCS, newLucene<Sort>(newLucene<SortField>(L"num", SortField::LONG)))->scoreDocs);
+    BOOST_CHECK_EQUAL(hits.size(), NUM_DOCS);
+    for (int32_t i = 1; i < hits.size(); ++i)
+        BOOST_CHECK(longValue(StringUtils::toInt(searcher->doc(hits[i - 1]->doc)->get(L"id"))) < longValue(StringUtils::toInt(searcher->doc(hits[i]->doc)->get(L"id"))));
+
+    hits = searcher->search(query, FilterPtr(), NUM_DOCS, newLucene<Sort>(newLucene<SortField>(L"dbl", SortField::DOUBLE, true)))->scoreDocs;
+    for (int32_t i = 1; i < hits.size(); ++i)
+        BOOST_CHECK(doubleValue(StringUtils::toInt(searcher->doc(hits[i - 1]->doc)->get(L"id"))) > doubleValue(StringUtils::toInt(searcher->doc(hits[i]->doc)->get(L"id"))));
+
+    hits = searcher->search(query, FilterPtr(), 5, newLucene<Sort>(newLucene<SortField>(L"small", SortField::INT)))->scoreDocs;
+    BOOST_CHECK_EQUAL(hits.size(), 5);
+    for (int32_t i = 0; i < hits.size(); ++i)
+        BOOST_CHECK_EQUAL(searcher->doc(hits[i]->doc)->get(L"id"), StringUtils::toString(NUM_DOCS - 1 - i));
+
+    // documents without a value sort first
+    hits = searcher->search(query, FilterPtr(), NUM_DOCS, newLucene<Sort>(newLucene<SortField>(L"sorted", SortField::STRING)))->scoreDocs;
+    String previous;
+    for (int32_t i = 0; i < hits.size(); ++i)
+    {
+        int32_t id = StringUtils::toInt(searcher->doc(hits[i]->doc)->get(L"id"));
+        String value(hasSortedValue(id) ? sortedValue(id) : L"");
+        BOOST_CHECK(previous <= value);
+        previous = value;
+    }
+
+    // compare across segments with a small queue
+    hits = searcher->search(query, FilterPtr(), 3, newLucene<Sort>(newLucene<SortField>(L"sorted", SortField::STRING, true)))->scoreDocs;
+    BOOST_CHECK_EQUAL(hits.size(), 3);
+    for (int32_t i = 0; i < hits.size(); ++i)
+        BOOST_CHECK_EQUAL(searcher->doc(hits[i]->doc)->get(L"id").empty(), false);
+    int32_t first = StringUtils::toInt(searcher->doc(hits[0]->doc)->get(L"id"));
+    BOOST_CHECK_EQUAL(sortedValue(first), String(L"g\x4e2d"));
+
+    searcher->close();
+}
+
+BOOST_AUTO_TEST_CASE(testValueSource)
+{
+    DirectoryPtr dir(createIndex(false));
+    IndexSearcherPtr searcher(newLucene<IndexSearcher>(dir, true));
+    ValueSourcePtr source(newLucene<NumericDocValuesSource>(L"dbl"));
+    BOOST_CHECK(source->equals(newLucene<NumericDocValuesSource>(L"dbl")));
+    BOOST_CHECK(!source->equals(newLucene<NumericDocValuesSource>(L"num")));
+
+    Collection<ScoreDocPtr> hits(searcher->search(newLucene<ValueSourceQuery>(source), FilterPtr(), NUM_DOCS)->scoreDocs);
+    BOOST_CHECK_EQUAL(hits.size(), NUM_DOCS);
+    for (int32_t i = 1; i < hits.size(); ++i)
+        BOOST_CHECK(doubleValue(StringUtils::toInt(searcher->doc(hits[i - 1]->doc)->get(L"id"))) > doubleValue(StringUtils::toInt(searcher->doc(hits[i]->doc)->get(L"id"))));
+
+    Collection<IndexReaderPtr> subReaders(searcher->getIndexReader()->getSequentialSubReaders());
+    DocValuesPtr values(source->getValues(subReaders[0]));
+    BOOST_CHECK_EQUAL(values->doubleVal(3), doubleValue(3));
+    BOOST_CHECK_EQUAL(values->intVal(3), (int32_t)doubleValue(3));
+
+    // readers without the field give 0
+    values = newLucene<NumericDocValuesSource>(L"missing")->getValues(subReaders[0]);
+    BOOST_CHECK_EQUAL(values->doubleVal(3), 0.0);
+
+    searcher->close();
+}
+
+BOOST_AUTO_TEST_CASE(testTypeConflict)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    DocumentPtr doc(newLucene<Document>());
+    doc->add(newLucene<DocValuesField>(L"field", L"a"));
+    writer->addDocument(doc);
+
+    doc = newLucene<Document>();
+    doc->add(newLucene<DocValuesField>(L"field", L"b", Fieldable::DOC_VALUES_BINARY));
+    BOOST_CHECK_EXCEPTION(writer->addDocument(doc), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+
+    BOOST_CHECK_EXCEPTION(newLucene<DocValuesField>(L"field", L"a", Fieldable::DOC_VALUES_NONE), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+
+    writer->close();
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), 1);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,216 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "MockRAMDirectory.h"
+#include "MMapDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermQuery.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+#include "NormValues.h"
+#include "Similarity.h"
+#include "FileUtils.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(CompactNormsTest, LuceneTestFixture)
+
+static const int32_t NUM_DOCS = 200;
+
+static void addDocuments(DirectoryPtr dir, int32_t maxBufferedDocs)
+{
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMaxBufferedDocs(maxBufferedDocs);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+
+        // many distinct norms in every document
+        FieldPtr body(newLucene<Field>(L"body", L"common term" + StringUtils::toString(i % 5), Field::STORE_NO, Field::INDEX_ANALYZED));
+        body->setBoost((double)(i % 64 + 1) * 0.25);
+        doc->add(body);
+
+        // the same many distinct norms rounded to at most 16
+        FieldPtr rounded(newLucene<Field>(L"rounded", L"common term" + StringUtils::toString(i % 5), Field::STORE_NO, Field::INDEX_ANALYZED));
+        rounded->setBoost((double)(i % 64 + 1) * 0.25);
+        rounded->setReducedPrecisionNorms(true);
+        doc->add(rounded);
+
+        // a field in few documents
+        if (i % 50 == 7)
+            doc->add(newLucene<Field>(L"rare", L"rare term" + StringUtils::toString(i), Field::STORE_NO, Field::INDEX_ANALYZED));
+
+        writer->addDocument(doc);
+    }
+    writer->close();
+}
+
+static void checkNormValues(IndexReaderPtr reader, const String& field)
+{
+    ByteArray norms(reader->norms(field));
+    NormValuesPtr values(reader->normValues(field));
+    BOOST_CHECK(values);
+    for (int32_t doc = 0; doc < reader->maxDoc(); ++doc)
+        BOOST_CHECK_EQUAL(values->get(doc), norms[doc]);
+
+    ByteArray copy(ByteArray::newInstance(reader->maxDoc()));
+    values->copyTo(copy.get(), 0, reader->maxDoc());
+    BOOST_CHECK(copy.equals(norms));
+}
+
+static int32_t countDistinct(IndexReaderPtr reader, const String& field)
+{
+    NormValuesPtr values(reader->normValues(field));
+    HashSet<int32_t> distinct(HashSet<int32_t>::newInstance());
+    for (int32_t doc = 0; doc < reader->maxDoc(); ++doc)
+        distinct.add(values->get(doc));
+    return distinct.size();
+}
+
+BOOST_AUTO_TEST_CASE(testEncodings)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    addDocuments(dir, NUM_DOCS);
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 1);
+    IndexReaderPtr segment(reader->getSequentialSubReaders()[0]);
+
+    // the encodings are checked first, as norms() loads the norms of a field into a dense byte array
+    BOOST_CHECK_EQUAL(segment->normValues(L"body")->sizeInBytes(), NUM_DOCS);
+    BOOST_CHECK(countDistinct(segment, L"body") > 16);
+
+    // sparse: only the documents with the field are held
+    BOOST_CHECK(segment->normValues(L"rare")->sizeInBytes() < NUM_DOCS / 4);
+    BOOST_CHECK_EQUAL(segment->normValues(L"rare")->get(0), Similarity::encodeNorm(1.0));
+    BOOST_CHECK(segment->normValues(L"rare")->get(7) != Similarity::encodeNorm(1.0));
+
+    // packed: at most 16 norms, half a byte per document
+    BOOST_CHECK(countDistinct(segment, L"rounded") <= 16);
+    BOOST_CHECK(segment->normValues(L"rounded")->sizeInBytes() <= 16 + NUM_DOCS / 2);
+
+    checkNormValues(segment, L"body");
+    checkNormValues(segment, L"rounded");
+    checkNormValues(segment, L"rare");
+    BOOST_CHECK(!segment->normValues(L"missing"));
+
+    // rounding keeps the order of the norms
+    NormValuesPtr body(segment->normValues(L"body"));
+    NormValuesPtr rounded(segment->normValues(L"rounded"));
+    for (int32_t doc = 1; doc < NUM_DOCS; ++doc)
+    {
+        if (body->get(doc) > body->get(doc - 1))
+            BOOST_CHECK(rounded->get(doc) >= rounded->get(doc - 1));
+    }
+
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testScores)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    addDocuments(dir, NUM_DOCS);
+    IndexSearcherPtr searcher(newLucene<IndexSearcher>(dir, true));
+    IndexReaderPtr reader(searcher->getIndexReader());
+
+    // the score of a document that matches one term once is proportional to its norm
+    TopDocsPtr hits(searcher->search(newLucene<TermQuery>(newLucene<Term>(L"rare", L"term57")), 10));
+    BOOST_CHECK_EQUAL(hits->totalHits, 1);
+    BOOST_CHECK_EQUAL(hits->scoreDocs[0]->doc, 57);
+
+    hits = searcher->search(newLucene<TermQuery>(newLucene<Term>(L"body", L"term3")), NUM_DOCS);
+    ByteArray norms(reader->norms(L"body"));
+    BOOST_CHECK_EQUAL(hits->totalHits, NUM_DOCS / 5);
+    for (int32_t i = 1; i < hits->scoreDocs.size(); ++i)
+    {
+        double previous = hits->scoreDocs[i - 1]->score / Similarity::decodeNorm(norms[hits->scoreDocs[i - 1]->doc]);
+        double current = hits->scoreDocs[i]->score / Similarity::decodeNorm(norms[hits->scoreDocs[i]->doc]);
+        BOOST_CHECK_CLOSE_FRACTION(previous, current, 0.00001);
+    }
+
+    searcher->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMergeAndSetNorm)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    addDocuments(dir, 50);
+
+    IndexReaderPtr reader(IndexReader::open(dir, false));
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 4);
+    ByteArray body(reader->norms(L"body"));
+    ByteArray rare(reader->norms(L"rare"));
+    reader->deleteDocument(3);
+    reader->close();
+
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+    writer->optimize();
+    writer->close();
+
+    reader = IndexReader::open(dir, false);
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 1);
+    IndexReaderPtr segment(reader->getSequentialSubReaders()[0]);
+    BOOST_CHECK_EQUAL(segment->maxDoc(), NUM_DOCS - 1);
+    for (int32_t doc = 0; doc < NUM_DOCS - 1; ++doc)
+    {
+        int32_t oldDoc = doc < 3 ? doc : doc + 1;
+        BOOST_CHECK_EQUAL(segment->normValues(L"body")->get(doc), body[oldDoc]);
+        BOOST_CHECK_EQUAL(segment->normValues(L"rare")->get(doc), rare[oldDoc]);
+    }
+    checkNormValues(segment, L"rounded");
+    BOOST_CHECK(countDistinct(segment, L"rounded") <= 16);
+    BOOST_CHECK(segment->normValues(L"rare")->sizeInBytes() < NUM_DOCS / 4);
+
+    // changed norms are written to a separate norms file
+    reader->setNorm(10, L"rare", (uint8_t)42);
+    BOOST_CHECK_EQUAL(segment->normValues(L"rare")->get(10), 42);
+    reader->close();
+
+    reader = IndexReader::open(dir, true);
+    segment = reader->getSequentialSubReaders()[0];
+    BOOST_CHECK_EQUAL(segment->normValues(L"rare")->get(10), 42);
+    checkNormValues(segment, L"rare");
+    checkNormValues(segment, L"body");
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMemoryMapped)
+{
+    String indexDir(FileUtils::joinPath(getTempDir(), L"testCompactNorms"));
+    DirectoryPtr dir(newLucene<MMapDirectory>(indexDir));
+    addDocuments(dir, NUM_DOCS);
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    IndexReaderPtr segment(reader->getSequentialSubReaders()[0]);
+
+    // dense and packed norms are read in place
+    BOOST_CHECK_EQUAL(segment->normValues(L"body")->sizeInBytes(), 0);
+    BOOST_CHECK(segment->normValues(L"rounded")->sizeInBytes() <= 16);
+    checkNormValues(segment, L"body");
+    checkNormValues(segment, L"rounded");
+    checkNormValues(segment, L"rare");
+
+    // a clone shares the norms of the original
+    IndexReaderPtr clone(boost::dynamic_pointer_cast<IndexReader>(segment->clone(true)));
+    checkNormValues(clone, L"body");
+    clone->close();
+
+    reader->close();
+    dir->close();
+    FileUtils::removeDirectory(indexDir);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -11,6 +11,7 @@
 #include "_SimpleFSDirectory.h"
 #include "IndexOutput.h"
 #include "IndexInput.h"
+#include "BufferedIndexInput.h"
 #include "CompoundFileWriter.h"
 #include "CompoundFileReader.h"
 #include "Random.h"
@@ -143,17 +144,6 @@ public:
         cw->close();
     }
     
-    bool isCSIndexInputOpen(IndexInputPtr is)
-    {
-        if (MiscUtils::typeOf<CSIndexInput>(is))
-        {
-            CSIndexInputPtr cis = boost::dynamic_pointer_cast<CSIndexInput>(is);
-            return isSimpleFSIndexInputOpen(cis->base);
-        }
-        else
-            return false;
-    }
-    
     bool isSimpleFSIndexInputOpen(IndexInputPtr is)
     {
         if (MiscUtils::typeOf<SimpleFSIndexInput>(is))
@@ -312,11 +302,12 @@ BOOST_AUTO_TEST_CASE(testClonedStreamsClosing)
     BOOST_CHECK(MiscUtils::typeOf<SimpleFSIndexInput>(expected));
     BOOST_CHECK(isSimpleFSIndexInputOpen(expected));
 
+    // sub-files are slices of the compound file's own stream
     IndexInputPtr one = cr->openInput(L"f11");
-    BOOST_CHECK(isCSIndexInputOpen(one));
+    BOOST_CHECK(isSimpleFSIndexInputOpen(one));
 
     IndexInputPtr two = boost::dynamic_pointer_cast<IndexInput>(one->clone());
-    BOOST_CHECK(isCSIndexInputOpen(two));
+    BOOST_CHECK(isSimpleFSIndexInputOpen(two));
 
     checkSameStreams(expected, one);
     expected->seek(0);
@@ -324,7 +315,7 @@ BOOST_AUTO_TEST_CASE(testClonedStreamsClosing)
 
     // Now close the first stream
     one->close();
-    BOOST_CHECK(isCSIndexInputOpen(one)); // Only close when cr is closed
+    BOOST_CHECK(isSimpleFSIndexInputOpen(one)); // Only close when cr is closed
 
     // The following should really fail since we couldn't expect to access a file once close has been called 
     // on it (regardless of buffering and/or clone magic)
@@ -334,8 +325,8 @@ BOOST_AUTO_TEST_CASE(testClonedStreamsClosing)
 
     // Now close the compound reader
     cr->close();
-    BOOST_CHECK(!isCSIndexInputOpen(one));
-    BOOST_CHECK(!isCSIndexInputOpen(two));
+    BOOST_CHECK(!isSimpleFSIndexInputOpen(one));
+    BOOST_CHECK(!isSimpleFSIndexInputOpen(two));
 
     // The following may also fail since the compound stream is closed
     expected->seek(0);
@@ -541,6 +532,27 @@ BOOST_AUTO_TEST_CASE(testReadPastEOF)
     cr->close();
 }
 
+BOOST_AUTO_TEST_CASE(testSliceBufferSize)
+{
+    setUpLarger();
+
+    CompoundFileReaderPtr cr = newLucene<CompoundFileReader>(dir, L"f.comp", 512);
+    BufferedIndexInputPtr is = boost::dynamic_pointer_cast<BufferedIndexInput>(cr->openInput(L"f2", 2048));
+    BOOST_REQUIRE(is);
+    BOOST_CHECK_EQUAL(is->getBufferSize(), 2048);
+    
+    IndexInputPtr expected = dir->openInput(L"f2");
+    checkSameStreams(expected, is);
+    expected->close();
+    is->close();
+    
+    is = boost::dynamic_pointer_cast<BufferedIndexInput>(cr->openInput(L"f2"));
+    BOOST_REQUIRE(is);
+    BOOST_CHECK_EQUAL(is->getBufferSize(), 512);
+    is->close();
+    cr->close();
+}
+
 /// This test that writes larger than the size of the buffer output will correctly increment the file pointer.
 BOOST_AUTO_TEST_CASE(testLargeWrites)
 {
@@ -0,0 +1,245 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include <boost/algorithm/string.hpp>
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "CompoundStagingDirectory.h"
+#include "MockRAMDirectory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "IndexWriter.h"
+#include "FSDirectory.h"
+#include "LogMergePolicy.h"
+#include "IndexReader.h"
+#include "Term.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "FileUtils.h"
+#include "MiscUtils.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(CompoundStagingDirectoryTest, LuceneTestFixture)
+
+BOOST_AUTO_TEST_CASE(testStaging)
+{
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    CompoundStagingDirectoryPtr staging(newLucene<CompoundStagingDirectory>(dir, L"_1"));
+
+    writeTestFile(staging, L"_1.frq", 1000);
+    writeTestFile(staging, L"_1.fnm", 10);
+    writeTestFile(staging, L"_1.fdt", 100); // doc stores aren't part of the compound file
+    writeTestFile(staging, L"_2.frq", 100); // another segment
+
+    BOOST_CHECK(staging->isStaged(L"_1.frq"));
+    BOOST_CHECK(staging->isStaged(L"_1.fnm"));
+    BOOST_CHECK(!dir->fileExists(L"_1.frq"));
+    BOOST_CHECK(!dir->fileExists(L"_1.fnm"));
+    BOOST_CHECK(!staging->isStaged(L"_1.fdt"));
+    BOOST_CHECK(dir->fileExists(L"_1.fdt"));
+    BOOST_CHECK(dir->fileExists(L"_2.frq"));
+
+    BOOST_CHECK(staging->fileExists(L"_1.frq"));
+    BOOST_CHECK_EQUAL(staging->fileLength(L"_1.frq"), 1000);
+    BOOST_CHECK_EQUAL(staging->listAll().size(), 4);
+    checkTestFile(staging, L"_1.frq", 1000);
+
+    staging->deleteFile(L"_1.fnm");
+    BOOST_CHECK(!staging->fileExists(L"_1.fnm"));
+    staging->close();
+}
+
+BOOST_AUTO_TEST_CASE(testSpill)
+{
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    CompoundStagingDirectoryPtr staging(newLucene<CompoundStagingDirectory>(dir, L"_1", 10000));
+
+    writeTestFile(staging, L"_1.tis", 5000);
+    BOOST_CHECK(staging->isStaged(L"_1.tis"));
+
+    // crosses the budget part way through, the rest is written to the delegate
+    IndexOutputPtr output(staging->createOutput(L"_1.frq"));
+    for (int32_t i = 0; i < 20000; ++i)
+        output->writeByte(testFileByte(i));
+    output->seek(0);
+    output->writeByte(0);
+    output->seek(20000);
+    output->close();
+
+    BOOST_CHECK(!staging->isStaged(L"_1.frq"));
+    BOOST_CHECK(dir->fileExists(L"_1.frq"));
+    BOOST_CHECK_EQUAL(dir->fileLength(L"_1.frq"), 20000);
+
+    // once full, new files go straight to the delegate
+    writeTestFile(staging, L"_1.prx", 100);
+    BOOST_CHECK(!staging->isStaged(L"_1.prx"));
+    BOOST_CHECK(dir->fileExists(L"_1.prx"));
+
+    IndexInputPtr input(dir->openInput(L"_1.frq"));
+    BOOST_CHECK_EQUAL(input->readByte(), 0);
+    for (int32_t i = 1; i < 20000; ++i)
+        BOOST_CHECK_EQUAL(input->readByte(), testFileByte(i));
+    input->close();
+    staging->close();
+}
+
+BOOST_AUTO_TEST_CASE(testUnstage)
+{
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    CompoundStagingDirectoryPtr staging(newLucene<CompoundStagingDirectory>(dir, L"_1"));
+
+    writeTestFile(staging, L"_1.frq", 1000);
+    writeTestFile(staging, L"_1.prx", 2000);
+    BOOST_CHECK_EQUAL(dir->listAll().size(), 0);
+
+    staging->unstage();
+    BOOST_CHECK(!staging->isStaged(L"_1.frq"));
+    BOOST_CHECK(!staging->isStaged(L"_1.prx"));
+    BOOST_CHECK_EQUAL(staging->sizeInBytes(), 0);
+    checkTestFile(dir, L"_1.frq", 1000);
+    checkTestFile(dir, L"_1.prx", 2000);
+    staging->close();
+}
+
+namespace TestStagingFailures
+{
+    class FailOnWrite : public MockDirectoryFailure
+    {
+    public:
+        virtual ~FailOnWrite()
+        {
+        }
+        
+        LUCENE_CLASS(FailOnWrite);
+    
+    public:
+        virtual void eval(MockRAMDirectoryPtr dir)
+        {
+            if (doFail)
+                boost::throw_exception(IOException(L"now failing on write"));
+        }
+    };
+}
+
+BOOST_AUTO_TEST_CASE(testSpillFailure)
+{
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    MockDirectoryFailurePtr failure(newLucene<TestStagingFailures::FailOnWrite>());
+    dir->failOn(failure);
+    CompoundStagingDirectoryPtr staging(newLucene<CompoundStagingDirectory>(dir, L"_1", 10000));
+
+    IndexOutputPtr output(staging->createOutput(L"_1.frq"));
+    for (int32_t i = 0; i < 5000; ++i)
+        output->writeByte(testFileByte(i));
+
+    // crossing the budget spills the file to the delegate, which fails
+    failure->setDoFail();
+    ByteArray bytes(ByteArray::newInstance(10000));
+    MiscUtils::arrayFill(bytes.get(), 0, bytes.size(), 0);
+    BOOST_CHECK_EXCEPTION(output->writeBytes(bytes.get(), 0, bytes.size()), IOException, check_exception(LuceneException::IO));
+    failure->clearDoFail();
+
+    // the staged copy is left for the failed flush or merge to discard
+    BOOST_CHECK(staging->isStaged(L"_1.frq"));
+    BOOST_CHECK_EQUAL(staging->fileLength(L"_1.frq"), 15000);
+    output->close();
+    staging->deleteFile(L"_1.frq");
+    BOOST_CHECK(!staging->fileExists(L"_1.frq"));
+    staging->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testUnstageFailure)
+{
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    MockDirectoryFailurePtr failure(newLucene<TestStagingFailures::FailOnWrite>());
+    dir->failOn(failure);
+    CompoundStagingDirectoryPtr staging(newLucene<CompoundStagingDirectory>(dir, L"_1"));
+
+    writeTestFile(staging, L"_1.frq", 1000);
+    writeTestFile(staging, L"_1.prx", 2000);
+
+    failure->setDoFail();
+    BOOST_CHECK_EXCEPTION(staging->unstage(), IOException, check_exception(LuceneException::IO));
+    failure->clearDoFail();
+
+    // files that failed to be written out are still staged, so unstaging can be retried
+    BOOST_CHECK(staging->sizeInBytes() > 0);
+    staging->unstage();
+    BOOST_CHECK_EQUAL(staging->sizeInBytes(), 0);
+    checkTestFile(dir, L"_1.frq", 1000);
+    checkTestFile(dir, L"_1.prx", 2000);
+    staging->close();
+    dir->close();
+}
+
+static void addDocs(IndexWriterPtr writer, int32_t numDocs)
+{
+    for (int32_t i = 0; i < numDocs; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"content", L"aaa bbb " + StringUtils::toString(i), Field::STORE_YES, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+}
+
+static void checkNoSegmentFiles(DirectoryPtr dir, const String& extension)
+{
+    HashSet<String> files(dir->listAll());
+    for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file)
+        BOOST_CHECK(!boost::ends_with(*file, extension));
+}
+
+BOOST_AUTO_TEST_CASE(testIndexWriterCompoundFile)
+{
+    // a directory held in RAM has no writes to save, so only a file system directory stages
+    BOOST_CHECK(!CompoundStagingDirectory::isWorthStaging(newLucene<MockRAMDirectory>()));
+    String dirPath(getTempDir(L"lucene.test.staging"));
+    DirectoryPtr dir(FSDirectory::open(dirPath));
+    BOOST_CHECK(CompoundStagingDirectory::isWorthStaging(dir));
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMaxBufferedDocs(10);
+    writer->setMergeFactor(3);
+    // the optimized segment would otherwise be too large a part of the index to use a compound file
+    boost::dynamic_pointer_cast<LogMergePolicy>(writer->getMergePolicy())->setNoCFSRatio(1.0);
+    addDocs(writer, 95);
+    writer->optimize();
+    writer->close();
+
+    // flushed and merged segments only ever reached the directory as compound files
+    checkNoSegmentFiles(dir, L".frq");
+    checkNoSegmentFiles(dir, L".prx");
+    checkNoSegmentFiles(dir, L".tis");
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), 95);
+    BOOST_CHECK_EQUAL(reader->docFreq(newLucene<Term>(L"content", L"aaa")), 95);
+    reader->close();
+    dir->close();
+    FileUtils::removeDirectory(dirPath);
+}
+
+BOOST_AUTO_TEST_CASE(testIndexWriterNoCompoundFile)
+{
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(false);
+    writer->setMaxBufferedDocs(10);
+    addDocs(writer, 25);
+    writer->close();
+
+    checkNoSegmentFiles(dir, L".cfs");
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), 25);
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,180 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "IndexInput.h"
+#include "FieldsWriter.h"
+#include "SetBasedFieldSelector.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(CompressedStoredFieldsTest, LuceneTestFixture)
+
+static const int32_t NUM_DOCS = 500;
+
+static String bodyText(int32_t i)
+{
+    String body(L"document " + StringUtils::toString(i));
+    for (int32_t j = 0; j < i % 20; ++j)
+        body += L" stored field text " + StringUtils::toString(j % 3);
+    return body;
+}
+
+static ByteArray binaryValue(int32_t i)
+{
+    // every tenth document is larger than a chunk
+    ByteArray bytes(ByteArray::newInstance(i % 10 == 0 ? 3 * FieldsWriter::CHUNK_SIZE / 2 : i % 50));
+    for (int32_t j = 0; j < bytes.size(); ++j)
+        bytes[j] = (uint8_t)((i + j * j) % 251);
+    return bytes;
+}
+
+static DocumentPtr createDocument(int32_t i)
+{
+    DocumentPtr doc(newLucene<Document>());
+    doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+    doc->add(newLucene<Field>(L"body", bodyText(i), Field::STORE_YES, Field::INDEX_ANALYZED));
+    if (i % 7 != 0)
+        doc->add(newLucene<Field>(L"bin", binaryValue(i), Field::STORE_YES));
+    doc->add(newLucene<Field>(L"unstored", L"not stored", Field::STORE_NO, Field::INDEX_ANALYZED));
+    return doc;
+}
+
+static void checkDocument(DocumentPtr doc, int32_t i)
+{
+    BOOST_CHECK_EQUAL(doc->get(L"id"), StringUtils::toString(i));
+    BOOST_CHECK_EQUAL(doc->get(L"body"), bodyText(i));
+    BOOST_CHECK(doc->get(L"unstored").empty());
+    ByteArray bytes(doc->getBinaryValue(L"bin"));
+    if (i % 7 == 0)
+        BOOST_CHECK(!bytes);
+    else
+    {
+        ByteArray expected(binaryValue(i));
+        BOOST_CHECK(bytes.equals(expected));
+    }
+}
+
+static DirectoryPtr createIndex(int32_t maxBufferedDocs)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(false);
+    writer->setMaxBufferedDocs(maxBufferedDocs);
+    writer->setMergeFactor(100);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    writer->close();
+    return dir;
+}
+
+BOOST_AUTO_TEST_CASE(testFormat)
+{
+    DirectoryPtr dir(createIndex(NUM_DOCS));
+    IndexInputPtr input(dir->openInput(L"_0.fdx"));
+    BOOST_CHECK_EQUAL(input->readInt(), FieldsWriter::FORMAT_COMPRESSED_CHUNKS);
+    input->close();
+
+    // the text of the documents is highly redundant, so the chunks compress well
+    int64_t rawLength = 0;
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        rawLength += bodyText(i).length() + (i % 7 != 0 ? binaryValue(i).size() : 0);
+    BOOST_CHECK(dir->fileLength(L"_0.fdt") < rawLength / 2);
+}
+
+BOOST_AUTO_TEST_CASE(testSequentialAndRandomAccess)
+{
+    DirectoryPtr dir(createIndex(NUM_DOCS));
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->maxDoc(), NUM_DOCS);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        checkDocument(reader->document(i), i);
+
+    RandomPtr random(newLucene<Random>(17));
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        int32_t n = random->nextInt(NUM_DOCS);
+        checkDocument(reader->document(n), n);
+    }
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testLazyFieldsOutliveChunk)
+{
+    DirectoryPtr dir(createIndex(NUM_DOCS));
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    HashSet<String> lazyFieldNames(HashSet<String>::newInstance());
+    lazyFieldNames.add(L"body");
+    lazyFieldNames.add(L"bin");
+    FieldSelectorPtr fieldSelector(newLucene<SetBasedFieldSelector>(HashSet<String>::newInstance(), lazyFieldNames));
+
+    Collection<DocumentPtr> docs(Collection<DocumentPtr>::newInstance());
+    for (int32_t i = 1; i < NUM_DOCS; i += 50)
+        docs.add(reader->document(i, fieldSelector));
+
+    // the lazy fields are read after later chunks were loaded
+    int32_t i = 1;
+    for (Collection<DocumentPtr>::iterator doc = docs.begin(); doc != docs.end(); ++doc, i += 50)
+    {
+        FieldablePtr body((*doc)->getFieldable(L"body"));
+        BOOST_CHECK(body->isLazy());
+        BOOST_CHECK_EQUAL(body->stringValue(), bodyText(i));
+        FieldablePtr bin((*doc)->getFieldable(L"bin"));
+        if (i % 7 == 0)
+            BOOST_CHECK(!bin);
+        else
+        {
+            BOOST_CHECK(bin->isLazy());
+            BOOST_CHECK(bin->getBinaryValue().equals(binaryValue(i)));
+        }
+    }
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMergeWithDeletions)
+{
+    DirectoryPtr dir(createIndex(37));
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+    for (int32_t i = 0; i < NUM_DOCS; i += 3)
+        writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(i)));
+    writer->optimize();
+    writer->close();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->maxDoc(), NUM_DOCS - (NUM_DOCS + 2) / 3);
+    int32_t n = 0;
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+    {
+        if (i % 3 != 0)
+            checkDocument(reader->document(n++), i);
+    }
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMergeWithoutDeletions)
+{
+    DirectoryPtr dir(createIndex(37));
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+    writer->optimize();
+    writer->close();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->maxDoc(), NUM_DOCS);
+    for (int32_t i = NUM_DOCS - 1; i >= 0; --i)
+        checkDocument(reader->document(i), i);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,361 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "SegmentReader.h"
+#include "SegmentInfo.h"
+#include "Analyzer.h"
+#include "WhitespaceTokenizer.h"
+#include "TokenFilter.h"
+#include "PayloadAttribute.h"
+#include "Payload.h"
+#include "Document.h"
+#include "Field.h"
+#include "NumericField.h"
+#include "NumericDocValues.h"
+#include "Term.h"
+#include "TermEnum.h"
+#include "TermPositions.h"
+#include "TermFreqVector.h"
+#include "IndexSearcher.h"
+#include "MatchAllDocsQuery.h"
+#include "TermQuery.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "TopFieldCollector.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+#include "EarlyTerminatingSortingCollector.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(IndexSortingTest, LuceneTestFixture)
+
+static const int32_t NUM_DOCS = 97;
+
+/// Gives each token a payload of 0 to 2 bytes, depending on its position in the field.
+class SortingPayloadFilter : public TokenFilter
+{
+public:
+    SortingPayloadFilter(TokenStreamPtr input) : TokenFilter(input)
+    {
+        payloadAtt = addAttribute<PayloadAttribute>();
+        count = 0;
+    }
+    
+    virtual ~SortingPayloadFilter()
+    {
+    }
+    
+    LUCENE_CLASS(SortingPayloadFilter);
+
+protected:
+    PayloadAttributePtr payloadAtt;
+    int32_t count;
+
+public:
+    virtual bool incrementToken()
+    {
+        if (!input->incrementToken())
+            return false;
+        int32_t length = count % 3;
+        if (length == 0)
+            payloadAtt->setPayload(PayloadPtr());
+        else
+        {
+            ByteArray data(ByteArray::newInstance(length));
+            for (int32_t i = 0; i < length; ++i)
+                data[i] = (uint8_t)(count + i);
+            payloadAtt->setPayload(newLucene<Payload>(data));
+        }
+        ++count;
+        return true;
+    }
+};
+
+class SortingPayloadAnalyzer : public Analyzer
+{
+public:
+    virtual ~SortingPayloadAnalyzer()
+    {
+    }
+    
+    LUCENE_CLASS(SortingPayloadAnalyzer);
+
+public:
+    virtual TokenStreamPtr tokenStream(const String& fieldName, ReaderPtr reader)
+    {
+        return newLucene<SortingPayloadFilter>(newLucene<WhitespaceTokenizer>(reader));
+    }
+};
+
+/// A permutation of the ids, so that the order of the ranks has nothing to do with the order of the ids.
+static int32_t rank(int32_t id)
+{
+    return (id * 37) % NUM_DOCS;
+}
+
+static DocumentPtr createDocument(int32_t id)
+{
+    DocumentPtr doc(newLucene<Document>());
+    doc->add(newLucene<Field>(L"id", StringUtils::toString(id), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+    doc->add(newLucene<Field>(L"rank", StringUtils::toString(rank(id)), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+    doc->add(newLucene<Field>(L"group", L"g" + StringUtils::toString(id % 4), Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+
+    StringStream body;
+    body << L"all";
+    for (int32_t i = 0; i <= id % 3; ++i)
+        body << L" w" << (id % 5);
+    body << L" id" << id;
+    FieldPtr bodyField(newLucene<Field>(L"body", body.str(), Field::STORE_NO, Field::INDEX_ANALYZED, Field::TERM_VECTOR_WITH_POSITIONS));
+    bodyField->setBoost(1.0 + (double)(id % 3));
+    doc->add(bodyField);
+
+    NumericFieldPtr dv(newLucene<NumericField>(L"dv", Field::STORE_NO, false));
+    dv->setLongValue((int64_t)id * 3);
+    dv->setDocValuesType(Fieldable::DOC_VALUES_NUMERIC);
+    doc->add(dv);
+    return doc;
+}
+
+static SortPtr rankSort(bool reverse)
+{
+    return newLucene<Sort>(newLucene<SortField>(L"rank", SortField::INT, reverse));
+}
+
+static IndexWriterPtr createWriter(DirectoryPtr dir, SortPtr sort, bool useCompoundFile)
+{
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<SortingPayloadAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMaxBufferedDocs(10);
+    writer->setMergeFactor(100);
+    writer->setUseCompoundFile(useCompoundFile);
+    writer->setIndexSort(sort);
+    return writer;
+}
+
+/// An index of the same documents in the order they were added, to compare against.
+static IndexReaderPtr createReference()
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<SortingPayloadAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    writer->optimize();
+    writer->close();
+    return IndexReader::open(dir, true);
+}
+
+static int32_t idOf(IndexReaderPtr reader, int32_t doc)
+{
+    return StringUtils::toInt(reader->document(doc)->get(L"id"));
+}
+
+/// Checks that the documents of a segment are in rank order, and that their norms, doc values, term vectors
+/// and postings (with their payloads) moved with them.
+static void checkSegment(IndexReaderPtr segment, IndexReaderPtr reference, bool reverse)
+{
+    ByteArray norms(segment->norms(L"body"));
+    ByteArray referenceNorms(reference->norms(L"body"));
+    NumericDocValuesPtr values(segment->getNumericDocValues(L"dv"));
+    BOOST_CHECK(values);
+
+    int32_t lastRank = -1;
+    for (int32_t doc = 0; doc < segment->maxDoc(); ++doc)
+    {
+        if (segment->isDeleted(doc))
+            continue;
+        int32_t id = idOf(segment, doc);
+        int32_t docRank = StringUtils::toInt(segment->document(doc)->get(L"rank"));
+        BOOST_CHECK_EQUAL(docRank, rank(id));
+        if (lastRank != -1)
+            BOOST_CHECK(reverse ? docRank < lastRank : docRank > lastRank);
+        lastRank = docRank;
+
+        BOOST_CHECK_EQUAL(norms[doc], referenceNorms[id]);
+        BOOST_CHECK_EQUAL(values->getLong(doc), (int64_t)id * 3);
+
+        TermFreqVectorPtr vector(segment->getTermFreqVector(doc, L"body"));
+        TermFreqVectorPtr referenceVector(reference->getTermFreqVector(id, L"body"));
+        BOOST_CHECK(vector->getTerms().equals(referenceVector->getTerms()));
+        BOOST_CHECK(vector->getTermFrequencies().equals(referenceVector->getTermFrequencies()));
+    }
+
+    TermEnumPtr terms(segment->terms(newLucene<Term>(L"body", L"")));
+    do
+    {
+        TermPtr term(terms->term());
+        if (!term || term->field() != L"body")
+            break;
+        TermPositionsPtr positions(segment->termPositions(term));
+        TermPositionsPtr referencePositions(reference->termPositions());
+        int32_t lastDoc = -1;
+        while (positions->next())
+        {
+            BOOST_CHECK(positions->doc() > lastDoc);
+            lastDoc = positions->doc();
+            
+            // the ids of the sorted docs are not in order, so the reference postings are sought again for each
+            int32_t id = idOf(segment, positions->doc());
+            referencePositions->seek(term);
+            BOOST_CHECK(referencePositions->skipTo(id));
+            BOOST_CHECK_EQUAL(referencePositions->doc(), id);
+            BOOST_CHECK_EQUAL(positions->freq(), referencePositions->freq());
+            for (int32_t i = 0; i < positions->freq(); ++i)
+            {
+                BOOST_CHECK_EQUAL(positions->nextPosition(), referencePositions->nextPosition());
+                BOOST_CHECK_EQUAL(positions->getPayloadLength(), referencePositions->getPayloadLength());
+                if (referencePositions->isPayloadAvailable())
+                {
+                    ByteArray payload(positions->getPayload(ByteArray(), 0));
+                    ByteArray referencePayload(referencePositions->getPayload(ByteArray(), 0));
+                    BOOST_CHECK(payload.equals(referencePayload));
+                }
+            }
+        }
+        positions->close();
+        referencePositions->close();
+    }
+    while (terms->next());
+    terms->close();
+}
+
+static void checkIndex(DirectoryPtr dir, SortPtr sort, bool reverse, int32_t expectedSegments)
+{
+    IndexReaderPtr reference(createReference());
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    Collection<IndexReaderPtr> segments(reader->getSequentialSubReaders());
+    BOOST_CHECK_EQUAL(segments.size(), expectedSegments);
+    for (Collection<IndexReaderPtr>::iterator segment = segments.begin(); segment != segments.end(); ++segment)
+    {
+        SegmentReaderPtr segmentReader(boost::dynamic_pointer_cast<SegmentReader>(*segment));
+        BOOST_CHECK_EQUAL(segmentReader->getSegmentInfo()->getIndexSort(), sort->getSort()[0]->toString());
+        checkSegment(*segment, reference, reverse);
+    }
+    reader->close();
+    reference->close();
+}
+
+BOOST_AUTO_TEST_CASE(testFlushedSegments)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(createWriter(dir, rankSort(false), false));
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    writer->close();
+    checkIndex(dir, rankSort(false), false, 10);
+}
+
+BOOST_AUTO_TEST_CASE(testMergedSegments)
+{
+    for (int32_t useCompoundFile = 0; useCompoundFile < 2; ++useCompoundFile)
+    {
+        DirectoryPtr dir(newLucene<MockRAMDirectory>());
+        IndexWriterPtr writer(createWriter(dir, rankSort(true), useCompoundFile == 1));
+        for (int32_t i = 0; i < NUM_DOCS; ++i)
+            writer->addDocument(createDocument(i));
+        writer->optimize();
+        writer->close();
+        checkIndex(dir, rankSort(true), true, 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testDeletes)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(createWriter(dir, rankSort(false), true));
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+    {
+        writer->addDocument(createDocument(i));
+
+        // some deletes are buffered with the documents they delete, others come after the flush
+        if (i % 7 == 3)
+            writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(i - 1)));
+        if (i % 25 == 24)
+            writer->deleteDocuments(newLucene<Term>(L"id", StringUtils::toString(i - 15)));
+    }
+    writer->commit();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    int32_t numDocs = reader->numDocs();
+    BOOST_CHECK_EQUAL(numDocs, NUM_DOCS - 16);
+    reader->close();
+    checkIndex(dir, rankSort(false), false, 10);
+
+    writer->optimize();
+    writer->close();
+    checkIndex(dir, rankSort(false), false, 1);
+
+    reader = IndexReader::open(dir, true);
+    BOOST_CHECK_EQUAL(reader->numDocs(), numDocs);
+    BOOST_CHECK_EQUAL(reader->maxDoc(), numDocs);
+    BOOST_CHECK_EQUAL(reader->docFreq(newLucene<Term>(L"id", L"2")), 0);
+    BOOST_CHECK_EQUAL(reader->docFreq(newLucene<Term>(L"id", L"9")), 0);
+    BOOST_CHECK_EQUAL(reader->docFreq(newLucene<Term>(L"id", L"3")), 1);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testUnsortableSort)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(createWriter(dir, SortPtr(), false));
+    BOOST_CHECK_EXCEPTION(writer->setIndexSort(newLucene<Sort>()), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    BOOST_CHECK(!writer->getIndexSort());
+    writer->close();
+}
+
+BOOST_AUTO_TEST_CASE(testEarlyTermination)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(createWriter(dir, SortPtr(), false));
+
+    // the first segment is written before the sort is set, so it has to be collected in full
+    for (int32_t i = 0; i < 10; ++i)
+        writer->addDocument(createDocument(i));
+    writer->setIndexSort(rankSort(false));
+    for (int32_t i = 10; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    writer->close();
+
+    IndexSearcherPtr searcher(newLucene<IndexSearcher>(dir, true));
+    Collection<QueryPtr> queries(newCollection<QueryPtr>(newLucene<MatchAllDocsQuery>(), newLucene<TermQuery>(newLucene<Term>(L"body", L"w2"))));
+    Collection<SortPtr> sorts(newCollection<SortPtr>(rankSort(false), newLucene<Sort>(newCollection<SortFieldPtr>(newLucene<SortField>(L"rank", SortField::INT), newLucene<SortField>(L"group", SortField::STRING)))));
+    for (Collection<QueryPtr>::iterator query = queries.begin(); query != queries.end(); ++query)
+    {
+        for (Collection<SortPtr>::iterator sort = sorts.begin(); sort != sorts.end(); ++sort)
+        {
+            TopFieldCollectorPtr full(TopFieldCollector::create(*sort, 5, true, false, false, true));
+            searcher->search(*query, full);
+            TopFieldCollectorPtr early(TopFieldCollector::create(*sort, 5, true, false, false, true));
+            searcher->search(*query, newLucene<EarlyTerminatingSortingCollector>(early, *sort, 5));
+
+            Collection<ScoreDocPtr> fullDocs(full->topDocs()->scoreDocs);
+            Collection<ScoreDocPtr> earlyDocs(early->topDocs()->scoreDocs);
+            BOOST_CHECK_EQUAL(fullDocs.size(), 5);
+            BOOST_CHECK_EQUAL(earlyDocs.size(), fullDocs.size());
+            for (int32_t i = 0; i < fullDocs.size(); ++i)
+                BOOST_CHECK_EQUAL(earlyDocs[i]->doc, fullDocs[i]->doc);
+            BOOST_CHECK(early->getTotalHits() <= full->getTotalHits());
+        }
+    }
+
+    // only the first segment and five documents of each sorted segment are collected
+    TopFieldCollectorPtr collector(TopFieldCollector::create(rankSort(false), 5, true, false, false, true));
+    searcher->search(newLucene<MatchAllDocsQuery>(), newLucene<EarlyTerminatingSortingCollector>(collector, rankSort(false), 5));
+    BOOST_CHECK_EQUAL(collector->getTotalHits(), 10 + 5 * 9);
+
+    // a sort the segments aren't ordered by collects everything
+    SortPtr other(rankSort(true));
+    collector = TopFieldCollector::create(other, 5, true, false, false, true);
+    searcher->search(newLucene<MatchAllDocsQuery>(), newLucene<EarlyTerminatingSortingCollector>(collector, other, 5));
+    BOOST_CHECK_EQUAL(collector->getTotalHits(), NUM_DOCS);
+    searcher->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
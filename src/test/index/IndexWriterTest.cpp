@@ -129,7 +129,7 @@ public:
     }
 };
 
-/// Throws IOException during FieldsWriter.flushDocument and during DocumentsWriter.abort
+/// Throws IOException during FieldsWriter.flushDocument or FieldsWriter.flushChunk and during DocumentsWriter.abort
 class FailOnlyOnAbortOrFlush : public MockDirectoryFailure
 {
 public:
@@ -150,7 +150,7 @@ public:
     {
         if (doFail)
         {
-            if (TestPoint::getTestPoint(L"abort") || TestPoint::getTestPoint(L"flushDocument"))
+            if (TestPoint::getTestPoint(L"abort") || TestPoint::getTestPoint(L"flushDocument") || TestPoint::getTestPoint(L"flushChunk"))
             {
                 if (onlyOnce)
                     doFail = false;
@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermDocs.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(SkipImpactsTest, LuceneTestFixture)
+
+static const int32_t NUM_DOCS = 1000;
+static const int32_t PEAK_DOC = 500;
+
+static DocumentPtr createDocument(int32_t i)
+{
+    StringStream content;
+    int32_t freq = i == PEAK_DOC ? 20 : i % 3 + 1;
+    for (int32_t j = 0; j < freq; ++j)
+        content << L"all ";
+    if (i % 4 == 0)
+        content << L"some ";
+    DocumentPtr doc(newLucene<Document>());
+    FieldPtr field(newLucene<Field>(L"content", content.str(), Field::STORE_NO, Field::INDEX_ANALYZED));
+    field->setBoost(i % 100 == 50 ? 8.0 : 1.0);
+    doc->add(field);
+    FieldPtr noTf(newLucene<Field>(L"notf", content.str(), Field::STORE_NO, Field::INDEX_ANALYZED));
+    noTf->setOmitTermFreqAndPositions(true);
+    doc->add(noTf);
+    FieldPtr noNorms(newLucene<Field>(L"nonorms", content.str(), Field::STORE_NO, Field::INDEX_ANALYZED_NO_NORMS));
+    doc->add(noNorms);
+    return doc;
+}
+
+static DirectoryPtr createIndex(bool blockPacked, int32_t maxBufferedDocs, bool optimize)
+{
+    DirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseBlockPackedPostings(blockPacked);
+    writer->setMaxBufferedDocs(maxBufferedDocs);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+        writer->addDocument(createDocument(i));
+    if (optimize)
+        writer->optimize();
+    writer->close();
+    return dir;
+}
+
+/// Checks that the bounds returned for each target hold for every doc from the target up to the end of its
+/// block, and that skipping still finds the same docs afterwards.  Returns the number of bounded blocks.
+static int32_t checkBounds(IndexReaderPtr segment, TermPtr term)
+{
+    ByteArray norms(segment->norms(term->field()));
+    TermDocsPtr termDocs(segment->termDocs(term));
+    int32_t bounded = 0;
+    for (int32_t target = 0; target < segment->maxDoc(); target += 13)
+    {
+        int32_t maxFreq = 0;
+        int32_t maxNorm = 0;
+        int32_t upTo = termDocs->advanceShallow(target, maxFreq, maxNorm);
+        BOOST_CHECK(upTo >= target);
+        if (upTo != INT_MAX)
+            ++bounded;
+
+        TermDocsPtr expected(segment->termDocs(term));
+        bool more = expected->skipTo(target);
+        bool skipped = termDocs->skipTo(target);
+        BOOST_CHECK_EQUAL(skipped, more);
+        if (!more)
+            break;
+        BOOST_CHECK_EQUAL(termDocs->doc(), expected->doc());
+        BOOST_CHECK_EQUAL(termDocs->freq(), expected->freq());
+
+        while (more && expected->doc() <= upTo)
+        {
+            BOOST_CHECK(expected->freq() <= maxFreq);
+            if (norms)
+                BOOST_CHECK((int32_t)norms[expected->doc()] <= maxNorm);
+            more = expected->next();
+        }
+        expected->close();
+    }
+    termDocs->close();
+    return bounded;
+}
+
+static void checkIndex(DirectoryPtr dir)
+{
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    Collection<IndexReaderPtr> segments(reader->getSequentialSubReaders());
+    for (Collection<IndexReaderPtr>::iterator segment = segments.begin(); segment != segments.end(); ++segment)
+    {
+        BOOST_CHECK(checkBounds(*segment, newLucene<Term>(L"content", L"all")) > 0);
+        BOOST_CHECK(checkBounds(*segment, newLucene<Term>(L"content", L"some")) > 0);
+        BOOST_CHECK(checkBounds(*segment, newLucene<Term>(L"notf", L"all")) > 0);
+        BOOST_CHECK(checkBounds(*segment, newLucene<Term>(L"nonorms", L"all")) > 0);
+        checkBounds(*segment, newLucene<Term>(L"content", L"missing"));
+    }
+    reader->close();
+}
+
+/// Returns the bounds of the first block of a term, which holds neither the peak freq nor a boosted doc.
+static int32_t firstBlock(IndexReaderPtr reader, TermPtr term, int32_t& maxFreq, int32_t& maxNorm)
+{
+    TermDocsPtr termDocs(reader->getSequentialSubReaders()[0]->termDocs(term));
+    int32_t upTo = termDocs->advanceShallow(0, maxFreq, maxNorm);
+    termDocs->close();
+    return upTo;
+}
+
+BOOST_AUTO_TEST_CASE(testBounds)
+{
+    checkIndex(createIndex(false, NUM_DOCS, false));
+    checkIndex(createIndex(true, NUM_DOCS, false));
+}
+
+BOOST_AUTO_TEST_CASE(testMergedBounds)
+{
+    checkIndex(createIndex(false, 300, true));
+    checkIndex(createIndex(true, 300, true));
+}
+
+BOOST_AUTO_TEST_CASE(testTightBounds)
+{
+    DirectoryPtr dir(createIndex(false, 300, true));
+    IndexReaderPtr reader(IndexReader::open(dir, false));
+    int32_t maxFreq = 0;
+    int32_t maxNorm = 0;
+
+    BOOST_CHECK(firstBlock(reader, newLucene<Term>(L"content", L"all"), maxFreq, maxNorm) < 50);
+    BOOST_CHECK(maxFreq <= 3);
+    uint8_t boosted = reader->norms(L"content")[50];
+    BOOST_CHECK(maxNorm < boosted);
+
+    // without freqs every doc has a freq of one, without norms no norm can be ruled out
+    firstBlock(reader, newLucene<Term>(L"notf", L"all"), maxFreq, maxNorm);
+    BOOST_CHECK_EQUAL(maxFreq, 1);
+    firstBlock(reader, newLucene<Term>(L"nonorms", L"all"), maxFreq, maxNorm);
+    BOOST_CHECK(maxFreq <= 3);
+    BOOST_CHECK_EQUAL(maxNorm, 255);
+
+    // changed norms are no longer bounded by the skip data
+    reader->setNorm(3, L"content", (uint8_t)255);
+    firstBlock(reader, newLucene<Term>(L"content", L"all"), maxFreq, maxNorm);
+    BOOST_CHECK(maxFreq <= 3);
+    BOOST_CHECK_EQUAL(maxNorm, 255);
+    reader->close();
+
+    reader = IndexReader::open(dir, true);
+    firstBlock(reader, newLucene<Term>(L"content", L"all"), maxFreq, maxNorm);
+    BOOST_CHECK_EQUAL(maxNorm, 255);
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
 #include "Field.h"
 #include "IndexFileNames.h"
 #include "TermVectorsReader.h"
+#include "TermVectorsWriter.h"
 #include "TermFreqVector.h"
 #include "SegmentInfo.h"
 #include "TermPositionVector.h"
@@ -357,6 +358,39 @@ BOOST_AUTO_TEST_CASE(testOffsetReader)
     }
 }
 
+BOOST_AUTO_TEST_CASE(testWriteAllDocVectors)
+{
+    // rewrite the vectors of a document as a merge does when it can't copy the raw bytes
+    TermVectorsReaderPtr reader = newLucene<TermVectorsReader>(dir, seg, fieldInfos);
+    TermVectorsWriterPtr writer = newLucene<TermVectorsWriter>(dir, L"_copy", fieldInfos);
+    writer->addAllDocVectors(reader->get(0));
+    writer->close();
+    
+    TermVectorsReaderPtr copyReader = newLucene<TermVectorsReader>(dir, L"_copy", fieldInfos);
+    for (int32_t field = 0; field < testFields.size(); ++field)
+    {
+        TermFreqVectorPtr vector = copyReader->get(0, testFields[field]);
+        BOOST_CHECK(vector);
+        Collection<String> terms = vector->getTerms();
+        BOOST_CHECK_EQUAL(terms.size(), testTerms.size());
+        TermPositionVectorPtr positionVector = boost::dynamic_pointer_cast<TermPositionVector>(vector);
+        for (int32_t i = 0; i < terms.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(terms[i], testTerms[i]);
+            Collection<int32_t> positions = positionVector ? positionVector->getTermPositions(i) : Collection<int32_t>();
+            BOOST_CHECK_EQUAL((bool)positions, (bool)testFieldsStorePos[field]);
+            for (int32_t j = 0; positions && j < positions.size(); ++j)
+                BOOST_CHECK_EQUAL(positions[j], this->positions[i][j]);
+            Collection<TermVectorOffsetInfoPtr> offset = positionVector ? positionVector->getOffsets(i) : Collection<TermVectorOffsetInfoPtr>();
+            BOOST_CHECK_EQUAL((bool)offset, (bool)testFieldsStoreOff[field]);
+            for (int32_t j = 0; offset && j < offset.size(); ++j)
+                BOOST_CHECK(offset[j]->equals(offsets[i][j]));
+        }
+    }
+    copyReader->close();
+    reader->close();
+}
+
 BOOST_AUTO_TEST_CASE(testMapper)
 {
     TermVectorsReaderPtr reader = newLucene<TermVectorsReader>(dir, seg, fieldInfos);
@@ -0,0 +1,216 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include <boost/algorithm/string.hpp>
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermEnum.h"
+#include "TermDocs.h"
+#include "IndexInput.h"
+#include "IndexFileNames.h"
+#include "TermInfosWriter.h"
+#include "ChecksumFooter.h"
+#include "Random.h"
+#include "NIOFSDirectory.h"
+#include "FileUtils.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(TermsIndexFSTTest, LuceneTestFixture)
+
+static const int32_t NUM_DOCS = 300;
+
+static DirectoryPtr createIndex(DirectoryPtr dir)
+{
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(false);
+    writer->setTermIndexInterval(4);
+    writer->setMaxBufferedDocs(100);
+    for (int32_t i = 0; i < NUM_DOCS; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+        String id(StringUtils::toString(i));
+        doc->add(newLucene<Field>(L"body", L"term" + id + L" common term" + StringUtils::toString(i % 7), Field::STORE_NO, Field::INDEX_ANALYZED));
+        doc->add(newLucene<Field>(L"b", L"t" + id + L" \x00e9t\x00e9" + id + L" \x4e2d\x6587" + StringUtils::toString(i % 11), Field::STORE_NO, Field::INDEX_ANALYZED));
+        doc->add(newLucene<Field>(L"body2", id, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->commit();
+    writer->close();
+    return dir;
+}
+
+static DirectoryPtr createIndex()
+{
+    return createIndex(newLucene<MockRAMDirectory>());
+}
+
+static Collection<TermPtr> allTerms(IndexReaderPtr reader, Collection<int32_t> docFreqs)
+{
+    Collection<TermPtr> terms(Collection<TermPtr>::newInstance());
+    TermEnumPtr termEnum(reader->terms());
+    while (termEnum->next())
+    {
+        terms.add(termEnum->term());
+        docFreqs.add(termEnum->docFreq());
+    }
+    termEnum->close();
+    return terms;
+}
+
+static void checkTermLookups(IndexReaderPtr reader)
+{
+    Collection<int32_t> docFreqs(Collection<int32_t>::newInstance());
+    Collection<TermPtr> terms(allTerms(reader, docFreqs));
+    BOOST_CHECK(terms.size() > 4 * NUM_DOCS);
+
+    // batched lookups, before the single ones leave anything in the term cache, of terms from all over the
+    // dictionary, some of them repeated, sharing a block or missing
+    RandomPtr random(newLucene<Random>(7));
+    Collection<TermPtr> batch(newCollection<TermPtr>(terms[0], terms[terms.size() - 1], newLucene<Term>(L"zzz", L"missing")));
+    for (int32_t i = 0; i < 50; ++i)
+    {
+        int32_t n = random->nextInt(terms.size());
+        batch.add(terms[n]);
+        batch.add(n + 1 < terms.size() ? terms[n + 1] : terms[n]);
+        batch.add(newLucene<Term>(terms[n]->field(), terms[n]->text() + L"!"));
+    }
+    Collection<int32_t> batchFreqs(reader->docFreqs(batch));
+    BOOST_CHECK_EQUAL(batchFreqs.size(), batch.size());
+    for (int32_t i = 0; i < batch.size(); ++i)
+    {
+        Collection<TermPtr>::iterator term = std::lower_bound(terms.begin(), terms.end(), batch[i], luceneCompare<TermPtr>());
+        bool exists = (term != terms.end() && (*term)->equals(batch[i]));
+        BOOST_CHECK_EQUAL(batchFreqs[i], exists ? docFreqs[std::distance(terms.begin(), term)] : 0);
+    }
+
+    // lookups in order scan on within the block of the last one
+    for (int32_t i = 0; i < terms.size(); ++i)
+        BOOST_CHECK_EQUAL(reader->docFreq(terms[i]), docFreqs[i]);
+
+    // exact lookups in random order
+    for (int32_t i = 0; i < 2000; ++i)
+    {
+        int32_t n = random->nextInt(terms.size());
+        BOOST_CHECK_EQUAL(reader->docFreq(terms[n]), docFreqs[n]);
+    }
+
+    // terms that don't exist, before, between and after the existing ones
+    for (int32_t i = 0; i < 500; ++i)
+    {
+        TermPtr term(terms[random->nextInt(terms.size())]);
+        TermPtr probe;
+        switch (random->nextInt(4))
+        {
+            case 0:
+                probe = newLucene<Term>(term->field(), term->text() + L"!");
+                break;
+            case 1:
+                probe = newLucene<Term>(term->field(), term->text().substr(0, term->text().length() - 1));
+                break;
+            case 2:
+                probe = newLucene<Term>(term->field() + L"0", term->text());
+                break;
+            default:
+                probe = newLucene<Term>(term->field(), L"");
+                break;
+        }
+
+        Collection<TermPtr>::iterator ceil = std::lower_bound(terms.begin(), terms.end(), probe, luceneCompare<TermPtr>());
+        bool exists = (ceil != terms.end() && (*ceil)->equals(probe));
+        BOOST_CHECK_EQUAL(reader->docFreq(probe), exists ? docFreqs[std::distance(terms.begin(), ceil)] : 0);
+
+        // seeking positions the enumeration on the least term at or after the probe
+        TermEnumPtr termEnum(reader->terms(probe));
+        if (ceil == terms.end())
+            BOOST_CHECK(!termEnum->term());
+        else
+        {
+            BOOST_CHECK(termEnum->term());
+            if (termEnum->term())
+                BOOST_CHECK((*ceil)->equals(termEnum->term()));
+        }
+        termEnum->close();
+    }
+
+    TermDocsPtr termDocs(reader->termDocs(newLucene<Term>(L"b", L"\x00e9t\x00e9" L"123")));
+    BOOST_CHECK(termDocs->next());
+    BOOST_CHECK_EQUAL(termDocs->doc(), 123);
+    BOOST_CHECK(!termDocs->next());
+    termDocs->close();
+}
+
+BOOST_AUTO_TEST_CASE(testTermsIndexHasFST)
+{
+    DirectoryPtr dir(createIndex());
+    HashSet<String> files(dir->listAll());
+    int32_t numIndexFiles = 0;
+    for (HashSet<String>::iterator file = files.begin(); file != files.end(); ++file)
+    {
+        if (boost::ends_with(*file, L"." + IndexFileNames::TERMS_INDEX_EXTENSION()))
+        {
+            IndexInputPtr input(dir->openInput(*file));
+            BOOST_CHECK(input->readInt() <= TermInfosWriter::FORMAT_VERSION_TERMS_INDEX_FST_ONLY);
+            
+            // the transducer follows the header, without the prefix coded index terms in between
+            input->seek(ChecksumFooter::dataLength(input) - 8);
+            BOOST_CHECK_EQUAL(input->readLong(), 28);
+            input->close();
+            ++numIndexFiles;
+        }
+    }
+    BOOST_CHECK(numIndexFiles > 0);
+}
+
+BOOST_AUTO_TEST_CASE(testLookups)
+{
+    DirectoryPtr dir(createIndex());
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 3);
+    checkTermLookups(reader);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testLookupsAfterMerge)
+{
+    DirectoryPtr dir(createIndex());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+    writer->optimize();
+    writer->close();
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    checkTermLookups(reader);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testLookupsOnDisk)
+{
+    // the batched lookups read the dictionary blocks through the directory's asynchronous reads
+    String path(getTempDir(L"lucene.test.termsindex"));
+    DirectoryPtr dir(createIndex(newLucene<NIOFSDirectory>(path)));
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    checkTermLookups(reader);
+    reader->close();
+    dir->close();
+    FileUtils::removeDirectory(path);
+}
+
+BOOST_AUTO_TEST_CASE(testIndexDivisor)
+{
+    DirectoryPtr dir(createIndex());
+    IndexReaderPtr reader(IndexReader::open(dir, IndexDeletionPolicyPtr(), true, 3));
+    checkTermLookups(reader);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
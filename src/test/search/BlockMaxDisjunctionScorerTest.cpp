@@ -0,0 +1,232 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermQuery.h"
+#include "PhraseQuery.h"
+#include "BooleanQuery.h"
+#include "BlockMaxDisjunctionScorer.h"
+#include "TopScoreDocCollector.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+#include "Weight.h"
+#include "Explanation.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+class BlockMaxDisjunctionScorerFixture : public LuceneTestFixture
+{
+public:
+    BlockMaxDisjunctionScorerFixture()
+    {
+        // terms from common to rare, with frequencies and boosts that vary from doc to doc
+        RandomPtr random(newLucene<Random>(42));
+        directory = newLucene<RAMDirectory>();
+        IndexWriterPtr writer(newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+        writer->setMaxBufferedDocs(1000);
+        for (int32_t i = 0; i < NUM_DOCS; ++i)
+        {
+            StringStream body;
+            addTerm(body, L"a", random->nextInt(100) < 80, 1 + random->nextInt(3));
+            addTerm(body, L"b", random->nextInt(100) < 50, 1 + random->nextInt(5));
+            addTerm(body, L"c", random->nextInt(100) < 20, 1 + random->nextInt(5));
+            addTerm(body, L"d", random->nextInt(100) < 5, 1 + random->nextInt(10));
+            addTerm(body, L"e", random->nextInt(100) < 1, 1);
+            addTerm(body, L"filler", true, random->nextInt(20));
+            DocumentPtr doc(newLucene<Document>());
+            FieldPtr field(newLucene<Field>(L"body", body.str(), Field::STORE_NO, Field::INDEX_ANALYZED));
+            field->setBoost((double)(1 << random->nextInt(3)));
+            doc->add(field);
+            writer->addDocument(doc);
+        }
+        writer->close();
+        reader = IndexReader::open(directory, true);
+        searcher = newLucene<IndexSearcher>(reader);
+    }
+
+    virtual ~BlockMaxDisjunctionScorerFixture()
+    {
+        searcher->close();
+        reader->close();
+    }
+
+protected:
+    static const int32_t NUM_DOCS;
+
+    DirectoryPtr directory;
+    IndexReaderPtr reader;
+    IndexSearcherPtr searcher;
+
+public:
+    static void addTerm(StringStream& body, const String& term, bool add, int32_t freq)
+    {
+        if (!add)
+            return;
+        for (int32_t i = 0; i < freq; ++i)
+            body << term << L" ";
+    }
+
+    static BooleanQueryPtr disjunction(const String& terms, bool disableCoord = false)
+    {
+        BooleanQueryPtr query(newLucene<BooleanQuery>(disableCoord));
+        for (String::const_iterator term = terms.begin(); term != terms.end(); ++term)
+            query->add(newLucene<TermQuery>(newLucene<Term>(L"body", String(1, *term))), BooleanClause::SHOULD);
+        return query;
+    }
+
+    /// Checks that pruned top hits score as the exact top hits, and that each has the score the query gives it.
+    /// Returns the number of hits counted by the pruned search.
+    int32_t checkTopHits(QueryPtr query, int32_t numHits, int32_t totalHitsThreshold)
+    {
+        TopDocsPtr expected(searcher->search(query, numHits));
+        searcher->setTotalHitsThreshold(totalHitsThreshold);
+        TopDocsPtr actual(searcher->search(query, numHits));
+        searcher->setTotalHitsThreshold(INT_MAX);
+
+        BOOST_CHECK_EQUAL(actual->scoreDocs.size(), expected->scoreDocs.size());
+        BOOST_CHECK(actual->totalHits <= expected->totalHits);
+        BOOST_CHECK(actual->totalHits >= std::min(expected->totalHits, totalHitsThreshold));
+        for (int32_t i = 0; i < actual->scoreDocs.size() && i < expected->scoreDocs.size(); ++i)
+        {
+            BOOST_CHECK_CLOSE_FRACTION(actual->scoreDocs[i]->score, expected->scoreDocs[i]->score, 1e-10);
+            BOOST_CHECK_CLOSE_FRACTION(actual->scoreDocs[i]->score, searcher->explain(query, actual->scoreDocs[i]->doc)->getValue(), 1e-10);
+        }
+        return actual->totalHits;
+    }
+};
+
+const int32_t BlockMaxDisjunctionScorerFixture::NUM_DOCS = 5000;
+
+BOOST_FIXTURE_TEST_SUITE(BlockMaxDisjunctionScorerTest, BlockMaxDisjunctionScorerFixture)
+
+BOOST_AUTO_TEST_CASE(testMatchesDisjunction)
+{
+    // without a minimum competitive score every doc matching a clause is scored
+    WeightPtr weight(disjunction(L"abcde")->weight(searcher));
+    Collection<IndexReaderPtr> segments(reader->getSequentialSubReaders());
+    BOOST_CHECK(segments.size() > 1);
+    for (Collection<IndexReaderPtr>::iterator segment = segments.begin(); segment != segments.end(); ++segment)
+    {
+        ScorerPtr expected(weight->scorer(*segment, true, false));
+        ScorerPtr actual(weight->topScoresScorer(*segment, true));
+        BOOST_CHECK(boost::dynamic_pointer_cast<BlockMaxDisjunctionScorer>(actual));
+        int32_t doc;
+        while ((doc = expected->nextDoc()) != DocIdSetIterator::NO_MORE_DOCS)
+        {
+            BOOST_CHECK_EQUAL(actual->nextDoc(), doc);
+            BOOST_CHECK_CLOSE_FRACTION(actual->score(), expected->score(), 1e-10);
+        }
+        BOOST_CHECK_EQUAL(actual->nextDoc(), DocIdSetIterator::NO_MORE_DOCS);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testAdvance)
+{
+    WeightPtr weight(disjunction(L"cde")->weight(searcher));
+    IndexReaderPtr segment(reader->getSequentialSubReaders()[0]);
+    ScorerPtr expected(weight->scorer(segment, true, false));
+    ScorerPtr actual(weight->topScoresScorer(segment, true));
+    for (int32_t target = 0; target < segment->maxDoc(); target += 37)
+    {
+        if (expected->docID() < target && expected->advance(target) == DocIdSetIterator::NO_MORE_DOCS)
+            break;
+        target = expected->docID();
+        BOOST_CHECK_EQUAL(actual->advance(target), target);
+        BOOST_CHECK_CLOSE_FRACTION(actual->score(), expected->score(), 1e-10);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSkipsNonCompetitiveDocs)
+{
+    int32_t exact = searcher->search(disjunction(L"abcde"), 10)->totalHits;
+    BOOST_CHECK(checkTopHits(disjunction(L"abcde"), 10, 10) < exact);
+    BOOST_CHECK(checkTopHits(disjunction(L"abc"), 10, 0) < searcher->search(disjunction(L"abc"), 10)->totalHits);
+    checkTopHits(disjunction(L"abcde"), 100, 10);
+    checkTopHits(disjunction(L"abcde"), 10, 1000);
+
+    // hits up to the threshold are counted exactly
+    BOOST_CHECK_EQUAL(checkTopHits(disjunction(L"abcde"), 10, INT_MAX - 1), exact);
+}
+
+BOOST_AUTO_TEST_CASE(testCoord)
+{
+    checkTopHits(disjunction(L"abcde", true), 10, 10);
+    checkTopHits(disjunction(L"de"), 10, 0);
+    checkTopHits(disjunction(L"ae"), 5, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testBoosts)
+{
+    BooleanQueryPtr query(disjunction(L"abd"));
+    query->getClauses()[0]->getQuery()->setBoost(4.0);
+    query->getClauses()[2]->getQuery()->setBoost(0.1);
+    checkTopHits(query, 10, 10);
+    query->setBoost(-1.0);
+    checkTopHits(query, 10, 10);
+}
+
+BOOST_AUTO_TEST_CASE(testClausesWithoutBounds)
+{
+    // nested queries and phrases can't bound their scores, so they are always essential
+    PhraseQueryPtr phrase(newLucene<PhraseQuery>());
+    phrase->add(newLucene<Term>(L"body", L"a"));
+    phrase->add(newLucene<Term>(L"body", L"b"));
+    BooleanQueryPtr query(disjunction(L"cd"));
+    query->add(phrase, BooleanClause::SHOULD);
+    query->add(disjunction(L"ae"), BooleanClause::SHOULD);
+    checkTopHits(query, 10, 10);
+
+    // with a single clause that has a scorer
+    BooleanQueryPtr missing(disjunction(L"e"));
+    missing->add(newLucene<TermQuery>(newLucene<Term>(L"body", L"missing")), BooleanClause::SHOULD);
+    checkTopHits(missing, 10, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testOnlyPureDisjunctions)
+{
+    BooleanQueryPtr query(disjunction(L"bc"));
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"body", L"a")), BooleanClause::MUST);
+    checkTopHits(query, 10, 0);
+
+    query = disjunction(L"abc");
+    query->add(newLucene<TermQuery>(newLucene<Term>(L"body", L"d")), BooleanClause::MUST_NOT);
+    checkTopHits(query, 10, 0);
+
+    query = disjunction(L"abcd");
+    query->setMinimumNumberShouldMatch(2);
+    checkTopHits(query, 10, 0);
+
+    WeightPtr weight(query->weight(searcher));
+    BOOST_CHECK(!boost::dynamic_pointer_cast<BlockMaxDisjunctionScorer>(weight->topScoresScorer(reader->getSequentialSubReaders()[0], true)));
+}
+
+BOOST_AUTO_TEST_CASE(testCollector)
+{
+    TopScoreDocCollectorPtr collector(TopScoreDocCollector::create(10, true, 100));
+    BOOST_CHECK(collector->needsTopScoresOnly());
+    BOOST_CHECK(!TopScoreDocCollector::create(10, true)->needsTopScoresOnly());
+    searcher->search(disjunction(L"abcde"), FilterPtr(), collector);
+    TopDocsPtr topDocs(collector->topDocs());
+    BOOST_CHECK(topDocs->totalHits > 100);
+    BOOST_CHECK_EQUAL(topDocs->scoreDocs.size(), 10);
+    TopDocsPtr expected(searcher->search(disjunction(L"abcde"), 10));
+    for (int32_t i = 0; i < 10; ++i)
+        BOOST_CHECK_CLOSE_FRACTION(topDocs->scoreDocs[i]->score, expected->scoreDocs[i]->score, 1e-10);
+
+    BOOST_CHECK_EXCEPTION(TopScoreDocCollector::create(10, true, -1), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
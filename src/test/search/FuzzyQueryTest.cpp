@@ -20,6 +20,8 @@
 #include "StandardAnalyzer.h"
 #include "QueryParser.h"
 #include "IndexReader.h"
+#include "FuzzyTermEnum.h"
+#include "Random.h"
 
 using namespace Lucene;
 
@@ -32,6 +34,28 @@ static void addDoc(const String& text, IndexWriterPtr writer)
     writer->addDocument(doc);
 }
 
+/// Enumerates the terms by comparing every term that shares the prefix.
+class ScanningFuzzyTermEnum : public FuzzyTermEnum
+{
+public:
+    ScanningFuzzyTermEnum(IndexReaderPtr reader, TermPtr term, double minSimilarity, int32_t prefixLength) : FuzzyTermEnum(reader, term, minSimilarity, prefixLength)
+    {
+        actualEnum->close();
+        _endEnum = false;
+        setEnum(reader->terms(newLucene<Term>(field, prefix)));
+    }
+    
+    virtual ~ScanningFuzzyTermEnum()
+    {
+    }
+
+public:
+    virtual bool next()
+    {
+        return FilteredTermEnum::next();
+    }
+};
+
 BOOST_AUTO_TEST_CASE(testFuzziness)
 {
     RAMDirectoryPtr directory = newLucene<RAMDirectory>();
@@ -297,6 +321,61 @@ BOOST_AUTO_TEST_CASE(testTokenLengthOpt)
     BOOST_CHECK_EQUAL(0, hits.size());
 }
 
+BOOST_AUTO_TEST_CASE(testSameTermsAsScan)
+{
+    RandomPtr random = newLucene<Random>(42);
+    String letters(L"abcdef");
+    RAMDirectoryPtr directory = newLucene<RAMDirectory>();
+    IndexWriterPtr writer = newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setMaxBufferedDocs(100);
+    Collection<String> words(Collection<String>::newInstance());
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        String word;
+        int32_t length = 1 + random->nextInt(8);
+        for (int32_t j = 0; j < length; ++j)
+            word += letters[random->nextInt(letters.length())];
+        words.add(word);
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"field", word, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"other", word, Field::STORE_NO, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+    IndexReaderPtr reader = IndexReader::open(directory, true);
+    
+    double minSimilarities[] = {0.0, 0.3, 0.5, 0.7};
+    for (int32_t i = 0; i < 50; ++i)
+    {
+        TermPtr term(newLucene<Term>(L"field", i == 0 ? String(L"") : words[i]));
+        for (int32_t s = 0; s < 4; ++s)
+        {
+            for (int32_t prefixLength = 0; prefixLength < 3; ++prefixLength)
+            {
+                FuzzyTermEnumPtr fuzzyEnum(newLucene<FuzzyTermEnum>(reader, term, minSimilarities[s], prefixLength));
+                FuzzyTermEnumPtr scanningEnum(newLucene<ScanningFuzzyTermEnum>(reader, term, minSimilarities[s], prefixLength));
+                int32_t count = 0;
+                while (scanningEnum->term())
+                {
+                    BOOST_REQUIRE(fuzzyEnum->term());
+                    BOOST_CHECK(fuzzyEnum->term()->equals(scanningEnum->term()));
+                    BOOST_CHECK_EQUAL(fuzzyEnum->docFreq(), scanningEnum->docFreq());
+                    BOOST_CHECK_EQUAL(fuzzyEnum->difference(), scanningEnum->difference());
+                    fuzzyEnum->next();
+                    scanningEnum->next();
+                    ++count;
+                }
+                BOOST_CHECK(!fuzzyEnum->term());
+                if (minSimilarities[s] == 0.0 && prefixLength == 0 && i != 0)
+                    BOOST_CHECK(count > 0);
+                fuzzyEnum->close();
+                scanningEnum->close();
+            }
+        }
+    }
+    reader->close();
+}
+
 BOOST_AUTO_TEST_CASE(testGiga)
 {
     StandardAnalyzerPtr analyzer = newLucene<StandardAnalyzer>(LuceneVersion::LUCENE_CURRENT);
@@ -0,0 +1,166 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermQuery.h"
+#include "BooleanQuery.h"
+#include "MatchAllDocsQuery.h"
+#include "QueryWrapperFilter.h"
+#include "Sort.h"
+#include "SortField.h"
+#include "TopDocs.h"
+#include "TopFieldDocs.h"
+#include "FieldDoc.h"
+#include "ScoreDoc.h"
+#include "TotalHitCountCollector.h"
+#include "ThreadPool.h"
+#include "Weight.h"
+#include "MiscUtils.h"
+
+using namespace Lucene;
+
+class IndexSearcherExecutorFixture : public LuceneTestFixture
+{
+public:
+    IndexSearcherExecutorFixture()
+    {
+        directory = newLucene<RAMDirectory>();
+        IndexWriterPtr writer(newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+        writer->setMaxBufferedDocs(100);
+        writer->setMergeFactor(1000);
+        for (int32_t i = 0; i < 2000; ++i)
+        {
+            DocumentPtr doc(newLucene<Document>());
+            StringStream body;
+            body << L"all " << (i % 2 == 0 ? L"even " : L"odd ");
+            for (int32_t j = 0; j < i % 7; ++j)
+                body << L"seven ";
+            doc->add(newLucene<Field>(L"body", body.str(), Field::STORE_NO, Field::INDEX_ANALYZED));
+            doc->add(newLucene<Field>(L"value", StringUtils::toString((i * 37) % 101), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+            writer->addDocument(doc);
+        }
+        writer->close();
+        reader = IndexReader::open(directory, true);
+        searcher = newLucene<IndexSearcher>(reader);
+        parallelSearcher = newLucene<IndexSearcher>(reader, ThreadPool::getInstance());
+    }
+
+    virtual ~IndexSearcherExecutorFixture()
+    {
+        reader->close();
+    }
+
+protected:
+    DirectoryPtr directory;
+    IndexReaderPtr reader;
+    IndexSearcherPtr searcher;
+    IndexSearcherPtr parallelSearcher;
+
+public:
+    static void checkHits(TopDocsPtr expected, TopDocsPtr actual)
+    {
+        BOOST_CHECK_EQUAL(actual->totalHits, expected->totalHits);
+        BOOST_CHECK_EQUAL(actual->scoreDocs.size(), expected->scoreDocs.size());
+        if (MiscUtils::isNaN(expected->maxScore))
+            BOOST_CHECK(MiscUtils::isNaN(actual->maxScore));
+        else
+            BOOST_CHECK_CLOSE_FRACTION(actual->maxScore, expected->maxScore, 1e-10);
+        for (int32_t i = 0; i < actual->scoreDocs.size() && i < expected->scoreDocs.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(actual->scoreDocs[i]->doc, expected->scoreDocs[i]->doc);
+            if (MiscUtils::isNaN(expected->scoreDocs[i]->score))
+                BOOST_CHECK(MiscUtils::isNaN(actual->scoreDocs[i]->score));
+            else
+                BOOST_CHECK_CLOSE_FRACTION(actual->scoreDocs[i]->score, expected->scoreDocs[i]->score, 1e-10);
+        }
+    }
+
+    static QueryPtr termQuery(const String& text)
+    {
+        return newLucene<TermQuery>(newLucene<Term>(L"body", text));
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(IndexSearcherExecutorTest, IndexSearcherExecutorFixture)
+
+BOOST_AUTO_TEST_CASE(testTopScoreDocs)
+{
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 20);
+    checkHits(searcher->search(termQuery(L"seven"), 10), parallelSearcher->search(termQuery(L"seven"), 10));
+    checkHits(searcher->search(termQuery(L"all"), 10), parallelSearcher->search(termQuery(L"all"), 10));
+    checkHits(searcher->search(termQuery(L"all"), 5000), parallelSearcher->search(termQuery(L"all"), 5000));
+    checkHits(searcher->search(termQuery(L"missing"), 10), parallelSearcher->search(termQuery(L"missing"), 10));
+
+    BooleanQueryPtr query(newLucene<BooleanQuery>());
+    query->add(termQuery(L"even"), BooleanClause::SHOULD);
+    query->add(termQuery(L"seven"), BooleanClause::SHOULD);
+    checkHits(searcher->search(query, 25), parallelSearcher->search(query, 25));
+
+    FilterPtr filter(newLucene<QueryWrapperFilter>(termQuery(L"odd")));
+    checkHits(searcher->search(query, filter, 25), parallelSearcher->search(query, filter, 25));
+}
+
+BOOST_AUTO_TEST_CASE(testTopFieldDocs)
+{
+    SortPtr sort(newLucene<Sort>(newCollection<SortFieldPtr>(newLucene<SortField>(L"value", SortField::INT), SortField::FIELD_DOC())));
+    checkHits(searcher->search(termQuery(L"seven"), FilterPtr(), 30, sort), parallelSearcher->search(termQuery(L"seven"), FilterPtr(), 30, sort));
+
+    // ties broken by doc
+    sort = newLucene<Sort>(newLucene<SortField>(L"value", SortField::STRING, true));
+    TopFieldDocsPtr expected(searcher->search(termQuery(L"all"), FilterPtr(), 100, sort));
+    TopFieldDocsPtr actual(parallelSearcher->search(termQuery(L"all"), FilterPtr(), 100, sort));
+    checkHits(expected, actual);
+    BOOST_CHECK_EQUAL(actual->fields.size(), 1);
+    BOOST_CHECK(boost::static_pointer_cast<FieldDoc>(actual->scoreDocs[0])->fields);
+
+    // fields are only filled when asked for
+    expected = searcher->search(termQuery(L"all")->weight(searcher), FilterPtr(), 100, sort, false);
+    actual = parallelSearcher->search(termQuery(L"all")->weight(parallelSearcher), FilterPtr(), 100, sort, false);
+    checkHits(expected, actual);
+    BOOST_CHECK(!boost::static_pointer_cast<FieldDoc>(actual->scoreDocs[0])->fields);
+
+    // with scores
+    searcher->setDefaultFieldSortScoring(true, true);
+    parallelSearcher->setDefaultFieldSortScoring(true, true);
+    sort = newLucene<Sort>(newCollection<SortFieldPtr>(newLucene<SortField>(L"value", SortField::INT), SortField::FIELD_SCORE()));
+    checkHits(searcher->search(termQuery(L"seven"), FilterPtr(), 50, sort), parallelSearcher->search(termQuery(L"seven"), FilterPtr(), 50, sort));
+}
+
+BOOST_AUTO_TEST_CASE(testCount)
+{
+    BOOST_CHECK_EQUAL(parallelSearcher->count(termQuery(L"all")), 2000);
+    BOOST_CHECK_EQUAL(parallelSearcher->count(termQuery(L"even")), 1000);
+    BOOST_CHECK_EQUAL(parallelSearcher->count(newLucene<MatchAllDocsQuery>()), 2000);
+    BOOST_CHECK_EQUAL(parallelSearcher->count(termQuery(L"missing")), 0);
+    BOOST_CHECK_EQUAL(searcher->count(termQuery(L"seven")), parallelSearcher->count(termQuery(L"seven")));
+
+    TotalHitCountCollectorPtr collector(newLucene<TotalHitCountCollector>());
+    parallelSearcher->search(termQuery(L"odd"), collector);
+    BOOST_CHECK_EQUAL(collector->getTotalHits(), 1000);
+}
+
+BOOST_AUTO_TEST_CASE(testSingleSegment)
+{
+    IndexWriterPtr writer(newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED));
+    writer->optimize();
+    writer->close();
+    IndexReaderPtr optimized(IndexReader::open(directory, true));
+    IndexSearcherPtr optimizedSearcher(newLucene<IndexSearcher>(optimized, ThreadPool::getInstance()));
+    checkHits(searcher->search(termQuery(L"seven"), 10), optimizedSearcher->search(termQuery(L"seven"), 10));
+    BOOST_CHECK_EQUAL(optimizedSearcher->count(termQuery(L"odd")), 1000);
+    optimized->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "LevenshteinAutomaton.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(LevenshteinAutomatonTest, LuceneTestFixture)
+
+static int32_t editDistance(const String& first, const String& second)
+{
+    Collection<int32_t> p(Collection<int32_t>::newInstance(first.length() + 1));
+    Collection<int32_t> d(Collection<int32_t>::newInstance(first.length() + 1));
+    for (int32_t i = 0; i <= (int32_t)first.length(); ++i)
+        p[i] = i;
+    for (int32_t j = 1; j <= (int32_t)second.length(); ++j)
+    {
+        d[0] = j;
+        for (int32_t i = 1; i <= (int32_t)first.length(); ++i)
+            d[i] = std::min(std::min(d[i - 1], p[i]) + 1, p[i - 1] + (first[i - 1] == second[j - 1] ? 0 : 1));
+        std::swap(p, d);
+    }
+    return p[first.length()];
+}
+
+/// Adds all the strings of chars up to maxLength long.
+static void addStrings(const String& chars, int32_t maxLength, const String& prefix, Collection<String> strings)
+{
+    strings.add(prefix);
+    if ((int32_t)prefix.length() == maxLength)
+        return;
+    for (String::const_iterator c = chars.begin(); c != chars.end(); ++c)
+        addStrings(chars, maxLength, prefix + *c, strings);
+}
+
+static void checkAutomaton(const String& text, int32_t maxDistance)
+{
+    LevenshteinAutomatonPtr automaton(newLucene<LevenshteinAutomaton>(text, maxDistance));
+    
+    // besides the chars of the text, the next accepted strings may use the smallest chars and the ones
+    // following the chars of the inputs
+    String chars(L"abcde");
+    chars.insert(chars.begin(), 1, (wchar_t)1);
+    chars.insert(chars.begin(), 1, (wchar_t)0);
+    Collection<String> accepted(Collection<String>::newInstance());
+    Collection<String> strings(Collection<String>::newInstance());
+    addStrings(chars, text.length() + maxDistance, L"", strings);
+    for (Collection<String>::iterator s = strings.begin(); s != strings.end(); ++s)
+    {
+        bool expected = (editDistance(text, *s) <= maxDistance);
+        BOOST_CHECK_EQUAL(expected, automaton->accepts(*s));
+        if (expected)
+            accepted.add(*s);
+    }
+    std::sort(accepted.begin(), accepted.end());
+    
+    String inputChars(L"abcd");
+    inputChars.insert(inputChars.begin(), 1, (wchar_t)0);
+    Collection<String> inputs(Collection<String>::newInstance());
+    addStrings(inputChars, 4, L"", inputs);
+    for (Collection<String>::iterator input = inputs.begin(); input != inputs.end(); ++input)
+    {
+        Collection<String>::iterator expected = std::upper_bound(accepted.begin(), accepted.end(), *input);
+        String next;
+        if (expected == accepted.end())
+            BOOST_CHECK(!automaton->nextAccepted(*input, next));
+        else
+        {
+            BOOST_CHECK(automaton->nextAccepted(*input, next));
+            BOOST_CHECK(next == *expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testNextAccepted)
+{
+    checkAutomaton(L"abc", 1);
+    checkAutomaton(L"abc", 2);
+    checkAutomaton(L"aab", 1);
+    checkAutomaton(L"ba", 1);
+    checkAutomaton(L"ab", 0);
+    checkAutomaton(L"", 1);
+}
+
+BOOST_AUTO_TEST_CASE(testDistances)
+{
+    LevenshteinAutomatonPtr automaton(newLucene<LevenshteinAutomaton>(L"lucene", 2));
+    BOOST_CHECK(automaton->accepts(L"lucene"));
+    BOOST_CHECK(automaton->accepts(L"lucne"));
+    BOOST_CHECK(automaton->accepts(L"lucenes"));
+    BOOST_CHECK(automaton->accepts(L"lcuene"));
+    BOOST_CHECK(automaton->accepts(L"luce"));
+    BOOST_CHECK(!automaton->accepts(L"luke"));
+    BOOST_CHECK(!automaton->accepts(L"lu"));
+    BOOST_CHECK(!automaton->accepts(L"solene"));
+    BOOST_CHECK(!automaton->accepts(L"lucenesss"));
+    
+    String next;
+    BOOST_CHECK(automaton->nextAccepted(L"lucene", next));
+    BOOST_CHECK(next == String(L"lucene") + (wchar_t)0);
+    BOOST_CHECK(automaton->nextAccepted(L"m", next));
+    BOOST_CHECK(next == String(L"m") + (wchar_t)0 + L"cene");
+    BOOST_CHECK(automaton->nextAccepted(L"z", next));
+    BOOST_CHECK(next == String(L"z") + (wchar_t)0 + L"cene");
+    
+    automaton = newLucene<LevenshteinAutomaton>(L"lucene", 0);
+    BOOST_CHECK(automaton->nextAccepted(L"a", next));
+    BOOST_CHECK(next == L"lucene");
+    BOOST_CHECK(!automaton->nextAccepted(L"lucene", next));
+    BOOST_CHECK(!automaton->nextAccepted(L"lucf", next));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
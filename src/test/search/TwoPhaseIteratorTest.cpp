@@ -0,0 +1,239 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermQuery.h"
+#include "PhraseQuery.h"
+#include "BooleanQuery.h"
+#include "FilteredQuery.h"
+#include "QueryWrapperFilter.h"
+#include "SpanTermQuery.h"
+#include "SpanNearQuery.h"
+#include "SpanFirstQuery.h"
+#include "SpanOrQuery.h"
+#include "Weight.h"
+#include "Scorer.h"
+#include "TwoPhaseIterator.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+
+using namespace Lucene;
+
+/// Doc i has "quick brown" if i is even, "lazy dog" if i is a multiple of 3 and "n0" if it is a multiple of 5.
+class TwoPhaseIteratorFixture : public LuceneTestFixture
+{
+public:
+    TwoPhaseIteratorFixture()
+    {
+        directory = newLucene<RAMDirectory>();
+        IndexWriterPtr writer(newLucene<IndexWriter>(directory, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+        for (int32_t i = 0; i < NUM_DOCS; ++i)
+        {
+            DocumentPtr doc(newLucene<Document>());
+            String body(i % 2 == 0 ? L"quick brown fox" : L"brown quick fox");
+            body += i % 3 == 0 ? L" lazy dog" : L" dog lazy";
+            body += L" n" + StringUtils::toString(i % 5);
+            doc->add(newLucene<Field>(L"body", body, Field::STORE_NO, Field::INDEX_ANALYZED));
+            writer->addDocument(doc);
+        }
+        writer->optimize();
+        writer->close();
+        searcher = newLucene<IndexSearcher>(directory, true);
+    }
+
+    virtual ~TwoPhaseIteratorFixture()
+    {
+        searcher->close();
+    }
+
+protected:
+    static const int32_t NUM_DOCS;
+
+    DirectoryPtr directory;
+    IndexSearcherPtr searcher;
+
+public:
+    static QueryPtr phrase(const String& first, const String& second)
+    {
+        PhraseQueryPtr query(newLucene<PhraseQuery>());
+        query->add(newLucene<Term>(L"body", first));
+        query->add(newLucene<Term>(L"body", second));
+        return query;
+    }
+
+    static SpanQueryPtr spanPhrase(const String& first, const String& second)
+    {
+        Collection<SpanQueryPtr> clauses(newCollection<SpanQueryPtr>(newLucene<SpanTermQuery>(newLucene<Term>(L"body", first)), newLucene<SpanTermQuery>(newLucene<Term>(L"body", second))));
+        return newLucene<SpanNearQuery>(clauses, 0, true);
+    }
+
+    static QueryPtr term(const String& text)
+    {
+        return newLucene<TermQuery>(newLucene<Term>(L"body", text));
+    }
+
+    static BooleanQueryPtr conjunction(QueryPtr first, QueryPtr second, BooleanClause::Occur occur = BooleanClause::MUST)
+    {
+        BooleanQueryPtr query(newLucene<BooleanQuery>());
+        query->add(first, BooleanClause::MUST);
+        query->add(second, occur);
+        return query;
+    }
+
+    /// Checks that the hits of query, filtered by filter if not null, are the docs divisible by all of the given
+    /// divisors and not divisible by notDivisor, if not zero.
+    void checkHits(QueryPtr query, FilterPtr filter, Collection<int32_t> divisors, int32_t notDivisor = 0)
+    {
+        int32_t expected = 0;
+        for (int32_t i = 0; i < NUM_DOCS; ++i)
+        {
+            if (matches(i, divisors, notDivisor))
+                ++expected;
+        }
+        TopDocsPtr hits(searcher->search(query, filter, NUM_DOCS));
+        BOOST_CHECK_EQUAL(hits->totalHits, expected);
+        for (int32_t i = 0; i < hits->scoreDocs.size(); ++i)
+            BOOST_CHECK(matches(hits->scoreDocs[i]->doc, divisors, notDivisor));
+    }
+
+    static bool matches(int32_t doc, Collection<int32_t> divisors, int32_t notDivisor)
+    {
+        for (Collection<int32_t>::iterator divisor = divisors.begin(); divisor != divisors.end(); ++divisor)
+        {
+            if (doc % *divisor != 0)
+                return false;
+        }
+        return (notDivisor == 0 || doc % notDivisor != 0);
+    }
+
+    ScorerPtr scorer(QueryPtr query)
+    {
+        return query->weight(searcher)->scorer(searcher->getIndexReader(), true, false);
+    }
+};
+
+const int32_t TwoPhaseIteratorFixture::NUM_DOCS = 300;
+
+BOOST_FIXTURE_TEST_SUITE(TwoPhaseIteratorTest, TwoPhaseIteratorFixture)
+
+BOOST_AUTO_TEST_CASE(testPhraseApproximation)
+{
+    ScorerPtr phraseScorer(scorer(phrase(L"quick", L"brown")));
+    TwoPhaseIteratorPtr twoPhase(phraseScorer->twoPhaseIterator());
+    BOOST_CHECK(twoPhase);
+    DocIdSetIteratorPtr approximation(twoPhase->approximation());
+    BOOST_CHECK_EQUAL(phraseScorer->docID(), -1);
+
+    // every doc has both terms, but only the even ones the phrase
+    int32_t numDocs = 0;
+    int32_t numMatches = 0;
+    for (int32_t doc = approximation->nextDoc(); doc != DocIdSetIterator::NO_MORE_DOCS; doc = approximation->nextDoc())
+    {
+        BOOST_CHECK_EQUAL(doc, numDocs++);
+        BOOST_CHECK_EQUAL(phraseScorer->docID(), doc);
+        bool matches = twoPhase->matches();
+        BOOST_CHECK_EQUAL(matches, doc % 2 == 0);
+        if (matches)
+        {
+            BOOST_CHECK(phraseScorer->score() > 0.0);
+            ++numMatches;
+        }
+    }
+    BOOST_CHECK_EQUAL(numDocs, NUM_DOCS);
+    BOOST_CHECK_EQUAL(numMatches, NUM_DOCS / 2);
+
+    DocIdSetIteratorPtr iterator(TwoPhaseIterator::asDocIdSetIterator(scorer(phrase(L"quick", L"brown"))->twoPhaseIterator()));
+    BOOST_CHECK_EQUAL(iterator->nextDoc(), 0);
+    BOOST_CHECK_EQUAL(iterator->advance(5), 6);
+    BOOST_CHECK_EQUAL(iterator->nextDoc(), 8);
+
+    // terms need no confirmation
+    BOOST_CHECK(!scorer(term(L"quick"))->twoPhaseIterator());
+    BOOST_CHECK_EQUAL(TwoPhaseIterator::approximationOf(scorer(term(L"quick")))->nextDoc(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testConjunctions)
+{
+    checkHits(phrase(L"quick", L"brown"), FilterPtr(), newCollection<int32_t>(2));
+    checkHits(conjunction(phrase(L"quick", L"brown"), phrase(L"lazy", L"dog")), FilterPtr(), newCollection<int32_t>(2, 3));
+    checkHits(conjunction(phrase(L"quick", L"brown"), term(L"n0")), FilterPtr(), newCollection<int32_t>(2, 5));
+    checkHits(conjunction(term(L"n0"), phrase(L"lazy", L"dog")), FilterPtr(), newCollection<int32_t>(3, 5));
+
+    BooleanQueryPtr query(conjunction(phrase(L"quick", L"brown"), phrase(L"lazy", L"dog")));
+    query->add(term(L"n0"), BooleanClause::MUST);
+    checkHits(query, FilterPtr(), newCollection<int32_t>(2, 3, 5));
+    BOOST_CHECK(scorer(query)->twoPhaseIterator());
+
+    // nested conjunctions confirm the phrases of their clauses only once all clauses agree
+    checkHits(conjunction(conjunction(phrase(L"quick", L"brown"), term(L"fox")), term(L"n0")), FilterPtr(), newCollection<int32_t>(2, 5));
+}
+
+BOOST_AUTO_TEST_CASE(testExclusions)
+{
+    checkHits(conjunction(phrase(L"quick", L"brown"), phrase(L"lazy", L"dog"), BooleanClause::MUST_NOT), FilterPtr(), newCollection<int32_t>(2), 3);
+    checkHits(conjunction(phrase(L"quick", L"brown"), term(L"n0"), BooleanClause::MUST_NOT), FilterPtr(), newCollection<int32_t>(2), 5);
+    checkHits(conjunction(term(L"n0"), phrase(L"quick", L"brown"), BooleanClause::MUST_NOT), FilterPtr(), newCollection<int32_t>(5), 2);
+
+    // the exclusion is deferred to the confirmation of the conjunction
+    BooleanQueryPtr query(conjunction(phrase(L"quick", L"brown"), phrase(L"lazy", L"dog"), BooleanClause::MUST_NOT));
+    query->add(term(L"n0"), BooleanClause::MUST);
+    checkHits(query, FilterPtr(), newCollection<int32_t>(2, 5), 3);
+}
+
+BOOST_AUTO_TEST_CASE(testFilters)
+{
+    FilterPtr filter(newLucene<QueryWrapperFilter>(term(L"n0")));
+    checkHits(phrase(L"quick", L"brown"), filter, newCollection<int32_t>(2, 5));
+    checkHits(newLucene<FilteredQuery>(phrase(L"quick", L"brown"), filter), FilterPtr(), newCollection<int32_t>(2, 5));
+    checkHits(conjunction(newLucene<FilteredQuery>(phrase(L"quick", L"brown"), filter), phrase(L"lazy", L"dog")), FilterPtr(), newCollection<int32_t>(2, 3, 5));
+    checkHits(conjunction(phrase(L"quick", L"brown"), phrase(L"lazy", L"dog")), filter, newCollection<int32_t>(2, 3, 5));
+
+    // scores are those of the unfiltered phrase
+    TopDocsPtr all(searcher->search(phrase(L"quick", L"brown"), FilterPtr(), NUM_DOCS));
+    TopDocsPtr filtered(searcher->search(newLucene<FilteredQuery>(phrase(L"quick", L"brown"), filter), FilterPtr(), NUM_DOCS));
+    BOOST_CHECK_EQUAL(filtered->totalHits, NUM_DOCS / 10);
+    for (int32_t i = 0; i < filtered->scoreDocs.size(); ++i)
+        BOOST_CHECK_CLOSE_FRACTION(filtered->scoreDocs[i]->score, all->scoreDocs[0]->score, 1e-10);
+}
+
+BOOST_AUTO_TEST_CASE(testSpans)
+{
+    ScorerPtr spanScorer(scorer(spanPhrase(L"quick", L"brown")));
+    BOOST_CHECK(spanScorer->twoPhaseIterator());
+    BOOST_CHECK_EQUAL(spanScorer->docID(), -1);
+    BOOST_CHECK_EQUAL(spanScorer->nextDoc(), 0);
+    BOOST_CHECK_EQUAL(spanScorer->advance(3), 4);
+    BOOST_CHECK_EQUAL(spanScorer->nextDoc(), 6);
+
+    checkHits(spanPhrase(L"quick", L"brown"), FilterPtr(), newCollection<int32_t>(2));
+    checkHits(spanPhrase(L"lazy", L"dog"), newLucene<QueryWrapperFilter>(term(L"n0")), newCollection<int32_t>(3, 5));
+    checkHits(conjunction(spanPhrase(L"quick", L"brown"), phrase(L"lazy", L"dog")), FilterPtr(), newCollection<int32_t>(2, 3));
+    checkHits(conjunction(spanPhrase(L"quick", L"brown"), spanPhrase(L"lazy", L"dog"), BooleanClause::MUST_NOT), FilterPtr(), newCollection<int32_t>(2), 3);
+    checkHits(newLucene<SpanFirstQuery>(spanPhrase(L"quick", L"brown"), 2), newLucene<QueryWrapperFilter>(term(L"n0")), newCollection<int32_t>(2, 5));
+
+    // the scores do not depend on the way the spans are positioned
+    TopDocsPtr all(searcher->search(spanPhrase(L"quick", L"brown"), FilterPtr(), NUM_DOCS));
+    TopDocsPtr filtered(searcher->search(spanPhrase(L"quick", L"brown"), newLucene<QueryWrapperFilter>(term(L"n0")), NUM_DOCS));
+    for (int32_t i = 0; i < filtered->scoreDocs.size(); ++i)
+        BOOST_CHECK_CLOSE_FRACTION(filtered->scoreDocs[i]->score, all->scoreDocs[0]->score, 1e-10);
+
+    // disjunctions of spans have no approximation
+    Collection<SpanQueryPtr> clauses(newCollection<SpanQueryPtr>(newLucene<SpanTermQuery>(newLucene<Term>(L"body", L"n0")), newLucene<SpanTermQuery>(newLucene<Term>(L"body", L"n1"))));
+    SpanQueryPtr spanOr(newLucene<SpanOrQuery>(clauses));
+    BOOST_CHECK(!scorer(spanOr)->twoPhaseIterator());
+    BOOST_CHECK_EQUAL(searcher->search(spanOr, newLucene<QueryWrapperFilter>(phrase(L"quick", L"brown")), NUM_DOCS)->totalHits, NUM_DOCS / 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,217 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "ArenaRAMDirectory.h"
+#include "RAMArena.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "TermQuery.h"
+#include "Term.h"
+#include "TopDocs.h"
+#include "LuceneThread.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(ArenaRAMDirectoryTest, LuceneTestFixture)
+
+static const int32_t SLAB_SIZE = 1024;
+
+BOOST_AUTO_TEST_CASE(testReadWrite)
+{
+    ArenaRAMDirectoryPtr dir(newLucene<ArenaRAMDirectory>(newLucene<RAMArena>(SLAB_SIZE)));
+    
+    // empty, short (packed tail), exactly one slab, long tail and multiple slabs
+    int32_t lengths[] = {0, 10, SLAB_SIZE, SLAB_SIZE - 10, 5 * SLAB_SIZE + 100};
+    for (int32_t i = 0; i < 5; ++i)
+        writeTestFile(dir, L"f" + StringUtils::toString(i), lengths[i], i);
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        BOOST_CHECK_EQUAL(dir->fileLength(L"f" + StringUtils::toString(i)), lengths[i]);
+        checkTestFile(dir, L"f" + StringUtils::toString(i), lengths[i], i);
+    }
+    BOOST_CHECK_EQUAL(dir->sizeInBytes(), 7 * SLAB_SIZE + 100);
+    
+    // bulk reads, seeks and clones across slab boundaries
+    IndexInputPtr input = dir->openInput(L"f4");
+    ByteArray bytes(ByteArray::newInstance(3 * SLAB_SIZE));
+    input->seek(SLAB_SIZE - 7);
+    input->readBytes(bytes.get(), 0, bytes.size());
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        BOOST_CHECK_EQUAL(bytes[i], testFileByte(SLAB_SIZE - 7 + i, 4));
+    BOOST_CHECK_EQUAL(input->getFilePointer(), 4 * SLAB_SIZE - 7);
+    IndexInputPtr clone = boost::dynamic_pointer_cast<IndexInput>(input->clone());
+    BOOST_CHECK_EQUAL(clone->getFilePointer(), 4 * SLAB_SIZE - 7);
+    BOOST_CHECK_EQUAL(clone->readByte(), input->readByte());
+    input->seek(5 * SLAB_SIZE + 100);
+    BOOST_CHECK_EXCEPTION(input->readByte(), IOException, check_exception(LuceneException::IO));
+    input->close();
+    clone->close();
+    
+    dir->deleteFile(L"f1");
+    BOOST_CHECK(!dir->fileExists(L"f1"));
+    BOOST_CHECK_EXCEPTION(dir->openInput(L"f1"), FileNotFoundException, check_exception(LuceneException::FileNotFound));
+    BOOST_CHECK_EXCEPTION(dir->deleteFile(L"f1"), FileNotFoundException, check_exception(LuceneException::FileNotFound));
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testSeekBackWhileWriting)
+{
+    ArenaRAMDirectoryPtr dir(newLucene<ArenaRAMDirectory>(newLucene<RAMArena>(SLAB_SIZE)));
+    IndexOutputPtr output = dir->createOutput(L"test");
+    output->writeInt(0);
+    for (int32_t i = 0; i < 2 * SLAB_SIZE; ++i)
+        output->writeByte(1);
+    BOOST_CHECK_EQUAL(output->length(), 2 * SLAB_SIZE + 4);
+    output->seek(0);
+    output->writeInt(12345);
+    BOOST_CHECK_EQUAL(output->length(), 2 * SLAB_SIZE + 4);
+    
+    // not readable until closed
+    BOOST_CHECK_EXCEPTION(dir->openInput(L"test"), IOException, check_exception(LuceneException::IO));
+    output->close();
+    
+    IndexInputPtr input = dir->openInput(L"test");
+    BOOST_CHECK_EQUAL(input->length(), 2 * SLAB_SIZE + 4);
+    BOOST_CHECK_EQUAL(input->readInt(), 12345);
+    input->seek(2 * SLAB_SIZE + 3);
+    BOOST_CHECK_EQUAL(input->readByte(), 1);
+    input->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testSlabReuse)
+{
+    RAMArenaPtr arena(newLucene<RAMArena>(SLAB_SIZE));
+    ArenaRAMDirectoryPtr dir(newLucene<ArenaRAMDirectory>(arena));
+    for (int32_t i = 0; i < 50; ++i)
+        writeTestFile(dir, L"f" + StringUtils::toString(i), 10, i);
+    
+    // one slab to write into (re-used for each file) and one holding all the tails
+    BOOST_CHECK_EQUAL(arena->getNumSlabsAllocated(), 2);
+    for (int32_t i = 0; i < 50; ++i)
+        checkTestFile(dir, L"f" + StringUtils::toString(i), 10, i);
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testSnapshot)
+{
+    ArenaRAMDirectoryPtr dir(newLucene<ArenaRAMDirectory>(newLucene<RAMArena>(SLAB_SIZE)));
+    writeTestFile(dir, L"a", 3 * SLAB_SIZE, 1);
+    writeTestFile(dir, L"b", 100, 2);
+    IndexOutputPtr open = dir->createOutput(L"c");
+    open->writeByte(1);
+    
+    ArenaRAMDirectoryPtr snapshot(dir->snapshot());
+    BOOST_CHECK(snapshot->fileExists(L"a"));
+    BOOST_CHECK(snapshot->fileExists(L"b"));
+    BOOST_CHECK(!snapshot->fileExists(L"c"));
+    open->close();
+    
+    // changes to either directory aren't seen by the other
+    dir->deleteFile(L"a");
+    writeTestFile(dir, L"b", 50, 3);
+    writeTestFile(snapshot, L"d", 10, 4);
+    checkTestFile(snapshot, L"a", 3 * SLAB_SIZE, 1);
+    checkTestFile(snapshot, L"b", 100, 2);
+    checkTestFile(dir, L"b", 50, 3);
+    BOOST_CHECK(!dir->fileExists(L"d"));
+    
+    uint64_t modified = snapshot->fileModified(L"b");
+    dir->touchFile(L"b");
+    BOOST_CHECK_EQUAL(snapshot->fileModified(L"b"), modified);
+    
+    // snapshots outlive the directory they were taken from
+    dir->close();
+    checkTestFile(snapshot, L"a", 3 * SLAB_SIZE, 1);
+    snapshot->close();
+}
+
+class SnapshotSearchThread : public LuceneThread
+{
+public:
+    SnapshotSearchThread(DirectoryPtr dir)
+    {
+        this->dir = dir;
+        this->failed = false;
+    }
+    
+    virtual ~SnapshotSearchThread()
+    {
+    }
+    
+    LUCENE_CLASS(SnapshotSearchThread);
+
+public:
+    DirectoryPtr dir;
+    bool failed;
+
+public:
+    virtual void run()
+    {
+        try
+        {
+            IndexSearcherPtr searcher(newLucene<IndexSearcher>(dir, true));
+            for (int32_t i = 0; i < 50; ++i)
+            {
+                if (searcher->search(newLucene<TermQuery>(newLucene<Term>(L"content", L"aaa")), 10)->totalHits != 100)
+                    failed = true;
+            }
+            searcher->close();
+        }
+        catch (...)
+        {
+            failed = true;
+        }
+    }
+};
+
+BOOST_AUTO_TEST_CASE(testIndexAndSearchSnapshot)
+{
+    ArenaRAMDirectoryPtr dir(newLucene<ArenaRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMaxBufferedDocs(10);
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"content", L"aaa", Field::STORE_NO, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->commit();
+    ArenaRAMDirectoryPtr snapshot(dir->snapshot());
+    
+    // keep changing the index while other threads search the snapshot
+    Collection<LuceneThreadPtr> threads(Collection<LuceneThreadPtr>::newInstance(4));
+    for (int32_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i] = newLucene<SnapshotSearchThread>(snapshot);
+        threads[i]->start();
+    }
+    writer->optimize();
+    writer->close();
+    for (int32_t i = 0; i < threads.size(); ++i)
+    {
+        threads[i]->join();
+        BOOST_CHECK(!boost::dynamic_pointer_cast<SnapshotSearchThread>(threads[i])->failed);
+    }
+    
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), 100);
+    reader->close();
+    dir->close();
+    snapshot->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,256 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "BlockCacheDirectory.h"
+#include "BlockCache.h"
+#include "MockRAMDirectory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "IndexWriter.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "TermQuery.h"
+#include "Term.h"
+#include "TopDocs.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(BlockCacheDirectoryTest, LuceneTestFixture)
+
+static const int32_t PAGE_SIZE = 1024;
+
+BOOST_AUTO_TEST_CASE(testBlockCache)
+{
+    BlockCachePtr cache(newLucene<BlockCache>(4 * PAGE_SIZE, PAGE_SIZE, 1));
+    BOOST_CHECK_EQUAL(cache->getPageSize(), PAGE_SIZE);
+    BOOST_CHECK_EQUAL(cache->getMaxPages(), 4);
+    
+    int64_t fileId = cache->newFileId();
+    BOOST_CHECK(!cache->get(fileId, 0));
+    BOOST_CHECK_EQUAL(cache->getMissCount(), 1);
+    
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        ByteArray page(ByteArray::newInstance(PAGE_SIZE));
+        page[0] = (uint8_t)i;
+        cache->put(fileId, i, page);
+    }
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 4);
+    BOOST_CHECK_EQUAL(cache->get(fileId, 2)[0], 2);
+    BOOST_CHECK_EQUAL(cache->getHitCount(), 1);
+    BOOST_CHECK_EQUAL(cache->getEvictionCount(), 0);
+    
+    // adding a fifth page evicts one of the others
+    cache->put(fileId, 4, ByteArray::newInstance(PAGE_SIZE));
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 4);
+    BOOST_CHECK_EQUAL(cache->getEvictionCount(), 1);
+    BOOST_CHECK(cache->get(fileId, 4));
+    
+    // pages of another file are distinct
+    BOOST_CHECK(!cache->get(cache->newFileId(), 4));
+    
+    cache->clear();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 0);
+    BOOST_CHECK(!cache->get(fileId, 4));
+}
+
+BOOST_AUTO_TEST_CASE(testInvalidArguments)
+{
+    BOOST_CHECK_EQUAL(newLucene<BlockCache>(4 * PAGE_SIZE, 1000, 1)->getPageSize(), PAGE_SIZE);
+    BOOST_CHECK_EXCEPTION(newLucene<BlockCache>(0, PAGE_SIZE, 1), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    BOOST_CHECK_EXCEPTION(newLucene<BlockCache>(4 * PAGE_SIZE, 0, 1), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    BOOST_CHECK_EXCEPTION(newLucene<BlockCache>(4 * PAGE_SIZE, PAGE_SIZE, 0), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+}
+
+BOOST_AUTO_TEST_CASE(testReadThroughCache)
+{
+    BlockCachePtr cache(newLucene<BlockCache>(64 * PAGE_SIZE, PAGE_SIZE, 4));
+    BlockCacheDirectoryPtr dir(newLucene<BlockCacheDirectory>(newLucene<MockRAMDirectory>(), cache));
+    writeTestFile(dir, L"test.bin", 10 * PAGE_SIZE + 17, 0);
+    
+    IndexInputPtr input = dir->openInput(L"test.bin");
+    checkTestFile(input, 10 * PAGE_SIZE + 17, 0);
+    BOOST_CHECK_EXCEPTION(input->readByte(), IOException, check_exception(LuceneException::IO));
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 11);
+    BOOST_CHECK_EQUAL(cache->getMissCount(), 11);
+    BOOST_CHECK_EQUAL(cache->getHitCount(), 0);
+    
+    // a second input is served entirely from the cache
+    IndexInputPtr input2 = dir->openInput(L"test.bin");
+    checkTestFile(input2, 10 * PAGE_SIZE + 17, 0);
+    BOOST_CHECK_EQUAL(cache->getMissCount(), 11);
+    BOOST_CHECK_EQUAL(cache->getHitCount(), 11);
+    
+    // bulk reads and seeks across page boundaries
+    ByteArray bytes(ByteArray::newInstance(3 * PAGE_SIZE));
+    input2->seek(PAGE_SIZE - 5);
+    input2->readBytes(bytes.get(), 0, bytes.size());
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        BOOST_CHECK_EQUAL(bytes[i], testFileByte(PAGE_SIZE - 5 + i));
+    BOOST_CHECK_EQUAL(input2->getFilePointer(), 4 * PAGE_SIZE - 5);
+    
+    // clones keep their own position
+    IndexInputPtr clone = boost::dynamic_pointer_cast<IndexInput>(input2->clone());
+    BOOST_CHECK_EQUAL(clone->getFilePointer(), 4 * PAGE_SIZE - 5);
+    clone->seek(0);
+    BOOST_CHECK_EQUAL(clone->readByte(), 0);
+    BOOST_CHECK_EQUAL(input2->readByte(), testFileByte(4 * PAGE_SIZE - 5));
+    clone->close();
+    
+    input2->seek(10 * PAGE_SIZE + 17);
+    BOOST_CHECK_EXCEPTION(input2->readByte(), IOException, check_exception(LuceneException::IO));
+    
+    input->close();
+    input2->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testInvalidateOnRecreate)
+{
+    BlockCachePtr cache(newLucene<BlockCache>(64 * PAGE_SIZE, PAGE_SIZE, 4));
+    MockRAMDirectoryPtr mockDir(newLucene<MockRAMDirectory>());
+    mockDir->setPreventDoubleWrite(false);
+    BlockCacheDirectoryPtr dir(newLucene<BlockCacheDirectory>(mockDir, cache));
+    writeTestFile(dir, L"test.bin", 2 * PAGE_SIZE, 0);
+    IndexInputPtr input = dir->openInput(L"test.bin");
+    checkTestFile(input, 2 * PAGE_SIZE, 0);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 2);
+    
+    dir->deleteFile(L"test.bin");
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 0);
+    writeTestFile(dir, L"test.bin", 3 * PAGE_SIZE, 7);
+    input = dir->openInput(L"test.bin");
+    checkTestFile(input, 3 * PAGE_SIZE, 7);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 3);
+    
+    // re-created without deleting first
+    writeTestFile(dir, L"test.bin", PAGE_SIZE, 13);
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 0);
+    input = dir->openInput(L"test.bin");
+    checkTestFile(input, PAGE_SIZE, 13);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 1);
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testCachePolicies)
+{
+    BlockCachePtr cache(newLucene<BlockCache>(64 * PAGE_SIZE, PAGE_SIZE, 4));
+    BlockCacheDirectoryPtr dir(newLucene<BlockCacheDirectory>(newLucene<MockRAMDirectory>(), cache));
+    BOOST_CHECK_EQUAL(dir->getDefaultCachePolicy(), BlockCacheDirectory::CACHE_DEFAULT);
+    dir->setCachePolicy(L"fdt", BlockCacheDirectory::CACHE_NEVER);
+    dir->setCachePolicy(L"tis", BlockCacheDirectory::CACHE_ALWAYS);
+    BOOST_CHECK_EQUAL(dir->getCachePolicy(L"fdt"), BlockCacheDirectory::CACHE_NEVER);
+    BOOST_CHECK_EQUAL(dir->getCachePolicy(L"frq"), BlockCacheDirectory::CACHE_DEFAULT);
+    
+    writeTestFile(dir, L"_0.fdt", 4 * PAGE_SIZE, 0);
+    writeTestFile(dir, L"_0.frq", 4 * PAGE_SIZE, 0);
+    writeTestFile(dir, L"_0.tis", 4 * PAGE_SIZE, 0);
+    
+    // never cached
+    IndexInputPtr input = dir->openInput(L"_0.fdt");
+    checkTestFile(input, 4 * PAGE_SIZE, 0);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 0);
+    BOOST_CHECK_EQUAL(cache->getMissCount(), 0);
+    
+    // merge reads don't add pages for default extensions...
+    DirectoryPtr mergeDir(dir->getMergeReadDirectory());
+    input = mergeDir->openInput(L"_0.frq");
+    checkTestFile(input, 4 * PAGE_SIZE, 0);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 0);
+    BOOST_CHECK_EQUAL(cache->getMissCount(), 4);
+    
+    // ...but do for extensions that are always cached
+    input = mergeDir->openInput(L"_0.tis");
+    checkTestFile(input, 4 * PAGE_SIZE, 0);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 4);
+    
+    // searches add pages
+    input = dir->openInput(L"_0.frq");
+    checkTestFile(input, 4 * PAGE_SIZE, 0);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 8);
+    
+    // and merges then use them
+    input = mergeDir->openInput(L"_0.frq");
+    checkTestFile(input, 4 * PAGE_SIZE, 0);
+    input->close();
+    BOOST_CHECK_EQUAL(cache->getHitCount(), 4);
+    
+    dir->setDefaultCachePolicy(BlockCacheDirectory::CACHE_NEVER);
+    BOOST_CHECK_EQUAL(dir->getCachePolicy(L"frq"), BlockCacheDirectory::CACHE_NEVER);
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMergesDontAddPages)
+{
+    MockRAMDirectoryPtr mockDir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(mockDir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(false);
+    writer->setMaxBufferedDocs(10);
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+    
+    // only the segments files are read other than by the merge
+    BlockCachePtr cache(newLucene<BlockCache>(64 * PAGE_SIZE, PAGE_SIZE, 4));
+    BlockCacheDirectoryPtr dir(newLucene<BlockCacheDirectory>(mockDir, cache));
+    dir->setCachePolicy(L"", BlockCacheDirectory::CACHE_NEVER);
+    dir->setCachePolicy(L"gen", BlockCacheDirectory::CACHE_NEVER);
+    writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setUseCompoundFile(false);
+    writer->optimize();
+    writer->close();
+    BOOST_CHECK(cache->getMissCount() > 0);
+    BOOST_CHECK_EQUAL(cache->getPageCount(), 0);
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testIndexAndSearch)
+{
+    BlockCachePtr cache(newLucene<BlockCache>(16 * PAGE_SIZE, PAGE_SIZE, 4));
+    BlockCacheDirectoryPtr dir(newLucene<BlockCacheDirectory>(newLucene<MockRAMDirectory>(), cache));
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMaxBufferedDocs(10);
+    for (int32_t i = 0; i < 200; ++i)
+    {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"content", i % 2 == 0 ? L"even" : L"odd", Field::STORE_NO, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->optimize();
+    writer->close();
+    
+    // the second pass is served (at least partly) from the cache
+    for (int32_t pass = 0; pass < 2; ++pass)
+    {
+        IndexSearcherPtr searcher(newLucene<IndexSearcher>(dir, true));
+        BOOST_CHECK_EQUAL(searcher->search(newLucene<TermQuery>(newLucene<Term>(L"content", L"even")), 1000)->totalHits, 100);
+        BOOST_CHECK_EQUAL(searcher->search(newLucene<TermQuery>(newLucene<Term>(L"id", L"77")), 1000)->totalHits, 1);
+        for (int32_t i = 0; i < 200; ++i)
+            BOOST_CHECK_EQUAL(searcher->doc(i)->get(L"id"), StringUtils::toString(i));
+        searcher->close();
+    }
+    BOOST_CHECK(cache->getHitCount() > 0);
+    dir->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
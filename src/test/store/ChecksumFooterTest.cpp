@@ -0,0 +1,276 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "ChecksumFooter.h"
+#include "ChecksumFooterIndexOutput.h"
+#include "CRC32C.h"
+#include "RAMDirectory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "CompoundFileWriter.h"
+#include "CompoundFileReader.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "SerialMergeScheduler.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(ChecksumFooterTest, LuceneTestFixture)
+
+static void writeFile(DirectoryPtr dir, const String& name, int32_t length)
+{
+    writeTestFile(newLucene<ChecksumFooterIndexOutput>(dir->createOutput(name)), length);
+}
+
+/// Flip the bits of a single byte of a file
+static void corruptFile(DirectoryPtr dir, const String& name, int64_t position)
+{
+    IndexInputPtr input(dir->openInput(name));
+    int32_t length = (int32_t)input->length();
+    ByteArray bytes(ByteArray::newInstance(length));
+    input->readBytes(bytes.get(), 0, length);
+    input->close();
+    bytes[position] = ~bytes[position];
+    IndexOutputPtr output(dir->createOutput(name));
+    output->writeBytes(bytes.get(), length);
+    output->close();
+}
+
+BOOST_AUTO_TEST_CASE(testFooter)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    writeFile(dir, L"test", 1000);
+
+    BOOST_CHECK_EQUAL(dir->fileLength(L"test"), 1000 + ChecksumFooter::FOOTER_LENGTH);
+
+    IndexInputPtr input(dir->openInput(L"test"));
+    BOOST_CHECK_EQUAL(ChecksumFooter::dataLength(input), 1000);
+    for (int32_t i = 0; i < 1000; ++i)
+        BOOST_CHECK_EQUAL(input->readByte(), testFileByte(i));
+    BOOST_CHECK_EQUAL(input->readInt(), ChecksumFooter::FOOTER_MAGIC);
+    BOOST_CHECK_EQUAL(input->readInt(), ChecksumFooter::ALGORITHM_CRC32C);
+    int64_t checksum = input->readLong();
+    BOOST_CHECK_EQUAL(ChecksumFooter::checksumEntireFile(input), checksum);
+    input->close();
+}
+
+BOOST_AUTO_TEST_CASE(testNoFooter)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"plain"));
+    output->writeInt(1234);
+    output->close();
+
+    BOOST_CHECK_EXCEPTION(ChecksumFooter::checksumEntireFile(dir, L"plain"), LuceneException, check_exception(LuceneException::CorruptIndex));
+}
+
+BOOST_AUTO_TEST_CASE(testSeekBackInHeader)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(newLucene<ChecksumFooterIndexOutput>(dir->createOutput(L"test")));
+    output->writeInt(0);
+    output->writeLong(0);
+    for (int32_t i = 0; i < 100000; ++i)
+        output->writeVInt(i);
+    output->seek(4);
+    output->writeLong(123456789);
+    output->close();
+
+    IndexInputPtr input(dir->openInput(L"test"));
+    BOOST_CHECK(ChecksumFooter::checksumEntireFile(input) != -1);
+    input->seek(4);
+    BOOST_CHECK_EQUAL(input->readLong(), 123456789);
+    input->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMixedWriteSizes)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(newLucene<ChecksumFooterIndexOutput>(dir->createOutput(L"test")));
+    ByteArray bytes(ByteArray::newInstance(5000));
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = testFileByte(i);
+    // single bytes and writes smaller than, equal to and larger than the checksum buffer
+    int32_t lengths[] = {1, 7, 1023, 1024, 1025, 5000, 3};
+    for (int32_t i = 0; i < 7; ++i)
+    {
+        output->writeBytes(bytes.get(), lengths[i]);
+        output->writeByte((uint8_t)i);
+    }
+    output->close();
+
+    IndexInputPtr input(dir->openInput(L"test"));
+    BOOST_CHECK(ChecksumFooter::checksumEntireFile(input) != -1);
+    input->close();
+}
+
+BOOST_AUTO_TEST_CASE(testSeekBackPastHeader)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(newLucene<ChecksumFooterIndexOutput>(dir->createOutput(L"test")));
+    for (int32_t i = 0; i < 100000; ++i)
+        output->writeInt(i);
+    output->seek(ChecksumFooterIndexOutput::HEADER_WINDOW * 2);
+    BOOST_CHECK_EXCEPTION({
+        output->writeInt(0);
+        output->flush();
+    }, LuceneException, check_exception(LuceneException::IllegalState));
+}
+
+BOOST_AUTO_TEST_CASE(testCorruptionDetected)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    writeFile(dir, L"test", 1000);
+    corruptFile(dir, L"test", 500);
+    BOOST_CHECK_EXCEPTION(ChecksumFooter::checksumEntireFile(dir, L"test"), LuceneException, check_exception(LuceneException::CorruptIndex));
+}
+
+BOOST_AUTO_TEST_CASE(testCompoundFile)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    writeFile(dir, L"a", 10);
+    writeFile(dir, L"b", 100000);
+    writeFile(dir, L"c", 0);
+
+    CompoundFileWriterPtr cfw(newLucene<CompoundFileWriter>(dir, L"test.cfs"));
+    cfw->addFile(L"a", true);
+    cfw->addFile(L"b", true);
+    cfw->addFile(L"c", true);
+    cfw->close();
+
+    BOOST_CHECK(ChecksumFooter::checksumEntireFile(dir, L"test.cfs") != -1);
+
+    CompoundFileReaderPtr cfr(newLucene<CompoundFileReader>(dir, L"test.cfs"));
+    BOOST_CHECK_EQUAL(cfr->fileLength(L"a"), 10 + ChecksumFooter::FOOTER_LENGTH);
+    BOOST_CHECK_EQUAL(cfr->fileLength(L"b"), 100000 + ChecksumFooter::FOOTER_LENGTH);
+    BOOST_CHECK_EQUAL(cfr->fileLength(L"c"), ChecksumFooter::FOOTER_LENGTH);
+    BOOST_CHECK_EQUAL(ChecksumFooter::checksumEntireFile(cfr, L"b"), ChecksumFooter::checksumEntireFile(dir, L"b"));
+    IndexInputPtr input(cfr->openInput(L"b"));
+    for (int32_t i = 0; i < 100000; ++i)
+        BOOST_CHECK_EQUAL(input->readByte(), testFileByte(i));
+    input->close();
+    cfr->close();
+}
+
+BOOST_AUTO_TEST_CASE(testCompoundFileCopyDetectsCorruption)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    writeFile(dir, L"a", 10);
+    writeFile(dir, L"b", 100000);
+    corruptFile(dir, L"b", 70000);
+
+    CompoundFileWriterPtr cfw(newLucene<CompoundFileWriter>(dir, L"test.cfs"));
+    cfw->addFile(L"a", true);
+    cfw->addFile(L"b", true);
+    BOOST_CHECK_EXCEPTION(cfw->close(), LuceneException, check_exception(LuceneException::CorruptIndex));
+}
+
+BOOST_AUTO_TEST_CASE(testCompoundFileCopyRequiresFooter)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"plain"));
+    for (int32_t i = 0; i < 100; ++i)
+        output->writeInt(i);
+    output->close();
+
+    CompoundFileWriterPtr cfw(newLucene<CompoundFileWriter>(dir, L"test.cfs"));
+    cfw->addFile(L"plain", true);
+    BOOST_CHECK_EXCEPTION(cfw->close(), LuceneException, check_exception(LuceneException::CorruptIndex));
+}
+
+BOOST_AUTO_TEST_CASE(testFooterlessCompoundFileEndingLikeFooter)
+{
+    // a compound file written before footers, whose last sub-file happens to end like a footer
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"test.cfs"));
+    output->writeVInt(1);
+    output->writeLong(1 + 8 + 2);
+    output->writeString(L"a");
+    output->writeInt(1234);
+    output->writeInt(ChecksumFooter::FOOTER_MAGIC);
+    output->writeInt(ChecksumFooter::ALGORITHM_CRC32C);
+    output->writeLong(0);
+    output->close();
+
+    CompoundFileReaderPtr cfr(newLucene<CompoundFileReader>(dir, L"test.cfs"));
+    BOOST_CHECK_EQUAL(cfr->fileLength(L"a"), 4 + ChecksumFooter::FOOTER_LENGTH);
+    cfr->close();
+}
+
+static void addDocs(IndexWriterPtr writer, int32_t numDocs)
+{
+    for (int32_t i = 0; i < numDocs; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"content", L"aaa bbb " + StringUtils::toString(i), Field::STORE_YES, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testCheckIntegrityAtMerge)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(false);
+    addDocs(writer, 20);
+    writer->commit();
+    addDocs(writer, 20);
+    writer->close();
+
+    // flip a byte in the postings of the first segment
+    BOOST_CHECK(dir->fileExists(L"_0.frq"));
+    corruptFile(dir, L"_0.frq", 0);
+
+    writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setMergeScheduler(newLucene<SerialMergeScheduler>());
+    BOOST_CHECK(!writer->getCheckIntegrityAtMerge());
+    writer->setCheckIntegrityAtMerge(true);
+    BOOST_CHECK_EXCEPTION(writer->optimize(), LuceneException, check_exception(LuceneException::CorruptIndex));
+    writer->rollback();
+
+    // the index is left as it was
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), 40);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_CASE(testTermVectorsVerifiedWhileMerging)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(false);
+    for (int32_t i = 0; i < 40; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"content", L"aaa bbb " + StringUtils::toString(i), Field::STORE_NO, Field::INDEX_ANALYZED, Field::TERM_VECTOR_WITH_POSITIONS_OFFSETS));
+        writer->addDocument(doc);
+        if (i == 19)
+            writer->commit();
+    }
+    writer->close();
+
+    // flip a byte in the term vectors of the first segment, which the merge copies without decoding
+    BOOST_CHECK(dir->fileExists(L"_0.tvf"));
+    corruptFile(dir, L"_0.tvf", dir->fileLength(L"_0.tvf") / 2);
+
+    writer = newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), false, IndexWriter::MaxFieldLengthLIMITED);
+    writer->setMergeScheduler(newLucene<SerialMergeScheduler>());
+    BOOST_CHECK(!writer->getCheckIntegrityAtMerge());
+    BOOST_CHECK_EXCEPTION(writer->optimize(), LuceneException, check_exception(LuceneException::CorruptIndex));
+    writer->rollback();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), 40);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -12,10 +12,12 @@
 #include "FSDirectory.h"
 #include "SimpleFSDirectory.h"
 #include "MMapDirectory.h"
+#include "NIOFSDirectory.h"
 #include "RAMDirectory.h"
 #include "IndexInput.h"
 #include "IndexOutput.h"
 #include "FileUtils.h"
+#include "MiscUtils.h"
 
 using namespace Lucene;
 
@@ -97,6 +99,15 @@ namespace TestDirectInstantiation
         bool isMMapDirectory() { return false; }
     };
 
+    class TestableNIOFSDirectory : public NIOFSDirectory
+    {
+    public:
+        TestableNIOFSDirectory(const String& path) : NIOFSDirectory(path) {}
+        virtual ~TestableNIOFSDirectory() {}
+        using NIOFSDirectory::ensureOpen;
+        bool isMMapDirectory() { return false; }
+    };
+
     class TestableMMapDirectory : public MMapDirectory
     {
     public:
@@ -121,6 +132,122 @@ BOOST_AUTO_TEST_CASE(testDirectInstantiation)
     TestInstantiationPair(mmapDir, fsDir, L"foo.1", L"foo1.lck");
 }
 
+BOOST_AUTO_TEST_CASE(testNIOFSInstantiation)
+{
+    TestDirectInstantiation::TestableSimpleFSDirectory fsDir(getTempDir());
+    fsDir.ensureOpen();
+
+    TestDirectInstantiation::TestableNIOFSDirectory nioDir(getTempDir());
+    nioDir.ensureOpen();
+
+    TestDirectInstantiation::TestableMMapDirectory mmapDir(getTempDir());
+    mmapDir.ensureOpen();
+
+    TestInstantiationPair(fsDir, nioDir, L"foo.0", L"foo0.lck");
+    TestInstantiationPair(nioDir, fsDir, L"foo.1", L"foo1.lck");
+    TestInstantiationPair(nioDir, mmapDir, L"foo.1", L"foo1.lck");
+    TestInstantiationPair(mmapDir, nioDir, L"foo.2", L"foo2.lck");
+}
+
+BOOST_AUTO_TEST_CASE(testOpen)
+{
+    // positional reads are opt-in
+    FSDirectoryPtr dir(FSDirectory::open(getTempDir()));
+    BOOST_CHECK(MiscUtils::typeOf<SimpleFSDirectory>(dir));
+    dir->close();
+    dir = FSDirectory::open(getTempDir(), LockFactoryPtr(), true);
+    #if defined(_WIN32) || defined(_WIN64)
+    BOOST_CHECK(MiscUtils::typeOf<SimpleFSDirectory>(dir));
+    #else
+    BOOST_CHECK(MiscUtils::typeOf<NIOFSDirectory>(dir));
+    #endif
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testNIOFSClones)
+{
+    NIOFSDirectoryPtr dir(newLucene<NIOFSDirectory>(getTempDir()));
+    IndexOutputPtr out = dir->createOutput(L"nio.bin");
+    for (int32_t i = 0; i < 10000; ++i)
+        out->writeVInt(i);
+    out->close();
+    
+    IndexInputPtr input = dir->openInput(L"nio.bin", 128);
+    IndexInputPtr clone = boost::dynamic_pointer_cast<IndexInput>(input->clone());
+    for (int32_t i = 0; i < 10000; ++i)
+    {
+        // interleave reads on the original and the clone, which share one file descriptor
+        BOOST_CHECK_EQUAL(input->readVInt(), i);
+        BOOST_CHECK_EQUAL(clone->readVInt(), i);
+    }
+    BOOST_CHECK_EXCEPTION(input->readByte(), IOException, check_exception(LuceneException::IO));
+    clone->close();
+    input->close();
+    dir->deleteFile(L"nio.bin");
+    dir->close();
+}
+
+static void checkSlices(DirectoryPtr dir)
+{
+    int32_t fileLength = 3 * 65536;
+    writeTestFile(dir, L"slice.bin", fileLength);
+    
+    IndexInputPtr input = dir->openInput(L"slice.bin");
+    input->seek(1000);
+    
+    // straddles the boundary between the first two mapped chunks
+    int64_t offset = 65536 - 100;
+    int32_t length = 65536 + 200;
+    IndexInputPtr slice = input->slice(offset, length);
+    BOOST_CHECK_EQUAL(slice->length(), length);
+    BOOST_CHECK_EQUAL(slice->getFilePointer(), 0);
+    BOOST_CHECK_EQUAL(input->getFilePointer(), 1000); // slicing doesn't move the file pointer
+    for (int32_t i = 0; i < length; ++i)
+        BOOST_CHECK_EQUAL(slice->readByte(), testFileByte(offset + i));
+    BOOST_CHECK_EQUAL(slice->getFilePointer(), length);
+    BOOST_CHECK_EXCEPTION(slice->readByte(), IOException, check_exception(LuceneException::IO));
+    
+    ByteArray bytes(ByteArray::newInstance(length));
+    slice->seek(0);
+    slice->readBytes(bytes.get(), 0, length);
+    for (int32_t i = 0; i < length; i += 1013)
+        BOOST_CHECK_EQUAL(bytes[i], testFileByte(offset + i));
+    slice->seek(length - 10);
+    BOOST_CHECK_EXCEPTION(slice->readBytes(bytes.get(), 0, 20), IOException, check_exception(LuceneException::IO));
+    
+    // clones and slices of a slice stay within it
+    IndexInputPtr clone = boost::dynamic_pointer_cast<IndexInput>(slice->clone());
+    clone->seek(50);
+    BOOST_CHECK_EQUAL(clone->readByte(), testFileByte(offset + 50));
+    IndexInputPtr subSlice = slice->slice(100, 10);
+    BOOST_CHECK_EQUAL(subSlice->length(), 10);
+    BOOST_CHECK_EQUAL(subSlice->readByte(), testFileByte(offset + 100));
+    subSlice->seek(9);
+    subSlice->readByte();
+    BOOST_CHECK_EXCEPTION(subSlice->readByte(), IOException, check_exception(LuceneException::IO));
+    
+    BOOST_CHECK_EXCEPTION(input->slice(fileLength - 10, 20), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    BOOST_CHECK_EXCEPTION(slice->slice(-1, 10), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    
+    // closing a slice leaves the input open
+    slice->close();
+    BOOST_CHECK_EQUAL(input->readByte(), testFileByte(1000));
+    
+    input->close();
+    dir->deleteFile(L"slice.bin");
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testSlices)
+{
+    checkSlices(newLucene<SimpleFSDirectory>(getTempDir()));
+    checkSlices(newLucene<NIOFSDirectory>(getTempDir()));
+    MMapDirectoryPtr mmapDir(newLucene<MMapDirectory>(getTempDir()));
+    mmapDir->setMaxChunkSize(65536);
+    checkSlices(mmapDir);
+    checkSlices(newLucene<RAMDirectory>());
+}
+
 BOOST_AUTO_TEST_CASE(testDontCreate)
 {
     String path(FileUtils::joinPath(getTempDir(), L"doesnotexist"));
@@ -0,0 +1,219 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "DirectoryWarmer.h"
+#include "MMapDirectory.h"
+#include "NIOFSDirectory.h"
+#include "SimpleFSDirectory.h"
+#include "RAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexCommit.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "FileUtils.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(DirectoryWarmerTest, LuceneTestFixture)
+
+DECLARE_SHARED_PTR(ProgressDirectoryWarmer)
+
+class ProgressDirectoryWarmer : public DirectoryWarmer
+{
+public:
+    ProgressDirectoryWarmer()
+    {
+        files = HashSet<String>::newInstance();
+        lastBytesWarmed = 0;
+    }
+
+    virtual ~ProgressDirectoryWarmer()
+    {
+    }
+
+    LUCENE_CLASS(ProgressDirectoryWarmer);
+
+public:
+    HashSet<String> files;
+    int64_t lastBytesWarmed;
+
+protected:
+    virtual void progress(const String& fileName, int64_t bytesWarmed, int64_t bytesToWarm)
+    {
+        BOOST_CHECK(bytesWarmed > lastBytesWarmed || bytesWarmed == 0);
+        BOOST_CHECK(bytesWarmed <= bytesToWarm);
+        files.add(fileName);
+        lastBytesWarmed = bytesWarmed;
+    }
+};
+
+static void createIndex(DirectoryPtr dir, bool useCompoundFile)
+{
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(useCompoundFile);
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        DocumentPtr doc(newLucene<Document>());
+        doc->add(newLucene<Field>(L"content", L"aaa bbb " + StringUtils::toString(i), Field::STORE_YES, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+    }
+    writer->close();
+}
+
+static void checkWarmFile(FSDirectoryPtr dir)
+{
+    writeTestFile(dir, L"test", 100000);
+    dir->warmFile(L"test", FSDirectory::WARM_NONE);
+    dir->warmFile(L"test", FSDirectory::WARM_ADVISE);
+    dir->warmFile(L"test", FSDirectory::WARM_PRELOAD);
+    dir->warmFile(L"test", FSDirectory::WARM_PRELOAD, 5000, 10000);
+    dir->warmFile(L"test", FSDirectory::WARM_ADVISE, 99999, 1);
+    dir->warmFile(L"test", FSDirectory::WARM_PRELOAD, 100000, 0);
+    BOOST_CHECK_EXCEPTION(dir->warmFile(L"test", FSDirectory::WARM_PRELOAD, 99999, 2), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    BOOST_CHECK_EXCEPTION(dir->warmFile(L"test", FSDirectory::WARM_PRELOAD, -1), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    dir->deleteFile(L"test");
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testWarmFile)
+{
+    checkWarmFile(newLucene<SimpleFSDirectory>(getTempDir()));
+    checkWarmFile(newLucene<NIOFSDirectory>(getTempDir()));
+    MMapDirectoryPtr mmapDir(newLucene<MMapDirectory>(getTempDir()));
+    mmapDir->setMaxChunkSize(65536); // ranges cross chunks
+    checkWarmFile(mmapDir);
+}
+
+BOOST_AUTO_TEST_CASE(testLockFile)
+{
+    MMapDirectoryPtr dir(newLucene<MMapDirectory>(FileUtils::joinPath(getTempDir(), L"testLockFile")));
+    dir->setMaxChunkSize(65536);
+    writeTestFile(dir, L"a", 100000);
+    writeTestFile(dir, L"b", 100);
+
+    dir->warmFile(L"a", FSDirectory::WARM_LOCK, 0, 70000);
+    dir->warmFile(L"a", FSDirectory::WARM_LOCK, 70000, 30000);
+    dir->warmFile(L"b", FSDirectory::WARM_LOCK);
+    BOOST_CHECK_EQUAL(dir->getLockedFiles().size(), 2);
+    BOOST_CHECK(dir->getLockedFiles().contains(L"a"));
+
+    dir->unlockFile(L"a");
+    BOOST_CHECK(!dir->getLockedFiles().contains(L"a"));
+    dir->unlockFile(L"a");
+
+    // deleting or overwriting a file releases its lock
+    dir->warmFile(L"a", FSDirectory::WARM_LOCK);
+    dir->deleteFile(L"b");
+    BOOST_CHECK(!dir->getLockedFiles().contains(L"b"));
+    writeTestFile(dir, L"a", 10);
+    BOOST_CHECK(dir->getLockedFiles().empty());
+
+    dir->warmFile(L"a", FSDirectory::WARM_LOCK);
+    dir->close();
+    BOOST_CHECK(dir->getLockedFiles().empty());
+}
+
+BOOST_AUTO_TEST_CASE(testDefaultModes)
+{
+    DirectoryWarmerPtr warmer(newLucene<DirectoryWarmer>());
+    BOOST_CHECK_EQUAL(warmer->getMode(L"tii"), FSDirectory::WARM_PRELOAD);
+    BOOST_CHECK_EQUAL(warmer->getMode(L"nrm"), FSDirectory::WARM_PRELOAD);
+    BOOST_CHECK_EQUAL(warmer->getMode(L"tis"), FSDirectory::WARM_ADVISE);
+    BOOST_CHECK_EQUAL(warmer->getMode(L"frq"), FSDirectory::WARM_ADVISE);
+    BOOST_CHECK_EQUAL(warmer->getMode(L"prx"), FSDirectory::WARM_NONE);
+    BOOST_CHECK_EQUAL(warmer->getMode(L"fdt"), FSDirectory::WARM_NONE);
+    warmer->setMode(L"prx", FSDirectory::WARM_LOCK);
+    BOOST_CHECK_EQUAL(warmer->getMode(L"prx"), FSDirectory::WARM_LOCK);
+    BOOST_CHECK(!warmer->getBackground());
+}
+
+BOOST_AUTO_TEST_CASE(testWarmCommit)
+{
+    FSDirectoryPtr dir(newLucene<NIOFSDirectory>(FileUtils::joinPath(getTempDir(), L"testWarmCommit")));
+    createIndex(dir, false);
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    ProgressDirectoryWarmerPtr warmer(newLucene<ProgressDirectoryWarmer>());
+    warmer->warm(reader->getIndexCommit());
+
+    BOOST_CHECK(warmer->files.contains(L"_0.tii"));
+    BOOST_CHECK(warmer->files.contains(L"_0.tis"));
+    BOOST_CHECK(warmer->files.contains(L"_0.frq"));
+    BOOST_CHECK(warmer->files.contains(L"_0.nrm"));
+    BOOST_CHECK(!warmer->files.contains(L"_0.prx"));
+    BOOST_CHECK(!warmer->files.contains(L"_0.fdt"));
+    int64_t expected = dir->fileLength(L"_0.tii") + dir->fileLength(L"_0.tis") + dir->fileLength(L"_0.frq") + dir->fileLength(L"_0.nrm");
+    BOOST_CHECK_EQUAL(warmer->getBytesToWarm(), expected);
+    BOOST_CHECK_EQUAL(warmer->getBytesWarmed(), expected);
+    BOOST_CHECK_EQUAL(warmer->lastBytesWarmed, expected);
+
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testWarmCompoundFile)
+{
+    MMapDirectoryPtr dir(newLucene<MMapDirectory>(FileUtils::joinPath(getTempDir(), L"testWarmCompoundFile")));
+    createIndex(dir, true);
+    BOOST_CHECK(dir->fileExists(L"_0.cfs"));
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    ProgressDirectoryWarmerPtr warmer(newLucene<ProgressDirectoryWarmer>());
+    warmer->setMode(L"tii", FSDirectory::WARM_LOCK);
+    warmer->warm(reader->getIndexCommit());
+
+    // only the parts of the compound file are warmed
+    BOOST_CHECK_EQUAL(warmer->files.size(), 1);
+    BOOST_CHECK(warmer->files.contains(L"_0.cfs"));
+    BOOST_CHECK(warmer->getBytesToWarm() > 0);
+    BOOST_CHECK(warmer->getBytesToWarm() < dir->fileLength(L"_0.cfs"));
+    BOOST_CHECK_EQUAL(warmer->getBytesWarmed(), warmer->getBytesToWarm());
+    BOOST_CHECK(dir->getLockedFiles().contains(L"_0.cfs"));
+
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testOpenWithWarmer)
+{
+    FSDirectoryPtr dir(newLucene<MMapDirectory>(FileUtils::joinPath(getTempDir(), L"testOpenWithWarmer")));
+    createIndex(dir, false);
+
+    DirectoryWarmerPtr warmer(newLucene<DirectoryWarmer>());
+    warmer->setBackground(true);
+    IndexReaderPtr reader(IndexReader::open(dir, true, warmer));
+    warmer->waitForCompletion();
+    BOOST_CHECK(!warmer->isRunning());
+    BOOST_CHECK(warmer->getBytesToWarm() > 0);
+    BOOST_CHECK_EQUAL(warmer->getBytesWarmed(), warmer->getBytesToWarm());
+    BOOST_CHECK_EQUAL(reader->numDocs(), 100);
+    reader->close();
+
+    reader = IndexReader::open(dir, true, DirectoryWarmerPtr());
+    BOOST_CHECK_EQUAL(reader->numDocs(), 100);
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testNonFSDirectory)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    createIndex(dir, false);
+
+    DirectoryWarmerPtr warmer(newLucene<DirectoryWarmer>());
+    IndexReaderPtr reader(IndexReader::open(dir, true, warmer));
+    BOOST_CHECK_EQUAL(warmer->getBytesToWarm(), 0);
+    BOOST_CHECK_EQUAL(reader->numDocs(), 100);
+    reader->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -15,6 +15,8 @@
 #include "Document.h"
 #include "Field.h"
 #include "Random.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
 #include "FileUtils.h"
 
 using namespace Lucene;
@@ -68,4 +70,69 @@ BOOST_AUTO_TEST_CASE(testMmapIndex)
     FileUtils::removeDirectory(storePathname);
 }
 
+BOOST_AUTO_TEST_CASE(testMaxChunkSize)
+{
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneMmapChunkSize"));
+    MMapDirectoryPtr storeDirectory(newLucene<MMapDirectory>(storePathname));
+    BOOST_CHECK_EQUAL(storeDirectory->getMaxChunkSize(), MMapDirectory::DEFAULT_MAX_CHUNK_SIZE);
+    storeDirectory->setMaxChunkSize(100000);
+    BOOST_CHECK_EQUAL(storeDirectory->getMaxChunkSize(), 65536);
+    BOOST_CHECK_EXCEPTION(storeDirectory->setMaxChunkSize(0), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    storeDirectory->close();
+}
+
+BOOST_AUTO_TEST_CASE(testMultiChunkRead)
+{
+    String storePathname(FileUtils::joinPath(getTempDir(), L"testLuceneMmapChunks"));
+    MMapDirectoryPtr storeDirectory(newLucene<MMapDirectory>(storePathname));
+    storeDirectory->setMaxChunkSize(65536);
+    
+    RandomPtr random = newLucene<Random>();
+    Collection<int32_t> ints(Collection<int32_t>::newInstance(40000));
+    Collection<int64_t> longs(Collection<int64_t>::newInstance(ints.size()));
+    
+    IndexOutputPtr output = storeDirectory->createOutput(L"chunks.bin");
+    for (int32_t i = 0; i < ints.size(); ++i)
+    {
+        ints[i] = random->nextInt(INT_MAX);
+        longs[i] = ((int64_t)random->nextInt(INT_MAX) << 31) | ints[i];
+        output->writeVInt(ints[i]);
+        output->writeVLong(longs[i]);
+        output->writeByte((uint8_t)i);
+    }
+    output->close();
+    
+    IndexInputPtr input = storeDirectory->openInput(L"chunks.bin");
+    BOOST_CHECK(input->length() > 3 * 65536);
+    for (int32_t i = 0; i < ints.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(input->readVInt(), ints[i]);
+        BOOST_CHECK_EQUAL(input->readVLong(), longs[i]);
+        BOOST_CHECK_EQUAL(input->readByte(), (uint8_t)i);
+    }
+    BOOST_CHECK_EQUAL(input->getFilePointer(), input->length());
+    BOOST_CHECK_EXCEPTION(input->readByte(), IOException, check_exception(LuceneException::IO));
+    
+    // bulk read straddling several chunk boundaries, from a clone
+    int64_t start = 65536 - 10;
+    ByteArray bulk(ByteArray::newInstance(3 * 65536));
+    IndexInputPtr clone = boost::dynamic_pointer_cast<IndexInput>(input->clone());
+    clone->seek(start);
+    clone->readBytes(bulk.get(), 0, bulk.size());
+    BOOST_CHECK_EQUAL(clone->getFilePointer(), start + bulk.size());
+    for (int32_t i = 0; i < bulk.size(); i += 4099)
+    {
+        input->seek(start + i);
+        BOOST_CHECK_EQUAL(input->readByte(), bulk[i]);
+    }
+    
+    // reading past the end of the last chunk fails
+    clone->seek(input->length() - 2);
+    BOOST_CHECK_EXCEPTION(clone->readBytes(bulk.get(), 0, 4), IOException, check_exception(LuceneException::IO));
+    
+    input->close();
+    storeDirectory->close();
+    FileUtils::removeDirectory(storePathname);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,122 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "NRTCachingDirectory.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "TermQuery.h"
+#include "Term.h"
+#include "TopDocs.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(NRTCachingDirectoryTest, LuceneTestFixture)
+
+BOOST_AUTO_TEST_CASE(testNRTAndCommit)
+{
+    MockRAMDirectoryPtr delegate(newLucene<MockRAMDirectory>());
+    NRTCachingDirectoryPtr cachedDir(newLucene<NRTCachingDirectory>(delegate, 2.0, 25.0));
+    IndexWriterPtr writer(newLucene<IndexWriter>(cachedDir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setMergeScheduler(cachedDir->getMergeScheduler());
+    writer->setMergeFactor(3);
+    
+    IndexReaderPtr reader;
+    for (int32_t i = 0; i < 100; ++i)
+    {
+        DocumentPtr doc = newLucene<Document>();
+        doc->add(newLucene<Field>(L"id", StringUtils::toString(i), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+        doc->add(newLucene<Field>(L"content", L"aaa", Field::STORE_NO, Field::INDEX_ANALYZED));
+        writer->addDocument(doc);
+        if (i % 10 == 9)
+        {
+            IndexReaderPtr newReader = reader ? reader->reopen() : writer->getReader();
+            if (newReader != reader)
+            {
+                if (reader)
+                    reader->close();
+                reader = newReader;
+            }
+            BOOST_CHECK_EQUAL(reader->numDocs(), i + 1);
+            IndexSearcherPtr searcher(newLucene<IndexSearcher>(reader));
+            BOOST_CHECK_EQUAL(searcher->search(newLucene<TermQuery>(newLucene<Term>(L"content", L"aaa")), 1000)->totalHits, i + 1);
+            
+            // freshly flushed segments live only in RAM
+            BOOST_CHECK(!cachedDir->listCachedFiles().empty());
+            BOOST_CHECK(cachedDir->sizeInBytes() > 0);
+            HashSet<String> cachedFiles(cachedDir->listCachedFiles());
+            for (HashSet<String>::iterator file = cachedFiles.begin(); file != cachedFiles.end(); ++file)
+            {
+                BOOST_CHECK(!delegate->fileExists(*file));
+                BOOST_CHECK(cachedDir->fileExists(*file));
+                BOOST_CHECK(cachedDir->listAll().contains(*file));
+            }
+        }
+    }
+    reader->close();
+    
+    // a commit writes everything it references to the delegate
+    writer->waitForMerges();
+    writer->commit();
+    HashSet<String> cachedFiles(cachedDir->listCachedFiles());
+    BOOST_CHECK(cachedFiles.empty());
+    
+    IndexReaderPtr delegateReader = IndexReader::open(delegate, true);
+    BOOST_CHECK_EQUAL(delegateReader->numDocs(), 100);
+    delegateReader->close();
+    
+    writer->close();
+    cachedDir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testCacheLimit)
+{
+    MockRAMDirectoryPtr delegate(newLucene<MockRAMDirectory>());
+    NRTCachingDirectoryPtr cachedDir(newLucene<NRTCachingDirectory>(delegate, 0.0, 0.001));
+    
+    // the first file fits, after which the cache is full
+    writeTestFile(cachedDir, L"a.bin", 2000);
+    writeTestFile(cachedDir, L"b.bin", 2000);
+    BOOST_CHECK(cachedDir->listCachedFiles().contains(L"a.bin"));
+    BOOST_CHECK(!cachedDir->listCachedFiles().contains(L"b.bin"));
+    BOOST_CHECK(!delegate->fileExists(L"a.bin"));
+    BOOST_CHECK(delegate->fileExists(L"b.bin"));
+    BOOST_CHECK_EQUAL(cachedDir->fileLength(L"a.bin"), 2000);
+    checkTestFile(cachedDir, L"a.bin", 2000);
+    checkTestFile(cachedDir, L"b.bin", 2000);
+    
+    // syncing moves the file to the delegate
+    cachedDir->sync(L"a.bin");
+    BOOST_CHECK(cachedDir->listCachedFiles().empty());
+    BOOST_CHECK_EQUAL(cachedDir->sizeInBytes(), 0);
+    checkTestFile(delegate, L"a.bin", 2000);
+    
+    // re-creating a file through the cache replaces the delegate's copy
+    writeTestFile(cachedDir, L"b.bin", 100);
+    BOOST_CHECK(cachedDir->listCachedFiles().contains(L"b.bin"));
+    BOOST_CHECK(!delegate->fileExists(L"b.bin"));
+    checkTestFile(cachedDir, L"b.bin", 100);
+    
+    cachedDir->deleteFile(L"b.bin");
+    BOOST_CHECK(!cachedDir->fileExists(L"b.bin"));
+    
+    // segments.gen is never cached
+    writeTestFile(cachedDir, L"segments.gen", 20);
+    BOOST_CHECK(delegate->fileExists(L"segments.gen"));
+    
+    cachedDir->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "TestUtils.h"
+#include "ReadBatch.h"
+#include "NIOFSDirectory.h"
+#include "SimpleFSDirectory.h"
+#include "MMapDirectory.h"
+#include "RAMDirectory.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
+#include "FileUtils.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(ReadBatchTest, LuceneTestFixture)
+
+static const int32_t FILE_LENGTH = 100000;
+
+static void checkSubmitReads(DirectoryPtr dir)
+{
+    writeTestFile(dir, L"batch.bin", FILE_LENGTH);
+    
+    IndexInputPtr input = dir->openInput(L"batch.bin");
+    input->seek(1234);
+    
+    // more reads than fit in a single submission queue, in no particular order
+    ReadBatchPtr batch(newLucene<ReadBatch>());
+    for (int32_t i = 0; i < 200; ++i)
+    {
+        int64_t position = ((int64_t)i * 7919) % (FILE_LENGTH - 1000);
+        BOOST_CHECK_EQUAL(batch->add(position, 1 + (i % 1000)), i);
+    }
+    input->submitReads(batch);
+    batch->waitForCompletion();
+    
+    for (int32_t i = 0; i < batch->size(); ++i)
+    {
+        ByteArray bytes(batch->getBytes(i));
+        BOOST_CHECK_EQUAL(bytes.size(), 1 + (i % 1000));
+        for (int32_t j = 0; j < bytes.size(); ++j)
+            BOOST_CHECK_EQUAL(bytes[j], testFileByte(batch->getPosition(i) + j));
+    }
+    
+    // submitting reads doesn't move the file pointer
+    BOOST_CHECK_EQUAL(input->getFilePointer(), 1234);
+    BOOST_CHECK_EQUAL(input->readByte(), testFileByte(1234));
+    
+    // a read past the end of the file is reported when the batch completes
+    ReadBatchPtr badBatch(newLucene<ReadBatch>());
+    badBatch->add(0, 10);
+    badBatch->add(FILE_LENGTH - 5, 10);
+    try
+    {
+        input->submitReads(badBatch);
+        badBatch->waitForCompletion();
+        BOOST_FAIL("Expected IOException");
+    }
+    catch (IOException& e)
+    {
+        BOOST_CHECK(check_exception(LuceneException::IO)(e));
+    }
+    
+    input->close();
+    dir->deleteFile(L"batch.bin");
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testNIOFSDirectory)
+{
+    checkSubmitReads(newLucene<NIOFSDirectory>(FileUtils::joinPath(getTempDir(), L"testReadBatch")));
+}
+
+BOOST_AUTO_TEST_CASE(testSimpleFSDirectory)
+{
+    checkSubmitReads(newLucene<SimpleFSDirectory>(FileUtils::joinPath(getTempDir(), L"testReadBatch")));
+}
+
+BOOST_AUTO_TEST_CASE(testRAMDirectory)
+{
+    checkSubmitReads(newLucene<RAMDirectory>());
+}
+
+BOOST_AUTO_TEST_CASE(testEmptyBatch)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    dir->createOutput(L"empty.bin")->close();
+    IndexInputPtr input = dir->openInput(L"empty.bin");
+    ReadBatchPtr batch(newLucene<ReadBatch>());
+    input->submitReads(batch);
+    batch->waitForCompletion();
+    BOOST_CHECK_EQUAL(batch->size(), 0);
+    input->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
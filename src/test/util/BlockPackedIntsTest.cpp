@@ -0,0 +1,112 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "BlockPackedInts.h"
+#include "RAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(BlockPackedIntsTest, LuceneTestFixture)
+
+static void checkRoundTrip(Collection<IntArray> blocks)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    BlockPackedIntsPtr packer(newLucene<BlockPackedInts>());
+    IndexOutputPtr output(dir->createOutput(L"packed"));
+    for (Collection<IntArray>::iterator block = blocks.begin(); block != blocks.end(); ++block)
+        packer->writeBlock(output, block->get());
+    output->writeVInt(12345);
+    output->close();
+
+    IndexInputPtr input(dir->openInput(L"packed"));
+    IntArray values(IntArray::newInstance(BlockPackedInts::BLOCK_SIZE));
+    for (Collection<IntArray>::iterator block = blocks.begin(); block != blocks.end(); ++block)
+    {
+        packer->readBlock(input, values.get());
+        for (int32_t i = 0; i < BlockPackedInts::BLOCK_SIZE; ++i)
+            BOOST_CHECK_EQUAL(values[i], (*block)[i]);
+    }
+    BOOST_CHECK_EQUAL(input->readVInt(), 12345);
+    input->close();
+}
+
+BOOST_AUTO_TEST_CASE(testEveryBitWidth)
+{
+    RandomPtr random(newLucene<Random>(42));
+    Collection<IntArray> blocks(Collection<IntArray>::newInstance());
+    for (int32_t bits = 0; bits <= 31; ++bits)
+    {
+        IntArray block(IntArray::newInstance(BlockPackedInts::BLOCK_SIZE));
+        for (int32_t i = 0; i < BlockPackedInts::BLOCK_SIZE; ++i)
+            block[i] = bits == 0 ? 0 : (random->nextInt() & (int32_t)((1u << bits) - 1));
+        block[random->nextInt(BlockPackedInts::BLOCK_SIZE)] = bits == 0 ? 0 : (int32_t)((1u << bits) - 1);
+        blocks.add(block);
+    }
+    IntArray max(IntArray::newInstance(BlockPackedInts::BLOCK_SIZE));
+    for (int32_t i = 0; i < BlockPackedInts::BLOCK_SIZE; ++i)
+        max[i] = INT_MAX - i;
+    blocks.add(max);
+    checkRoundTrip(blocks);
+}
+
+BOOST_AUTO_TEST_CASE(testExceptions)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IntArray block(IntArray::newInstance(BlockPackedInts::BLOCK_SIZE));
+    for (int32_t i = 0; i < BlockPackedInts::BLOCK_SIZE; ++i)
+        block[i] = i % 3;
+    block[7] = 1000000;
+    block[127] = 70000;
+
+    BlockPackedIntsPtr packer(newLucene<BlockPackedInts>());
+    IndexOutputPtr output(dir->createOutput(L"packed"));
+    packer->writeBlock(output, block.get());
+    output->close();
+
+    // the two large values are stored as exceptions rather than widening the block
+    BOOST_CHECK(dir->fileLength(L"packed") < 2 + 5 * 16);
+
+    Collection<IntArray> blocks(Collection<IntArray>::newInstance());
+    blocks.add(block);
+    checkRoundTrip(blocks);
+}
+
+BOOST_AUTO_TEST_CASE(testNegativeValue)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IntArray block(IntArray::newInstance(BlockPackedInts::BLOCK_SIZE));
+    for (int32_t i = 0; i < BlockPackedInts::BLOCK_SIZE; ++i)
+        block[i] = i;
+    block[10] = -1;
+    BlockPackedIntsPtr packer(newLucene<BlockPackedInts>());
+    IndexOutputPtr output(dir->createOutput(L"packed"));
+    BOOST_CHECK_EXCEPTION(packer->writeBlock(output, block.get()), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    output->close();
+}
+
+BOOST_AUTO_TEST_CASE(testPrefixSum)
+{
+    for (int32_t length = 0; length <= 11; ++length)
+    {
+        IntArray values(IntArray::newInstance(std::max(length, 1)));
+        for (int32_t i = 0; i < length; ++i)
+            values[i] = i + 1;
+        BlockPackedInts::prefixSum(values.get(), length, 100);
+        int32_t expected = 100;
+        for (int32_t i = 0; i < length; ++i)
+        {
+            expected += i + 1;
+            BOOST_CHECK_EQUAL(values[i], expected);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
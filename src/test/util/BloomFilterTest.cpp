@@ -0,0 +1,196 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "BloomFilter.h"
+#include "RAMDirectory.h"
+#include "MockRAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "WhitespaceAnalyzer.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermDocs.h"
+#include "TermEnum.h"
+#include "MiscUtils.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(BloomFilterTest, LuceneTestFixture)
+
+static const int32_t NUM_VALUES = 10000;
+
+static int64_t hashValue(const String& value)
+{
+    SingleString utf8(StringUtils::toUTF8(value));
+    return BloomFilter::hash((const uint8_t*)utf8.c_str(), (int32_t)utf8.length());
+}
+
+static BloomFilterPtr createFilter()
+{
+    Collection<int64_t> hashes(Collection<int64_t>::newInstance());
+    for (int32_t i = 0; i < NUM_VALUES; ++i)
+        hashes.add(hashValue(L"id" + StringUtils::toString(i)));
+    return BloomFilter::create(hashes);
+}
+
+/// Returns the number of values that are not in the filter but may be.
+static int32_t falsePositives(BloomFilterPtr filter)
+{
+    int32_t count = 0;
+    for (int32_t i = NUM_VALUES; i < 2 * NUM_VALUES; ++i)
+    {
+        if (filter->mayContain(hashValue(L"id" + StringUtils::toString(i))))
+            ++count;
+    }
+    return count;
+}
+
+BOOST_AUTO_TEST_CASE(testHash)
+{
+    BOOST_CHECK_EQUAL(hashValue(L"abc"), hashValue(L"abc"));
+    BOOST_CHECK_NE(hashValue(L"abc"), hashValue(L"abd"));
+    BOOST_CHECK_NE(hashValue(L""), hashValue(L"a"));
+    // tails of each length are mixed in
+    for (int32_t length = 1; length < 17; ++length)
+        BOOST_CHECK_NE(hashValue(String(length, L'x')), hashValue(String(length + 1, L'x')));
+}
+
+BOOST_AUTO_TEST_CASE(testNoFalseNegatives)
+{
+    BloomFilterPtr filter(createFilter());
+    for (int32_t i = 0; i < NUM_VALUES; ++i)
+        BOOST_CHECK(filter->mayContain(hashValue(L"id" + StringUtils::toString(i))));
+    BOOST_CHECK_EQUAL(filter->getNumBits(), 131072);
+    BOOST_CHECK_EQUAL(filter->sizeInBytes(), 131072 / 8);
+    BOOST_CHECK(filter->getNumHashes() >= 7 && filter->getNumHashes() <= BloomFilter::MAX_HASHES);
+}
+
+BOOST_AUTO_TEST_CASE(testFalsePositiveRate)
+{
+    // at least ten bits per value keeps the rate under 1%
+    BOOST_CHECK(falsePositives(createFilter()) < NUM_VALUES / 100);
+
+    Collection<int64_t> hashes(Collection<int64_t>::newInstance());
+    for (int32_t i = 0; i < NUM_VALUES; ++i)
+        hashes.add(hashValue(L"id" + StringUtils::toString(i)));
+    BOOST_CHECK(falsePositives(BloomFilter::create(hashes, 4)) > falsePositives(createFilter()));
+}
+
+BOOST_AUTO_TEST_CASE(testEmpty)
+{
+    BloomFilterPtr filter(BloomFilter::create(Collection<int64_t>::newInstance()));
+    BOOST_CHECK_EQUAL(filter->getNumBits(), 64);
+    BOOST_CHECK(!filter->mayContain(hashValue(L"id")));
+}
+
+BOOST_AUTO_TEST_CASE(testReadWrite)
+{
+    BloomFilterPtr filter(createFilter());
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"filter"));
+    filter->write(output);
+    output->close();
+
+    IndexInputPtr input(dir->openInput(L"filter"));
+    BloomFilterPtr read(BloomFilter::read(input));
+    BOOST_CHECK_EQUAL(input->getFilePointer(), input->length());
+    input->close();
+
+    BOOST_CHECK_EQUAL(read->getNumBits(), filter->getNumBits());
+    BOOST_CHECK_EQUAL(read->getNumHashes(), filter->getNumHashes());
+    for (int32_t i = 0; i < 2 * NUM_VALUES; ++i)
+    {
+        int64_t hash = hashValue(L"id" + StringUtils::toString(i));
+        BOOST_CHECK_EQUAL(read->mayContain(hash), filter->mayContain(hash));
+    }
+}
+
+static DocumentPtr createDocument(int32_t id, const String& body)
+{
+    DocumentPtr doc(newLucene<Document>());
+    FieldPtr idField(newLucene<Field>(L"id", L"id" + StringUtils::toString(id), Field::STORE_YES, Field::INDEX_NOT_ANALYZED_NO_NORMS));
+    idField->setBloomFiltered(true);
+    doc->add(idField);
+    doc->add(newLucene<Field>(L"body", body, Field::STORE_NO, Field::INDEX_ANALYZED));
+    return doc;
+}
+
+/// Checks that each of the ids below numIds has one live document, and that ids that were never added have none.
+static void checkIds(IndexReaderPtr reader, int32_t numIds)
+{
+    for (int32_t i = 0; i < 600; ++i)
+    {
+        TermPtr term(newLucene<Term>(L"id", L"id" + StringUtils::toString(i)));
+        if (i >= 500)
+            BOOST_CHECK_EQUAL(reader->docFreq(term), 0);
+        TermDocsPtr termDocs(reader->termDocs(term));
+        BOOST_CHECK_EQUAL(termDocs->next(), i < numIds);
+        if (i < numIds)
+            BOOST_CHECK(!termDocs->next());
+        termDocs->close();
+    }
+    // fields without a filter and enumeration are unaffected
+    BOOST_CHECK(reader->docFreq(newLucene<Term>(L"body", L"even")) >= 250);
+    BOOST_CHECK_EQUAL(reader->docFreq(newLucene<Term>(L"missing", L"id1")), 0);
+    TermEnumPtr terms(reader->terms(newLucene<Term>(L"id", L"id")));
+    BOOST_CHECK_EQUAL(terms->term()->field(), L"id");
+    terms->close();
+}
+
+static void checkIndex(bool compound)
+{
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    writer->setUseCompoundFile(compound);
+    writer->setMaxBufferedDocs(50);
+    writer->setMergeFactor(100);
+    for (int32_t i = 0; i < 500; ++i)
+        writer->addDocument(createDocument(i, i % 2 == 0 ? L"even" : L"odd"));
+    writer->commit();
+    if (!compound)
+        BOOST_CHECK(dir->fileExists(L"_0.blm"));
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK(reader->getSequentialSubReaders().size() > 1);
+    checkIds(reader, 500);
+    reader->close();
+
+    // updates and deletes find the single document of each id
+    for (int32_t i = 0; i < 500; i += 10)
+        writer->updateDocument(newLucene<Term>(L"id", L"id" + StringUtils::toString(i)), createDocument(i, i % 2 == 0 ? L"even" : L"odd"));
+    writer->deleteDocuments(newLucene<Term>(L"id", L"id499"));
+    writer->deleteDocuments(newLucene<Term>(L"id", L"id1000"));
+    writer->commit();
+    reader = IndexReader::open(dir, true);
+    BOOST_CHECK_EQUAL(reader->numDocs(), 499);
+    checkIds(reader, 499);
+    reader->close();
+
+    writer->optimize();
+    writer->close();
+    reader = IndexReader::open(dir, true);
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 1);
+    checkIds(reader, 499);
+    reader->close();
+    dir->close();
+}
+
+BOOST_AUTO_TEST_CASE(testIndex)
+{
+    checkIndex(false);
+}
+
+BOOST_AUTO_TEST_CASE(testCompoundIndex)
+{
+    checkIndex(true);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
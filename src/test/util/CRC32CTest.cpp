@@ -0,0 +1,103 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "CRC32C.h"
+#include "Random.h"
+#include "MiscUtils.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(CRC32CTest, LuceneTestFixture)
+
+static int64_t checksumOf(const uint8_t* b, int32_t length)
+{
+    CRC32CPtr checksum(newLucene<CRC32C>());
+    checksum->update(b, 0, length);
+    return checksum->getValue();
+}
+
+BOOST_AUTO_TEST_CASE(testKnownValues)
+{
+    BOOST_CHECK_EQUAL(checksumOf(NULL, 0), 0);
+
+    const char* check = "123456789";
+    BOOST_CHECK_EQUAL(checksumOf((const uint8_t*)check, 9), 0xe3069283LL);
+
+    // test vectors from RFC 3720 (iSCSI)
+    ByteArray zeros(ByteArray::newInstance(32));
+    MiscUtils::arrayFill(zeros.get(), 0, 32, 0);
+    BOOST_CHECK_EQUAL(checksumOf(zeros.get(), 32), 0x8a9136aaLL);
+
+    ByteArray ones(ByteArray::newInstance(32));
+    MiscUtils::arrayFill(ones.get(), 0, 32, 0xff);
+    BOOST_CHECK_EQUAL(checksumOf(ones.get(), 32), 0x62a8ab43LL);
+
+    ByteArray ascending(ByteArray::newInstance(32));
+    for (int32_t i = 0; i < 32; ++i)
+        ascending[i] = (uint8_t)i;
+    BOOST_CHECK_EQUAL(checksumOf(ascending.get(), 32), 0x46dd794eLL);
+}
+
+BOOST_AUTO_TEST_CASE(testIncrementalMatchesBulk)
+{
+    RandomPtr random(newLucene<Random>());
+    ByteArray bytes(ByteArray::newInstance(10000));
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = (uint8_t)random->nextInt(256);
+
+    int64_t expected = checksumOf(bytes.get(), bytes.size());
+
+    CRC32CPtr single(newLucene<CRC32C>());
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        single->update(bytes[i]);
+    BOOST_CHECK_EQUAL(single->getValue(), expected);
+
+    // unaligned chunks of random length
+    CRC32CPtr chunked(newLucene<CRC32C>());
+    int32_t offset = 0;
+    while (offset < bytes.size())
+    {
+        int32_t length = std::min(random->nextInt(37) + 1, bytes.size() - offset);
+        chunked->update(bytes.get(), offset, length);
+        offset += length;
+    }
+    BOOST_CHECK_EQUAL(chunked->getValue(), expected);
+
+    chunked->reset();
+    BOOST_CHECK_EQUAL(chunked->getValue(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testPatch)
+{
+    RandomPtr random(newLucene<Random>());
+    ByteArray bytes(ByteArray::newInstance(1000));
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = (uint8_t)random->nextInt(256);
+
+    for (int32_t iter = 0; iter < 50; ++iter)
+    {
+        CRC32CPtr checksum(newLucene<CRC32C>());
+        checksum->update(bytes.get(), 0, bytes.size());
+
+        int32_t length = random->nextInt(16) + 1;
+        int32_t position = random->nextInt(bytes.size() - length);
+        uint8_t oldBytes[16];
+        uint8_t newBytes[16];
+        for (int32_t i = 0; i < length; ++i)
+        {
+            oldBytes[i] = bytes[position + i];
+            newBytes[i] = (uint8_t)random->nextInt(256);
+            bytes[position + i] = newBytes[i];
+        }
+
+        checksum->patch(bytes.size(), position, oldBytes, newBytes, length);
+        BOOST_CHECK_EQUAL(checksum->getValue(), checksumOf(bytes.get(), bytes.size()));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
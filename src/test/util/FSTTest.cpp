@@ -0,0 +1,210 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "FST.h"
+#include "FSTBuilder.h"
+#include "RAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+#include "MiscUtils.h"
+#include "UnicodeUtils.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(FSTTest, LuceneTestFixture)
+
+typedef std::set<std::string> KeySet;
+
+static FSTPtr buildFST(const KeySet& keys)
+{
+    FSTBuilderPtr builder(newLucene<FSTBuilder>());
+    int64_t ordinal = 0;
+    for (KeySet::const_iterator key = keys.begin(); key != keys.end(); ++key)
+        builder->add((const uint8_t*)key->data(), (int32_t)key->length(), ordinal++);
+    BOOST_CHECK_EQUAL(builder->size(), (int64_t)keys.size());
+    return builder->finish();
+}
+
+static std::string toKey(UTF8ResultPtr result)
+{
+    return std::string((const char*)result->result.get(), result->length);
+}
+
+static int64_t ordinalOf(const KeySet& keys, KeySet::const_iterator key)
+{
+    return (int64_t)std::distance(keys.begin(), key);
+}
+
+static void checkFST(FSTPtr fst, const KeySet& keys, RandomPtr random)
+{
+    int64_t ordinal = 0;
+    for (KeySet::const_iterator key = keys.begin(); key != keys.end(); ++key)
+        BOOST_CHECK_EQUAL(fst->get((const uint8_t*)key->data(), (int32_t)key->length()), ordinal++);
+
+    // the ordinals increase with the keys, so each key can be found from its ordinal
+    UTF8ResultPtr found(newLucene<UTF8Result>());
+    ordinal = 0;
+    for (KeySet::const_iterator key = keys.begin(); key != keys.end(); ++key)
+    {
+        BOOST_CHECK(fst->getKey(ordinal++, found));
+        BOOST_CHECK(toKey(found) == *key);
+    }
+    BOOST_CHECK(!fst->getKey(ordinal, found));
+    BOOST_CHECK(!fst->getKey(-1, found));
+    
+    for (int32_t i = 0; i < 2000; ++i)
+    {
+        std::string probe;
+        int32_t length = random->nextInt(6);
+        for (int32_t j = 0; j < length; ++j)
+            probe += (char)(uint8_t)(random->nextInt(4) == 0 ? random->nextInt(256) : 'a' + random->nextInt(4));
+
+        bool exists = (keys.find(probe) != keys.end());
+        BOOST_CHECK_EQUAL(fst->get((const uint8_t*)probe.data(), (int32_t)probe.length()), exists ? ordinalOf(keys, keys.find(probe)) : -1);
+
+        // ceil is the first key >= probe
+        KeySet::const_iterator ceil = keys.lower_bound(probe);
+        int64_t output = fst->ceil((const uint8_t*)probe.data(), (int32_t)probe.length(), found);
+        if (ceil == keys.end())
+            BOOST_CHECK_EQUAL(output, -1);
+        else
+        {
+            BOOST_CHECK_EQUAL(output, ordinalOf(keys, ceil));
+            BOOST_CHECK(toKey(found) == *ceil);
+        }
+
+        // floor is the last key <= probe
+        KeySet::const_iterator floor = keys.upper_bound(probe);
+        output = fst->floor((const uint8_t*)probe.data(), (int32_t)probe.length(), found);
+        if (floor == keys.begin())
+            BOOST_CHECK_EQUAL(output, -1);
+        else
+        {
+            --floor;
+            BOOST_CHECK_EQUAL(output, ordinalOf(keys, floor));
+            BOOST_CHECK(toKey(found) == *floor);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testRandomKeys)
+{
+    RandomPtr random(newLucene<Random>(17));
+    for (int32_t iter = 0; iter < 5; ++iter)
+    {
+        KeySet keys;
+        int32_t numKeys = 1 + random->nextInt(iter == 0 ? 10 : 3000);
+        for (int32_t i = 0; i < numKeys; ++i)
+        {
+            std::string key;
+            int32_t length = random->nextInt(8);
+            for (int32_t j = 0; j < length; ++j)
+                key += (char)(uint8_t)(random->nextInt(8) == 0 ? random->nextInt(256) : 'a' + random->nextInt(4));
+            keys.insert(key);
+        }
+        checkFST(buildFST(keys), keys, random);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSharedSuffixes)
+{
+    KeySet keys;
+    const char* prefixes[] = {"con", "pre", "re", "sub", "trans"};
+    const char* suffixes[] = {"fer", "fers", "ferred", "ferring", "form", "forms", "formed", "forming"};
+    int64_t totalLength = 0;
+    for (int32_t i = 0; i < 5; ++i)
+    {
+        for (int32_t j = 0; j < 8; ++j)
+        {
+            keys.insert(std::string(prefixes[i]) + suffixes[j]);
+            totalLength += (int64_t)(std::strlen(prefixes[i]) + std::strlen(suffixes[j]));
+        }
+    }
+    FSTPtr fst(buildFST(keys));
+    checkFST(fst, keys, newLucene<Random>(3));
+
+    // the suffixes are only stored once
+    BOOST_CHECK(fst->sizeInBytes() < totalLength);
+}
+
+BOOST_AUTO_TEST_CASE(testEmptyKey)
+{
+    KeySet keys;
+    keys.insert("");
+    keys.insert(std::string(1, '\0'));
+    keys.insert("a");
+    keys.insert("ab");
+    checkFST(buildFST(keys), keys, newLucene<Random>(5));
+}
+
+BOOST_AUTO_TEST_CASE(testEmpty)
+{
+    FSTPtr fst(newLucene<FSTBuilder>()->finish());
+    UTF8ResultPtr found(newLucene<UTF8Result>());
+    const uint8_t key[] = {'a'};
+    BOOST_CHECK_EQUAL(fst->get(key, 1), -1);
+    BOOST_CHECK_EQUAL(fst->get(key, 0), -1);
+    BOOST_CHECK_EQUAL(fst->floor(key, 1, found), -1);
+    BOOST_CHECK_EQUAL(fst->ceil(key, 0, found), -1);
+    BOOST_CHECK(!fst->getKey(0, found));
+}
+
+BOOST_AUTO_TEST_CASE(testLargeOutputs)
+{
+    FSTBuilderPtr builder(newLucene<FSTBuilder>());
+    const uint8_t a[] = {'a'};
+    const uint8_t ab[] = {'a', 'b'};
+    const uint8_t b[] = {'b'};
+    builder->add(a, 1, 5);
+    builder->add(ab, 2, (int64_t)1 << 40);
+    builder->add(b, 1, ((int64_t)1 << 40) + 7);
+    FSTPtr fst(builder->finish());
+    BOOST_CHECK_EQUAL(fst->get(a, 1), 5);
+    BOOST_CHECK_EQUAL(fst->get(ab, 2), (int64_t)1 << 40);
+    BOOST_CHECK_EQUAL(fst->get(b, 1), ((int64_t)1 << 40) + 7);
+    UTF8ResultPtr found(newLucene<UTF8Result>());
+    BOOST_CHECK(fst->getKey((int64_t)1 << 40, found));
+    BOOST_CHECK_EQUAL(found->length, 2);
+    BOOST_CHECK(!fst->getKey(6, found));
+}
+
+BOOST_AUTO_TEST_CASE(testUnsortedKeys)
+{
+    FSTBuilderPtr builder(newLucene<FSTBuilder>());
+    const uint8_t ab[] = {'a', 'b'};
+    const uint8_t a[] = {'a'};
+    builder->add(ab, 2, 0);
+    BOOST_CHECK_EXCEPTION(builder->add(ab, 2, 1), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    BOOST_CHECK_EXCEPTION(builder->add(a, 1, 1), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+    BOOST_CHECK_EXCEPTION(builder->add(ab, 0, -1), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+}
+
+BOOST_AUTO_TEST_CASE(testWriteRead)
+{
+    KeySet keys;
+    RandomPtr random(newLucene<Random>(11));
+    for (int32_t i = 0; i < 500; ++i)
+        keys.insert(std::string("key") + (char)('a' + random->nextInt(26)) + (char)('a' + random->nextInt(26)));
+    FSTPtr fst(buildFST(keys));
+
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"fst"));
+    fst->write(output);
+    output->writeVInt(42);
+    output->close();
+
+    IndexInputPtr input(dir->openInput(L"fst"));
+    FSTPtr read(newLucene<FST>(input));
+    BOOST_CHECK_EQUAL(input->readVInt(), 42);
+    input->close();
+    BOOST_CHECK_EQUAL(read->sizeInBytes(), fst->sizeInBytes());
+    checkFST(read, keys, random);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
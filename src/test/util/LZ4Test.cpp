@@ -0,0 +1,103 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "LZ4.h"
+#include "RAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(LZ4Test, LuceneTestFixture)
+
+/// Compresses the bytes, checks they decompress to the same bytes and returns the compressed length.
+static int64_t checkRoundTrip(ByteArray bytes, int32_t length)
+{
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"compressed"));
+    newLucene<LZ4>()->compress(bytes.get(), 0, length, output);
+    int64_t compressedLength = output->getFilePointer();
+    output->writeVInt(12345);
+    output->close();
+
+    IndexInputPtr input(dir->openInput(L"compressed"));
+    ByteArray restored(ByteArray::newInstance(length + 2));
+    restored[0] = 7;
+    restored[length + 1] = 9;
+    LZ4::decompress(input, length, restored.get(), 1);
+    BOOST_CHECK_EQUAL(restored[0], 7);
+    BOOST_CHECK_EQUAL(restored[length + 1], 9);
+    for (int32_t i = 0; i < length; ++i)
+        BOOST_CHECK_EQUAL(restored[i + 1], bytes[i]);
+    BOOST_CHECK_EQUAL(input->readVInt(), 12345);
+    input->close();
+    return compressedLength;
+}
+
+BOOST_AUTO_TEST_CASE(testShortInputs)
+{
+    ByteArray bytes(ByteArray::newInstance(16));
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = 'a';
+    for (int32_t length = 0; length <= bytes.size(); ++length)
+        checkRoundTrip(bytes, length);
+}
+
+BOOST_AUTO_TEST_CASE(testRandomBytes)
+{
+    RandomPtr random(newLucene<Random>(42));
+    ByteArray bytes(ByteArray::newInstance(70000));
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = (uint8_t)random->nextInt(256);
+    // incompressible input grows by little more than its literal run headers
+    BOOST_CHECK(checkRoundTrip(bytes, bytes.size()) < bytes.size() + bytes.size() / 200 + 16);
+}
+
+BOOST_AUTO_TEST_CASE(testRepetitiveBytes)
+{
+    RandomPtr random(newLucene<Random>(7));
+    ByteArray bytes(ByteArray::newInstance(100000));
+    String words[] = {L"apple ", L"banana ", L"cherry ", L"date ", L"elderberry "};
+    int32_t length = 0;
+    while (true)
+    {
+        String word(words[random->nextInt(5)]);
+        if (length + (int32_t)word.length() > bytes.size())
+            break;
+        for (String::iterator c = word.begin(); c != word.end(); ++c)
+            bytes[length++] = (uint8_t)*c;
+    }
+    // greedy matching against a single earlier candidate gets about a third of the length here
+    BOOST_CHECK(checkRoundTrip(bytes, length) < length / 2);
+
+    // long runs exercise the extended literal and match lengths and overlapping matches
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = i < 300 ? (uint8_t)random->nextInt(256) : (uint8_t)(i % 3);
+    BOOST_CHECK(checkRoundTrip(bytes, bytes.size()) < 1000);
+}
+
+BOOST_AUTO_TEST_CASE(testCorruptInput)
+{
+    ByteArray bytes(ByteArray::newInstance(1000));
+    for (int32_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = (uint8_t)(i % 10);
+
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"compressed"));
+    newLucene<LZ4>()->compress(bytes.get(), 0, bytes.size(), output);
+    output->close();
+
+    // claiming fewer decompressed bytes than were compressed makes a match overrun the output
+    IndexInputPtr input(dir->openInput(L"compressed"));
+    ByteArray restored(ByteArray::newInstance(bytes.size()));
+    BOOST_CHECK_EXCEPTION(LZ4::decompress(input, 100, restored.get(), 0), LuceneException, check_exception(LuceneException::CorruptIndex));
+    input->close();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
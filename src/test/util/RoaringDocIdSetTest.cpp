@@ -0,0 +1,230 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include "LuceneTestFixture.h"
+#include "RoaringDocIdSet.h"
+#include "OpenBitSet.h"
+#include "OpenBitSetIterator.h"
+#include "DocIdSetIterator.h"
+#include "RAMDirectory.h"
+#include "IndexOutput.h"
+#include "IndexInput.h"
+#include "Random.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(RoaringDocIdSetTest, LuceneTestFixture)
+
+static const int32_t MAX_DOC = 6 * 65536 + 1000;
+
+static RandomPtr random = newLucene<Random>(123);
+
+/// Fills a set with blocks of each kind: sparse, dense, runs of doc ids and empty.
+static void fillMixed(OpenBitSetPtr expected, RoaringDocIdSetPtr set)
+{
+    for (int32_t doc = 0; doc < MAX_DOC; ++doc)
+    {
+        int32_t block = doc >> 16;
+        bool add = false;
+        if (block == 0 || block == 5)
+            add = (random->nextInt(100) == 0);
+        else if (block == 1 || block == 6)
+            add = (random->nextInt(3) != 0);
+        else if (block == 2)
+            add = ((doc & 1023) < 700);
+        else if (block == 3)
+            add = (doc == 3 * 65536 + 17);
+        if (add)
+        {
+            expected->set((int64_t)doc);
+            set->set(doc);
+        }
+    }
+}
+
+static void checkEquals(OpenBitSetPtr expected, RoaringDocIdSetPtr set)
+{
+    BOOST_CHECK_EQUAL(set->cardinality(), expected->cardinality());
+    DocIdSetIteratorPtr expectedDocs(newLucene<OpenBitSetIterator>(expected));
+    DocIdSetIteratorPtr docs(set->iterator());
+    int32_t doc;
+    do
+    {
+        doc = expectedDocs->nextDoc();
+        BOOST_CHECK_EQUAL(docs->nextDoc(), doc);
+    }
+    while (doc != DocIdSetIterator::NO_MORE_DOCS);
+
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        doc = random->nextInt(MAX_DOC);
+        BOOST_CHECK_EQUAL(set->get(doc), expected->get(doc));
+    }
+}
+
+static void checkAdvance(OpenBitSetPtr expected, RoaringDocIdSetPtr set)
+{
+    DocIdSetIteratorPtr docs(set->iterator());
+    int32_t doc = -1;
+    while (doc != DocIdSetIterator::NO_MORE_DOCS)
+    {
+        int32_t target = doc + 1 + random->nextInt(random->nextInt(2) == 0 ? 10 : 70000);
+        int32_t next = target >= MAX_DOC ? -1 : expected->nextSetBit(target);
+        doc = docs->advance(target);
+        BOOST_CHECK_EQUAL(doc, next == -1 ? DocIdSetIterator::NO_MORE_DOCS : next);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testMixedBlocks)
+{
+    OpenBitSetPtr expected(newLucene<OpenBitSet>(MAX_DOC));
+    RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>());
+    fillMixed(expected, set);
+    checkEquals(expected, set);
+    checkAdvance(expected, set);
+
+    int64_t size = set->sizeInBytes();
+    set->optimize();
+    checkEquals(expected, set);
+    checkAdvance(expected, set);
+
+    // the runs take much less than their array or bitmap
+    BOOST_CHECK(set->sizeInBytes() < size - 8192);
+}
+
+BOOST_AUTO_TEST_CASE(testFromIterator)
+{
+    OpenBitSetPtr expected(newLucene<OpenBitSet>(MAX_DOC));
+    RoaringDocIdSetPtr filled(newLucene<RoaringDocIdSet>());
+    fillMixed(expected, filled);
+    RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>(newLucene<OpenBitSetIterator>(expected)));
+    checkEquals(expected, set);
+    checkAdvance(expected, set);
+    BOOST_CHECK(set->isCacheable());
+
+    RoaringDocIdSetPtr empty(newLucene<RoaringDocIdSet>(newLucene<OpenBitSetIterator>(newLucene<OpenBitSet>(10))));
+    BOOST_CHECK(empty->isEmpty());
+    BOOST_CHECK_EQUAL(empty->iterator()->nextDoc(), DocIdSetIterator::NO_MORE_DOCS);
+}
+
+BOOST_AUTO_TEST_CASE(testRuns)
+{
+    RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>());
+    for (int32_t doc = 100; doc < 200000; ++doc)
+        set->set(doc);
+    set->optimize();
+    BOOST_CHECK_EQUAL(set->cardinality(), 200000 - 100);
+    BOOST_CHECK(set->sizeInBytes() < 100);
+    BOOST_CHECK(!set->get(99));
+    BOOST_CHECK(set->get(100));
+    BOOST_CHECK(set->get(199999));
+    BOOST_CHECK(!set->get(200000));
+    BOOST_CHECK_EQUAL(set->iterator()->advance(65536 * 2 + 5), 65536 * 2 + 5);
+
+    // changing a run keeps the other doc ids
+    set->clear(70000);
+    set->set(50);
+    BOOST_CHECK_EQUAL(set->cardinality(), 200000 - 100);
+    BOOST_CHECK(!set->get(70000));
+    BOOST_CHECK(set->get(70001));
+    BOOST_CHECK(set->get(50));
+}
+
+BOOST_AUTO_TEST_CASE(testSetAndClear)
+{
+    OpenBitSetPtr expected(newLucene<OpenBitSet>(MAX_DOC));
+    RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>());
+    for (int32_t i = 0; i < 20000; ++i)
+    {
+        int32_t doc = random->nextInt(MAX_DOC);
+        if (random->nextInt(4) == 0)
+        {
+            expected->clear((int64_t)doc);
+            set->clear(doc);
+        }
+        else
+        {
+            expected->set((int64_t)doc);
+            set->set(doc);
+        }
+    }
+    checkEquals(expected, set);
+
+    // clearing every doc id leaves no containers
+    DocIdSetIteratorPtr docs(newLucene<OpenBitSetIterator>(expected));
+    for (int32_t doc = docs->nextDoc(); doc != DocIdSetIterator::NO_MORE_DOCS; doc = docs->nextDoc())
+        set->clear(doc);
+    BOOST_CHECK(set->isEmpty());
+    BOOST_CHECK_EQUAL(set->sizeInBytes(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testOperations)
+{
+    OpenBitSetPtr expectedA(newLucene<OpenBitSet>(MAX_DOC));
+    RoaringDocIdSetPtr a(newLucene<RoaringDocIdSet>());
+    fillMixed(expectedA, a);
+    OpenBitSetPtr expectedB(newLucene<OpenBitSet>(MAX_DOC));
+    RoaringDocIdSetPtr b(newLucene<RoaringDocIdSet>());
+    fillMixed(expectedB, b);
+    b->optimize();
+
+    BOOST_CHECK_EQUAL(RoaringDocIdSet::intersectionCount(a, b), OpenBitSet::intersectionCount(expectedA, expectedB));
+
+    OpenBitSetPtr expected(boost::dynamic_pointer_cast<OpenBitSet>(expectedA->clone()));
+    expected->intersect(expectedB);
+    checkEquals(expected, RoaringDocIdSet::_and(a, b));
+
+    expected = boost::dynamic_pointer_cast<OpenBitSet>(expectedA->clone());
+    expected->_union(expectedB);
+    checkEquals(expected, RoaringDocIdSet::_or(a, b));
+
+    expected = boost::dynamic_pointer_cast<OpenBitSet>(expectedA->clone());
+    expected->andNot(expectedB);
+    checkEquals(expected, RoaringDocIdSet::andNot(a, b));
+
+    expected = boost::dynamic_pointer_cast<OpenBitSet>(expectedB->clone());
+    expected->andNot(expectedA);
+    checkEquals(expected, RoaringDocIdSet::andNot(b, a));
+
+    // the operands are unchanged
+    checkEquals(expectedA, a);
+    checkEquals(expectedB, b);
+    BOOST_CHECK(RoaringDocIdSet::andNot(a, a)->isEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(testWriteRead)
+{
+    OpenBitSetPtr expected(newLucene<OpenBitSet>(MAX_DOC));
+    RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>());
+    fillMixed(expected, set);
+    set->optimize();
+
+    RAMDirectoryPtr dir(newLucene<RAMDirectory>());
+    IndexOutputPtr output(dir->createOutput(L"docs"));
+    set->write(output);
+    output->writeVInt(12345);
+    output->close();
+
+    IndexInputPtr input(dir->openInput(L"docs"));
+    RoaringDocIdSetPtr read(RoaringDocIdSet::read(input));
+    BOOST_CHECK_EQUAL(input->readVInt(), 12345);
+    input->close();
+    checkEquals(expected, read);
+    BOOST_CHECK_EQUAL(read->sizeInBytes(), set->sizeInBytes());
+}
+
+BOOST_AUTO_TEST_CASE(testClone)
+{
+    OpenBitSetPtr expected(newLucene<OpenBitSet>(MAX_DOC));
+    RoaringDocIdSetPtr set(newLucene<RoaringDocIdSet>());
+    fillMixed(expected, set);
+    RoaringDocIdSetPtr clone(boost::dynamic_pointer_cast<RoaringDocIdSet>(set->clone()));
+    set->clear(expected->nextSetBit(0));
+    checkEquals(expected, clone);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
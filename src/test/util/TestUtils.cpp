@@ -11,6 +11,8 @@
 #include "CheckIndex.h"
 #include "ConcurrentMergeScheduler.h"
 #include "IndexWriter.h"
+#include "IndexInput.h"
+#include "IndexOutput.h"
 #include "Random.h"
 #include "MiscUtils.h"
 #include "FileUtils.h"
@@ -181,4 +183,36 @@ namespace Lucene
         }
         return true;
     }
+    
+    uint8_t testFileByte(int64_t position, int32_t seed)
+    {
+        return (uint8_t)((position + seed) % 251);
+    }
+    
+    void writeTestFile(IndexOutputPtr output, int32_t length, int32_t seed)
+    {
+        for (int32_t i = 0; i < length; ++i)
+            output->writeByte(testFileByte(i, seed));
+        output->close();
+    }
+    
+    void writeTestFile(DirectoryPtr dir, const String& name, int32_t length, int32_t seed)
+    {
+        writeTestFile(dir->createOutput(name), length, seed);
+    }
+    
+    void checkTestFile(IndexInputPtr input, int32_t length, int32_t seed)
+    {
+        BOOST_CHECK_EQUAL(input->length(), length);
+        for (int32_t i = 0; i < length; ++i)
+            BOOST_CHECK_EQUAL(input->readByte(), testFileByte(i, seed));
+    }
+    
+    void checkTestFile(DirectoryPtr dir, const String& name, int32_t length, int32_t seed)
+    {
+        IndexInputPtr input(dir->openInput(name));
+        checkTestFile(input, length, seed);
+        BOOST_CHECK_EXCEPTION(input->readByte(), IOException, check_exception(LuceneException::IO));
+        input->close();
+    }
 }
@@ -0,0 +1,226 @@
+/////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2009-2011 Alan Wright. All rights reserved.
+// Distributable under the terms of either the Apache License (Version 2.0)
+// or the GNU Lesser General Public License.
+/////////////////////////////////////////////////////////////////////////////
+
+#include "TestInc.h"
+#include <boost/bind.hpp>
+#include <boost/bind/protect.hpp>
+#include "LuceneTestFixture.h"
+#include "ThreadPool.h"
+#include "MockRAMDirectory.h"
+#include "IndexWriter.h"
+#include "IndexReader.h"
+#include "IndexSearcher.h"
+#include "WhitespaceAnalyzer.h"
+#include "ConcurrentMergeScheduler.h"
+#include "ParallelMultiSearcher.h"
+#include "MultiSearcher.h"
+#include "Document.h"
+#include "Field.h"
+#include "Term.h"
+#include "TermQuery.h"
+#include "TopDocs.h"
+#include "ScoreDoc.h"
+
+using namespace Lucene;
+
+BOOST_FIXTURE_TEST_SUITE(ThreadPoolTest, LuceneTestFixture)
+
+static int32_t square(int32_t value)
+{
+    return value * value;
+}
+
+static int32_t fail()
+{
+    boost::throw_exception(IllegalStateException(L"task failed"));
+    return 0;
+}
+
+/// Sums the squares below n in tasks of pool, each of which sums depth - 1 levels of nested tasks.
+static int32_t sumSquares(ThreadPoolPtr pool, int32_t n, int32_t depth)
+{
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance(n));
+    for (int32_t i = 0; i < n; ++i)
+    {
+        if (depth == 1)
+            futures[i] = pool->scheduleTask(boost::protect(boost::bind<int32_t>(&square, i)));
+        else
+            futures[i] = pool->scheduleTask(boost::protect(boost::bind<int32_t>(&sumSquares, pool, i, depth - 1)));
+    }
+    int32_t sum = 0;
+    for (int32_t i = 0; i < n; ++i)
+        sum += futures[i]->get<int32_t>();
+    return sum;
+}
+
+BOOST_AUTO_TEST_CASE(testNumThreads)
+{
+    BOOST_CHECK_EQUAL(newLucene<ThreadPool>(3)->getNumThreads(), 3);
+    BOOST_CHECK(ThreadPool::getInstance()->getNumThreads() >= 5);
+    BOOST_CHECK_EQUAL(ThreadPool::getInstance()->getNumThreads(), ThreadPool::defaultNumThreads());
+    BOOST_CHECK_EXCEPTION(newLucene<ThreadPool>(0), IllegalArgumentException, check_exception(LuceneException::IllegalArgument));
+}
+
+BOOST_AUTO_TEST_CASE(testResults)
+{
+    ThreadPoolPtr pool(newLucene<ThreadPool>(4));
+    BOOST_CHECK_EQUAL(sumSquares(pool, 1000, 1), 332833500);
+}
+
+BOOST_AUTO_TEST_CASE(testException)
+{
+    ThreadPoolPtr pool(newLucene<ThreadPool>(2));
+    FuturePtr failed(pool->scheduleTask(boost::protect(boost::bind<int32_t>(&fail))));
+    BOOST_CHECK_EXCEPTION(failed->get<int32_t>(), IllegalStateException, check_exception(LuceneException::IllegalState));
+    BOOST_CHECK(failed->isDone());
+
+    // the workers carry on
+    BOOST_CHECK_EQUAL(pool->scheduleTask(boost::protect(boost::bind<int32_t>(&square, 7)))->get<int32_t>(), 49);
+}
+
+BOOST_AUTO_TEST_CASE(testNestedTasks)
+{
+    // tasks waiting for their own tasks run them rather than block the only worker
+    ThreadPoolPtr pool(newLucene<ThreadPool>(1));
+    BOOST_CHECK_EQUAL(pool->scheduleTask(boost::protect(boost::bind<int32_t>(&sumSquares, pool, 10, 1)))->get<int32_t>(), 285);
+    BOOST_CHECK_EQUAL(sumSquares(newLucene<ThreadPool>(2), 8, 3), sumSquares(pool, 8, 3));
+}
+
+DECLARE_SHARED_PTR(BlockingTask)
+
+/// Keeps the worker running it busy until released.
+class BlockingTask : public LuceneObject
+{
+public:
+    BlockingTask()
+    {
+        started = false;
+        released = false;
+    }
+    
+    virtual ~BlockingTask()
+    {
+    }
+    
+    LUCENE_CLASS(BlockingTask);
+
+protected:
+    bool started;
+    bool released;
+
+public:
+    int32_t run()
+    {
+        SyncLock syncLock(this);
+        started = true;
+        notifyAll();
+        while (!released)
+            wait(10);
+        return 0;
+    }
+    
+    void waitForStart()
+    {
+        SyncLock syncLock(this);
+        while (!started)
+            wait(10);
+    }
+    
+    void release()
+    {
+        SyncLock syncLock(this);
+        released = true;
+        notifyAll();
+    }
+};
+
+BOOST_AUTO_TEST_CASE(testWaitingRunsOnlyItsOwnTask)
+{
+    // the only worker is busy, so the waiting thread runs the task it waits for and leaves the other one queued
+    ThreadPoolPtr pool(newLucene<ThreadPool>(1));
+    BlockingTaskPtr blocking(newLucene<BlockingTask>());
+    FuturePtr blocked(pool->scheduleTask(boost::protect(boost::bind<int32_t>(boost::mem_fn(&BlockingTask::run), blocking))));
+    blocking->waitForStart();
+    FuturePtr unrelated(pool->scheduleTask(boost::protect(boost::bind<int32_t>(&square, 3))));
+    FuturePtr waited(pool->scheduleTask(boost::protect(boost::bind<int32_t>(&square, 4))));
+    BOOST_CHECK_EQUAL(waited->get<int32_t>(), 16);
+    BOOST_CHECK(!unrelated->isDone());
+    blocking->release();
+    BOOST_CHECK_EQUAL(unrelated->get<int32_t>(), 9);
+    BOOST_CHECK_EQUAL(blocked->get<int32_t>(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(testQueuedTasksRunOnShutdown)
+{
+    Collection<FuturePtr> futures(Collection<FuturePtr>::newInstance(100));
+    {
+        ThreadPoolPtr pool(newLucene<ThreadPool>(2));
+        for (int32_t i = 0; i < futures.size(); ++i)
+            futures[i] = pool->scheduleTask(boost::protect(boost::bind<int32_t>(&square, i)));
+    }
+    for (int32_t i = 0; i < futures.size(); ++i)
+        BOOST_CHECK_EQUAL(futures[i]->get<int32_t>(), i * i);
+}
+
+static DocumentPtr createDocument(int32_t id)
+{
+    DocumentPtr doc(newLucene<Document>());
+    doc->add(newLucene<Field>(L"id", StringUtils::toString(id), Field::STORE_YES, Field::INDEX_NOT_ANALYZED));
+    doc->add(newLucene<Field>(L"body", id % 3 == 0 ? L"fizz" : L"buzz", Field::STORE_NO, Field::INDEX_ANALYZED));
+    return doc;
+}
+
+BOOST_AUTO_TEST_CASE(testMergeScheduler)
+{
+    ThreadPoolPtr pool(newLucene<ThreadPool>(2));
+    MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+    IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+    ConcurrentMergeSchedulerPtr cms(newLucene<ConcurrentMergeScheduler>(pool));
+    cms->setMaxThreadCount(2);
+    BOOST_CHECK_EQUAL(cms->getExecutor(), pool);
+    writer->setMergeScheduler(cms);
+    writer->setMaxBufferedDocs(2);
+    writer->setMergeFactor(3);
+    for (int32_t i = 0; i < 300; ++i)
+        writer->addDocument(createDocument(i));
+    writer->optimize();
+    writer->close();
+
+    IndexReaderPtr reader(IndexReader::open(dir, true));
+    BOOST_CHECK_EQUAL(reader->numDocs(), 300);
+    BOOST_CHECK_EQUAL(reader->getSequentialSubReaders().size(), 1);
+    BOOST_CHECK_EQUAL(reader->docFreq(newLucene<Term>(L"body", L"fizz")), 100);
+    reader->close();
+    dir->close();
+
+    BOOST_CHECK_EXCEPTION(newLucene<ConcurrentMergeScheduler>(ThreadPoolPtr()), NullPointerException, check_exception(LuceneException::NullPointer));
+}
+
+BOOST_AUTO_TEST_CASE(testParallelMultiSearcher)
+{
+    Collection<SearchablePtr> searchables(Collection<SearchablePtr>::newInstance());
+    for (int32_t i = 0; i < 4; ++i)
+    {
+        MockRAMDirectoryPtr dir(newLucene<MockRAMDirectory>());
+        IndexWriterPtr writer(newLucene<IndexWriter>(dir, newLucene<WhitespaceAnalyzer>(), true, IndexWriter::MaxFieldLengthLIMITED));
+        for (int32_t j = 0; j < 50; ++j)
+            writer->addDocument(createDocument(i * 50 + j));
+        writer->close();
+        searchables.add(newLucene<IndexSearcher>(dir, true));
+    }
+    QueryPtr query(newLucene<TermQuery>(newLucene<Term>(L"body", L"fizz")));
+    SearcherPtr searcher(newLucene<MultiSearcher>(searchables));
+    SearcherPtr parallelSearcher(newLucene<ParallelMultiSearcher>(searchables, newLucene<ThreadPool>(3)));
+    TopDocsPtr expected(searcher->search(query, 20));
+    TopDocsPtr actual(parallelSearcher->search(query, 20));
+    BOOST_CHECK_EQUAL(actual->totalHits, 67);
+    BOOST_CHECK_EQUAL(actual->totalHits, expected->totalHits);
+    BOOST_CHECK_EQUAL(actual->scoreDocs.size(), expected->scoreDocs.size());
+    for (int32_t i = 0; i < actual->scoreDocs.size(); ++i)
+        BOOST_CHECK_EQUAL(actual->scoreDocs[i]->doc, expected->scoreDocs[i]->doc);
+}
+
+BOOST_AUTO_TEST_SUITE_END()